@@ -0,0 +1,99 @@
+/**
+ * @file bench_apu.cpp
+ * @brief Measures the cost of audio synthesis per frame under light and heavy register traffic
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../src/apu/apu.hpp"
+#include "../src/core/scheduler.hpp"
+#include "../src/cpu/sm83_state.hpp"
+#include "../src/ppu/ppu_registers.hpp"
+
+static const int DEFAULT_FRAMES = 6000;
+
+// Real time length of a frame, and the budget for a whole frame when running 10 times faster
+static const double FRAME_NS = 1e9 * DOTS_PER_FRAME / 4194304.0;
+static const double TURBO_FRAME_NS = FRAME_NS / 10;
+
+/**
+ * @brief Plays all four channels, rewriting their frequencies a given number of times per frame
+ *
+ * @return double The mean nanoseconds spent per frame, including reading the samples
+ */
+static double TimeAPU(int writes_per_frame, int frames) {
+    uint8_t* memory = new uint8_t[65536]();
+    SM83State state(memory);
+    Scheduler scheduler;
+    APU apu(memory, &scheduler, DEFAULT_SAMPLE_RATE);
+    state.AddMemoryObserver(&apu, 0xFF, 0xFF);
+
+    state.SetMemoryAt(NR50_ADDRESS, 0x77);
+    state.SetMemoryAt(NR51_ADDRESS, 0xFF);
+    for (uint16_t address = WAVE_RAM_ADDRESS; address <= APU_LAST_ADDRESS; address++) {
+        state.SetMemoryAt(address, (uint8_t)(address * 37));
+    }
+
+    // Square 1 with a sweep, square 2 with an envelope, wave at 100% and fast noise
+    state.SetMemoryAt(0xFF10, 0x17);
+    state.SetMemoryAt(0xFF11, 0x80);
+    state.SetMemoryAt(0xFF12, 0xF3);
+    state.SetMemoryAt(0xFF14, NRX4_TRIGGER | 0x06);
+    state.SetMemoryAt(0xFF16, 0x40);
+    state.SetMemoryAt(0xFF17, 0xA7);
+    state.SetMemoryAt(0xFF19, NRX4_TRIGGER | 0x07);
+    state.SetMemoryAt(0xFF1A, 0x80);
+    state.SetMemoryAt(0xFF1C, 0x20);
+    state.SetMemoryAt(0xFF1E, NRX4_TRIGGER | 0x06);
+    state.SetMemoryAt(0xFF21, 0xF0);
+    state.SetMemoryAt(0xFF22, 0x11);
+    state.SetMemoryAt(0xFF23, NRX4_TRIGGER);
+
+    std::vector<float> samples(4096);
+    uint32_t step = DOTS_PER_FRAME / (writes_per_frame + 1);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        uint32_t elapsed = 0;
+
+        for (int write = 0; write < writes_per_frame; write++) {
+            scheduler.Advance(step);
+            elapsed += step;
+            state.SetMemoryAt(0xFF18, (uint8_t)(frame + write));
+            state.SetMemoryAt(0xFF1D, (uint8_t)(frame * 3 + write));
+        }
+
+        scheduler.Advance(DOTS_PER_FRAME - elapsed);
+        apu.EndFrame();
+        apu.ReadSamples(samples.data(), samples.size() / 2);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    state.RemoveMemoryObserver(&apu);
+    delete[] memory;
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / frames;
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = argc > 1 ? atoi(argv[1]) : DEFAULT_FRAMES;
+    if (frames < 1) {
+        fprintf(stderr, "Usage: %s [FRAMES]\n", argv[0]);
+        return 2;
+    }
+
+    // Once per frame is a typical music driver, once per line is a sample playback routine
+    const int writes[] = { 0, 1, 16, 154 };
+
+    printf("%-16s %12s %14s\n", "writes/frame", "us/frame", "% of 10x frame");
+    for (int count : writes) {
+        double ns = TimeAPU(count, frames);
+        printf("%-16d %12.2f %13.1f%%\n", count, ns / 1000.0, 100.0 * ns / TURBO_FRAME_NS);
+    }
+
+    return 0;
+}
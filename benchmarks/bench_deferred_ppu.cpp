@@ -0,0 +1,125 @@
+/**
+ * @file bench_deferred_ppu.cpp
+ * @brief Compares whole machine throughput with the PPU drawing inline and on a second thread
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../src/core/game_boy.hpp"
+#include "../src/util/xxhash64.hpp"
+
+static const int DEFAULT_FRAMES = 3000;
+
+// Spins in place, so nearly all the work is drawing
+static const uint8_t IDLE_CODE[] = {
+    0x18, 0xFE          // 0100 JR 0100
+};
+
+// Scrolls every few dots, logging a register write per iteration
+static const uint8_t RASTER_CODE[] = {
+    0x21, 0x43, 0xFF,   // 0100 LD HL,FF43 (SCX)
+    0x34,               // 0103 INC (HL)
+    0x18, 0xFD          // 0104 JR 0103
+};
+
+// Rewrites the first 256 bytes of tile data forever, logging a VRAM write per iteration
+static const uint8_t VRAM_CODE[] = {
+    0x11, 0x00, 0x80,   // 0100 LD DE,8000
+    0x12,               // 0103 LD (DE),A
+    0x1C,               // 0104 INC E
+    0x18, 0xFC          // 0105 JR 0103
+};
+
+struct Workload {
+    std::string name;
+    std::vector<uint8_t> rom;
+};
+
+static Workload BuildWorkload(const char* name, const uint8_t* code, size_t size) {
+    Workload workload;
+    workload.name = name;
+    workload.rom.assign(MAX_ROM_SIZE, 0x00);
+    for (size_t i = 0; i < size; i++) {
+        workload.rom[0x100 + i] = code[i];
+    }
+    return workload;
+}
+
+/**
+ * @brief Runs a ROM for a number of frames, hashing every frame as lameboy-headless does
+ *
+ * @return double The seconds taken
+ */
+static double TimeFrames(const Workload& workload, PPUKind kind, int frames, uint64_t* last_hash) {
+    GameBoy game_boy(kind);
+    if (!game_boy.LoadROM(workload.rom.data(), workload.rom.size())) {
+        throw std::runtime_error("Empty ROM " + workload.name);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        game_boy.RunFrame();
+        *last_hash = XXHash64(game_boy.framebuffer(), SCREEN_PIXELS * sizeof(uint32_t));
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return std::chrono::duration<double>(elapsed).count();
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = DEFAULT_FRAMES;
+    std::vector<Workload> workloads;
+    workloads.push_back(BuildWorkload("idle", IDLE_CODE, sizeof(IDLE_CODE)));
+    workloads.push_back(BuildWorkload("raster", RASTER_CODE, sizeof(RASTER_CODE)));
+    workloads.push_back(BuildWorkload("vram", VRAM_CODE, sizeof(VRAM_CODE)));
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            std::ifstream file(argv[i], std::ios::binary);
+            Workload workload;
+            workload.name = argv[i];
+            workload.rom.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            workloads.push_back(workload);
+        } else {
+            frames = 0;
+            break;
+        }
+    }
+
+    if (frames < 1) {
+        fprintf(stderr, "Usage: %s [--frames N] [ROM...]\n", argv[0]);
+        return 2;
+    }
+
+    printf("%d frames per run, every frame hashed\n", frames);
+    printf("%-24s %-10s %12s %10s %6s\n", "workload", "ppu", "frames/s", "speedup", "same");
+
+    try {
+        for (const Workload& workload : workloads) {
+            uint64_t inline_hash = 0;
+            uint64_t deferred_hash = 0;
+            double inline_seconds = TimeFrames(workload, FAST_PPU, frames, &inline_hash);
+            double deferred_seconds = TimeFrames(workload, DEFERRED_PPU, frames, &deferred_hash);
+
+            printf("%-24s %-10s %12.0f %9.2fx %6s\n", workload.name.c_str(), "inline", frames / inline_seconds, 1.0, "-");
+            printf("%-24s %-10s %12.0f %9.2fx %6s\n", workload.name.c_str(), "deferred", frames / deferred_seconds,
+                inline_seconds / deferred_seconds, deferred_hash == inline_hash ? "yes" : "NO");
+        }
+    } catch (const std::runtime_error& error) {
+        fprintf(stderr, "%s\n", error.what());
+        return 1;
+    }
+
+    return 0;
+}
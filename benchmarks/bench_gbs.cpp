@@ -0,0 +1,101 @@
+/**
+ * @file bench_gbs.cpp
+ * @brief Measures how much faster than real time a GBS song renders with only the CPU and APU running
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include "../src/core/gbs_player.hpp"
+#include "../src/ppu/ppu_registers.hpp"
+
+static const int DEFAULT_SECONDS = 600;
+static const uint32_t DMG_CLOCK_RATE = 4194304;
+
+// INIT starts all four channels, as in bench_apu
+static const uint8_t INIT_CODE[] = {
+    0x26, 0xFF,
+    0x2E, 0x30, 0x36, 0x12, 0x2E, 0x31, 0x36, 0x9A, 0x2E, 0x32, 0x36, 0xEF, 0x2E, 0x33, 0x36, 0x47,
+    0x2E, 0x10, 0x36, 0x17, 0x2E, 0x11, 0x36, 0x80, 0x2E, 0x12, 0x36, 0xF3, 0x2E, 0x14, 0x36, 0x86,
+    0x2E, 0x16, 0x36, 0x40, 0x2E, 0x17, 0x36, 0xA7, 0x2E, 0x19, 0x36, 0x87,
+    0x2E, 0x1A, 0x36, 0x80, 0x2E, 0x1C, 0x36, 0x20, 0x2E, 0x1E, 0x36, 0x86,
+    0x2E, 0x21, 0x36, 0xF0, 0x2E, 0x22, 0x36, 0x11, 0x2E, 0x23, 0x36, 0x80,
+    0xC9
+};
+
+// PLAY nudges a frequency on three channels, like a driver applying vibrato
+static const uint8_t PLAY_CODE[] = {
+    0x26, 0xFF,
+    0x2E, 0x18, 0x34,
+    0x2E, 0x1D, 0x34,
+    0x2E, 0x22, 0x34,
+    0xC9
+};
+
+static const uint16_t LOAD_ADDRESS = 0x0400;
+static const uint16_t PLAY_ADDRESS = 0x0500;
+
+static std::vector<uint8_t> BuildGBS() {
+    std::vector<uint8_t> file(GBS_HEADER_SIZE + 0x200, 0x00);
+    memcpy(file.data(), "GBS", 3);
+    file[0x03] = 1;
+    file[0x04] = 1;
+    file[0x05] = 1;
+    file[0x06] = (uint8_t)LOAD_ADDRESS;
+    file[0x07] = (uint8_t)(LOAD_ADDRESS >> 8);
+    file[0x08] = (uint8_t)LOAD_ADDRESS;
+    file[0x09] = (uint8_t)(LOAD_ADDRESS >> 8);
+    file[0x0A] = (uint8_t)PLAY_ADDRESS;
+    file[0x0B] = (uint8_t)(PLAY_ADDRESS >> 8);
+    file[0x0C] = 0xFE;
+    file[0x0D] = 0xFF;
+
+    memcpy(file.data() + GBS_HEADER_SIZE, INIT_CODE, sizeof(INIT_CODE));
+    memcpy(file.data() + GBS_HEADER_SIZE + (PLAY_ADDRESS - LOAD_ADDRESS), PLAY_CODE, sizeof(PLAY_CODE));
+    return file;
+}
+
+int main(int argc, char *argv[])
+{
+    int seconds = argc > 1 ? atoi(argv[1]) : DEFAULT_SECONDS;
+    const char* path = argc > 2 ? argv[2] : nullptr;
+    if (seconds < 1) {
+        fprintf(stderr, "Usage: %s [SECONDS] [GBS]\n", argv[0]);
+        return 2;
+    }
+
+    GBSPlayer player;
+    std::vector<uint8_t> file = BuildGBS();
+    bool loaded = path != nullptr ? player.LoadFile(path) : player.Load(file.data(), file.size());
+    if (!loaded) {
+        fprintf(stderr, "Could not read a GBS file from %s\n", path);
+        return 1;
+    }
+
+    std::vector<float> samples(4096);
+    uint64_t total_dots = (uint64_t)seconds * DMG_CLOCK_RATE;
+    size_t read = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    try {
+        player.StartSong(player.header().first_song > 0 ? player.header().first_song - 1 : 0);
+        while (player.cycles() < total_dots) {
+            player.Run(DOTS_PER_FRAME);
+            read += player.ReadAudio(samples.data(), samples.size() / 2);
+        }
+    } catch (const std::runtime_error& error) {
+        fprintf(stderr, "%s\n", error.what());
+        return 1;
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double played = (double)player.cycles() / DMG_CLOCK_RATE;
+    printf("%-16s %12s %14s %14s\n", "audio seconds", "samples", "wall seconds", "x real time");
+    printf("%-16.1f %12zu %14.3f %14.0f\n", played, read, elapsed, played / elapsed);
+
+    return 0;
+}
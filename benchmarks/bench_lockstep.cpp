@@ -0,0 +1,179 @@
+/**
+ * @file bench_lockstep.cpp
+ * @brief Compares running many CPUs one at a time with running them in lockstep at every SIMD level
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+#include "../src/cpu/sm83_emulator.hpp"
+#include "../src/cpu/sm83_lockstep.hpp"
+
+static const int DEFAULT_INSTANCES = 64;
+static const int DEFAULT_FRAMES = 60;
+
+// Cycles in a DMG frame. Only the CPU runs, so these are CPU frames with no PPU or APU work
+static const uint32_t CYCLES_PER_FRAME = 70224;
+
+// Counted loops whose branches only depend on B and C, so every instance stays on the same PC
+// while A and HL differ. JR offsets are relative to the next instruction
+static const uint8_t CONVERGED_CODE[] = {
+    0x06, 0x40,         // 0100 LD B,40
+    0x0E, 0x10,         // 0102 LD C,10
+    0x23,               // 0104 INC HL
+    0x17,               // 0105 RLA
+    0x09,               // 0106 ADD HL,BC
+    0x0D,               // 0107 DEC C
+    0x20, 0xFA,         // 0108 JR NZ,0104
+    0x05,               // 010A DEC B
+    0x20, 0xF5,         // 010B JR NZ,0102
+    0x18, 0xF1          // 010D JR 0100
+};
+
+// Branches on the bits of A, which differs per instance, taking paths of different lengths
+static const uint8_t DIVERGENT_CODE[] = {
+    0x17,               // 0100 RLA
+    0x38, 0x02,         // 0101 JR C,0105
+    0x23,               // 0103 INC HL
+    0x23,               // 0104 INC HL
+    0x0C,               // 0105 INC C
+    0x18, 0xF8          // 0106 JR 0100
+};
+
+struct Workload {
+    const char* name;
+    const uint8_t* code;
+    size_t size;
+};
+
+static std::vector<uint8_t> BuildROM(const Workload& workload) {
+    std::vector<uint8_t> rom(LOCKSTEP_ROM_SIZE, 0x00);
+    for (size_t i = 0; i < workload.size; i++) {
+        rom[0x100 + i] = workload.code[i];
+    }
+    return rom;
+}
+
+static void SeedRegisters(SM83State* state, int instance) {
+    state->setAF(0x01B0);
+    state->setA((uint8_t)(instance * 73 + 5));
+    state->setBC(0x0013);
+    state->setDE(0x00D8);
+    state->setHL((uint16_t)(instance * 37));
+    state->setStackPointer(0xFFFE);
+    state->setProgramCounter(0x0100);
+}
+
+/**
+ * @brief Runs each instance on its own SM83Emulator, a frame at a time
+ *
+ * @return double Seconds taken
+ */
+static double TimeScalar(const Workload& workload, int instances, int frames) {
+    std::vector<uint8_t> rom = BuildROM(workload);
+    std::vector<std::vector<uint8_t>> memories(instances, std::vector<uint8_t>(0x10000, 0x00));
+    std::vector<SM83State*> states;
+
+    for (int i = 0; i < instances; i++) {
+        std::copy(rom.begin(), rom.end(), memories[i].begin());
+        SM83State* state = new SM83State(memories[i].data());
+        SeedRegisters(state, i);
+        states.push_back(state);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < instances; i++) {
+        SM83Emulator emulator(states[i]);
+        uint64_t cycles = 0;
+        for (int frame = 1; frame <= frames; frame++) {
+            while (cycles < (uint64_t)frame * CYCLES_PER_FRAME) {
+                cycles += emulator.Step();
+            }
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (SM83State* state : states) {
+        delete state;
+    }
+    return elapsed;
+}
+
+/**
+ * @brief Runs every instance in one LockstepSM83, a frame at a time
+ *
+ * @param vector_share Receives the fraction of instructions run by the lane kernel
+ * @param lanes_per_step Receives the mean number of instances covered by a kernel call
+ * @return double Seconds taken
+ */
+static double TimeLockstep(const Workload& workload, int instances, int frames, SIMDLevel level, double* vector_share, double* lanes_per_step) {
+    std::vector<uint8_t> rom = BuildROM(workload);
+    LockstepSM83 lockstep(instances, level);
+    lockstep.LoadROM(rom.data(), rom.size());
+
+    SM83State state(nullptr);
+    for (int i = 0; i < instances; i++) {
+        SeedRegisters(&state, i);
+        lockstep.WriteRegisters(i, &state);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        lockstep.Run(CYCLES_PER_FRAME);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t vector = lockstep.vectorInstructions();
+    *vector_share = (double)vector / (vector + lockstep.scalarSteps());
+    *lanes_per_step = lockstep.vectorSteps() > 0 ? (double)vector / lockstep.vectorSteps() : 0.0;
+    return elapsed;
+}
+
+int main(int argc, char *argv[])
+{
+    int instances = argc > 1 ? atoi(argv[1]) : DEFAULT_INSTANCES;
+    int frames = argc > 2 ? atoi(argv[2]) : DEFAULT_FRAMES;
+    if (instances < 1 || frames < 1) {
+        fprintf(stderr, "Usage: %s [INSTANCES] [FRAMES]\n", argv[0]);
+        return 2;
+    }
+
+    const Workload workloads[] = {
+        { "converged", CONVERGED_CODE, sizeof(CONVERGED_CODE) },
+        { "divergent", DIVERGENT_CODE, sizeof(DIVERGENT_CODE) }
+    };
+    const SIMDLevel levels[] = { SIMD_SCALAR, SIMD_AVX2, SIMD_AVX512 };
+
+    printf("%d instances, %d CPU frames each\n", instances, frames);
+    printf("%-10s %-18s %14s %10s %10s %12s\n", "workload", "engine", "frames/s", "speedup", "vector", "lanes/step");
+
+    try {
+        for (const Workload& workload : workloads) {
+            double scalar_seconds = TimeScalar(workload, instances, frames);
+            double total_frames = (double)instances * frames;
+            printf("%-10s %-18s %14.0f %9.2fx %10s %12s\n", workload.name, "scalar instances", total_frames / scalar_seconds, 1.0, "-", "-");
+
+            for (SIMDLevel level : levels) {
+                if (!SIMDLevelSupported(level)) {
+                    continue;
+                }
+
+                double vector_share = 0.0;
+                double lanes_per_step = 0.0;
+                double seconds = TimeLockstep(workload, instances, frames, level, &vector_share, &lanes_per_step);
+                char engine[32];
+                snprintf(engine, sizeof(engine), "lockstep %s", SIMDLevelName(level));
+                printf("%-10s %-18s %14.0f %9.2fx %9.1f%% %12.1f\n", workload.name, engine, total_frames / seconds,
+                    scalar_seconds / seconds, vector_share * 100.0, lanes_per_step);
+            }
+        }
+    } catch (const std::runtime_error& error) {
+        fprintf(stderr, "%s\n", error.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,326 @@
+/**
+ * @file bench_op_codes.cpp
+ * @brief Google Benchmark microbenchmarks of the op code handlers, their ALU helpers, instruction
+ * dispatch and the memory bus
+ *
+ * Run with --benchmark_format=json or --benchmark_out=FILE --benchmark_out_format=json to keep results.
+ */
+
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../src/cpu/sm83_emulator.hpp"
+#include "../src/cpu/sm83_op_codes.hpp"
+#include "../src/cpu/sm83_state.hpp"
+
+static const uint16_t CODE_ADDRESS = 0x0100;
+
+// Instructions run per iteration of the dispatch benchmarks
+static const int STREAM_LENGTH = 1024;
+
+// Single byte op codes that only touch registers
+static const uint8_t ALU_OP_CODES[] = {
+    0x03, 0x04, 0x05, 0x07, 0x09, 0x0B, 0x0C, 0x0D, 0x0F, 0x13, 0x14, 0x15, 0x17, 0x19, 0x1B, 0x1C,
+    0x1D, 0x1F, 0x23, 0x24, 0x25, 0x29, 0x2B, 0x2C, 0x2D, 0x2F, 0x33, 0x37
+};
+
+// Single byte op codes that read or write through BC, DE or HL
+static const uint8_t MEMORY_OP_CODES[] = {
+    0x02, 0x0A, 0x12, 0x1A, 0x22, 0x2A, 0x32, 0x34, 0x35
+};
+
+/**
+ * @brief A 64KB memory bus and a CPU state on it, with registers pointing into work RAM
+ *
+ */
+struct Machine {
+    std::vector<uint8_t> memory;
+    SM83State state;
+
+    Machine() : memory(0x10000, 0x00), state(memory.data()) {
+        this->ResetRegisters();
+    }
+
+    void ResetRegisters() {
+        this->state.setAF(0x3C00);
+        this->state.setBC(0xC010);
+        this->state.setDE(0xC020);
+        this->state.setHL(0xC030);
+        this->state.setStackPointer(0xDFF0);
+        this->state.setProgramCounter(CODE_ADDRESS);
+    }
+};
+
+// Does nothing, to time the cost of an observed page
+class NullObserver : public MemoryObserver {
+public:
+    void OnMemoryWrite(uint16_t address, uint8_t value) override {}
+
+    bool OnMemoryRead(uint16_t address, uint8_t* value) override {
+        return false;
+    }
+};
+
+/**
+ * @brief The register reset done before every handler call, to subtract from the Execute results
+ *
+ */
+static void BM_ResetRegisters(benchmark::State& bench) {
+    Machine machine;
+    for (auto _ : bench) {
+        machine.ResetRegisters();
+        benchmark::ClobberMemory();
+    }
+    bench.SetItemsProcessed(bench.iterations());
+}
+BENCHMARK(BM_ResetRegisters)->Name("Execute/reset_only");
+
+/**
+ * @brief Runs one handler repeatedly at the same PC with the same registers, so jumps, calls and
+ * pointer increments do not drift between iterations
+ *
+ */
+static void BM_Execute(benchmark::State& bench, uint8_t op_code) {
+    Machine machine;
+    machine.memory[CODE_ADDRESS] = op_code;
+    machine.memory[CODE_ADDRESS + 1] = 0x30;
+    machine.memory[CODE_ADDRESS + 2] = 0xC0;
+    OpCodeHandler handler = OpCodeHandlerFor(op_code);
+
+    for (auto _ : bench) {
+        machine.ResetRegisters();
+        benchmark::DoNotOptimize(handler(&machine.state));
+    }
+    bench.SetItemsProcessed(bench.iterations());
+}
+
+static void BM_AddToRegister8(benchmark::State& bench) {
+    Machine machine;
+    uint8_t value = 0;
+    for (auto _ : bench) {
+        AddToRegister(&machine.state, &SM83State::a, &SM83State::setA, value++);
+    }
+    benchmark::DoNotOptimize(machine.state.a());
+    bench.SetItemsProcessed(bench.iterations());
+}
+BENCHMARK(BM_AddToRegister8)->Name("ALU/AddToRegister/8");
+
+static void BM_AddToRegister16(benchmark::State& bench) {
+    Machine machine;
+    uint16_t value = 0;
+    for (auto _ : bench) {
+        AddToRegister(&machine.state, &SM83State::hl, &SM83State::setHL, value);
+        value += 0x0123;
+    }
+    benchmark::DoNotOptimize(machine.state.hl());
+    bench.SetItemsProcessed(bench.iterations());
+}
+BENCHMARK(BM_AddToRegister16)->Name("ALU/AddToRegister/16");
+
+static void BM_SubFromRegister(benchmark::State& bench) {
+    Machine machine;
+    uint8_t value = 0;
+    for (auto _ : bench) {
+        SubFromRegister(&machine.state, &SM83State::b, &SM83State::setB, value++);
+    }
+    benchmark::DoNotOptimize(machine.state.b());
+    bench.SetItemsProcessed(bench.iterations());
+}
+BENCHMARK(BM_SubFromRegister)->Name("ALU/SubFromRegister");
+
+static void BM_AddToMemoryLocation(benchmark::State& bench) {
+    Machine machine;
+    uint8_t value = 0;
+    for (auto _ : bench) {
+        AddToMemoryLocation(&machine.state, 0xC030, value++);
+    }
+    benchmark::DoNotOptimize(machine.memory[0xC030]);
+    bench.SetItemsProcessed(bench.iterations());
+}
+BENCHMARK(BM_AddToMemoryLocation)->Name("ALU/AddToMemoryLocation");
+
+static void BM_SubFromMemoryLocation(benchmark::State& bench) {
+    Machine machine;
+    uint8_t value = 0;
+    for (auto _ : bench) {
+        SubFromMemoryLocation(&machine.state, 0xC030, value++);
+    }
+    benchmark::DoNotOptimize(machine.memory[0xC030]);
+    bench.SetItemsProcessed(bench.iterations());
+}
+BENCHMARK(BM_SubFromMemoryLocation)->Name("ALU/SubFromMemoryLocation");
+
+static void BM_RotateLeft(benchmark::State& bench) {
+    Machine machine;
+    bool through_carry = bench.range(0) != 0;
+    for (auto _ : bench) {
+        RotateLeft(&machine.state, &SM83State::a, &SM83State::setA, through_carry);
+    }
+    benchmark::DoNotOptimize(machine.state.a());
+    bench.SetItemsProcessed(bench.iterations());
+}
+BENCHMARK(BM_RotateLeft)->Name("ALU/RotateLeft")->ArgName("through_carry")->Arg(0)->Arg(1);
+
+static void BM_RotateRight(benchmark::State& bench) {
+    Machine machine;
+    bool through_carry = bench.range(0) != 0;
+    for (auto _ : bench) {
+        RotateRight(&machine.state, &SM83State::a, &SM83State::setA, through_carry);
+    }
+    benchmark::DoNotOptimize(machine.state.a());
+    bench.SetItemsProcessed(bench.iterations());
+}
+BENCHMARK(BM_RotateRight)->Name("ALU/RotateRight")->ArgName("through_carry")->Arg(0)->Arg(1);
+
+/**
+ * @brief Fills the code area with a fixed random sequence of single byte op codes
+ *
+ */
+static void WriteStream(Machine* machine, const uint8_t* op_codes, size_t count) {
+    std::mt19937 random(42);
+    for (int i = 0; i < STREAM_LENGTH; i++) {
+        machine->memory[CODE_ADDRESS + i] = op_codes[random() % count];
+    }
+}
+
+/**
+ * @brief Fetches and dispatches a stream of instructions through SM83Emulator::Step
+ *
+ */
+static void BM_DispatchStream(benchmark::State& bench, const uint8_t* op_codes, size_t count) {
+    Machine machine;
+    WriteStream(&machine, op_codes, count);
+    SM83Emulator emulator(&machine.state);
+
+    uint64_t cycles = 0;
+    for (auto _ : bench) {
+        machine.ResetRegisters();
+        for (int i = 0; i < STREAM_LENGTH; i++) {
+            cycles += emulator.Step();
+        }
+    }
+    benchmark::DoNotOptimize(cycles);
+    bench.SetItemsProcessed(bench.iterations() * STREAM_LENGTH);
+}
+BENCHMARK_CAPTURE(BM_DispatchStream, alu, ALU_OP_CODES, sizeof(ALU_OP_CODES))->Name("Dispatch/Step/alu");
+BENCHMARK_CAPTURE(BM_DispatchStream, memory, MEMORY_OP_CODES, sizeof(MEMORY_OP_CODES))->Name("Dispatch/Step/memory");
+
+/**
+ * @brief The same ALU stream dispatched through the handler table without SM83Emulator, to
+ * separate the cost of the table lookup from the fetch
+ *
+ */
+static void BM_DispatchTable(benchmark::State& bench) {
+    Machine machine;
+    WriteStream(&machine, ALU_OP_CODES, sizeof(ALU_OP_CODES));
+
+    OpCodeHandler handlers[STREAM_LENGTH];
+    for (int i = 0; i < STREAM_LENGTH; i++) {
+        handlers[i] = OpCodeHandlerFor(machine.memory[CODE_ADDRESS + i]);
+    }
+
+    uint64_t cycles = 0;
+    for (auto _ : bench) {
+        machine.ResetRegisters();
+        for (int i = 0; i < STREAM_LENGTH; i++) {
+            cycles += handlers[i](&machine.state);
+        }
+    }
+    benchmark::DoNotOptimize(cycles);
+    bench.SetItemsProcessed(bench.iterations() * STREAM_LENGTH);
+}
+BENCHMARK(BM_DispatchTable)->Name("Dispatch/predecoded/alu");
+
+/**
+ * @brief A counted DEC C / JR NZ loop, so every other instruction is a taken branch
+ *
+ */
+static void BM_DispatchLoop(benchmark::State& bench) {
+    Machine machine;
+    machine.memory[CODE_ADDRESS] = 0x0D;
+    // JR NZ back to DEC C, relative to the instruction after the JR
+    machine.memory[CODE_ADDRESS + 1] = 0x20;
+    machine.memory[CODE_ADDRESS + 2] = 0xFD;
+    SM83Emulator emulator(&machine.state);
+
+    uint64_t cycles = 0;
+    for (auto _ : bench) {
+        machine.ResetRegisters();
+        machine.state.setC(0);
+        // 256 passes of two instructions
+        for (int i = 0; i < 512; i++) {
+            cycles += emulator.Step();
+        }
+    }
+    benchmark::DoNotOptimize(cycles);
+    bench.SetItemsProcessed(bench.iterations() * 512);
+}
+BENCHMARK(BM_DispatchLoop)->Name("Dispatch/Step/loop");
+
+static void BM_BusRead(benchmark::State& bench) {
+    Machine machine;
+    NullObserver observer;
+    if (bench.range(0) != 0) {
+        machine.state.AddMemoryObserver(&observer, 0xC0, 0xDF, WATCH_READS);
+    }
+
+    uint32_t sum = 0;
+    for (auto _ : bench) {
+        for (uint16_t address = 0xC000; address < 0xC100; address++) {
+            sum += machine.state.MemoryAt(address);
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    bench.SetItemsProcessed(bench.iterations() * 256);
+}
+BENCHMARK(BM_BusRead)->Name("Bus/Read")->ArgName("watched")->Arg(0)->Arg(1);
+
+static void BM_BusWrite(benchmark::State& bench) {
+    Machine machine;
+    NullObserver observer;
+    if (bench.range(0) != 0) {
+        machine.state.AddMemoryObserver(&observer, 0xC0, 0xDF, WATCH_WRITES);
+    }
+
+    uint8_t value = 0;
+    for (auto _ : bench) {
+        for (uint16_t address = 0xC000; address < 0xC100; address++) {
+            machine.state.SetMemoryAt(address, value++);
+        }
+        benchmark::ClobberMemory();
+    }
+    bench.SetItemsProcessed(bench.iterations() * 256);
+}
+BENCHMARK(BM_BusWrite)->Name("Bus/Write")->ArgName("watched")->Arg(0)->Arg(1);
+
+static void BM_BusCopy(benchmark::State& bench) {
+    Machine machine;
+    for (auto _ : bench) {
+        // The size of an OAM DMA
+        machine.state.CopyMemory(0xFE00, 0xC000, 160);
+        benchmark::ClobberMemory();
+    }
+    bench.SetBytesProcessed(bench.iterations() * 160);
+}
+BENCHMARK(BM_BusCopy)->Name("Bus/CopyMemory");
+
+int main(int argc, char **argv) {
+    // One benchmark per implemented op code, named after its handler
+    for (int op_code = 0; op_code < 0x100; op_code++) {
+        if (OpCodeHandlerFor((uint8_t)op_code) == nullptr) {
+            continue;
+        }
+        char name[32];
+        snprintf(name, sizeof(name), "Execute/%02X", op_code);
+        benchmark::RegisterBenchmark(name, BM_Execute, (uint8_t)op_code);
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
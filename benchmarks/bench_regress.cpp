@@ -0,0 +1,334 @@
+/**
+ * @file bench_regress.cpp
+ * @brief Records benchmark baselines and compares later builds against them, failing on regressions
+ *
+ * record BASELINE [ROM...] measures ns/op of every op code handler, instructions/s of the dispatch
+ * loop, and frames/s and instructions/s of each ROM run headless, then saves every sample.
+ * compare BASELINE [ROM...] repeats the same measurements and exits with 1 when any metric is
+ * significantly worse than its baseline by more than the noise threshold. Significance is corrected
+ * for the number of metrics, so the chance of a false alarm across the whole run stays at alpha.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../src/core/game_boy.hpp"
+#include "../src/cpu/sm83_emulator.hpp"
+#include "../src/cpu/sm83_state.hpp"
+#include "../src/util/perf_baseline.hpp"
+
+static const int DEFAULT_REPEATS = 15;
+static const long DEFAULT_FRAMES = 300;
+static const double DEFAULT_THRESHOLD = 0.10;
+static const double DEFAULT_ALPHA = 0.01;
+
+// Calls per handler sample, around a few milliseconds each
+static const int HANDLER_CALLS = 400000;
+
+// Instructions per dispatch sample
+static const int DISPATCH_INSTRUCTIONS = 1 << 20;
+
+// Frames run before timing a ROM, past the boot logo of most games
+static const long WARMUP_FRAMES = 30;
+
+static const uint16_t CODE_ADDRESS = 0x0100;
+
+// Single byte op codes that only touch registers, as in bench_op_codes
+static const uint8_t ALU_OP_CODES[] = {
+    0x03, 0x04, 0x05, 0x07, 0x09, 0x0B, 0x0C, 0x0D, 0x0F, 0x13, 0x14, 0x15, 0x17, 0x19, 0x1B, 0x1C,
+    0x1D, 0x1F, 0x23, 0x24, 0x25, 0x29, 0x2B, 0x2C, 0x2D, 0x2F, 0x33, 0x37
+};
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr, "Usage: %s record|compare BASELINE [--repeats N] [--frames N] [--threshold PERCENT] [--alpha P] [--accurate] [ROM...]\n", program);
+    fprintf(stderr, "  record           Measure and save the samples to BASELINE\n");
+    fprintf(stderr, "  compare          Measure and compare against BASELINE, exiting with 1 on a regression\n");
+    fprintf(stderr, "  --repeats N      Samples taken of every metric (default %d)\n", DEFAULT_REPEATS);
+    fprintf(stderr, "  --frames N       Frames timed per ROM sample (default %ld)\n", DEFAULT_FRAMES);
+    fprintf(stderr, "  --threshold PCT  Change treated as noise, in percent (default %.0f)\n", DEFAULT_THRESHOLD * 100);
+    fprintf(stderr, "  --alpha P        Significance level across all metrics (default %.2f)\n", DEFAULT_ALPHA);
+    fprintf(stderr, "  --accurate       Run ROMs with the pixel FIFO renderer\n");
+}
+
+static double Since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void ResetRegisters(SM83State* state) {
+    state->setAF(0x3C00);
+    state->setBC(0xC010);
+    state->setDE(0xC020);
+    state->setHL(0xC030);
+    state->setStackPointer(0xDFF0);
+    state->setProgramCounter(CODE_ADDRESS);
+}
+
+/**
+ * @brief Times one handler at a fixed PC with fixed registers
+ *
+ * @return double Nanoseconds per call, including the register reset
+ */
+static double SampleHandler(uint8_t op_code) {
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    SM83State state(memory.data());
+    memory[CODE_ADDRESS] = op_code;
+    memory[CODE_ADDRESS + 1] = 0x30;
+    memory[CODE_ADDRESS + 2] = 0xC0;
+    OpCodeHandler handler = OpCodeHandlerFor(op_code);
+
+    uint64_t cycles = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < HANDLER_CALLS; i++) {
+        ResetRegisters(&state);
+        cycles += handler(&state);
+    }
+    double seconds = Since(start);
+
+    // Keeps the loop from being optimised away
+    if (cycles == 0) {
+        fprintf(stderr, "Handler 0x%02X took no cycles\n", op_code);
+    }
+    return seconds * 1e9 / HANDLER_CALLS;
+}
+
+/**
+ * @brief Times SM83Emulator::Step over a fixed random stream of register op codes
+ *
+ * @return double Instructions per second
+ */
+static double SampleDispatch() {
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    SM83State state(memory.data());
+    SM83Emulator emulator(&state);
+
+    std::mt19937 random(42);
+    for (int i = 0; i < 1024; i++) {
+        memory[CODE_ADDRESS + i] = ALU_OP_CODES[random() % sizeof(ALU_OP_CODES)];
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < DISPATCH_INSTRUCTIONS / 1024; run++) {
+        ResetRegisters(&state);
+        for (int i = 0; i < 1024; i++) {
+            emulator.Step();
+        }
+    }
+    return DISPATCH_INSTRUCTIONS / Since(start);
+}
+
+/**
+ * @brief Runs a ROM headless, draining audio every frame as lameboy-headless does
+ *
+ * @param frames_per_second Receives the frames run per second
+ * @param instructions_per_second Receives the CPU instructions run per second
+ * @return true if the ROM loaded
+ * @throws std::runtime_error if the ROM reaches an unimplemented op code
+ */
+static bool SampleROM(const char* path, PPUKind ppu_kind, long frames, double* frames_per_second, double* instructions_per_second) {
+    GameBoy game_boy(ppu_kind);
+    if (!game_boy.LoadROMFile(path)) {
+        return false;
+    }
+
+    for (long frame = 0; frame < WARMUP_FRAMES; frame++) {
+        game_boy.RunFrame();
+        game_boy.ReadAudio(nullptr, game_boy.audioSamplesAvailable());
+    }
+
+    uint64_t first_instruction = game_boy.instructions();
+    auto start = std::chrono::steady_clock::now();
+    for (long frame = 0; frame < frames; frame++) {
+        game_boy.RunFrame();
+        game_boy.ReadAudio(nullptr, game_boy.audioSamplesAvailable());
+    }
+    double seconds = Since(start);
+
+    *frames_per_second = frames / seconds;
+    *instructions_per_second = (game_boy.instructions() - first_instruction) / seconds;
+    return true;
+}
+
+/**
+ * @brief Gets the file name of a path, which names the ROM metrics
+ *
+ */
+static std::string ROMName(const char* path) {
+    const char* name = strrchr(path, '/');
+    return name != nullptr ? name + 1 : path;
+}
+
+static PerfMetric* FindMetric(std::vector<PerfMetric>* metrics, const std::string& name) {
+    for (PerfMetric& metric : *metrics) {
+        if (metric.name == name) {
+            return &metric;
+        }
+    }
+    return nullptr;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3 || (strcmp(argv[1], "record") != 0 && strcmp(argv[1], "compare") != 0)) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    bool record = strcmp(argv[1], "record") == 0;
+    const char* baseline_path = argv[2];
+    int repeats = DEFAULT_REPEATS;
+    long frames = DEFAULT_FRAMES;
+    double threshold = DEFAULT_THRESHOLD;
+    double alpha = DEFAULT_ALPHA;
+    PPUKind ppu_kind = FAST_PPU;
+    std::vector<const char*> roms;
+
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--repeats") == 0 && i + 1 < argc) {
+            repeats = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = strtol(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = atof(argv[++i]) / 100;
+        } else if (strcmp(argv[i], "--alpha") == 0 && i + 1 < argc) {
+            alpha = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--accurate") == 0) {
+            ppu_kind = ACCURATE_PPU;
+        } else if (argv[i][0] != '-') {
+            roms.push_back(argv[i]);
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    // Fewer than 5 samples a side can never reach p < 0.01
+    if (repeats < 5 || frames < 1 || threshold < 0 || alpha <= 0) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    std::vector<PerfMetric> baseline;
+    if (!record && !LoadPerfBaseline(baseline_path, &baseline)) {
+        fprintf(stderr, "Could not read a baseline from %s\n", baseline_path);
+        return 2;
+    }
+
+    std::vector<PerfMetric> metrics;
+    std::vector<uint8_t> op_codes;
+    for (int op_code = 0; op_code < 0x100; op_code++) {
+        if (OpCodeHandlerFor((uint8_t)op_code) != nullptr) {
+            char name[32];
+            snprintf(name, sizeof(name), "execute/%02X", op_code);
+            metrics.push_back(PerfMetric{ name, "ns/op", false, {} });
+            op_codes.push_back((uint8_t)op_code);
+        }
+    }
+    metrics.push_back(PerfMetric{ "dispatch/alu", "instr/s", true, {} });
+    for (const char* rom : roms) {
+        metrics.push_back(PerfMetric{ "rom/" + ROMName(rom) + "/frames", "frames/s", true, {} });
+        metrics.push_back(PerfMetric{ "rom/" + ROMName(rom) + "/instructions", "instr/s", true, {} });
+    }
+
+    // Interleaves the repeats so that a slow patch on the machine spreads over every metric
+    try {
+        for (int repeat = 0; repeat < repeats; repeat++) {
+            size_t next = 0;
+            for (uint8_t op_code : op_codes) {
+                metrics[next++].samples.push_back(SampleHandler(op_code));
+            }
+            metrics[next++].samples.push_back(SampleDispatch());
+
+            for (const char* rom : roms) {
+                double frames_per_second;
+                double instructions_per_second;
+                if (!SampleROM(rom, ppu_kind, frames, &frames_per_second, &instructions_per_second)) {
+                    fprintf(stderr, "Could not read a ROM from %s\n", rom);
+                    return 2;
+                }
+                metrics[next++].samples.push_back(frames_per_second);
+                metrics[next++].samples.push_back(instructions_per_second);
+            }
+            fprintf(stderr, "\rrun %d/%d", repeat + 1, repeats);
+        }
+        fprintf(stderr, "\n");
+    } catch (const std::runtime_error& error) {
+        fprintf(stderr, "\n%s\n", error.what());
+        return 2;
+    }
+
+    if (record) {
+        if (!SavePerfBaseline(baseline_path, metrics)) {
+            fprintf(stderr, "Could not write %s\n", baseline_path);
+            return 2;
+        }
+
+        printf("%-36s %-9s %14s\n", "metric", "unit", "median");
+        for (const PerfMetric& metric : metrics) {
+            printf("%-36s %-9s %14.6g\n", metric.name.c_str(), metric.unit.c_str(), Median(metric.samples));
+        }
+        printf("Saved %zu metrics to %s\n", metrics.size(), baseline_path);
+        return 0;
+    }
+
+    size_t compared_count = 0;
+    for (const PerfMetric& metric : metrics) {
+        if (FindMetric(&baseline, metric.name) != nullptr) {
+            compared_count++;
+        }
+    }
+
+    // Regressions are decided by the Holm procedure over every p value. Improvements are only
+    // informational, so a plain Bonferroni correction is enough for them
+    std::vector<PerfComparison> comparisons(metrics.size());
+    std::vector<double> p_values;
+    for (size_t i = 0; i < metrics.size(); i++) {
+        PerfMetric* stored = FindMetric(&baseline, metrics[i].name);
+        if (stored != nullptr) {
+            comparisons[i] = ComparePerfMetric(*stored, metrics[i], threshold, alpha / compared_count);
+            p_values.push_back(comparisons[i].p_value);
+        }
+    }
+    std::vector<bool> significant = HolmSignificant(p_values, alpha);
+
+    int regressions = 0;
+    size_t compared = 0;
+    printf("%-36s %-9s %14s %14s %9s %9s  %s\n", "metric", "unit", "baseline", "current", "change", "p", "result");
+    for (size_t i = 0; i < metrics.size(); i++) {
+        const PerfMetric& metric = metrics[i];
+        PerfMetric* stored = FindMetric(&baseline, metric.name);
+        if (stored == nullptr) {
+            printf("%-36s %-9s %14s %14.6g %9s %9s  new\n", metric.name.c_str(), metric.unit.c_str(), "-", Median(metric.samples), "-", "-");
+            continue;
+        }
+
+        const PerfComparison& comparison = comparisons[i];
+        const char* result = "ok";
+        if (significant[compared++]) {
+            result = "REGRESSION";
+            regressions++;
+        } else if (comparison.improvement) {
+            result = "improved";
+        }
+
+        printf("%-36s %-9s %14.6g %14.6g %+8.1f%% %9.2g  %s\n", metric.name.c_str(), metric.unit.c_str(),
+            Median(stored->samples), Median(metric.samples), comparison.change * 100, comparison.p_value, result);
+    }
+
+    for (const PerfMetric& metric : baseline) {
+        if (FindMetric(&metrics, metric.name) == nullptr) {
+            printf("%-36s %-9s %14.6g %14s %9s %9s  not measured\n", metric.name.c_str(), metric.unit.c_str(), Median(metric.samples), "-", "-", "-");
+        }
+    }
+
+    if (regressions > 0) {
+        printf("%d metrics regressed by more than %.1f%% (p < %g)\n", regressions, threshold * 100, alpha);
+        return 1;
+    }
+    printf("No regressions beyond %.1f%% (p < %g)\n", threshold * 100, alpha);
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file bench_resampler.cpp
+ * @brief Measures the resampler's speed at every SIMD level, its latency and its quality
+ *
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../src/audio/resampler.hpp"
+
+static const int DEFAULT_ITERATIONS = 20000;
+
+// One DMG frame of audio at 48kHz, the batch size the emulator uses
+static const size_t BATCH = 803;
+
+static const double PI = 3.14159265358979323846;
+
+// Real time length of a frame
+static const double FRAME_NS = 1e9 * 70224 / 4194304.0;
+
+/**
+ * @brief Times one kernel on frame sized batches, returning the mean nanoseconds per batch
+ *
+ */
+static double TimeBatches(SIMDLevel level, uint32_t output_rate, const std::vector<float>& input, int iterations) {
+    Resampler resampler(48000, output_rate, level);
+    std::vector<float> output(resampler.MaxOutput(BATCH, 0.005) * 2);
+
+    for (int i = 0; i < iterations / 10 + 1; i++) {
+        resampler.Process(input.data(), BATCH, output.data(), 0.002);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        resampler.Process(input.data(), BATCH, output.data(), 0.002);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+/**
+ * @brief Resamples a second of a sine from 48kHz to 44.1kHz
+ *
+ * @return double The RMS difference from the ideal output in dB relative to the tone, or the
+ * output level in dB for tones above the output Nyquist frequency, which should vanish
+ */
+static double ToneQuality(double frequency) {
+    const uint32_t input_rate = 48000;
+    const uint32_t output_rate = 44100;
+    Resampler resampler(input_rate, output_rate, SIMD_SCALAR);
+
+    std::vector<float> input(input_rate * 2);
+    for (uint32_t i = 0; i < input_rate; i++) {
+        input[i * 2] = input[i * 2 + 1] = (float)sin(2 * PI * frequency * i / input_rate);
+    }
+
+    std::vector<float> output(resampler.MaxOutput(input_rate) * 2);
+    size_t produced = resampler.Process(input.data(), input_rate, output.data());
+
+    bool aliased = frequency > output_rate / 2;
+    double step = (double)input_rate / output_rate;
+    double sum = 0;
+    size_t count = 0;
+    for (size_t n = RESAMPLER_TAPS; n < produced; n++) {
+        double ideal = aliased ? 0.0 : sin(2 * PI * frequency * n * step / input_rate);
+        double error = output[n * 2] - ideal;
+        sum += error * error;
+        count++;
+    }
+
+    // Relative to the RMS of a full scale sine
+    return 20 * log10(sqrt(sum / count) / sqrt(0.5) + 1e-12);
+}
+
+/**
+ * @brief Finds how many output samples an impulse takes to reach its peak, including samples held back
+ *
+ */
+static size_t ImpulseDelay() {
+    Resampler resampler(48000, 48000, SIMD_SCALAR);
+    std::vector<float> input(BATCH * 2, 0.0f);
+    std::vector<float> output(resampler.MaxOutput(BATCH) * 2);
+
+    input[0] = input[1] = 1.0f;
+    size_t produced = resampler.Process(input.data(), BATCH, output.data());
+
+    size_t peak = 0;
+    for (size_t n = 1; n < produced; n++) {
+        if (output[n * 2] > output[peak * 2]) {
+            peak = n;
+        }
+    }
+    return peak;
+}
+
+int main(int argc, char *argv[])
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : DEFAULT_ITERATIONS;
+    if (iterations < 1) {
+        fprintf(stderr, "Usage: %s [ITERATIONS]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<float> input(BATCH * 2);
+    for (size_t i = 0; i < BATCH; i++) {
+        input[i * 2] = (float)sin(i * 0.05);
+        input[i * 2 + 1] = (float)cos(i * 0.07);
+    }
+
+    printf("Speed, frame sized batches of %zu stereo samples from 48kHz\n", BATCH);
+    printf("%-8s %-7s %12s %12s %16s\n", "output", "simd", "us/batch", "ns/sample", "% of 10x frame");
+    for (uint32_t output_rate : { 44100u, 48000u }) {
+        for (int level = SIMD_SCALAR; level <= SIMD_AVX2; level++) {
+            if (!SIMDLevelSupported((SIMDLevel)level)) {
+                continue;
+            }
+
+            double ns = TimeBatches((SIMDLevel)level, output_rate, input, iterations);
+            double samples = BATCH * (double)output_rate / 48000;
+            printf("%-8u %-7s %12.2f %12.2f %15.2f%%\n", output_rate, SIMDLevelName((SIMDLevel)level),
+                ns / 1000.0, ns / samples, 100.0 * ns / (FRAME_NS / 10));
+        }
+    }
+
+    Resampler resampler(48000, 44100, SIMD_SCALAR);
+    printf("\nLatency\n");
+    printf("held back         %zu samples, %.3f ms at 48kHz\n", resampler.latency(), resampler.latency() * 1000.0 / 48000);
+    printf("impulse peak      output sample %zu, output n lines up with input time n * step\n", ImpulseDelay());
+
+    printf("\nQuality, 48kHz to 44.1kHz\n");
+    printf("%-10s %14s\n", "tone Hz", "error dB");
+    for (double frequency : { 100.0, 1000.0, 5000.0, 10000.0, 15000.0, 18000.0 }) {
+        printf("%-10.0f %14.1f\n", frequency, ToneQuality(frequency));
+    }
+    printf("%-10s %14s\n", "alias Hz", "level dB");
+    for (double frequency : { 22500.0, 23000.0, 23500.0, 23900.0 }) {
+        printf("%-10.0f %14.1f\n", frequency, ToneQuality(frequency));
+    }
+
+    return 0;
+}
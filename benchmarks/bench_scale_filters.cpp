@@ -0,0 +1,80 @@
+/**
+ * @file bench_scale_filters.cpp
+ * @brief Measures every scaling filter at every factor and SIMD level on a 160x144 frame
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "../src/ppu/ppu_registers.hpp"
+#include "../src/video/scale_filters.hpp"
+
+// Repeats per measurement, enough to run for a few milliseconds at the fastest setting
+static const int DEFAULT_ITERATIONS = 2000;
+
+/**
+ * @brief Times one filter, returning the mean nanoseconds per frame
+ *
+ */
+static double TimeFilter(ScaleFilter filter, int factor, SIMDLevel level, const uint32_t* frame, std::vector<uint32_t>& output, int iterations) {
+    // Warm up caches and let the CPU settle on a clock speed
+    for (int i = 0; i < iterations / 10 + 1; i++) {
+        ScaleFrame(filter, factor, frame, SCREEN_WIDTH, SCREEN_HEIGHT, output.data(), SCREEN_WIDTH * factor, level);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        ScaleFrame(filter, factor, frame, SCREEN_WIDTH, SCREEN_HEIGHT, output.data(), SCREEN_WIDTH * factor, level);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+int main(int argc, char *argv[])
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : DEFAULT_ITERATIONS;
+    if (iterations < 1) {
+        fprintf(stderr, "Usage: %s [ITERATIONS]\n", argv[0]);
+        return 2;
+    }
+
+    // A frame of DMG shades with runs, like typical game content
+    std::vector<uint32_t> frame(SCREEN_PIXELS);
+    std::mt19937 random(1);
+    for (int i = 0; i < SCREEN_PIXELS; i++) {
+        frame[i] = random() % 4 == 0 ? DMG_SHADES[random() % 4] : frame[i > 0 ? i - 1 : 0];
+    }
+
+    std::vector<uint32_t> output(SCREEN_PIXELS * MAX_SCALE_FACTOR * MAX_SCALE_FACTOR);
+
+    struct Case {
+        const char* name;
+        ScaleFilter filter;
+        int factor;
+    };
+    const Case cases[] = {
+        { "nearest", NEAREST_FILTER, 2 }, { "nearest", NEAREST_FILTER, 3 }, { "nearest", NEAREST_FILTER, 4 },
+        { "nearest", NEAREST_FILTER, 5 }, { "nearest", NEAREST_FILTER, 6 },
+        { "scale2x", SCALE2X_FILTER, 2 }, { "scale3x", SCALE3X_FILTER, 3 },
+        { "lcd", LCD_GRID_FILTER, 2 }, { "lcd", LCD_GRID_FILTER, 3 }, { "lcd", LCD_GRID_FILTER, 4 },
+        { "lcd", LCD_GRID_FILTER, 5 }, { "lcd", LCD_GRID_FILTER, 6 },
+    };
+
+    printf("%-8s %6s %-7s %12s %10s\n", "filter", "factor", "simd", "us/frame", "fps");
+    for (const Case& test : cases) {
+        for (int level = SIMD_SCALAR; level <= SIMD_AVX2; level++) {
+            if (!SIMDLevelSupported((SIMDLevel)level)) {
+                continue;
+            }
+
+            double ns = TimeFilter(test.filter, test.factor, (SIMDLevel)level, frame.data(), output, iterations);
+            printf("%-8s %6d %-7s %12.2f %10.0f\n", test.name, test.factor, SIMDLevelName((SIMDLevel)level), ns / 1000.0, 1e9 / ns);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file apu.cpp
+ * @brief Implementation of the audio processing unit
+ *
+ */
+
+#include "./apu.hpp"
+#include "../ppu/ppu_registers.hpp"
+
+// A frame can overrun by one instruction, allow for a whole extra frame to be safe
+static const uint32_t MAX_FRAME_CLOCKS = DOTS_PER_FRAME * 2;
+
+APU::APU(uint8_t* memory_bus_ptr, Scheduler* scheduler, uint32_t sample_rate)
+    : mixer_(sample_rate, MAX_FRAME_CLOCKS),
+      square1_(memory_bus_ptr, &mixer_, 0xFF10, 0, true),
+      square2_(memory_bus_ptr, &mixer_, 0xFF15, 1, false),
+      wave_(memory_bus_ptr, &mixer_),
+      noise_(memory_bus_ptr, &mixer_) {
+    this->memory_bus_ = memory_bus_ptr;
+    this->scheduler_ = scheduler;
+    this->time_ = scheduler->now();
+    this->sequencer_time_ = this->time_ + FRAME_SEQUENCER_CLOCKS;
+    this->sequencer_step_ = 0;
+    this->powered_ = true;
+
+    this->mixer_.SetMasterControl(this->time_, memory_bus_ptr[NR50_ADDRESS], memory_bus_ptr[NR51_ADDRESS]);
+    this->UpdateStatus();
+}
+
+void APU::RunUntil(uint64_t to) {
+    while (this->time_ < to) {
+        uint64_t next = this->sequencer_time_ < to ? this->sequencer_time_ : to;
+
+        this->square1_.Run(next);
+        this->square2_.Run(next);
+        this->wave_.Run(next);
+        this->noise_.Run(next);
+        this->time_ = next;
+
+        if (next == this->sequencer_time_) {
+            this->ClockSequencer(next);
+            this->sequencer_time_ += FRAME_SEQUENCER_CLOCKS;
+        }
+    }
+}
+
+void APU::ClockSequencer(uint64_t time) {
+    uint8_t step = this->sequencer_step_;
+    this->sequencer_step_ = (step + 1) & 7;
+
+    if ((step & 1) == 0) {
+        this->square1_.ClockLength(time);
+        this->square2_.ClockLength(time);
+        this->wave_.ClockLength(time);
+        this->noise_.ClockLength(time);
+    }
+    if (step == 2 || step == 6) {
+        this->square1_.ClockSweep(time);
+    }
+    if (step == 7) {
+        this->square1_.ClockEnvelope(time);
+        this->square2_.ClockEnvelope(time);
+        this->noise_.ClockEnvelope(time);
+    }
+
+    this->UpdateStatus();
+}
+
+void APU::EndFrame() {
+    uint64_t now = this->scheduler_->now();
+    this->RunUntil(now);
+    this->mixer_.EndFrame(now);
+}
+
+size_t APU::samplesAvailable() {
+    return this->mixer_.samplesAvailable();
+}
+
+size_t APU::ReadSamples(float* out, size_t count) {
+    return this->mixer_.ReadSamples(out, count);
+}
+
+void APU::CopyStateFrom(const APU& other) {
+    // Assignment reuses the sample buffers, which are the same size at the same sample rate
+    this->mixer_ = other.mixer_;
+
+    this->square1_ = other.square1_;
+    this->square2_ = other.square2_;
+    this->wave_ = other.wave_;
+    this->noise_ = other.noise_;
+    this->square1_.Rebind(this->memory_bus_, &this->mixer_);
+    this->square2_.Rebind(this->memory_bus_, &this->mixer_);
+    this->wave_.Rebind(this->memory_bus_, &this->mixer_);
+    this->noise_.Rebind(this->memory_bus_, &this->mixer_);
+
+    this->time_ = other.time_;
+    this->sequencer_time_ = other.sequencer_time_;
+    this->sequencer_step_ = other.sequencer_step_;
+    this->powered_ = other.powered_;
+}
+
+void APU::OnMemoryWrite(uint16_t address, uint8_t value) {
+    if (address < NR10_ADDRESS || address > APU_LAST_ADDRESS) {
+        return;
+    }
+
+    uint64_t now = this->scheduler_->now();
+    this->RunUntil(now);
+    this->WriteRegister(address, value, now);
+}
+
+void APU::WriteRegister(uint16_t address, uint8_t value, uint64_t time) {
+    if (address >= WAVE_RAM_ADDRESS) {
+        // The channels have caught up, so wave RAM changes are heard from now on
+        return;
+    }
+
+    if (address == NR52_ADDRESS) {
+        bool powered = (value & NR52_POWER) > 0;
+
+        if (!powered && this->powered_) {
+            // Powering off clears every sound register and silences the channels
+            for (uint16_t reg = NR10_ADDRESS; reg < NR52_ADDRESS; reg++) {
+                this->memory_bus_[reg] = 0;
+            }
+            this->square1_.Disable(time);
+            this->square2_.Disable(time);
+            this->wave_.Disable(time);
+            this->noise_.Disable(time);
+            this->mixer_.SetMasterControl(time, 0, 0);
+        } else if (powered && !this->powered_) {
+            this->sequencer_step_ = 0;
+        }
+
+        this->powered_ = powered;
+        this->UpdateStatus();
+        return;
+    }
+
+    // Registers are read only while the APU is off
+    if (!this->powered_) {
+        this->memory_bus_[address] = 0;
+        return;
+    }
+
+    if (address <= 0xFF14) {
+        this->square1_.Write(address, value, time);
+    } else if (address <= 0xFF19) {
+        this->square2_.Write(address, value, time);
+    } else if (address <= 0xFF1E) {
+        this->wave_.Write(address, value, time);
+    } else if (address <= 0xFF23) {
+        this->noise_.Write(address, value, time);
+    } else if (address == NR50_ADDRESS || address == NR51_ADDRESS) {
+        this->mixer_.SetMasterControl(time, this->memory_bus_[NR50_ADDRESS], this->memory_bus_[NR51_ADDRESS]);
+    }
+
+    this->UpdateStatus();
+}
+
+void APU::UpdateStatus() {
+    uint8_t status = this->powered_ ? NR52_POWER | 0x70 : 0x70;
+
+    status |= this->square1_.enabled() ? 0x01 : 0;
+    status |= this->square2_.enabled() ? 0x02 : 0;
+    status |= this->wave_.enabled() ? 0x04 : 0;
+    status |= this->noise_.enabled() ? 0x08 : 0;
+
+    this->memory_bus_[NR52_ADDRESS] = status;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file apu.hpp
+ * @brief The DMG audio processing unit, synthesised lazily from register writes
+ *
+ */
+
+#ifndef APU_H
+#define APU_H
+
+#include <cstddef>
+#include <cstdint>
+#include "../core/scheduler.hpp"
+#include "../cpu/memory_observer.hpp"
+#include "./apu_mixer.hpp"
+#include "./sound_channels.hpp"
+
+// Sound registers
+static const uint16_t NR10_ADDRESS = 0xFF10;
+static const uint16_t NR50_ADDRESS = 0xFF24;
+static const uint16_t NR51_ADDRESS = 0xFF25;
+static const uint16_t NR52_ADDRESS = 0xFF26;
+static const uint16_t WAVE_RAM_ADDRESS = 0xFF30;
+static const uint16_t APU_LAST_ADDRESS = 0xFF3F;
+
+// Bit 7 of NR52 powers the APU
+static const uint8_t NR52_POWER = 0b10000000;
+
+// The frame sequencer clocks lengths, sweeps and envelopes at 512Hz
+static const uint32_t FRAME_SEQUENCER_CLOCKS = 8192;
+
+static const uint32_t DEFAULT_SAMPLE_RATE = 48000;
+
+/**
+ * @brief Synthesises the four DMG sound channels without being ticked.
+ *
+ * Nothing runs while the CPU executes. When a sound register is written the APU first catches every
+ * channel up to the time of the write, then applies it; EndFrame() catches up to the end of the
+ * frame and hands a frame's worth of samples to the mixer's band-limited buffers. Catching up steps
+ * each channel from one waveform change to the next, so the cost follows the number of amplitude
+ * changes rather than the clock rate.
+ *
+ * The APU registers itself with the SM83State for writes to page 0xFF.
+ */
+class APU : public MemoryObserver
+{
+
+private:
+
+    uint8_t* memory_bus_;
+    Scheduler* scheduler_;
+
+    APUMixer mixer_;
+    SquareChannel square1_;
+    SquareChannel square2_;
+    WaveChannel wave_;
+    NoiseChannel noise_;
+
+    // The channels have been run up to this clock
+    uint64_t time_;
+
+    // Clock of the next frame sequencer step, and which of its 8 steps that is
+    uint64_t sequencer_time_;
+    uint8_t sequencer_step_;
+
+    bool powered_;
+
+    /**
+     * @brief Runs every channel and the frame sequencer up to a clock
+     *
+     * @param to The clock to run until
+     */
+    void RunUntil(uint64_t to);
+
+    /**
+     * @brief Clocks the lengths, sweep and envelopes due on the current frame sequencer step
+     *
+     * @param time The clock of the step
+     */
+    void ClockSequencer(uint64_t time);
+
+    /**
+     * @brief Handles a write to a sound register after the channels have caught up
+     *
+     * @param address The register written to
+     * @param value The value written
+     * @param time The clock of the write
+     */
+    void WriteRegister(uint16_t address, uint8_t value, uint64_t time);
+
+    /**
+     * @brief Updates the read only channel status bits of NR52
+     *
+     */
+    void UpdateStatus();
+
+public:
+    /**
+     * @brief Constructs a new APU, powered on with every channel silent
+     *
+     * @param memory_bus_ptr Pointer to the memory bus holding the sound registers
+     * @param scheduler The clock register writes are timed with
+     * @param sample_rate Output samples per second
+     */
+    APU(uint8_t* memory_bus_ptr, Scheduler* scheduler, uint32_t sample_rate = DEFAULT_SAMPLE_RATE);
+
+    /**
+     * @brief Catches up to the current time and makes the frame's samples available
+     *
+     */
+    void EndFrame();
+
+    /**
+     * @brief Gets the number of stereo samples ready to be read
+     *
+     */
+    size_t samplesAvailable();
+
+    /**
+     * @brief Reads stereo samples, removing them from the APU
+     *
+     * @param out Receives the samples, left then right, or nullptr to discard them
+     * @param count The maximum number of stereo samples to read
+     * @return size_t The number of stereo samples read
+     */
+    size_t ReadSamples(float* out, size_t count);
+
+    /**
+     * @brief Catches the channels up and applies writes to the sound registers
+     *
+     * @param address The 16bit address written to
+     * @param value The value written
+     */
+    void OnMemoryWrite(uint16_t address, uint8_t value) override;
+
+    /**
+     * @brief Copies the channels, frame sequencer and unread samples of another APU with the same sample rate
+     *
+     * @param other The APU to copy
+     */
+    void CopyStateFrom(const APU& other);
+};
+
+#endif
@@ -0,0 +1,70 @@
+/**
+ * @file apu_mixer.cpp
+ * @brief Implementation of the APU mixer
+ *
+ */
+
+#include "./apu_mixer.hpp"
+
+// The DMG's clock rate, which is also the rate of the times channels report
+static const uint32_t APU_CLOCK_RATE = 4194304;
+
+// Four channels at full volume through the loudest master volume reach 1.0
+static const float LEVEL_SCALE = 1.0f / (APU_CHANNELS * 15 * 8);
+
+APUMixer::APUMixer(uint32_t sample_rate, uint32_t max_frame_clocks)
+    : left_(APU_CLOCK_RATE, sample_rate, max_frame_clocks), right_(APU_CLOCK_RATE, sample_rate, max_frame_clocks) {
+    this->frame_start_ = 0;
+    this->panning_ = 0;
+    this->left_volume_ = 1;
+    this->right_volume_ = 1;
+
+    for (int i = 0; i < APU_CHANNELS; i++) {
+        this->amplitudes_[i] = 0;
+        this->left_levels_[i] = 0;
+        this->right_levels_[i] = 0;
+    }
+}
+
+void APUMixer::UpdateLevels(int channel, uint64_t time) {
+    uint32_t clock_time = (uint32_t)(time - this->frame_start_);
+    float amplitude = this->amplitudes_[channel] * LEVEL_SCALE;
+
+    float left = (this->panning_ & (0x10 << channel)) > 0 ? amplitude * this->left_volume_ : 0.0f;
+    float right = (this->panning_ & (0x01 << channel)) > 0 ? amplitude * this->right_volume_ : 0.0f;
+
+    if (left != this->left_levels_[channel]) {
+        this->left_.AddDelta(clock_time, left - this->left_levels_[channel]);
+        this->left_levels_[channel] = left;
+    }
+    if (right != this->right_levels_[channel]) {
+        this->right_.AddDelta(clock_time, right - this->right_levels_[channel]);
+        this->right_levels_[channel] = right;
+    }
+}
+
+void APUMixer::SetMasterControl(uint64_t time, uint8_t nr50, uint8_t nr51) {
+    this->panning_ = nr51;
+    this->left_volume_ = (uint8_t)(((nr50 >> 4) & 0x07) + 1);
+    this->right_volume_ = (uint8_t)((nr50 & 0x07) + 1);
+
+    for (int i = 0; i < APU_CHANNELS; i++) {
+        this->UpdateLevels(i, time);
+    }
+}
+
+void APUMixer::EndFrame(uint64_t time) {
+    uint32_t clocks = (uint32_t)(time - this->frame_start_);
+    this->left_.EndFrame(clocks);
+    this->right_.EndFrame(clocks);
+    this->frame_start_ = time;
+}
+
+size_t APUMixer::samplesAvailable() {
+    return this->left_.samplesAvailable();
+}
+
+size_t APUMixer::ReadSamples(float* out, size_t count) {
+    this->left_.ReadSamples(out, count, 2);
+    return this->right_.ReadSamples(out == nullptr ? nullptr : out + 1, count, 2);
+}
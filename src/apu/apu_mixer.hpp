@@ -0,0 +1,109 @@
+/**
+ * @file apu_mixer.hpp
+ * @brief Pans and scales the sound channels into a pair of band-limited buffers
+ *
+ */
+
+#ifndef APU_MIXER_H
+#define APU_MIXER_H
+
+#include <cstddef>
+#include <cstdint>
+#include "./blip_buffer.hpp"
+
+static const int APU_CHANNELS = 4;
+
+/**
+ * @brief Turns the amplitude of each channel over time into stereo samples.
+ *
+ * Channels report their 4 bit output whenever it changes, along with the clock it changed on. The
+ * mixer applies NR50 and NR51 and forwards the change in each side's level to that side's
+ * BlipBuffer, so a channel holding a level costs nothing.
+ */
+class APUMixer
+{
+
+private:
+
+    BlipBuffer left_;
+    BlipBuffer right_;
+
+    // Clock at which the current frame started
+    uint64_t frame_start_;
+
+    // NR51, bits 0-3 route channels 1-4 to the right and bits 4-7 to the left
+    uint8_t panning_;
+
+    // NR50 volumes plus one, 1-8
+    uint8_t left_volume_;
+    uint8_t right_volume_;
+
+    // The last output of each channel and the level it contributes to each side
+    uint8_t amplitudes_[APU_CHANNELS];
+    float left_levels_[APU_CHANNELS];
+    float right_levels_[APU_CHANNELS];
+
+    /**
+     * @brief Recomputes a channel's contribution to each side, adding the differences to the buffers
+     *
+     * @param channel The channel, 0-3
+     * @param time The clock of the change
+     */
+    void UpdateLevels(int channel, uint64_t time);
+
+public:
+    /**
+     * @brief Constructs a new APUMixer with all channels silent
+     *
+     * @param sample_rate Output samples per second
+     * @param max_frame_clocks The longest frame that will be passed to EndFrame
+     */
+    APUMixer(uint32_t sample_rate, uint32_t max_frame_clocks);
+
+    /**
+     * @brief Sets the output of a channel
+     *
+     * @param channel The channel, 0-3
+     * @param time The clock of the change, no earlier than the start of the frame
+     * @param amplitude The channel output, 0-15
+     */
+    void SetAmplitude(int channel, uint64_t time, uint8_t amplitude) {
+        if (this->amplitudes_[channel] != amplitude) {
+            this->amplitudes_[channel] = amplitude;
+            this->UpdateLevels(channel, time);
+        }
+    }
+
+    /**
+     * @brief Applies new master volume and panning registers
+     *
+     * @param time The clock of the write
+     * @param nr50 The NR50 register
+     * @param nr51 The NR51 register
+     */
+    void SetMasterControl(uint64_t time, uint8_t nr50, uint8_t nr51);
+
+    /**
+     * @brief Ends the current frame, making its samples available
+     *
+     * @param time The clock the frame ends on and the next one starts on
+     */
+    void EndFrame(uint64_t time);
+
+    /**
+     * @brief Gets the number of stereo samples ready to be read
+     *
+     */
+    size_t samplesAvailable();
+
+    /**
+     * @brief Reads stereo samples, removing them from the buffers
+     *
+     * @param out Receives the samples, left then right, or nullptr to discard them
+     * @param count The maximum number of stereo samples to read
+     * @return size_t The number of stereo samples read
+     */
+    size_t ReadSamples(float* out, size_t count);
+};
+
+#endif
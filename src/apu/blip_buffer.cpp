@@ -0,0 +1,120 @@
+/**
+ * @file blip_buffer.cpp
+ * @brief Implementation of the band-limited step buffer
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "./blip_buffer.hpp"
+
+// Cutoff of the impulse as a fraction of the output sample rate, a little below Nyquist
+static const double CUTOFF = 0.45;
+
+// Charge kept by the DMG's output capacitor per clock, which removes the DC offset of the channels
+static const double CAPACITOR_CHARGE_PER_CLOCK = 0.999958;
+
+// Frames that may be left unread before the oldest samples are dropped
+static const size_t UNREAD_FRAMES = 4;
+
+static const double PI = 3.14159265358979323846;
+
+BlipBuffer::BlipBuffer(uint32_t clock_rate, uint32_t sample_rate, uint32_t max_frame_clocks) {
+    this->factor_ = ((uint64_t)sample_rate << 32) / clock_rate;
+    this->offset_ = 0;
+    this->available_ = 0;
+    this->integrator_ = 0;
+    this->capacitor_ = 0;
+    this->charge_factor_ = (float)pow(CAPACITOR_CHARGE_PER_CLOCK, (double)clock_rate / sample_rate);
+
+    // Room for the frame being built, its impulse tails and a few frames not yet read
+    this->max_frame_samples_ = this->SamplesForClocks(max_frame_clocks) + 1;
+    this->deltas_.assign(this->max_frame_samples_ * (UNREAD_FRAMES + 1) + BLIP_TAPS, 0.0f);
+
+    // Windowed sinc impulses, centred between taps BLIP_TAPS / 2 - 1 and BLIP_TAPS / 2
+    for (int phase = 0; phase < BLIP_PHASES; phase++) {
+        double fraction = (double)phase / BLIP_PHASES;
+        double sum = 0;
+
+        for (int tap = 0; tap < BLIP_TAPS; tap++) {
+            double x = tap - (BLIP_TAPS / 2 - 1) - fraction;
+            double sinc = x == 0 ? 1.0 : sin(2 * PI * CUTOFF * x) / (2 * PI * CUTOFF * x);
+            double window = 0.5 + 0.5 * cos(PI * x / (BLIP_TAPS / 2));
+            this->kernel_[phase][tap] = (float)(sinc * window);
+            sum += sinc * window;
+        }
+        for (int tap = 0; tap < BLIP_TAPS; tap++) {
+            this->kernel_[phase][tap] = (float)(this->kernel_[phase][tap] / sum);
+        }
+    }
+}
+
+void BlipBuffer::EndFrame(uint32_t clocks) {
+    uint64_t position = this->offset_ + clocks * this->factor_;
+    size_t samples = (size_t)(position >> 32);
+    this->offset_ = position & 0xFFFFFFFF;
+
+    this->available_ += samples;
+
+    // If nothing has been read for a while, drop the oldest samples rather than overflow
+    size_t limit = this->max_frame_samples_ * UNREAD_FRAMES;
+    if (this->available_ > limit) {
+        this->Consume(this->available_ - limit, nullptr, 1);
+    }
+}
+
+size_t BlipBuffer::samplesAvailable() {
+    return this->available_;
+}
+
+size_t BlipBuffer::SamplesForClocks(uint32_t clocks) {
+    return (size_t)((clocks * this->factor_) >> 32) + 1;
+}
+
+size_t BlipBuffer::ReadSamples(float* out, size_t count, size_t stride) {
+    if (count > this->available_) {
+        count = this->available_;
+    }
+    this->Consume(count, out, stride);
+    return count;
+}
+
+void BlipBuffer::Consume(size_t count, float* out, size_t stride) {
+    if (count > this->available_) {
+        count = this->available_;
+    }
+
+    float integrator = this->integrator_;
+    float capacitor = this->capacitor_;
+    float charge = this->charge_factor_;
+    const float* deltas = this->deltas_.data();
+
+    for (size_t i = 0; i < count; i++) {
+        integrator += deltas[i];
+        float sample = integrator - capacitor;
+        capacitor = integrator - sample * charge;
+
+        if (out != nullptr) {
+            out[i * stride] = sample;
+        }
+    }
+
+    this->integrator_ = integrator;
+    this->capacitor_ = capacitor;
+
+    // Shift the unread samples and the deltas of the frame being built to the front
+    size_t size = this->deltas_.size();
+    memmove(this->deltas_.data(), this->deltas_.data() + count, (size - count) * sizeof(float));
+    memset(this->deltas_.data() + size - count, 0, count * sizeof(float));
+
+    this->available_ -= count;
+}
+
+void BlipBuffer::Clear() {
+    this->offset_ = 0;
+    this->available_ = 0;
+    this->integrator_ = 0;
+    this->capacitor_ = 0;
+    std::fill(this->deltas_.begin(), this->deltas_.end(), 0.0f);
+}
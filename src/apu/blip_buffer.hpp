@@ -0,0 +1,127 @@
+/**
+ * @file blip_buffer.hpp
+ * @brief Band-limited step synthesis buffer converting amplitude changes at clock times into samples
+ *
+ */
+
+#ifndef BLIP_BUFFER_H
+#define BLIP_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Sub-sample positions a step can land on
+static const int BLIP_PHASE_BITS = 5;
+static const int BLIP_PHASES = 1 << BLIP_PHASE_BITS;
+
+// Width of the band-limited impulse, in output samples
+static const int BLIP_TAPS = 16;
+
+/**
+ * @brief Accumulates amplitude changes and produces band-limited samples from them.
+ *
+ * A square wave is nothing but steps, so instead of evaluating a waveform for every output sample,
+ * sound channels report each change of amplitude along with the clock it happened on. Each change
+ * is added to a delta buffer as a windowed sinc impulse at its exact sub-sample position, and
+ * reading samples integrates the buffer, turning the impulses into steps without aliasing. The
+ * cost is proportional to the number of amplitude changes, not to the clock rate.
+ */
+class BlipBuffer
+{
+
+private:
+
+    // Output samples per clock, as 32.32 fixed point
+    uint64_t factor_;
+
+    // Fractional sample position of the start of the current frame, as 32.32 fixed point
+    uint64_t offset_;
+
+    // Deltas of the samples that are ready followed by the ones still being built
+    std::vector<float> deltas_;
+    size_t available_;
+    size_t max_frame_samples_;
+
+    // Running sum of the deltas, and the charge of the output high pass filter
+    float integrator_;
+    float capacitor_;
+    float charge_factor_;
+
+    // The impulse for each phase, normalised so every step has exactly its height
+    float kernel_[BLIP_PHASES][BLIP_TAPS];
+
+    /**
+     * @brief Drops samples from the front, keeping the integrator and filter in step
+     *
+     * @param count The number of samples to drop
+     * @param out Receives the samples if not nullptr
+     * @param stride Distance between samples written to out
+     */
+    void Consume(size_t count, float* out, size_t stride);
+
+public:
+    /**
+     * @brief Constructs a new BlipBuffer
+     *
+     * @param clock_rate Clocks per second of the times passed to AddDelta
+     * @param sample_rate Output samples per second
+     * @param max_frame_clocks The longest frame that will be passed to EndFrame
+     */
+    BlipBuffer(uint32_t clock_rate, uint32_t sample_rate, uint32_t max_frame_clocks);
+
+    /**
+     * @brief Adds a change of amplitude
+     *
+     * @param clock_time Clocks since the start of the current frame
+     * @param delta The change in amplitude
+     */
+    void AddDelta(uint32_t clock_time, float delta) {
+        uint64_t position = this->offset_ + clock_time * this->factor_;
+        size_t index = (size_t)(position >> 32);
+        const float* kernel = this->kernel_[(position >> (32 - BLIP_PHASE_BITS)) & (BLIP_PHASES - 1)];
+        float* out = this->deltas_.data() + this->available_ + index;
+
+        for (int i = 0; i < BLIP_TAPS; i++) {
+            out[i] += kernel[i] * delta;
+        }
+    }
+
+    /**
+     * @brief Ends the current frame, making its samples available
+     *
+     * @param clocks The length of the frame in clocks. Times in the next frame are relative to its end
+     */
+    void EndFrame(uint32_t clocks);
+
+    /**
+     * @brief Gets the number of samples ready to be read
+     *
+     */
+    size_t samplesAvailable();
+
+    /**
+     * @brief Gets the number of samples a frame of a given length produces, give or take one
+     *
+     * @param clocks The length of the frame in clocks
+     */
+    size_t SamplesForClocks(uint32_t clocks);
+
+    /**
+     * @brief Reads samples, removing them from the buffer
+     *
+     * @param out Receives the samples, or nullptr to discard them
+     * @param count The maximum number of samples to read
+     * @param stride Distance between samples written to out, 2 to interleave stereo
+     * @return size_t The number of samples read
+     */
+    size_t ReadSamples(float* out, size_t count, size_t stride = 1);
+
+    /**
+     * @brief Discards all samples and deltas and resets the filters
+     *
+     */
+    void Clear();
+};
+
+#endif
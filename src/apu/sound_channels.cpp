@@ -0,0 +1,370 @@
+/**
+ * @file sound_channels.cpp
+ * @brief Implementation of the sound channels
+ *
+ */
+
+#include "./sound_channels.hpp"
+
+// Output of each of the 8 steps of the four duty cycles selected by NRx1, bit n is step n
+static const uint8_t DUTY_PATTERNS[4] = {0b10000000, 0b10000001, 0b11100001, 0b01111110};
+
+// Right shifts applied to wave samples by the NR32 output levels: mute, 100%, 50% and 25%
+static const uint8_t WAVE_VOLUME_SHIFTS[4] = {4, 0, 1, 2};
+
+// Noise divisors selected by the low 3 bits of NR43, in clocks
+static const uint8_t NOISE_DIVISORS[8] = {8, 16, 32, 48, 64, 80, 96, 112};
+
+static const uint16_t WAVE_RAM_START = 0xFF30;
+static const uint16_t MAX_FREQUENCY = 2047;
+
+/**
+ * @brief Gets whether an NRx2 value leaves the channel's DAC powered
+ *
+ */
+static bool DACEnabled(uint8_t nrx2) {
+    return (nrx2 & 0xF8) != 0;
+}
+
+/**
+ * @brief Steps a volume envelope
+ *
+ * @param nrx2 The channel's envelope register
+ * @param volume The current volume
+ * @param timer Envelope steps left until the volume changes
+ */
+static void StepEnvelope(uint8_t nrx2, uint8_t* volume, uint8_t* timer) {
+    uint8_t pace = nrx2 & 0x07;
+    if (pace == 0) {
+        return;
+    }
+
+    if (*timer > 0) {
+        (*timer)--;
+    }
+    if (*timer > 0) {
+        return;
+    }
+
+    *timer = pace;
+    if ((nrx2 & 0x08) > 0) {
+        if (*volume < 15) {
+            (*volume)++;
+        }
+    } else if (*volume > 0) {
+        (*volume)--;
+    }
+}
+
+SoundChannel::SoundChannel(uint8_t* memory_bus_ptr, APUMixer* mixer, uint16_t base, int index, uint16_t max_length) {
+    this->memory_bus_ = memory_bus_ptr;
+    this->mixer_ = mixer;
+    this->base_ = base;
+    this->index_ = index;
+    this->enabled_ = false;
+    this->length_ = 0;
+    this->max_length_ = max_length;
+    this->timer_ = 0;
+    this->period_ = 8192;
+}
+
+void SoundChannel::Rebind(uint8_t* memory_bus_ptr, APUMixer* mixer) {
+    this->memory_bus_ = memory_bus_ptr;
+    this->mixer_ = mixer;
+}
+
+uint32_t SoundChannel::SkipTo(uint64_t to) {
+    if (this->timer_ >= to) {
+        return 0;
+    }
+
+    uint64_t steps = (to - this->timer_ + this->period_ - 1) / this->period_;
+    this->timer_ += steps * this->period_;
+    return (uint32_t)steps;
+}
+
+uint16_t SoundChannel::frequency() {
+    return (uint16_t)(this->memory_bus_[this->base_ + 3] | ((this->memory_bus_[this->base_ + 4] & 0x07) << 8));
+}
+
+bool SoundChannel::enabled() {
+    return this->enabled_;
+}
+
+void SoundChannel::Disable(uint64_t time) {
+    this->enabled_ = false;
+    this->mixer_->SetAmplitude(this->index_, time, 0);
+}
+
+void SoundChannel::WriteLength(uint8_t value) {
+    this->length_ = (uint16_t)(this->max_length_ - (value & (this->max_length_ - 1)));
+}
+
+void SoundChannel::ClockLength(uint64_t time) {
+    if ((this->memory_bus_[this->base_ + 4] & NRX4_LENGTH_ENABLE) == 0 || this->length_ == 0) {
+        return;
+    }
+
+    this->length_--;
+    if (this->length_ == 0) {
+        this->Disable(time);
+    }
+}
+
+SquareChannel::SquareChannel(uint8_t* memory_bus_ptr, APUMixer* mixer, uint16_t base, int index, bool has_sweep)
+    : SoundChannel(memory_bus_ptr, mixer, base, index, 64) {
+    this->has_sweep_ = has_sweep;
+    this->duty_step_ = 0;
+    this->volume_ = 0;
+    this->envelope_timer_ = 0;
+    this->sweep_frequency_ = 0;
+    this->sweep_timer_ = 0;
+    this->sweep_enabled_ = false;
+}
+
+uint8_t SquareChannel::output() {
+    if (!this->enabled_) {
+        return 0;
+    }
+
+    uint8_t duty = DUTY_PATTERNS[this->memory_bus_[this->base_ + 1] >> 6];
+    return ((duty >> this->duty_step_) & 1) > 0 ? this->volume_ : 0;
+}
+
+void SquareChannel::Run(uint64_t to) {
+    if (!this->enabled_) {
+        this->duty_step_ = (uint8_t)((this->duty_step_ + this->SkipTo(to)) & 7);
+        return;
+    }
+
+    while (this->timer_ < to) {
+        this->duty_step_ = (this->duty_step_ + 1) & 7;
+        this->mixer_->SetAmplitude(this->index_, this->timer_, this->output());
+        this->timer_ += this->period_;
+    }
+}
+
+void SquareChannel::Write(uint16_t address, uint8_t value, uint64_t time) {
+    switch (address - this->base_) {
+        case 1:
+            this->WriteLength(value);
+            this->mixer_->SetAmplitude(this->index_, time, this->output());
+            break;
+        case 2:
+            if (!DACEnabled(value)) {
+                this->Disable(time);
+            }
+            break;
+        case 3:
+            this->period_ = (2048 - this->frequency()) * 4;
+            break;
+        case 4:
+            this->period_ = (2048 - this->frequency()) * 4;
+            if ((value & NRX4_TRIGGER) == 0) {
+                break;
+            }
+
+            {
+                uint8_t nrx2 = this->memory_bus_[this->base_ + 2];
+                this->enabled_ = DACEnabled(nrx2);
+                this->volume_ = nrx2 >> 4;
+                this->envelope_timer_ = nrx2 & 0x07;
+            }
+            if (this->length_ == 0) {
+                this->length_ = this->max_length_;
+            }
+            this->timer_ = time + this->period_;
+
+            if (this->has_sweep_) {
+                uint8_t nr10 = this->memory_bus_[this->base_];
+                uint8_t pace = (nr10 >> 4) & 0x07;
+                this->sweep_frequency_ = this->frequency();
+                this->sweep_timer_ = pace > 0 ? pace : 8;
+                this->sweep_enabled_ = (nr10 & 0x77) != 0;
+
+                if ((nr10 & 0x07) > 0) {
+                    this->NextSweepFrequency(time);
+                }
+            }
+
+            this->mixer_->SetAmplitude(this->index_, time, this->output());
+            break;
+    }
+}
+
+void SquareChannel::ClockEnvelope(uint64_t time) {
+    StepEnvelope(this->memory_bus_[this->base_ + 2], &this->volume_, &this->envelope_timer_);
+    this->mixer_->SetAmplitude(this->index_, time, this->output());
+}
+
+uint16_t SquareChannel::NextSweepFrequency(uint64_t time) {
+    uint8_t nr10 = this->memory_bus_[this->base_];
+    uint16_t delta = this->sweep_frequency_ >> (nr10 & 0x07);
+    uint16_t next = (nr10 & 0x08) > 0 ? this->sweep_frequency_ - delta : this->sweep_frequency_ + delta;
+
+    if (next > MAX_FREQUENCY) {
+        this->Disable(time);
+    }
+    return next;
+}
+
+void SquareChannel::ClockSweep(uint64_t time) {
+    if (!this->has_sweep_ || --this->sweep_timer_ > 0) {
+        return;
+    }
+
+    uint8_t nr10 = this->memory_bus_[this->base_];
+    uint8_t pace = (nr10 >> 4) & 0x07;
+    this->sweep_timer_ = pace > 0 ? pace : 8;
+
+    if (!this->sweep_enabled_ || pace == 0 || !this->enabled_) {
+        return;
+    }
+
+    uint16_t next = this->NextSweepFrequency(time);
+    if (next <= MAX_FREQUENCY && (nr10 & 0x07) > 0) {
+        // The new frequency is written back to NR13 and NR14
+        this->sweep_frequency_ = next;
+        this->memory_bus_[this->base_ + 3] = next & 0xFF;
+        this->memory_bus_[this->base_ + 4] = (uint8_t)((this->memory_bus_[this->base_ + 4] & 0xF8) | (next >> 8));
+        this->period_ = (2048 - next) * 4;
+
+        // Checked again for overflow, without being used
+        this->NextSweepFrequency(time);
+    }
+}
+
+WaveChannel::WaveChannel(uint8_t* memory_bus_ptr, APUMixer* mixer) : SoundChannel(memory_bus_ptr, mixer, 0xFF1A, 2, 256) {
+    this->position_ = 0;
+    this->sample_ = 0;
+    this->volume_shift_ = 4;
+}
+
+uint8_t WaveChannel::output() {
+    return this->enabled_ ? this->sample_ >> this->volume_shift_ : 0;
+}
+
+void WaveChannel::Run(uint64_t to) {
+    if (!this->enabled_) {
+        this->position_ = (uint8_t)((this->position_ + this->SkipTo(to)) & 31);
+        return;
+    }
+
+    const uint8_t* wave_ram = this->memory_bus_ + WAVE_RAM_START;
+
+    while (this->timer_ < to) {
+        this->position_ = (this->position_ + 1) & 31;
+
+        // High nibble first
+        uint8_t byte = wave_ram[this->position_ >> 1];
+        this->sample_ = (this->position_ & 1) > 0 ? byte & 0x0F : byte >> 4;
+
+        this->mixer_->SetAmplitude(this->index_, this->timer_, this->output());
+        this->timer_ += this->period_;
+    }
+}
+
+void WaveChannel::Write(uint16_t address, uint8_t value, uint64_t time) {
+    switch (address - this->base_) {
+        case 0:
+            if ((value & 0x80) == 0) {
+                this->Disable(time);
+            }
+            break;
+        case 1:
+            this->WriteLength(value);
+            break;
+        case 2:
+            this->volume_shift_ = WAVE_VOLUME_SHIFTS[(value >> 5) & 0x03];
+            this->mixer_->SetAmplitude(this->index_, time, this->output());
+            break;
+        case 3:
+            this->period_ = (2048 - this->frequency()) * 2;
+            break;
+        case 4:
+            this->period_ = (2048 - this->frequency()) * 2;
+            if ((value & NRX4_TRIGGER) == 0) {
+                break;
+            }
+
+            // Playback restarts from the first sample, the last one read keeps playing until then
+            this->enabled_ = (this->memory_bus_[this->base_] & 0x80) > 0;
+            if (this->length_ == 0) {
+                this->length_ = this->max_length_;
+            }
+            this->position_ = 0;
+            this->timer_ = time + this->period_;
+            this->mixer_->SetAmplitude(this->index_, time, this->output());
+            break;
+    }
+}
+
+NoiseChannel::NoiseChannel(uint8_t* memory_bus_ptr, APUMixer* mixer) : SoundChannel(memory_bus_ptr, mixer, 0xFF1F, 3, 64) {
+    this->lfsr_ = 0x7FFF;
+    this->volume_ = 0;
+    this->envelope_timer_ = 0;
+}
+
+uint8_t NoiseChannel::output() {
+    return this->enabled_ && (this->lfsr_ & 1) == 0 ? this->volume_ : 0;
+}
+
+void NoiseChannel::Run(uint64_t to) {
+    if (!this->enabled_) {
+        this->SkipTo(to);
+        return;
+    }
+
+    bool short_mode = (this->memory_bus_[this->base_ + 3] & 0x08) > 0;
+
+    while (this->timer_ < to) {
+        uint16_t bit = (this->lfsr_ ^ (this->lfsr_ >> 1)) & 1;
+        this->lfsr_ = (uint16_t)((this->lfsr_ >> 1) | (bit << 14));
+        if (short_mode) {
+            this->lfsr_ = (uint16_t)((this->lfsr_ & ~0x40) | (bit << 6));
+        }
+
+        this->mixer_->SetAmplitude(this->index_, this->timer_, this->output());
+        this->timer_ += this->period_;
+    }
+}
+
+void NoiseChannel::Write(uint16_t address, uint8_t value, uint64_t time) {
+    switch (address - this->base_) {
+        case 1:
+            this->WriteLength(value);
+            break;
+        case 2:
+            if (!DACEnabled(value)) {
+                this->Disable(time);
+            }
+            break;
+        case 3:
+            // Shifts of 14 and 15 stop the LFSR
+            this->period_ = (value >> 4) >= 14 ? UINT32_MAX : (uint32_t)NOISE_DIVISORS[value & 0x07] << (value >> 4);
+            break;
+        case 4:
+            if ((value & NRX4_TRIGGER) == 0) {
+                break;
+            }
+
+            {
+                uint8_t nrx2 = this->memory_bus_[this->base_ + 2];
+                this->enabled_ = DACEnabled(nrx2);
+                this->volume_ = nrx2 >> 4;
+                this->envelope_timer_ = nrx2 & 0x07;
+            }
+            if (this->length_ == 0) {
+                this->length_ = this->max_length_;
+            }
+            this->lfsr_ = 0x7FFF;
+            this->timer_ = time + this->period_;
+            this->mixer_->SetAmplitude(this->index_, time, this->output());
+            break;
+    }
+}
+
+void NoiseChannel::ClockEnvelope(uint64_t time) {
+    StepEnvelope(this->memory_bus_[this->base_ + 2], &this->volume_, &this->envelope_timer_);
+    this->mixer_->SetAmplitude(this->index_, time, this->output());
+}
@@ -0,0 +1,287 @@
+/**
+ * @file sound_channels.hpp
+ * @brief The DMG's two pulse channels, wave channel and noise channel
+ *
+ */
+
+#ifndef SOUND_CHANNELS_H
+#define SOUND_CHANNELS_H
+
+#include <cstdint>
+#include "./apu_mixer.hpp"
+
+// Bits of NRx4
+static const uint8_t NRX4_TRIGGER = 0b10000000;
+static const uint8_t NRX4_LENGTH_ENABLE = 0b01000000;
+
+/**
+ * @brief State shared by every channel: the enable flag, the length counter and the waveform timer.
+ *
+ * Channels are advanced with Run(to), which steps the waveform timer from its last due time to the
+ * requested clock and reports each change of output to the mixer at the clock it happened on. The
+ * APU only calls it before a register write and at the end of a frame. Registers are read straight
+ * from the memory bus, which holds the value last written.
+ */
+class SoundChannel
+{
+
+protected:
+
+    uint8_t* memory_bus_;
+    APUMixer* mixer_;
+
+    // Address of NRx0, the first register of the channel
+    uint16_t base_;
+    int index_;
+
+    bool enabled_;
+
+    uint16_t length_;
+    uint16_t max_length_;
+
+    // Clock at which the waveform next steps, and the clocks between steps
+    uint64_t timer_;
+    uint32_t period_;
+
+    /**
+     * @brief Moves the waveform timer past a clock without stepping the waveform one step at a time
+     *
+     * @param to The clock to move past
+     * @return uint32_t The number of steps skipped
+     */
+    uint32_t SkipTo(uint64_t to);
+
+    /**
+     * @brief Reads the 11 bit frequency from NRx3 and NRx4
+     *
+     */
+    uint16_t frequency();
+
+public:
+    /**
+     * @brief Constructs a new disabled SoundChannel
+     *
+     * @param memory_bus_ptr Pointer to the memory bus
+     * @param mixer The mixer channel output is sent to
+     * @param base Address of NRx0
+     * @param index The channel number less one
+     * @param max_length The length counter's reload value
+     */
+    SoundChannel(uint8_t* memory_bus_ptr, APUMixer* mixer, uint16_t base, int index, uint16_t max_length);
+
+    /**
+     * @brief Points a channel copied from another APU at this APU's memory bus and mixer
+     *
+     * @param memory_bus_ptr Pointer to the memory bus
+     * @param mixer The mixer channel output is sent to
+     */
+    void Rebind(uint8_t* memory_bus_ptr, APUMixer* mixer);
+
+    /**
+     * @brief Gets whether the channel is playing, as reported by NR52
+     *
+     */
+    bool enabled();
+
+    /**
+     * @brief Silences the channel until it is next triggered
+     *
+     * @param time The clock it is silenced on
+     */
+    void Disable(uint64_t time);
+
+    /**
+     * @brief Loads the length counter from NRx1
+     *
+     * @param value The value written to NRx1
+     */
+    void WriteLength(uint8_t value);
+
+    /**
+     * @brief Counts the length down, disabling the channel when it expires. Called at 256Hz
+     *
+     * @param time The clock of the frame sequencer step
+     */
+    void ClockLength(uint64_t time);
+};
+
+/**
+ * @brief A pulse channel with a volume envelope and, on channel 1, a frequency sweep
+ *
+ */
+class SquareChannel : public SoundChannel
+{
+
+private:
+
+    bool has_sweep_;
+
+    // Position within the 8 step duty cycle
+    uint8_t duty_step_;
+
+    uint8_t volume_;
+    uint8_t envelope_timer_;
+
+    uint16_t sweep_frequency_;
+    uint8_t sweep_timer_;
+    bool sweep_enabled_;
+
+    /**
+     * @brief Gets the 4 bit output for the current duty step and volume
+     *
+     */
+    uint8_t output();
+
+    /**
+     * @brief Computes the next swept frequency, disabling the channel if it overflows
+     *
+     * @param time The clock of the calculation
+     * @return uint16_t The new frequency
+     */
+    uint16_t NextSweepFrequency(uint64_t time);
+
+public:
+    /**
+     * @brief Constructs a new SquareChannel
+     *
+     * @param memory_bus_ptr Pointer to the memory bus
+     * @param mixer The mixer channel output is sent to
+     * @param base Address of NRx0
+     * @param index The channel number less one
+     * @param has_sweep Whether NRx0 controls a frequency sweep
+     */
+    SquareChannel(uint8_t* memory_bus_ptr, APUMixer* mixer, uint16_t base, int index, bool has_sweep);
+
+    /**
+     * @brief Steps the waveform up to a clock
+     *
+     * @param to The clock to run until
+     */
+    void Run(uint64_t to);
+
+    /**
+     * @brief Handles a write to one of the channel's registers
+     *
+     * @param address The register written to
+     * @param value The value written
+     * @param time The clock of the write
+     */
+    void Write(uint16_t address, uint8_t value, uint64_t time);
+
+    /**
+     * @brief Steps the volume envelope. Called at 64Hz
+     *
+     * @param time The clock of the frame sequencer step
+     */
+    void ClockEnvelope(uint64_t time);
+
+    /**
+     * @brief Steps the frequency sweep. Called at 128Hz
+     *
+     * @param time The clock of the frame sequencer step
+     */
+    void ClockSweep(uint64_t time);
+};
+
+/**
+ * @brief The channel playing 32 4 bit samples from wave RAM
+ *
+ */
+class WaveChannel : public SoundChannel
+{
+
+private:
+
+    // Position within wave RAM and the sample there
+    uint8_t position_;
+    uint8_t sample_;
+
+    // Right shift applied to samples by the NR32 output level
+    uint8_t volume_shift_;
+
+    /**
+     * @brief Gets the 4 bit output for the current sample and output level
+     *
+     */
+    uint8_t output();
+
+public:
+    /**
+     * @brief Constructs a new WaveChannel
+     *
+     * @param memory_bus_ptr Pointer to the memory bus
+     * @param mixer The mixer channel output is sent to
+     */
+    WaveChannel(uint8_t* memory_bus_ptr, APUMixer* mixer);
+
+    /**
+     * @brief Steps through wave RAM up to a clock
+     *
+     * @param to The clock to run until
+     */
+    void Run(uint64_t to);
+
+    /**
+     * @brief Handles a write to one of the channel's registers
+     *
+     * @param address The register written to
+     * @param value The value written
+     * @param time The clock of the write
+     */
+    void Write(uint16_t address, uint8_t value, uint64_t time);
+};
+
+/**
+ * @brief The channel outputting the low bit of a linear feedback shift register
+ *
+ */
+class NoiseChannel : public SoundChannel
+{
+
+private:
+
+    uint16_t lfsr_;
+
+    uint8_t volume_;
+    uint8_t envelope_timer_;
+
+    /**
+     * @brief Gets the 4 bit output for the current LFSR state and volume
+     *
+     */
+    uint8_t output();
+
+public:
+    /**
+     * @brief Constructs a new NoiseChannel
+     *
+     * @param memory_bus_ptr Pointer to the memory bus
+     * @param mixer The mixer channel output is sent to
+     */
+    NoiseChannel(uint8_t* memory_bus_ptr, APUMixer* mixer);
+
+    /**
+     * @brief Clocks the LFSR up to a clock
+     *
+     * @param to The clock to run until
+     */
+    void Run(uint64_t to);
+
+    /**
+     * @brief Handles a write to one of the channel's registers
+     *
+     * @param address The register written to
+     * @param value The value written
+     * @param time The clock of the write
+     */
+    void Write(uint16_t address, uint8_t value, uint64_t time);
+
+    /**
+     * @brief Steps the volume envelope. Called at 64Hz
+     *
+     * @param time The clock of the frame sequencer step
+     */
+    void ClockEnvelope(uint64_t time);
+};
+
+#endif
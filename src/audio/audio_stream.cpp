@@ -0,0 +1,66 @@
+/**
+ * @file audio_stream.cpp
+ * @brief Implementation of the audio stream
+ *
+ */
+
+#include <cstring>
+#include "./audio_stream.hpp"
+
+AudioStream::AudioStream(uint32_t input_rate, uint32_t output_rate, size_t latency)
+    : ring_(latency * 4), resampler_(input_rate, output_rate), underruns_(0) {
+    this->target_fill_ = latency;
+    this->adjustment_ = 0;
+    this->dropped_ = 0;
+}
+
+size_t AudioStream::Write(const float* samples, size_t count) {
+    // Empty: stretch the most, at the target: play at the nominal rate, twice the target or more: shrink the most
+    double error = 1.0 - (double)this->fill() / this->target_fill_;
+    if (error < -1.0) {
+        error = -1.0;
+    }
+    this->adjustment_ = MAX_RATE_DEVIATION * error;
+
+    size_t most = this->resampler_.MaxOutput(count, this->adjustment_);
+    if (this->scratch_.size() < most * 2) {
+        this->scratch_.resize(most * 2);
+    }
+
+    float* out = this->scratch_.data();
+    size_t produced = this->resampler_.Process(samples, count, out, this->adjustment_);
+
+    size_t queued = this->ring_.Push(out, produced * 2) / 2;
+    this->dropped_ += produced - queued;
+    return queued;
+}
+
+size_t AudioStream::Read(float* out, size_t count) {
+    size_t read = this->ring_.Pop(out, count * 2) / 2;
+
+    if (read < count) {
+        memset(out + read * 2, 0, (count - read) * 2 * sizeof(float));
+        this->underruns_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return read;
+}
+
+size_t AudioStream::fill() {
+    return this->ring_.size() / 2;
+}
+
+size_t AudioStream::capacity() {
+    return this->ring_.capacity() / 2;
+}
+
+double AudioStream::rateAdjustment() {
+    return this->adjustment_;
+}
+
+uint64_t AudioStream::underruns() {
+    return this->underruns_.load(std::memory_order_relaxed);
+}
+
+uint64_t AudioStream::droppedSamples() {
+    return this->dropped_;
+}
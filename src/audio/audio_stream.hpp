@@ -0,0 +1,114 @@
+/**
+ * @file audio_stream.hpp
+ * @brief Lock-free hand off of audio from the emulation thread to the audio device, with dynamic rate control
+ *
+ */
+
+#ifndef AUDIO_STREAM_H
+#define AUDIO_STREAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../util/spsc_ring_buffer.hpp"
+#include "./resampler.hpp"
+
+// The furthest the resampling ratio is nudged away from the nominal one
+static const double MAX_RATE_DEVIATION = 0.005;
+
+/**
+ * @brief Carries stereo samples from the emulator to an audio callback without locks.
+ *
+ * The emulator runs at 59.73 frames per second against its own clock and the audio device consumes
+ * samples against another, so the two always drift apart. Write() resamples each batch from the
+ * emulator's rate to the device's and nudges the ratio by up to MAX_RATE_DEVIATION depending on
+ * how full the ring is: a ring running low gets slightly more samples, a ring filling up slightly
+ * fewer. The fill level settles around the requested latency, so the device neither underruns nor drops
+ * samples, and the pitch change stays far below what can be heard.
+ *
+ * Write() must only be called from one thread and Read() from one other thread, such as an
+ * SDL_AudioCallback. Read() never blocks and never allocates.
+ */
+class AudioStream
+{
+
+private:
+
+    // Interleaved left and right samples at the output rate
+    SPSCRingBuffer<float> ring_;
+
+    Resampler resampler_;
+
+    // Stereo samples the ring is kept filled to
+    size_t target_fill_;
+
+    // The rate adjustment applied to the last batch
+    double adjustment_;
+
+    // Output of the resampler before it is pushed. Only grows, so steady state writes do not allocate
+    std::vector<float> scratch_;
+
+    std::atomic<uint64_t> underruns_;
+    uint64_t dropped_;
+
+public:
+    /**
+     * @brief Constructs a new AudioStream
+     *
+     * @param input_rate Samples per second passed to Write
+     * @param output_rate Samples per second taken by Read
+     * @param latency Stereo samples of buffering to aim for. The ring holds at least twice this
+     */
+    AudioStream(uint32_t input_rate, uint32_t output_rate, size_t latency);
+
+    /**
+     * @brief Resamples a batch and queues it for the consumer. Producer only
+     *
+     * @param samples Interleaved stereo samples at the input rate
+     * @param count The number of stereo samples
+     * @return size_t The number of stereo samples queued at the output rate
+     */
+    size_t Write(const float* samples, size_t count);
+
+    /**
+     * @brief Takes queued samples, filling whatever is missing with silence. Consumer only
+     *
+     * @param out Receives interleaved stereo samples at the output rate
+     * @param count The number of stereo samples wanted
+     * @return size_t The number of stereo samples that were queued, less than count on an underrun
+     */
+    size_t Read(float* out, size_t count);
+
+    /**
+     * @brief Gets the number of queued stereo samples
+     *
+     */
+    size_t fill();
+
+    /**
+     * @brief Gets the number of stereo samples the ring can hold
+     *
+     */
+    size_t capacity();
+
+    /**
+     * @brief Gets the fraction the last batch was stretched by, positive when more samples were produced
+     *
+     */
+    double rateAdjustment();
+
+    /**
+     * @brief Gets the number of reads that ran out of samples
+     *
+     */
+    uint64_t underruns();
+
+    /**
+     * @brief Gets the number of stereo samples dropped because the ring was full
+     *
+     */
+    uint64_t droppedSamples();
+};
+
+#endif
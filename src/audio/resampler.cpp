@@ -0,0 +1,170 @@
+/**
+ * @file resampler.cpp
+ * @brief Implementation of the polyphase resampler and its scalar kernel
+ *
+ */
+
+#include <cmath>
+#include <cstring>
+#include "./resampler.hpp"
+
+// Cutoff as a fraction of the lower Nyquist frequency, leaving room for the transition band
+static const double CUTOFF_FRACTION = 0.9;
+
+// Kaiser window shape, trading transition width for stopband attenuation
+static const double KAISER_BETA = 8.0;
+
+// Zeros before the first input sample, so output sample 0 lines up with input sample 0
+static const size_t LEADING_ZEROS = RESAMPLER_TAPS / 2 - 1;
+
+static const double PI = 3.14159265358979323846;
+
+/**
+ * @brief Modified Bessel function of the first kind, order 0, by its power series
+ *
+ */
+static double BesselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+size_t ResampleScalar(ResampleBatch* batch) {
+    size_t produced = 0;
+    uint64_t position = batch->position;
+
+    while (produced < batch->max_out && (position >> 32) + RESAMPLER_TAPS <= batch->available) {
+        size_t index = (size_t)(position >> 32);
+        uint32_t phase;
+        float weight;
+        ResamplerPhase(position, &phase, &weight);
+
+        const float* c0 = batch->filters + phase * RESAMPLER_TAPS;
+        const float* c1 = c0 + RESAMPLER_TAPS;
+        const float* left = batch->left + index;
+        const float* right = batch->right + index;
+        float sum_left = 0;
+        float sum_right = 0;
+
+        for (int k = 0; k < RESAMPLER_TAPS; k++) {
+            float c = c0[k] + (c1[k] - c0[k]) * weight;
+            sum_left += c * left[k];
+            sum_right += c * right[k];
+        }
+
+        batch->out[produced * 2] = sum_left;
+        batch->out[produced * 2 + 1] = sum_right;
+        produced++;
+        position += batch->step;
+    }
+
+    batch->position = position;
+    return produced;
+}
+
+Resampler::Resampler(uint32_t input_rate, uint32_t output_rate, SIMDLevel level) {
+    this->nominal_step_ = (double)input_rate / output_rate;
+
+    switch (SIMDLevelSupported(level) ? level : SIMD_SCALAR) {
+#ifdef LAMEBOY_X86
+        case SIMD_AVX512:
+        case SIMD_AVX2:
+            this->kernel_ = ResampleAVX2;
+            break;
+        case SIMD_SSE2:
+            this->kernel_ = ResampleSSE2;
+            break;
+#endif
+        default:
+            this->kernel_ = ResampleScalar;
+            break;
+    }
+
+    // Cutoff in cycles per input sample
+    double ratio = output_rate < input_rate ? (double)output_rate / input_rate : 1.0;
+    double cutoff = 0.5 * ratio * CUTOFF_FRACTION;
+    double half_width = RESAMPLER_TAPS / 2;
+
+    this->filters_.resize((RESAMPLER_PHASES + 1) * RESAMPLER_TAPS);
+    for (int phase = 0; phase <= RESAMPLER_PHASES; phase++) {
+        float* filter = this->filters_.data() + phase * RESAMPLER_TAPS;
+        double fraction = (double)phase / RESAMPLER_PHASES;
+        double sum = 0;
+
+        for (int tap = 0; tap < RESAMPLER_TAPS; tap++) {
+            double x = tap - (double)LEADING_ZEROS - fraction;
+            double sinc = x == 0 ? 1.0 : sin(2 * PI * cutoff * x) / (2 * PI * cutoff * x);
+            double edge = x / half_width;
+            double window = edge * edge < 1.0 ? BesselI0(KAISER_BETA * sqrt(1.0 - edge * edge)) / BesselI0(KAISER_BETA) : 0.0;
+
+            filter[tap] = (float)(sinc * window);
+            sum += sinc * window;
+        }
+
+        // Unity gain at DC for every phase
+        for (int tap = 0; tap < RESAMPLER_TAPS; tap++) {
+            filter[tap] = (float)(filter[tap] / sum);
+        }
+    }
+
+    this->Reset();
+}
+
+size_t Resampler::Process(const float* in, size_t count, float* out, double adjustment) {
+    size_t total = this->history_ + count;
+    if (this->left_.size() < total) {
+        this->left_.resize(total);
+        this->right_.resize(total);
+    }
+
+    float* left = this->left_.data();
+    float* right = this->right_.data();
+    for (size_t i = 0; i < count; i++) {
+        left[this->history_ + i] = in[i * 2];
+        right[this->history_ + i] = in[i * 2 + 1];
+    }
+
+    ResampleBatch batch;
+    batch.left = left;
+    batch.right = right;
+    batch.available = total;
+    batch.position = this->position_;
+    batch.step = (uint64_t)(this->nominal_step_ / (1.0 + adjustment) * 4294967296.0 + 0.5);
+    batch.filters = this->filters_.data();
+    batch.out = out;
+    batch.max_out = this->MaxOutput(count, adjustment);
+
+    size_t produced = this->kernel_(&batch);
+
+    // Keep the input from the next output sample's first tap onwards
+    size_t consumed = (size_t)(batch.position >> 32);
+    if (consumed > total) {
+        consumed = total;
+    }
+    memmove(left, left + consumed, (total - consumed) * sizeof(float));
+    memmove(right, right + consumed, (total - consumed) * sizeof(float));
+    this->history_ = total - consumed;
+    this->position_ = batch.position - ((uint64_t)consumed << 32);
+
+    return produced;
+}
+
+size_t Resampler::MaxOutput(size_t count, double adjustment) {
+    return (size_t)((count + RESAMPLER_TAPS) * (1.0 + adjustment) / this->nominal_step_) + 2;
+}
+
+size_t Resampler::latency() {
+    return RESAMPLER_TAPS / 2;
+}
+
+void Resampler::Reset() {
+    this->left_.assign(LEADING_ZEROS + 1024, 0.0f);
+    this->right_.assign(LEADING_ZEROS + 1024, 0.0f);
+    this->history_ = LEADING_ZEROS;
+    this->position_ = 0;
+}
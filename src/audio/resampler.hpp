@@ -0,0 +1,91 @@
+/**
+ * @file resampler.hpp
+ * @brief Windowed sinc polyphase resampler for stereo audio, with kernels picked at runtime
+ *
+ */
+
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../util/cpu_features.hpp"
+#include "./resampler_kernels.hpp"
+
+/**
+ * @brief Converts stereo audio between sample rates, a batch at a time.
+ *
+ * Each output sample is a RESAMPLER_TAPS point dot product of the input with a Kaiser windowed
+ * sinc, picked from a table of RESAMPLER_PHASES fractional delays and interpolated between the two
+ * nearest. The cutoff sits just below the lower of the two Nyquist frequencies, so downsampling
+ * does not alias. The ratio can be nudged on every batch for rate control without rebuilding the
+ * table, as long as the nudge is small.
+ *
+ * Input is kept planar so the dot products read contiguous memory, and the kernel for the active
+ * SIMD level processes a whole batch per call. Buffers only grow, so steady state calls do not
+ * allocate.
+ */
+class Resampler
+{
+
+private:
+
+    std::vector<float> filters_;
+    ResampleKernel kernel_;
+
+    // Input samples per output sample before any adjustment
+    double nominal_step_;
+
+    // Planar input history. The first history_ samples are left over from earlier batches
+    std::vector<float> left_;
+    std::vector<float> right_;
+    size_t history_;
+
+    // Position of the next output sample in the history, as 32.32 fixed point
+    uint64_t position_;
+
+public:
+    /**
+     * @brief Constructs a new Resampler
+     *
+     * @param input_rate Samples per second passed to Process
+     * @param output_rate Samples per second produced
+     * @param level The kernel to use, unsupported levels fall back to scalar
+     */
+    Resampler(uint32_t input_rate, uint32_t output_rate, SIMDLevel level = ActiveSIMDLevel());
+
+    /**
+     * @brief Resamples a batch
+     *
+     * @param in Interleaved stereo samples at the input rate
+     * @param count The number of stereo samples
+     * @param out Receives interleaved stereo samples, with room for MaxOutput(count, adjustment)
+     * @param adjustment Fraction to stretch the batch by, positive for more output samples
+     * @return size_t The number of stereo samples written
+     */
+    size_t Process(const float* in, size_t count, float* out, double adjustment = 0.0);
+
+    /**
+     * @brief Gets the most output samples Process can write for a batch
+     *
+     * @param count The number of input samples
+     * @param adjustment The stretch that will be passed to Process
+     */
+    size_t MaxOutput(size_t count, double adjustment = 0.0);
+
+    /**
+     * @brief Gets the input samples held back until enough later samples arrive to filter them
+     *
+     * Output sample n is aligned with input time n * step, so this is the only delay the filter adds.
+     */
+    size_t latency();
+
+    /**
+     * @brief Forgets all input, as though newly constructed
+     *
+     */
+    void Reset();
+};
+
+#endif
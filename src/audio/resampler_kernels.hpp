@@ -0,0 +1,70 @@
+/**
+ * @file resampler_kernels.hpp
+ * @brief Polyphase filter kernels shared by the resampler, one per SIMD level
+ *
+ */
+
+#ifndef RESAMPLER_KERNELS_H
+#define RESAMPLER_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "../util/cpu_features.hpp"
+
+// Input samples weighted for each output sample, a multiple of 8 for the AVX2 kernel
+static const int RESAMPLER_TAPS = 32;
+
+// Filter phases per input sample. Coefficients between phases are interpolated
+static const int RESAMPLER_PHASE_BITS = 8;
+static const int RESAMPLER_PHASES = 1 << RESAMPLER_PHASE_BITS;
+
+/**
+ * @brief One batch of work for a kernel.
+ *
+ * Positions are 32.32 fixed point input sample indices. The output sample at position p is the
+ * dot product of the filter for the fraction of p with the RESAMPLER_TAPS input samples starting
+ * at the integer part of p.
+ */
+struct ResampleBatch {
+    // Planar input, each holding available samples
+    const float* left;
+    const float* right;
+    size_t available;
+
+    // Position of the next output sample, advanced by the kernel
+    uint64_t position;
+    uint64_t step;
+
+    // RESAMPLER_PHASES + 1 filters of RESAMPLER_TAPS coefficients, the last equal to the first shifted by one
+    const float* filters;
+
+    // Interleaved stereo output
+    float* out;
+    size_t max_out;
+};
+
+/**
+ * @brief Produces output samples until the input or the output space runs out
+ *
+ * @return size_t The number of stereo samples written
+ */
+typedef size_t (*ResampleKernel)(ResampleBatch* batch);
+
+/**
+ * @brief Splits a position's fraction into a filter phase and the weight of the next phase
+ *
+ */
+inline void ResamplerPhase(uint64_t position, uint32_t* phase, float* weight) {
+    uint32_t fraction = (uint32_t)position;
+    *phase = fraction >> (32 - RESAMPLER_PHASE_BITS);
+    *weight = (float)(fraction & ((1u << (32 - RESAMPLER_PHASE_BITS)) - 1)) * (1.0f / (1u << (32 - RESAMPLER_PHASE_BITS)));
+}
+
+size_t ResampleScalar(ResampleBatch* batch);
+
+#ifdef LAMEBOY_X86
+size_t ResampleSSE2(ResampleBatch* batch);
+size_t ResampleAVX2(ResampleBatch* batch);
+#endif
+
+#endif
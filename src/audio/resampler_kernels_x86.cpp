@@ -0,0 +1,111 @@
+/**
+ * @file resampler_kernels_x86.cpp
+ * @brief SSE2 and AVX2 polyphase resampler kernels
+ *
+ * As with the scaling kernels, each function carries its own target attribute so the rest of the
+ * binary still runs on CPUs without AVX2.
+ */
+
+#include "./resampler_kernels.hpp"
+
+#ifdef LAMEBOY_X86
+
+#include <immintrin.h>
+
+#define SSE2_TARGET __attribute__((target("sse2")))
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+// SSE2
+
+/**
+ * @brief Adds up the lanes of two accumulators, returning the sums in lanes 0 and 1
+ *
+ */
+SSE2_TARGET static inline __m128 HorizontalSums128(__m128 left, __m128 right) {
+    // Interleaving gives l0+l2 r0+r2 l1+l3 r1+r3, and folding the high half down finishes both sums
+    __m128 low = _mm_unpacklo_ps(left, right);
+    __m128 high = _mm_unpackhi_ps(left, right);
+    __m128 sums = _mm_add_ps(low, high);
+    return _mm_add_ps(sums, _mm_movehl_ps(sums, sums));
+}
+
+SSE2_TARGET size_t ResampleSSE2(ResampleBatch* batch) {
+    size_t produced = 0;
+    uint64_t position = batch->position;
+
+    while (produced < batch->max_out && (position >> 32) + RESAMPLER_TAPS <= batch->available) {
+        size_t index = (size_t)(position >> 32);
+        uint32_t phase;
+        float weight;
+        ResamplerPhase(position, &phase, &weight);
+
+        const float* c0 = batch->filters + phase * RESAMPLER_TAPS;
+        const float* c1 = c0 + RESAMPLER_TAPS;
+        const float* left = batch->left + index;
+        const float* right = batch->right + index;
+        __m128 w = _mm_set1_ps(weight);
+        __m128 sum_left = _mm_setzero_ps();
+        __m128 sum_right = _mm_setzero_ps();
+
+        for (int k = 0; k < RESAMPLER_TAPS; k += 4) {
+            __m128 a = _mm_loadu_ps(c0 + k);
+            __m128 c = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(c1 + k), a), w));
+            sum_left = _mm_add_ps(sum_left, _mm_mul_ps(c, _mm_loadu_ps(left + k)));
+            sum_right = _mm_add_ps(sum_right, _mm_mul_ps(c, _mm_loadu_ps(right + k)));
+        }
+
+        // Lanes 0 and 1 hold the left and right sums, stored together
+        _mm_storel_pi((__m64*)(batch->out + produced * 2), HorizontalSums128(sum_left, sum_right));
+        produced++;
+        position += batch->step;
+    }
+
+    batch->position = position;
+    return produced;
+}
+
+// AVX2
+
+AVX2_TARGET size_t ResampleAVX2(ResampleBatch* batch) {
+    size_t produced = 0;
+    uint64_t position = batch->position;
+
+    while (produced < batch->max_out && (position >> 32) + RESAMPLER_TAPS <= batch->available) {
+        size_t index = (size_t)(position >> 32);
+        uint32_t phase;
+        float weight;
+        ResamplerPhase(position, &phase, &weight);
+
+        const float* c0 = batch->filters + phase * RESAMPLER_TAPS;
+        const float* c1 = c0 + RESAMPLER_TAPS;
+        const float* left = batch->left + index;
+        const float* right = batch->right + index;
+        __m256 w = _mm256_set1_ps(weight);
+        __m256 sum_left = _mm256_setzero_ps();
+        __m256 sum_right = _mm256_setzero_ps();
+
+        for (int k = 0; k < RESAMPLER_TAPS; k += 8) {
+            __m256 a = _mm256_loadu_ps(c0 + k);
+            __m256 c = _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(c1 + k), a), w));
+            sum_left = _mm256_add_ps(sum_left, _mm256_mul_ps(c, _mm256_loadu_ps(left + k)));
+            sum_right = _mm256_add_ps(sum_right, _mm256_mul_ps(c, _mm256_loadu_ps(right + k)));
+        }
+
+        // Fold each accumulator to 4 lanes, then finish as SSE does
+        __m128 left4 = _mm_add_ps(_mm256_castps256_ps128(sum_left), _mm256_extractf128_ps(sum_left, 1));
+        __m128 right4 = _mm_add_ps(_mm256_castps256_ps128(sum_right), _mm256_extractf128_ps(sum_right, 1));
+        __m128 low = _mm_unpacklo_ps(left4, right4);
+        __m128 high = _mm_unpackhi_ps(left4, right4);
+        __m128 sums = _mm_add_ps(low, high);
+        sums = _mm_add_ps(sums, _mm_movehl_ps(sums, sums));
+
+        _mm_storel_pi((__m64*)(batch->out + produced * 2), sums);
+        produced++;
+        position += batch->step;
+    }
+
+    batch->position = position;
+    return produced;
+}
+
+#endif
@@ -0,0 +1,314 @@
+/**
+ * @file batch.cpp
+ * @brief Runs a list of headless jobs across every core, printing hashes and timing as JSON lines
+ *
+ */
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "./core/game_boy.hpp"
+#include "./export/y4m_writer.hpp"
+#include "./util/work_stealing_pool.hpp"
+#include "./util/xxhash64.hpp"
+
+static const uint32_t DMG_CLOCK_RATE = 4194304;
+
+/**
+ * @brief What a job reports besides its timing
+ *
+ */
+enum JobOutput {
+    // The hash of the last frame
+    OUTPUT_LAST_HASH,
+    // The hash of every frame
+    OUTPUT_ALL_HASHES,
+    // The hash of the last frame, with the video written to a Y4M file
+    OUTPUT_Y4M
+};
+
+/**
+ * @brief One line of the jobs file
+ *
+ */
+struct BatchJob {
+    std::string rom;
+    long frames;
+    JobOutput output;
+    std::string path;
+};
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr, "Usage: %s [--threads N] [--accurate] [--deferred] JOBS\n", program);
+    fprintf(stderr, "  --threads N     Number of workers (default one per hardware thread)\n");
+    fprintf(stderr, "  --accurate      Draw with the pixel FIFO renderer\n");
+    fprintf(stderr, "  --deferred      Draw on a second thread per worker, best with --threads at half the cores\n");
+    fprintf(stderr, "JOBS is a file, or - for stdin, with one job per line:\n");
+    fprintf(stderr, "  ROM FRAMES [last|all|y4m=PATH]\n");
+    fprintf(stderr, "Blank lines and lines starting with # are ignored.\n");
+}
+
+/**
+ * @brief State kept by each worker and reused from job to job
+ *
+ */
+struct BatchWorker {
+    GameBoy* game_boy;
+    // Only created once the worker gets a job writing video, its buffers are large
+    Y4MWriter* y4m;
+};
+
+/**
+ * @brief Parses a jobs file
+ *
+ * @param input The jobs, one per line
+ * @param jobs Receives the jobs
+ * @return true if every line was understood, otherwise the bad line is reported on stderr
+ */
+static bool ParseJobs(std::istream& input, std::vector<BatchJob>* jobs) {
+    std::string line;
+    int number = 0;
+
+    while (std::getline(input, line)) {
+        number++;
+        std::istringstream fields(line);
+        BatchJob job;
+        std::string output;
+
+        if (!(fields >> job.rom) || job.rom[0] == '#') {
+            continue;
+        }
+
+        job.output = OUTPUT_LAST_HASH;
+        if (!(fields >> job.frames) || job.frames <= 0) {
+            fprintf(stderr, "Line %d: expected a frame count after the ROM\n", number);
+            return false;
+        }
+
+        if (fields >> output) {
+            if (output == "all") {
+                job.output = OUTPUT_ALL_HASHES;
+            } else if (output.compare(0, 4, "y4m=") == 0 && output.size() > 4) {
+                job.output = OUTPUT_Y4M;
+                job.path = output.substr(4);
+            } else if (output != "last") {
+                fprintf(stderr, "Line %d: unknown output %s\n", number, output.c_str());
+                return false;
+            }
+        }
+
+        jobs->push_back(job);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Appends a string to a JSON line as a quoted, escaped value
+ *
+ */
+static void AppendJSONString(std::string* out, const std::string& value) {
+    out->push_back('"');
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out->push_back('\\');
+            out->push_back(c);
+        } else if ((unsigned char)c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)c);
+            out->append(escaped);
+        } else {
+            out->push_back(c);
+        }
+    }
+    out->push_back('"');
+}
+
+/**
+ * @brief Runs a job on a worker's machine and builds its JSON line
+ *
+ * @param state The worker's machine, reset by loading the ROM, and video writer
+ * @param job The job to run
+ * @param index The job's position in the jobs file
+ * @param worker The worker index
+ * @param out Receives the JSON line, without a newline
+ * @return true if the job ran all of its frames and wrote its output
+ */
+static bool RunJob(BatchWorker* state, const BatchJob& job, size_t index, size_t worker, std::string* out) {
+    char number[64];
+    std::string& line = *out;
+    line = "{\"job\":";
+    line += std::to_string(index);
+    line += ",\"rom\":";
+    AppendJSONString(&line, job.rom);
+    line += ",\"worker\":";
+    line += std::to_string(worker);
+
+    GameBoy* game_boy = state->game_boy;
+    Y4MWriter* y4m = state->y4m;
+
+    auto start = std::chrono::steady_clock::now();
+    std::string error;
+    std::vector<uint64_t> hashes;
+    uint64_t hash = 0;
+    long frame = 0;
+
+    if (!game_boy->LoadROMFile(job.rom.c_str())) {
+        error = "could not read the ROM";
+    } else {
+        if (job.output == OUTPUT_Y4M && !y4m->Open(job.path.c_str())) {
+            error = "could not write " + job.path;
+        } else {
+            if (job.output == OUTPUT_ALL_HASHES) {
+                hashes.reserve(job.frames);
+            }
+
+            try {
+                for (; frame < job.frames; frame++) {
+                    game_boy->RunFrame();
+                    game_boy->ReadAudio(nullptr, game_boy->audioSamplesAvailable());
+
+                    hash = XXHash64(game_boy->framebuffer(), SCREEN_PIXELS * sizeof(uint32_t));
+                    if (job.output == OUTPUT_ALL_HASHES) {
+                        hashes.push_back(hash);
+                    } else if (job.output == OUTPUT_Y4M) {
+                        y4m->WriteFrame(game_boy->framebuffer());
+                    }
+                }
+            } catch (const std::runtime_error& exception) {
+                error = exception.what();
+            }
+
+            if (job.output == OUTPUT_Y4M && !y4m->Close() && error.empty()) {
+                error = "could not write " + job.path;
+            }
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    line += ",\"frames\":";
+    line += std::to_string(frame);
+    snprintf(number, sizeof(number), ",\"seconds\":%.6f,\"fps\":%.1f", seconds, seconds > 0 ? frame / seconds : 0.0);
+    line += number;
+
+    if (frame > 0 && job.output != OUTPUT_ALL_HASHES) {
+        snprintf(number, sizeof(number), ",\"hash\":\"%016" PRIx64 "\"", hash);
+        line += number;
+    }
+    if (job.output == OUTPUT_ALL_HASHES) {
+        line += ",\"hashes\":[";
+        for (size_t i = 0; i < hashes.size(); i++) {
+            snprintf(number, sizeof(number), "%s\"%016" PRIx64 "\"", i > 0 ? "," : "", hashes[i]);
+            line += number;
+        }
+        line += "]";
+    }
+
+    if (error.empty()) {
+        line += ",\"status\":\"ok\"}";
+        return true;
+    }
+
+    line += ",\"status\":\"error\",\"error\":";
+    AppendJSONString(&line, error);
+    line += "}";
+    return false;
+}
+
+int main(int argc, char *argv[])
+{
+    const char* jobs_path = nullptr;
+    long threads = 0;
+    PPUKind ppu_kind = FAST_PPU;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = strtol(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--accurate") == 0) {
+            ppu_kind = ACCURATE_PPU;
+        } else if (strcmp(argv[i], "--deferred") == 0) {
+            ppu_kind = DEFERRED_PPU;
+        } else if ((argv[i][0] != '-' || strcmp(argv[i], "-") == 0) && jobs_path == nullptr) {
+            jobs_path = argv[i];
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (jobs_path == nullptr || threads < 0) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    std::vector<BatchJob> jobs;
+    if (strcmp(jobs_path, "-") == 0) {
+        if (!ParseJobs(std::cin, &jobs)) {
+            return 2;
+        }
+    } else {
+        std::ifstream file(jobs_path);
+        if (!file) {
+            fprintf(stderr, "Could not read %s\n", jobs_path);
+            return 1;
+        }
+        if (!ParseJobs(file, &jobs)) {
+            return 2;
+        }
+    }
+
+    WorkStealingPool pool((size_t)threads);
+
+    // Each worker builds its machine on its first job and keeps it for the rest
+    std::vector<BatchWorker> workers(pool.threadCount(), BatchWorker { nullptr, nullptr });
+    std::mutex output_mutex;
+    size_t failures = 0;
+    uint64_t total_frames = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    pool.Run(jobs.size(), [&](size_t worker, size_t index) {
+        const BatchJob& job = jobs[index];
+        BatchWorker& state = workers[worker];
+        if (state.game_boy == nullptr) {
+            state.game_boy = new GameBoy(ppu_kind);
+        }
+        if (state.y4m == nullptr && job.output == OUTPUT_Y4M) {
+            state.y4m = new Y4MWriter(SCREEN_WIDTH, SCREEN_HEIGHT, DMG_CLOCK_RATE, DOTS_PER_FRAME);
+        }
+
+        std::string line;
+        bool failed = !RunJob(&state, job, index, worker, &line);
+
+        // Lines go out whole, in the order jobs finish
+        std::lock_guard<std::mutex> lock(output_mutex);
+        fputs(line.c_str(), stdout);
+        fputc('\n', stdout);
+        fflush(stdout);
+        failures += failed ? 1 : 0;
+        total_frames += failed ? 0 : job.frames;
+    });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (BatchWorker& state : workers) {
+        delete state.game_boy;
+        delete state.y4m;
+    }
+
+    fprintf(stderr, "%zu jobs (%zu failed) on %zu workers in %.3fs, %.1f jobs/s, %.0f fps overall, %" PRIu64 " steals\n",
+        jobs.size(), failures, pool.threadCount(), seconds, seconds > 0 ? jobs.size() / seconds : 0.0,
+        seconds > 0 ? total_frames / seconds : 0.0, pool.steals());
+
+    return failures > 0 ? 1 : 0;
+}
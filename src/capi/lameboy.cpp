@@ -0,0 +1,183 @@
+/**
+ * @file lameboy.cpp
+ * @brief Implementation of the C interface over GameBoy
+ *
+ */
+
+#include <cstring>
+#include <stdexcept>
+#include "./lameboy.h"
+#include "../core/game_boy.hpp"
+
+static const uint16_t WRAM_START = 0xC000;
+static const uint16_t HRAM_START = 0xFF80;
+
+static_assert(LB_SCREEN_WIDTH * LB_SCREEN_HEIGHT == SCREEN_PIXELS, "C screen size must match the PPU");
+static_assert(LB_BUTTON_A == BUTTON_A && LB_BUTTON_START == BUTTON_START, "C button bits must match the joypad");
+
+struct lb_instance {
+    GameBoy machine;
+
+    // The PPU draws here directly, so the pointer handed out survives ROM loads and resets
+    uint32_t framebuffer[SCREEN_PIXELS];
+
+    char error[128];
+
+    lb_instance(PPUKind kind) : machine(kind) {
+        for (int i = 0; i < SCREEN_PIXELS; i++) {
+            this->framebuffer[i] = DMG_SHADES[0];
+        }
+        this->machine.SetFramebuffer(this->framebuffer);
+        this->error[0] = '\0';
+    }
+};
+
+// A spare machine the state is copied in and out of
+struct lb_snapshot {
+    GameBoy machine;
+
+    lb_snapshot(PPUKind kind) : machine(kind) {}
+};
+
+static int Fail(lb_instance* instance, const char* message) {
+    strncpy(instance->error, message, sizeof(instance->error) - 1);
+    instance->error[sizeof(instance->error) - 1] = '\0';
+    return LB_ERROR;
+}
+
+// Every exported function that can throw catches everything, since no C++ exception may unwind into a C caller.
+// GameBoy allocates its components with throwing new, so even creation can fail with bad_alloc
+static int FailWithException(lb_instance* instance) {
+    try {
+        throw;
+    } catch (const std::exception& error) {
+        return Fail(instance, error.what());
+    } catch (...) {
+        return Fail(instance, "Unknown error");
+    }
+}
+
+lb_instance* lb_create(uint32_t flags) {
+    try {
+        return new lb_instance((flags & LB_ACCURATE_PPU) != 0 ? ACCURATE_PPU : FAST_PPU);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void lb_destroy(lb_instance* instance) {
+    try {
+        delete instance;
+    } catch (...) {
+    }
+}
+
+int lb_load_rom(lb_instance* instance, const uint8_t* data, size_t size) {
+    try {
+        instance->error[0] = '\0';
+        return instance->machine.LoadROM(data, size) ? LB_OK : Fail(instance, "Empty ROM image");
+    } catch (...) {
+        return FailWithException(instance);
+    }
+}
+
+int lb_load_rom_file(lb_instance* instance, const char* path) {
+    try {
+        instance->error[0] = '\0';
+        return instance->machine.LoadROMFile(path) ? LB_OK : Fail(instance, "Could not read the ROM file");
+    } catch (...) {
+        return FailWithException(instance);
+    }
+}
+
+int lb_step(lb_instance* instance, uint32_t frames, uint8_t buttons) {
+    try {
+        GameBoy& machine = instance->machine;
+        machine.SetButtons(buttons);
+
+        for (uint32_t frame = 0; frame < frames; frame++) {
+            machine.RunFrame();
+            // Keeps the sample buffer from filling, nothing reads the audio
+            machine.ReadAudio(nullptr, machine.audioSamplesAvailable());
+        }
+        return LB_OK;
+    } catch (...) {
+        return FailWithException(instance);
+    }
+}
+
+int lb_step_many(lb_instance* const* instances, size_t count, uint32_t frames, const uint8_t* buttons) {
+    int result = LB_OK;
+
+    // lb_step reports its own failures, so nothing can escape here
+    for (size_t i = 0; i < count; i++) {
+        if (lb_step(instances[i], frames, buttons != nullptr ? buttons[i] : 0) != LB_OK) {
+            result = LB_ERROR;
+        }
+    }
+
+    return result;
+}
+
+lb_snapshot* lb_snapshot_create(lb_instance* instance) {
+    lb_snapshot* snapshot = nullptr;
+
+    try {
+        snapshot = new lb_snapshot(instance->machine.ppuKind());
+        snapshot->machine.CopyStateFrom(&instance->machine);
+        return snapshot;
+    } catch (...) {
+        delete snapshot;
+        FailWithException(instance);
+        return nullptr;
+    }
+}
+
+int lb_snapshot_save(lb_instance* instance, lb_snapshot* snapshot) {
+    try {
+        if (!snapshot->machine.CopyStateFrom(&instance->machine)) {
+            return Fail(instance, "Snapshot was made with different flags");
+        }
+        return LB_OK;
+    } catch (...) {
+        return FailWithException(instance);
+    }
+}
+
+int lb_reset_to(lb_instance* instance, lb_snapshot* snapshot) {
+    try {
+        if (!instance->machine.CopyStateFrom(&snapshot->machine)) {
+            return Fail(instance, "Snapshot was made with different flags");
+        }
+        return LB_OK;
+    } catch (...) {
+        return FailWithException(instance);
+    }
+}
+
+void lb_snapshot_destroy(lb_snapshot* snapshot) {
+    try {
+        delete snapshot;
+    } catch (...) {
+    }
+}
+
+const uint32_t* lb_framebuffer(lb_instance* instance) {
+    return instance->framebuffer;
+}
+
+const uint8_t* lb_wram(lb_instance* instance) {
+    return instance->machine.memory() + WRAM_START;
+}
+
+const uint8_t* lb_hram(lb_instance* instance) {
+    return instance->machine.memory() + HRAM_START;
+}
+
+uint64_t lb_cycles(lb_instance* instance) {
+    return instance->machine.cycles();
+}
+
+const char* lb_last_error(lb_instance* instance) {
+    return instance->error;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file lameboy.h
+ * @brief C interface for embedding the emulator, such as in reinforcement learning environments
+ *
+ * Every instance owns its framebuffer and memory, and hands out borrowed pointers to them that stay
+ * valid until lb_destroy, so observations are read in place after each step. Once an instance has
+ * been created and a ROM loaded, lb_step, lb_step_many, lb_snapshot_save and lb_reset_to never
+ * allocate. Functions returning int return LB_OK or LB_ERROR, with the reason in lb_last_error.
+ * No C++ exception leaves the library: failures, running out of memory included, come back as NULL
+ * or LB_ERROR, and an instance whose load failed can still be stepped.
+ * An instance may be used by one thread at a time; separate instances are independent.
+ */
+
+#ifndef LAMEBOY_H
+#define LAMEBOY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define LB_API __declspec(dllexport)
+#else
+#define LB_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LB_SCREEN_WIDTH 160
+#define LB_SCREEN_HEIGHT 144
+
+/* Work RAM at 0xC000 and high RAM at 0xFF80 */
+#define LB_WRAM_SIZE 0x2000
+#define LB_HRAM_SIZE 0x7F
+
+#define LB_OK 0
+#define LB_ERROR -1
+
+/* Flags for lb_create */
+#define LB_ACCURATE_PPU 0x01
+
+/* Button bits for lb_step, set while a button is held */
+#define LB_BUTTON_RIGHT 0x01
+#define LB_BUTTON_LEFT 0x02
+#define LB_BUTTON_UP 0x04
+#define LB_BUTTON_DOWN 0x08
+#define LB_BUTTON_A 0x10
+#define LB_BUTTON_B 0x20
+#define LB_BUTTON_SELECT 0x40
+#define LB_BUTTON_START 0x80
+
+typedef struct lb_instance lb_instance;
+typedef struct lb_snapshot lb_snapshot;
+
+/**
+ * @brief Creates an instance with empty memory
+ *
+ * @param flags LB_ACCURATE_PPU to draw with the pixel FIFO renderer, otherwise 0
+ * @return lb_instance* The instance, or NULL if it could not be allocated
+ */
+LB_API lb_instance* lb_create(uint32_t flags);
+
+/**
+ * @brief Destroys an instance, invalidating every pointer borrowed from it
+ *
+ * @param instance The instance, or NULL
+ */
+LB_API void lb_destroy(lb_instance* instance);
+
+/**
+ * @brief Loads a ROM image and resets the instance
+ *
+ * @param instance The instance
+ * @param data The ROM image, copied
+ * @param size The size of the image in bytes
+ */
+LB_API int lb_load_rom(lb_instance* instance, const uint8_t* data, size_t size);
+
+/**
+ * @brief Loads a ROM file and resets the instance
+ *
+ * @param instance The instance
+ * @param path The path of the ROM file
+ */
+LB_API int lb_load_rom_file(lb_instance* instance, const char* path);
+
+/**
+ * @brief Holds a set of buttons and runs whole frames. Audio is discarded
+ *
+ * @param instance The instance
+ * @param frames The number of frames to run
+ * @param buttons LB_BUTTON_* bits held for every frame
+ */
+LB_API int lb_step(lb_instance* instance, uint32_t frames, uint8_t buttons);
+
+/**
+ * @brief Steps a batch of instances in turn on the calling thread
+ *
+ * @param instances The instances
+ * @param count The number of instances
+ * @param frames The number of frames to run each instance for
+ * @param buttons The buttons for each instance, or NULL for none
+ * @return int LB_ERROR if any instance failed, whose lb_last_error says why
+ */
+LB_API int lb_step_many(lb_instance* const* instances, size_t count, uint32_t frames, const uint8_t* buttons);
+
+/**
+ * @brief Creates a snapshot holding the current state of an instance
+ *
+ * @param instance The instance to capture
+ * @return lb_snapshot* The snapshot, or NULL if it could not be allocated, with the reason in lb_last_error
+ */
+LB_API lb_snapshot* lb_snapshot_create(lb_instance* instance);
+
+/**
+ * @brief Captures the current state of an instance into an existing snapshot
+ *
+ * @param instance The instance to capture
+ * @param snapshot A snapshot created from an instance with the same flags
+ */
+LB_API int lb_snapshot_save(lb_instance* instance, lb_snapshot* snapshot);
+
+/**
+ * @brief Returns an instance to a snapshot, which may have been taken from another instance.
+ *
+ * Stepping after a reset gives the same frames and memory as stepping the captured instance did.
+ * Borrowed pointers stay valid and see the restored state.
+ *
+ * @param instance The instance
+ * @param snapshot A snapshot created from an instance with the same flags
+ */
+LB_API int lb_reset_to(lb_instance* instance, lb_snapshot* snapshot);
+
+/**
+ * @brief Destroys a snapshot
+ *
+ * @param snapshot The snapshot, or NULL
+ */
+LB_API void lb_snapshot_destroy(lb_snapshot* snapshot);
+
+/**
+ * @brief Borrows the framebuffer, LB_SCREEN_WIDTH x LB_SCREEN_HEIGHT ARGB8888 pixels in row order
+ *
+ */
+LB_API const uint32_t* lb_framebuffer(lb_instance* instance);
+
+/**
+ * @brief Borrows work RAM, LB_WRAM_SIZE bytes from 0xC000
+ *
+ */
+LB_API const uint8_t* lb_wram(lb_instance* instance);
+
+/**
+ * @brief Borrows high RAM, LB_HRAM_SIZE bytes from 0xFF80
+ *
+ */
+LB_API const uint8_t* lb_hram(lb_instance* instance);
+
+/**
+ * @brief Gets the number of dots run since the ROM was loaded
+ *
+ */
+LB_API uint64_t lb_cycles(lb_instance* instance);
+
+/**
+ * @brief Gets the reason the last call on an instance failed, or an empty string
+ *
+ */
+LB_API const char* lb_last_error(lb_instance* instance);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,351 @@
+/**
+ * @file game_boy.cpp
+ * @brief Implementation of the emulated machine
+ *
+ */
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include "./game_boy.hpp"
+
+// The last page of the ROM area
+static const uint8_t ROM_LAST_PAGE = 0x7F;
+
+GameBoy::GameBoy(PPUKind ppu_kind, uint32_t sample_rate) : memory_(new uint8_t[65536]()), state_(memory_), cpu_(&state_) {
+    this->ppu_kind_ = ppu_kind;
+    this->scheduler_ = nullptr;
+    this->fast_ppu_ = nullptr;
+    this->accurate_ppu_ = nullptr;
+    this->deferred_ppu_ = nullptr;
+    this->ppu_ = nullptr;
+    this->dma_ = nullptr;
+    this->apu_ = nullptr;
+    this->joypad_ = nullptr;
+    this->sample_rate_ = sample_rate;
+    this->framebuffer_target_ = nullptr;
+    this->frame_end_ = 0;
+
+    // The destructor does not run for a constructor that throws
+    try {
+        this->Reset();
+    } catch (...) {
+        delete[] this->memory_;
+        throw;
+    }
+}
+
+GameBoy::~GameBoy() {
+    this->DestroyComponents();
+    delete[] this->memory_;
+}
+
+bool GameBoy::LoadROM(const uint8_t* data, size_t size) {
+    if (data == nullptr || size == 0) {
+        return false;
+    }
+
+    this->rom_.assign(data, data + (size < MAX_ROM_SIZE ? size : MAX_ROM_SIZE));
+    this->Reset();
+    return true;
+}
+
+bool GameBoy::LoadROMFile(const char* path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return this->LoadROM(data.data(), data.size());
+}
+
+void GameBoy::Reset() {
+    // The ROM area beyond the end of a small image reads as an open bus
+    memset(this->memory_, 0xFF, MAX_ROM_SIZE);
+    memset(this->memory_ + MAX_ROM_SIZE, 0, 65536 - MAX_ROM_SIZE);
+    if (!this->rom_.empty()) {
+        memcpy(this->memory_, this->rom_.data(), this->rom_.size());
+    }
+
+    // Registers as the DMG boot ROM leaves them
+    this->state_.setAF(0x01B0);
+    this->state_.setBC(0x0013);
+    this->state_.setDE(0x00D8);
+    this->state_.setHL(0x014D);
+    this->state_.setStackPointer(0xFFFE);
+    this->state_.setProgramCounter(0x0100);
+
+    this->memory_[IF_ADDRESS] = 0xE1;
+    this->memory_[LCDC_ADDRESS] = 0x91;
+    this->memory_[BGP_ADDRESS] = 0xFC;
+    this->memory_[OBP0_ADDRESS] = 0xFF;
+    this->memory_[OBP1_ADDRESS] = 0xFF;
+    this->memory_[NR50_ADDRESS] = 0x77;
+    this->memory_[NR51_ADDRESS] = 0xF3;
+
+    // Everything is built before the old components go, so a failed allocation leaves a machine that still runs
+    Scheduler* scheduler = nullptr;
+    FastPPU* fast_ppu = nullptr;
+    AccuratePPU* accurate_ppu = nullptr;
+    DeferredPPU* deferred_ppu = nullptr;
+    DMAController* dma = nullptr;
+    APU* apu = nullptr;
+    Joypad* joypad = nullptr;
+    try {
+        scheduler = new Scheduler();
+        PPUBase* ppu = nullptr;
+        if (this->ppu_kind_ == ACCURATE_PPU) {
+            accurate_ppu = new AccuratePPU(this->memory_);
+            ppu = accurate_ppu;
+        } else if (this->ppu_kind_ == DEFERRED_PPU) {
+            // Starts from memory as set up above, and sees every later change through the log
+            deferred_ppu = new DeferredPPU(this->memory_, nullptr);
+            ppu = deferred_ppu->timing();
+        } else {
+            fast_ppu = new FastPPU(this->memory_);
+            ppu = fast_ppu;
+        }
+        dma = new DMAController(this->memory_, &this->state_, scheduler, ppu);
+        apu = new APU(this->memory_, scheduler, this->sample_rate_);
+        joypad = new Joypad(this->memory_, &this->state_);
+    } catch (...) {
+        delete joypad;
+        delete apu;
+        delete dma;
+        delete deferred_ppu;
+        delete accurate_ppu;
+        delete fast_ppu;
+        delete scheduler;
+        throw;
+    }
+
+    this->DestroyComponents();
+
+    this->scheduler_ = scheduler;
+    this->fast_ppu_ = fast_ppu;
+    this->accurate_ppu_ = accurate_ppu;
+    this->deferred_ppu_ = deferred_ppu;
+    this->dma_ = dma;
+    this->apu_ = apu;
+    this->joypad_ = joypad;
+    this->frame_end_ = DOTS_PER_FRAME;
+
+    if (this->accurate_ppu_ != nullptr) {
+        this->ppu_ = this->accurate_ppu_;
+        this->state_.AddMemoryObserver(this->accurate_ppu_, 0xFE, 0xFE);
+        this->ppu_->SetFramebuffer(this->framebuffer_target_);
+    } else if (this->deferred_ppu_ != nullptr) {
+        this->ppu_ = this->deferred_ppu_->timing();
+        this->state_.AddMemoryObserver(this->deferred_ppu_, 0x80, 0x9F);
+        this->state_.AddMemoryObserver(this->deferred_ppu_, 0xFE, 0xFF);
+        this->deferred_ppu_->SetFramebuffer(this->framebuffer_target_);
+    } else {
+        this->ppu_ = this->fast_ppu_;
+        this->state_.AddMemoryObserver(this->fast_ppu_, 0xFE, 0xFE);
+        this->ppu_->SetFramebuffer(this->framebuffer_target_);
+    }
+    this->state_.AddMemoryObserver(this->apu_, 0xFF, 0xFF);
+
+    this->state_.AddMemoryObserver(this, 0x00, ROM_LAST_PAGE);
+}
+
+void GameBoy::DestroyComponents() {
+    this->state_.RemoveMemoryObserver(this);
+
+    delete this->joypad_;
+    if (this->apu_ != nullptr) {
+        this->state_.RemoveMemoryObserver(this->apu_);
+        delete this->apu_;
+    }
+    delete this->dma_;
+    if (this->fast_ppu_ != nullptr) {
+        this->state_.RemoveMemoryObserver(this->fast_ppu_);
+        delete this->fast_ppu_;
+    }
+    if (this->accurate_ppu_ != nullptr) {
+        this->state_.RemoveMemoryObserver(this->accurate_ppu_);
+        delete this->accurate_ppu_;
+    }
+    if (this->deferred_ppu_ != nullptr) {
+        this->state_.RemoveMemoryObserver(this->deferred_ppu_);
+        delete this->deferred_ppu_;
+    }
+    delete this->scheduler_;
+
+    this->apu_ = nullptr;
+    this->joypad_ = nullptr;
+    this->dma_ = nullptr;
+    this->fast_ppu_ = nullptr;
+    this->accurate_ppu_ = nullptr;
+    this->deferred_ppu_ = nullptr;
+    this->ppu_ = nullptr;
+    this->scheduler_ = nullptr;
+}
+
+void GameBoy::RunFrame() {
+    // One switch per frame rather than a virtual call per instruction
+    switch (this->ppu_kind_) {
+        case FAST_PPU:
+            this->RunFrameWith(this->fast_ppu_);
+            break;
+        case ACCURATE_PPU:
+            this->RunFrameWith(this->accurate_ppu_);
+            break;
+        case DEFERRED_PPU:
+            this->RunFrameWith(this->deferred_ppu_);
+            break;
+    }
+}
+
+template <typename P>
+void GameBoy::RunFrameWith(P* ppu) {
+    Scheduler* scheduler = this->scheduler_;
+    uint64_t frame_end = this->frame_end_;
+
+    while (!ppu->frameComplete() && scheduler->now() < frame_end) {
+        uint32_t cycles = this->cpu_.Step() + this->dma_->TakeStallCycles();
+
+        ppu->Tick((uint16_t)cycles);
+        scheduler->Advance(cycles);
+    }
+
+    this->FinishFrame(ppu);
+}
+
+uint32_t GameBoy::StepInstruction() {
+    switch (this->ppu_kind_) {
+        case FAST_PPU:
+            return this->StepWith(this->fast_ppu_);
+        case ACCURATE_PPU:
+            return this->StepWith(this->accurate_ppu_);
+        case DEFERRED_PPU:
+            return this->StepWith(this->deferred_ppu_);
+    }
+    return 0;
+}
+
+template <typename P>
+uint32_t GameBoy::StepWith(P* ppu) {
+    uint32_t cycles = this->cpu_.Step() + this->dma_->TakeStallCycles();
+
+    ppu->Tick((uint16_t)cycles);
+    this->scheduler_->Advance(cycles);
+
+    if (ppu->frameComplete() || this->scheduler_->now() >= this->frame_end_) {
+        this->FinishFrame(ppu);
+    }
+    return cycles;
+}
+
+template <typename P>
+void GameBoy::FinishFrame(P* ppu) {
+    ppu->AcknowledgeFrame();
+    this->apu_->EndFrame();
+    this->frame_end_ = this->scheduler_->now() + DOTS_PER_FRAME;
+}
+
+void GameBoy::SetButtons(uint8_t buttons) {
+    this->joypad_->SetButtons(buttons);
+}
+
+bool GameBoy::CopyStateFrom(GameBoy* other) {
+    if (other->ppu_kind_ != this->ppu_kind_ || other->sample_rate_ != this->sample_rate_) {
+        return false;
+    }
+    if (this->ppu_kind_ == DEFERRED_PPU) {
+        return false;
+    }
+    if (other == this) {
+        return true;
+    }
+
+    // Only allocates when the other ROM is larger than any this machine has held
+    this->rom_.assign(other->rom_.begin(), other->rom_.end());
+    memcpy(this->memory_, other->memory_, 65536);
+
+    SM83State* source = &other->state_;
+    this->state_.setAF(source->af());
+    this->state_.setBC(source->bc());
+    this->state_.setDE(source->de());
+    this->state_.setHL(source->hl());
+    this->state_.setStackPointer(source->stackPointer());
+    this->state_.setProgramCounter(source->programCounter());
+
+    // Pending events belong to the DMA controller, which schedules its own again
+    this->scheduler_->Restart(other->scheduler_->now());
+    this->frame_end_ = other->frame_end_;
+    if (this->ppu_kind_ == ACCURATE_PPU) {
+        this->accurate_ppu_->CopyStateFrom(*other->accurate_ppu_);
+    } else {
+        this->fast_ppu_->CopyStateFrom(*other->fast_ppu_);
+    }
+    this->dma_->CopyStateFrom(*other->dma_);
+    this->apu_->CopyStateFrom(*other->apu_);
+    this->joypad_->SetButtons(other->joypad_->buttons());
+
+    // SetButtons may have requested an interrupt the other machine never saw
+    this->memory_[IF_ADDRESS] = other->memory_[IF_ADDRESS];
+    this->memory_[P1_ADDRESS] = other->memory_[P1_ADDRESS];
+    return true;
+}
+
+const uint32_t* GameBoy::framebuffer() {
+    if (this->deferred_ppu_ != nullptr) {
+        return this->deferred_ppu_->framebuffer();
+    }
+    return this->ppu_->framebuffer();
+}
+
+void GameBoy::SetFramebuffer(uint32_t* framebuffer) {
+    this->framebuffer_target_ = framebuffer;
+    if (this->deferred_ppu_ != nullptr) {
+        this->deferred_ppu_->SetFramebuffer(framebuffer);
+    } else {
+        this->ppu_->SetFramebuffer(framebuffer);
+    }
+}
+
+size_t GameBoy::audioSamplesAvailable() {
+    return this->apu_->samplesAvailable();
+}
+
+size_t GameBoy::ReadAudio(float* out, size_t count) {
+    return this->apu_->ReadSamples(out, count);
+}
+
+uint32_t GameBoy::sampleRate() {
+    return this->sample_rate_;
+}
+
+uint64_t GameBoy::cycles() {
+    return this->scheduler_->now();
+}
+
+uint64_t GameBoy::instructions() {
+    return this->cpu_.instructions();
+}
+
+OpCodeProfile* GameBoy::opCodeProfile() {
+    return this->cpu_.profile();
+}
+
+PPUKind GameBoy::ppuKind() {
+    return this->ppu_kind_;
+}
+
+SM83Emulator* GameBoy::cpu() {
+    return &this->cpu_;
+}
+
+SM83State* GameBoy::state() {
+    return &this->state_;
+}
+
+uint8_t* GameBoy::memory() {
+    return this->memory_;
+}
+
+void GameBoy::OnMemoryWrite(uint16_t address, uint8_t value) {
+    this->memory_[address] = address < this->rom_.size() ? this->rom_[address] : 0xFF;
+}
@@ -0,0 +1,274 @@
+/**
+ * @file game_boy.hpp
+ * @brief The emulated machine: CPU, memory, PPU, APU and DMA driven from one clock, with no frontend dependencies
+ *
+ */
+
+#ifndef GAME_BOY_H
+#define GAME_BOY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../apu/apu.hpp"
+#include "../cpu/memory_observer.hpp"
+#include "../cpu/sm83_emulator.hpp"
+#include "../cpu/sm83_state.hpp"
+#include "../memory/dma_controller.hpp"
+#include "../memory/joypad.hpp"
+#include "../ppu/deferred_ppu.hpp"
+#include "../ppu/ppu.hpp"
+#include "./scheduler.hpp"
+
+// Without a memory bank controller only the first two ROM banks are mapped
+static const size_t MAX_ROM_SIZE = 0x8000;
+
+/**
+ * @brief The renderer used by the PPU, see FastPPU, AccuratePPU and DeferredPPU
+ *
+ */
+enum PPUKind {
+    FAST_PPU,
+    ACCURATE_PPU,
+    // FastPPU's frames, drawn on a second thread while the CPU runs on
+    DEFERRED_PPU
+};
+
+/**
+ * @brief A complete machine that can be run a frame at a time.
+ *
+ * Frontends only see the framebuffer and the audio samples, so the same core drives the SDL window,
+ * headless regression runs and anything else. Each frame's samples become available when the frame
+ * completes. The PPU kind is fixed per instance and dispatched once per frame, so the
+ * instruction loop is compiled separately for each renderer.
+ *
+ * Writes to the ROM area are discarded. Memory bank controllers are not emulated yet.
+ */
+class GameBoy : public MemoryObserver
+{
+
+private:
+
+    uint8_t* memory_;
+    std::vector<uint8_t> rom_;
+
+    SM83State state_;
+    SM83Emulator cpu_;
+
+    PPUKind ppu_kind_;
+    Scheduler* scheduler_;
+    FastPPU* fast_ppu_;
+    AccuratePPU* accurate_ppu_;
+    DeferredPPU* deferred_ppu_;
+    // The PPU whose timing the CPU sees, the timing half of a DeferredPPU
+    PPUBase* ppu_;
+    DMAController* dma_;
+    APU* apu_;
+    Joypad* joypad_;
+
+    uint32_t sample_rate_;
+
+    // External buffer the PPU draws into, or nullptr for its own
+    uint32_t* framebuffer_target_;
+
+    // The clock at which the current frame ends if the PPU has not completed one, as with the LCD off
+    uint64_t frame_end_;
+
+    /**
+     * @brief Releases the PPU, APU, DMA controller and scheduler
+     *
+     */
+    void DestroyComponents();
+
+    /**
+     * @brief Runs instructions until the PPU completes a frame, or a frame's worth of dots with the LCD off
+     *
+     * @param ppu The PPU matching ppu_kind_
+     */
+    template <typename P>
+    void RunFrameWith(P* ppu);
+
+    /**
+     * @brief Runs a single instruction, finishing the frame if it completes one
+     *
+     * @param ppu The PPU matching ppu_kind_
+     * @return uint32_t The dots taken, including any DMA stall
+     */
+    template <typename P>
+    uint32_t StepWith(P* ppu);
+
+    /**
+     * @brief Hands the completed frame and its audio over and starts timing the next one
+     *
+     * @param ppu The PPU matching ppu_kind_
+     */
+    template <typename P>
+    void FinishFrame(P* ppu);
+
+public:
+    /**
+     * @brief Constructs a new GameBoy with empty memory
+     *
+     * @param ppu_kind The renderer to draw frames with
+     * @param sample_rate Audio samples per second
+     */
+    GameBoy(PPUKind ppu_kind = FAST_PPU, uint32_t sample_rate = DEFAULT_SAMPLE_RATE);
+
+    ~GameBoy();
+
+    /**
+     * @brief Loads a ROM image and resets the machine
+     *
+     * @param data The ROM image
+     * @param size The size of the image in bytes. Only the first MAX_ROM_SIZE bytes are mapped
+     * @return true if the ROM was loaded
+     */
+    bool LoadROM(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Loads a ROM image from a file and resets the machine
+     *
+     * @param path The path of the ROM file
+     * @return true if the file could be read
+     */
+    bool LoadROMFile(const char* path);
+
+    /**
+     * @brief Puts the machine in the state the boot ROM leaves it in, with the loaded ROM mapped
+     *
+     * @throws std::bad_alloc if a component cannot be allocated. The old components are kept, so the machine can
+     * still run
+     */
+    void Reset();
+
+    /**
+     * @brief Runs the machine until the next frame is complete
+     *
+     * @throws std::runtime_error if the CPU reaches an op code that is not implemented
+     */
+    void RunFrame();
+
+    /**
+     * @brief Runs a single instruction with the rest of the machine kept in step.
+     *
+     * Meant for debuggers, which need to stop between any two instructions. A frame completed by the
+     * instruction is finished exactly as RunFrame would, and a later RunFrame carries on from the
+     * middle of the current frame.
+     *
+     * @return uint32_t The dots taken, including any DMA stall
+     * @throws std::runtime_error if the CPU reaches an op code that is not implemented
+     */
+    uint32_t StepInstruction();
+
+    /**
+     * @brief Sets the buttons held from now on
+     *
+     * @param buttons BUTTON_* bits
+     */
+    void SetButtons(uint8_t buttons);
+
+    /**
+     * @brief Makes this machine an exact copy of another between frames, without allocating.
+     *
+     * Memory, CPU registers, the clock, the PPU, the APU with its unread samples, DMA transfers in
+     * flight and the held buttons are all copied, so running both machines from here gives identical
+     * frames. Used to keep snapshots as spare machines and to restore them. The framebuffer set with
+     * SetFramebuffer stays in place and receives a copy of the other machine's last frame.
+     * DEFERRED_PPU machines cannot be copied, since their render state lives on another thread.
+     *
+     * @param other The machine to copy, with the same PPU kind and sample rate
+     * @return true if the state was copied, false if the machines are not alike or use DEFERRED_PPU
+     */
+    bool CopyStateFrom(GameBoy* other);
+
+    /**
+     * @brief Gets the last completed frame, 160x144 ARGB8888 pixels in row order
+     *
+     * With DEFERRED_PPU this waits for the render thread to catch up, which is only the tail of the
+     * frame since it draws while the CPU runs.
+     */
+    const uint32_t* framebuffer();
+
+    /**
+     * @brief Draws the following frames into an external 160x144 buffer. Passing nullptr restores the PPU's own buffer.
+     *
+     * Safe to call between frames, which lets a frontend hand the PPU a fresh buffer for every frame.
+     *
+     * @param framebuffer The buffer to draw into
+     */
+    void SetFramebuffer(uint32_t* framebuffer);
+
+    /**
+     * @brief Gets the number of stereo audio samples produced by completed frames and not yet read
+     *
+     */
+    size_t audioSamplesAvailable();
+
+    /**
+     * @brief Reads stereo audio samples, removing them from the machine
+     *
+     * @param out Receives the samples, left then right, or nullptr to discard them
+     * @param count The maximum number of stereo samples to read
+     * @return size_t The number of stereo samples read
+     */
+    size_t ReadAudio(float* out, size_t count);
+
+    /**
+     * @brief Gets the audio sample rate chosen at construction
+     *
+     */
+    uint32_t sampleRate();
+
+    /**
+     * @brief Gets the number of dots run since the last reset
+     *
+     */
+    uint64_t cycles();
+
+    /**
+     * @brief Gets the number of CPU instructions executed since construction
+     *
+     */
+    uint64_t instructions();
+
+    /**
+     * @brief Gets the op code counts of the CPU
+     *
+     * @return OpCodeProfile* The profile, or nullptr unless built with LAMEBOY_OPCODE_PROFILE
+     */
+    OpCodeProfile* opCodeProfile();
+
+    /**
+     * @brief Gets the PPU kind chosen at construction
+     *
+     */
+    PPUKind ppuKind();
+
+    /**
+     * @brief Gets the CPU, for attaching instruction observers
+     *
+     */
+    SM83Emulator* cpu();
+
+    /**
+     * @brief Gets the CPU state
+     *
+     */
+    SM83State* state();
+
+    /**
+     * @brief Gets the 65,536 byte memory bus
+     *
+     */
+    uint8_t* memory();
+
+    /**
+     * @brief Restores the ROM byte after a write to the ROM area
+     *
+     * @param address The 16bit address written to
+     * @param value The value written
+     */
+    void OnMemoryWrite(uint16_t address, uint8_t value) override;
+};
+
+#endif
@@ -0,0 +1,265 @@
+/**
+ * @file gbs_player.cpp
+ * @brief Implementation of the GBS player
+ *
+ */
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include "./gbs_player.hpp"
+#include "../ppu/ppu_registers.hpp"
+
+static const uint16_t TMA_ADDRESS = 0xFF06;
+static const uint16_t TAC_ADDRESS = 0xFF07;
+
+static const uint32_t ROM_BANK_SIZE = 0x4000;
+static const uint16_t BANK_SELECT_START = 0x2000;
+static const uint16_t BANK_SELECT_END = 0x3FFF;
+static const uint8_t ROM_LAST_PAGE = 0x7F;
+
+// Return address pushed before INIT and PLAY. Below GBS_MIN_LOAD_ADDRESS, so never real code
+static const uint16_t RETURN_ADDRESS = 0x0000;
+
+// Dots a routine may run before it is assumed to never return
+static const uint64_t CALL_LIMIT = 4194304;
+
+// Dots per timer increment for each TAC clock select
+static const uint32_t TIMER_DIVIDERS[4] = { 1024, 16, 64, 256 };
+
+static uint16_t Read16(const uint8_t* data) {
+    return (uint16_t)(data[0] | data[1] << 8);
+}
+
+static void ReadString(const uint8_t* data, char* out) {
+    memcpy(out, data, 32);
+    out[32] = '\0';
+}
+
+bool ParseGBSHeader(const uint8_t* data, size_t size, GBSHeader* header) {
+    if (data == nullptr || size <= GBS_HEADER_SIZE || memcmp(data, "GBS", 3) != 0) {
+        return false;
+    }
+
+    header->version = data[0x03];
+    header->song_count = data[0x04];
+    header->first_song = data[0x05];
+    header->load_address = Read16(data + 0x06);
+    header->init_address = Read16(data + 0x08);
+    header->play_address = Read16(data + 0x0A);
+    header->stack_pointer = Read16(data + 0x0C);
+    header->timer_modulo = data[0x0E];
+    header->timer_control = data[0x0F];
+    ReadString(data + 0x10, header->title);
+    ReadString(data + 0x30, header->author);
+    ReadString(data + 0x50, header->copyright);
+
+    return header->version == 1 && header->song_count > 0 &&
+        header->load_address >= GBS_MIN_LOAD_ADDRESS && header->load_address < 0x8000;
+}
+
+GBSPlayer::GBSPlayer(uint32_t sample_rate) : memory_(new uint8_t[65536]()), state_(memory_), cpu_(&state_) {
+    memset(&this->header_, 0, sizeof(this->header_));
+    this->loaded_ = false;
+    this->bank_ = 1;
+    this->scheduler_ = nullptr;
+    this->apu_ = nullptr;
+    this->sample_rate_ = sample_rate;
+    this->next_play_ = 0;
+    this->frame_start_ = 0;
+}
+
+GBSPlayer::~GBSPlayer() {
+    this->DestroyComponents();
+    delete[] this->memory_;
+}
+
+bool GBSPlayer::Load(const uint8_t* data, size_t size) {
+    GBSHeader header;
+    if (!ParseGBSHeader(data, size, &header)) {
+        return false;
+    }
+
+    // The image is laid out as it would be in a cartridge, so banks are simple 16KB slices
+    this->header_ = header;
+    this->image_.assign(header.load_address, 0xFF);
+    this->image_.insert(this->image_.end(), data + GBS_HEADER_SIZE, data + size);
+    this->loaded_ = true;
+    return true;
+}
+
+bool GBSPlayer::LoadFile(const char* path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return this->Load(data.data(), data.size());
+}
+
+void GBSPlayer::DestroyComponents() {
+    this->state_.RemoveMemoryObserver(this);
+
+    if (this->apu_ != nullptr) {
+        this->state_.RemoveMemoryObserver(this->apu_);
+        delete this->apu_;
+    }
+    delete this->scheduler_;
+
+    this->apu_ = nullptr;
+    this->scheduler_ = nullptr;
+}
+
+void GBSPlayer::MapBank(uint32_t bank) {
+    this->bank_ = bank == 0 ? 1 : bank;
+
+    size_t offset = (size_t)this->bank_ * ROM_BANK_SIZE;
+    size_t available = offset < this->image_.size() ? this->image_.size() - offset : 0;
+    size_t mapped = available < ROM_BANK_SIZE ? available : ROM_BANK_SIZE;
+
+    memcpy(this->memory_ + ROM_BANK_SIZE, this->image_.data() + offset, mapped);
+    memset(this->memory_ + ROM_BANK_SIZE + mapped, 0xFF, ROM_BANK_SIZE - mapped);
+}
+
+bool GBSPlayer::StartSong(uint8_t song) {
+    if (!this->loaded_ || song >= this->header_.song_count) {
+        return false;
+    }
+
+    this->DestroyComponents();
+
+    memset(this->memory_, 0, 65536);
+    size_t bank0 = this->image_.size() < ROM_BANK_SIZE ? this->image_.size() : ROM_BANK_SIZE;
+    memcpy(this->memory_, this->image_.data(), bank0);
+    memset(this->memory_ + bank0, 0xFF, ROM_BANK_SIZE - bank0);
+    this->MapBank(1);
+
+    // Sound on at full volume on both sides, and the timer as the header asks
+    this->memory_[NR52_ADDRESS] = NR52_POWER;
+    this->memory_[NR50_ADDRESS] = 0x77;
+    this->memory_[NR51_ADDRESS] = 0xFF;
+    this->memory_[TMA_ADDRESS] = this->header_.timer_modulo;
+    this->memory_[TAC_ADDRESS] = this->header_.timer_control;
+
+    this->state_.setAF(0x0000);
+    this->state_.setBC(0x0000);
+    this->state_.setDE(0x0000);
+    this->state_.setHL(0x0000);
+    this->state_.setA(song);
+    this->state_.setStackPointer(this->header_.stack_pointer);
+
+    this->scheduler_ = new Scheduler();
+    this->apu_ = new APU(this->memory_, this->scheduler_, this->sample_rate_);
+    this->state_.AddMemoryObserver(this->apu_, 0xFF, 0xFF);
+    this->state_.AddMemoryObserver(this, 0x00, ROM_LAST_PAGE);
+    this->frame_start_ = 0;
+
+    this->Call(this->header_.init_address);
+    this->next_play_ = this->scheduler_->now();
+    return true;
+}
+
+void GBSPlayer::Advance(uint32_t cycles) {
+    this->scheduler_->Advance(cycles);
+
+    if (this->scheduler_->now() - this->frame_start_ >= DOTS_PER_FRAME) {
+        this->apu_->EndFrame();
+        this->frame_start_ = this->scheduler_->now();
+    }
+}
+
+void GBSPlayer::Call(uint16_t address) {
+    uint16_t sp = this->state_.stackPointer();
+    this->state_.SetMemoryAt((uint16_t)(sp - 1), (uint8_t)(RETURN_ADDRESS >> 8));
+    this->state_.SetMemoryAt((uint16_t)(sp - 2), (uint8_t)RETURN_ADDRESS);
+    this->state_.setStackPointer((uint16_t)(sp - 2));
+    this->state_.setProgramCounter(address);
+
+    uint64_t limit = this->scheduler_->now() + CALL_LIMIT;
+
+    while (this->state_.programCounter() != RETURN_ADDRESS) {
+        if (this->scheduler_->now() >= limit) {
+            throw std::runtime_error("GBS routine did not return");
+        }
+        this->Advance(this->cpu_.Step());
+    }
+}
+
+void GBSPlayer::Run(uint64_t dots) {
+    if (this->apu_ == nullptr) {
+        return;
+    }
+
+    uint64_t end = this->scheduler_->now() + dots;
+
+    while (this->scheduler_->now() < end) {
+        uint64_t now = this->scheduler_->now();
+
+        if (now >= this->next_play_) {
+            this->Call(this->header_.play_address);
+
+            // A PLAY that overruns its period delays the next one rather than queueing them up
+            this->next_play_ += this->playPeriod();
+            if (this->next_play_ < this->scheduler_->now()) {
+                this->next_play_ = this->scheduler_->now();
+            }
+            continue;
+        }
+
+        // Idle until PLAY is due, the run ends or the APU frame is full
+        uint64_t until = this->next_play_ < end ? this->next_play_ : end;
+        uint64_t frame_end = this->frame_start_ + DOTS_PER_FRAME;
+        until = until < frame_end ? until : frame_end;
+        this->Advance((uint32_t)(until - now));
+    }
+
+    this->apu_->EndFrame();
+    this->frame_start_ = this->scheduler_->now();
+}
+
+uint32_t GBSPlayer::playPeriod() {
+    if ((this->header_.timer_control & GBS_TIMER_PLAY) == 0) {
+        return DOTS_PER_FRAME;
+    }
+
+    // The routines may reprogram the timer, so the rate follows the registers
+    uint8_t tac = this->memory_[TAC_ADDRESS];
+    uint8_t tma = this->memory_[TMA_ADDRESS];
+    return TIMER_DIVIDERS[tac & 0b11] * (256 - tma);
+}
+
+const GBSHeader& GBSPlayer::header() {
+    return this->header_;
+}
+
+size_t GBSPlayer::audioSamplesAvailable() {
+    return this->apu_ != nullptr ? this->apu_->samplesAvailable() : 0;
+}
+
+size_t GBSPlayer::ReadAudio(float* out, size_t count) {
+    return this->apu_ != nullptr ? this->apu_->ReadSamples(out, count) : 0;
+}
+
+uint32_t GBSPlayer::sampleRate() {
+    return this->sample_rate_;
+}
+
+uint64_t GBSPlayer::cycles() {
+    return this->scheduler_ != nullptr ? this->scheduler_->now() : 0;
+}
+
+uint8_t* GBSPlayer::memory() {
+    return this->memory_;
+}
+
+void GBSPlayer::OnMemoryWrite(uint16_t address, uint8_t value) {
+    if (address >= BANK_SELECT_START && address <= BANK_SELECT_END) {
+        this->MapBank(value);
+    }
+
+    // Restore the byte that was overwritten, from whichever bank is now mapped there
+    size_t offset = address < ROM_BANK_SIZE ? address : (size_t)this->bank_ * ROM_BANK_SIZE + (address - ROM_BANK_SIZE);
+    this->memory_[address] = offset < this->image_.size() ? this->image_[offset] : 0xFF;
+}
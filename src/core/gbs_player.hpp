@@ -0,0 +1,215 @@
+/**
+ * @file gbs_player.hpp
+ * @brief Plays GBS sound files on the CPU and APU alone, with no PPU
+ *
+ */
+
+#ifndef GBS_PLAYER_H
+#define GBS_PLAYER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../apu/apu.hpp"
+#include "../cpu/memory_observer.hpp"
+#include "../cpu/sm83_emulator.hpp"
+#include "../cpu/sm83_state.hpp"
+#include "./scheduler.hpp"
+
+static const size_t GBS_HEADER_SIZE = 0x70;
+
+// Code is never loaded below this, so it is safe to use as the return address of INIT and PLAY
+static const uint16_t GBS_MIN_LOAD_ADDRESS = 0x0400;
+
+// TAC bit selecting the timer rather than vertical blank as the PLAY rate
+static const uint8_t GBS_TIMER_PLAY = 0b00000100;
+
+/**
+ * @brief The fields of a GBS file header
+ *
+ */
+struct GBSHeader {
+    uint8_t version;
+    uint8_t song_count;
+    // 1 based
+    uint8_t first_song;
+    uint16_t load_address;
+    uint16_t init_address;
+    uint16_t play_address;
+    uint16_t stack_pointer;
+    uint8_t timer_modulo;
+    uint8_t timer_control;
+    char title[33];
+    char author[33];
+    char copyright[33];
+};
+
+/**
+ * @brief Reads and validates a GBS header
+ *
+ * @param data The start of the file
+ * @param size The size of the file in bytes
+ * @param header Receives the header fields, with the strings null terminated
+ * @return true if the data starts with a usable GBS header
+ */
+bool ParseGBSHeader(const uint8_t* data, size_t size, GBSHeader* header);
+
+/**
+ * @brief Runs the INIT and PLAY routines of a GBS file and collects the audio they produce.
+ *
+ * Only the CPU, the memory bus and the APU exist, so nothing is spent on video. Routines are
+ * entered by pushing a return address and jumping, then stepped through the op code handlers until
+ * they return. PLAY is called at the vertical blank rate or at the timer rate the header asks for.
+ * Writes to 0x2000-0x3FFF switch the ROM bank mapped at 0x4000-0x7FFF, as GBS files expect.
+ */
+class GBSPlayer : public MemoryObserver
+{
+
+private:
+
+    uint8_t* memory_;
+    std::vector<uint8_t> image_;
+    GBSHeader header_;
+    bool loaded_;
+    uint32_t bank_;
+
+    SM83State state_;
+    SM83Emulator cpu_;
+
+    Scheduler* scheduler_;
+    APU* apu_;
+    uint32_t sample_rate_;
+
+    // When PLAY is next due, and when the APU last ended a frame
+    uint64_t next_play_;
+    uint64_t frame_start_;
+
+    /**
+     * @brief Releases the APU and scheduler
+     *
+     */
+    void DestroyComponents();
+
+    /**
+     * @brief Maps a 16KB bank of the image at 0x4000-0x7FFF
+     *
+     * @param bank The bank number, 0 selecting bank 1
+     */
+    void MapBank(uint32_t bank);
+
+    /**
+     * @brief Advances the clock, ending APU frames so none grows too long
+     *
+     * @param cycles The number of dots to advance
+     */
+    void Advance(uint32_t cycles);
+
+    /**
+     * @brief Calls a routine and runs it until it returns
+     *
+     * @param address The entry point
+     * @throws std::runtime_error if the routine reaches an unimplemented op code or does not return within a second
+     */
+    void Call(uint16_t address);
+
+public:
+    /**
+     * @brief Constructs a new GBSPlayer with nothing loaded
+     *
+     * @param sample_rate Audio samples per second
+     */
+    GBSPlayer(uint32_t sample_rate = DEFAULT_SAMPLE_RATE);
+
+    ~GBSPlayer();
+
+    /**
+     * @brief Loads a GBS file
+     *
+     * @param data The file contents
+     * @param size The size of the file in bytes
+     * @return true if the file has a valid header
+     */
+    bool Load(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Loads a GBS file from disk
+     *
+     * @param path The path of the file
+     * @return true if the file could be read and has a valid header
+     */
+    bool LoadFile(const char* path);
+
+    /**
+     * @brief Resets the machine and runs INIT for a song
+     *
+     * @param song The 0 based song number
+     * @return true if a file is loaded and the song exists
+     * @throws std::runtime_error if INIT reaches an unimplemented op code or does not return
+     */
+    bool StartSong(uint8_t song);
+
+    /**
+     * @brief Plays the current song, calling PLAY whenever it is due
+     *
+     * The APU only holds a few frames of audio, so long runs should be split up and read in between.
+     *
+     * @param dots The number of dots to play for
+     * @throws std::runtime_error if PLAY reaches an unimplemented op code or does not return
+     */
+    void Run(uint64_t dots);
+
+    /**
+     * @brief Gets the number of dots between calls to PLAY, from the header or the timer registers
+     *
+     */
+    uint32_t playPeriod();
+
+    /**
+     * @brief Gets the header of the loaded file
+     *
+     */
+    const GBSHeader& header();
+
+    /**
+     * @brief Gets the number of stereo audio samples produced and not yet read
+     *
+     */
+    size_t audioSamplesAvailable();
+
+    /**
+     * @brief Reads stereo audio samples, removing them from the player
+     *
+     * @param out Receives the samples, left then right, or nullptr to discard them
+     * @param count The maximum number of stereo samples to read
+     * @return size_t The number of stereo samples read
+     */
+    size_t ReadAudio(float* out, size_t count);
+
+    /**
+     * @brief Gets the audio sample rate chosen at construction
+     *
+     */
+    uint32_t sampleRate();
+
+    /**
+     * @brief Gets the number of dots run since the song started
+     *
+     */
+    uint64_t cycles();
+
+    /**
+     * @brief Gets the 65,536 byte memory bus
+     *
+     */
+    uint8_t* memory();
+
+    /**
+     * @brief Switches ROM banks and restores ROM bytes after a write to the ROM area
+     *
+     * @param address The 16bit address written to
+     * @param value The value written
+     */
+    void OnMemoryWrite(uint16_t address, uint8_t value) override;
+};
+
+#endif
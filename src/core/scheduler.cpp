@@ -0,0 +1,66 @@
+/**
+ * @file scheduler.cpp
+ * @brief Implementation of the event scheduler
+ *
+ */
+
+#include <algorithm>
+#include "./scheduler.hpp"
+
+Scheduler::Scheduler() {
+    this->now_ = 0;
+    this->next_id_ = 0;
+}
+
+uint64_t Scheduler::now() {
+    return this->now_;
+}
+
+uint64_t Scheduler::nextEventTime() {
+    return this->events_.empty() ? UINT64_MAX : this->events_.front().time;
+}
+
+uint32_t Scheduler::Schedule(uint64_t delay, std::function<void(uint64_t)> callback) {
+    Event event;
+    event.time = this->now_ + delay;
+    event.id = this->next_id_++;
+    event.callback = callback;
+
+    this->events_.push_back(event);
+    std::push_heap(this->events_.begin(), this->events_.end(), Later);
+
+    return event.id;
+}
+
+void Scheduler::Cancel(uint32_t id) {
+    for (size_t i = 0; i < this->events_.size(); i++) {
+        if (this->events_[i].id == id) {
+            this->events_.erase(this->events_.begin() + i);
+            std::make_heap(this->events_.begin(), this->events_.end(), Later);
+            return;
+        }
+    }
+}
+
+void Scheduler::Restart(uint64_t now) {
+    this->now_ = now;
+    this->events_.clear();
+}
+
+void Scheduler::RunDueEvents() {
+    while (!this->events_.empty() && this->events_.front().time <= this->now_) {
+        std::pop_heap(this->events_.begin(), this->events_.end(), Later);
+        Event event = this->events_.back();
+        this->events_.pop_back();
+
+        // The callback may schedule further events, so the heap has to be consistent first
+        event.callback(this->now_ - event.time);
+    }
+}
+
+bool Scheduler::Later(const Event& a, const Event& b) {
+    if (a.time != b.time) {
+        return a.time > b.time;
+    }
+    return a.id > b.id;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file scheduler.hpp
+ * @brief Timestamp ordered event queue driven by the emulated clock
+ *
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Runs callbacks once the emulated clock reaches their due time.
+ *
+ * Components that act at a known time in the future, such as DMA transfers or the end of a bus
+ * restriction, schedule an event instead of being polled every cycle. Advance() only compares
+ * against the earliest due time until that time is reached.
+ */
+class Scheduler
+{
+
+private:
+
+    struct Event {
+        uint64_t time;
+        uint32_t id;
+        std::function<void(uint64_t)> callback;
+    };
+
+    // The emulated clock, in dots
+    uint64_t now_;
+
+    // Pending events, kept as a min-heap on time then id
+    std::vector<Event> events_;
+
+    uint32_t next_id_;
+
+    /**
+     * @brief Heap ordering, puts the earliest event and the first scheduled among equals at the front
+     *
+     */
+    static bool Later(const Event& a, const Event& b);
+
+    /**
+     * @brief Runs every event due at or before the current time
+     *
+     */
+    void RunDueEvents();
+
+public:
+    /**
+     * @brief Constructs a new Scheduler with the clock at 0
+     *
+     */
+    Scheduler();
+
+    /**
+     * @brief Gets the current emulated time in dots
+     *
+     */
+    uint64_t now();
+
+    /**
+     * @brief Gets the time of the earliest pending event, or UINT64_MAX if there is none
+     *
+     */
+    uint64_t nextEventTime();
+
+    /**
+     * @brief Schedules a callback
+     *
+     * @param delay Dots from now until the event is due
+     * @param callback Called with the number of dots the event ran late by
+     * @return uint32_t An id that can be passed to Cancel
+     */
+    uint32_t Schedule(uint64_t delay, std::function<void(uint64_t)> callback);
+
+    /**
+     * @brief Removes a pending event. Does nothing if it has already run
+     *
+     * @param id The id returned by Schedule
+     */
+    void Cancel(uint32_t id);
+
+    /**
+     * @brief Sets the clock and drops every pending event, for restoring a snapshot.
+     *
+     * Owners of the dropped events must schedule them again for the new time.
+     *
+     * @param now The new time in dots
+     */
+    void Restart(uint64_t now);
+
+    /**
+     * @brief Moves the clock forward and runs the events that became due, in time order
+     *
+     * @param cycles The number of dots to advance by
+     */
+    void Advance(uint32_t cycles) {
+        this->now_ += cycles;
+        if (!this->events_.empty() && this->events_.front().time <= this->now_) {
+            this->RunDueEvents();
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file cpu_engine.cpp
+ * @brief Implementation of the CPU engine adapters
+ *
+ */
+
+#include <cstdio>
+#include <cstring>
+#include "./cpu_engine.hpp"
+
+static const uint32_t MEMORY_SIZE = 0x10000;
+
+void CopyRegisters(SM83State* from, SM83State* to) {
+    to->setAF(from->af());
+    to->setBC(from->bc());
+    to->setDE(from->de());
+    to->setHL(from->hl());
+    to->setStackPointer(from->stackPointer());
+    to->setProgramCounter(from->programCounter());
+}
+
+InterpreterEngine::InterpreterEngine() : memory_(new uint8_t[MEMORY_SIZE]()), state_(memory_), cpu_(&state_) {
+    memset(this->rom_, 0, sizeof(this->rom_));
+    this->cycles_ = 0;
+    this->state_.AddMemoryObserver(this, 0x00, (ENGINE_ROM_SIZE >> 8) - 1);
+}
+
+InterpreterEngine::~InterpreterEngine() {
+    delete[] this->memory_;
+}
+
+const char* InterpreterEngine::name() {
+    return "interpreter";
+}
+
+void InterpreterEngine::Load(SM83State* registers, const uint8_t* memory) {
+    memcpy(this->memory_, memory, MEMORY_SIZE);
+    memcpy(this->rom_, memory, ENGINE_ROM_SIZE);
+    CopyRegisters(registers, &this->state_);
+    this->cycles_ = 0;
+}
+
+void InterpreterEngine::RunTo(uint64_t cycle) {
+    while (this->cycles_ < cycle) {
+        this->cycles_ += this->cpu_.Step();
+    }
+}
+
+uint64_t InterpreterEngine::cycles() {
+    return this->cycles_;
+}
+
+SM83State* InterpreterEngine::state() {
+    return &this->state_;
+}
+
+uint8_t* InterpreterEngine::memory() {
+    return this->memory_;
+}
+
+SM83Emulator* InterpreterEngine::cpu() {
+    return &this->cpu_;
+}
+
+void InterpreterEngine::OnMemoryWrite(uint16_t address, uint8_t value) {
+    this->memory_[address] = this->rom_[address];
+}
+
+LockstepEngine::LockstepEngine(size_t instance_count, SIMDLevel level) : lockstep_(instance_count, level), state_(lockstep_.memory(0)) {
+    this->budget_ = 0;
+    snprintf(this->name_, sizeof(this->name_), "lockstep-%s", SIMDLevelName(this->lockstep_.simdLevel()));
+}
+
+const char* LockstepEngine::name() {
+    return this->name_;
+}
+
+void LockstepEngine::Load(SM83State* registers, const uint8_t* memory) {
+    // LoadROM also clears the lane registers, cycle counts and carried overshoot
+    this->lockstep_.LoadROM(memory, ENGINE_ROM_SIZE);
+
+    for (size_t i = 0; i < this->lockstep_.instanceCount(); i++) {
+        memcpy(this->lockstep_.memory(i), memory, MEMORY_SIZE);
+        this->lockstep_.WriteRegisters(i, registers);
+    }
+
+    CopyRegisters(registers, &this->state_);
+    this->budget_ = 0;
+}
+
+void LockstepEngine::RunTo(uint64_t cycle) {
+    // Run stops each instance at the first boundary at or past the total of the budgets given
+    if (cycle > this->budget_) {
+        this->lockstep_.Run((uint32_t)(cycle - this->budget_));
+        this->budget_ = cycle;
+    }
+    this->lockstep_.ReadRegisters(0, &this->state_);
+}
+
+uint64_t LockstepEngine::cycles() {
+    return this->lockstep_.cycles(0);
+}
+
+SM83State* LockstepEngine::state() {
+    return &this->state_;
+}
+
+uint8_t* LockstepEngine::memory() {
+    return this->lockstep_.memory(0);
+}
+
+LockstepSM83* LockstepEngine::lockstep() {
+    return &this->lockstep_;
+}
@@ -0,0 +1,164 @@
+/**
+ * @file cpu_engine.hpp
+ * @brief Common interface over the CPU execution engines, used to check them against each other
+ *
+ */
+
+#ifndef CPU_ENGINE_H
+#define CPU_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "./memory_observer.hpp"
+#include "./sm83_emulator.hpp"
+#include "./sm83_lockstep.hpp"
+#include "./sm83_state.hpp"
+
+// Bytes of ROM that engines protect from writes, as on a cartridge without an MBC
+static const uint32_t ENGINE_ROM_SIZE = 0x8000;
+
+/**
+ * @brief An engine that executes SM83 code on a 64KB memory bus.
+ *
+ * Engines are driven by cycle counts rather than instruction counts, since some run many
+ * instructions per call. RunTo always stops on an instruction boundary, so two engines that agree
+ * stop on the same instruction. Their state is read back as registers in an SM83State over the
+ * engine's own memory.
+ */
+class CPUEngine
+{
+public:
+    virtual ~CPUEngine() = default;
+
+    /**
+     * @brief Gets a short name for reports
+     *
+     */
+    virtual const char* name() = 0;
+
+    /**
+     * @brief Replaces the registers and memory of the engine and sets its cycle count to zero
+     *
+     * @param registers The registers to copy
+     * @param memory The 64KB memory bus to copy, the first ENGINE_ROM_SIZE bytes being ROM
+     */
+    virtual void Load(SM83State* registers, const uint8_t* memory) = 0;
+
+    /**
+     * @brief Runs whole instructions until at least a number of cycles have run since Load
+     *
+     * @param cycle The cycle count to reach
+     * @throws std::runtime_error if the engine reaches an op code that is not implemented
+     */
+    virtual void RunTo(uint64_t cycle) = 0;
+
+    /**
+     * @brief Gets the cycles run since Load
+     *
+     */
+    virtual uint64_t cycles() = 0;
+
+    /**
+     * @brief Gets the registers of the engine, in a state over its memory bus
+     *
+     */
+    virtual SM83State* state() = 0;
+
+    /**
+     * @brief Gets the engine's 64KB memory bus
+     *
+     */
+    virtual uint8_t* memory() = 0;
+};
+
+/**
+ * @brief Runs SM83Emulator, the reference interpreter
+ *
+ */
+class InterpreterEngine : public CPUEngine, public MemoryObserver
+{
+
+private:
+
+    uint8_t* memory_;
+    uint8_t rom_[ENGINE_ROM_SIZE];
+    SM83State state_;
+    SM83Emulator cpu_;
+    uint64_t cycles_;
+
+public:
+    InterpreterEngine();
+    ~InterpreterEngine();
+
+    const char* name() override;
+    void Load(SM83State* registers, const uint8_t* memory) override;
+    void RunTo(uint64_t cycle) override;
+    uint64_t cycles() override;
+    SM83State* state() override;
+    uint8_t* memory() override;
+
+    /**
+     * @brief Gets the interpreter, for attaching observers
+     *
+     */
+    SM83Emulator* cpu();
+
+    /**
+     * @brief Undoes writes to ROM
+     *
+     */
+    void OnMemoryWrite(uint16_t address, uint8_t value) override;
+};
+
+/**
+ * @brief Runs LockstepSM83 with every instance started from the same state, so converged
+ * instructions go through the lane kernels. Instance 0 is the one compared
+ *
+ */
+class LockstepEngine : public CPUEngine
+{
+
+private:
+
+    LockstepSM83 lockstep_;
+
+    // Registers of instance 0 over its memory, refreshed after each RunTo
+    SM83State state_;
+
+    // Sum of the budgets passed to LockstepSM83::Run since Load
+    uint64_t budget_;
+
+    char name_[32];
+
+public:
+    /**
+     * @brief Constructs a new LockstepEngine
+     *
+     * @param instance_count Identical instances to run, at least 2 for the lane kernels to be used
+     * @param level The SIMD level of the lane kernels
+     */
+    LockstepEngine(size_t instance_count, SIMDLevel level = ActiveSIMDLevel());
+
+    const char* name() override;
+    void Load(SM83State* registers, const uint8_t* memory) override;
+    void RunTo(uint64_t cycle) override;
+    uint64_t cycles() override;
+    SM83State* state() override;
+    uint8_t* memory() override;
+
+    /**
+     * @brief Gets the lockstep driver
+     *
+     */
+    LockstepSM83* lockstep();
+};
+
+/**
+ * @brief Copies the registers of one state into another
+ *
+ * @param from The state to read
+ * @param to The state to write
+ */
+void CopyRegisters(SM83State* from, SM83State* to);
+
+#endif
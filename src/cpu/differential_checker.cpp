@@ -0,0 +1,214 @@
+/**
+ * @file differential_checker.cpp
+ * @brief Implementation of the differential checker
+ *
+ */
+
+#include <cinttypes>
+#include <cstring>
+#include "./differential_checker.hpp"
+#include "../util/xxhash64.hpp"
+
+static const uint32_t MEMORY_SIZE = 0x10000;
+
+// Differing memory ranges listed in a report before the rest are summarised
+static const int MAX_REPORTED_RANGES = 8;
+
+DifferentialChecker::DifferentialChecker(CPUEngine* first, CPUEngine* second, uint32_t interval, size_t trace_length)
+    : checkpoint_memory_(MEMORY_SIZE, 0), checkpoint_(checkpoint_memory_.data()) {
+    this->first_ = first;
+    this->second_ = second;
+    this->interval_ = interval > 0 ? interval : 1;
+    this->trace_length_ = trace_length > 0 ? trace_length : 1;
+    this->checkpoint_cycle_ = 0;
+    this->checks_ = 0;
+}
+
+uint64_t DifferentialChecker::Hash(CPUEngine* engine) {
+    SM83State* state = engine->state();
+    uint16_t registers[6] = {
+        state->af(), state->bc(), state->de(), state->hl(), state->stackPointer(), state->programCounter()
+    };
+
+    return XXHash64(engine->memory(), MEMORY_SIZE, XXHash64(registers, sizeof(registers)) ^ engine->cycles());
+}
+
+bool DifferentialChecker::Run(SM83State* registers, const uint8_t* memory, uint64_t cycles) {
+    memcpy(this->checkpoint_memory_.data(), memory, MEMORY_SIZE);
+    CopyRegisters(registers, &this->checkpoint_);
+    this->checkpoint_cycle_ = 0;
+    this->checks_ = 0;
+    this->divergence_ = Divergence();
+
+    bool diverged = false;
+    uint64_t interval = 0;
+    while (this->checkpoint_cycle_ < cycles) {
+        uint64_t remaining = cycles - this->checkpoint_cycle_;
+        interval = remaining < this->interval_ ? remaining : this->interval_;
+        this->checks_++;
+
+        if (!this->AgreeAt(interval)) {
+            diverged = true;
+            break;
+        }
+
+        // Both engines agree, so either one's state becomes the new checkpoint
+        memcpy(this->checkpoint_memory_.data(), this->first_->memory(), MEMORY_SIZE);
+        CopyRegisters(this->first_->state(), &this->checkpoint_);
+        this->checkpoint_cycle_ += this->first_->cycles();
+    }
+
+    if (!diverged) {
+        return true;
+    }
+
+    // Narrows the interval until the engines agree at one boundary and differ one instruction later.
+    // agree is always a boundary both engines reach, disagree is a cycle where they differ
+    uint64_t agree = 0;
+    uint64_t disagree = interval;
+    while (disagree - agree > 1) {
+        uint64_t middle = agree + (disagree - agree) / 2;
+        if (!this->AgreeAt(middle)) {
+            disagree = middle;
+            continue;
+        }
+
+        uint64_t reached = this->first_->cycles();
+        if (reached >= disagree) {
+            // The instruction spanning middle is the one that diverges
+            break;
+        }
+        agree = reached;
+    }
+
+    this->AgreeAt(agree);
+    this->divergence_.cycle = this->checkpoint_cycle_ + agree;
+    this->divergence_.pc = this->first_->state()->programCounter();
+    this->divergence_.op_code = this->first_->memory()[this->divergence_.pc];
+
+    this->AgreeAt(agree + 1);
+    this->divergence_.differences = this->Describe();
+
+    this->RecordTraces(agree + 1);
+    return false;
+}
+
+bool DifferentialChecker::AgreeAt(uint64_t cycle) {
+    this->first_->Load(&this->checkpoint_, this->checkpoint_memory_.data());
+    this->second_->Load(&this->checkpoint_, this->checkpoint_memory_.data());
+    this->first_->RunTo(cycle);
+    this->second_->RunTo(cycle);
+    return Hash(this->first_) == Hash(this->second_);
+}
+
+void DifferentialChecker::RecordTraces(uint64_t cycle) {
+    CPUEngine* engines[2] = { this->first_, this->second_ };
+    std::vector<TraceRecord>* traces[2] = { &this->divergence_.first_trace, &this->divergence_.second_trace };
+
+    for (int i = 0; i < 2; i++) {
+        CPUEngine* engine = engines[i];
+        engine->Load(&this->checkpoint_, this->checkpoint_memory_.data());
+        ExecutionTrace trace(this->trace_length_, engine->memory());
+
+        // Running to one cycle past the current count always runs exactly one instruction
+        while (engine->cycles() < cycle) {
+            uint16_t pc = engine->state()->programCounter();
+            uint8_t op_code = engine->memory()[pc];
+            uint64_t before = engine->cycles();
+            engine->RunTo(before + 1);
+            trace.Record(pc, op_code, (uint8_t)(engine->cycles() - before), engine->state());
+        }
+
+        // Keeps the newest trace_length_ records
+        size_t keep = trace.size() < this->trace_length_ ? trace.size() : this->trace_length_;
+        for (size_t j = trace.size() - keep; j < trace.size(); j++) {
+            traces[i]->push_back(trace.at(j));
+        }
+    }
+}
+
+std::string DifferentialChecker::Describe() {
+    std::string text;
+    char line[128];
+    SM83State* first = this->first_->state();
+    SM83State* second = this->second_->state();
+
+    const char* names[6] = { "AF", "BC", "DE", "HL", "SP", "PC" };
+    uint16_t first_values[6] = { first->af(), first->bc(), first->de(), first->hl(), first->stackPointer(), first->programCounter() };
+    uint16_t second_values[6] = { second->af(), second->bc(), second->de(), second->hl(), second->stackPointer(), second->programCounter() };
+
+    for (int i = 0; i < 6; i++) {
+        if (first_values[i] != second_values[i]) {
+            snprintf(line, sizeof(line), "%s %04X != %04X\n", names[i], first_values[i], second_values[i]);
+            text += line;
+        }
+    }
+
+    if (this->first_->cycles() != this->second_->cycles()) {
+        snprintf(line, sizeof(line), "cycles %" PRIu64 " != %" PRIu64 "\n",
+            this->checkpoint_cycle_ + this->first_->cycles(), this->checkpoint_cycle_ + this->second_->cycles());
+        text += line;
+    }
+
+    const uint8_t* first_memory = this->first_->memory();
+    const uint8_t* second_memory = this->second_->memory();
+    int ranges = 0;
+    uint32_t address = 0;
+    while (address < MEMORY_SIZE) {
+        if (first_memory[address] == second_memory[address]) {
+            address++;
+            continue;
+        }
+
+        uint32_t end = address;
+        while (end < MEMORY_SIZE && first_memory[end] != second_memory[end]) {
+            end++;
+        }
+
+        if (ranges < MAX_REPORTED_RANGES) {
+            snprintf(line, sizeof(line), "memory %04X-%04X, first byte %02X != %02X\n",
+                address, end - 1, first_memory[address], second_memory[address]);
+            text += line;
+        }
+        ranges++;
+        address = end;
+    }
+
+    if (ranges > MAX_REPORTED_RANGES) {
+        snprintf(line, sizeof(line), "%d more differing memory ranges\n", ranges - MAX_REPORTED_RANGES);
+        text += line;
+    }
+    return text;
+}
+
+const Divergence& DifferentialChecker::divergence() {
+    return this->divergence_;
+}
+
+uint64_t DifferentialChecker::checks() {
+    return this->checks_;
+}
+
+void DifferentialChecker::WriteReport(FILE* file) {
+    const Divergence& divergence = this->divergence_;
+    fprintf(file, "%s and %s diverge at cycle %" PRIu64 " running %02X at %04X\n",
+        this->first_->name(), this->second_->name(), divergence.cycle, divergence.op_code, divergence.pc);
+    fprintf(file, "%s", divergence.differences.c_str());
+
+    const std::vector<TraceRecord>* traces[2] = { &divergence.first_trace, &divergence.second_trace };
+    const char* names[2] = { this->first_->name(), this->second_->name() };
+
+    for (int i = 0; i < 2; i++) {
+        fprintf(file, "\n%s, last %zu instructions:\n", names[i], traces[i]->size());
+
+        // The trace ends on the diverging instruction, which started at divergence.cycle
+        uint64_t cycle = divergence.cycle;
+        for (size_t j = 0; j + 1 < traces[i]->size(); j++) {
+            cycle -= (*traces[i])[j].cycles;
+        }
+        for (const TraceRecord& record : *traces[i]) {
+            WriteTraceRecord(file, record, cycle);
+            cycle += record.cycles;
+        }
+    }
+}
@@ -0,0 +1,130 @@
+/**
+ * @file differential_checker.hpp
+ * @brief Runs two CPU engines side by side and finds the first instruction where they disagree
+ *
+ */
+
+#ifndef DIFFERENTIAL_CHECKER_H
+#define DIFFERENTIAL_CHECKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "./cpu_engine.hpp"
+#include "./execution_trace.hpp"
+
+/**
+ * @brief Where two engines first disagreed
+ *
+ */
+struct Divergence {
+    // Cycle of the last instruction boundary where both engines agreed
+    uint64_t cycle;
+    // The instruction both engines ran from that boundary, giving different results
+    uint16_t pc;
+    uint8_t op_code;
+    // What differed, one line per register or memory range
+    std::string differences;
+    // The instructions each engine ran up to and including the diverging one, oldest first
+    std::vector<TraceRecord> first_trace;
+    std::vector<TraceRecord> second_trace;
+};
+
+/**
+ * @brief Checks that two engines agree by comparing hashes of their registers and memory.
+ *
+ * Both engines run in intervals of a fixed number of cycles and are hashed at the end of each. The
+ * state at the last matching hash is kept as a checkpoint. When the hashes differ, both engines are
+ * restarted from the checkpoint and run to the midpoint, halving the range until the first diverging
+ * instruction is found. They are then stepped one instruction at a time from the checkpoint to
+ * record a trace of each.
+ */
+class DifferentialChecker
+{
+
+private:
+
+    CPUEngine* first_;
+    CPUEngine* second_;
+    uint32_t interval_;
+    size_t trace_length_;
+
+    // State both engines agreed on, and the cycle it was reached
+    std::vector<uint8_t> checkpoint_memory_;
+    SM83State checkpoint_;
+    uint64_t checkpoint_cycle_;
+
+    Divergence divergence_;
+    uint64_t checks_;
+
+    /**
+     * @brief Hashes the registers, memory and cycle count of an engine
+     *
+     */
+    static uint64_t Hash(CPUEngine* engine);
+
+    /**
+     * @brief Restarts both engines from the checkpoint and runs them to a cycle after it
+     *
+     * @param cycle Cycles past the checkpoint
+     * @return true if the engines agree there
+     */
+    bool AgreeAt(uint64_t cycle);
+
+    /**
+     * @brief Records the instructions of both engines from the checkpoint up to a cycle after it
+     *
+     */
+    void RecordTraces(uint64_t cycle);
+
+    /**
+     * @brief Describes how the state of the two engines differs
+     *
+     */
+    std::string Describe();
+
+public:
+    /**
+     * @brief Constructs a new DifferentialChecker
+     *
+     * @param first The engine taken as the reference
+     * @param second The engine checked against it
+     * @param interval Cycles between hash comparisons
+     * @param trace_length Instructions of each engine kept for the report
+     */
+    DifferentialChecker(CPUEngine* first, CPUEngine* second, uint32_t interval, size_t trace_length);
+
+    /**
+     * @brief Runs both engines from the same state
+     *
+     * @param registers The starting registers
+     * @param memory The starting 64KB memory bus
+     * @param cycles The number of cycles to run
+     * @return true if the engines agreed throughout, false if divergence() describes where they did not
+     * @throws std::runtime_error if an engine reaches an op code that is not implemented
+     */
+    bool Run(SM83State* registers, const uint8_t* memory, uint64_t cycles);
+
+    /**
+     * @brief Gets the first divergence found by the last Run
+     *
+     */
+    const Divergence& divergence();
+
+    /**
+     * @brief Gets the number of hash comparisons made by the last Run
+     *
+     */
+    uint64_t checks();
+
+    /**
+     * @brief Prints the divergence along with the traces of both engines
+     *
+     * @param file The stream to print to
+     */
+    void WriteReport(FILE* file);
+};
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * @file disassembler.cpp
+ * @brief Implementation of the SM83 disassembler
+ *
+ */
+
+#include <cstdio>
+#include <cstring>
+#include "./disassembler.hpp"
+#include "./sm83_op_code_info.hpp"
+
+// Marks an empty cache entry, no bank and address pair has all of bits 24-31 set
+static const uint32_t EMPTY_LOCATION = 0xFFFFFFFF;
+
+/**
+ * @brief Appends formatted text, truncating at the end of the buffer
+ *
+ * @param out The end of the text so far
+ * @param end One past the last character of the buffer
+ * @return char* The new end of the text
+ */
+static char* Append(char* out, char* end, const char* format, int value) {
+    int written = snprintf(out, (size_t)(end - out), format, value);
+    if (written < 0) {
+        return out;
+    }
+    return written < end - out ? out + written : end - 1;
+}
+
+/**
+ * @brief Appends an address as its label, or as hex without one
+ *
+ */
+static char* AppendAddress(char* out, char* end, uint16_t address, const SymbolTable* symbols) {
+    const char* label = symbols != nullptr ? symbols->Find(SymbolTable::BankOf(address), address) : nullptr;
+    if (label == nullptr) {
+        return Append(out, end, "$%04X", address);
+    }
+
+    size_t length = strlen(label);
+    if (length > (size_t)(end - out - 1)) {
+        length = (size_t)(end - out - 1);
+    }
+    memcpy(out, label, length);
+    out[length] = '\0';
+    return out + length;
+}
+
+uint8_t DisassembleInstruction(const uint8_t* bytes, uint16_t address, const SymbolTable* symbols, char* text) {
+    const OpCodeInfo* info = &OpCodeInfoFor(bytes[0]);
+    const uint8_t* operands = bytes + 1;
+
+    if (bytes[0] == CB_PREFIX) {
+        info = &CBOpCodeInfoFor(bytes[1]);
+        operands = bytes + 2;
+    }
+
+    if (info->mnemonic == nullptr) {
+        snprintf(text, DISASSEMBLY_TEXT_SIZE, "DB $%02X", bytes[0]);
+        return 1;
+    }
+
+    char* out = text;
+    char* end = text + DISASSEMBLY_TEXT_SIZE;
+    const char* mnemonic = info->mnemonic;
+    uint16_t immediate = (uint16_t)(operands[0] | operands[1] << 8);
+
+    // Operand kinds are the only lower case text in a mnemonic
+    while (*mnemonic != '\0' && out < end - 1) {
+        if (strncmp(mnemonic, "d16", 3) == 0) {
+            out = Append(out, end, "$%04X", immediate);
+            mnemonic += 3;
+        } else if (strncmp(mnemonic, "a16", 3) == 0) {
+            out = AppendAddress(out, end, immediate, symbols);
+            mnemonic += 3;
+        } else if (strncmp(mnemonic, "d8", 2) == 0) {
+            out = Append(out, end, "$%02X", operands[0]);
+            mnemonic += 2;
+        } else if (strncmp(mnemonic, "a8", 2) == 0) {
+            out = AppendAddress(out, end, (uint16_t)(0xFF00 | operands[0]), symbols);
+            mnemonic += 2;
+        } else if (strncmp(mnemonic, "r8", 2) == 0) {
+            int offset = (int8_t)operands[0];
+            if (info->mnemonic[0] == 'J') {
+                out = AppendAddress(out, end, (uint16_t)(address + info->length + offset), symbols);
+            } else if (out > text && out[-1] == '+' && offset < 0) {
+                // SP+r8 reads better as SP-5 than SP+-5
+                out = Append(out - 1, end, "-%d", -offset);
+            } else {
+                out = Append(out, end, "%d", offset);
+            }
+            mnemonic += 2;
+        } else {
+            *out++ = *mnemonic++;
+        }
+    }
+    *out = '\0';
+
+    return info->length;
+}
+
+Disassembler::Disassembler(const uint8_t* memory_bus, const SymbolTable* symbols) : cache_(DISASSEMBLY_CACHE_SIZE) {
+    this->memory_ = memory_bus;
+    this->symbols_ = symbols;
+    this->hits_ = 0;
+    this->misses_ = 0;
+    this->Clear();
+}
+
+const DisassembledLine& Disassembler::Disassemble(uint16_t address, uint8_t bank) {
+    uint32_t location = (uint32_t)bank << 16 | address;
+    Entry& entry = this->cache_[(address ^ (uint32_t)bank << 7) & (DISASSEMBLY_CACHE_SIZE - 1)];
+    const uint8_t* memory = this->memory_;
+    DisassembledLine& line = entry.line;
+
+    if (entry.location == location) {
+        bool unchanged = true;
+        for (uint8_t i = 0; i < line.length; i++) {
+            unchanged = unchanged && line.bytes[i] == memory[(uint16_t)(address + i)];
+        }
+        if (unchanged) {
+            this->hits_++;
+            return line;
+        }
+    }
+
+    this->misses_++;
+    for (int i = 0; i < 3; i++) {
+        line.bytes[i] = memory[(uint16_t)(address + i)];
+    }
+    line.address = address;
+    line.bank = bank;
+    line.length = DisassembleInstruction(line.bytes, address, this->symbols_, line.text);
+    entry.location = location;
+    return line;
+}
+
+const DisassembledLine& Disassembler::Disassemble(uint16_t address) {
+    return this->Disassemble(address, SymbolTable::BankOf(address));
+}
+
+void Disassembler::SetSymbols(const SymbolTable* symbols) {
+    this->symbols_ = symbols;
+    this->Clear();
+}
+
+void Disassembler::Clear() {
+    for (Entry& entry : this->cache_) {
+        entry.location = EMPTY_LOCATION;
+    }
+}
+
+uint64_t Disassembler::hits() {
+    return this->hits_;
+}
+
+uint64_t Disassembler::misses() {
+    return this->misses_;
+}
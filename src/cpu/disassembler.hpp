@@ -0,0 +1,126 @@
+/**
+ * @file disassembler.hpp
+ * @brief SM83 disassembly driven by the op code tables, with a cache of decoded lines
+ *
+ */
+
+#ifndef DISASSEMBLER_H
+#define DISASSEMBLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "./symbol_table.hpp"
+
+// Room for the longest line, a CALL with a long label
+static const size_t DISASSEMBLY_TEXT_SIZE = 48;
+
+// Decoded lines kept by a Disassembler, a power of two
+static const size_t DISASSEMBLY_CACHE_SIZE = 16384;
+
+/**
+ * @brief One decoded instruction
+ *
+ */
+struct DisassembledLine {
+    uint16_t address;
+    uint8_t bank;
+    uint8_t length;
+    // The bytes the line was decoded from, only the first length are meaningful
+    uint8_t bytes[3];
+    char text[DISASSEMBLY_TEXT_SIZE];
+};
+
+/**
+ * @brief Decodes a single instruction from its bytes
+ *
+ * Immediate data is written as $-prefixed hex. Jump, call and load addresses, and the targets of
+ * relative jumps, are replaced by their labels when symbols are given. Undefined op codes decode as
+ * a one byte DB.
+ *
+ * @param bytes The op code followed by at least two more bytes
+ * @param address The address of the op code, for relative jump targets
+ * @param symbols Labels to use for addresses, or nullptr
+ * @param text Receives the instruction, at least DISASSEMBLY_TEXT_SIZE characters
+ * @return uint8_t The length of the instruction in bytes
+ */
+uint8_t DisassembleInstruction(const uint8_t* bytes, uint16_t address, const SymbolTable* symbols, char* text);
+
+/**
+ * @brief Disassembles code on the memory bus, keeping decoded lines keyed by bank and address.
+ *
+ * The cache is direct mapped. Each entry keeps the bytes it was decoded from and a hit compares them
+ * with memory first, so any write to an instruction's bytes invalidates its line without the
+ * disassembler having to observe writes, and code in RAM is decoded afresh only when it changes.
+ */
+class Disassembler
+{
+
+private:
+
+    struct Entry {
+        // Bank in bits 16-23, address in bits 0-15, or 0xFFFFFFFF when empty
+        uint32_t location;
+        DisassembledLine line;
+    };
+
+    const uint8_t* memory_;
+    const SymbolTable* symbols_;
+
+    std::vector<Entry> cache_;
+    uint64_t hits_;
+    uint64_t misses_;
+
+public:
+    /**
+     * @brief Constructs a new Disassembler
+     *
+     * @param memory_bus The 65,536 byte memory bus
+     * @param symbols Labels to use for addresses, or nullptr
+     */
+    Disassembler(const uint8_t* memory_bus, const SymbolTable* symbols = nullptr);
+
+    /**
+     * @brief Disassembles the instruction at an address
+     *
+     * @param address The address of the op code
+     * @param bank The bank the address is mapped from
+     * @return const DisassembledLine& The line, valid until the next call
+     */
+    const DisassembledLine& Disassemble(uint16_t address, uint8_t bank);
+
+    /**
+     * @brief Disassembles the instruction at an address, in the bank SymbolTable::BankOf maps it to
+     *
+     * @param address The address of the op code
+     * @return const DisassembledLine& The line, valid until the next call
+     */
+    const DisassembledLine& Disassemble(uint16_t address);
+
+    /**
+     * @brief Changes the labels used and forgets every decoded line
+     *
+     * @param symbols Labels to use for addresses, or nullptr
+     */
+    void SetSymbols(const SymbolTable* symbols);
+
+    /**
+     * @brief Forgets every decoded line
+     *
+     */
+    void Clear();
+
+    /**
+     * @brief Gets the number of lookups answered from the cache
+     *
+     */
+    uint64_t hits();
+
+    /**
+     * @brief Gets the number of lookups that had to decode
+     *
+     */
+    uint64_t misses();
+};
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file execution_trace.cpp
+ * @brief Implementation of the execution trace ring
+ *
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "./disassembler.hpp"
+#include "./execution_trace.hpp"
+
+static_assert(sizeof(TraceRecord) == 16, "Trace records are saved as 16 bytes");
+
+ExecutionTrace::ExecutionTrace(size_t capacity, const uint8_t* memory_bus_ptr) {
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    this->memory_bus_ = memory_bus_ptr;
+    this->records_ = new TraceRecord[size]();
+    this->mask_ = size - 1;
+    this->Clear();
+}
+
+ExecutionTrace::~ExecutionTrace() {
+    delete[] this->records_;
+}
+
+void ExecutionTrace::Clear() {
+    this->head_ = 0;
+    this->cycles_ = 0;
+}
+
+size_t ExecutionTrace::size() {
+    return this->head_ < this->capacity() ? (size_t)this->head_ : this->capacity();
+}
+
+size_t ExecutionTrace::capacity() {
+    return this->mask_ + 1;
+}
+
+const TraceRecord& ExecutionTrace::at(size_t index) {
+    uint64_t oldest = this->head_ - this->size();
+    return this->records_[(oldest + index) & this->mask_];
+}
+
+bool ExecutionTrace::Save(const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    TraceFileHeader header;
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.record_size = sizeof(TraceRecord);
+    header.record_count = (uint32_t)this->size();
+    header.first_cycle = this->cycles_;
+    for (size_t i = 0; i < this->size(); i++) {
+        header.first_cycle -= this->at(i).cycles;
+    }
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    // The ring is written in at most two runs, the older part after the head then the part before it
+    size_t start = (size_t)((this->head_ - this->size()) & this->mask_);
+    size_t first_run = this->size() < this->capacity() - start ? this->size() : this->capacity() - start;
+    written = written && fwrite(this->records_ + start, sizeof(TraceRecord), first_run, file) == first_run;
+    written = written && fwrite(this->records_, sizeof(TraceRecord), this->size() - first_run, file) == this->size() - first_run;
+
+    return fclose(file) == 0 && written;
+}
+
+bool LoadTrace(const char* path, TraceFileHeader* header, std::vector<TraceRecord>* records) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    bool loaded = fread(header, sizeof(TraceFileHeader), 1, file) == 1
+        && memcmp(header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) == 0
+        && header->record_size == sizeof(TraceRecord);
+
+    // The count comes from the file, so a corrupt one must not size the allocation
+    if (loaded) {
+        long start = ftell(file);
+        loaded = fseek(file, 0, SEEK_END) == 0;
+        long end = ftell(file);
+        loaded = loaded && start >= 0 && end >= start && fseek(file, start, SEEK_SET) == 0
+            && header->record_count <= (uint64_t)(end - start) / sizeof(TraceRecord);
+    }
+
+    if (loaded) {
+        records->resize(header->record_count);
+        loaded = fread(records->data(), sizeof(TraceRecord), records->size(), file) == records->size();
+    }
+
+    fclose(file);
+    return loaded;
+}
+
+void WriteTraceRecord(FILE* file, const TraceRecord& record, uint64_t cycle, const SymbolTable* symbols) {
+    uint8_t bytes[3] = {record.op_code, record.operands[0], record.operands[1]};
+    char instruction[DISASSEMBLY_TEXT_SIZE];
+    DisassembleInstruction(bytes, record.pc, symbols, instruction);
+
+    fprintf(file, "%-12" PRIu64 " %04X %02X %02X %02X %3u  %02X %02X %02X %02X %02X %02X %02X %02X %04X %c%c%c%c  %s\n",
+        cycle, record.pc, record.op_code, record.operands[0], record.operands[1], record.cycles,
+        record.a, record.f, record.b, record.c, record.d, record.e, record.h, record.l, record.sp,
+        (record.f & 0x80) > 0 ? 'Z' : '-', (record.f & 0x40) > 0 ? 'N' : '-',
+        (record.f & 0x20) > 0 ? 'H' : '-', (record.f & 0x10) > 0 ? 'C' : '-', instruction);
+}
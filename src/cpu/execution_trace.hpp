@@ -0,0 +1,173 @@
+/**
+ * @file execution_trace.hpp
+ * @brief Fixed size ring of compact binary instruction records, saved to disk for offline decoding
+ *
+ */
+
+#ifndef EXECUTION_TRACE_H
+#define EXECUTION_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "./sm83_state.hpp"
+#include "./symbol_table.hpp"
+
+// Identifies a saved trace, followed by the version in the header
+static const char TRACE_MAGIC[8] = { 'L', 'B', 'T', 'R', 'A', 'C', 'E', '1' };
+
+/**
+ * @brief One executed instruction. The registers are those after the instruction ran
+ *
+ */
+struct TraceRecord {
+    uint16_t pc;
+    uint16_t sp;
+    uint8_t op_code;
+    // The two bytes following the op code, for decoding operands
+    uint8_t operands[2];
+    uint8_t cycles;
+    uint8_t a;
+    uint8_t f;
+    uint8_t b;
+    uint8_t c;
+    uint8_t d;
+    uint8_t e;
+    uint8_t h;
+    uint8_t l;
+};
+
+/**
+ * @brief Header at the start of a saved trace, followed by record_count records oldest first
+ *
+ */
+struct TraceFileHeader {
+    char magic[8];
+    uint32_t record_size;
+    uint32_t record_count;
+    // Cycles run before the oldest record, so records can be given absolute cycle counts
+    uint64_t first_cycle;
+};
+
+/**
+ * @brief Keeps the most recent instructions executed by an SM83Emulator.
+ *
+ * Attach one with SM83Emulator::SetTrace to start tracing and detach it with nullptr to stop.
+ * Recording copies 16 bytes into a power of two sized ring and never allocates, so tracing costs a
+ * few nanoseconds an instruction rather than the cost of formatting text. lameboy-trace turns a saved
+ * trace back into text.
+ */
+class ExecutionTrace
+{
+
+private:
+
+    const uint8_t* memory_bus_;
+
+    TraceRecord* records_;
+    size_t mask_;
+
+    // Records written since construction or Clear, the next goes at head_ & mask_
+    uint64_t head_;
+
+    // Cycles of every record written
+    uint64_t cycles_;
+
+public:
+    /**
+     * @brief Constructs a new ExecutionTrace
+     *
+     * @param capacity Records kept, rounded up to a power of two
+     * @param memory_bus_ptr Pointer to the memory bus, read for operand bytes
+     */
+    ExecutionTrace(size_t capacity, const uint8_t* memory_bus_ptr);
+
+    ~ExecutionTrace();
+
+    /**
+     * @brief Appends an instruction, overwriting the oldest once the ring is full
+     *
+     * @param pc The address the instruction was fetched from
+     * @param op_code The op code
+     * @param cycles The cycles it took
+     * @param state The CPU state after the instruction
+     */
+    inline void Record(uint16_t pc, uint8_t op_code, uint8_t cycles, SM83State* state) {
+        TraceRecord& record = this->records_[this->head_ & this->mask_];
+        record.pc = pc;
+        record.sp = state->stackPointer();
+        record.op_code = op_code;
+        record.operands[0] = this->memory_bus_[(uint16_t)(pc + 1)];
+        record.operands[1] = this->memory_bus_[(uint16_t)(pc + 2)];
+        record.cycles = cycles;
+        record.a = state->a();
+        record.f = state->f();
+        record.b = state->b();
+        record.c = state->c();
+        record.d = state->d();
+        record.e = state->e();
+        record.h = state->h();
+        record.l = state->l();
+        this->head_++;
+        this->cycles_ += cycles;
+    }
+
+    /**
+     * @brief Discards every record
+     *
+     */
+    void Clear();
+
+    /**
+     * @brief Gets the number of records held, at most the capacity
+     *
+     */
+    size_t size();
+
+    /**
+     * @brief Gets the number of records the ring holds
+     *
+     */
+    size_t capacity();
+
+    /**
+     * @brief Gets a record held in the ring
+     *
+     * @param index 0 for the oldest record, up to size() - 1 for the newest
+     * @return const TraceRecord& The record
+     */
+    const TraceRecord& at(size_t index);
+
+    /**
+     * @brief Writes the records oldest first after a TraceFileHeader
+     *
+     * @param path The file to write
+     * @return true if the file was written
+     */
+    bool Save(const char* path);
+};
+
+/**
+ * @brief Reads a trace written by ExecutionTrace::Save
+ *
+ * @param path The file to read
+ * @param header Receives the header
+ * @param records Receives the records, oldest first
+ * @return true if the file was a complete trace, false if it was not a trace or holds fewer records than its
+ * header counts
+ */
+bool LoadTrace(const char* path, TraceFileHeader* header, std::vector<TraceRecord>* records);
+
+/**
+ * @brief Prints a trace record as one line of text, the format lameboy-trace uses, ending with the
+ * disassembled instruction
+ *
+ * @param file The stream to print to
+ * @param record The record
+ * @param cycle The cycle the instruction started on
+ * @param symbols Labels for the disassembly, or nullptr
+ */
+void WriteTraceRecord(FILE* file, const TraceRecord& record, uint64_t cycle, const SymbolTable* symbols = nullptr);
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * @file guest_profiler.cpp
+ * @brief Implementation of the guest code sampling profiler
+ *
+ */
+
+#include <cinttypes>
+#include "./guest_profiler.hpp"
+
+/**
+ * @brief Gets whether an op code is CALL, a conditional CALL or RST, which push a return address
+ *
+ */
+static bool IsCall(uint8_t op_code) {
+    switch (op_code) {
+        case 0xC4: case 0xCC: case 0xCD: case 0xD4: case 0xDC:
+        case 0xC7: case 0xCF: case 0xD7: case 0xDF: case 0xE7: case 0xEF: case 0xF7: case 0xFF:
+            return true;
+        default:
+            return false;
+    }
+}
+
+GuestProfiler::GuestProfiler(uint32_t period) {
+    this->period_ = period > 0 ? period : 1;
+    this->Clear();
+}
+
+void GuestProfiler::Clear() {
+    this->countdown_ = this->period_;
+    this->stack_.clear();
+    this->stacks_.clear();
+    this->samples_ = 0;
+}
+
+void GuestProfiler::OnInstruction(uint16_t pc, uint8_t op_code, uint8_t cycles, SM83State* state) {
+    uint16_t sp = state->stackPointer();
+
+    // A frame is live while its return address is at or above SP
+    while (!this->stack_.empty() && sp > this->stack_.back().return_slot) {
+        this->stack_.pop_back();
+    }
+
+    // Conditional calls only push when taken, which shows as the new PC not following the instruction.
+    // RST is a single byte, the calls are three
+    uint16_t next = (uint16_t)(pc + ((op_code & 0x07) == 0x07 ? 1 : 3));
+    if (IsCall(op_code) && state->programCounter() != next) {
+        if (this->stack_.size() < MAX_PROFILER_DEPTH) {
+            Frame frame;
+            frame.entry = CodeLocation(state->programCounter());
+            frame.return_slot = sp;
+            this->stack_.push_back(frame);
+        }
+    }
+
+    // An instruction longer than the period covers several samples
+    this->countdown_ -= cycles;
+    if (this->countdown_ <= 0) {
+        uint64_t count = 1 + (uint64_t)(-this->countdown_) / this->period_;
+        this->countdown_ += (int64_t)(count * this->period_);
+        this->Sample(state->programCounter(), count);
+    }
+}
+
+void GuestProfiler::Sample(uint16_t pc, uint64_t count) {
+    this->key_.clear();
+    for (const Frame& frame : this->stack_) {
+        this->key_.push_back(frame.entry);
+    }
+    this->key_.push_back(CodeLocation(pc));
+
+    this->stacks_[this->key_] += count;
+    this->samples_ += count;
+}
+
+void GuestProfiler::WriteFolded(FILE* file, const SymbolTable* symbols) {
+    for (const auto& entry : this->stacks_) {
+        const std::vector<uint32_t>& frames = entry.first;
+        for (size_t i = 0; i < frames.size(); i++) {
+            const char* label = symbols != nullptr ? symbols->Find((uint8_t)(frames[i] >> 16), (uint16_t)frames[i]) : nullptr;
+            if (label != nullptr) {
+                fprintf(file, "%s%s", i > 0 ? ";" : "", label);
+            } else {
+                fprintf(file, "%s%02X:%04X", i > 0 ? ";" : "", frames[i] >> 16, frames[i] & 0xFFFF);
+            }
+        }
+        fprintf(file, " %" PRIu64 "\n", entry.second);
+    }
+}
+
+uint64_t GuestProfiler::samples() {
+    return this->samples_;
+}
+
+size_t GuestProfiler::depth() {
+    return this->stack_.size();
+}
+
+uint32_t GuestProfiler::CodeLocation(uint16_t address) {
+    return (uint32_t)SymbolTable::BankOf(address) << 16 | address;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file guest_profiler.hpp
+ * @brief Sampling profiler for guest code, writing folded stacks for flamegraph.pl
+ *
+ */
+
+#ifndef GUEST_PROFILER_H
+#define GUEST_PROFILER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <vector>
+#include "./instruction_observer.hpp"
+#include "./symbol_table.hpp"
+
+// Calls deeper than this are not tracked, their samples are attributed to the deepest tracked frame
+static const uint8_t MAX_PROFILER_DEPTH = 64;
+
+/**
+ * @brief Samples the guest PC every fixed number of cycles along with the call stack leading to it.
+ *
+ * The call stack is rebuilt by watching CALL, conditional CALL and RST as they execute. A frame is
+ * dropped once the stack pointer moves above the slot holding its return address, which covers RET,
+ * RETI and code that pops return addresses or reloads SP itself.
+ *
+ * Frames are written as BB:AAAA, the ROM bank and address of a function entry, with the sampled PC
+ * as the leaf. Without a memory bank controller 0000-3FFF is bank 00 and 4000-7FFF bank 01; RAM
+ * addresses are given bank 00.
+ *
+ * The profiler only reads the CPU state, so attaching it does not change emulated timing.
+ */
+class GuestProfiler : public InstructionObserver
+{
+
+private:
+
+    struct Frame {
+        // Bank and address of the function entry
+        uint32_t entry;
+        // Address of the return address on the stack
+        uint16_t return_slot;
+    };
+
+    uint32_t period_;
+
+    // Cycles left until the next sample
+    int64_t countdown_;
+
+    std::vector<Frame> stack_;
+
+    // Sample counts of each distinct stack, root first and the sampled PC last
+    std::map<std::vector<uint32_t>, uint64_t> stacks_;
+    std::vector<uint32_t> key_;
+
+    uint64_t samples_;
+
+    /**
+     * @brief Records the current call stack and PC
+     *
+     * @param pc The PC at the sample
+     * @param count The number of samples falling on this instruction
+     */
+    void Sample(uint16_t pc, uint64_t count);
+
+public:
+    /**
+     * @brief Constructs a new GuestProfiler
+     *
+     * @param period Cycles between samples
+     */
+    GuestProfiler(uint32_t period);
+
+    /**
+     * @brief Follows calls and returns and takes a sample whenever the period has elapsed
+     *
+     */
+    void OnInstruction(uint16_t pc, uint8_t op_code, uint8_t cycles, SM83State* state) override;
+
+    /**
+     * @brief Discards every sample and the tracked call stack
+     *
+     */
+    void Clear();
+
+    /**
+     * @brief Writes one line per distinct stack, frames separated by semicolons followed by the sample count
+     *
+     * @param file The stream to write to
+     * @param symbols Labels to name frames by where they have one, or nullptr
+     */
+    void WriteFolded(FILE* file, const SymbolTable* symbols = nullptr);
+
+    /**
+     * @brief Gets the number of samples taken
+     *
+     */
+    uint64_t samples();
+
+    /**
+     * @brief Gets the number of calls currently tracked
+     *
+     */
+    size_t depth();
+
+    /**
+     * @brief Gets the bank and address identifying a code location
+     *
+     * @param address The address
+     * @return uint32_t The bank in bits 16-23 and the address in bits 0-15
+     */
+    static uint32_t CodeLocation(uint16_t address);
+};
+
+#endif
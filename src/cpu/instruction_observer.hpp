@@ -0,0 +1,34 @@
+/**
+ * @file instruction_observer.hpp
+ * @brief Interface for tools that follow the CPU one instruction at a time
+ *
+ */
+
+#ifndef INSTRUCTION_OBSERVER_H
+#define INSTRUCTION_OBSERVER_H
+
+#include <cstdint>
+#include "./sm83_state.hpp"
+
+/**
+ * @brief Receives every instruction SM83Emulator executes. Observers must only read the state, so
+ * attaching one never changes how the guest runs
+ *
+ */
+class InstructionObserver
+{
+public:
+    virtual ~InstructionObserver() = default;
+
+    /**
+     * @brief Called after an instruction has executed
+     *
+     * @param pc The address the instruction was fetched from
+     * @param op_code The op code
+     * @param cycles The cycles it took
+     * @param state The CPU state after the instruction
+     */
+    virtual void OnInstruction(uint16_t pc, uint8_t op_code, uint8_t cycles, SM83State* state) = 0;
+};
+
+#endif
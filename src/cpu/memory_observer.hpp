@@ -0,0 +1,58 @@
+/**
+ * @file memory_observer.hpp
+ * @brief Interface for components that react to CPU accesses on the memory bus
+ *
+ */
+
+#ifndef MEMORY_OBSERVER_H
+#define MEMORY_OBSERVER_H
+
+#include <cstdint>
+
+// Kinds of access an observer can watch a page for
+static const uint8_t WATCH_WRITES = 0b00000001;
+static const uint8_t WATCH_READS = 0b00000010;
+
+/**
+ * @brief Receives CPU accesses to the pages of the memory bus it was registered for
+ *
+ */
+class MemoryObserver
+{
+public:
+    virtual ~MemoryObserver() = default;
+
+    /**
+     * @brief Called after the CPU has written to a watched page
+     *
+     * @param address The 16bit address written to
+     * @param value The value now stored at the address
+     */
+    virtual void OnMemoryWrite(uint16_t address, uint8_t value) = 0;
+
+    /**
+     * @brief Called after a block copy has written to a watched page. Defaults to one OnMemoryWrite per byte
+     *
+     * @param address The first address written to
+     * @param data The bytes now stored from address onwards
+     * @param length The number of bytes written
+     */
+    virtual void OnMemoryBlockWrite(uint16_t address, const uint8_t* data, uint16_t length) {
+        for (uint16_t i = 0; i < length; i++) {
+            this->OnMemoryWrite((uint16_t)(address + i), data[i]);
+        }
+    }
+
+    /**
+     * @brief Called before the CPU reads from a page watched for reads
+     *
+     * @param address The 16bit address being read
+     * @param value Receives the value to return instead of memory, if overridden
+     * @return true if the observer supplied the value
+     */
+    virtual bool OnMemoryRead(uint16_t address, uint8_t* value) {
+        return false;
+    }
+};
+
+#endif
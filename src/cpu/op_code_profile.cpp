@@ -0,0 +1,113 @@
+/**
+ * @file op_code_profile.cpp
+ * @brief Implementation of op code profiling reports
+ *
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <vector>
+#include "./op_code_profile.hpp"
+
+OpCodeProfile::OpCodeProfile() {
+    this->Clear();
+}
+
+void OpCodeProfile::Clear() {
+    memset(this->executions_, 0, sizeof(this->executions_));
+    memset(this->cycles_, 0, sizeof(this->cycles_));
+    memset(this->histogram_, 0, sizeof(this->histogram_));
+}
+
+void OpCodeProfile::Merge(const OpCodeProfile& other) {
+    for (uint16_t slot = 0; slot < OP_CODE_PROFILE_SLOTS; slot++) {
+        this->executions_[slot] += other.executions_[slot];
+        this->cycles_[slot] += other.cycles_[slot];
+        for (uint8_t bucket = 0; bucket < CYCLE_BUCKETS; bucket++) {
+            this->histogram_[slot][bucket] += other.histogram_[slot][bucket];
+        }
+    }
+}
+
+uint64_t OpCodeProfile::executions(uint16_t slot) {
+    return this->executions_[slot];
+}
+
+uint64_t OpCodeProfile::cycles(uint16_t slot) {
+    return this->cycles_[slot];
+}
+
+uint64_t OpCodeProfile::histogram(uint16_t slot, uint8_t bucket) {
+    return this->histogram_[slot][bucket];
+}
+
+uint64_t OpCodeProfile::totalExecutions() {
+    uint64_t total = 0;
+    for (uint16_t slot = 0; slot < OP_CODE_PROFILE_SLOTS; slot++) {
+        total += this->executions_[slot];
+    }
+    return total;
+}
+
+uint64_t OpCodeProfile::totalCycles() {
+    uint64_t total = 0;
+    for (uint16_t slot = 0; slot < OP_CODE_PROFILE_SLOTS; slot++) {
+        total += this->cycles_[slot];
+    }
+    return total;
+}
+
+size_t OpCodeProfile::Top(size_t count, uint16_t* slots) {
+    std::vector<uint16_t> ran;
+    for (uint16_t slot = 0; slot < OP_CODE_PROFILE_SLOTS; slot++) {
+        if (this->executions_[slot] > 0) {
+            ran.push_back(slot);
+        }
+    }
+
+    std::stable_sort(ran.begin(), ran.end(), [this](uint16_t a, uint16_t b) {
+        if (this->cycles_[a] != this->cycles_[b]) {
+            return this->cycles_[a] > this->cycles_[b];
+        }
+        return this->executions_[a] > this->executions_[b];
+    });
+
+    size_t written = std::min(count, ran.size());
+    std::copy(ran.begin(), ran.begin() + written, slots);
+    return written;
+}
+
+void OpCodeProfile::WriteReport(FILE* file, size_t count) {
+    std::vector<uint16_t> slots(count);
+    size_t written = this->Top(count, slots.data());
+    uint64_t total_executions = this->totalExecutions();
+    uint64_t total_cycles = this->totalCycles();
+
+    fprintf(file, "%" PRIu64 " instructions, %" PRIu64 " cycles\n", total_executions, total_cycles);
+    fprintf(file, "%-6s %14s %7s %14s %7s %7s  %s\n", "op", "executions", "%", "cycles", "%", "cum %", "cycles:count");
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < written; i++) {
+        uint16_t slot = slots[i];
+        cumulative += this->cycles_[slot];
+
+        char name[8];
+        if (slot >= CB_PROFILE_SLOT) {
+            snprintf(name, sizeof(name), "CB %02X", slot - CB_PROFILE_SLOT);
+        } else {
+            snprintf(name, sizeof(name), "%02X", slot);
+        }
+
+        fprintf(file, "%-6s %14" PRIu64 " %6.2f%% %14" PRIu64 " %6.2f%% %6.2f%% ", name,
+            this->executions_[slot], 100.0 * this->executions_[slot] / total_executions,
+            this->cycles_[slot], 100.0 * this->cycles_[slot] / total_cycles, 100.0 * cumulative / total_cycles);
+
+        for (uint8_t bucket = 0; bucket < CYCLE_BUCKETS; bucket++) {
+            if (this->histogram_[slot][bucket] > 0) {
+                fprintf(file, " %u:%" PRIu64, bucket * 4, this->histogram_[slot][bucket]);
+            }
+        }
+        fprintf(file, "\n");
+    }
+}
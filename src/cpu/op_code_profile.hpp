@@ -0,0 +1,118 @@
+/**
+ * @file op_code_profile.hpp
+ * @brief Per op code execution counts and cycle histograms, recorded by the dispatcher when the
+ * build enables LAMEBOY_OPCODE_PROFILE
+ *
+ */
+
+#ifndef OP_CODE_PROFILE_H
+#define OP_CODE_PROFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Primary op codes take slots 0x000-0x0FF, CB prefixed op codes 0x100-0x1FF
+static const uint16_t OP_CODE_PROFILE_SLOTS = 0x200;
+static const uint16_t CB_PROFILE_SLOT = 0x100;
+
+// Instructions take 4 to 24 cycles in steps of 4, bucket n counts those taking 4n cycles
+static const uint8_t CYCLE_BUCKETS = 8;
+
+/**
+ * @brief Counts how often each op code runs and how many cycles it takes.
+ *
+ * Conditional jumps, calls and returns show up in the histogram as one bucket for the branch taken
+ * and one for not taken. Reports rank op codes by cumulative cycles, which is where time goes.
+ */
+class OpCodeProfile
+{
+
+private:
+
+    uint64_t executions_[OP_CODE_PROFILE_SLOTS];
+    uint64_t cycles_[OP_CODE_PROFILE_SLOTS];
+    uint64_t histogram_[OP_CODE_PROFILE_SLOTS][CYCLE_BUCKETS];
+
+public:
+    /**
+     * @brief Constructs a new OpCodeProfile with every count at zero
+     *
+     */
+    OpCodeProfile();
+
+    /**
+     * @brief Sets every count back to zero
+     *
+     */
+    void Clear();
+
+    /**
+     * @brief Records one execution of an op code
+     *
+     * @param slot The op code, plus CB_PROFILE_SLOT for CB prefixed op codes
+     * @param cycles The cycles it took
+     */
+    inline void Record(uint16_t slot, uint8_t cycles) {
+        uint8_t bucket = cycles / 4;
+        this->executions_[slot]++;
+        this->cycles_[slot] += cycles;
+        this->histogram_[slot][bucket < CYCLE_BUCKETS ? bucket : CYCLE_BUCKETS - 1]++;
+    }
+
+    /**
+     * @brief Adds the counts of another profile to this one, such as from another machine
+     *
+     * @param other The profile to add
+     */
+    void Merge(const OpCodeProfile& other);
+
+    /**
+     * @brief Gets the number of times an op code ran
+     *
+     */
+    uint64_t executions(uint16_t slot);
+
+    /**
+     * @brief Gets the total cycles spent in an op code
+     *
+     */
+    uint64_t cycles(uint16_t slot);
+
+    /**
+     * @brief Gets the number of executions of an op code that took 4 x bucket cycles
+     *
+     */
+    uint64_t histogram(uint16_t slot, uint8_t bucket);
+
+    /**
+     * @brief Gets the number of instructions recorded
+     *
+     */
+    uint64_t totalExecutions();
+
+    /**
+     * @brief Gets the number of cycles recorded
+     *
+     */
+    uint64_t totalCycles();
+
+    /**
+     * @brief Ranks the op codes that ran by cumulative cycles, ties broken by executions
+     *
+     * @param count The most slots to return
+     * @param slots Receives up to count slots, most expensive first
+     * @return size_t The number of slots written
+     */
+    size_t Top(size_t count, uint16_t* slots);
+
+    /**
+     * @brief Prints the top op codes with their share of executions and cycles and their histograms
+     *
+     * @param file The stream to print to
+     * @param count The number of op codes to list
+     */
+    void WriteReport(FILE* file, size_t count);
+};
+
+#endif
@@ -0,0 +1,126 @@
+/**
+ * @file sm83_emulator.cpp
+ * @brief Implementation of the SM83 fetch and dispatch loop
+ *
+ */
+
+#include <cstdio>
+#include <stdexcept>
+#include "./sm83_emulator.hpp"
+#include "./sm83_op_code_info.hpp"
+#include "./sm83_op_codes.hpp"
+
+// Primary op codes indexed by value, nullptr where there is no implementation yet
+static constexpr OpCodeHandler OP_CODE_TABLE[256] = {
+    /* 00 */ Execute00, Execute01, Execute02, Execute03, Execute04, Execute05, Execute06, Execute07, Execute08, Execute09, Execute0A, Execute0B, Execute0C, Execute0D, Execute0E, Execute0F,
+    /* 10 */ nullptr, Execute11, Execute12, Execute13, Execute14, Execute15, Execute16, Execute17, Execute18, Execute19, Execute1A, Execute1B, Execute1C, Execute1D, Execute1E, Execute1F,
+    /* 20 */ Execute20, Execute21, Execute22, Execute23, Execute24, Execute25, Execute26, Execute27, Execute28, Execute29, Execute2A, Execute2B, Execute2C, Execute2D, Execute2E, Execute2F,
+    /* 30 */ Execute30, Execute31, Execute32, Execute33, Execute34, Execute35, Execute36, Execute37, Execute38, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+    /* 40 */ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+    /* 50 */ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+    /* 60 */ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+    /* 70 */ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+    /* 80 */ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+    /* 90 */ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+    /* A0 */ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+    /* B0 */ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+    /* C0 */ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, ExecuteC9, nullptr, nullptr, nullptr, ExecuteCD, nullptr, nullptr,
+    /* D0 */ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+    /* E0 */ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+    /* F0 */ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr
+};
+
+/**
+ * @brief Gets whether every op code with a handler is one OP_CODE_INFO defines
+ *
+ */
+static constexpr bool HandlersAreDefined() {
+    for (int op_code = 0; op_code < 256; op_code++) {
+        if (OP_CODE_TABLE[op_code] != nullptr && OP_CODE_INFO[op_code].mnemonic == nullptr) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(HandlersAreDefined(), "An op code has a handler but OP_CODE_INFO leaves it undefined");
+
+OpCodeHandler OpCodeHandlerFor(uint8_t op_code) {
+    return OP_CODE_TABLE[op_code];
+}
+
+SM83Emulator::SM83Emulator(SM83State* state) {
+    this->state_ = state;
+    this->instructions_ = 0;
+    this->observer_count_ = 0;
+    this->trace_ = nullptr;
+}
+
+uint8_t SM83Emulator::Step() {
+    uint16_t pc = this->state_->programCounter();
+    uint8_t op_code = this->state_->MemoryAt(pc);
+    OpCodeHandler handler = OP_CODE_TABLE[op_code];
+
+    if (handler == nullptr) {
+        char message[64];
+        snprintf(message, sizeof(message), "Unimplemented op code 0x%02X at 0x%04X", op_code, pc);
+        throw std::runtime_error(message);
+    }
+
+    this->instructions_++;
+    uint8_t cycles = handler(this->state_);
+
+#ifdef LAMEBOY_OPCODE_PROFILE
+    this->profile_.Record(op_code, cycles);
+#endif
+
+    if (this->trace_ != nullptr) {
+        this->trace_->Record(pc, op_code, cycles, this->state_);
+    }
+
+    for (uint8_t i = 0; i < this->observer_count_; i++) {
+        this->observers_[i]->OnInstruction(pc, op_code, cycles, this->state_);
+    }
+    return cycles;
+}
+
+uint64_t SM83Emulator::instructions() {
+    return this->instructions_;
+}
+
+OpCodeProfile* SM83Emulator::profile() {
+#ifdef LAMEBOY_OPCODE_PROFILE
+    return &this->profile_;
+#else
+    return nullptr;
+#endif
+}
+
+bool SM83Emulator::AddInstructionObserver(InstructionObserver* observer) {
+    if (this->observer_count_ == MAX_INSTRUCTION_OBSERVERS) {
+        return false;
+    }
+    this->observers_[this->observer_count_++] = observer;
+    return true;
+}
+
+void SM83Emulator::RemoveInstructionObserver(InstructionObserver* observer) {
+    for (uint8_t i = 0; i < this->observer_count_; i++) {
+        if (this->observers_[i] == observer) {
+            // Keeps the remaining observers in the order they were added
+            for (uint8_t j = i + 1; j < this->observer_count_; j++) {
+                this->observers_[j - 1] = this->observers_[j];
+            }
+            this->observer_count_--;
+            return;
+        }
+    }
+}
+
+void SM83Emulator::SetTrace(ExecutionTrace* trace) {
+    this->trace_ = trace;
+}
+
+ExecutionTrace* SM83Emulator::trace() {
+    return this->trace_;
+}
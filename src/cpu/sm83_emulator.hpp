@@ -9,4 +9,114 @@
  *
  */
 
+#ifndef SM83_EMULATOR_H
+#define SM83_EMULATOR_H
 
+#include <cstdint>
+#include "./execution_trace.hpp"
+#include "./instruction_observer.hpp"
+#include "./op_code_profile.hpp"
+#include "./sm83_state.hpp"
+
+/**
+ * @brief Signature shared by every op code implementation
+ *
+ */
+typedef uint8_t (*OpCodeHandler)(SM83State* state);
+
+// Instruction observers that can be attached to one emulator at a time
+static const uint8_t MAX_INSTRUCTION_OBSERVERS = 4;
+
+/**
+ * @brief Gets the implementation of a primary op code
+ *
+ * @param op_code The op code
+ * @return OpCodeHandler The handler, or nullptr if the op code is not implemented yet
+ */
+OpCodeHandler OpCodeHandlerFor(uint8_t op_code);
+
+/**
+ * @brief Fetches and executes instructions on an SM83State
+ *
+ */
+class SM83Emulator
+{
+
+private:
+
+    SM83State* state_;
+
+    // Instructions executed since construction
+    uint64_t instructions_;
+
+#ifdef LAMEBOY_OPCODE_PROFILE
+    OpCodeProfile profile_;
+#endif
+
+    // Receives every instruction while set
+    ExecutionTrace* trace_;
+
+    // Attached observers, packed at the front so Step only checks the count when there are none
+    InstructionObserver* observers_[MAX_INSTRUCTION_OBSERVERS];
+    uint8_t observer_count_;
+
+public:
+    /**
+     * @brief Constructs a new SM83Emulator
+     *
+     * @param state The CPU state to execute on
+     */
+    SM83Emulator(SM83State* state);
+
+    /**
+     * @brief Executes the instruction at the program counter
+     *
+     * @return uint8_t The number of CPU cycles taken
+     * @throws std::runtime_error if the op code is not implemented
+     */
+    uint8_t Step();
+
+    /**
+     * @brief Gets the number of instructions executed since construction
+     *
+     */
+    uint64_t instructions();
+
+    /**
+     * @brief Gets the op code counts recorded by Step
+     *
+     * @return OpCodeProfile* The profile, or nullptr unless built with LAMEBOY_OPCODE_PROFILE
+     */
+    OpCodeProfile* profile();
+
+    /**
+     * @brief Attaches an observer to be told about every instruction from now on
+     *
+     * @param observer The observer, which must outlive the emulator or be removed first
+     * @return true if attached, false if every slot is taken
+     */
+    bool AddInstructionObserver(InstructionObserver* observer);
+
+    /**
+     * @brief Detaches an observer. Does nothing if it was not attached
+     *
+     * @param observer The observer to remove
+     */
+    void RemoveInstructionObserver(InstructionObserver* observer);
+
+    /**
+     * @brief Starts or stops tracing. The check for a trace is a single branch in Step
+     *
+     * @param trace The trace to record into, or nullptr to stop tracing
+     */
+    void SetTrace(ExecutionTrace* trace);
+
+    /**
+     * @brief Gets the trace being recorded into
+     *
+     * @return ExecutionTrace* The trace, or nullptr if tracing is off
+     */
+    ExecutionTrace* trace();
+};
+
+#endif
@@ -0,0 +1,242 @@
+/**
+ * @file sm83_lockstep.cpp
+ * @brief Implementation of the lockstep SM83 driver
+ *
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include "./sm83_lockstep.hpp"
+#include "./sm83_emulator.hpp"
+
+static const uint32_t INSTANCE_MEMORY_SIZE = 0x10000;
+static const uint8_t ROM_LAST_PAGE = 0x7F;
+
+LockstepSM83::LockstepSM83(size_t instance_count, SIMDLevel level) {
+    this->instance_count_ = instance_count;
+    this->group_count_ = (instance_count + LOCKSTEP_LANES - 1) / LOCKSTEP_LANES;
+
+    // new only guarantees alignof(max_align_t) before C++17
+    size_t group_bytes = this->group_count_ * sizeof(LaneGroup);
+    this->group_storage_ = new uint8_t[group_bytes + alignof(LaneGroup)];
+    uintptr_t address = (uintptr_t)this->group_storage_;
+    address = (address + alignof(LaneGroup) - 1) & ~(uintptr_t)(alignof(LaneGroup) - 1);
+    this->groups_ = (LaneGroup*)address;
+    memset(this->groups_, 0, group_bytes);
+
+    this->memory_ = new uint8_t[instance_count * INSTANCE_MEMORY_SIZE];
+    memset(this->memory_, 0, instance_count * INSTANCE_MEMORY_SIZE);
+    memset(this->rom_, 0xFF, sizeof(this->rom_));
+
+    for (size_t i = 0; i < instance_count; i++) {
+        SM83State* state = new SM83State(this->memory_ + i * INSTANCE_MEMORY_SIZE);
+        state->AddMemoryObserver(this, 0x00, ROM_LAST_PAGE);
+        this->states_.push_back(state);
+    }
+    this->cycles_.assign(instance_count, 0);
+
+    this->simd_level_ = SIMDLevelSupported(level) ? level : SIMD_SCALAR;
+    switch (this->simd_level_) {
+#ifdef LAMEBOY_X86
+        case SIMD_AVX512:
+            this->kernel_ = ExecuteLanesAVX512;
+            break;
+        case SIMD_AVX2:
+            this->kernel_ = ExecuteLanesAVX2;
+            break;
+#endif
+        default:
+            // 4 lanes of SSE2 buy little over the scalar loop once masking is paid for
+            this->simd_level_ = SIMD_SCALAR;
+            this->kernel_ = ExecuteLanesScalar;
+            break;
+    }
+
+    this->current_instance_ = 0;
+    this->vector_steps_ = 0;
+    this->vector_instructions_ = 0;
+    this->scalar_steps_ = 0;
+}
+
+LockstepSM83::~LockstepSM83() {
+    for (SM83State* state : this->states_) {
+        delete state;
+    }
+    delete[] this->memory_;
+    delete[] this->group_storage_;
+}
+
+void LockstepSM83::LoadROM(const uint8_t* data, size_t size) {
+    size_t length = size < LOCKSTEP_ROM_SIZE ? size : LOCKSTEP_ROM_SIZE;
+    memset(this->rom_, 0xFF, sizeof(this->rom_));
+    memcpy(this->rom_, data, length);
+
+    memset(this->groups_, 0, this->group_count_ * sizeof(LaneGroup));
+
+    for (size_t i = 0; i < this->instance_count_; i++) {
+        uint8_t* memory = this->memory(i);
+        memset(memory, 0, INSTANCE_MEMORY_SIZE);
+        memcpy(memory, this->rom_, LOCKSTEP_ROM_SIZE);
+
+        // DMG register values after the boot ROM hands over
+        SM83State* state = this->states_[i];
+        state->setAF(0x01B0);
+        state->setBC(0x0013);
+        state->setDE(0x00D8);
+        state->setHL(0x014D);
+        state->setStackPointer(0xFFFE);
+        state->setProgramCounter(0x0100);
+        this->WriteRegisters(i, state);
+        this->cycles_[i] = 0;
+    }
+}
+
+void LockstepSM83::Run(uint32_t cycles) {
+    for (size_t group = 0; group < this->group_count_; group++) {
+        this->RunGroup(group, cycles);
+    }
+}
+
+void LockstepSM83::RunGroup(size_t group, uint32_t budget) {
+    uint32_t (*r)[LOCKSTEP_LANES] = this->groups_[group].registers;
+    size_t first = group * LOCKSTEP_LANES;
+    int lanes = (int)(this->instance_count_ - first < (size_t)LOCKSTEP_LANES ? this->instance_count_ - first : LOCKSTEP_LANES);
+
+    // Lanes start with the overshoot of the previous Run
+    uint32_t start[LOCKSTEP_LANES];
+    for (int lane = 0; lane < lanes; lane++) {
+        start[lane] = r[LANE_CYCLES][lane];
+    }
+
+    while (true) {
+        // Follow the lowest PC so lanes that took a forward branch wait at the join for the rest
+        int leader = -1;
+        for (int lane = 0; lane < lanes; lane++) {
+            if (r[LANE_CYCLES][lane] < budget && (leader < 0 || r[LANE_PC][lane] < r[LANE_PC][leader])) {
+                leader = lane;
+            }
+        }
+
+        if (leader < 0) {
+            break;
+        }
+
+        uint32_t pc = r[LANE_PC][leader];
+        uint32_t mask = 0;
+        for (int lane = 0; lane < lanes; lane++) {
+            if (r[LANE_PC][lane] == pc && r[LANE_CYCLES][lane] < budget) {
+                mask |= 1u << lane;
+            }
+        }
+
+        // Immediates come from the shared ROM, so only instructions wholly inside it can be vectorised
+        if (pc + 2 < LOCKSTEP_ROM_SIZE && (mask & (mask - 1)) != 0) {
+            const LaneOp& op = LaneOpFor(this->rom_[pc]);
+
+            if (op.kind != LANE_OP_SCALAR) {
+                this->kernel_(&this->groups_[group], mask, op, this->rom_[pc + 1], this->rom_[pc + 2]);
+                this->vector_steps_++;
+                this->vector_instructions_ += __builtin_popcount(mask);
+                continue;
+            }
+        }
+
+        for (int lane = 0; lane < lanes; lane++) {
+            if ((mask & (1u << lane)) != 0) {
+                this->StepScalar(group, lane);
+            }
+        }
+    }
+
+    for (int lane = 0; lane < lanes; lane++) {
+        this->cycles_[first + lane] += r[LANE_CYCLES][lane] - start[lane];
+        r[LANE_CYCLES][lane] -= budget;
+    }
+}
+
+void LockstepSM83::StepScalar(size_t group, int lane) {
+    size_t instance = group * LOCKSTEP_LANES + lane;
+    SM83State* state = this->states_[instance];
+    this->ReadRegisters(instance, state);
+
+    uint16_t pc = state->programCounter();
+    uint8_t op_code = this->memory_[instance * INSTANCE_MEMORY_SIZE + pc];
+    OpCodeHandler handler = OpCodeHandlerFor(op_code);
+
+    if (handler == nullptr) {
+        char message[64];
+        snprintf(message, sizeof(message), "Unimplemented op code 0x%02X at 0x%04X", op_code, pc);
+        throw std::runtime_error(message);
+    }
+
+    this->current_instance_ = instance;
+    uint8_t cycles = handler(state);
+    this->WriteRegisters(instance, state);
+    this->groups_[group].registers[LANE_CYCLES][lane] += cycles;
+    this->scalar_steps_++;
+}
+
+void LockstepSM83::ReadRegisters(size_t instance, SM83State* state) {
+    uint32_t (*r)[LOCKSTEP_LANES] = this->groups_[instance / LOCKSTEP_LANES].registers;
+    int lane = (int)(instance % LOCKSTEP_LANES);
+
+    state->setA((uint8_t)r[LANE_A][lane]);
+    state->setF((uint8_t)r[LANE_F][lane]);
+    state->setB((uint8_t)r[LANE_B][lane]);
+    state->setC((uint8_t)r[LANE_C][lane]);
+    state->setD((uint8_t)r[LANE_D][lane]);
+    state->setE((uint8_t)r[LANE_E][lane]);
+    state->setH((uint8_t)r[LANE_H][lane]);
+    state->setL((uint8_t)r[LANE_L][lane]);
+    state->setStackPointer((uint16_t)r[LANE_SP][lane]);
+    state->setProgramCounter((uint16_t)r[LANE_PC][lane]);
+}
+
+void LockstepSM83::WriteRegisters(size_t instance, SM83State* state) {
+    uint32_t (*r)[LOCKSTEP_LANES] = this->groups_[instance / LOCKSTEP_LANES].registers;
+    int lane = (int)(instance % LOCKSTEP_LANES);
+
+    r[LANE_A][lane] = state->a();
+    r[LANE_F][lane] = state->f();
+    r[LANE_B][lane] = state->b();
+    r[LANE_C][lane] = state->c();
+    r[LANE_D][lane] = state->d();
+    r[LANE_E][lane] = state->e();
+    r[LANE_H][lane] = state->h();
+    r[LANE_L][lane] = state->l();
+    r[LANE_SP][lane] = state->stackPointer();
+    r[LANE_PC][lane] = state->programCounter();
+}
+
+uint8_t* LockstepSM83::memory(size_t instance) {
+    return this->memory_ + instance * INSTANCE_MEMORY_SIZE;
+}
+
+uint64_t LockstepSM83::cycles(size_t instance) {
+    return this->cycles_[instance];
+}
+
+size_t LockstepSM83::instanceCount() {
+    return this->instance_count_;
+}
+
+SIMDLevel LockstepSM83::simdLevel() {
+    return this->simd_level_;
+}
+
+uint64_t LockstepSM83::vectorSteps() {
+    return this->vector_steps_;
+}
+
+uint64_t LockstepSM83::vectorInstructions() {
+    return this->vector_instructions_;
+}
+
+uint64_t LockstepSM83::scalarSteps() {
+    return this->scalar_steps_;
+}
+
+void LockstepSM83::OnMemoryWrite(uint16_t address, uint8_t value) {
+    this->memory(this->current_instance_)[address] = this->rom_[address];
+}
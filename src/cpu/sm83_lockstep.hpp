@@ -0,0 +1,183 @@
+/**
+ * @file sm83_lockstep.hpp
+ * @brief Runs many SM83 instances on the same ROM, stepping converged instances together with SIMD
+ *
+ */
+
+#ifndef SM83_LOCKSTEP_H
+#define SM83_LOCKSTEP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "./memory_observer.hpp"
+#include "./sm83_lockstep_kernels.hpp"
+#include "./sm83_state.hpp"
+
+// Bytes of ROM shared by every instance, the fixed and switchable banks without an MBC
+static const uint32_t LOCKSTEP_ROM_SIZE = 0x8000;
+
+/**
+ * @brief Steps a set of independent SM83 instances that all run the same ROM.
+ *
+ * Registers are kept as a structure of arrays in groups of LOCKSTEP_LANES instances. Each step picks
+ * the instance of a group with the lowest PC and runs its instruction on every instance of the group
+ * at that PC, with a lane kernel when the op code has one and the PC is in ROM. Instances
+ * that have diverged, instructions that touch memory and op codes without a kernel fall back to the
+ * Execute* handlers one instance at a time, so results always match a lone SM83Emulator.
+ *
+ * Each instance has its own 64KB memory bus with the ROM copied into it. Writes to ROM are undone,
+ * as on a cartridge without an MBC. There is no PPU, APU or interrupt handling.
+ */
+class LockstepSM83 : public MemoryObserver
+{
+
+private:
+
+    size_t instance_count_;
+    size_t group_count_;
+
+    // Storage for the groups, over allocated so they can be aligned for AVX-512
+    uint8_t* group_storage_;
+    LaneGroup* groups_;
+
+    // 64KB per instance
+    uint8_t* memory_;
+
+    // Used to run the Execute* handlers for an instance, each on its own memory bus
+    std::vector<SM83State*> states_;
+
+    // The ROM, which immediates of vector steps are read from
+    uint8_t rom_[LOCKSTEP_ROM_SIZE];
+
+    // Cycles run by each instance before the current Run
+    std::vector<uint64_t> cycles_;
+
+    LaneKernel kernel_;
+    SIMDLevel simd_level_;
+
+    // The instance being stepped by a handler, for restoring ROM writes
+    size_t current_instance_;
+
+    uint64_t vector_steps_;
+    uint64_t vector_instructions_;
+    uint64_t scalar_steps_;
+
+    /**
+     * @brief Runs the instructions of a group until every instance has used the cycle budget
+     *
+     * @param group The group index
+     * @param budget The cycles each instance should run
+     */
+    void RunGroup(size_t group, uint32_t budget);
+
+    /**
+     * @brief Runs one instruction on a single instance through its Execute* handler
+     *
+     * @param group The group index
+     * @param lane The instance's lane in the group
+     * @throws std::runtime_error if the op code is not implemented
+     */
+    void StepScalar(size_t group, int lane);
+
+public:
+    /**
+     * @brief Constructs a new LockstepSM83
+     *
+     * @param instance_count The number of instances to run
+     * @param level The SIMD level of the lane kernel, lowered if the CPU does not support it
+     */
+    LockstepSM83(size_t instance_count, SIMDLevel level = ActiveSIMDLevel());
+
+    ~LockstepSM83();
+
+    /**
+     * @brief Copies a ROM into every instance and sets the registers the boot ROM leaves behind
+     *
+     * @param data The ROM. Anything past LOCKSTEP_ROM_SIZE is ignored
+     * @param size The size of the ROM in bytes
+     */
+    void LoadROM(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Runs every instance for at least a number of cycles.
+     *
+     * An instance stops at the first instruction boundary at or past the budget, and the overshoot is
+     * taken off the next Run.
+     *
+     * @param cycles The number of cycles
+     * @throws std::runtime_error if an instance reaches an op code that is not implemented
+     */
+    void Run(uint32_t cycles);
+
+    /**
+     * @brief Copies the registers of an instance into a state
+     *
+     * @param instance The instance
+     * @param state Receives the registers
+     */
+    void ReadRegisters(size_t instance, SM83State* state);
+
+    /**
+     * @brief Sets the registers of an instance from a state
+     *
+     * @param instance The instance
+     * @param state The registers to set
+     */
+    void WriteRegisters(size_t instance, SM83State* state);
+
+    /**
+     * @brief Gets the memory bus of an instance
+     *
+     * @param instance The instance
+     * @return uint8_t* 64KB of memory
+     */
+    uint8_t* memory(size_t instance);
+
+    /**
+     * @brief Gets the total cycles an instance has run since the ROM was loaded
+     *
+     * @param instance The instance
+     */
+    uint64_t cycles(size_t instance);
+
+    /**
+     * @brief Gets the number of instances
+     *
+     */
+    size_t instanceCount();
+
+    /**
+     * @brief Gets the SIMD level of the lane kernel in use
+     *
+     */
+    SIMDLevel simdLevel();
+
+    /**
+     * @brief Gets the number of steps run by the lane kernel, each covering two or more instances
+     *
+     */
+    uint64_t vectorSteps();
+
+    /**
+     * @brief Gets the number of instructions run by the lane kernel, counting each instance of a step
+     *
+     */
+    uint64_t vectorInstructions();
+
+    /**
+     * @brief Gets the number of instructions run on a single instance through its handler
+     *
+     */
+    uint64_t scalarSteps();
+
+    /**
+     * @brief Undoes writes to ROM by the instance being stepped
+     *
+     * @param address The address written to
+     * @param value The value written
+     */
+    void OnMemoryWrite(uint16_t address, uint8_t value) override;
+};
+
+#endif
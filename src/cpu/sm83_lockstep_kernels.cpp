@@ -0,0 +1,166 @@
+/**
+ * @file sm83_lockstep_kernels.cpp
+ * @brief Op code table and scalar kernel for lockstep stepping
+ *
+ */
+
+#include <array>
+#include "./sm83_lockstep_kernels.hpp"
+#include "./sm83_op_code_info.hpp"
+#include "./sm83_state.hpp"
+
+// Lengths and timings come from the op code table so lanes can never disagree with the handlers
+static LaneOp MakeLaneOp(LaneOpKind kind, int reg, int arg, uint8_t op_code) {
+    const OpCodeInfo& info = OpCodeInfoFor(op_code);
+    LaneOp op = { (uint8_t)kind, (uint8_t)reg, (uint8_t)arg, info.length, info.cycles, info.branch_cycles };
+    return op;
+}
+
+static std::array<LaneOp, 256> BuildLaneOps() {
+    std::array<LaneOp, 256> ops;
+    ops.fill(LaneOp { LANE_OP_SCALAR, 0, 0, 0, 0, 0 });
+
+    // Rows of the op code table share a register, B C / D E / H L going down
+    for (int row = 0; row < 3; row++) {
+        int high = LANE_B + row * 2;
+        int low = high + 1;
+        int base = row * 0x10;
+
+        ops[base + 0x01] = MakeLaneOp(LANE_OP_LOAD_16, high, 0, base + 0x01);
+        ops[base + 0x03] = MakeLaneOp(LANE_OP_INC_16, high, 0, base + 0x03);
+        ops[base + 0x04] = MakeLaneOp(LANE_OP_INC_8, high, 0, base + 0x04);
+        ops[base + 0x05] = MakeLaneOp(LANE_OP_DEC_8, high, 0, base + 0x05);
+        ops[base + 0x06] = MakeLaneOp(LANE_OP_LOAD_8, high, 0, base + 0x06);
+        ops[base + 0x09] = MakeLaneOp(LANE_OP_ADD_HL, LANE_H, high, base + 0x09);
+        ops[base + 0x0B] = MakeLaneOp(LANE_OP_DEC_16, high, 0, base + 0x0B);
+        ops[base + 0x0C] = MakeLaneOp(LANE_OP_INC_8, low, 0, base + 0x0C);
+        ops[base + 0x0D] = MakeLaneOp(LANE_OP_DEC_8, low, 0, base + 0x0D);
+        ops[base + 0x0E] = MakeLaneOp(LANE_OP_LOAD_8, low, 0, base + 0x0E);
+    }
+
+    ops[0x00] = MakeLaneOp(LANE_OP_NOP, 0, 0, 0x00);
+    ops[0x07] = MakeLaneOp(LANE_OP_ROTATE_LEFT, LANE_A, 0, 0x07);
+    ops[0x17] = MakeLaneOp(LANE_OP_ROTATE_LEFT, LANE_A, 1, 0x17);
+    ops[0x0F] = MakeLaneOp(LANE_OP_ROTATE_RIGHT, LANE_A, 0, 0x0F);
+    ops[0x1F] = MakeLaneOp(LANE_OP_ROTATE_RIGHT, LANE_A, 1, 0x1F);
+    ops[0x2F] = MakeLaneOp(LANE_OP_CPL, LANE_A, 0, 0x2F);
+    ops[0x37] = MakeLaneOp(LANE_OP_SCF, LANE_F, 0, 0x37);
+    ops[0x18] = MakeLaneOp(LANE_OP_JUMP, LANE_PC, LANE_IF_ALWAYS, 0x18);
+    ops[0x20] = MakeLaneOp(LANE_OP_JUMP, LANE_PC, LANE_IF_NZ, 0x20);
+    ops[0x28] = MakeLaneOp(LANE_OP_JUMP, LANE_PC, LANE_IF_Z, 0x28);
+    ops[0x30] = MakeLaneOp(LANE_OP_JUMP, LANE_PC, LANE_IF_NC, 0x30);
+    ops[0x38] = MakeLaneOp(LANE_OP_JUMP, LANE_PC, LANE_IF_C, 0x38);
+
+    return ops;
+}
+
+static const std::array<LaneOp, 256> LANE_OPS = BuildLaneOps();
+
+const LaneOp& LaneOpFor(uint8_t op_code) {
+    return LANE_OPS[op_code];
+}
+
+/**
+ * @brief Gets whether a jump is taken given the flags
+ *
+ */
+static bool JumpTaken(uint8_t condition, uint32_t f) {
+    switch (condition) {
+        case LANE_IF_NZ:
+            return (f & Z_FLAG) == 0;
+        case LANE_IF_Z:
+            return (f & Z_FLAG) != 0;
+        case LANE_IF_NC:
+            return (f & C_FLAG) == 0;
+        case LANE_IF_C:
+            return (f & C_FLAG) != 0;
+        default:
+            return true;
+    }
+}
+
+void ExecuteLanesScalar(LaneGroup* group, uint32_t mask, const LaneOp& op, uint8_t immediate1, uint8_t immediate2) {
+    uint32_t (*r)[LOCKSTEP_LANES] = group->registers;
+
+    for (int lane = 0; lane < LOCKSTEP_LANES; lane++) {
+        if ((mask & (1u << lane)) == 0) {
+            continue;
+        }
+
+        uint32_t f = r[LANE_F][lane];
+
+        switch (op.kind) {
+            case LANE_OP_LOAD_8:
+                r[op.reg][lane] = immediate1;
+                break;
+            case LANE_OP_LOAD_16:
+                // The immediate is little endian, so the low half of the pair comes first
+                r[op.reg][lane] = immediate2;
+                r[op.reg + 1][lane] = immediate1;
+                break;
+            case LANE_OP_INC_8: {
+                uint32_t value = (r[op.reg][lane] + 1) & 0xFF;
+                r[op.reg][lane] = value;
+                r[LANE_F][lane] = (f & ~(uint32_t)(Z_FLAG | N_FLAG | H_FLAG)) | (value == 0 ? Z_FLAG : 0) | ((value & 0x0F) == 0 ? H_FLAG : 0);
+                break;
+            }
+            case LANE_OP_DEC_8: {
+                uint32_t value = (r[op.reg][lane] - 1) & 0xFF;
+                r[op.reg][lane] = value;
+                r[LANE_F][lane] = (f & ~(uint32_t)(Z_FLAG | H_FLAG)) | N_FLAG | (value == 0 ? Z_FLAG : 0) | ((value & 0x0F) == 0x0F ? H_FLAG : 0);
+                break;
+            }
+            case LANE_OP_INC_16:
+            case LANE_OP_DEC_16: {
+                uint32_t pair = r[op.reg][lane] << 8 | r[op.reg + 1][lane];
+                pair = (op.kind == LANE_OP_INC_16 ? pair + 1 : pair - 1) & 0xFFFF;
+                r[op.reg][lane] = pair >> 8;
+                r[op.reg + 1][lane] = pair & 0xFF;
+                break;
+            }
+            case LANE_OP_ADD_HL: {
+                uint32_t hl = r[LANE_H][lane] << 8 | r[LANE_L][lane];
+                uint32_t source = r[op.arg][lane] << 8 | r[op.arg + 1][lane];
+                uint32_t sum = hl + source;
+                r[LANE_H][lane] = (sum >> 8) & 0xFF;
+                r[LANE_L][lane] = sum & 0xFF;
+                f &= ~(uint32_t)(N_FLAG | H_FLAG | C_FLAG);
+                f |= (hl & 0x0FFF) + (source & 0x0FFF) > 0x0FFF ? H_FLAG : 0;
+                f |= sum > 0xFFFF ? C_FLAG : 0;
+                r[LANE_F][lane] = f;
+                break;
+            }
+            case LANE_OP_ROTATE_LEFT:
+            case LANE_OP_ROTATE_RIGHT: {
+                uint32_t a = r[LANE_A][lane];
+                bool left = op.kind == LANE_OP_ROTATE_LEFT;
+                uint32_t out = left ? a >> 7 : a & 1;
+                uint32_t in = op.arg != 0 ? (f & C_FLAG) >> 4 : out;
+                uint32_t value = left ? ((a << 1) & 0xFF) | in : (a >> 1) | (in << 7);
+                r[LANE_A][lane] = value;
+                r[LANE_F][lane] = out != 0 ? C_FLAG : 0;
+                break;
+            }
+            case LANE_OP_CPL:
+                r[LANE_A][lane] ^= 0xFF;
+                r[LANE_F][lane] = f | N_FLAG | H_FLAG;
+                break;
+            case LANE_OP_SCF:
+                r[LANE_F][lane] = (f & (Z_FLAG | C_FLAG)) | C_FLAG;
+                break;
+            default:
+                break;
+        }
+
+        if (op.kind == LANE_OP_JUMP) {
+            bool taken = JumpTaken(op.arg, f);
+            uint32_t pc = r[LANE_PC][lane];
+            uint32_t next = pc + op.length;
+            r[LANE_PC][lane] = (taken ? next + (int8_t)immediate1 : next) & 0xFFFF;
+            r[LANE_CYCLES][lane] += taken ? op.branch_cycles : op.cycles;
+        } else {
+            r[LANE_PC][lane] = (r[LANE_PC][lane] + op.length) & 0xFFFF;
+            r[LANE_CYCLES][lane] += op.cycles;
+        }
+    }
+}
@@ -0,0 +1,127 @@
+/**
+ * @file sm83_lockstep_kernels.hpp
+ * @brief Op code kernels that step a group of SM83 instances at once, one per SIMD level
+ *
+ */
+
+#ifndef SM83_LOCKSTEP_KERNELS_H
+#define SM83_LOCKSTEP_KERNELS_H
+
+#include <cstdint>
+#include "../util/cpu_features.hpp"
+
+// Instances per group: two AVX2 vectors or one AVX-512 vector of 32 bit lanes
+static const int LOCKSTEP_LANES = 16;
+
+/**
+ * @brief Rows of a LaneGroup. B to L are in pair order, so the low half of a pair follows its high half
+ *
+ */
+enum LaneRegister {
+    LANE_A,
+    LANE_F,
+    LANE_B,
+    LANE_C,
+    LANE_D,
+    LANE_E,
+    LANE_H,
+    LANE_L,
+    LANE_SP,
+    LANE_PC,
+    // Cycles run since the start of the current LockstepSM83::Run
+    LANE_CYCLES,
+    LANE_REGISTERS
+};
+
+/**
+ * @brief The registers of LOCKSTEP_LANES instances, one row per register with a lane per instance.
+ *
+ * Every value is widened to 32 bits so a row is one AVX-512 vector. Only the low 8 bits of the 8 bit
+ * registers and the low 16 bits of SP and PC are ever set.
+ */
+struct alignas(64) LaneGroup {
+    uint32_t registers[LANE_REGISTERS][LOCKSTEP_LANES];
+};
+
+/**
+ * @brief Families of op codes with a lane kernel. Everything else is stepped one instance at a time
+ *
+ */
+enum LaneOpKind {
+    LANE_OP_SCALAR,
+    LANE_OP_NOP,
+    LANE_OP_LOAD_8,
+    LANE_OP_LOAD_16,
+    LANE_OP_INC_8,
+    LANE_OP_DEC_8,
+    LANE_OP_INC_16,
+    LANE_OP_DEC_16,
+    LANE_OP_ADD_HL,
+    LANE_OP_ROTATE_LEFT,
+    LANE_OP_ROTATE_RIGHT,
+    LANE_OP_CPL,
+    LANE_OP_SCF,
+    LANE_OP_JUMP
+};
+
+/**
+ * @brief Conditions of LANE_OP_JUMP
+ *
+ */
+enum LaneCondition {
+    LANE_IF_ALWAYS,
+    LANE_IF_NZ,
+    LANE_IF_Z,
+    LANE_IF_NC,
+    LANE_IF_C
+};
+
+/**
+ * @brief How a lane kernel runs an op code
+ *
+ */
+struct LaneOp {
+    uint8_t kind;
+    // The register written, the high half for pairs
+    uint8_t reg;
+    // The source pair of ADD HL, whether a rotate goes through carry, or a jump condition
+    uint8_t arg;
+    // Bytes the PC advances by, before any jump offset
+    uint8_t length;
+    // Cycles taken, when not jumping for a conditional jump
+    uint8_t cycles;
+    // Cycles taken by a jump that is followed
+    uint8_t branch_cycles;
+};
+
+/**
+ * @brief Gets the lane kernel description of an op code
+ *
+ * @param op_code The op code
+ * @return const LaneOp& A LANE_OP_SCALAR entry if the op code has no lane kernel
+ */
+const LaneOp& LaneOpFor(uint8_t op_code);
+
+/**
+ * @brief Runs one op code on the lanes of a group that share a PC in ROM.
+ *
+ * Each kernel matches the Execute* handler of the op code exactly, flags included, so stepping an
+ * instance in a group or on its own gives the same result. Immediates are passed in since every
+ * instance maps the same ROM.
+ *
+ * @param group The group
+ * @param mask Bit n set to run lane n
+ * @param op The op code's description, never LANE_OP_SCALAR
+ * @param immediate1 The byte at PC + 1
+ * @param immediate2 The byte at PC + 2
+ */
+typedef void (*LaneKernel)(LaneGroup* group, uint32_t mask, const LaneOp& op, uint8_t immediate1, uint8_t immediate2);
+
+void ExecuteLanesScalar(LaneGroup* group, uint32_t mask, const LaneOp& op, uint8_t immediate1, uint8_t immediate2);
+
+#ifdef LAMEBOY_X86
+void ExecuteLanesAVX2(LaneGroup* group, uint32_t mask, const LaneOp& op, uint8_t immediate1, uint8_t immediate2);
+void ExecuteLanesAVX512(LaneGroup* group, uint32_t mask, const LaneOp& op, uint8_t immediate1, uint8_t immediate2);
+#endif
+
+#endif
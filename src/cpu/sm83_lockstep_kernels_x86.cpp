@@ -0,0 +1,308 @@
+/**
+ * @file sm83_lockstep_kernels_x86.cpp
+ * @brief AVX2 and AVX-512 lockstep kernels
+ *
+ * A group is two AVX2 vectors or one AVX-512 vector per register. Lanes outside the mask are left
+ * untouched by masked stores, so the kernels compute every lane and only keep the ones that ran.
+ */
+
+#include "./sm83_lockstep_kernels.hpp"
+#include "./sm83_state.hpp"
+
+#ifdef LAMEBOY_X86
+
+#include <immintrin.h>
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+#define AVX512_TARGET __attribute__((target("avx512f")))
+
+// AVX2
+
+/**
+ * @brief Expands 8 mask bits to all ones or all zeros per lane
+ *
+ */
+AVX2_TARGET static inline __m256i LaneMaskAVX2(uint32_t bits) {
+    const __m256i select = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32((int)bits), select), select);
+}
+
+/**
+ * @brief Expands a comparison result to a flag bit in the lanes where it holds
+ *
+ */
+AVX2_TARGET static inline __m256i FlagIfAVX2(__m256i condition, uint8_t flag) {
+    return _mm256_and_si256(condition, _mm256_set1_epi32(flag));
+}
+
+AVX2_TARGET static inline __m256i JumpTakenAVX2(uint8_t condition, __m256i f) {
+    __m256i zero = _mm256_setzero_si256();
+
+    switch (condition) {
+        case LANE_IF_NZ:
+            return _mm256_cmpeq_epi32(_mm256_and_si256(f, _mm256_set1_epi32(Z_FLAG)), zero);
+        case LANE_IF_Z:
+            return _mm256_cmpeq_epi32(_mm256_and_si256(f, _mm256_set1_epi32(Z_FLAG)), _mm256_set1_epi32(Z_FLAG));
+        case LANE_IF_NC:
+            return _mm256_cmpeq_epi32(_mm256_and_si256(f, _mm256_set1_epi32(C_FLAG)), zero);
+        case LANE_IF_C:
+            return _mm256_cmpeq_epi32(_mm256_and_si256(f, _mm256_set1_epi32(C_FLAG)), _mm256_set1_epi32(C_FLAG));
+        default:
+            return _mm256_cmpeq_epi32(zero, zero);
+    }
+}
+
+AVX2_TARGET void ExecuteLanesAVX2(LaneGroup* group, uint32_t mask, const LaneOp& op, uint8_t immediate1, uint8_t immediate2) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i byte = _mm256_set1_epi32(0xFF);
+    const __m256i word = _mm256_set1_epi32(0xFFFF);
+    const __m256i nibble = _mm256_set1_epi32(0x0F);
+    const __m256i twelve_bits = _mm256_set1_epi32(0x0FFF);
+
+    for (int half = 0; half < LOCKSTEP_LANES; half += 8) {
+        uint32_t bits = (mask >> half) & 0xFF;
+        if (bits == 0) {
+            continue;
+        }
+
+        __m256i lanes = LaneMaskAVX2(bits);
+        int* row[LANE_REGISTERS];
+        for (int i = 0; i < LANE_REGISTERS; i++) {
+            row[i] = (int*)(group->registers[i] + half);
+        }
+
+        __m256i f = _mm256_load_si256((const __m256i*)row[LANE_F]);
+
+        switch (op.kind) {
+            case LANE_OP_LOAD_8:
+                _mm256_maskstore_epi32(row[op.reg], lanes, _mm256_set1_epi32(immediate1));
+                break;
+            case LANE_OP_LOAD_16:
+                _mm256_maskstore_epi32(row[op.reg], lanes, _mm256_set1_epi32(immediate2));
+                _mm256_maskstore_epi32(row[op.reg + 1], lanes, _mm256_set1_epi32(immediate1));
+                break;
+            case LANE_OP_INC_8: {
+                __m256i value = _mm256_and_si256(_mm256_add_epi32(_mm256_load_si256((const __m256i*)row[op.reg]), one), byte);
+                __m256i flags = _mm256_and_si256(f, _mm256_set1_epi32(~(Z_FLAG | N_FLAG | H_FLAG) & 0xFF));
+                flags = _mm256_or_si256(flags, FlagIfAVX2(_mm256_cmpeq_epi32(value, zero), Z_FLAG));
+                flags = _mm256_or_si256(flags, FlagIfAVX2(_mm256_cmpeq_epi32(_mm256_and_si256(value, nibble), zero), H_FLAG));
+                _mm256_maskstore_epi32(row[op.reg], lanes, value);
+                _mm256_maskstore_epi32(row[LANE_F], lanes, flags);
+                break;
+            }
+            case LANE_OP_DEC_8: {
+                __m256i value = _mm256_and_si256(_mm256_sub_epi32(_mm256_load_si256((const __m256i*)row[op.reg]), one), byte);
+                __m256i flags = _mm256_and_si256(f, _mm256_set1_epi32(~(Z_FLAG | H_FLAG) & 0xFF));
+                flags = _mm256_or_si256(flags, _mm256_set1_epi32(N_FLAG));
+                flags = _mm256_or_si256(flags, FlagIfAVX2(_mm256_cmpeq_epi32(value, zero), Z_FLAG));
+                flags = _mm256_or_si256(flags, FlagIfAVX2(_mm256_cmpeq_epi32(_mm256_and_si256(value, nibble), nibble), H_FLAG));
+                _mm256_maskstore_epi32(row[op.reg], lanes, value);
+                _mm256_maskstore_epi32(row[LANE_F], lanes, flags);
+                break;
+            }
+            case LANE_OP_INC_16:
+            case LANE_OP_DEC_16: {
+                __m256i high = _mm256_load_si256((const __m256i*)row[op.reg]);
+                __m256i low = _mm256_load_si256((const __m256i*)row[op.reg + 1]);
+                __m256i pair = _mm256_or_si256(_mm256_slli_epi32(high, 8), low);
+                pair = op.kind == LANE_OP_INC_16 ? _mm256_add_epi32(pair, one) : _mm256_sub_epi32(pair, one);
+                pair = _mm256_and_si256(pair, word);
+                _mm256_maskstore_epi32(row[op.reg], lanes, _mm256_srli_epi32(pair, 8));
+                _mm256_maskstore_epi32(row[op.reg + 1], lanes, _mm256_and_si256(pair, byte));
+                break;
+            }
+            case LANE_OP_ADD_HL: {
+                __m256i hl = _mm256_or_si256(_mm256_slli_epi32(_mm256_load_si256((const __m256i*)row[LANE_H]), 8),
+                    _mm256_load_si256((const __m256i*)row[LANE_L]));
+                __m256i source = _mm256_or_si256(_mm256_slli_epi32(_mm256_load_si256((const __m256i*)row[op.arg]), 8),
+                    _mm256_load_si256((const __m256i*)row[op.arg + 1]));
+                __m256i sum = _mm256_add_epi32(hl, source);
+                __m256i low_sum = _mm256_add_epi32(_mm256_and_si256(hl, twelve_bits), _mm256_and_si256(source, twelve_bits));
+
+                // Sums are at most 17 bits, so signed compares are safe
+                __m256i flags = _mm256_and_si256(f, _mm256_set1_epi32(~(N_FLAG | H_FLAG | C_FLAG) & 0xFF));
+                flags = _mm256_or_si256(flags, FlagIfAVX2(_mm256_cmpgt_epi32(low_sum, twelve_bits), H_FLAG));
+                flags = _mm256_or_si256(flags, FlagIfAVX2(_mm256_cmpgt_epi32(sum, word), C_FLAG));
+                sum = _mm256_and_si256(sum, word);
+                _mm256_maskstore_epi32(row[LANE_H], lanes, _mm256_srli_epi32(sum, 8));
+                _mm256_maskstore_epi32(row[LANE_L], lanes, _mm256_and_si256(sum, byte));
+                _mm256_maskstore_epi32(row[LANE_F], lanes, flags);
+                break;
+            }
+            case LANE_OP_ROTATE_LEFT:
+            case LANE_OP_ROTATE_RIGHT: {
+                __m256i a = _mm256_load_si256((const __m256i*)row[LANE_A]);
+                bool left = op.kind == LANE_OP_ROTATE_LEFT;
+                __m256i out = left ? _mm256_srli_epi32(a, 7) : _mm256_and_si256(a, one);
+                __m256i in = op.arg != 0 ? _mm256_srli_epi32(_mm256_and_si256(f, _mm256_set1_epi32(C_FLAG)), 4) : out;
+                __m256i value = left ? _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(a, 1), byte), in)
+                    : _mm256_or_si256(_mm256_srli_epi32(a, 1), _mm256_slli_epi32(in, 7));
+                __m256i flags = _mm256_slli_epi32(out, 4);
+                _mm256_maskstore_epi32(row[LANE_A], lanes, value);
+                _mm256_maskstore_epi32(row[LANE_F], lanes, flags);
+                break;
+            }
+            case LANE_OP_CPL:
+                _mm256_maskstore_epi32(row[LANE_A], lanes, _mm256_xor_si256(_mm256_load_si256((const __m256i*)row[LANE_A]), byte));
+                _mm256_maskstore_epi32(row[LANE_F], lanes, _mm256_or_si256(f, _mm256_set1_epi32(N_FLAG | H_FLAG)));
+                break;
+            case LANE_OP_SCF:
+                _mm256_maskstore_epi32(row[LANE_F], lanes,
+                    _mm256_or_si256(_mm256_and_si256(f, _mm256_set1_epi32(Z_FLAG | C_FLAG)), _mm256_set1_epi32(C_FLAG)));
+                break;
+            default:
+                break;
+        }
+
+        __m256i pc = _mm256_load_si256((const __m256i*)row[LANE_PC]);
+        __m256i cycles = _mm256_load_si256((const __m256i*)row[LANE_CYCLES]);
+
+        if (op.kind == LANE_OP_JUMP) {
+            __m256i taken = JumpTakenAVX2(op.arg, f);
+            __m256i next = _mm256_add_epi32(pc, _mm256_set1_epi32(op.length));
+            __m256i target = _mm256_add_epi32(next, _mm256_set1_epi32((int8_t)immediate1));
+            pc = _mm256_blendv_epi8(next, target, taken);
+            cycles = _mm256_add_epi32(cycles, _mm256_blendv_epi8(_mm256_set1_epi32(op.cycles), _mm256_set1_epi32(op.branch_cycles), taken));
+        } else {
+            pc = _mm256_add_epi32(pc, _mm256_set1_epi32(op.length));
+            cycles = _mm256_add_epi32(cycles, _mm256_set1_epi32(op.cycles));
+        }
+
+        _mm256_maskstore_epi32(row[LANE_PC], lanes, _mm256_and_si256(pc, word));
+        _mm256_maskstore_epi32(row[LANE_CYCLES], lanes, cycles);
+    }
+}
+
+// AVX-512
+
+/**
+ * @brief Expands a comparison mask to a flag bit in the lanes where it holds
+ *
+ */
+AVX512_TARGET static inline __m512i FlagIfAVX512(__mmask16 condition, uint8_t flag) {
+    return _mm512_maskz_mov_epi32(condition, _mm512_set1_epi32(flag));
+}
+
+AVX512_TARGET static inline __mmask16 JumpTakenAVX512(uint8_t condition, __m512i f) {
+    switch (condition) {
+        case LANE_IF_NZ:
+            return _mm512_testn_epi32_mask(f, _mm512_set1_epi32(Z_FLAG));
+        case LANE_IF_Z:
+            return _mm512_test_epi32_mask(f, _mm512_set1_epi32(Z_FLAG));
+        case LANE_IF_NC:
+            return _mm512_testn_epi32_mask(f, _mm512_set1_epi32(C_FLAG));
+        case LANE_IF_C:
+            return _mm512_test_epi32_mask(f, _mm512_set1_epi32(C_FLAG));
+        default:
+            return 0xFFFF;
+    }
+}
+
+AVX512_TARGET void ExecuteLanesAVX512(LaneGroup* group, uint32_t mask, const LaneOp& op, uint8_t immediate1, uint8_t immediate2) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i byte = _mm512_set1_epi32(0xFF);
+    const __m512i word = _mm512_set1_epi32(0xFFFF);
+    const __m512i nibble = _mm512_set1_epi32(0x0F);
+    const __m512i twelve_bits = _mm512_set1_epi32(0x0FFF);
+
+    __mmask16 lanes = (__mmask16)mask;
+    uint32_t (*row)[LOCKSTEP_LANES] = group->registers;
+    __m512i f = _mm512_load_si512(row[LANE_F]);
+
+    switch (op.kind) {
+        case LANE_OP_LOAD_8:
+            _mm512_mask_store_epi32(row[op.reg], lanes, _mm512_set1_epi32(immediate1));
+            break;
+        case LANE_OP_LOAD_16:
+            _mm512_mask_store_epi32(row[op.reg], lanes, _mm512_set1_epi32(immediate2));
+            _mm512_mask_store_epi32(row[op.reg + 1], lanes, _mm512_set1_epi32(immediate1));
+            break;
+        case LANE_OP_INC_8: {
+            __m512i value = _mm512_and_si512(_mm512_add_epi32(_mm512_load_si512(row[op.reg]), one), byte);
+            __m512i flags = _mm512_and_si512(f, _mm512_set1_epi32(~(Z_FLAG | N_FLAG | H_FLAG) & 0xFF));
+            flags = _mm512_or_si512(flags, FlagIfAVX512(_mm512_cmpeq_epi32_mask(value, zero), Z_FLAG));
+            flags = _mm512_or_si512(flags, FlagIfAVX512(_mm512_testn_epi32_mask(value, nibble), H_FLAG));
+            _mm512_mask_store_epi32(row[op.reg], lanes, value);
+            _mm512_mask_store_epi32(row[LANE_F], lanes, flags);
+            break;
+        }
+        case LANE_OP_DEC_8: {
+            __m512i value = _mm512_and_si512(_mm512_sub_epi32(_mm512_load_si512(row[op.reg]), one), byte);
+            __m512i flags = _mm512_and_si512(f, _mm512_set1_epi32(~(Z_FLAG | H_FLAG) & 0xFF));
+            flags = _mm512_or_si512(flags, _mm512_set1_epi32(N_FLAG));
+            flags = _mm512_or_si512(flags, FlagIfAVX512(_mm512_cmpeq_epi32_mask(value, zero), Z_FLAG));
+            flags = _mm512_or_si512(flags, FlagIfAVX512(_mm512_cmpeq_epi32_mask(_mm512_and_si512(value, nibble), nibble), H_FLAG));
+            _mm512_mask_store_epi32(row[op.reg], lanes, value);
+            _mm512_mask_store_epi32(row[LANE_F], lanes, flags);
+            break;
+        }
+        case LANE_OP_INC_16:
+        case LANE_OP_DEC_16: {
+            __m512i pair = _mm512_or_si512(_mm512_slli_epi32(_mm512_load_si512(row[op.reg]), 8), _mm512_load_si512(row[op.reg + 1]));
+            pair = op.kind == LANE_OP_INC_16 ? _mm512_add_epi32(pair, one) : _mm512_sub_epi32(pair, one);
+            pair = _mm512_and_si512(pair, word);
+            _mm512_mask_store_epi32(row[op.reg], lanes, _mm512_srli_epi32(pair, 8));
+            _mm512_mask_store_epi32(row[op.reg + 1], lanes, _mm512_and_si512(pair, byte));
+            break;
+        }
+        case LANE_OP_ADD_HL: {
+            __m512i hl = _mm512_or_si512(_mm512_slli_epi32(_mm512_load_si512(row[LANE_H]), 8), _mm512_load_si512(row[LANE_L]));
+            __m512i source = _mm512_or_si512(_mm512_slli_epi32(_mm512_load_si512(row[op.arg]), 8), _mm512_load_si512(row[op.arg + 1]));
+            __m512i sum = _mm512_add_epi32(hl, source);
+            __m512i low_sum = _mm512_add_epi32(_mm512_and_si512(hl, twelve_bits), _mm512_and_si512(source, twelve_bits));
+
+            __m512i flags = _mm512_and_si512(f, _mm512_set1_epi32(~(N_FLAG | H_FLAG | C_FLAG) & 0xFF));
+            flags = _mm512_or_si512(flags, FlagIfAVX512(_mm512_cmpgt_epu32_mask(low_sum, twelve_bits), H_FLAG));
+            flags = _mm512_or_si512(flags, FlagIfAVX512(_mm512_cmpgt_epu32_mask(sum, word), C_FLAG));
+            sum = _mm512_and_si512(sum, word);
+            _mm512_mask_store_epi32(row[LANE_H], lanes, _mm512_srli_epi32(sum, 8));
+            _mm512_mask_store_epi32(row[LANE_L], lanes, _mm512_and_si512(sum, byte));
+            _mm512_mask_store_epi32(row[LANE_F], lanes, flags);
+            break;
+        }
+        case LANE_OP_ROTATE_LEFT:
+        case LANE_OP_ROTATE_RIGHT: {
+            __m512i a = _mm512_load_si512(row[LANE_A]);
+            bool left = op.kind == LANE_OP_ROTATE_LEFT;
+            __m512i out = left ? _mm512_srli_epi32(a, 7) : _mm512_and_si512(a, one);
+            __m512i in = op.arg != 0 ? _mm512_srli_epi32(_mm512_and_si512(f, _mm512_set1_epi32(C_FLAG)), 4) : out;
+            __m512i value = left ? _mm512_or_si512(_mm512_and_si512(_mm512_slli_epi32(a, 1), byte), in)
+                : _mm512_or_si512(_mm512_srli_epi32(a, 1), _mm512_slli_epi32(in, 7));
+            __m512i flags = _mm512_slli_epi32(out, 4);
+            _mm512_mask_store_epi32(row[LANE_A], lanes, value);
+            _mm512_mask_store_epi32(row[LANE_F], lanes, flags);
+            break;
+        }
+        case LANE_OP_CPL:
+            _mm512_mask_store_epi32(row[LANE_A], lanes, _mm512_xor_si512(_mm512_load_si512(row[LANE_A]), byte));
+            _mm512_mask_store_epi32(row[LANE_F], lanes, _mm512_or_si512(f, _mm512_set1_epi32(N_FLAG | H_FLAG)));
+            break;
+        case LANE_OP_SCF:
+            _mm512_mask_store_epi32(row[LANE_F], lanes,
+                _mm512_or_si512(_mm512_and_si512(f, _mm512_set1_epi32(Z_FLAG | C_FLAG)), _mm512_set1_epi32(C_FLAG)));
+            break;
+        default:
+            break;
+    }
+
+    __m512i pc = _mm512_load_si512(row[LANE_PC]);
+    __m512i cycles = _mm512_load_si512(row[LANE_CYCLES]);
+
+    if (op.kind == LANE_OP_JUMP) {
+        __mmask16 taken = JumpTakenAVX512(op.arg, f);
+        __m512i next = _mm512_add_epi32(pc, _mm512_set1_epi32(op.length));
+        __m512i target = _mm512_add_epi32(next, _mm512_set1_epi32((int8_t)immediate1));
+        pc = _mm512_mask_blend_epi32(taken, next, target);
+        cycles = _mm512_add_epi32(cycles, _mm512_mask_blend_epi32(taken, _mm512_set1_epi32(op.cycles), _mm512_set1_epi32(op.branch_cycles)));
+    } else {
+        pc = _mm512_add_epi32(pc, _mm512_set1_epi32(op.length));
+        cycles = _mm512_add_epi32(cycles, _mm512_set1_epi32(op.cycles));
+    }
+
+    _mm512_mask_store_epi32(row[LANE_PC], lanes, _mm512_and_si512(pc, word));
+    _mm512_mask_store_epi32(row[LANE_CYCLES], lanes, cycles);
+}
+
+#endif
@@ -0,0 +1,774 @@
+/**
+ * @file sm83_op_code_info.hpp
+ * @brief Length, timing and flag effects of every SM83 op code
+ *
+ */
+
+#ifndef SM83_OP_CODE_INFO_H
+#define SM83_OP_CODE_INFO_H
+
+#include <cstdint>
+
+/**
+ * @brief Describes one op code as listed in the Pandocs op code table.
+ *
+ * Mnemonics name their operands by kind: d8 and d16 are immediate data, a8 is an offset from 0xFF00,
+ * a16 an absolute address and r8 a signed offset. Cycles are T-cycles and include the CB prefix for
+ * CB op codes.
+ */
+struct OpCodeInfo {
+    // nullptr for op codes the CPU does not define
+    const char* mnemonic;
+    // Bytes including the op code and any CB prefix
+    uint8_t length;
+    // Cycles taken, when not branching for conditional jumps, calls and returns
+    uint8_t cycles;
+    // Cycles taken when a conditional branch is taken, the same as cycles for everything else
+    uint8_t branch_cycles;
+    // Z, N, H and C in order: the flag's letter if set from the result, 0 or 1 if forced, - if kept
+    const char* flags;
+};
+
+// The op code that selects the second table
+static const uint8_t CB_PREFIX = 0xCB;
+
+// Primary op codes indexed by value. Handlers, lane kernels and the disassembler all read lengths and
+// cycles from here, and the checks at the end of this file run whenever it is included
+static constexpr OpCodeInfo OP_CODE_INFO[256] = {
+    /* 00 */ {"NOP", 1, 4, 4, "----"},
+    /* 01 */ {"LD BC,d16", 3, 12, 12, "----"},
+    /* 02 */ {"LD (BC),A", 1, 8, 8, "----"},
+    /* 03 */ {"INC BC", 1, 8, 8, "----"},
+    /* 04 */ {"INC B", 1, 4, 4, "Z0H-"},
+    /* 05 */ {"DEC B", 1, 4, 4, "Z1H-"},
+    /* 06 */ {"LD B,d8", 2, 8, 8, "----"},
+    /* 07 */ {"RLCA", 1, 4, 4, "000C"},
+    /* 08 */ {"LD (a16),SP", 3, 20, 20, "----"},
+    /* 09 */ {"ADD HL,BC", 1, 8, 8, "-0HC"},
+    /* 0A */ {"LD A,(BC)", 1, 8, 8, "----"},
+    /* 0B */ {"DEC BC", 1, 8, 8, "----"},
+    /* 0C */ {"INC C", 1, 4, 4, "Z0H-"},
+    /* 0D */ {"DEC C", 1, 4, 4, "Z1H-"},
+    /* 0E */ {"LD C,d8", 2, 8, 8, "----"},
+    /* 0F */ {"RRCA", 1, 4, 4, "000C"},
+    /* 10 */ {"STOP", 2, 4, 4, "----"},
+    /* 11 */ {"LD DE,d16", 3, 12, 12, "----"},
+    /* 12 */ {"LD (DE),A", 1, 8, 8, "----"},
+    /* 13 */ {"INC DE", 1, 8, 8, "----"},
+    /* 14 */ {"INC D", 1, 4, 4, "Z0H-"},
+    /* 15 */ {"DEC D", 1, 4, 4, "Z1H-"},
+    /* 16 */ {"LD D,d8", 2, 8, 8, "----"},
+    /* 17 */ {"RLA", 1, 4, 4, "000C"},
+    /* 18 */ {"JR r8", 2, 12, 12, "----"},
+    /* 19 */ {"ADD HL,DE", 1, 8, 8, "-0HC"},
+    /* 1A */ {"LD A,(DE)", 1, 8, 8, "----"},
+    /* 1B */ {"DEC DE", 1, 8, 8, "----"},
+    /* 1C */ {"INC E", 1, 4, 4, "Z0H-"},
+    /* 1D */ {"DEC E", 1, 4, 4, "Z1H-"},
+    /* 1E */ {"LD E,d8", 2, 8, 8, "----"},
+    /* 1F */ {"RRA", 1, 4, 4, "000C"},
+    /* 20 */ {"JR NZ,r8", 2, 8, 12, "----"},
+    /* 21 */ {"LD HL,d16", 3, 12, 12, "----"},
+    /* 22 */ {"LD (HL+),A", 1, 8, 8, "----"},
+    /* 23 */ {"INC HL", 1, 8, 8, "----"},
+    /* 24 */ {"INC H", 1, 4, 4, "Z0H-"},
+    /* 25 */ {"DEC H", 1, 4, 4, "Z1H-"},
+    /* 26 */ {"LD H,d8", 2, 8, 8, "----"},
+    /* 27 */ {"DAA", 1, 4, 4, "Z-0C"},
+    /* 28 */ {"JR Z,r8", 2, 8, 12, "----"},
+    /* 29 */ {"ADD HL,HL", 1, 8, 8, "-0HC"},
+    /* 2A */ {"LD A,(HL+)", 1, 8, 8, "----"},
+    /* 2B */ {"DEC HL", 1, 8, 8, "----"},
+    /* 2C */ {"INC L", 1, 4, 4, "Z0H-"},
+    /* 2D */ {"DEC L", 1, 4, 4, "Z1H-"},
+    /* 2E */ {"LD L,d8", 2, 8, 8, "----"},
+    /* 2F */ {"CPL", 1, 4, 4, "-11-"},
+    /* 30 */ {"JR NC,r8", 2, 8, 12, "----"},
+    /* 31 */ {"LD SP,d16", 3, 12, 12, "----"},
+    /* 32 */ {"LD (HL-),A", 1, 8, 8, "----"},
+    /* 33 */ {"INC SP", 1, 8, 8, "----"},
+    /* 34 */ {"INC (HL)", 1, 12, 12, "Z0H-"},
+    /* 35 */ {"DEC (HL)", 1, 12, 12, "Z1H-"},
+    /* 36 */ {"LD (HL),d8", 2, 12, 12, "----"},
+    /* 37 */ {"SCF", 1, 4, 4, "-001"},
+    /* 38 */ {"JR C,r8", 2, 8, 12, "----"},
+    /* 39 */ {"ADD HL,SP", 1, 8, 8, "-0HC"},
+    /* 3A */ {"LD A,(HL-)", 1, 8, 8, "----"},
+    /* 3B */ {"DEC SP", 1, 8, 8, "----"},
+    /* 3C */ {"INC A", 1, 4, 4, "Z0H-"},
+    /* 3D */ {"DEC A", 1, 4, 4, "Z1H-"},
+    /* 3E */ {"LD A,d8", 2, 8, 8, "----"},
+    /* 3F */ {"CCF", 1, 4, 4, "-00C"},
+    /* 40 */ {"LD B,B", 1, 4, 4, "----"},
+    /* 41 */ {"LD B,C", 1, 4, 4, "----"},
+    /* 42 */ {"LD B,D", 1, 4, 4, "----"},
+    /* 43 */ {"LD B,E", 1, 4, 4, "----"},
+    /* 44 */ {"LD B,H", 1, 4, 4, "----"},
+    /* 45 */ {"LD B,L", 1, 4, 4, "----"},
+    /* 46 */ {"LD B,(HL)", 1, 8, 8, "----"},
+    /* 47 */ {"LD B,A", 1, 4, 4, "----"},
+    /* 48 */ {"LD C,B", 1, 4, 4, "----"},
+    /* 49 */ {"LD C,C", 1, 4, 4, "----"},
+    /* 4A */ {"LD C,D", 1, 4, 4, "----"},
+    /* 4B */ {"LD C,E", 1, 4, 4, "----"},
+    /* 4C */ {"LD C,H", 1, 4, 4, "----"},
+    /* 4D */ {"LD C,L", 1, 4, 4, "----"},
+    /* 4E */ {"LD C,(HL)", 1, 8, 8, "----"},
+    /* 4F */ {"LD C,A", 1, 4, 4, "----"},
+    /* 50 */ {"LD D,B", 1, 4, 4, "----"},
+    /* 51 */ {"LD D,C", 1, 4, 4, "----"},
+    /* 52 */ {"LD D,D", 1, 4, 4, "----"},
+    /* 53 */ {"LD D,E", 1, 4, 4, "----"},
+    /* 54 */ {"LD D,H", 1, 4, 4, "----"},
+    /* 55 */ {"LD D,L", 1, 4, 4, "----"},
+    /* 56 */ {"LD D,(HL)", 1, 8, 8, "----"},
+    /* 57 */ {"LD D,A", 1, 4, 4, "----"},
+    /* 58 */ {"LD E,B", 1, 4, 4, "----"},
+    /* 59 */ {"LD E,C", 1, 4, 4, "----"},
+    /* 5A */ {"LD E,D", 1, 4, 4, "----"},
+    /* 5B */ {"LD E,E", 1, 4, 4, "----"},
+    /* 5C */ {"LD E,H", 1, 4, 4, "----"},
+    /* 5D */ {"LD E,L", 1, 4, 4, "----"},
+    /* 5E */ {"LD E,(HL)", 1, 8, 8, "----"},
+    /* 5F */ {"LD E,A", 1, 4, 4, "----"},
+    /* 60 */ {"LD H,B", 1, 4, 4, "----"},
+    /* 61 */ {"LD H,C", 1, 4, 4, "----"},
+    /* 62 */ {"LD H,D", 1, 4, 4, "----"},
+    /* 63 */ {"LD H,E", 1, 4, 4, "----"},
+    /* 64 */ {"LD H,H", 1, 4, 4, "----"},
+    /* 65 */ {"LD H,L", 1, 4, 4, "----"},
+    /* 66 */ {"LD H,(HL)", 1, 8, 8, "----"},
+    /* 67 */ {"LD H,A", 1, 4, 4, "----"},
+    /* 68 */ {"LD L,B", 1, 4, 4, "----"},
+    /* 69 */ {"LD L,C", 1, 4, 4, "----"},
+    /* 6A */ {"LD L,D", 1, 4, 4, "----"},
+    /* 6B */ {"LD L,E", 1, 4, 4, "----"},
+    /* 6C */ {"LD L,H", 1, 4, 4, "----"},
+    /* 6D */ {"LD L,L", 1, 4, 4, "----"},
+    /* 6E */ {"LD L,(HL)", 1, 8, 8, "----"},
+    /* 6F */ {"LD L,A", 1, 4, 4, "----"},
+    /* 70 */ {"LD (HL),B", 1, 8, 8, "----"},
+    /* 71 */ {"LD (HL),C", 1, 8, 8, "----"},
+    /* 72 */ {"LD (HL),D", 1, 8, 8, "----"},
+    /* 73 */ {"LD (HL),E", 1, 8, 8, "----"},
+    /* 74 */ {"LD (HL),H", 1, 8, 8, "----"},
+    /* 75 */ {"LD (HL),L", 1, 8, 8, "----"},
+    /* 76 */ {"HALT", 1, 4, 4, "----"},
+    /* 77 */ {"LD (HL),A", 1, 8, 8, "----"},
+    /* 78 */ {"LD A,B", 1, 4, 4, "----"},
+    /* 79 */ {"LD A,C", 1, 4, 4, "----"},
+    /* 7A */ {"LD A,D", 1, 4, 4, "----"},
+    /* 7B */ {"LD A,E", 1, 4, 4, "----"},
+    /* 7C */ {"LD A,H", 1, 4, 4, "----"},
+    /* 7D */ {"LD A,L", 1, 4, 4, "----"},
+    /* 7E */ {"LD A,(HL)", 1, 8, 8, "----"},
+    /* 7F */ {"LD A,A", 1, 4, 4, "----"},
+    /* 80 */ {"ADD A,B", 1, 4, 4, "Z0HC"},
+    /* 81 */ {"ADD A,C", 1, 4, 4, "Z0HC"},
+    /* 82 */ {"ADD A,D", 1, 4, 4, "Z0HC"},
+    /* 83 */ {"ADD A,E", 1, 4, 4, "Z0HC"},
+    /* 84 */ {"ADD A,H", 1, 4, 4, "Z0HC"},
+    /* 85 */ {"ADD A,L", 1, 4, 4, "Z0HC"},
+    /* 86 */ {"ADD A,(HL)", 1, 8, 8, "Z0HC"},
+    /* 87 */ {"ADD A,A", 1, 4, 4, "Z0HC"},
+    /* 88 */ {"ADC A,B", 1, 4, 4, "Z0HC"},
+    /* 89 */ {"ADC A,C", 1, 4, 4, "Z0HC"},
+    /* 8A */ {"ADC A,D", 1, 4, 4, "Z0HC"},
+    /* 8B */ {"ADC A,E", 1, 4, 4, "Z0HC"},
+    /* 8C */ {"ADC A,H", 1, 4, 4, "Z0HC"},
+    /* 8D */ {"ADC A,L", 1, 4, 4, "Z0HC"},
+    /* 8E */ {"ADC A,(HL)", 1, 8, 8, "Z0HC"},
+    /* 8F */ {"ADC A,A", 1, 4, 4, "Z0HC"},
+    /* 90 */ {"SUB B", 1, 4, 4, "Z1HC"},
+    /* 91 */ {"SUB C", 1, 4, 4, "Z1HC"},
+    /* 92 */ {"SUB D", 1, 4, 4, "Z1HC"},
+    /* 93 */ {"SUB E", 1, 4, 4, "Z1HC"},
+    /* 94 */ {"SUB H", 1, 4, 4, "Z1HC"},
+    /* 95 */ {"SUB L", 1, 4, 4, "Z1HC"},
+    /* 96 */ {"SUB (HL)", 1, 8, 8, "Z1HC"},
+    /* 97 */ {"SUB A", 1, 4, 4, "Z1HC"},
+    /* 98 */ {"SBC A,B", 1, 4, 4, "Z1HC"},
+    /* 99 */ {"SBC A,C", 1, 4, 4, "Z1HC"},
+    /* 9A */ {"SBC A,D", 1, 4, 4, "Z1HC"},
+    /* 9B */ {"SBC A,E", 1, 4, 4, "Z1HC"},
+    /* 9C */ {"SBC A,H", 1, 4, 4, "Z1HC"},
+    /* 9D */ {"SBC A,L", 1, 4, 4, "Z1HC"},
+    /* 9E */ {"SBC A,(HL)", 1, 8, 8, "Z1HC"},
+    /* 9F */ {"SBC A,A", 1, 4, 4, "Z1HC"},
+    /* A0 */ {"AND B", 1, 4, 4, "Z010"},
+    /* A1 */ {"AND C", 1, 4, 4, "Z010"},
+    /* A2 */ {"AND D", 1, 4, 4, "Z010"},
+    /* A3 */ {"AND E", 1, 4, 4, "Z010"},
+    /* A4 */ {"AND H", 1, 4, 4, "Z010"},
+    /* A5 */ {"AND L", 1, 4, 4, "Z010"},
+    /* A6 */ {"AND (HL)", 1, 8, 8, "Z010"},
+    /* A7 */ {"AND A", 1, 4, 4, "Z010"},
+    /* A8 */ {"XOR B", 1, 4, 4, "Z000"},
+    /* A9 */ {"XOR C", 1, 4, 4, "Z000"},
+    /* AA */ {"XOR D", 1, 4, 4, "Z000"},
+    /* AB */ {"XOR E", 1, 4, 4, "Z000"},
+    /* AC */ {"XOR H", 1, 4, 4, "Z000"},
+    /* AD */ {"XOR L", 1, 4, 4, "Z000"},
+    /* AE */ {"XOR (HL)", 1, 8, 8, "Z000"},
+    /* AF */ {"XOR A", 1, 4, 4, "Z000"},
+    /* B0 */ {"OR B", 1, 4, 4, "Z000"},
+    /* B1 */ {"OR C", 1, 4, 4, "Z000"},
+    /* B2 */ {"OR D", 1, 4, 4, "Z000"},
+    /* B3 */ {"OR E", 1, 4, 4, "Z000"},
+    /* B4 */ {"OR H", 1, 4, 4, "Z000"},
+    /* B5 */ {"OR L", 1, 4, 4, "Z000"},
+    /* B6 */ {"OR (HL)", 1, 8, 8, "Z000"},
+    /* B7 */ {"OR A", 1, 4, 4, "Z000"},
+    /* B8 */ {"CP B", 1, 4, 4, "Z1HC"},
+    /* B9 */ {"CP C", 1, 4, 4, "Z1HC"},
+    /* BA */ {"CP D", 1, 4, 4, "Z1HC"},
+    /* BB */ {"CP E", 1, 4, 4, "Z1HC"},
+    /* BC */ {"CP H", 1, 4, 4, "Z1HC"},
+    /* BD */ {"CP L", 1, 4, 4, "Z1HC"},
+    /* BE */ {"CP (HL)", 1, 8, 8, "Z1HC"},
+    /* BF */ {"CP A", 1, 4, 4, "Z1HC"},
+    /* C0 */ {"RET NZ", 1, 8, 20, "----"},
+    /* C1 */ {"POP BC", 1, 12, 12, "----"},
+    /* C2 */ {"JP NZ,a16", 3, 12, 16, "----"},
+    /* C3 */ {"JP a16", 3, 16, 16, "----"},
+    /* C4 */ {"CALL NZ,a16", 3, 12, 24, "----"},
+    /* C5 */ {"PUSH BC", 1, 16, 16, "----"},
+    /* C6 */ {"ADD A,d8", 2, 8, 8, "Z0HC"},
+    /* C7 */ {"RST 00H", 1, 16, 16, "----"},
+    /* C8 */ {"RET Z", 1, 8, 20, "----"},
+    /* C9 */ {"RET", 1, 16, 16, "----"},
+    /* CA */ {"JP Z,a16", 3, 12, 16, "----"},
+    /* CB */ {"PREFIX CB", 1, 4, 4, "----"},
+    /* CC */ {"CALL Z,a16", 3, 12, 24, "----"},
+    /* CD */ {"CALL a16", 3, 24, 24, "----"},
+    /* CE */ {"ADC A,d8", 2, 8, 8, "Z0HC"},
+    /* CF */ {"RST 08H", 1, 16, 16, "----"},
+    /* D0 */ {"RET NC", 1, 8, 20, "----"},
+    /* D1 */ {"POP DE", 1, 12, 12, "----"},
+    /* D2 */ {"JP NC,a16", 3, 12, 16, "----"},
+    /* D3 */ {nullptr, 1, 0, 0, "----"},
+    /* D4 */ {"CALL NC,a16", 3, 12, 24, "----"},
+    /* D5 */ {"PUSH DE", 1, 16, 16, "----"},
+    /* D6 */ {"SUB d8", 2, 8, 8, "Z1HC"},
+    /* D7 */ {"RST 10H", 1, 16, 16, "----"},
+    /* D8 */ {"RET C", 1, 8, 20, "----"},
+    /* D9 */ {"RETI", 1, 16, 16, "----"},
+    /* DA */ {"JP C,a16", 3, 12, 16, "----"},
+    /* DB */ {nullptr, 1, 0, 0, "----"},
+    /* DC */ {"CALL C,a16", 3, 12, 24, "----"},
+    /* DD */ {nullptr, 1, 0, 0, "----"},
+    /* DE */ {"SBC A,d8", 2, 8, 8, "Z1HC"},
+    /* DF */ {"RST 18H", 1, 16, 16, "----"},
+    /* E0 */ {"LDH (a8),A", 2, 12, 12, "----"},
+    /* E1 */ {"POP HL", 1, 12, 12, "----"},
+    /* E2 */ {"LD (C),A", 1, 8, 8, "----"},
+    /* E3 */ {nullptr, 1, 0, 0, "----"},
+    /* E4 */ {nullptr, 1, 0, 0, "----"},
+    /* E5 */ {"PUSH HL", 1, 16, 16, "----"},
+    /* E6 */ {"AND d8", 2, 8, 8, "Z010"},
+    /* E7 */ {"RST 20H", 1, 16, 16, "----"},
+    /* E8 */ {"ADD SP,r8", 2, 16, 16, "00HC"},
+    /* E9 */ {"JP HL", 1, 4, 4, "----"},
+    /* EA */ {"LD (a16),A", 3, 16, 16, "----"},
+    /* EB */ {nullptr, 1, 0, 0, "----"},
+    /* EC */ {nullptr, 1, 0, 0, "----"},
+    /* ED */ {nullptr, 1, 0, 0, "----"},
+    /* EE */ {"XOR d8", 2, 8, 8, "Z000"},
+    /* EF */ {"RST 28H", 1, 16, 16, "----"},
+    /* F0 */ {"LDH A,(a8)", 2, 12, 12, "----"},
+    /* F1 */ {"POP AF", 1, 12, 12, "ZNHC"},
+    /* F2 */ {"LD A,(C)", 1, 8, 8, "----"},
+    /* F3 */ {"DI", 1, 4, 4, "----"},
+    /* F4 */ {nullptr, 1, 0, 0, "----"},
+    /* F5 */ {"PUSH AF", 1, 16, 16, "----"},
+    /* F6 */ {"OR d8", 2, 8, 8, "Z000"},
+    /* F7 */ {"RST 30H", 1, 16, 16, "----"},
+    /* F8 */ {"LD HL,SP+r8", 2, 12, 12, "00HC"},
+    /* F9 */ {"LD SP,HL", 1, 8, 8, "----"},
+    /* FA */ {"LD A,(a16)", 3, 16, 16, "----"},
+    /* FB */ {"EI", 1, 4, 4, "----"},
+    /* FC */ {nullptr, 1, 0, 0, "----"},
+    /* FD */ {nullptr, 1, 0, 0, "----"},
+    /* FE */ {"CP d8", 2, 8, 8, "Z1HC"},
+    /* FF */ {"RST 38H", 1, 16, 16, "----"}
+};
+
+// Op codes following CB_PREFIX, indexed by the second byte
+static constexpr OpCodeInfo CB_OP_CODE_INFO[256] = {
+    /* 00 */ {"RLC B", 2, 8, 8, "Z00C"},
+    /* 01 */ {"RLC C", 2, 8, 8, "Z00C"},
+    /* 02 */ {"RLC D", 2, 8, 8, "Z00C"},
+    /* 03 */ {"RLC E", 2, 8, 8, "Z00C"},
+    /* 04 */ {"RLC H", 2, 8, 8, "Z00C"},
+    /* 05 */ {"RLC L", 2, 8, 8, "Z00C"},
+    /* 06 */ {"RLC (HL)", 2, 16, 16, "Z00C"},
+    /* 07 */ {"RLC A", 2, 8, 8, "Z00C"},
+    /* 08 */ {"RRC B", 2, 8, 8, "Z00C"},
+    /* 09 */ {"RRC C", 2, 8, 8, "Z00C"},
+    /* 0A */ {"RRC D", 2, 8, 8, "Z00C"},
+    /* 0B */ {"RRC E", 2, 8, 8, "Z00C"},
+    /* 0C */ {"RRC H", 2, 8, 8, "Z00C"},
+    /* 0D */ {"RRC L", 2, 8, 8, "Z00C"},
+    /* 0E */ {"RRC (HL)", 2, 16, 16, "Z00C"},
+    /* 0F */ {"RRC A", 2, 8, 8, "Z00C"},
+    /* 10 */ {"RL B", 2, 8, 8, "Z00C"},
+    /* 11 */ {"RL C", 2, 8, 8, "Z00C"},
+    /* 12 */ {"RL D", 2, 8, 8, "Z00C"},
+    /* 13 */ {"RL E", 2, 8, 8, "Z00C"},
+    /* 14 */ {"RL H", 2, 8, 8, "Z00C"},
+    /* 15 */ {"RL L", 2, 8, 8, "Z00C"},
+    /* 16 */ {"RL (HL)", 2, 16, 16, "Z00C"},
+    /* 17 */ {"RL A", 2, 8, 8, "Z00C"},
+    /* 18 */ {"RR B", 2, 8, 8, "Z00C"},
+    /* 19 */ {"RR C", 2, 8, 8, "Z00C"},
+    /* 1A */ {"RR D", 2, 8, 8, "Z00C"},
+    /* 1B */ {"RR E", 2, 8, 8, "Z00C"},
+    /* 1C */ {"RR H", 2, 8, 8, "Z00C"},
+    /* 1D */ {"RR L", 2, 8, 8, "Z00C"},
+    /* 1E */ {"RR (HL)", 2, 16, 16, "Z00C"},
+    /* 1F */ {"RR A", 2, 8, 8, "Z00C"},
+    /* 20 */ {"SLA B", 2, 8, 8, "Z00C"},
+    /* 21 */ {"SLA C", 2, 8, 8, "Z00C"},
+    /* 22 */ {"SLA D", 2, 8, 8, "Z00C"},
+    /* 23 */ {"SLA E", 2, 8, 8, "Z00C"},
+    /* 24 */ {"SLA H", 2, 8, 8, "Z00C"},
+    /* 25 */ {"SLA L", 2, 8, 8, "Z00C"},
+    /* 26 */ {"SLA (HL)", 2, 16, 16, "Z00C"},
+    /* 27 */ {"SLA A", 2, 8, 8, "Z00C"},
+    /* 28 */ {"SRA B", 2, 8, 8, "Z00C"},
+    /* 29 */ {"SRA C", 2, 8, 8, "Z00C"},
+    /* 2A */ {"SRA D", 2, 8, 8, "Z00C"},
+    /* 2B */ {"SRA E", 2, 8, 8, "Z00C"},
+    /* 2C */ {"SRA H", 2, 8, 8, "Z00C"},
+    /* 2D */ {"SRA L", 2, 8, 8, "Z00C"},
+    /* 2E */ {"SRA (HL)", 2, 16, 16, "Z00C"},
+    /* 2F */ {"SRA A", 2, 8, 8, "Z00C"},
+    /* 30 */ {"SWAP B", 2, 8, 8, "Z000"},
+    /* 31 */ {"SWAP C", 2, 8, 8, "Z000"},
+    /* 32 */ {"SWAP D", 2, 8, 8, "Z000"},
+    /* 33 */ {"SWAP E", 2, 8, 8, "Z000"},
+    /* 34 */ {"SWAP H", 2, 8, 8, "Z000"},
+    /* 35 */ {"SWAP L", 2, 8, 8, "Z000"},
+    /* 36 */ {"SWAP (HL)", 2, 16, 16, "Z000"},
+    /* 37 */ {"SWAP A", 2, 8, 8, "Z000"},
+    /* 38 */ {"SRL B", 2, 8, 8, "Z00C"},
+    /* 39 */ {"SRL C", 2, 8, 8, "Z00C"},
+    /* 3A */ {"SRL D", 2, 8, 8, "Z00C"},
+    /* 3B */ {"SRL E", 2, 8, 8, "Z00C"},
+    /* 3C */ {"SRL H", 2, 8, 8, "Z00C"},
+    /* 3D */ {"SRL L", 2, 8, 8, "Z00C"},
+    /* 3E */ {"SRL (HL)", 2, 16, 16, "Z00C"},
+    /* 3F */ {"SRL A", 2, 8, 8, "Z00C"},
+    /* 40 */ {"BIT 0,B", 2, 8, 8, "Z01-"},
+    /* 41 */ {"BIT 0,C", 2, 8, 8, "Z01-"},
+    /* 42 */ {"BIT 0,D", 2, 8, 8, "Z01-"},
+    /* 43 */ {"BIT 0,E", 2, 8, 8, "Z01-"},
+    /* 44 */ {"BIT 0,H", 2, 8, 8, "Z01-"},
+    /* 45 */ {"BIT 0,L", 2, 8, 8, "Z01-"},
+    /* 46 */ {"BIT 0,(HL)", 2, 12, 12, "Z01-"},
+    /* 47 */ {"BIT 0,A", 2, 8, 8, "Z01-"},
+    /* 48 */ {"BIT 1,B", 2, 8, 8, "Z01-"},
+    /* 49 */ {"BIT 1,C", 2, 8, 8, "Z01-"},
+    /* 4A */ {"BIT 1,D", 2, 8, 8, "Z01-"},
+    /* 4B */ {"BIT 1,E", 2, 8, 8, "Z01-"},
+    /* 4C */ {"BIT 1,H", 2, 8, 8, "Z01-"},
+    /* 4D */ {"BIT 1,L", 2, 8, 8, "Z01-"},
+    /* 4E */ {"BIT 1,(HL)", 2, 12, 12, "Z01-"},
+    /* 4F */ {"BIT 1,A", 2, 8, 8, "Z01-"},
+    /* 50 */ {"BIT 2,B", 2, 8, 8, "Z01-"},
+    /* 51 */ {"BIT 2,C", 2, 8, 8, "Z01-"},
+    /* 52 */ {"BIT 2,D", 2, 8, 8, "Z01-"},
+    /* 53 */ {"BIT 2,E", 2, 8, 8, "Z01-"},
+    /* 54 */ {"BIT 2,H", 2, 8, 8, "Z01-"},
+    /* 55 */ {"BIT 2,L", 2, 8, 8, "Z01-"},
+    /* 56 */ {"BIT 2,(HL)", 2, 12, 12, "Z01-"},
+    /* 57 */ {"BIT 2,A", 2, 8, 8, "Z01-"},
+    /* 58 */ {"BIT 3,B", 2, 8, 8, "Z01-"},
+    /* 59 */ {"BIT 3,C", 2, 8, 8, "Z01-"},
+    /* 5A */ {"BIT 3,D", 2, 8, 8, "Z01-"},
+    /* 5B */ {"BIT 3,E", 2, 8, 8, "Z01-"},
+    /* 5C */ {"BIT 3,H", 2, 8, 8, "Z01-"},
+    /* 5D */ {"BIT 3,L", 2, 8, 8, "Z01-"},
+    /* 5E */ {"BIT 3,(HL)", 2, 12, 12, "Z01-"},
+    /* 5F */ {"BIT 3,A", 2, 8, 8, "Z01-"},
+    /* 60 */ {"BIT 4,B", 2, 8, 8, "Z01-"},
+    /* 61 */ {"BIT 4,C", 2, 8, 8, "Z01-"},
+    /* 62 */ {"BIT 4,D", 2, 8, 8, "Z01-"},
+    /* 63 */ {"BIT 4,E", 2, 8, 8, "Z01-"},
+    /* 64 */ {"BIT 4,H", 2, 8, 8, "Z01-"},
+    /* 65 */ {"BIT 4,L", 2, 8, 8, "Z01-"},
+    /* 66 */ {"BIT 4,(HL)", 2, 12, 12, "Z01-"},
+    /* 67 */ {"BIT 4,A", 2, 8, 8, "Z01-"},
+    /* 68 */ {"BIT 5,B", 2, 8, 8, "Z01-"},
+    /* 69 */ {"BIT 5,C", 2, 8, 8, "Z01-"},
+    /* 6A */ {"BIT 5,D", 2, 8, 8, "Z01-"},
+    /* 6B */ {"BIT 5,E", 2, 8, 8, "Z01-"},
+    /* 6C */ {"BIT 5,H", 2, 8, 8, "Z01-"},
+    /* 6D */ {"BIT 5,L", 2, 8, 8, "Z01-"},
+    /* 6E */ {"BIT 5,(HL)", 2, 12, 12, "Z01-"},
+    /* 6F */ {"BIT 5,A", 2, 8, 8, "Z01-"},
+    /* 70 */ {"BIT 6,B", 2, 8, 8, "Z01-"},
+    /* 71 */ {"BIT 6,C", 2, 8, 8, "Z01-"},
+    /* 72 */ {"BIT 6,D", 2, 8, 8, "Z01-"},
+    /* 73 */ {"BIT 6,E", 2, 8, 8, "Z01-"},
+    /* 74 */ {"BIT 6,H", 2, 8, 8, "Z01-"},
+    /* 75 */ {"BIT 6,L", 2, 8, 8, "Z01-"},
+    /* 76 */ {"BIT 6,(HL)", 2, 12, 12, "Z01-"},
+    /* 77 */ {"BIT 6,A", 2, 8, 8, "Z01-"},
+    /* 78 */ {"BIT 7,B", 2, 8, 8, "Z01-"},
+    /* 79 */ {"BIT 7,C", 2, 8, 8, "Z01-"},
+    /* 7A */ {"BIT 7,D", 2, 8, 8, "Z01-"},
+    /* 7B */ {"BIT 7,E", 2, 8, 8, "Z01-"},
+    /* 7C */ {"BIT 7,H", 2, 8, 8, "Z01-"},
+    /* 7D */ {"BIT 7,L", 2, 8, 8, "Z01-"},
+    /* 7E */ {"BIT 7,(HL)", 2, 12, 12, "Z01-"},
+    /* 7F */ {"BIT 7,A", 2, 8, 8, "Z01-"},
+    /* 80 */ {"RES 0,B", 2, 8, 8, "----"},
+    /* 81 */ {"RES 0,C", 2, 8, 8, "----"},
+    /* 82 */ {"RES 0,D", 2, 8, 8, "----"},
+    /* 83 */ {"RES 0,E", 2, 8, 8, "----"},
+    /* 84 */ {"RES 0,H", 2, 8, 8, "----"},
+    /* 85 */ {"RES 0,L", 2, 8, 8, "----"},
+    /* 86 */ {"RES 0,(HL)", 2, 16, 16, "----"},
+    /* 87 */ {"RES 0,A", 2, 8, 8, "----"},
+    /* 88 */ {"RES 1,B", 2, 8, 8, "----"},
+    /* 89 */ {"RES 1,C", 2, 8, 8, "----"},
+    /* 8A */ {"RES 1,D", 2, 8, 8, "----"},
+    /* 8B */ {"RES 1,E", 2, 8, 8, "----"},
+    /* 8C */ {"RES 1,H", 2, 8, 8, "----"},
+    /* 8D */ {"RES 1,L", 2, 8, 8, "----"},
+    /* 8E */ {"RES 1,(HL)", 2, 16, 16, "----"},
+    /* 8F */ {"RES 1,A", 2, 8, 8, "----"},
+    /* 90 */ {"RES 2,B", 2, 8, 8, "----"},
+    /* 91 */ {"RES 2,C", 2, 8, 8, "----"},
+    /* 92 */ {"RES 2,D", 2, 8, 8, "----"},
+    /* 93 */ {"RES 2,E", 2, 8, 8, "----"},
+    /* 94 */ {"RES 2,H", 2, 8, 8, "----"},
+    /* 95 */ {"RES 2,L", 2, 8, 8, "----"},
+    /* 96 */ {"RES 2,(HL)", 2, 16, 16, "----"},
+    /* 97 */ {"RES 2,A", 2, 8, 8, "----"},
+    /* 98 */ {"RES 3,B", 2, 8, 8, "----"},
+    /* 99 */ {"RES 3,C", 2, 8, 8, "----"},
+    /* 9A */ {"RES 3,D", 2, 8, 8, "----"},
+    /* 9B */ {"RES 3,E", 2, 8, 8, "----"},
+    /* 9C */ {"RES 3,H", 2, 8, 8, "----"},
+    /* 9D */ {"RES 3,L", 2, 8, 8, "----"},
+    /* 9E */ {"RES 3,(HL)", 2, 16, 16, "----"},
+    /* 9F */ {"RES 3,A", 2, 8, 8, "----"},
+    /* A0 */ {"RES 4,B", 2, 8, 8, "----"},
+    /* A1 */ {"RES 4,C", 2, 8, 8, "----"},
+    /* A2 */ {"RES 4,D", 2, 8, 8, "----"},
+    /* A3 */ {"RES 4,E", 2, 8, 8, "----"},
+    /* A4 */ {"RES 4,H", 2, 8, 8, "----"},
+    /* A5 */ {"RES 4,L", 2, 8, 8, "----"},
+    /* A6 */ {"RES 4,(HL)", 2, 16, 16, "----"},
+    /* A7 */ {"RES 4,A", 2, 8, 8, "----"},
+    /* A8 */ {"RES 5,B", 2, 8, 8, "----"},
+    /* A9 */ {"RES 5,C", 2, 8, 8, "----"},
+    /* AA */ {"RES 5,D", 2, 8, 8, "----"},
+    /* AB */ {"RES 5,E", 2, 8, 8, "----"},
+    /* AC */ {"RES 5,H", 2, 8, 8, "----"},
+    /* AD */ {"RES 5,L", 2, 8, 8, "----"},
+    /* AE */ {"RES 5,(HL)", 2, 16, 16, "----"},
+    /* AF */ {"RES 5,A", 2, 8, 8, "----"},
+    /* B0 */ {"RES 6,B", 2, 8, 8, "----"},
+    /* B1 */ {"RES 6,C", 2, 8, 8, "----"},
+    /* B2 */ {"RES 6,D", 2, 8, 8, "----"},
+    /* B3 */ {"RES 6,E", 2, 8, 8, "----"},
+    /* B4 */ {"RES 6,H", 2, 8, 8, "----"},
+    /* B5 */ {"RES 6,L", 2, 8, 8, "----"},
+    /* B6 */ {"RES 6,(HL)", 2, 16, 16, "----"},
+    /* B7 */ {"RES 6,A", 2, 8, 8, "----"},
+    /* B8 */ {"RES 7,B", 2, 8, 8, "----"},
+    /* B9 */ {"RES 7,C", 2, 8, 8, "----"},
+    /* BA */ {"RES 7,D", 2, 8, 8, "----"},
+    /* BB */ {"RES 7,E", 2, 8, 8, "----"},
+    /* BC */ {"RES 7,H", 2, 8, 8, "----"},
+    /* BD */ {"RES 7,L", 2, 8, 8, "----"},
+    /* BE */ {"RES 7,(HL)", 2, 16, 16, "----"},
+    /* BF */ {"RES 7,A", 2, 8, 8, "----"},
+    /* C0 */ {"SET 0,B", 2, 8, 8, "----"},
+    /* C1 */ {"SET 0,C", 2, 8, 8, "----"},
+    /* C2 */ {"SET 0,D", 2, 8, 8, "----"},
+    /* C3 */ {"SET 0,E", 2, 8, 8, "----"},
+    /* C4 */ {"SET 0,H", 2, 8, 8, "----"},
+    /* C5 */ {"SET 0,L", 2, 8, 8, "----"},
+    /* C6 */ {"SET 0,(HL)", 2, 16, 16, "----"},
+    /* C7 */ {"SET 0,A", 2, 8, 8, "----"},
+    /* C8 */ {"SET 1,B", 2, 8, 8, "----"},
+    /* C9 */ {"SET 1,C", 2, 8, 8, "----"},
+    /* CA */ {"SET 1,D", 2, 8, 8, "----"},
+    /* CB */ {"SET 1,E", 2, 8, 8, "----"},
+    /* CC */ {"SET 1,H", 2, 8, 8, "----"},
+    /* CD */ {"SET 1,L", 2, 8, 8, "----"},
+    /* CE */ {"SET 1,(HL)", 2, 16, 16, "----"},
+    /* CF */ {"SET 1,A", 2, 8, 8, "----"},
+    /* D0 */ {"SET 2,B", 2, 8, 8, "----"},
+    /* D1 */ {"SET 2,C", 2, 8, 8, "----"},
+    /* D2 */ {"SET 2,D", 2, 8, 8, "----"},
+    /* D3 */ {"SET 2,E", 2, 8, 8, "----"},
+    /* D4 */ {"SET 2,H", 2, 8, 8, "----"},
+    /* D5 */ {"SET 2,L", 2, 8, 8, "----"},
+    /* D6 */ {"SET 2,(HL)", 2, 16, 16, "----"},
+    /* D7 */ {"SET 2,A", 2, 8, 8, "----"},
+    /* D8 */ {"SET 3,B", 2, 8, 8, "----"},
+    /* D9 */ {"SET 3,C", 2, 8, 8, "----"},
+    /* DA */ {"SET 3,D", 2, 8, 8, "----"},
+    /* DB */ {"SET 3,E", 2, 8, 8, "----"},
+    /* DC */ {"SET 3,H", 2, 8, 8, "----"},
+    /* DD */ {"SET 3,L", 2, 8, 8, "----"},
+    /* DE */ {"SET 3,(HL)", 2, 16, 16, "----"},
+    /* DF */ {"SET 3,A", 2, 8, 8, "----"},
+    /* E0 */ {"SET 4,B", 2, 8, 8, "----"},
+    /* E1 */ {"SET 4,C", 2, 8, 8, "----"},
+    /* E2 */ {"SET 4,D", 2, 8, 8, "----"},
+    /* E3 */ {"SET 4,E", 2, 8, 8, "----"},
+    /* E4 */ {"SET 4,H", 2, 8, 8, "----"},
+    /* E5 */ {"SET 4,L", 2, 8, 8, "----"},
+    /* E6 */ {"SET 4,(HL)", 2, 16, 16, "----"},
+    /* E7 */ {"SET 4,A", 2, 8, 8, "----"},
+    /* E8 */ {"SET 5,B", 2, 8, 8, "----"},
+    /* E9 */ {"SET 5,C", 2, 8, 8, "----"},
+    /* EA */ {"SET 5,D", 2, 8, 8, "----"},
+    /* EB */ {"SET 5,E", 2, 8, 8, "----"},
+    /* EC */ {"SET 5,H", 2, 8, 8, "----"},
+    /* ED */ {"SET 5,L", 2, 8, 8, "----"},
+    /* EE */ {"SET 5,(HL)", 2, 16, 16, "----"},
+    /* EF */ {"SET 5,A", 2, 8, 8, "----"},
+    /* F0 */ {"SET 6,B", 2, 8, 8, "----"},
+    /* F1 */ {"SET 6,C", 2, 8, 8, "----"},
+    /* F2 */ {"SET 6,D", 2, 8, 8, "----"},
+    /* F3 */ {"SET 6,E", 2, 8, 8, "----"},
+    /* F4 */ {"SET 6,H", 2, 8, 8, "----"},
+    /* F5 */ {"SET 6,L", 2, 8, 8, "----"},
+    /* F6 */ {"SET 6,(HL)", 2, 16, 16, "----"},
+    /* F7 */ {"SET 6,A", 2, 8, 8, "----"},
+    /* F8 */ {"SET 7,B", 2, 8, 8, "----"},
+    /* F9 */ {"SET 7,C", 2, 8, 8, "----"},
+    /* FA */ {"SET 7,D", 2, 8, 8, "----"},
+    /* FB */ {"SET 7,E", 2, 8, 8, "----"},
+    /* FC */ {"SET 7,H", 2, 8, 8, "----"},
+    /* FD */ {"SET 7,L", 2, 8, 8, "----"},
+    /* FE */ {"SET 7,(HL)", 2, 16, 16, "----"},
+    /* FF */ {"SET 7,A", 2, 8, 8, "----"}
+};
+
+/**
+ * @brief Gets the description of a primary op code
+ *
+ * @param op_code The op code
+ * @return const OpCodeInfo& The description. CB_PREFIX describes the prefix byte alone
+ */
+constexpr const OpCodeInfo& OpCodeInfoFor(uint8_t op_code) {
+    return OP_CODE_INFO[op_code];
+}
+
+/**
+ * @brief Gets the description of an op code following the CB prefix
+ *
+ * @param op_code The byte after the prefix
+ */
+constexpr const OpCodeInfo& CBOpCodeInfoFor(uint8_t op_code) {
+    return CB_OP_CODE_INFO[op_code];
+}
+
+/**
+ * @brief Gets whether some text appears in a mnemonic, at compile time
+ *
+ * @param mnemonic The mnemonic
+ * @param text The text to look for
+ */
+constexpr bool MnemonicContains(const char* mnemonic, const char* text) {
+    for (int i = 0; mnemonic[i] != '\0'; i++) {
+        int j = 0;
+        while (text[j] != '\0' && mnemonic[i + j] == text[j]) {
+            j++;
+        }
+        if (text[j] == '\0') {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Gets whether a mnemonic starts with some text, at compile time
+ *
+ * @param mnemonic The mnemonic
+ * @param text The prefix
+ */
+constexpr bool MnemonicStartsWith(const char* mnemonic, const char* text) {
+    int i = 0;
+    while (text[i] != '\0' && mnemonic[i] == text[i]) {
+        i++;
+    }
+    return text[i] == '\0';
+}
+
+/**
+ * @brief Gets the length an op code's operands imply, so the table can be checked against its mnemonics
+ *
+ * @param info The op code's description
+ * @param cb true for an op code following CB_PREFIX
+ * @return uint8_t The expected length in bytes
+ */
+constexpr uint8_t ExpectedLength(const OpCodeInfo& info, bool cb) {
+    if (info.mnemonic == nullptr) {
+        return 1;
+    }
+    if (cb) {
+        return 2;
+    }
+    if (MnemonicContains(info.mnemonic, "d16") || MnemonicContains(info.mnemonic, "a16")) {
+        return 3;
+    }
+    // STOP is followed by a byte the CPU skips
+    if (MnemonicContains(info.mnemonic, "d8") || MnemonicContains(info.mnemonic, "a8") ||
+        MnemonicContains(info.mnemonic, "r8") || MnemonicStartsWith(info.mnemonic, "STOP")) {
+        return 2;
+    }
+    return 1;
+}
+
+/**
+ * @brief Gets whether an op code is a jump, call or return that tests a flag
+ *
+ * @param info The op code's description
+ */
+constexpr bool IsConditionalBranch(const OpCodeInfo& info) {
+    if (info.mnemonic == nullptr) {
+        return false;
+    }
+
+    int operand = 0;
+    if (MnemonicStartsWith(info.mnemonic, "JR ") || MnemonicStartsWith(info.mnemonic, "JP ") ||
+        MnemonicStartsWith(info.mnemonic, "RET ")) {
+        operand = MnemonicStartsWith(info.mnemonic, "RET ") ? 4 : 3;
+    } else if (MnemonicStartsWith(info.mnemonic, "CALL ")) {
+        operand = 5;
+    } else {
+        return false;
+    }
+
+    // The condition is the first operand, a flag name optionally preceded by N
+    const char* condition = info.mnemonic + operand;
+    int flag = condition[0] == 'N' ? 1 : 0;
+    if (condition[flag] != 'Z' && condition[flag] != 'C') {
+        return false;
+    }
+    return condition[flag + 1] == ',' || condition[flag + 1] == '\0';
+}
+
+/**
+ * @brief Gets whether every length in a table matches the operands of its mnemonic
+ *
+ * @param table OP_CODE_INFO or CB_OP_CODE_INFO
+ * @param cb true for CB_OP_CODE_INFO
+ */
+constexpr bool LengthsMatchOperands(const OpCodeInfo (&table)[256], bool cb) {
+    for (int op_code = 0; op_code < 256; op_code++) {
+        if (table[op_code].length != ExpectedLength(table[op_code], cb)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Gets whether every op code in a table takes whole machine cycles, and defined ones take at least one
+ *
+ * @param table OP_CODE_INFO or CB_OP_CODE_INFO
+ */
+constexpr bool CyclesAreMachineCycles(const OpCodeInfo (&table)[256]) {
+    for (int op_code = 0; op_code < 256; op_code++) {
+        const OpCodeInfo& info = table[op_code];
+        if (info.cycles % 4 != 0 || info.branch_cycles % 4 != 0) {
+            return false;
+        }
+        if (info.mnemonic != nullptr && info.cycles == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Gets whether exactly the conditional branches of a table take longer when taken
+ *
+ * @param table OP_CODE_INFO or CB_OP_CODE_INFO
+ */
+constexpr bool BranchCyclesMatchConditions(const OpCodeInfo (&table)[256]) {
+    for (int op_code = 0; op_code < 256; op_code++) {
+        const OpCodeInfo& info = table[op_code];
+        if (IsConditionalBranch(info) ? info.branch_cycles <= info.cycles : info.branch_cycles != info.cycles) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Gets whether every flags string in a table names Z, N, H and C with a letter, 0, 1 or -
+ *
+ * @param table OP_CODE_INFO or CB_OP_CODE_INFO
+ */
+constexpr bool FlagsAreWellFormed(const OpCodeInfo (&table)[256]) {
+    const char letters[] = {'Z', 'N', 'H', 'C'};
+    for (int op_code = 0; op_code < 256; op_code++) {
+        const char* flags = table[op_code].flags;
+        for (int i = 0; i < 4; i++) {
+            if (flags[i] != letters[i] && flags[i] != '0' && flags[i] != '1' && flags[i] != '-') {
+                return false;
+            }
+        }
+        if (flags[4] != '\0') {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Gets whether the CB table's cycles follow its operand: 8 for registers, 16 through (HL) and
+ * 12 for BIT, which reads (HL) without writing it back
+ *
+ */
+constexpr bool CBCyclesMatchOperands() {
+    for (int op_code = 0; op_code < 256; op_code++) {
+        uint8_t expected = 8;
+        if ((op_code & 7) == 6) {
+            expected = (op_code >> 6) == 1 ? 12 : 16;
+        }
+        if (CB_OP_CODE_INFO[op_code].cycles != expected || CB_OP_CODE_INFO[op_code].mnemonic == nullptr) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Counts the op codes a table leaves undefined
+ *
+ * @param table OP_CODE_INFO or CB_OP_CODE_INFO
+ */
+constexpr int UndefinedOpCodes(const OpCodeInfo (&table)[256]) {
+    int undefined = 0;
+    for (int op_code = 0; op_code < 256; op_code++) {
+        undefined += table[op_code].mnemonic == nullptr ? 1 : 0;
+    }
+    return undefined;
+}
+
+static_assert(LengthsMatchOperands(OP_CODE_INFO, false), "An op code's length does not match its operands");
+static_assert(LengthsMatchOperands(CB_OP_CODE_INFO, true), "A CB op code is not two bytes long");
+static_assert(CyclesAreMachineCycles(OP_CODE_INFO), "An op code's cycles are not whole machine cycles");
+static_assert(CyclesAreMachineCycles(CB_OP_CODE_INFO), "A CB op code's cycles are not whole machine cycles");
+static_assert(BranchCyclesMatchConditions(OP_CODE_INFO), "Only conditional branches may take longer when taken");
+static_assert(BranchCyclesMatchConditions(CB_OP_CODE_INFO), "CB op codes never branch");
+static_assert(FlagsAreWellFormed(OP_CODE_INFO), "An op code's flags are malformed");
+static_assert(FlagsAreWellFormed(CB_OP_CODE_INFO), "A CB op code's flags are malformed");
+static_assert(CBCyclesMatchOperands(), "A CB op code's cycles do not match its operand");
+static_assert(UndefinedOpCodes(OP_CODE_INFO) == 11, "The primary table has eleven holes");
+static_assert(UndefinedOpCodes(CB_OP_CODE_INFO) == 0, "Every CB op code is defined");
+
+#endif
@@ -4,24 +4,64 @@
  */
 
 #include <iostream>
+#include "./sm83_op_code_info.hpp"
 #include "./sm83_op_codes.hpp"
 #include "./sm83_state.hpp"
 
 using namespace std;
 
-void AddToRegister(SM83State* state, uint8_t (SM83State::*reg_getter)(), void (SM83State::*reg_setter)(uint8_t), uint8_t value) {
+/**
+ * @brief Moves the program counter past an op code and gets the cycles it took, both from OP_CODE_INFO
+ *
+ * @tparam OP_CODE The op code being finished
+ * @param state The SM83 state object to operate on
+ * @return uint8_t The op code's cycles
+ */
+template <uint8_t OP_CODE>
+static inline uint8_t Complete(SM83State* state) {
+    static_assert(OP_CODE_INFO[OP_CODE].mnemonic != nullptr, "Undefined op codes have no handler");
+    static_assert(OP_CODE_INFO[OP_CODE].cycles == OP_CODE_INFO[OP_CODE].branch_cycles, "Conditional branches finish with JumpRelative");
+
+    state->IncrementProgramCounter(OP_CODE_INFO[OP_CODE].length);
+    return OP_CODE_INFO[OP_CODE].cycles;
+}
+
+/**
+ * @brief Finishes a JR op code, taking its length and both timings from OP_CODE_INFO
+ *
+ * @tparam OP_CODE The JR op code being finished
+ * @param state The SM83 state object to operate on
+ * @param taken Whether the condition holds. Always true for the unconditional JR
+ * @return uint8_t The op code's cycles, or its branch cycles if the jump is taken
+ */
+template <uint8_t OP_CODE>
+static inline uint8_t JumpRelative(SM83State* state, bool taken) {
+    static_assert(MnemonicStartsWith(OP_CODE_INFO[OP_CODE].mnemonic, "JR "), "JumpRelative finishes JR op codes");
+
+    uint16_t pc = state->programCounter();
+    uint16_t next = (uint16_t)(pc + OP_CODE_INFO[OP_CODE].length);
+
+    if (taken == false) {
+        state->setProgramCounter(next);
+        return OP_CODE_INFO[OP_CODE].cycles;
+    }
 
-    bool h = false;
-    bool z = false;
+    // Offsets are relative to the next instruction
+    int8_t r8 = (int8_t)state->MemoryAt(pc + 1);
+    state->setProgramCounter((uint16_t)(next + r8));
+    return OP_CODE_INFO[OP_CODE].branch_cycles;
+}
+
+void AddToRegister(SM83State* state, uint8_t (SM83State::*reg_getter)(), void (SM83State::*reg_setter)(uint8_t), uint8_t value) {
 
     uint8_t reg_value = ((*state).*reg_getter)();
     uint8_t new_reg_value = reg_value + value;
     ((*state).*reg_setter)(new_reg_value);
 
-    // Set the H flag
+    // Set the H flag on a carry out of the low nibble
     uint8_t f_flag = state->f();
 
-    if (new_reg_value < reg_value) {
+    if ((reg_value & 0x0F) + (value & 0x0F) > 0x0F) {
         f_flag = f_flag | H_FLAG;
     } else {
         f_flag = f_flag & NOT_H_FLAG;
@@ -46,16 +86,17 @@ void AddToRegister(SM83State* state, uint16_t (SM83State::*reg_getter)(), void (
     uint16_t new_reg_value = reg_value + value;
     ((*state).*reg_setter)(new_reg_value);
 
-    // Set the H flag
+    // Set the H flag on a carry out of bit 11
     uint8_t f_flag = state->f();
 
-    if (new_reg_value < reg_value) {
+    if ((reg_value & 0x0FFF) + (value & 0x0FFF) > 0x0FFF) {
         f_flag = f_flag | H_FLAG;
     } else {
         f_flag = f_flag & NOT_H_FLAG;
     }
 
-    if ((new_reg_value & 0x00FF) < (reg_value & 0x00FF)) {
+    // Set the C flag on a carry out of bit 15
+    if (new_reg_value < reg_value) {
         f_flag = f_flag | C_FLAG;
     } else {
         f_flag = f_flag & NOT_C_FLAG;
@@ -73,19 +114,20 @@ void AddToMemoryLocation(SM83State* state, uint16_t address, uint8_t value) {
     uint8_t new_memory_value = memory_value + value;
     state->SetMemoryAt(address, new_memory_value);
 
-    // Set the H flag
+    // Set the H flag on a carry out of the low nibble
     uint8_t f_flag = state->f();
 
-    if (new_memory_value < memory_value) {
+    if ((memory_value & 0x0F) + (value & 0x0F) > 0x0F) {
         f_flag = f_flag | H_FLAG;
     } else {
         f_flag = f_flag & NOT_H_FLAG;
     }
 
-    if ((new_memory_value & 0x00FF) < (memory_value & 0x00FF)) {
-        f_flag = f_flag | C_FLAG;
+    // Set the Z flag
+    if (new_memory_value == 0) {
+        f_flag = f_flag | Z_FLAG;
     } else {
-        f_flag = f_flag & NOT_C_FLAG;
+        f_flag = f_flag & NOT_Z_FLAG;
     }
 
     // Set N to 0
@@ -95,17 +137,14 @@ void AddToMemoryLocation(SM83State* state, uint16_t address, uint8_t value) {
 }
 
 void SubFromRegister(SM83State* state, uint8_t (SM83State::*reg_getter)(), void (SM83State::*reg_setter)(uint8_t), uint8_t value) {
-    bool h = false;
-    bool z = false;
-
     uint8_t reg_value = ((*state).*reg_getter)();
     uint8_t new_reg_value = reg_value - value;
     ((*state).*reg_setter)(new_reg_value);
 
-    // Set the H flag
+    // Set the H flag on a borrow from bit 4
     uint8_t f_flag = state->f();
 
-    if (new_reg_value > reg_value) {
+    if ((reg_value & 0x0F) < (value & 0x0F)) {
         f_flag = f_flag | H_FLAG;
     } else {
         f_flag = f_flag & NOT_H_FLAG;
@@ -118,7 +157,7 @@ void SubFromRegister(SM83State* state, uint8_t (SM83State::*reg_getter)(), void
         f_flag = f_flag & NOT_Z_FLAG;
     }
 
-    // Set N to 0
+    // Set N to 1
     f_flag = f_flag | N_FLAG;
 
     state->setF(f_flag);
@@ -130,10 +169,10 @@ void SubFromMemoryLocation(SM83State* state, uint16_t address, uint8_t value) {
     uint8_t new_memory_value = memory_value - value;
     state->SetMemoryAt(address, new_memory_value);
 
-    // Set the H flag
+    // Set the H flag on a borrow from bit 4
     uint8_t f_flag = state->f();
 
-    if (new_memory_value > memory_value) {
+    if ((memory_value & 0x0F) < (value & 0x0F)) {
         f_flag = f_flag | H_FLAG;
     } else {
         f_flag = f_flag & NOT_H_FLAG;
@@ -146,14 +185,14 @@ void SubFromMemoryLocation(SM83State* state, uint16_t address, uint8_t value) {
         f_flag = f_flag & NOT_Z_FLAG;
     }
 
-    // Set N to 0
+    // Set N to 1
     f_flag = f_flag | N_FLAG;
 
     state->setF(f_flag);
 }
 
 void RotateRight(SM83State* state, uint8_t (SM83State::*reg_getter)(), void (SM83State::*reg_setter)(uint8_t), bool through_carry) {
-    // Z, N, H, and C will all be zero to start
+    // Z, N and H are always cleared, C is set below
     uint8_t f_flag = 0b00000000;
 
     // Get the register value to rotate
@@ -179,22 +218,18 @@ void RotateRight(SM83State* state, uint8_t (SM83State::*reg_getter)(), void (SM8
         new_reg_value = new_reg_value | 0b10000000;
     }
 
-    if (new_reg_value == 0) {
-        f_flag = f_flag | Z_FLAG;
-    }
-
     ((*state).*reg_setter)(new_reg_value);
     state->setF(f_flag);
 }
 
 void RotateLeft(SM83State* state, uint8_t (SM83State::*reg_getter)(), void (SM83State::*reg_setter)(uint8_t), bool through_carry) {
-    // Z, N, H, and C will all be zero to start
+    // Z, N and H are always cleared, C is set below
     uint8_t f_flag = 0b00000000;
 
     // Get the register value to rotate
     uint8_t reg_value = ((*state).*reg_getter)();
 
-    // Shift to the right 1 bit
+    // Shift to the left 1 bit
     uint8_t new_reg_value = reg_value << 1;
 
     // If the most sig bit was set, CY is set as well
@@ -214,63 +249,52 @@ void RotateLeft(SM83State* state, uint8_t (SM83State::*reg_getter)(), void (SM83
         new_reg_value = new_reg_value | 0b00000001;
     }
 
-    if (new_reg_value == 0) {
-        f_flag = f_flag | Z_FLAG;
-    }
-
     ((*state).*reg_setter)(new_reg_value);
     state->setF(f_flag);
 }
 
-// Runs for 4 cycles and moves program counter forward 1 byte
-// No other side effects
+// No side effects beyond moving past the op code
 uint8_t Execute00(SM83State* state) {
-    state->IncrementProgramCounter(1);
-    return 4;
+    return Complete<0x00>(state);
 }
 
 uint8_t Execute01(SM83State* state) {
-    uint8_t b = state->MemoryAt(state->programCounter() + 1);
-    uint8_t c = state->MemoryAt(state->programCounter() + 2);
+    // The immediate is little endian, low byte first
+    uint8_t c = state->MemoryAt(state->programCounter() + 1);
+    uint8_t b = state->MemoryAt(state->programCounter() + 2);
 
     state->setB(b);
     state->setC(c);
-    state->IncrementProgramCounter(3);
-
-    return 12;
+    return Complete<0x01>(state);
 }
 
 uint8_t Execute11(SM83State* state) {
-    uint8_t d = state->MemoryAt(state->programCounter() + 1);
-    uint8_t e = state->MemoryAt(state->programCounter() + 2);
+    // The immediate is little endian, low byte first
+    uint8_t e = state->MemoryAt(state->programCounter() + 1);
+    uint8_t d = state->MemoryAt(state->programCounter() + 2);
 
     state->setD(d);
     state->setE(e);
-    state->IncrementProgramCounter(3);
-
-    return 12;
+    return Complete<0x11>(state);
 }
 
 uint8_t Execute21(SM83State* state) {
-    uint8_t h = state->MemoryAt(state->programCounter() + 1);
-    uint8_t l = state->MemoryAt(state->programCounter() + 2);
+    // The immediate is little endian, low byte first
+    uint8_t l = state->MemoryAt(state->programCounter() + 1);
+    uint8_t h = state->MemoryAt(state->programCounter() + 2);
 
     state->setH(h);
     state->setL(l);
-    state->IncrementProgramCounter(3);
-
-    return 12;
+    return Complete<0x21>(state);
 }
 
 uint8_t Execute31(SM83State* state) {
-    // Get the most and least significant nibbles
-    uint8_t msn = state->MemoryAt(state->programCounter() + 1);
-    uint8_t lsn = state->MemoryAt(state->programCounter() + 2);
+    // Get the least and most significant bytes, the immediate is little endian
+    uint8_t lsb = state->MemoryAt(state->programCounter() + 1);
+    uint8_t msb = state->MemoryAt(state->programCounter() + 2);
 
-    state->setStackPointer((uint16_t)(msn << 8 | lsn));
-    state->IncrementProgramCounter(3);
-
-    return 12;
+    state->setStackPointer((uint16_t)(msb << 8 | lsb));
+    return Complete<0x31>(state);
 }
 
 uint8_t Execute02(SM83State* state) {
@@ -278,9 +302,7 @@ uint8_t Execute02(SM83State* state) {
     uint16_t bc = state->bc();
 
     state->SetMemoryAt(bc, a);
-    state->IncrementProgramCounter(1);
-
-    return 8;
+    return Complete<0x02>(state);
 }
 
 uint8_t Execute12(SM83State* state) {
@@ -288,9 +310,7 @@ uint8_t Execute12(SM83State* state) {
     uint16_t de = state->de();
 
     state->SetMemoryAt(de, a);
-    state->IncrementProgramCounter(1);
-
-    return 8;
+    return Complete<0x12>(state);
 }
 
 uint8_t Execute22(SM83State* state) {
@@ -299,9 +319,7 @@ uint8_t Execute22(SM83State* state) {
 
     state->SetMemoryAt(hl, a);
     state->setHL(hl + 1);
-    state->IncrementProgramCounter(1);
-
-    return 8;
+    return Complete<0x22>(state);
 }
 
 uint8_t Execute32(SM83State* state) {
@@ -310,117 +328,96 @@ uint8_t Execute32(SM83State* state) {
 
     state->SetMemoryAt(hl, a);
     state->setHL(hl - 1);
-    state->IncrementProgramCounter(1);
-
-    return 8;
+    return Complete<0x32>(state);
 }
 
 uint8_t Execute03(SM83State* state) {
     uint16_t bc = state->bc();
     state->setBC(bc + 1);
-    state->IncrementProgramCounter(1);
-
-    return 8;
+    return Complete<0x03>(state);
 }
 
 uint8_t Execute13(SM83State* state) {
     uint16_t de = state->de();
     state->setDE(de + 1);
-    state->IncrementProgramCounter(1);
-
-    return 8;
+    return Complete<0x13>(state);
 }
 
 uint8_t Execute23(SM83State* state) {
     uint16_t hl = state->hl();
     state->setHL(hl + 1);
-    state->IncrementProgramCounter(1);
-
-    return 8;
+    return Complete<0x23>(state);
 }
 
 uint8_t Execute33(SM83State* state) {
     uint16_t sp = state->stackPointer();
     state->setStackPointer(sp + 1);
-    state->IncrementProgramCounter(1);
-
-    return 8;
+    return Complete<0x33>(state);
 }
 
 uint8_t Execute04(SM83State* state) {
     AddToRegister(state, &SM83State::b, &SM83State::setB, 1);
-    state->IncrementProgramCounter(1);
-    return 4;
+    return Complete<0x04>(state);
 }
 
 uint8_t Execute14(SM83State* state) {
     AddToRegister(state, &SM83State::d, &SM83State::setD, 1);
-    state->IncrementProgramCounter(1);
-    return 4;
+    return Complete<0x14>(state);
 }
 
 uint8_t Execute24(SM83State* state) {
     AddToRegister(state, &SM83State::h, &SM83State::setH, 1);
-    state->IncrementProgramCounter(1);
-    return 4;
+    return Complete<0x24>(state);
 }
 
 uint8_t Execute34(SM83State* state) {
     uint16_t address = state->hl();
     AddToMemoryLocation(state, address, 1);
 
-    state->IncrementProgramCounter(1);
-    return 12;
+    return Complete<0x34>(state);
 }
 
 uint8_t Execute05(SM83State* state) {
     SubFromRegister(state, &SM83State::b, &SM83State::setB, 1);
-    state->IncrementProgramCounter(1);
-    return 4;
+    return Complete<0x05>(state);
 }
 
 uint8_t Execute15(SM83State* state) {
     SubFromRegister(state, &SM83State::d, &SM83State::setD, 1);
-    state->IncrementProgramCounter(1);
-    return 4;
+    return Complete<0x15>(state);
 }
 
 uint8_t Execute25(SM83State* state) {
     SubFromRegister(state, &SM83State::h, &SM83State::setH, 1);
-    state->IncrementProgramCounter(1);
-    return 4;
+    return Complete<0x25>(state);
 }
 
 uint8_t Execute35(SM83State* state) {
     uint16_t address = state->hl();
     SubFromMemoryLocation(state, address, 1);
 
-    state->IncrementProgramCounter(1);
-    return 12;
+    return Complete<0x35>(state);
 }
 
 uint8_t Execute06(SM83State* state) {
     uint8_t data = state->MemoryAt(state->programCounter() + 1);
     state->setB(data);
 
-    state->IncrementProgramCounter(2);
-    return 8;
+    return Complete<0x06>(state);
 }
 
 uint8_t Execute16(SM83State* state) {
     uint8_t data = state->MemoryAt(state->programCounter() + 1);
     state->setD(data);
 
-    state->IncrementProgramCounter(2);
-    return 8;
+    return Complete<0x16>(state);
 }
 
 uint8_t Execute26(SM83State* state) {
     uint8_t data = state->MemoryAt(state->programCounter() + 1);
     state->setH(data);
 
-    state->IncrementProgramCounter(2);
-    return 8;
+    return Complete<0x26>(state);
 }
 
 uint8_t Execute36(SM83State* state) {
@@ -428,20 +425,17 @@ uint8_t Execute36(SM83State* state) {
     uint16_t hl = state->hl();
     state->SetMemoryAt(hl, data);
 
-    state->IncrementProgramCounter(2);
-    return 12;
+    return Complete<0x36>(state);
 }
 
 uint8_t Execute07(SM83State* state) {
     RotateLeft(state, &SM83State::a, &SM83State::setA, false);
-    state->IncrementProgramCounter(1);
-    return 4;
+    return Complete<0x07>(state);
 }
 
 uint8_t Execute17(SM83State* state) {
     RotateLeft(state, &SM83State::a, &SM83State::setA, true);
-    state->IncrementProgramCounter(1);
-    return 4;
+    return Complete<0x17>(state);
 }
 
 uint8_t Execute37(SM83State* state) {
@@ -451,82 +445,55 @@ uint8_t Execute37(SM83State* state) {
     f = (f & 0b10010000) | C_FLAG;
     state->setF(f);
 
-    state->IncrementProgramCounter(1);
-    return 4;
+    return Complete<0x37>(state);
 }
 
 uint8_t Execute08(SM83State* state) {
     uint16_t pc = state->programCounter();
     uint16_t sp = state->stackPointer();
 
-    uint8_t sp_a = (uint8_t)((sp | 0b11110000) >> 8);
-    uint8_t sp_b = (uint8_t)(sp);
+    // The address follows the op code, low byte first, and SP is stored there low byte first
+    uint8_t low = state->MemoryAt(pc + 1);
+    uint8_t high = state->MemoryAt(pc + 2);
+    uint16_t address = (uint16_t)(high << 8 | low);
 
-    state->SetMemoryAt(pc + 1, sp_a);
-    state->SetMemoryAt(pc + 2, sp_b);
+    state->SetMemoryAt(address, (uint8_t)sp);
+    state->SetMemoryAt((uint16_t)(address + 1), (uint8_t)(sp >> 8));
 
-    state->IncrementProgramCounter(3);
-    return 20;
+    return Complete<0x08>(state);
 }
 
 uint8_t Execute18(SM83State* state) {
-    uint16_t pc = state->programCounter();
-    int8_t r8 = (int8_t)state->MemoryAt(pc + 1);
-
-    state->setProgramCounter((uint16_t)(pc + r8));
-    return 12;
+    return JumpRelative<0x18>(state, true);
 }
 
 uint8_t Execute28(SM83State* state) {
-    bool z_flag = state->zFlag();
-    uint16_t pc = state->programCounter();
-    int8_t r8 = (int8_t)state->MemoryAt(pc + 1);
-
-    if (z_flag) {
-        state->setProgramCounter((uint16_t)(pc + r8));
-        return 12;
-    }
-
-    state->setProgramCounter((uint16_t)(pc + 2));
-    return 8;
+    return JumpRelative<0x28>(state, state->zFlag());
 }
 
 uint8_t Execute38(SM83State* state) {
-    bool c_flag = state->cFlag();
-    uint16_t pc = state->programCounter();
-    int8_t r8 = (int8_t)state->MemoryAt(pc + 1);
-
-    if (c_flag) {
-        state->setProgramCounter((uint16_t)(pc + r8));
-        return 12;
-    }
-
-    state->setProgramCounter((uint16_t)(pc + 2));
-    return 8;
+    return JumpRelative<0x38>(state, state->cFlag());
 }
 
 uint8_t Execute09(SM83State* state) {
     uint16_t bc = state->bc();
     AddToRegister(state, &SM83State::hl, &SM83State::setHL, bc);
 
-    state->IncrementProgramCounter(1);
-    return 8;
+    return Complete<0x09>(state);
 }
 
 uint8_t Execute19(SM83State* state) {
     uint16_t de = state->de();
     AddToRegister(state, &SM83State::hl, &SM83State::setHL, de);
 
-    state->IncrementProgramCounter(1);
-    return 8;
+    return Complete<0x19>(state);
 }
 
 uint8_t Execute29(SM83State* state) {
     uint16_t hl = state->hl();
     AddToRegister(state, &SM83State::hl, &SM83State::setHL, hl);
 
-    state->IncrementProgramCounter(1);
-    return 8;
+    return Complete<0x29>(state);
 }
 
 uint8_t Execute0A(SM83State* state) {
@@ -534,8 +501,7 @@ uint8_t Execute0A(SM83State* state) {
     uint8_t value = state->MemoryAt(bc);
 
     state->setA(value);
-    state->IncrementProgramCounter(1);
-    return 8;
+    return Complete<0x0A>(state);
 }
 
 uint8_t Execute1A(SM83State* state) {
@@ -543,8 +509,7 @@ uint8_t Execute1A(SM83State* state) {
     uint8_t value = state->MemoryAt(de);
 
     state->setA(value);
-    state->IncrementProgramCounter(1);
-    return 8;
+    return Complete<0x1A>(state);
 }
 
 uint8_t Execute2A(SM83State* state) {
@@ -553,104 +518,86 @@ uint8_t Execute2A(SM83State* state) {
 
     state->setA(value);
     state->setHL(hl + 1);
-    state->IncrementProgramCounter(1);
-    return 8;
+    return Complete<0x2A>(state);
 }
 
 uint8_t Execute0B(SM83State* state) {
     uint16_t bc = state->bc();
     state->setBC(bc - 1);
-    state->IncrementProgramCounter(1);
-
-    return 8;
+    return Complete<0x0B>(state);
 }
 
 uint8_t Execute1B(SM83State* state) {
     uint16_t de = state->de();
     state->setDE(de - 1);
-    state->IncrementProgramCounter(1);
-
-    return 8;
+    return Complete<0x1B>(state);
 }
 
 uint8_t Execute2B(SM83State* state) {
     uint16_t hl = state->hl();
     state->setHL(hl - 1);
-    state->IncrementProgramCounter(1);
-
-    return 8;
+    return Complete<0x2B>(state);
 }
 
 uint8_t Execute0C(SM83State* state) {
     AddToRegister(state, &SM83State::c, &SM83State::setC, 1);
-    state->IncrementProgramCounter(1);\
-    return 4;
+    return Complete<0x0C>(state);
 }
 
 uint8_t Execute1C(SM83State* state) {
     AddToRegister(state, &SM83State::e, &SM83State::setE, 1);
-    state->IncrementProgramCounter(1);\
-    return 4;
+    return Complete<0x1C>(state);
 }
 
 uint8_t Execute2C(SM83State* state) {
     AddToRegister(state, &SM83State::l, &SM83State::setL, 1);
-    state->IncrementProgramCounter(1);\
-    return 4;
+    return Complete<0x2C>(state);
 }
 
 uint8_t Execute0D(SM83State* state) {
     SubFromRegister(state, &SM83State::c, &SM83State::setC, 1);
-    state->IncrementProgramCounter(1);
-    return 4;
+    return Complete<0x0D>(state);
 }
 
 uint8_t Execute1D(SM83State* state) {
     SubFromRegister(state, &SM83State::e, &SM83State::setE, 1);
-    state->IncrementProgramCounter(1);
-    return 4;
+    return Complete<0x1D>(state);
 }
 
 uint8_t Execute2D(SM83State* state) {
     SubFromRegister(state, &SM83State::l, &SM83State::setL, 1);
-    state->IncrementProgramCounter(1);
-    return 4;
+    return Complete<0x2D>(state);
 }
 
 uint8_t Execute0E(SM83State* state) {
     uint8_t data = state->MemoryAt(state->programCounter() + 1);
     state->setC(data);
 
-    state->IncrementProgramCounter(2);
-    return 8;
+    return Complete<0x0E>(state);
 }
 
 uint8_t Execute1E(SM83State* state) {
     uint8_t data = state->MemoryAt(state->programCounter() + 1);
     state->setE(data);
 
-    state->IncrementProgramCounter(2);
-    return 8;
+    return Complete<0x1E>(state);
 }
 
 uint8_t Execute2E(SM83State* state) {
     uint8_t data = state->MemoryAt(state->programCounter() + 1);
     state->setL(data);
 
-    state->IncrementProgramCounter(2);
-    return 8;
+    return Complete<0x2E>(state);
 }
 
 uint8_t Execute0F(SM83State* state) {
     RotateRight(state, &SM83State::a, &SM83State::setA, false);
-    state->IncrementProgramCounter(1);
-    return 4;
+    return Complete<0x0F>(state);
 }
 
 uint8_t Execute1F(SM83State* state) {
     RotateRight(state, &SM83State::a, &SM83State::setA, true);
-    state->IncrementProgramCounter(1);
-    return 4;
+    return Complete<0x1F>(state);
 }
 
 uint8_t Execute2F(SM83State* state) {
@@ -663,55 +610,31 @@ uint8_t Execute2F(SM83State* state) {
     state->setF(f);
     state->setA(a ^ 0xFF);
 
-    state->IncrementProgramCounter(1);
-    return 4;
+    return Complete<0x2F>(state);
 }
 
 uint8_t Execute20(SM83State* state) {
-    bool nz = state->zFlag() == false;
-    uint16_t pc = state->programCounter();
-
-    // If the zero flag is not set, jump to address in the next 8 bits.
-    if (nz == true) {
-        int8_t address = state->MemoryAt(pc + 1);
-        state->setProgramCounter(pc + address);
-        return 12;
-    }
-    else {
-        state->setProgramCounter(pc + 2);
-        return 8;
-    }
+    // If the zero flag is not set, jump by the offset in the next 8 bits
+    return JumpRelative<0x20>(state, state->zFlag() == false);
 }
 
 uint8_t Execute30(SM83State* state) {
-    bool nc = state->cFlag() == false;
-    uint16_t pc = state->programCounter();
-
-    // If the zero flag is not set, jump to address in the next 8 bits.
-    if (nc == true) {
-        int8_t address = state->MemoryAt(pc + 1);
-        state->setProgramCounter(pc + address);
-        return 12;
-    }
-    else {
-        state->setProgramCounter(pc + 2);
-        return 8;
-    }
+    // If the carry flag is not set, jump by the offset in the next 8 bits
+    return JumpRelative<0x30>(state, state->cFlag() == false);
 }
 
 uint8_t Execute27(SM83State* state) {
 
     uint8_t a = state->a();
-    uint f = state->f();
+    uint8_t f = state->f();
 
-    bool z_flag = state->zFlag();
     bool c_flag = state->cFlag();
     bool h_flag = state->hFlag();
 
     if (state->nFlag() == false) {
         // after an addition, adjust if (half-)carry occurred or if result is out of bounds
         if (c_flag || a > 0x99) {
-            state->setA(a += 0x60);
+            a += 0x60;
             f = f | C_FLAG;
         }
         if (h_flag || (a & 0x0f) > 0x09) {
@@ -738,5 +661,31 @@ uint8_t Execute27(SM83State* state) {
     state->setA(a);
     state->setF(f);
 
-    return 4;
-}
\ No newline at end of file
+    return Complete<0x27>(state);
+}
+
+uint8_t ExecuteC9(SM83State* state) {
+    uint16_t sp = state->stackPointer();
+    uint8_t low = state->MemoryAt(sp);
+    uint8_t high = state->MemoryAt((uint16_t)(sp + 1));
+
+    state->setStackPointer((uint16_t)(sp + 2));
+    state->setProgramCounter((uint16_t)(high << 8 | low));
+    return OP_CODE_INFO[0xC9].cycles;
+}
+
+uint8_t ExecuteCD(SM83State* state) {
+    uint16_t pc = state->programCounter();
+    uint8_t low = state->MemoryAt(pc + 1);
+    uint8_t high = state->MemoryAt(pc + 2);
+    uint16_t return_address = (uint16_t)(pc + OP_CODE_INFO[0xCD].length);
+
+    // The high byte is pushed first so the address sits little endian on the stack
+    uint16_t sp = state->stackPointer();
+    state->SetMemoryAt((uint16_t)(sp - 1), (uint8_t)(return_address >> 8));
+    state->SetMemoryAt((uint16_t)(sp - 2), (uint8_t)return_address);
+    state->setStackPointer((uint16_t)(sp - 2));
+
+    state->setProgramCounter((uint16_t)(high << 8 | low));
+    return OP_CODE_INFO[0xCD].cycles;
+}
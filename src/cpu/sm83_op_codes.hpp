@@ -18,7 +18,7 @@ using namespace std;
  * @param reg_getter The getter for the register value
  * @param reg_setter The setter for the register value
  * @param value The value to add to the register
- * @post F register is updated with CPU flags
+ * @post Z and H are set from the result, N is reset, C is unaffected
  */
 void AddToRegister(SM83State* state, uint8_t (SM83State::*reg_getter)(), void (SM83State::*reg_setter)(uint8_t), uint8_t value);
 
@@ -29,7 +29,7 @@ void AddToRegister(SM83State* state, uint8_t (SM83State::*reg_getter)(), void (S
  * @param reg_getter The getter for the register value
  * @param reg_setter The setter for the register value
  * @param value The value to add to the register
- * @post F register is updated with CPU flags. H and C carry flags are updated
+ * @post H and C are set from the carries out of bits 11 and 15, N is reset, Z is unaffected
  */
 void AddToRegister(SM83State* state, uint16_t (SM83State::*reg_getter)(), void (SM83State::*reg_setter)(uint16_t), uint16_t value);
 
@@ -39,7 +39,7 @@ void AddToRegister(SM83State* state, uint16_t (SM83State::*reg_getter)(), void (
  * @param state The SM83 state object to operate on
  * @param address The address of the value to add to
  * @param value The value to add to the memory value
- * @post F register is updated with CPU flags. H and C carry flags are updated
+ * @post Z and H are set from the result, N is reset, C is unaffected
  */
 void AddToMemoryLocation(SM83State* state, uint16_t address, uint8_t value);
 
@@ -50,7 +50,7 @@ void AddToMemoryLocation(SM83State* state, uint16_t address, uint8_t value);
  * @param reg_getter The getter for the register value
  * @param reg_setter The setter for the register value
  * @param value The value to subtract from the register
- * @post F register is updated with CPU flags
+ * @post Z and H are set from the result, N is set, C is unaffected
  */
 void SubFromRegister(SM83State* state, uint8_t (SM83State::*reg_getter)(), void (SM83State::*reg_setter)(uint8_t), uint8_t value);
 
@@ -60,7 +60,7 @@ void SubFromRegister(SM83State* state, uint8_t (SM83State::*reg_getter)(), void
  * @param state The SM83 state object to operate on
  * @param address The address of the value to add to
  * @param value The value to substract from the memory value
- * @post F register is updated with CPU flags
+ * @post Z and H are set from the result, N is set, C is unaffected
  */
 void SubFromMemoryLocation(SM83State* state, uint16_t address, uint8_t value);
 
@@ -71,6 +71,7 @@ void SubFromMemoryLocation(SM83State* state, uint16_t address, uint8_t value);
  * @param reg_getter The getter for the register to rotate
  * @param reg_setter The setter for the register to rotate
  * @param through_carry A value indicating whether or not the carry flag rotates into the register
+ * @post C is set from the bit rotated out, Z, N and H are reset as for the accumulator rotates
  */
 void RotateRight(SM83State* state, uint8_t (SM83State::*reg_getter)(), void (SM83State::*reg_setter)(uint8_t), bool through_carry);
 
@@ -81,6 +82,7 @@ void RotateRight(SM83State* state, uint8_t (SM83State::*reg_getter)(), void (SM8
  * @param reg_getter The getter for the register to rotate
  * @param reg_setter The setter for the register to rotate
  * @param through_carry A value indicating whether or not the carry flag rotates into the register
+ * @post C is set from the bit rotated out, Z, N and H are reset as for the accumulator rotates
  */
 void RotateLeft(SM83State* state, uint8_t (SM83State::*reg_getter)(), void (SM83State::*reg_setter)(uint8_t), bool through_carry);
 /**
@@ -336,28 +338,28 @@ uint8_t Execute27(SM83State* state);
 uint8_t Execute37(SM83State* state);
 
 /**
- * @brief LD (a16), SP - Put the stack pointer into the next two bytes
+ * @brief LD (a16), SP - Store the stack pointer, low byte first, at the address in the next two bytes
  * @param state The current state to operate on
  * @return uint8_t The number of cpu cycles to perform operation (20)
  */
 uint8_t Execute08(SM83State* state);
 
 /**
- * @brief JR r8 - relative jump to PC + signed digit. PC=PC+/-r8
+ * @brief JR r8 - relative jump by a signed offset from the next instruction. PC=PC+2+/-r8
  * @param state The current state to operate on
  * @return uint8_t The number of cpu cycles to perform operation (12)
  */
 uint8_t Execute18(SM83State* state);
 
 /**
- * @brief JR Z, r8 - conditional relative jump to PC + signed digit if Z is True. PC=PC+/-r8
+ * @brief JR Z, r8 - conditional relative jump by a signed offset from the next instruction if Z is True. PC=PC+2+/-r8
  * @param state The current state to operate on
  * @return uint8_t The number of cpu cycles to perform operation (12/8)
  */
 uint8_t Execute28(SM83State* state);
 
 /**
- * @brief JR C, r8 - conditional relative jump to PC + signed digit if C is True. PC=PC+/-r8
+ * @brief JR C, r8 - conditional relative jump by a signed offset from the next instruction if C is True. PC=PC+2+/-r8
  * @param state The current state to operate on
  * @return uint8_t The number of cpu cycles to perform operation (12/8)
  */
@@ -521,7 +523,7 @@ uint8_t Execute2F(SM83State* state);
  *
  * @param state The current state to operate on
  * @return uint8_t The number of cpu cycles to perform operation. 12 if jump, 8 otherwise
- * @post PC = PC + r8
+ * @post PC = PC + 2 + r8
  */
 uint8_t Execute20(SM83State* state);
 
@@ -530,8 +532,26 @@ uint8_t Execute20(SM83State* state);
  *
  * @param state The current state to operate on
  * @return uint8_t The number of cpu cycles to perform operation. 12 if jump, 8 otherwise
- * @post PC = PC + r8
+ * @post PC = PC + 2 + r8
  */
 uint8_t Execute30(SM83State* state);
 
-#endif
\ No newline at end of file
+/**
+ * @brief RET - Pops the return address off the stack into PC
+ *
+ * @param state The current state to operate on
+ * @return uint8_t The number of cpu cycles to perform operation (16)
+ * @post PC = (SP), SP = SP + 2
+ */
+uint8_t ExecuteC9(SM83State* state);
+
+/**
+ * @brief CALL a16 - Pushes the address of the next instruction and jumps to the little endian immediate address
+ *
+ * @param state The current state to operate on
+ * @return uint8_t The number of cpu cycles to perform operation (24)
+ * @post SP = SP - 2, (SP) = PC + 3, PC = a16
+ */
+uint8_t ExecuteCD(SM83State* state);
+
+#endif
@@ -9,6 +9,7 @@
  *
  */
 
+#include <cstring>
 #include <iostream>
 #include "./sm83_state.hpp"
 
@@ -17,6 +18,14 @@ using namespace std;
 SM83State::SM83State(uint8_t* memory_bus_ptr) {
     // Sets the pointer to the memory bus array
     this->memory_bus_ = memory_bus_ptr;
+
+    for (int i = 0; i < MAX_MEMORY_OBSERVERS; i++) {
+        this->observers_[i] = nullptr;
+    }
+    for (int page = 0; page < 256; page++) {
+        this->watched_pages_[page] = 0;
+        this->read_watched_pages_[page] = 0;
+    }
 }
 
 bool SM83State::zFlag() {
@@ -55,12 +64,117 @@ void SM83State::IncrementProgramCounter(uint8_t num_bytes) {
     this->program_counter_ = this->program_counter_ + num_bytes;
 }
 
-uint8_t SM83State::MemoryAt(int16_t address) {
+uint8_t SM83State::MemoryAt(uint16_t address) {
+    uint8_t watchers = this->read_watched_pages_[address >> 8];
+    if (watchers != 0) {
+        return this->NotifyRead(address, watchers);
+    }
+
     return this->memory_bus_[address];
 }
 
-void SM83State::SetMemoryAt(int16_t address, uint8_t value) {
+void SM83State::SetMemoryAt(uint16_t address, uint8_t value) {
     this->memory_bus_[address] = value;
+
+    uint8_t watchers = this->watched_pages_[address >> 8];
+    if (watchers != 0) {
+        this->NotifyWrite(address, value, watchers);
+    }
+}
+
+void SM83State::NotifyWrite(uint16_t address, uint8_t value, uint8_t watchers) {
+    for (int i = 0; i < MAX_MEMORY_OBSERVERS; i++) {
+        if ((watchers & (1 << i)) > 0) {
+            this->observers_[i]->OnMemoryWrite(address, value);
+        }
+    }
+}
+
+uint8_t SM83State::NotifyRead(uint16_t address, uint8_t watchers) {
+    uint8_t value;
+
+    for (int i = 0; i < MAX_MEMORY_OBSERVERS; i++) {
+        if ((watchers & (1 << i)) > 0 && this->observers_[i]->OnMemoryRead(address, &value)) {
+            return value;
+        }
+    }
+
+    return this->memory_bus_[address];
+}
+
+void SM83State::CopyMemory(uint16_t destination, uint16_t source, uint16_t length) {
+    if (length == 0) {
+        return;
+    }
+
+    memmove(this->memory_bus_ + destination, this->memory_bus_ + source, length);
+
+    // Each observer hears about the whole block once, however many of its pages it covers
+    uint8_t watchers = 0;
+    for (int page = destination >> 8; page <= (destination + length - 1) >> 8; page++) {
+        watchers = watchers | this->watched_pages_[page];
+    }
+
+    for (int i = 0; i < MAX_MEMORY_OBSERVERS; i++) {
+        if ((watchers & (1 << i)) > 0) {
+            this->observers_[i]->OnMemoryBlockWrite(destination, this->memory_bus_ + destination, length);
+        }
+    }
+}
+
+bool SM83State::AddMemoryObserver(MemoryObserver* observer, uint8_t first_page, uint8_t last_page, uint8_t watch) {
+    int slot = -1;
+
+    // Reuse the observer's slot if it already has one
+    for (int i = 0; i < MAX_MEMORY_OBSERVERS; i++) {
+        if (this->observers_[i] == observer) {
+            slot = i;
+            break;
+        }
+        if (slot < 0 && this->observers_[i] == nullptr) {
+            slot = i;
+        }
+    }
+
+    if (slot < 0) {
+        return false;
+    }
+
+    this->observers_[slot] = observer;
+
+    for (int page = first_page; page <= last_page; page++) {
+        if ((watch & WATCH_WRITES) > 0) {
+            this->watched_pages_[page] = this->watched_pages_[page] | (uint8_t)(1 << slot);
+        }
+        if ((watch & WATCH_READS) > 0) {
+            this->read_watched_pages_[page] = this->read_watched_pages_[page] | (uint8_t)(1 << slot);
+        }
+    }
+    return true;
+}
+
+void SM83State::RemoveMemoryObserver(MemoryObserver* observer, uint8_t watch) {
+    for (int i = 0; i < MAX_MEMORY_OBSERVERS; i++) {
+        if (this->observers_[i] != observer) {
+            continue;
+        }
+
+        bool watching = false;
+        for (int page = 0; page < 256; page++) {
+            if ((watch & WATCH_WRITES) > 0) {
+                this->watched_pages_[page] = this->watched_pages_[page] & (uint8_t)~(1 << i);
+            }
+            if ((watch & WATCH_READS) > 0) {
+                this->read_watched_pages_[page] = this->read_watched_pages_[page] & (uint8_t)~(1 << i);
+            }
+            watching = watching || ((this->watched_pages_[page] | this->read_watched_pages_[page]) & (1 << i)) > 0;
+        }
+
+        // Free the slot once the observer watches nothing
+        if (!watching) {
+            this->observers_[i] = nullptr;
+        }
+    }
 }
 
 uint8_t SM83State::a() {
@@ -12,6 +12,7 @@
 #define SM83_STATE_H
 
 #include <iostream>
+#include "./memory_observer.hpp"
 
 using namespace std;
 
@@ -26,6 +27,9 @@ static const uint8_t NOT_N_FLAG = 0b10111111;
 static const uint8_t NOT_H_FLAG = 0b11011111;
 static const uint8_t NOT_C_FLAG = 0b11101111;
 
+// Each page of the memory bus can be watched by up to 8 observers
+static const uint8_t MAX_MEMORY_OBSERVERS = 8;
+
 class SM83State
 {
 
@@ -50,6 +54,31 @@ private:
     uint16_t stack_pointer_;
     uint16_t program_counter_;
 
+    // Observers notified of writes to the pages they watch
+    MemoryObserver* observers_[MAX_MEMORY_OBSERVERS];
+
+    // One bit per observer for each 256 byte page, so unwatched accesses cost a single lookup
+    uint8_t watched_pages_[256];
+    uint8_t read_watched_pages_[256];
+
+    /**
+     * @brief Passes a write on to the observers watching its page
+     *
+     * @param address The 16bit address written to
+     * @param value The value written
+     * @param watchers The observer bits of the page
+     */
+    void NotifyWrite(uint16_t address, uint8_t value, uint8_t watchers);
+
+    /**
+     * @brief Gives the observers watching a page the chance to supply a read
+     *
+     * @param address The 16bit address being read
+     * @param watchers The observer bits of the page
+     * @return uint8_t The value supplied by an observer, or the value in memory
+     */
+    uint8_t NotifyRead(uint16_t address, uint8_t watchers);
+
 public:
     /**
      * @brief Constructs a new SM83State instance
@@ -308,7 +337,7 @@ public:
      *
      * @param address The 16bit absolute memory address
      */
-    uint8_t MemoryAt(int16_t address);
+    uint8_t MemoryAt(uint16_t address);
 
     /**
      * @brief Sets the memory saved at the 16bit address
@@ -316,7 +345,35 @@ public:
      * @param address The 16bit absolute memory address
      * @param value The 8bit value to load into the memory
      */
-    void SetMemoryAt(int16_t address, uint8_t value);
+    void SetMemoryAt(uint16_t address, uint8_t value);
+
+    /**
+     * @brief Copies a block of memory in one go, as DMA does, then notifies the observers of the destination
+     *
+     * @param destination The first address to write to
+     * @param source The first address to read from
+     * @param length The number of bytes to copy. Neither range may run past 0xFFFF
+     */
+    void CopyMemory(uint16_t destination, uint16_t source, uint16_t length);
+
+    /**
+     * @brief Registers an observer for accesses to a range of pages
+     *
+     * @param observer The observer to notify
+     * @param first_page The first watched page (address >> 8)
+     * @param last_page The last watched page, inclusive
+     * @param watch WATCH_WRITES, WATCH_READS or both
+     * @return true if the observer was added, false if there was no free slot
+     */
+    bool AddMemoryObserver(MemoryObserver* observer, uint8_t first_page, uint8_t last_page, uint8_t watch = WATCH_WRITES);
+
+    /**
+     * @brief Stops notifying an observer of accesses
+     *
+     * @param observer The observer to remove
+     * @param watch The kinds of access to stop watching, all of them by default
+     */
+    void RemoveMemoryObserver(MemoryObserver* observer, uint8_t watch = WATCH_WRITES | WATCH_READS);
 };
 
 #endif
\ No newline at end of file
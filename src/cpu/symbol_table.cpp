@@ -0,0 +1,74 @@
+/**
+ * @file symbol_table.cpp
+ * @brief Implementation of the label table and the .sym loader
+ *
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include "./symbol_table.hpp"
+
+bool SymbolTable::LoadSymFile(const char* path) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t comment = line.find(';');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+
+        // BB:AAAA Name
+        size_t colon = line.find(':');
+        size_t space = line.find_first_of(" \t", colon);
+        if (colon == std::string::npos || colon == 0 || space == std::string::npos) {
+            continue;
+        }
+
+        char* end;
+        unsigned long bank = strtoul(line.c_str(), &end, 16);
+        if (end != line.c_str() + colon) {
+            continue;
+        }
+        unsigned long address = strtoul(line.c_str() + colon + 1, &end, 16);
+        if (end != line.c_str() + space || bank > 0xFF || address > 0xFFFF) {
+            continue;
+        }
+
+        size_t name_start = line.find_first_not_of(" \t", space);
+        size_t name_end = line.find_last_not_of(" \t\r");
+        if (name_start == std::string::npos) {
+            continue;
+        }
+
+        this->Add((uint8_t)bank, (uint16_t)address, line.substr(name_start, name_end - name_start + 1));
+    }
+    return true;
+}
+
+void SymbolTable::Add(uint8_t bank, uint16_t address, const std::string& name) {
+    uint32_t location = (uint32_t)bank << 16 | address;
+    auto existing = this->labels_.find(location);
+
+    if (existing == this->labels_.end()) {
+        this->labels_[location] = name;
+    } else if (existing->second.find('.') != std::string::npos && name.find('.') == std::string::npos) {
+        existing->second = name;
+    }
+}
+
+const char* SymbolTable::Find(uint8_t bank, uint16_t address) const {
+    auto label = this->labels_.find((uint32_t)bank << 16 | address);
+    return label != this->labels_.end() ? label->second.c_str() : nullptr;
+}
+
+size_t SymbolTable::size() const {
+    return this->labels_.size();
+}
+
+uint8_t SymbolTable::BankOf(uint16_t address) {
+    return address >= 0x4000 && address < 0x8000 ? 1 : 0;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file symbol_table.hpp
+ * @brief Labels for code and data addresses, loaded from RGBDS symbol files
+ *
+ */
+
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Maps bank and address pairs to label names.
+ *
+ * Locations use the same numbering as GuestProfiler::CodeLocation, the bank in bits 16-23 and the
+ * address in bits 0-15. Without a memory bank controller 4000-7FFF is bank 01 and everything else,
+ * including RAM, bank 00, which is also how rgblink numbers them in a .sym file.
+ */
+class SymbolTable
+{
+
+private:
+
+    std::unordered_map<uint32_t, std::string> labels_;
+
+public:
+    /**
+     * @brief Adds the labels in an RGBDS .sym file
+     *
+     * Each line is BB:AAAA followed by the label, and anything after a semicolon is a comment.
+     * Lines that do not parse are skipped.
+     *
+     * @param path The path of the file
+     * @return true if the file could be read
+     */
+    bool LoadSymFile(const char* path);
+
+    /**
+     * @brief Adds a label. A global label replaces a local one (containing a dot) at the same place,
+     * otherwise the first label added is kept
+     *
+     * @param bank The bank
+     * @param address The address
+     * @param name The label
+     */
+    void Add(uint8_t bank, uint16_t address, const std::string& name);
+
+    /**
+     * @brief Gets the label at a location
+     *
+     * @param bank The bank
+     * @param address The address
+     * @return const char* The label, or nullptr if there is none
+     */
+    const char* Find(uint8_t bank, uint16_t address) const;
+
+    /**
+     * @brief Gets the number of labelled locations
+     *
+     */
+    size_t size() const;
+
+    /**
+     * @brief Gets the bank an address is mapped from, for looking up the labels it refers to
+     *
+     * @param address The address
+     * @return uint8_t 01 for the switchable ROM area, 00 otherwise
+     */
+    static uint8_t BankOf(uint16_t address);
+};
+
+#endif
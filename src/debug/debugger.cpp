@@ -0,0 +1,202 @@
+/**
+ * @file debugger.cpp
+ * @brief Implementation of breakpoints and watchpoints
+ *
+ */
+
+#include <cstring>
+#include <stdexcept>
+#include "./debugger.hpp"
+#include "../cpu/sm83_op_code_info.hpp"
+
+Debugger::Debugger(GameBoy* game_boy) {
+    this->game_boy_ = game_boy;
+    this->watch_hit_ = STOP_NONE;
+    this->watch_address_ = 0;
+    this->stop_reason_ = STOP_NONE;
+    this->stop_address_ = 0;
+
+    memset(this->breakpoints_, 0, sizeof(this->breakpoints_));
+    memset(this->read_watches_, 0, sizeof(this->read_watches_));
+    memset(this->write_watches_, 0, sizeof(this->write_watches_));
+}
+
+Debugger::~Debugger() {
+    this->game_boy_->state()->RemoveMemoryObserver(this);
+}
+
+GameBoy* Debugger::gameBoy() {
+    return this->game_boy_;
+}
+
+void Debugger::AddBreakpoint(uint16_t address) {
+    this->breakpoints_[address >> 6] |= (uint64_t)1 << (address & 63);
+}
+
+void Debugger::RemoveBreakpoint(uint16_t address) {
+    this->breakpoints_[address >> 6] &= ~((uint64_t)1 << (address & 63));
+}
+
+bool Debugger::hasBreakpoint(uint16_t address) {
+    return ((this->breakpoints_[address >> 6] >> (address & 63)) & 1) != 0;
+}
+
+bool Debugger::AddWatchpoint(uint16_t address, uint32_t length, uint8_t watch) {
+    for (uint32_t i = 0; i < length && i < 65536; i++) {
+        uint16_t watched = (uint16_t)(address + i);
+        uint64_t bit = (uint64_t)1 << (watched & 63);
+
+        if ((watch & WATCH_READS) > 0) {
+            this->read_watches_[watched >> 6] |= bit;
+        }
+        if ((watch & WATCH_WRITES) > 0) {
+            this->write_watches_[watched >> 6] |= bit;
+        }
+    }
+
+    if (!this->UpdateWatchedPages()) {
+        this->RemoveWatchpoint(address, length, watch);
+        return false;
+    }
+    return true;
+}
+
+void Debugger::RemoveWatchpoint(uint16_t address, uint32_t length, uint8_t watch) {
+    for (uint32_t i = 0; i < length && i < 65536; i++) {
+        uint16_t watched = (uint16_t)(address + i);
+        uint64_t bit = (uint64_t)1 << (watched & 63);
+
+        if ((watch & WATCH_READS) > 0) {
+            this->read_watches_[watched >> 6] &= ~bit;
+        }
+        if ((watch & WATCH_WRITES) > 0) {
+            this->write_watches_[watched >> 6] &= ~bit;
+        }
+    }
+
+    this->UpdateWatchedPages();
+}
+
+bool Debugger::isWatched(uint16_t address, uint8_t watch) {
+    const uint64_t* bitmap = watch == WATCH_READS ? this->read_watches_ : this->write_watches_;
+    return ((bitmap[address >> 6] >> (address & 63)) & 1) != 0;
+}
+
+void Debugger::ClearAll() {
+    memset(this->breakpoints_, 0, sizeof(this->breakpoints_));
+    memset(this->read_watches_, 0, sizeof(this->read_watches_));
+    memset(this->write_watches_, 0, sizeof(this->write_watches_));
+    this->UpdateWatchedPages();
+}
+
+bool Debugger::PageHasBits(const uint64_t* bitmap, int page) {
+    // A page is four words of the bitmap
+    const uint64_t* words = bitmap + page * 4;
+    return (words[0] | words[1] | words[2] | words[3]) != 0;
+}
+
+bool Debugger::UpdateWatchedPages() {
+    SM83State* state = this->game_boy_->state();
+
+    // Watches change rarely, so the pages are rebuilt from scratch rather than patched
+    state->RemoveMemoryObserver(this);
+
+    for (int page = 0; page < 256; page++) {
+        uint8_t watch = 0;
+        if (PageHasBits(this->read_watches_, page)) {
+            watch = watch | WATCH_READS;
+        }
+        if (PageHasBits(this->write_watches_, page)) {
+            watch = watch | WATCH_WRITES;
+        }
+
+        if (watch != 0 && !state->AddMemoryObserver(this, (uint8_t)page, (uint8_t)page, watch)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+StopReason Debugger::RunInstruction() {
+    this->watch_hit_ = STOP_NONE;
+
+    try {
+        this->game_boy_->StepInstruction();
+    } catch (const std::runtime_error& error) {
+        this->fault_ = error.what();
+        return STOP_FAULT;
+    }
+
+    if (this->watch_hit_ != STOP_NONE) {
+        this->stop_address_ = this->watch_address_;
+    }
+    return this->watch_hit_;
+}
+
+StopReason Debugger::Step() {
+    StopReason reason = this->RunInstruction();
+
+    this->stop_reason_ = reason == STOP_NONE ? STOP_STEP : reason;
+    return this->stop_reason_;
+}
+
+StopReason Debugger::Continue(uint64_t max_instructions) {
+    SM83State* state = this->game_boy_->state();
+
+    // The first instruction runs even if it has a breakpoint, which is the one being continued from
+    StopReason reason = this->RunInstruction();
+    uint64_t executed = 1;
+
+    while (reason == STOP_NONE) {
+        uint16_t pc = state->programCounter();
+
+        if (((this->breakpoints_[pc >> 6] >> (pc & 63)) & 1) != 0) {
+            reason = STOP_BREAKPOINT;
+            this->stop_address_ = pc;
+        } else if (max_instructions > 0 && executed >= max_instructions) {
+            reason = STOP_LIMIT;
+        } else {
+            reason = this->RunInstruction();
+            executed++;
+        }
+    }
+
+    this->stop_reason_ = reason;
+    return reason;
+}
+
+StopReason Debugger::stopReason() {
+    return this->stop_reason_;
+}
+
+uint16_t Debugger::stopAddress() {
+    return this->stop_address_;
+}
+
+const std::string& Debugger::fault() {
+    return this->fault_;
+}
+
+void Debugger::OnMemoryWrite(uint16_t address, uint8_t value) {
+    if (this->watch_hit_ == STOP_NONE && this->isWatched(address, WATCH_WRITES)) {
+        this->watch_hit_ = STOP_WATCH_WRITE;
+        this->watch_address_ = address;
+    }
+}
+
+bool Debugger::IsFetch(uint16_t address) {
+    // Handlers read their operands before moving PC, so PC is still the start of the instruction
+    uint16_t pc = this->game_boy_->state()->programCounter();
+    uint8_t op_code = this->game_boy_->memory()[pc];
+    uint8_t length = op_code == CB_PREFIX ? 2 : OpCodeInfoFor(op_code).length;
+
+    return (uint16_t)(address - pc) < length;
+}
+
+bool Debugger::OnMemoryRead(uint16_t address, uint8_t* value) {
+    if (this->watch_hit_ == STOP_NONE && this->isWatched(address, WATCH_READS) && !this->IsFetch(address)) {
+        this->watch_hit_ = STOP_WATCH_READ;
+        this->watch_address_ = address;
+    }
+    return false;
+}
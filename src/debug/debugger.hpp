@@ -0,0 +1,218 @@
+/**
+ * @file debugger.hpp
+ * @brief Execute breakpoints and memory watchpoints for a GameBoy
+ *
+ */
+
+#ifndef DEBUGGER_H
+#define DEBUGGER_H
+
+#include <cstdint>
+#include <string>
+#include "../core/game_boy.hpp"
+#include "../cpu/memory_observer.hpp"
+
+// One bit for every address on the memory bus
+static const int ADDRESS_BITMAP_WORDS = 65536 / 64;
+
+/**
+ * @brief Why the debugger handed control back
+ *
+ */
+enum StopReason {
+    STOP_NONE,
+    STOP_STEP,
+    STOP_BREAKPOINT,
+    STOP_WATCH_READ,
+    STOP_WATCH_WRITE,
+    STOP_LIMIT,
+    STOP_FAULT
+};
+
+/**
+ * @brief Runs a GameBoy an instruction at a time, stopping at breakpoints and watched accesses.
+ *
+ * Breakpoints are kept in a bitmap with one bit per address and are only tested by Continue, between
+ * instructions, so a machine run with RunFrame pays nothing for them. Watchpoints are kept in read
+ * and write bitmaps, and the debugger only registers as a MemoryObserver on the pages holding a
+ * watched address. Accesses to every other page stay on the memory bus fast path.
+ *
+ * A watchpoint stops the machine after the instruction making the access has completed. Fetching the
+ * bytes of the instruction being executed is not a read, as in GDB, so running watched code does not
+ * stop the machine. Reads whose
+ * value is supplied by an observer registered before the debugger, such as OAM DMA blocking the bus,
+ * may not be reported.
+ */
+class Debugger : public MemoryObserver
+{
+
+private:
+
+    GameBoy* game_boy_;
+
+    uint64_t breakpoints_[ADDRESS_BITMAP_WORDS];
+    uint64_t read_watches_[ADDRESS_BITMAP_WORDS];
+    uint64_t write_watches_[ADDRESS_BITMAP_WORDS];
+
+    // Set by the memory observer callbacks during an instruction
+    StopReason watch_hit_;
+    uint16_t watch_address_;
+
+    StopReason stop_reason_;
+    uint16_t stop_address_;
+    std::string fault_;
+
+    /**
+     * @brief Gets whether any address of a page is set in a bitmap
+     *
+     * @param bitmap The bitmap to test
+     * @param page The page (address >> 8)
+     */
+    static bool PageHasBits(const uint64_t* bitmap, int page);
+
+    /**
+     * @brief Gets whether an address is one of the bytes of the instruction at PC
+     *
+     * @param address The address being read
+     */
+    bool IsFetch(uint16_t address);
+
+    /**
+     * @brief Registers the debugger on exactly the pages that hold watched addresses
+     *
+     * @return true if the memory bus had a free observer slot, or no page is watched
+     */
+    bool UpdateWatchedPages();
+
+    /**
+     * @brief Runs one instruction and records why it should stop, if it should
+     *
+     * @return StopReason STOP_NONE to keep running, STOP_FAULT or a watchpoint reason otherwise
+     */
+    StopReason RunInstruction();
+
+public:
+    /**
+     * @brief Constructs a new Debugger with no breakpoints or watchpoints
+     *
+     * @param game_boy The machine to debug, which must outlive the debugger
+     */
+    Debugger(GameBoy* game_boy);
+
+    ~Debugger();
+
+    /**
+     * @brief Gets the machine being debugged
+     *
+     */
+    GameBoy* gameBoy();
+
+    /**
+     * @brief Stops execution before the instruction at an address
+     *
+     * @param address The address of the instruction
+     */
+    void AddBreakpoint(uint16_t address);
+
+    /**
+     * @brief Removes a breakpoint. Does nothing if there is none at the address
+     *
+     * @param address The address of the instruction
+     */
+    void RemoveBreakpoint(uint16_t address);
+
+    /**
+     * @brief Gets whether there is a breakpoint at an address
+     *
+     * @param address The address to test
+     */
+    bool hasBreakpoint(uint16_t address);
+
+    /**
+     * @brief Stops execution after CPU accesses to a range of addresses
+     *
+     * @param address The first watched address
+     * @param length The number of addresses watched, wrapping at 0xFFFF
+     * @param watch WATCH_WRITES, WATCH_READS or both
+     * @return true if the watchpoint was added, false if the memory bus had no free observer slot
+     */
+    bool AddWatchpoint(uint16_t address, uint32_t length, uint8_t watch);
+
+    /**
+     * @brief Stops watching a range of addresses
+     *
+     * @param address The first address
+     * @param length The number of addresses, wrapping at 0xFFFF
+     * @param watch The kinds of access to stop watching
+     */
+    void RemoveWatchpoint(uint16_t address, uint32_t length, uint8_t watch);
+
+    /**
+     * @brief Gets whether accesses to an address are watched
+     *
+     * @param address The address to test
+     * @param watch WATCH_WRITES or WATCH_READS
+     */
+    bool isWatched(uint16_t address, uint8_t watch);
+
+    /**
+     * @brief Removes every breakpoint and watchpoint
+     *
+     */
+    void ClearAll();
+
+    /**
+     * @brief Runs a single instruction, ignoring any breakpoint at the program counter
+     *
+     * @return StopReason STOP_STEP, a watchpoint reason, or STOP_FAULT
+     */
+    StopReason Step();
+
+    /**
+     * @brief Runs until a breakpoint, a watched access or a fault.
+     *
+     * A breakpoint at the program counter when called does not stop it, so continuing from a
+     * breakpoint always makes progress.
+     *
+     * @param max_instructions Instructions to run before returning STOP_LIMIT, or 0 for no limit
+     * @return StopReason Why execution stopped
+     */
+    StopReason Continue(uint64_t max_instructions = 0);
+
+    /**
+     * @brief Gets why execution last stopped
+     *
+     */
+    StopReason stopReason();
+
+    /**
+     * @brief Gets the address of the access that triggered the last watchpoint stop
+     *
+     */
+    uint16_t stopAddress();
+
+    /**
+     * @brief Gets the message of the exception behind the last STOP_FAULT
+     *
+     */
+    const std::string& fault();
+
+    /**
+     * @brief Records a watched write
+     *
+     * @param address The 16bit address written to
+     * @param value The value written
+     */
+    void OnMemoryWrite(uint16_t address, uint8_t value) override;
+
+    /**
+     * @brief Records a watched read, leaving the value to memory
+     *
+     * @param address The 16bit address being read
+     * @param value Unused
+     * @return false, the debugger never supplies values
+     */
+    bool OnMemoryRead(uint16_t address, uint8_t* value) override;
+};
+
+#endif
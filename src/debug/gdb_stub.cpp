@@ -0,0 +1,553 @@
+/**
+ * @file gdb_stub.cpp
+ * @brief Implementation of the GDB remote serial protocol server
+ *
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include "./gdb_stub.hpp"
+
+// Signals reported in stop replies
+static const int SIGNAL_INT = 2;
+static const int SIGNAL_ILL = 4;
+static const int SIGNAL_TRAP = 5;
+
+// Sent by GDB on its own, outside any packet, to interrupt a running target
+static const char INTERRUPT_BYTE = 0x03;
+
+#ifdef MSG_NOSIGNAL
+static const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static const int SEND_FLAGS = 0;
+#endif
+
+static const char HEX_DIGITS[] = "0123456789abcdef";
+
+static int HexValue(char digit) {
+    if (digit >= '0' && digit <= '9') {
+        return digit - '0';
+    }
+    if (digit >= 'a' && digit <= 'f') {
+        return digit - 'a' + 10;
+    }
+    if (digit >= 'A' && digit <= 'F') {
+        return digit - 'A' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief Parses a hex number, stopping at the first character that is not a hex digit
+ *
+ * @param text The text to parse
+ * @param position The index to start at, moved past the digits
+ * @param value Receives the number
+ * @return true if there was at least one digit
+ */
+static bool ParseHex(const std::string& text, size_t* position, uint32_t* value) {
+    size_t start = *position;
+    *value = 0;
+
+    while (*position < text.size() && HexValue(text[*position]) >= 0) {
+        *value = (*value << 4) | (uint32_t)HexValue(text[*position]);
+        (*position)++;
+    }
+    return *position > start;
+}
+
+static void AppendHexByte(std::string* text, uint8_t value) {
+    text->push_back(HEX_DIGITS[value >> 4]);
+    text->push_back(HEX_DIGITS[value & 0x0F]);
+}
+
+/**
+ * @brief Decodes a byte from two hex digits
+ *
+ * @return int The byte, or -1 if the digits are missing or invalid
+ */
+static int DecodeHexByte(const std::string& text, size_t position) {
+    if (position + 1 >= text.size()) {
+        return -1;
+    }
+
+    int high = HexValue(text[position]);
+    int low = HexValue(text[position + 1]);
+    if (high < 0 || low < 0) {
+        return -1;
+    }
+    return (high << 4) | low;
+}
+
+GDBStub::GDBStub(Debugger* debugger) {
+    this->debugger_ = debugger;
+    this->listen_socket_ = -1;
+    this->client_socket_ = -1;
+    this->port_ = 0;
+    this->detached_ = false;
+    this->killed_ = false;
+    this->last_stop_ = "T05";
+}
+
+GDBStub::~GDBStub() {
+    if (this->client_socket_ >= 0) {
+        close(this->client_socket_);
+    }
+    if (this->listen_socket_ >= 0) {
+        close(this->listen_socket_);
+    }
+}
+
+bool GDBStub::Listen(uint16_t port) {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0) {
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    // Only the local machine can attach, the protocol has no authentication
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+
+    socklen_t length = sizeof(address);
+    if (bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 1) != 0
+        || getsockname(listener, (sockaddr*)&address, &length) != 0) {
+        close(listener);
+        return false;
+    }
+
+    if (this->listen_socket_ >= 0) {
+        close(this->listen_socket_);
+    }
+    this->listen_socket_ = listener;
+    this->port_ = ntohs(address.sin_port);
+    return true;
+}
+
+uint16_t GDBStub::port() {
+    return this->port_;
+}
+
+bool GDBStub::Serve() {
+    if (this->listen_socket_ < 0) {
+        return false;
+    }
+
+    this->client_socket_ = accept(this->listen_socket_, nullptr, nullptr);
+    if (this->client_socket_ < 0) {
+        return false;
+    }
+
+    // Packets are small and each waits on a reply, so batching only adds latency
+    int no_delay = 1;
+    setsockopt(this->client_socket_, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+
+    this->detached_ = false;
+    this->killed_ = false;
+
+    std::string packet;
+    while (!this->detached_ && this->ReceivePacket(&packet)) {
+        std::string reply = this->HandlePacket(packet);
+
+        // A kill is never acknowledged
+        if (this->killed_ || !this->SendPacket(reply)) {
+            break;
+        }
+    }
+
+    close(this->client_socket_);
+    this->client_socket_ = -1;
+    return true;
+}
+
+bool GDBStub::ReceivePacket(std::string* packet) {
+    char byte;
+
+    while (true) {
+        // Acknowledgements and stray interrupts between packets are skipped
+        do {
+            if (recv(this->client_socket_, &byte, 1, 0) != 1) {
+                return false;
+            }
+        } while (byte != '$');
+
+        packet->clear();
+        uint8_t sum = 0;
+        bool escaped = false;
+
+        while (true) {
+            if (recv(this->client_socket_, &byte, 1, 0) != 1) {
+                return false;
+            }
+            if (byte == '#') {
+                break;
+            }
+
+            sum = (uint8_t)(sum + (uint8_t)byte);
+            if (escaped) {
+                packet->push_back((char)(byte ^ 0x20));
+                escaped = false;
+            } else if (byte == '}') {
+                escaped = true;
+            } else {
+                packet->push_back(byte);
+            }
+        }
+
+        char checksum[2];
+        for (int i = 0; i < 2; i++) {
+            if (recv(this->client_socket_, &checksum[i], 1, 0) != 1) {
+                return false;
+            }
+        }
+
+        bool valid = HexValue(checksum[0]) >= 0 && HexValue(checksum[1]) >= 0
+            && (HexValue(checksum[0]) << 4 | HexValue(checksum[1])) == sum;
+        char ack = valid ? '+' : '-';
+        if (send(this->client_socket_, &ack, 1, SEND_FLAGS) != 1) {
+            return false;
+        }
+        if (valid) {
+            return true;
+        }
+    }
+}
+
+bool GDBStub::SendPacket(const std::string& payload) {
+    std::string framed = Frame(payload);
+    size_t sent = 0;
+
+    while (sent < framed.size()) {
+        ssize_t result = send(this->client_socket_, framed.data() + sent, framed.size() - sent, SEND_FLAGS);
+        if (result <= 0) {
+            return false;
+        }
+        sent += (size_t)result;
+    }
+    return true;
+}
+
+bool GDBStub::InterruptRequested() {
+    if (this->client_socket_ < 0) {
+        return false;
+    }
+
+    char byte;
+    while (recv(this->client_socket_, &byte, 1, MSG_DONTWAIT) == 1) {
+        if (byte == INTERRUPT_BYTE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string GDBStub::HandlePacket(const std::string& packet) {
+    if (packet.empty()) {
+        return "";
+    }
+
+    SM83State* state = this->debugger_->gameBoy()->state();
+    uint8_t* memory = this->debugger_->gameBoy()->memory();
+    size_t position = 1;
+    uint32_t value;
+    std::string reply;
+
+    switch (packet[0]) {
+        case '?':
+            return this->last_stop_;
+
+        case 'g':
+            for (int i = 0; i < GDB_REGISTER_COUNT; i++) {
+                uint16_t register_value = this->ReadRegister(i);
+                AppendHexByte(&reply, (uint8_t)register_value);
+                AppendHexByte(&reply, (uint8_t)(register_value >> 8));
+            }
+            return reply;
+
+        case 'G':
+            if (packet.size() < 1 + GDB_REGISTER_COUNT * 4) {
+                return "E01";
+            }
+            for (int i = 0; i < GDB_REGISTER_COUNT; i++) {
+                int low = DecodeHexByte(packet, 1 + i * 4);
+                int high = DecodeHexByte(packet, 3 + i * 4);
+                if (low < 0 || high < 0) {
+                    return "E01";
+                }
+                this->WriteRegister(i, (uint16_t)(high << 8 | low));
+            }
+            return "OK";
+
+        case 'p':
+            if (!ParseHex(packet, &position, &value) || value >= GDB_REGISTER_COUNT) {
+                return "E01";
+            }
+            AppendHexByte(&reply, (uint8_t)this->ReadRegister((int)value));
+            AppendHexByte(&reply, (uint8_t)(this->ReadRegister((int)value) >> 8));
+            return reply;
+
+        case 'P': {
+            uint32_t index;
+            if (!ParseHex(packet, &position, &index) || index >= GDB_REGISTER_COUNT
+                || position >= packet.size() || packet[position] != '=') {
+                return "E01";
+            }
+            int low = DecodeHexByte(packet, position + 1);
+            int high = DecodeHexByte(packet, position + 3);
+            if (low < 0 || high < 0) {
+                return "E01";
+            }
+            this->WriteRegister((int)index, (uint16_t)(high << 8 | low));
+            return "OK";
+        }
+
+        case 'm': {
+            uint32_t length;
+            if (!ParseHex(packet, &position, &value) || position >= packet.size() || packet[position++] != ','
+                || !ParseHex(packet, &position, &length)) {
+                return "E01";
+            }
+            // Each byte takes two characters of the reply
+            if (length > GDB_PACKET_SIZE / 2) {
+                length = GDB_PACKET_SIZE / 2;
+            }
+            for (uint32_t i = 0; i < length; i++) {
+                AppendHexByte(&reply, memory[(uint16_t)(value + i)]);
+            }
+            return reply;
+        }
+
+        case 'M': {
+            uint32_t length;
+            if (!ParseHex(packet, &position, &value) || position >= packet.size() || packet[position++] != ','
+                || !ParseHex(packet, &position, &length) || position >= packet.size() || packet[position++] != ':'
+                || packet.size() < position + length * 2) {
+                return "E01";
+            }
+            for (uint32_t i = 0; i < length; i++) {
+                int byte = DecodeHexByte(packet, position + i * 2);
+                if (byte < 0) {
+                    return "E01";
+                }
+                memory[(uint16_t)(value + i)] = (uint8_t)byte;
+            }
+            return "OK";
+        }
+
+        case 'c':
+        case 's':
+            // An optional address to resume from
+            if (ParseHex(packet, &position, &value)) {
+                state->setProgramCounter((uint16_t)value);
+            }
+            return this->Resume(packet[0] == 's');
+
+        case 'Z':
+        case 'z':
+            return this->HandleBreakpoint(packet);
+
+        case 'D':
+            this->debugger_->ClearAll();
+            this->detached_ = true;
+            return "OK";
+
+        case 'k':
+            this->killed_ = true;
+            return "";
+
+        case 'H':
+        case 'T':
+            // There is a single thread
+            return "OK";
+
+        case 'q':
+            if (packet.compare(0, 10, "qSupported") == 0) {
+                char supported[32];
+                snprintf(supported, sizeof(supported), "PacketSize=%zx", GDB_PACKET_SIZE);
+                return supported;
+            }
+            if (packet == "qAttached") {
+                return "1";
+            }
+            if (packet == "qC") {
+                return "QC1";
+            }
+            if (packet == "qfThreadInfo") {
+                return "m1";
+            }
+            if (packet == "qsThreadInfo") {
+                return "l";
+            }
+            return "";
+
+        default:
+            return "";
+    }
+}
+
+std::string GDBStub::HandleBreakpoint(const std::string& packet) {
+    bool insert = packet[0] == 'Z';
+    size_t position = 1;
+    uint32_t type;
+    uint32_t address;
+    uint32_t length;
+
+    if (!ParseHex(packet, &position, &type) || position >= packet.size() || packet[position++] != ','
+        || !ParseHex(packet, &position, &address) || position >= packet.size() || packet[position++] != ','
+        || !ParseHex(packet, &position, &length)) {
+        return "E01";
+    }
+
+    uint8_t watch;
+    switch (type) {
+        case 0:
+        case 1:
+            // Software and hardware breakpoints share the bitmap
+            if (insert) {
+                this->debugger_->AddBreakpoint((uint16_t)address);
+            } else {
+                this->debugger_->RemoveBreakpoint((uint16_t)address);
+            }
+            return "OK";
+        case 2:
+            watch = WATCH_WRITES;
+            break;
+        case 3:
+            watch = WATCH_READS;
+            break;
+        case 4:
+            watch = WATCH_READS | WATCH_WRITES;
+            break;
+        default:
+            return "";
+    }
+
+    if (insert) {
+        return this->debugger_->AddWatchpoint((uint16_t)address, length, watch) ? "OK" : "E01";
+    }
+    this->debugger_->RemoveWatchpoint((uint16_t)address, length, watch);
+    return "OK";
+}
+
+std::string GDBStub::Resume(bool step) {
+    StopReason reason;
+
+    if (step) {
+        reason = this->debugger_->Step();
+    } else {
+        do {
+            reason = this->debugger_->Continue(GDB_INTERRUPT_SLICE);
+        } while (reason == STOP_LIMIT && !this->InterruptRequested());
+    }
+
+    this->last_stop_ = this->StopReply(reason);
+    return this->last_stop_;
+}
+
+std::string GDBStub::StopReply(StopReason reason) {
+    char reply[32];
+    uint16_t address = this->debugger_->stopAddress();
+
+    switch (reason) {
+        case STOP_WATCH_READ:
+        case STOP_WATCH_WRITE: {
+            // GDB matches the kind against the watchpoint it inserted
+            const char* kind = reason == STOP_WATCH_READ ? "rwatch" : "watch";
+            if (this->debugger_->isWatched(address, WATCH_READS) && this->debugger_->isWatched(address, WATCH_WRITES)) {
+                kind = "awatch";
+            }
+            snprintf(reply, sizeof(reply), "T%02x%s:%04x;", SIGNAL_TRAP, kind, address);
+            break;
+        }
+        case STOP_FAULT:
+            snprintf(reply, sizeof(reply), "T%02x", SIGNAL_ILL);
+            break;
+        case STOP_LIMIT:
+            snprintf(reply, sizeof(reply), "T%02x", SIGNAL_INT);
+            break;
+        default:
+            snprintf(reply, sizeof(reply), "T%02x", SIGNAL_TRAP);
+            break;
+    }
+    return reply;
+}
+
+uint16_t GDBStub::ReadRegister(int index) {
+    SM83State* state = this->debugger_->gameBoy()->state();
+
+    switch (index) {
+        case GDB_AF:
+            return state->af();
+        case GDB_BC:
+            return state->bc();
+        case GDB_DE:
+            return state->de();
+        case GDB_HL:
+            return state->hl();
+        case GDB_SP:
+            return state->stackPointer();
+        case GDB_PC:
+            return state->programCounter();
+        default:
+            return 0;
+    }
+}
+
+void GDBStub::WriteRegister(int index, uint16_t value) {
+    SM83State* state = this->debugger_->gameBoy()->state();
+
+    switch (index) {
+        case GDB_AF:
+            state->setAF(value);
+            break;
+        case GDB_BC:
+            state->setBC(value);
+            break;
+        case GDB_DE:
+            state->setDE(value);
+            break;
+        case GDB_HL:
+            state->setHL(value);
+            break;
+        case GDB_SP:
+            state->setStackPointer(value);
+            break;
+        case GDB_PC:
+            state->setProgramCounter(value);
+            break;
+        default:
+            break;
+    }
+}
+
+bool GDBStub::detached() {
+    return this->detached_;
+}
+
+bool GDBStub::killed() {
+    return this->killed_;
+}
+
+uint8_t GDBStub::Checksum(const std::string& payload) {
+    uint8_t sum = 0;
+    for (char byte : payload) {
+        sum = (uint8_t)(sum + (uint8_t)byte);
+    }
+    return sum;
+}
+
+std::string GDBStub::Frame(const std::string& payload) {
+    std::string framed = "$" + payload + "#";
+    AppendHexByte(&framed, Checksum(payload));
+    return framed;
+}
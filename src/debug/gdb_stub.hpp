@@ -0,0 +1,195 @@
+/**
+ * @file gdb_stub.hpp
+ * @brief GDB remote serial protocol server for the debugger
+ *
+ */
+
+#ifndef GDB_STUB_H
+#define GDB_STUB_H
+
+#include <cstdint>
+#include <string>
+#include "./debugger.hpp"
+
+// Largest packet accepted from the client, advertised in qSupported
+static const size_t GDB_PACKET_SIZE = 0x4000;
+
+// Instructions run between checks for an interrupt from the client while continuing
+static const uint64_t GDB_INTERRUPT_SLICE = 65536;
+
+// Registers in the order of GDB's z80 target, all 16 bits. The SM83 has no IX, IY, IR or shadow set
+enum GDBRegister {
+    GDB_AF,
+    GDB_BC,
+    GDB_DE,
+    GDB_HL,
+    GDB_SP,
+    GDB_PC,
+    GDB_IX,
+    GDB_IY,
+    GDB_AF_SHADOW,
+    GDB_BC_SHADOW,
+    GDB_DE_SHADOW,
+    GDB_HL_SHADOW,
+    GDB_IR,
+    GDB_REGISTER_COUNT
+};
+
+/**
+ * @brief Serves one GDB client on a local TCP port.
+ *
+ * Registers are presented in the layout of GDB's z80 target, so `gdb -ex "set architecture z80"
+ * -ex "target remote :PORT"` can attach, and any other client speaking the remote protocol sees the
+ * same packets. Supported packets are ?, g, G, p, P, m, M, c, s, Z0 to Z4, z0 to z4, D, k and the
+ * queries GDB needs to attach. Memory read or written by the client goes straight to the bus, so it
+ * never trips a watchpoint or reaches an I/O register's observer.
+ *
+ * While the machine runs the socket is polled every GDB_INTERRUPT_SLICE instructions for the
+ * interrupt byte GDB sends on Ctrl-C.
+ */
+class GDBStub
+{
+
+private:
+
+    Debugger* debugger_;
+
+    int listen_socket_;
+    int client_socket_;
+    uint16_t port_;
+
+    // Set by D or k, ending Serve
+    bool detached_;
+    bool killed_;
+
+    // The reply to ?, updated whenever the machine stops
+    std::string last_stop_;
+
+    /**
+     * @brief Resumes the machine and waits for it to stop
+     *
+     * @param step true to run a single instruction
+     * @return std::string The stop reply
+     */
+    std::string Resume(bool step);
+
+    /**
+     * @brief Gets whether the client has sent an interrupt, without blocking
+     *
+     */
+    bool InterruptRequested();
+
+    /**
+     * @brief Builds the stop reply for the debugger's last stop
+     *
+     * @param reason Why the machine stopped
+     */
+    std::string StopReply(StopReason reason);
+
+    /**
+     * @brief Reads one packet from the client, acknowledging it
+     *
+     * @param packet Receives the packet payload
+     * @return true if a packet was read, false if the client went away
+     */
+    bool ReceivePacket(std::string* packet);
+
+    /**
+     * @brief Sends a packet to the client
+     *
+     * @param payload The packet payload
+     * @return true if it was sent
+     */
+    bool SendPacket(const std::string& payload);
+
+    /**
+     * @brief Gets the value of a register in the z80 layout
+     *
+     * @param index A GDBRegister
+     */
+    uint16_t ReadRegister(int index);
+
+    /**
+     * @brief Sets a register in the z80 layout. Registers the SM83 lacks are ignored
+     *
+     * @param index A GDBRegister
+     * @param value The new value
+     */
+    void WriteRegister(int index, uint16_t value);
+
+    /**
+     * @brief Handles Z and z packets
+     *
+     * @param packet The packet
+     * @return std::string OK, E01 for a malformed packet or no free slot, or empty if unsupported
+     */
+    std::string HandleBreakpoint(const std::string& packet);
+
+public:
+    /**
+     * @brief Constructs a new GDBStub
+     *
+     * @param debugger The debugger controlling the machine
+     */
+    GDBStub(Debugger* debugger);
+
+    ~GDBStub();
+
+    /**
+     * @brief Listens on a port of the loopback interface
+     *
+     * @param port The TCP port, or 0 to let the system pick one
+     * @return true if listening
+     */
+    bool Listen(uint16_t port);
+
+    /**
+     * @brief Gets the port being listened on
+     *
+     */
+    uint16_t port();
+
+    /**
+     * @brief Waits for a client and serves it until it detaches, kills the target or disconnects
+     *
+     * @return true if a client was served
+     */
+    bool Serve();
+
+    /**
+     * @brief Handles one packet, resuming the machine if asked to
+     *
+     * @param packet The packet payload, without framing
+     * @return std::string The reply payload. Empty for unsupported packets, as the protocol requires
+     */
+    std::string HandlePacket(const std::string& packet);
+
+    /**
+     * @brief Gets whether the client has detached
+     *
+     */
+    bool detached();
+
+    /**
+     * @brief Gets whether the client has killed the target
+     *
+     */
+    bool killed();
+
+    /**
+     * @brief Computes the checksum of a packet payload
+     *
+     * @param payload The payload
+     * @return uint8_t The sum of its bytes modulo 256
+     */
+    static uint8_t Checksum(const std::string& payload);
+
+    /**
+     * @brief Frames a payload as $payload#checksum
+     *
+     * @param payload The payload
+     */
+    static std::string Frame(const std::string& payload);
+};
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * @file diff.cpp
+ * @brief Runs a ROM on the interpreter and the lockstep engine together and reports where they differ
+ *
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+#include "./cpu/cpu_engine.hpp"
+#include "./cpu/differential_checker.hpp"
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr, "Usage: %s [--cycles N] [--interval N] [--lanes N] [--trace N] ROM\n", program);
+    fprintf(stderr, "  --cycles N    Cycles to run, default 70224000 (1000 frames)\n");
+    fprintf(stderr, "  --interval N  Cycles between state comparisons, default 65536\n");
+    fprintf(stderr, "  --lanes N     Lockstep instances to run, only the first is compared, default 1\n");
+    fprintf(stderr, "  --trace N     Instructions of each engine printed on a divergence, default 32\n");
+}
+
+int main(int argc, char *argv[])
+{
+    const char* rom_path = nullptr;
+    long long cycles = 70224000;
+    long interval = 65536;
+    long lanes = 1;
+    long trace = 32;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--cycles") == 0 && i + 1 < argc) {
+            cycles = strtoll(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+            interval = strtol(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--lanes") == 0 && i + 1 < argc) {
+            lanes = strtol(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace = strtol(argv[++i], nullptr, 10);
+        } else if (argv[i][0] != '-' && rom_path == nullptr) {
+            rom_path = argv[i];
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (rom_path == nullptr || cycles <= 0 || interval <= 0 || lanes <= 0 || trace <= 0) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    std::ifstream file(rom_path, std::ios::binary);
+    if (!file) {
+        fprintf(stderr, "Could not read %s\n", rom_path);
+        return 1;
+    }
+    std::vector<uint8_t> rom((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // ROM beyond the end of a small image reads as an open bus, as on the GameBoy
+    std::vector<uint8_t> memory(0x10000, 0);
+    memset(memory.data(), 0xFF, ENGINE_ROM_SIZE);
+    memcpy(memory.data(), rom.data(), rom.size() < ENGINE_ROM_SIZE ? rom.size() : ENGINE_ROM_SIZE);
+
+    // DMG register values after the boot ROM hands over
+    SM83State registers(memory.data());
+    registers.setAF(0x01B0);
+    registers.setBC(0x0013);
+    registers.setDE(0x00D8);
+    registers.setHL(0x014D);
+    registers.setStackPointer(0xFFFE);
+    registers.setProgramCounter(0x0100);
+
+    InterpreterEngine interpreter;
+    LockstepEngine lockstep((size_t)lanes);
+    DifferentialChecker checker(&interpreter, &lockstep, (uint32_t)interval, (size_t)trace);
+
+    bool agreed;
+    try {
+        agreed = checker.Run(&registers, memory.data(), (uint64_t)cycles);
+    } catch (const std::runtime_error& error) {
+        // Both engines stop on the same unimplemented op codes, so reaching one is not a divergence
+        fprintf(stderr, "%s\n", error.what());
+        return 1;
+    }
+
+    if (!agreed) {
+        checker.WriteReport(stdout);
+        return 1;
+    }
+
+    printf("%s and %s agree over %lld cycles, %" PRIu64 " comparisons\n",
+        interpreter.name(), lockstep.name(), cycles, checker.checks());
+    return 0;
+}
@@ -0,0 +1,197 @@
+/**
+ * @file async_file_writer.cpp
+ * @brief Implementation of the background file writer
+ *
+ */
+
+#include <chrono>
+#include <cstring>
+#include "./async_file_writer.hpp"
+
+// Upper bound on a wait for a wake up, in case one is missed
+static const std::chrono::milliseconds WAKE_INTERVAL(10);
+
+AsyncFileWriter::AsyncFileWriter(size_t buffer_size, size_t buffer_count)
+    : buffers_(buffer_count < 2 ? 2 : buffer_count, std::vector<uint8_t>(buffer_size)),
+      filled_(buffers_.size()), filled_sizes_(buffers_.size(), 0), free_(buffers_.size()),
+      closing_(false), failed_(false) {
+    this->file_ = nullptr;
+    this->buffer_size_ = buffer_size;
+    this->current_ = 0;
+    this->used_ = 0;
+    this->bytes_ = 0;
+    this->stalls_ = 0;
+
+    for (size_t i = 1; i < this->buffers_.size(); i++) {
+        this->free_.TryPush(i);
+    }
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    this->Close();
+}
+
+bool AsyncFileWriter::Open(const char* path) {
+    this->Close();
+
+    this->file_ = fopen(path, "wb");
+    if (this->file_ == nullptr) {
+        return false;
+    }
+
+    this->used_ = 0;
+    this->bytes_ = 0;
+    this->stalls_ = 0;
+    this->closing_.store(false);
+    this->failed_.store(false);
+    this->thread_ = std::thread(&AsyncFileWriter::WriterLoop, this);
+    return true;
+}
+
+uint8_t* AsyncFileWriter::Reserve(size_t size) {
+    if (size > this->buffer_size_) {
+        return nullptr;
+    }
+    if (this->used_ + size > this->buffer_size_) {
+        this->HandOff();
+    }
+    return this->buffers_[this->current_].data() + this->used_;
+}
+
+void AsyncFileWriter::Commit(size_t size) {
+    this->used_ += size;
+    this->bytes_ += size;
+}
+
+void AsyncFileWriter::Write(const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+
+    while (size > 0) {
+        if (this->used_ == this->buffer_size_) {
+            this->HandOff();
+        }
+
+        size_t room = this->buffer_size_ - this->used_;
+        size_t count = size < room ? size : room;
+        memcpy(this->buffers_[this->current_].data() + this->used_, bytes, count);
+        this->Commit(count);
+        bytes += count;
+        size -= count;
+    }
+}
+
+void AsyncFileWriter::HandOff() {
+    if (this->used_ == 0) {
+        return;
+    }
+
+    this->filled_sizes_[this->current_] = this->used_;
+    this->filled_.TryPush(this->current_);
+    {
+        std::lock_guard<std::mutex> lock(this->wake_mutex_);
+    }
+    this->wake_writer_.notify_one();
+
+    if (!this->free_.TryPop(&this->current_)) {
+        // Every buffer is queued, the disk has fallen behind
+        this->stalls_++;
+        std::unique_lock<std::mutex> lock(this->wake_mutex_);
+        while (!this->free_.TryPop(&this->current_)) {
+            this->wake_producer_.wait_for(lock, WAKE_INTERVAL);
+        }
+    }
+    this->used_ = 0;
+}
+
+void AsyncFileWriter::WriterLoop() {
+    while (true) {
+        size_t index;
+
+        if (this->filled_.TryPop(&index)) {
+            size_t size = this->filled_sizes_[index];
+            if (!this->failed_.load(std::memory_order_relaxed) && fwrite(this->buffers_[index].data(), 1, size, this->file_) != size) {
+                this->failed_.store(true);
+            }
+
+            this->free_.TryPush(index);
+            {
+                std::lock_guard<std::mutex> lock(this->wake_mutex_);
+            }
+            this->wake_producer_.notify_one();
+            continue;
+        }
+
+        // Everything pushed before closing_ was set has been written by now
+        if (this->closing_.load(std::memory_order_acquire)) {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(this->wake_mutex_);
+        this->wake_writer_.wait_for(lock, WAKE_INTERVAL, [this]() {
+            return this->filled_.size() > 0 || this->closing_.load(std::memory_order_acquire);
+        });
+    }
+}
+
+bool AsyncFileWriter::Flush() {
+    if (this->file_ == nullptr) {
+        return false;
+    }
+
+    this->HandOff();
+
+    // Every buffer but the current one comes back once it has been written
+    std::unique_lock<std::mutex> lock(this->wake_mutex_);
+    while (this->free_.size() < this->buffers_.size() - 1) {
+        this->wake_producer_.wait_for(lock, WAKE_INTERVAL);
+    }
+    lock.unlock();
+
+    if (fflush(this->file_) != 0) {
+        this->failed_.store(true);
+    }
+    return !this->failed_.load();
+}
+
+bool AsyncFileWriter::Rewrite(uint64_t offset, const void* data, size_t size) {
+    if (!this->Flush()) {
+        return false;
+    }
+
+    // The writer thread is idle until more is handed off, so the file can be used from here
+    bool written = fseek(this->file_, (long)offset, SEEK_SET) == 0
+        && fwrite(data, 1, size, this->file_) == size
+        && fseek(this->file_, 0, SEEK_END) == 0;
+    if (!written) {
+        this->failed_.store(true);
+    }
+    return written;
+}
+
+bool AsyncFileWriter::Close() {
+    if (this->file_ == nullptr) {
+        return false;
+    }
+
+    this->HandOff();
+    this->closing_.store(true, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(this->wake_mutex_);
+    }
+    this->wake_writer_.notify_one();
+    this->thread_.join();
+
+    if (fclose(this->file_) != 0) {
+        this->failed_.store(true);
+    }
+    this->file_ = nullptr;
+    return !this->failed_.load();
+}
+
+uint64_t AsyncFileWriter::bytesWritten() {
+    return this->bytes_;
+}
+
+uint64_t AsyncFileWriter::stalls() {
+    return this->stalls_;
+}
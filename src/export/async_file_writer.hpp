@@ -0,0 +1,159 @@
+/**
+ * @file async_file_writer.hpp
+ * @brief Buffered file output drained by a background thread
+ *
+ */
+
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../util/spsc_ring_buffer.hpp"
+
+static const size_t DEFAULT_WRITE_BUFFER_SIZE = 4 << 20;
+static const size_t DEFAULT_WRITE_BUFFER_COUNT = 8;
+
+/**
+ * @brief Writes a file from a background thread so the producer never waits on the disk.
+ *
+ * Data is copied into one of a fixed set of large buffers allocated up front. When a buffer fills
+ * it is handed to the writer thread through an SPSCRingBuffer and the producer carries on with the
+ * next free one. The producer only waits if every buffer is queued, which means the disk is slower
+ * than the producer over the whole buffered span. Such waits are counted by stalls().
+ *
+ * One thread writes and one thread runs the writer, so the class is not safe to share further.
+ */
+class AsyncFileWriter
+{
+
+private:
+
+    FILE* file_;
+    std::thread thread_;
+
+    std::vector<std::vector<uint8_t>> buffers_;
+    size_t buffer_size_;
+
+    // Buffers passed to the writer thread with the number of bytes used, and buffers ready for reuse
+    SPSCRingBuffer<size_t> filled_;
+    std::vector<size_t> filled_sizes_;
+    SPSCRingBuffer<size_t> free_;
+
+    // The buffer being filled by the producer and the bytes used in it
+    size_t current_;
+    size_t used_;
+
+    // Wakes the writer thread when there is work, and the producer when a buffer is freed
+    std::mutex wake_mutex_;
+    std::condition_variable wake_writer_;
+    std::condition_variable wake_producer_;
+    std::atomic<bool> closing_;
+
+    std::atomic<bool> failed_;
+    uint64_t bytes_;
+    uint64_t stalls_;
+
+    /**
+     * @brief Body of the writer thread
+     *
+     */
+    void WriterLoop();
+
+    /**
+     * @brief Queues the current buffer for writing and takes the next free one, waiting if there is none
+     *
+     */
+    void HandOff();
+
+public:
+    /**
+     * @brief Constructs a new AsyncFileWriter, allocating all of its buffers
+     *
+     * @param buffer_size Bytes per buffer, also the largest size Reserve accepts
+     * @param buffer_count The number of buffers
+     */
+    AsyncFileWriter(size_t buffer_size = DEFAULT_WRITE_BUFFER_SIZE, size_t buffer_count = DEFAULT_WRITE_BUFFER_COUNT);
+
+    /**
+     * @brief Closes the file if it is still open
+     *
+     */
+    ~AsyncFileWriter();
+
+    /**
+     * @brief Creates or truncates a file and starts the writer thread
+     *
+     * @param path The file to write
+     * @return true if the file could be opened
+     */
+    bool Open(const char* path);
+
+    /**
+     * @brief Gets space for the next bytes of the file, to be filled and then passed to Commit
+     *
+     * @param size The number of bytes needed
+     * @return uint8_t* The space, valid until the next call, or nullptr if size is larger than a buffer, in which
+     * case the bytes must go through Write instead
+     */
+    uint8_t* Reserve(size_t size);
+
+    /**
+     * @brief Adds bytes filled in after Reserve to the file
+     *
+     * @param size The number of bytes filled, at most the size reserved
+     */
+    void Commit(size_t size);
+
+    /**
+     * @brief Copies bytes to the end of the file
+     *
+     * @param data The bytes
+     * @param size The number of bytes
+     */
+    void Write(const void* data, size_t size);
+
+    /**
+     * @brief Waits until everything written so far is in the file
+     *
+     * @return true if nothing has failed
+     */
+    bool Flush();
+
+    /**
+     * @brief Overwrites bytes already in the file, such as a header holding the final size. Flushes first
+     *
+     * @param offset The position in the file
+     * @param data The bytes
+     * @param size The number of bytes
+     * @return true if the bytes were written
+     */
+    bool Rewrite(uint64_t offset, const void* data, size_t size);
+
+    /**
+     * @brief Flushes, stops the writer thread and closes the file
+     *
+     * @return true if every byte was written
+     */
+    bool Close();
+
+    /**
+     * @brief Gets the number of bytes passed to the writer so far
+     *
+     */
+    uint64_t bytesWritten();
+
+    /**
+     * @brief Gets the number of times the producer had to wait for a free buffer
+     *
+     */
+    uint64_t stalls();
+};
+
+#endif
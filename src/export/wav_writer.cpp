@@ -0,0 +1,100 @@
+/**
+ * @file wav_writer.cpp
+ * @brief Implementation of the WAV writer
+ *
+ */
+
+#include <cstring>
+#include "./wav_writer.hpp"
+
+static const uint16_t WAV_CHANNELS = 2;
+static const uint16_t WAV_BITS = 16;
+static const uint16_t WAV_FORMAT_PCM = 1;
+
+// Samples are converted a chunk at a time straight into the writer's buffer
+static const size_t CONVERT_CHUNK = 4096;
+
+static_assert(CONVERT_CHUNK * 4 <= DEFAULT_WRITE_BUFFER_SIZE, "A converted chunk must fit in one write buffer");
+
+static void Put16(uint8_t* out, uint16_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static void Put32(uint8_t* out, uint32_t value) {
+    Put16(out, (uint16_t)value);
+    Put16(out + 2, (uint16_t)(value >> 16));
+}
+
+WavWriter::WavWriter(uint32_t sample_rate) {
+    this->sample_rate_ = sample_rate;
+    this->samples_ = 0;
+}
+
+void WavWriter::BuildHeader(uint64_t samples, uint8_t* header) {
+    uint32_t block = WAV_CHANNELS * WAV_BITS / 8;
+    uint64_t data_size = samples * block;
+
+    // Sizes beyond 4GB cannot be represented, saturate so players still read what they can
+    uint32_t data = data_size > 0xFFFFFFFF - WAV_HEADER_SIZE ? (uint32_t)(0xFFFFFFFF - WAV_HEADER_SIZE) : (uint32_t)data_size;
+
+    memcpy(header, "RIFF", 4);
+    Put32(header + 4, (uint32_t)(data + WAV_HEADER_SIZE - 8));
+    memcpy(header + 8, "WAVEfmt ", 8);
+    Put32(header + 16, 16);
+    Put16(header + 20, WAV_FORMAT_PCM);
+    Put16(header + 22, WAV_CHANNELS);
+    Put32(header + 24, this->sample_rate_);
+    Put32(header + 28, this->sample_rate_ * block);
+    Put16(header + 32, (uint16_t)block);
+    Put16(header + 34, WAV_BITS);
+    memcpy(header + 36, "data", 4);
+    Put32(header + 40, data);
+}
+
+bool WavWriter::Open(const char* path) {
+    if (!this->writer_.Open(path)) {
+        return false;
+    }
+
+    uint8_t header[WAV_HEADER_SIZE];
+    this->BuildHeader(0, header);
+    this->writer_.Write(header, sizeof(header));
+    this->samples_ = 0;
+    return true;
+}
+
+void WavWriter::WriteSamples(const float* samples, size_t count) {
+    this->samples_ += count;
+
+    while (count > 0) {
+        size_t chunk = count < CONVERT_CHUNK ? count : CONVERT_CHUNK;
+        uint8_t* out = this->writer_.Reserve(chunk * 4);
+
+        for (size_t i = 0; i < chunk * 2; i++) {
+            float sample = samples[i];
+            sample = sample > 1.0f ? 1.0f : (sample < -1.0f ? -1.0f : sample);
+            Put16(out + i * 2, (uint16_t)(int16_t)(sample * 32767.0f));
+        }
+
+        this->writer_.Commit(chunk * 4);
+        samples += chunk * 2;
+        count -= chunk;
+    }
+}
+
+bool WavWriter::Close() {
+    uint8_t header[WAV_HEADER_SIZE];
+    this->BuildHeader(this->samples_, header);
+
+    bool rewritten = this->writer_.Rewrite(0, header, sizeof(header));
+    return this->writer_.Close() && rewritten;
+}
+
+uint64_t WavWriter::samplesWritten() {
+    return this->samples_;
+}
+
+uint64_t WavWriter::stalls() {
+    return this->writer_.stalls();
+}
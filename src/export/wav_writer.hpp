@@ -0,0 +1,82 @@
+/**
+ * @file wav_writer.hpp
+ * @brief 16 bit stereo PCM WAV output
+ *
+ */
+
+#ifndef WAV_WRITER_H
+#define WAV_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include "./async_file_writer.hpp"
+
+// Size of the RIFF, fmt and data chunk headers
+static const size_t WAV_HEADER_SIZE = 44;
+
+/**
+ * @brief Streams float samples to a WAV file as 16 bit PCM.
+ *
+ * The header is written with zero sizes and patched when the file is closed, so samples can be
+ * appended as they are produced without knowing the length up front.
+ */
+class WavWriter
+{
+
+private:
+
+    AsyncFileWriter writer_;
+    uint32_t sample_rate_;
+    uint64_t samples_;
+
+    /**
+     * @brief Builds the header for a given number of stereo samples
+     *
+     */
+    void BuildHeader(uint64_t samples, uint8_t* header);
+
+public:
+    /**
+     * @brief Constructs a new WavWriter
+     *
+     * @param sample_rate Stereo samples per second
+     */
+    WavWriter(uint32_t sample_rate);
+
+    /**
+     * @brief Creates the file and writes a placeholder header
+     *
+     * @param path The file to write
+     * @return true if the file could be opened
+     */
+    bool Open(const char* path);
+
+    /**
+     * @brief Appends samples, clamped to -1.0 to 1.0
+     *
+     * @param samples Interleaved stereo samples
+     * @param count The number of stereo samples
+     */
+    void WriteSamples(const float* samples, size_t count);
+
+    /**
+     * @brief Fills in the header sizes and closes the file
+     *
+     * @return true if the whole file was written
+     */
+    bool Close();
+
+    /**
+     * @brief Gets the number of stereo samples written
+     *
+     */
+    uint64_t samplesWritten();
+
+    /**
+     * @brief Gets the number of times samples had to wait for the disk
+     *
+     */
+    uint64_t stalls();
+};
+
+#endif
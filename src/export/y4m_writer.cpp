@@ -0,0 +1,110 @@
+/**
+ * @file y4m_writer.cpp
+ * @brief Implementation of the Y4M writer
+ *
+ */
+
+#include <cstdio>
+#include <cstring>
+#include "./y4m_writer.hpp"
+
+static const char FRAME_HEADER[] = "FRAME\n";
+static const size_t FRAME_HEADER_SIZE = sizeof(FRAME_HEADER) - 1;
+
+/**
+ * @brief Converts a pixel to studio range BT.601 luma
+ *
+ */
+static inline uint8_t Luma(uint32_t pixel) {
+    int r = (pixel >> 16) & 0xFF;
+    int g = (pixel >> 8) & 0xFF;
+    int b = pixel & 0xFF;
+    return (uint8_t)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+}
+
+Y4MWriter::Y4MWriter(int width, int height, uint32_t rate_numerator, uint32_t rate_denominator) {
+    this->width_ = width;
+    this->height_ = height;
+    this->rate_numerator_ = rate_numerator;
+    this->rate_denominator_ = rate_denominator;
+    this->frames_ = 0;
+}
+
+bool Y4MWriter::Open(const char* path) {
+    if (!this->writer_.Open(path)) {
+        return false;
+    }
+
+    char header[128];
+    int length = snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%u:%u Ip A1:1 C420jpeg\n",
+        this->width_, this->height_, this->rate_numerator_, this->rate_denominator_);
+    this->writer_.Write(header, (size_t)length);
+    this->frames_ = 0;
+    return true;
+}
+
+void Y4MWriter::WriteFrame(const uint32_t* pixels) {
+    int width = this->width_;
+    int height = this->height_;
+    size_t luma_size = (size_t)width * height;
+    size_t chroma_size = luma_size / 4;
+
+    size_t frame_size = FRAME_HEADER_SIZE + luma_size + chroma_size * 2;
+    uint8_t* out = this->writer_.Reserve(frame_size);
+    bool reserved = out != nullptr;
+    if (!reserved) {
+        this->large_frame_.resize(frame_size);
+        out = this->large_frame_.data();
+    }
+
+    memcpy(out, FRAME_HEADER, FRAME_HEADER_SIZE);
+    uint8_t* y_plane = out + FRAME_HEADER_SIZE;
+    uint8_t* u_plane = y_plane + luma_size;
+    uint8_t* v_plane = u_plane + chroma_size;
+
+    for (size_t i = 0; i < luma_size; i++) {
+        y_plane[i] = Luma(pixels[i]);
+    }
+
+    // Chroma from the average of each 2x2 block
+    for (int y = 0; y < height; y += 2) {
+        const uint32_t* top = pixels + y * width;
+        const uint32_t* bottom = top + width;
+
+        for (int x = 0; x < width; x += 2) {
+            int r = 0;
+            int g = 0;
+            int b = 0;
+            const uint32_t block[4] = { top[x], top[x + 1], bottom[x], bottom[x + 1] };
+            for (uint32_t pixel : block) {
+                r += (pixel >> 16) & 0xFF;
+                g += (pixel >> 8) & 0xFF;
+                b += pixel & 0xFF;
+            }
+
+            // Sums of four pixels, so the usual divide by 256 becomes 1024
+            size_t index = (y / 2) * (width / 2) + x / 2;
+            u_plane[index] = (uint8_t)(((-38 * r - 74 * g + 112 * b + 512) >> 10) + 128);
+            v_plane[index] = (uint8_t)(((112 * r - 94 * g - 18 * b + 512) >> 10) + 128);
+        }
+    }
+
+    if (reserved) {
+        this->writer_.Commit(frame_size);
+    } else {
+        this->writer_.Write(out, frame_size);
+    }
+    this->frames_++;
+}
+
+bool Y4MWriter::Close() {
+    return this->writer_.Close();
+}
+
+uint64_t Y4MWriter::framesWritten() {
+    return this->frames_;
+}
+
+uint64_t Y4MWriter::stalls() {
+    return this->writer_.stalls();
+}
@@ -0,0 +1,82 @@
+/**
+ * @file y4m_writer.hpp
+ * @brief Uncompressed YUV4MPEG2 video output
+ *
+ */
+
+#ifndef Y4M_WRITER_H
+#define Y4M_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "./async_file_writer.hpp"
+
+/**
+ * @brief Streams ARGB8888 frames to a Y4M file as 4:2:0 BT.601 video.
+ *
+ * Y4M is a plain header followed by raw planes, which ffmpeg and most encoders read directly.
+ * Each frame is converted straight into the writer's buffer.
+ */
+class Y4MWriter
+{
+
+private:
+
+    AsyncFileWriter writer_;
+    int width_;
+    int height_;
+    uint32_t rate_numerator_;
+    uint32_t rate_denominator_;
+    uint64_t frames_;
+
+    // Frames too large for one write buffer are converted here and copied in with Write
+    std::vector<uint8_t> large_frame_;
+
+public:
+    /**
+     * @brief Constructs a new Y4MWriter
+     *
+     * @param width The frame width, even
+     * @param height The frame height, even
+     * @param rate_numerator Frame rate numerator
+     * @param rate_denominator Frame rate denominator
+     */
+    Y4MWriter(int width, int height, uint32_t rate_numerator, uint32_t rate_denominator);
+
+    /**
+     * @brief Creates the file and writes the stream header
+     *
+     * @param path The file to write
+     * @return true if the file could be opened
+     */
+    bool Open(const char* path);
+
+    /**
+     * @brief Appends a frame
+     *
+     * @param pixels width x height ARGB8888 pixels in row order
+     */
+    void WriteFrame(const uint32_t* pixels);
+
+    /**
+     * @brief Closes the file
+     *
+     * @return true if the whole file was written
+     */
+    bool Close();
+
+    /**
+     * @brief Gets the number of frames written
+     *
+     */
+    uint64_t framesWritten();
+
+    /**
+     * @brief Gets the number of times frames had to wait for the disk
+     *
+     */
+    uint64_t stalls();
+};
+
+#endif
@@ -0,0 +1,287 @@
+/**
+ * @file sdl_frontend.cpp
+ * @brief Implementation of the SDL frontend
+ *
+ */
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include "./sdl_frontend.hpp"
+
+// Duration of a DMG frame, 70224 dots at 4194304Hz
+static const std::chrono::nanoseconds FRAME_DURATION(16742706);
+
+// How far the emulation thread may fall behind its clock before it stops trying to catch up
+static const int MAX_FRAMES_BEHIND = 4;
+
+// Samples per audio callback, and the buffering the stream aims for
+static const Uint16 AUDIO_DEVICE_SAMPLES = 512;
+static const uint32_t AUDIO_LATENCY_MS = 60;
+
+SDLFrontend::SDLFrontend(GameBoy* game_boy, bool turbo, ScaleFilter filter, int factor, bool audio) : frames_(SCREEN_PIXELS), running_(false) {
+    this->game_boy_ = game_boy;
+    this->turbo_ = turbo;
+    this->filter_ = filter;
+    this->factor_ = FilterFactor(filter, factor);
+    this->window_ = nullptr;
+    this->renderer_ = nullptr;
+    this->texture_ = nullptr;
+    this->vsync_ = false;
+    this->audio_ = audio;
+    this->audio_device_ = 0;
+    this->audio_stream_ = nullptr;
+
+    // Room for a couple of frames, in case the machine ever ends a frame late
+    this->audio_batch_.resize(game_boy->sampleRate() / 30 * 2);
+}
+
+SDLFrontend::~SDLFrontend() {
+    this->running_.store(false, std::memory_order_release);
+    if (this->emulation_thread_.joinable()) {
+        this->emulation_thread_.join();
+    }
+    this->game_boy_->SetFramebuffer(nullptr);
+
+    // Closing the device waits for the callback, after which the stream can go
+    if (this->audio_device_ != 0) {
+        SDL_CloseAudioDevice(this->audio_device_);
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    }
+    delete this->audio_stream_;
+
+    if (this->texture_ != nullptr) {
+        SDL_DestroyTexture(this->texture_);
+    }
+    if (this->renderer_ != nullptr) {
+        SDL_DestroyRenderer(this->renderer_);
+    }
+    if (this->window_ != nullptr) {
+        SDL_DestroyWindow(this->window_);
+    }
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+}
+
+bool SDLFrontend::Open(const char* title, int scale) {
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0) {
+        this->error_ = SDL_GetError();
+        return false;
+    }
+
+    this->window_ = SDL_CreateWindow(
+        title,
+        SDL_WINDOWPOS_UNDEFINED,
+        SDL_WINDOWPOS_UNDEFINED,
+        SCREEN_WIDTH * scale,
+        SCREEN_HEIGHT * scale,
+        SDL_WINDOW_RESIZABLE
+    );
+    if (this->window_ == nullptr) {
+        this->error_ = SDL_GetError();
+        return false;
+    }
+
+    // Prefer a vsynced accelerated renderer, falling back to software for drivers without one
+    this->renderer_ = SDL_CreateRenderer(this->window_, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    if (this->renderer_ == nullptr) {
+        this->renderer_ = SDL_CreateRenderer(this->window_, -1, SDL_RENDERER_SOFTWARE);
+    }
+    if (this->renderer_ == nullptr) {
+        this->error_ = SDL_GetError();
+        return false;
+    }
+
+    SDL_RendererInfo info;
+    this->vsync_ = SDL_GetRendererInfo(this->renderer_, &info) == 0 && (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+
+    SDL_RenderSetLogicalSize(this->renderer_, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+    this->texture_ = SDL_CreateTexture(
+        this->renderer_,
+        SDL_PIXELFORMAT_ARGB8888,
+        SDL_TEXTUREACCESS_STREAMING,
+        SCREEN_WIDTH * this->factor_,
+        SCREEN_HEIGHT * this->factor_
+    );
+    if (this->texture_ == nullptr) {
+        this->error_ = SDL_GetError();
+        return false;
+    }
+
+    if (this->audio_ && !this->OpenAudio()) {
+        this->audio_ = false;
+    }
+
+    return true;
+}
+
+bool SDLFrontend::OpenAudio() {
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0) {
+        return false;
+    }
+
+    SDL_AudioSpec desired;
+    SDL_AudioSpec obtained;
+    memset(&desired, 0, sizeof(desired));
+    desired.freq = (int)this->game_boy_->sampleRate();
+    desired.format = AUDIO_F32SYS;
+    desired.channels = 2;
+    desired.samples = AUDIO_DEVICE_SAMPLES;
+    desired.callback = &SDLFrontend::AudioCallback;
+    desired.userdata = this;
+
+    // Devices open paused, so the stream can be created once the device's rate is known
+    this->audio_device_ = SDL_OpenAudioDevice(nullptr, 0, &desired, &obtained, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+    if (this->audio_device_ == 0) {
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return false;
+    }
+
+    size_t latency = (size_t)obtained.freq * AUDIO_LATENCY_MS / 1000;
+    if (latency < (size_t)obtained.samples * 2) {
+        latency = (size_t)obtained.samples * 2;
+    }
+    this->audio_stream_ = new AudioStream(this->game_boy_->sampleRate(), (uint32_t)obtained.freq, latency);
+    return true;
+}
+
+void SDLFrontend::AudioCallback(void* userdata, Uint8* stream, int length) {
+    SDLFrontend* frontend = (SDLFrontend*)userdata;
+    frontend->audio_stream_->Read((float*)stream, (size_t)length / (2 * sizeof(float)));
+}
+
+void SDLFrontend::QueueAudio() {
+    size_t count = this->audio_batch_.size() / 2;
+
+    if (this->audio_stream_ == nullptr) {
+        this->game_boy_->ReadAudio(nullptr, this->game_boy_->audioSamplesAvailable());
+        return;
+    }
+
+    while (this->game_boy_->audioSamplesAvailable() > 0) {
+        size_t read = this->game_boy_->ReadAudio(this->audio_batch_.data(), count);
+        this->audio_stream_->Write(this->audio_batch_.data(), read);
+    }
+}
+
+bool SDLFrontend::Run(uint64_t max_frames) {
+    uint64_t presented = 0;
+    std::string present_error;
+
+    this->running_.store(true, std::memory_order_release);
+    this->emulation_thread_ = std::thread(&SDLFrontend::EmulationLoop, this);
+
+    // Plays silence until the first frame's samples arrive
+    if (this->audio_device_ != 0) {
+        SDL_PauseAudioDevice(this->audio_device_, 0);
+    }
+
+    while (this->running_.load(std::memory_order_acquire)) {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_QUIT || (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE)) {
+                this->running_.store(false, std::memory_order_release);
+            }
+        }
+
+        bool fresh = this->frames_.Acquire();
+        if (fresh) {
+            if (!this->UploadFrame(this->frames_.ReadBuffer())) {
+                present_error = SDL_GetError();
+                this->running_.store(false, std::memory_order_release);
+                break;
+            }
+            presented++;
+        }
+
+        // Presenting blocks until vsync when it is available, otherwise wait a little for the next frame
+        if (fresh || this->vsync_) {
+            SDL_RenderClear(this->renderer_);
+            SDL_RenderCopy(this->renderer_, this->texture_, nullptr, nullptr);
+            SDL_RenderPresent(this->renderer_);
+        } else {
+            SDL_Delay(1);
+        }
+
+        if (max_frames > 0 && presented >= max_frames) {
+            this->running_.store(false, std::memory_order_release);
+        }
+    }
+
+    this->emulation_thread_.join();
+
+    if (!present_error.empty()) {
+        this->error_ = present_error;
+    }
+    return this->error_.empty();
+}
+
+bool SDLFrontend::audioOpen() {
+    return this->audio_stream_ != nullptr;
+}
+
+AudioStream* SDLFrontend::audioStream() {
+    return this->audio_stream_;
+}
+
+const std::string& SDLFrontend::error() {
+    return this->error_;
+}
+
+void SDLFrontend::EmulationLoop() {
+    auto next_frame = std::chrono::steady_clock::now();
+
+    while (this->running_.load(std::memory_order_acquire)) {
+        this->game_boy_->SetFramebuffer(this->frames_.WriteBuffer());
+
+        try {
+            this->game_boy_->RunFrame();
+        } catch (const std::runtime_error& error) {
+            this->error_ = error.what();
+            this->running_.store(false, std::memory_order_release);
+            break;
+        }
+
+        // With --deferred the render thread may still be drawing into the write buffer
+        this->game_boy_->framebuffer();
+        this->frames_.Publish();
+        this->QueueAudio();
+
+        if (this->turbo_) {
+            continue;
+        }
+
+        next_frame += FRAME_DURATION;
+        auto now = std::chrono::steady_clock::now();
+        if (now > next_frame + FRAME_DURATION * MAX_FRAMES_BEHIND) {
+            // Too far behind to catch up, such as after the process was suspended
+            next_frame = now;
+        } else {
+            std::this_thread::sleep_until(next_frame);
+        }
+    }
+}
+
+bool SDLFrontend::UploadFrame(const uint32_t* frame) {
+    void* pixels;
+    int pitch;
+
+    if (SDL_LockTexture(this->texture_, nullptr, &pixels, &pitch) != 0) {
+        return false;
+    }
+
+    uint8_t* row = (uint8_t*)pixels;
+    if (this->factor_ > 1) {
+        // The filters write straight into texture memory, so scaling costs no extra copy
+        ScaleFrame(this->filter_, this->factor_, frame, SCREEN_WIDTH, SCREEN_HEIGHT, (uint32_t*)pixels, pitch / (int)sizeof(uint32_t));
+    } else if (pitch == SCREEN_WIDTH * (int)sizeof(uint32_t)) {
+        memcpy(row, frame, SCREEN_PIXELS * sizeof(uint32_t));
+    } else {
+        for (int y = 0; y < SCREEN_HEIGHT; y++) {
+            memcpy(row + y * pitch, frame + y * SCREEN_WIDTH, SCREEN_WIDTH * sizeof(uint32_t));
+        }
+    }
+
+    SDL_UnlockTexture(this->texture_);
+    return true;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file sdl_frontend.hpp
+ * @brief SDL window and audio device fed by a machine emulated on a separate thread
+ *
+ */
+
+#ifndef SDL_FRONTEND_H
+#define SDL_FRONTEND_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include <SDL.h>
+#include "../audio/audio_stream.hpp"
+#include "../core/game_boy.hpp"
+#include "../util/triple_buffer.hpp"
+#include "../video/scale_filters.hpp"
+
+/**
+ * @brief Runs a GameBoy on an emulation thread and presents its frames from the calling thread.
+ *
+ * The emulation thread draws each frame straight into the back buffer of a TripleBuffer and
+ * publishes it, pacing itself with its own clock so it never waits on vsync. The present thread
+ * picks up the newest complete frame, copies it once into a streaming texture through
+ * SDL_LockTexture and presents with vsync, so a frame is never shown half drawn.
+ *
+ * Each frame's audio is written to an AudioStream, which the SDL audio callback reads from without
+ * locking. The stream's rate control absorbs the difference between the emulation thread's clock
+ * and the audio device's.
+ *
+ * Works with SDL_VIDEODRIVER=dummy and SDL_AUDIODRIVER=dummy, which is how it is tested without a
+ * display or sound card.
+ */
+class SDLFrontend
+{
+
+private:
+
+    GameBoy* game_boy_;
+    bool turbo_;
+
+    // Applied on the CPU while uploading, the texture is factor_ times the screen size
+    ScaleFilter filter_;
+    int factor_;
+
+    TripleBuffer<uint32_t> frames_;
+
+    // Audio is dropped if it was not requested or the device could not be opened
+    bool audio_;
+    SDL_AudioDeviceID audio_device_;
+    AudioStream* audio_stream_;
+
+    // One batch of samples on its way from the machine to the stream, only used by the emulation thread
+    std::vector<float> audio_batch_;
+
+    std::atomic<bool> running_;
+    std::thread emulation_thread_;
+
+    // Set by the emulation thread before it stops on an error, read after it has been joined
+    std::string error_;
+
+    SDL_Window* window_;
+    SDL_Renderer* renderer_;
+    SDL_Texture* texture_;
+    bool vsync_;
+
+    /**
+     * @brief Body of the emulation thread
+     *
+     */
+    void EmulationLoop();
+
+    /**
+     * @brief Opens the default audio device and the stream feeding it
+     *
+     * @return true on success
+     */
+    bool OpenAudio();
+
+    /**
+     * @brief Moves the audio of the last frame into the stream, or discards it without a device
+     *
+     */
+    void QueueAudio();
+
+    /**
+     * @brief SDL audio callback, fills the device buffer from the stream
+     *
+     * @param userdata The AudioStream
+     * @param stream The device buffer, interleaved stereo floats
+     * @param length The size of the buffer in bytes
+     */
+    static void AudioCallback(void* userdata, Uint8* stream, int length);
+
+    /**
+     * @brief Copies a frame into the streaming texture, scaling it on the way if a filter is set
+     *
+     * @param frame 160x144 ARGB8888 pixels
+     * @return true if the texture could be locked
+     */
+    bool UploadFrame(const uint32_t* frame);
+
+public:
+    /**
+     * @brief Constructs a new SDLFrontend
+     *
+     * @param game_boy The machine to run, with a ROM already loaded
+     * @param turbo Run the emulation as fast as possible rather than at 59.73 frames per second
+     * @param filter The filter applied to each frame before it is uploaded
+     * @param factor The factor passed to FilterFactor. Nearest at 1 uploads frames unscaled and leaves scaling to the renderer
+     * @param audio Play the machine's audio
+     */
+    SDLFrontend(GameBoy* game_boy, bool turbo, ScaleFilter filter, int factor, bool audio);
+
+    /**
+     * @brief Stops the emulation thread and releases the window and audio device
+     *
+     */
+    ~SDLFrontend();
+
+    /**
+     * @brief Creates the window, renderer and streaming texture, and opens the audio device
+     *
+     * Failing to open the audio device is not an error, the machine then runs silently. See audioOpen()
+     *
+     * @param title The window title
+     * @param scale Window pixels per Game Boy pixel
+     * @return true on success, otherwise see error()
+     */
+    bool Open(const char* title, int scale);
+
+    /**
+     * @brief Runs until the window is closed, the emulator stops or max_frames frames have been presented
+     *
+     * @param max_frames The number of new frames to present before returning, 0 for no limit
+     * @return true if the emulator did not stop on an error
+     */
+    bool Run(uint64_t max_frames);
+
+    /**
+     * @brief Gets whether audio is being played
+     *
+     */
+    bool audioOpen();
+
+    /**
+     * @brief Gets the stream feeding the audio device, or nullptr if audio is not being played
+     *
+     */
+    AudioStream* audioStream();
+
+    /**
+     * @brief Gets a description of the last error
+     *
+     */
+    const std::string& error();
+};
+
+#endif
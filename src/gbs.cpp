@@ -0,0 +1,119 @@
+/**
+ * @file gbs.cpp
+ * @brief Renders songs from GBS sound files to WAV as fast as the CPU and APU can run
+ *
+ */
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include "./core/gbs_player.hpp"
+#include "./export/wav_writer.hpp"
+#include "./ppu/ppu_registers.hpp"
+
+static const uint32_t DMG_CLOCK_RATE = 4194304;
+
+// Playback is run and drained a frame at a time, well within what the APU can hold
+static const uint32_t PLAY_CHUNK_DOTS = DOTS_PER_FRAME;
+static const size_t AUDIO_CHUNK = 4096;
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr, "Usage: %s [--song N] [--seconds S] [--wav PATH] GBS\n", program);
+    fprintf(stderr, "  --song N        Song to play, from 1 (default the file's first song)\n");
+    fprintf(stderr, "  --seconds S     Length of audio to render (default 60)\n");
+    fprintf(stderr, "  --wav PATH      Write the audio to PATH as 16 bit stereo WAV\n");
+}
+
+int main(int argc, char *argv[])
+{
+    const char* gbs_path = nullptr;
+    const char* wav_path = nullptr;
+    long song = 0;
+    double seconds = 60;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--song") == 0 && i + 1 < argc) {
+            song = strtol(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = strtod(argv[++i], nullptr);
+        } else if (strcmp(argv[i], "--wav") == 0 && i + 1 < argc) {
+            wav_path = argv[++i];
+        } else if (argv[i][0] != '-' && gbs_path == nullptr) {
+            gbs_path = argv[i];
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (gbs_path == nullptr || seconds <= 0) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    GBSPlayer player;
+    if (!player.LoadFile(gbs_path)) {
+        fprintf(stderr, "Could not read a GBS file from %s\n", gbs_path);
+        return 1;
+    }
+
+    const GBSHeader& header = player.header();
+    if (song == 0) {
+        song = header.first_song > 0 ? header.first_song : 1;
+    }
+    printf("%s - %s (%s)\n", header.title, header.author, header.copyright);
+
+    WavWriter wav(player.sampleRate());
+    if (wav_path != nullptr && !wav.Open(wav_path)) {
+        fprintf(stderr, "Could not write %s\n", wav_path);
+        return 1;
+    }
+
+    std::vector<float> audio(AUDIO_CHUNK * 2);
+    uint64_t total_dots = (uint64_t)(seconds * DMG_CLOCK_RATE);
+    uint64_t samples = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    try {
+        if (song < 1 || song > 255 || !player.StartSong((uint8_t)(song - 1))) {
+            fprintf(stderr, "%s has no song %ld\n", gbs_path, song);
+            return 1;
+        }
+
+        // The timer registers hold the file's TAC and TMA, and any changes INIT made, only from here
+        printf("Song %ld of %d, PLAY every %u dots\n", song, header.song_count, player.playPeriod());
+
+        while (player.cycles() < total_dots) {
+            uint64_t remaining = total_dots - player.cycles();
+            player.Run(remaining < PLAY_CHUNK_DOTS ? remaining : PLAY_CHUNK_DOTS);
+
+            size_t count;
+            while ((count = player.ReadAudio(audio.data(), AUDIO_CHUNK)) > 0) {
+                if (wav_path != nullptr) {
+                    wav.WriteSamples(audio.data(), count);
+                }
+                samples += count;
+            }
+        }
+    } catch (const std::runtime_error& error) {
+        fprintf(stderr, "Stopped after %.3fs of audio: %s\n", (double)player.cycles() / DMG_CLOCK_RATE, error.what());
+        wav.Close();
+        return 1;
+    }
+
+    if (wav_path != nullptr && !wav.Close()) {
+        fprintf(stderr, "Could not write %s\n", wav_path);
+        return 1;
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double played = (double)player.cycles() / DMG_CLOCK_RATE;
+    fprintf(stderr, "%.1fs of audio, %" PRIu64 " samples in %.3fs (%.0fx real time)\n",
+        played, samples, elapsed, elapsed > 0 ? played / elapsed : 0);
+
+    return 0;
+}
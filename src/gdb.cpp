@@ -0,0 +1,72 @@
+/**
+ * @file gdb.cpp
+ * @brief Runs a ROM under a GDB remote protocol stub on a local TCP port
+ *
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "./core/game_boy.hpp"
+#include "./debug/debugger.hpp"
+#include "./debug/gdb_stub.hpp"
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr, "Usage: %s [--port N] [--accurate] [--once] ROM\n", program);
+    fprintf(stderr, "  --port N    TCP port on 127.0.0.1 to listen on, default 1234\n");
+    fprintf(stderr, "  --accurate  Draw with the pixel FIFO renderer\n");
+    fprintf(stderr, "  --once      Exit when the first client detaches\n");
+}
+
+int main(int argc, char *argv[])
+{
+    const char* rom_path = nullptr;
+    long port = 1234;
+    bool accurate = false;
+    bool once = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = strtol(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--accurate") == 0) {
+            accurate = true;
+        } else if (strcmp(argv[i], "--once") == 0) {
+            once = true;
+        } else if (argv[i][0] != '-' && rom_path == nullptr) {
+            rom_path = argv[i];
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (rom_path == nullptr || port < 0 || port > 65535) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    GameBoy game_boy(accurate ? ACCURATE_PPU : FAST_PPU);
+    if (!game_boy.LoadROMFile(rom_path)) {
+        fprintf(stderr, "Could not read %s\n", rom_path);
+        return 1;
+    }
+
+    Debugger debugger(&game_boy);
+    GDBStub stub(&debugger);
+    if (!stub.Listen((uint16_t)port)) {
+        fprintf(stderr, "Could not listen on port %ld\n", port);
+        return 1;
+    }
+
+    fprintf(stderr, "Waiting for GDB on 127.0.0.1:%u\n", stub.port());
+
+    // Each client picks up the machine where the last one detached, until one kills it
+    while (stub.Serve()) {
+        if (stub.killed() || once) {
+            break;
+        }
+        fprintf(stderr, "Client detached, waiting for the next one\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,310 @@
+/**
+ * @file headless.cpp
+ * @brief Runs a ROM without a window and prints a hash of every frame, for golden image regression tests.
+ * Can also export the video and audio faster than real time.
+ *
+ */
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include "./core/game_boy.hpp"
+#include "./cpu/execution_trace.hpp"
+#include "./cpu/guest_profiler.hpp"
+#include "./export/wav_writer.hpp"
+#include "./export/y4m_writer.hpp"
+#include "./util/xxhash64.hpp"
+#include "./video/scale_filters.hpp"
+
+// Frames per second of the real hardware, 4194304 / 70224
+static const double DMG_FRAME_RATE = 59.7275;
+static const uint32_t DMG_CLOCK_RATE = 4194304;
+static const uint32_t DMG_DOTS_PER_FRAME = 70224;
+
+// Cycles between guest profiler samples, about 70 per frame
+static const uint32_t DEFAULT_SAMPLE_PERIOD = 1024;
+
+// Instructions kept by --trace, 1MB of records
+static const uint32_t DEFAULT_TRACE_SIZE = 65536;
+
+// Audio read back from the core per call while exporting
+static const size_t EXPORT_AUDIO_CHUNK = 2048;
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr, "Usage: %s [--frames N] [--accurate] [--deferred] [--quiet] [--dump PREFIX] [--y4m PATH] [--wav PATH] [--filter NAME] [--scale N] [--profile N] [--flame PATH] [--sample-period N] [--sym PATH] [--trace PATH] [--trace-size N] ROM\n", program);
+    fprintf(stderr, "  --frames N      Number of frames to run (default 60)\n");
+    fprintf(stderr, "  --accurate      Draw with the pixel FIFO renderer\n");
+    fprintf(stderr, "  --deferred      Draw the same frames as the default renderer on a second thread\n");
+    fprintf(stderr, "  --quiet         Only print the hash of the last frame\n");
+    fprintf(stderr, "  --dump PREFIX   Write every frame to PREFIX00000.ppm, PREFIX00001.ppm, ...\n");
+    fprintf(stderr, "  --y4m PATH      Write the video to PATH as uncompressed YUV4MPEG2\n");
+    fprintf(stderr, "  --wav PATH      Write the audio to PATH as 16 bit stereo WAV\n");
+    fprintf(stderr, "  --filter NAME   Scale dumped and exported frames with nearest, scale2x, scale3x or lcd\n");
+    fprintf(stderr, "  --scale N       Factor for the nearest and lcd filters (default 2 once a filter is set)\n");
+    fprintf(stderr, "  --profile N     Print the N op codes taking the most cycles, needs LAMEBOY_OPCODE_PROFILE\n");
+    fprintf(stderr, "  --flame PATH    Sample the guest PC and call stack, writing folded stacks for flamegraph.pl\n");
+    fprintf(stderr, "  --sample-period N  Cycles between guest samples (default %u)\n", DEFAULT_SAMPLE_PERIOD);
+    fprintf(stderr, "  --sym PATH      Name --flame frames with the labels in an RGBDS .sym file\n");
+    fprintf(stderr, "  --trace PATH    Keep the last instructions in a binary trace, saved to PATH on exit or error\n");
+    fprintf(stderr, "  --trace-size N  Instructions kept by --trace (default %u)\n", DEFAULT_TRACE_SIZE);
+}
+
+/**
+ * @brief Writes ARGB8888 pixels as a binary PPM
+ *
+ * @param path The file to write
+ * @param pixels The pixels in row order
+ * @param width The image width
+ * @param height The image height
+ * @param rgb Scratch space for width x height x 3 bytes
+ * @return true if the file was written
+ */
+static bool WritePPM(const char* path, const uint32_t* pixels, int width, int height, uint8_t* rgb) {
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    for (int i = 0; i < width * height; i++) {
+        rgb[i * 3] = (uint8_t)(pixels[i] >> 16);
+        rgb[i * 3 + 1] = (uint8_t)(pixels[i] >> 8);
+        rgb[i * 3 + 2] = (uint8_t)pixels[i];
+    }
+
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    bool written = fwrite(rgb, 3, (size_t)width * height, file) == (size_t)width * height;
+    return fclose(file) == 0 && written;
+}
+
+/**
+ * @brief Writes the stacks sampled by a guest profiler
+ *
+ * @param path The file to write
+ * @param profiler The profiler
+ * @param symbols Labels for the frames
+ * @return true if the file was written
+ */
+static bool WriteFlame(const char* path, GuestProfiler* profiler, const SymbolTable* symbols) {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+    profiler->WriteFolded(file, symbols);
+    return fclose(file) == 0;
+}
+
+int main(int argc, char *argv[])
+{
+    const char* rom_path = nullptr;
+    long frames = 60;
+    PPUKind ppu_kind = FAST_PPU;
+    bool quiet = false;
+    const char* dump_prefix = nullptr;
+    const char* y4m_path = nullptr;
+    const char* wav_path = nullptr;
+    ScaleFilter filter = NEAREST_FILTER;
+    int scale = 2;
+    bool filtered = false;
+    int profile_count = 0;
+    const char* flame_path = nullptr;
+    int sample_period = DEFAULT_SAMPLE_PERIOD;
+    const char* sym_path = nullptr;
+    const char* trace_path = nullptr;
+    int trace_size = DEFAULT_TRACE_SIZE;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = strtol(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--accurate") == 0) {
+            ppu_kind = ACCURATE_PPU;
+        } else if (strcmp(argv[i], "--deferred") == 0) {
+            ppu_kind = DEFERRED_PPU;
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        } else if (strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+            dump_prefix = argv[++i];
+        } else if (strcmp(argv[i], "--y4m") == 0 && i + 1 < argc) {
+            y4m_path = argv[++i];
+        } else if (strcmp(argv[i], "--wav") == 0 && i + 1 < argc) {
+            wav_path = argv[++i];
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc && ParseScaleFilter(argv[i + 1], &filter)) {
+            filtered = true;
+            i++;
+        } else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc) {
+            scale = atoi(argv[++i]);
+            filtered = true;
+        } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profile_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--flame") == 0 && i + 1 < argc) {
+            flame_path = argv[++i];
+        } else if (strcmp(argv[i], "--sample-period") == 0 && i + 1 < argc) {
+            sample_period = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--sym") == 0 && i + 1 < argc) {
+            sym_path = argv[++i];
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--trace-size") == 0 && i + 1 < argc) {
+            trace_size = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && rom_path == nullptr) {
+            rom_path = argv[i];
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (rom_path == nullptr || frames <= 0 || profile_count < 0 || sample_period <= 0 || trace_size <= 0) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    GameBoy game_boy(ppu_kind);
+    if (!game_boy.LoadROMFile(rom_path)) {
+        fprintf(stderr, "Could not read %s\n", rom_path);
+        return 1;
+    }
+
+    // Buffers for dumping are allocated once, not per frame
+    int factor = filtered ? FilterFactor(filter, scale) : 1;
+    int dump_width = SCREEN_WIDTH * factor;
+    int dump_height = SCREEN_HEIGHT * factor;
+    std::vector<uint32_t> scaled(dump_prefix != nullptr || y4m_path != nullptr ? dump_width * dump_height : 0);
+    std::vector<uint8_t> rgb(dump_prefix != nullptr ? scaled.size() * 3 : 0);
+    std::vector<char> dump_path(dump_prefix != nullptr ? strlen(dump_prefix) + 16 : 0);
+    std::vector<float> audio(wav_path != nullptr ? EXPORT_AUDIO_CHUNK * 2 : 0);
+
+    // Frames and samples are handed to writer threads so the core never waits on the disk
+    Y4MWriter y4m(dump_width, dump_height, DMG_CLOCK_RATE, DMG_DOTS_PER_FRAME);
+    WavWriter wav(game_boy.sampleRate());
+
+    if (y4m_path != nullptr && !y4m.Open(y4m_path)) {
+        fprintf(stderr, "Could not write %s\n", y4m_path);
+        return 1;
+    }
+    if (wav_path != nullptr && !wav.Open(wav_path)) {
+        fprintf(stderr, "Could not write %s\n", wav_path);
+        return 1;
+    }
+
+    SymbolTable symbols;
+    if (sym_path != nullptr && !symbols.LoadSymFile(sym_path)) {
+        fprintf(stderr, "Could not read symbols from %s\n", sym_path);
+        return 1;
+    }
+
+    GuestProfiler profiler((uint32_t)sample_period);
+    if (flame_path != nullptr) {
+        game_boy.cpu()->AddInstructionObserver(&profiler);
+    }
+
+    ExecutionTrace trace(trace_path != nullptr ? trace_size : 1, game_boy.memory());
+    if (trace_path != nullptr) {
+        game_boy.cpu()->SetTrace(&trace);
+    }
+
+    uint64_t hash = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (long frame = 0; frame < frames; frame++) {
+        try {
+            game_boy.RunFrame();
+        } catch (const std::runtime_error& error) {
+            fprintf(stderr, "Stopped in frame %ld: %s\n", frame, error.what());
+            if (profile_count > 0 && game_boy.opCodeProfile() != nullptr) {
+                game_boy.opCodeProfile()->WriteReport(stderr, profile_count);
+            }
+            if (flame_path != nullptr) {
+                WriteFlame(flame_path, &profiler, &symbols);
+            }
+            if (trace_path != nullptr && trace.Save(trace_path)) {
+                fprintf(stderr, "Saved the last %zu instructions to %s\n", trace.size(), trace_path);
+            }
+            return 1;
+        }
+
+        hash = XXHash64(game_boy.framebuffer(), SCREEN_PIXELS * sizeof(uint32_t));
+        if (!quiet) {
+            printf("%ld %016" PRIx64 "\n", frame, hash);
+        }
+
+        if (wav_path != nullptr) {
+            size_t count;
+            while ((count = game_boy.ReadAudio(audio.data(), EXPORT_AUDIO_CHUNK)) > 0) {
+                wav.WriteSamples(audio.data(), count);
+            }
+        } else {
+            game_boy.ReadAudio(nullptr, game_boy.audioSamplesAvailable());
+        }
+
+        const uint32_t* pixels = game_boy.framebuffer();
+        if (factor > 1 && (dump_prefix != nullptr || y4m_path != nullptr)) {
+            ScaleFrame(filter, factor, pixels, SCREEN_WIDTH, SCREEN_HEIGHT, scaled.data(), dump_width);
+            pixels = scaled.data();
+        }
+
+        if (y4m_path != nullptr) {
+            y4m.WriteFrame(pixels);
+        }
+
+        if (dump_prefix != nullptr) {
+            snprintf(dump_path.data(), dump_path.size(), "%s%05ld.ppm", dump_prefix, frame);
+            if (!WritePPM(dump_path.data(), pixels, dump_width, dump_height, rgb.data())) {
+                fprintf(stderr, "Could not write %s\n", dump_path.data());
+                return 1;
+            }
+        }
+    }
+
+    if (quiet) {
+        printf("%ld %016" PRIx64 "\n", frames - 1, hash);
+    }
+
+    // Closing waits for the writers, so the time reported covers the whole export
+    if (y4m_path != nullptr && !y4m.Close()) {
+        fprintf(stderr, "Could not write %s\n", y4m_path);
+        return 1;
+    }
+    if (wav_path != nullptr && !wav.Close()) {
+        fprintf(stderr, "Could not write %s\n", wav_path);
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double fps = seconds > 0 ? frames / seconds : 0;
+    fprintf(stderr, "%ld frames in %.3fs, %.0f fps (%.1fx real time)\n", frames, seconds, fps, fps / DMG_FRAME_RATE);
+
+    if (trace_path != nullptr) {
+        if (!trace.Save(trace_path)) {
+            fprintf(stderr, "Could not write %s\n", trace_path);
+            return 1;
+        }
+        fprintf(stderr, "Saved the last %zu instructions to %s\n", trace.size(), trace_path);
+    }
+
+    if (flame_path != nullptr) {
+        if (!WriteFlame(flame_path, &profiler, &symbols)) {
+            fprintf(stderr, "Could not write %s\n", flame_path);
+            return 1;
+        }
+        fprintf(stderr, "Wrote %" PRIu64 " guest samples to %s\n", profiler.samples(), flame_path);
+    }
+
+    if (profile_count > 0) {
+        if (game_boy.opCodeProfile() != nullptr) {
+            game_boy.opCodeProfile()->WriteReport(stderr, profile_count);
+        } else {
+            fprintf(stderr, "Op code profiling needs a build with -DLAMEBOY_OPCODE_PROFILE=ON\n");
+        }
+    }
+
+    if (y4m_path != nullptr || wav_path != nullptr) {
+        fprintf(stderr, "Exported %" PRIu64 " frames and %" PRIu64 " samples, writers stalled %" PRIu64 " times\n",
+            y4m.framesWritten(), wav.samplesWritten(), y4m.stalls() + wav.stalls());
+    }
+
+    return 0;
+}
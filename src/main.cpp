@@ -1,28 +1,93 @@
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
-#include <SDL.h>
+#include "./core/game_boy.hpp"
+#include "./frontend/sdl_frontend.hpp"
+
+static void PrintUsage(const char* program) {
+  std::cerr << "Usage: " << program << " [--accurate] [--deferred] [--turbo] [--scale N] [--filter NAME] [--frames N] [--mute] ROM" << std::endl;
+  std::cerr << "  --accurate   Draw with the pixel FIFO renderer" << std::endl;
+  std::cerr << "  --deferred   Draw the default renderer's frames on a second thread" << std::endl;
+  std::cerr << "  --turbo      Run as fast as possible" << std::endl;
+  std::cerr << "  --scale N    Window pixels per Game Boy pixel (default 3)" << std::endl;
+  std::cerr << "  --filter F   Scale on the CPU with nearest, scale2x, scale3x or lcd" << std::endl;
+  std::cerr << "  --frames N   Exit after presenting N frames" << std::endl;
+  std::cerr << "  --mute       Do not open an audio device" << std::endl;
+}
 
 int main(int argc, char *argv[])
 {
-  SDL_Init(SDL_INIT_VIDEO);
+  const char* rom_path = nullptr;
+  PPUKind ppu_kind = FAST_PPU;
+  bool turbo = false;
+  int scale = 3;
+  ScaleFilter filter = NEAREST_FILTER;
+  bool filtered = false;
+  uint64_t frames = 0;
+  bool audio = true;
 
-  SDL_Window *window = SDL_CreateWindow(
-    "SDL2Test",
-    SDL_WINDOWPOS_UNDEFINED,
-    SDL_WINDOWPOS_UNDEFINED,
-    640,
-    480,
-    0
-  );
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--accurate") == 0) {
+      ppu_kind = ACCURATE_PPU;
+    } else if (strcmp(argv[i], "--deferred") == 0) {
+      ppu_kind = DEFERRED_PPU;
+    } else if (strcmp(argv[i], "--turbo") == 0) {
+      turbo = true;
+    } else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc) {
+      scale = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      if (!ParseScaleFilter(argv[++i], &filter)) {
+        PrintUsage(argv[0]);
+        return 2;
+      }
+      filtered = true;
+    } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+      frames = strtoull(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--mute") == 0) {
+      audio = false;
+    } else if (argv[i][0] != '-' && rom_path == nullptr) {
+      rom_path = argv[i];
+    } else {
+      PrintUsage(argv[0]);
+      return 2;
+    }
+  }
 
-  SDL_Renderer *renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
-  SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255);
-  SDL_RenderClear(renderer);
-  SDL_RenderPresent(renderer);
+  if (rom_path == nullptr || scale < 1) {
+    PrintUsage(argv[0]);
+    return 2;
+  }
 
-  SDL_Delay(3000);
+  GameBoy game_boy(ppu_kind);
+  if (!game_boy.LoadROMFile(rom_path)) {
+    std::cerr << "Could not read " << rom_path << std::endl;
+    return 1;
+  }
 
-  SDL_DestroyWindow(window);
-  SDL_Quit();
+  if (SDL_Init(0) != 0) {
+    std::cerr << SDL_GetError() << std::endl;
+    return 1;
+  }
+
+  int result = 0;
+  {
+    // Without a filter the renderer does the scaling
+    SDLFrontend frontend(&game_boy, turbo, filter, filtered ? scale : 1, audio);
 
-  return 0;
-}
\ No newline at end of file
+    if (!frontend.Open("LameBoy", scale)) {
+      std::cerr << frontend.error() << std::endl;
+      result = 1;
+    } else {
+      if (audio && !frontend.audioOpen()) {
+        std::cerr << "Audio unavailable, running silently: " << SDL_GetError() << std::endl;
+      }
+      if (!frontend.Run(frames)) {
+        std::cerr << frontend.error() << std::endl;
+        result = 1;
+      }
+    }
+  }
+
+  SDL_Quit();
+  return result;
+}
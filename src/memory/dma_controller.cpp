@@ -0,0 +1,212 @@
+/**
+ * @file dma_controller.cpp
+ * @brief Implementation of the DMA controller
+ *
+ */
+
+#include "./dma_controller.hpp"
+
+// Echo RAM mirrors work RAM, OAM DMA from 0xE000 and above reads it
+static const uint16_t ECHO_START = 0xE000;
+static const uint16_t ECHO_OFFSET = 0x2000;
+
+// The last page the CPU cannot reach during an OAM DMA, HRAM and the IO registers live above it
+static const uint8_t OAM_DMA_LAST_BLOCKED_PAGE = 0xFE;
+
+DMAController::DMAController(uint8_t* memory_bus_ptr, SM83State* state, Scheduler* scheduler, PPUBase* ppu) {
+    this->memory_bus_ = memory_bus_ptr;
+    this->state_ = state;
+    this->scheduler_ = scheduler;
+    this->ppu_ = ppu;
+    this->oam_dma_end_ = 0;
+    this->oam_dma_active_ = false;
+    this->oam_dma_event_ = 0;
+    this->hdma_source_ = 0;
+    this->hdma_destination_ = VRAM_START;
+    this->hdma_remaining_ = 0;
+    this->hdma_event_ = 0;
+    this->stall_cycles_ = 0;
+
+    this->memory_bus_[HDMA5_ADDRESS] = 0xFF;
+    this->state_->AddMemoryObserver(this, 0xFF, 0xFF, WATCH_WRITES);
+}
+
+DMAController::~DMAController() {
+    if (this->oam_dma_active_) {
+        this->scheduler_->Cancel(this->oam_dma_event_);
+    }
+    if (this->hdma_remaining_ > 0) {
+        this->scheduler_->Cancel(this->hdma_event_);
+    }
+    this->state_->RemoveMemoryObserver(this);
+}
+
+void DMAController::OnMemoryWrite(uint16_t address, uint8_t value) {
+    switch (address) {
+        case DMA_ADDRESS:
+            this->StartOAMDMA(value);
+            break;
+        case HDMA1_ADDRESS:
+            this->hdma_source_ = (uint16_t)((value << 8) | (this->hdma_source_ & 0x00FF));
+            break;
+        case HDMA2_ADDRESS:
+            // The low four bits of both addresses are ignored
+            this->hdma_source_ = (uint16_t)((this->hdma_source_ & 0xFF00) | (value & 0xF0));
+            break;
+        case HDMA3_ADDRESS:
+            this->hdma_destination_ = (uint16_t)(VRAM_START | ((value & 0x1F) << 8) | (this->hdma_destination_ & 0x00FF));
+            break;
+        case HDMA4_ADDRESS:
+            this->hdma_destination_ = (uint16_t)((this->hdma_destination_ & 0xFF00) | (value & 0xF0));
+            break;
+        case HDMA5_ADDRESS:
+            this->WriteHDMA5(value);
+            break;
+        default:
+            break;
+    }
+}
+
+bool DMAController::OnMemoryRead(uint16_t address, uint8_t* value) {
+    // The end event only runs once the owner advances the scheduler, so check the time as well
+    if (this->scheduler_->now() >= this->oam_dma_end_) {
+        return false;
+    }
+
+    *value = 0xFF;
+    return true;
+}
+
+bool DMAController::oamDMAActive() {
+    return this->oam_dma_active_ && this->scheduler_->now() < this->oam_dma_end_;
+}
+
+bool DMAController::hdmaActive() {
+    return this->hdma_remaining_ > 0;
+}
+
+uint32_t DMAController::TakeStallCycles() {
+    uint32_t stall = this->stall_cycles_;
+    this->stall_cycles_ = 0;
+    return stall;
+}
+
+void DMAController::CopyStateFrom(const DMAController& other) {
+    if (this->oam_dma_active_ != other.oam_dma_active_) {
+        if (other.oam_dma_active_) {
+            this->state_->AddMemoryObserver(this, 0x00, OAM_DMA_LAST_BLOCKED_PAGE, WATCH_READS);
+        } else {
+            this->state_->RemoveMemoryObserver(this, WATCH_READS);
+        }
+    }
+
+    this->oam_dma_active_ = other.oam_dma_active_;
+    this->oam_dma_end_ = other.oam_dma_end_;
+    this->hdma_source_ = other.hdma_source_;
+    this->hdma_destination_ = other.hdma_destination_;
+    this->hdma_remaining_ = other.hdma_remaining_;
+    this->stall_cycles_ = other.stall_cycles_;
+
+    uint64_t now = this->scheduler_->now();
+    if (this->oam_dma_active_) {
+        this->oam_dma_event_ = this->scheduler_->Schedule(this->oam_dma_end_ > now ? this->oam_dma_end_ - now : 0, [this](uint64_t late) {
+            this->EndOAMDMA();
+        });
+    }
+    if (this->hdma_remaining_ > 0) {
+        this->ScheduleHBlankBlock();
+    }
+}
+
+void DMAController::StartOAMDMA(uint8_t page) {
+    uint16_t source = (uint16_t)(page << 8);
+    if (source >= ECHO_START) {
+        source -= ECHO_OFFSET;
+    }
+
+    this->state_->CopyMemory(OAM_START, source, OAM_SIZE);
+
+    // Restarting a transfer extends the restriction rather than stacking a second one
+    if (this->oam_dma_active_) {
+        this->scheduler_->Cancel(this->oam_dma_event_);
+    } else {
+        this->state_->AddMemoryObserver(this, 0x00, OAM_DMA_LAST_BLOCKED_PAGE, WATCH_READS);
+    }
+
+    this->oam_dma_active_ = true;
+    this->oam_dma_end_ = this->scheduler_->now() + OAM_DMA_DOTS;
+    this->oam_dma_event_ = this->scheduler_->Schedule(OAM_DMA_DOTS, [this](uint64_t late) {
+        this->EndOAMDMA();
+    });
+}
+
+void DMAController::EndOAMDMA() {
+    this->oam_dma_active_ = false;
+    this->state_->RemoveMemoryObserver(this, WATCH_READS);
+}
+
+void DMAController::WriteHDMA5(uint8_t value) {
+    uint8_t blocks = (uint8_t)((value & 0x7F) + 1);
+
+    if (this->hdma_remaining_ > 0) {
+        // Writing with bit 7 clear stops an HBlank DMA, which then reports its remaining length with bit 7 set
+        if ((value & HDMA_HBLANK_MODE) == 0) {
+            this->scheduler_->Cancel(this->hdma_event_);
+            this->memory_bus_[HDMA5_ADDRESS] = (uint8_t)(HDMA_HBLANK_MODE | (this->hdma_remaining_ - 1));
+            this->hdma_remaining_ = 0;
+            return;
+        }
+        this->scheduler_->Cancel(this->hdma_event_);
+    }
+
+    if ((value & HDMA_HBLANK_MODE) == 0) {
+        this->CopyBlocks(blocks);
+        this->memory_bus_[HDMA5_ADDRESS] = 0xFF;
+        return;
+    }
+
+    this->hdma_remaining_ = blocks;
+    this->memory_bus_[HDMA5_ADDRESS] = (uint8_t)(blocks - 1);
+    this->ScheduleHBlankBlock();
+}
+
+void DMAController::CopyBlocks(uint8_t blocks) {
+    for (uint8_t i = 0; i < blocks; i++) {
+        // Transfers stop at the end of VRAM rather than wrapping
+        if (this->hdma_destination_ < VRAM_START || this->hdma_destination_ > VRAM_END) {
+            break;
+        }
+
+        // Contiguous 16 byte blocks could be one copy, but the source may cross into another region
+        this->state_->CopyMemory(this->hdma_destination_, this->hdma_source_, HDMA_BLOCK_SIZE);
+        this->hdma_source_ += HDMA_BLOCK_SIZE;
+        this->hdma_destination_ += HDMA_BLOCK_SIZE;
+        this->stall_cycles_ += HDMA_BLOCK_DOTS;
+    }
+}
+
+void DMAController::ScheduleHBlankBlock() {
+    this->hdma_event_ = this->scheduler_->Schedule(this->ppu_->DotsUntilNextHBlank(), [this](uint64_t late) {
+        this->RunHBlankBlock();
+    });
+}
+
+void DMAController::RunHBlankBlock() {
+    // A renderer with a long mode 3 may not have reached HBlank yet
+    if (this->ppu_->mode() != HBLANK || this->ppu_->ly() >= VISIBLE_LINES) {
+        this->ScheduleHBlankBlock();
+        return;
+    }
+
+    this->CopyBlocks(1);
+    this->hdma_remaining_--;
+
+    if (this->hdma_remaining_ == 0 || this->hdma_destination_ > VRAM_END) {
+        this->hdma_remaining_ = 0;
+        this->memory_bus_[HDMA5_ADDRESS] = 0xFF;
+        return;
+    }
+
+    this->memory_bus_[HDMA5_ADDRESS] = (uint8_t)(this->hdma_remaining_ - 1);
+    this->ScheduleHBlankBlock();
+}
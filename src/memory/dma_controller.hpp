@@ -0,0 +1,176 @@
+/**
+ * @file dma_controller.hpp
+ * @brief OAM DMA and CGB VRAM DMA as bulk copies on the memory bus
+ *
+ */
+
+#ifndef DMA_CONTROLLER_H
+#define DMA_CONTROLLER_H
+
+#include <cstdint>
+#include "../cpu/memory_observer.hpp"
+#include "../cpu/sm83_state.hpp"
+#include "../core/scheduler.hpp"
+#include "../ppu/ppu.hpp"
+
+// DMA registers
+static const uint16_t DMA_ADDRESS = 0xFF46;
+static const uint16_t HDMA1_ADDRESS = 0xFF51;
+static const uint16_t HDMA2_ADDRESS = 0xFF52;
+static const uint16_t HDMA3_ADDRESS = 0xFF53;
+static const uint16_t HDMA4_ADDRESS = 0xFF54;
+static const uint16_t HDMA5_ADDRESS = 0xFF55;
+
+// Bit 7 of HDMA5 selects an HBlank transfer when written, and is clear while one is running
+static const uint8_t HDMA_HBLANK_MODE = 0b10000000;
+
+// OAM DMA copies one byte per M-cycle, 160 M-cycles in dots
+static const uint16_t OAM_DMA_DOTS = OAM_SIZE * 4;
+
+// VRAM DMA moves 16 bytes per block and halts the CPU for 8 M-cycles per block
+static const uint16_t HDMA_BLOCK_SIZE = 16;
+static const uint16_t HDMA_BLOCK_DOTS = 32;
+
+/**
+ * @brief Performs DMA transfers with SM83State::CopyMemory instead of one CPU write per byte.
+ *
+ * An OAM DMA copies all 160 bytes as soon as 0xFF46 is written. For the 640 dots the transfer takes
+ * on hardware, the controller watches reads of every page below HRAM and returns 0xFF, which is what
+ * the CPU sees while the DMA unit owns the bus. The restriction is lifted by a scheduled event.
+ *
+ * A general purpose VRAM DMA copies every block at once. An HBlank DMA copies one 16 byte block at
+ * the start of each HBlank, scheduled from the PPU's timing rather than polled. Both halt the CPU,
+ * which the owner collects with TakeStallCycles().
+ *
+ * The controller registers itself with the SM83State for writes to page 0xFF.
+ */
+class DMAController : public MemoryObserver
+{
+
+private:
+
+    uint8_t* memory_bus_;
+    SM83State* state_;
+    Scheduler* scheduler_;
+    PPUBase* ppu_;
+
+    // The bus is restricted until the clock reaches this time
+    uint64_t oam_dma_end_;
+    bool oam_dma_active_;
+    uint32_t oam_dma_event_;
+
+    // VRAM DMA addresses, advanced as blocks are copied
+    uint16_t hdma_source_;
+    uint16_t hdma_destination_;
+
+    // Blocks left in the running HBlank DMA, 0 when idle
+    uint8_t hdma_remaining_;
+    uint32_t hdma_event_;
+
+    // Dots the CPU has been halted for since the last call to TakeStallCycles
+    uint32_t stall_cycles_;
+
+    /**
+     * @brief Copies OAM from the page written to 0xFF46 and restricts the bus until the transfer ends
+     *
+     * @param page The high byte of the source address
+     */
+    void StartOAMDMA(uint8_t page);
+
+    /**
+     * @brief Lifts the bus restriction at the end of an OAM DMA
+     *
+     */
+    void EndOAMDMA();
+
+    /**
+     * @brief Handles a write to HDMA5, starting or cancelling a VRAM DMA
+     *
+     * @param value The value written
+     */
+    void WriteHDMA5(uint8_t value);
+
+    /**
+     * @brief Copies VRAM DMA blocks and advances the addresses
+     *
+     * @param blocks The number of 16 byte blocks
+     */
+    void CopyBlocks(uint8_t blocks);
+
+    /**
+     * @brief Schedules the next HBlank DMA block
+     *
+     */
+    void ScheduleHBlankBlock();
+
+    /**
+     * @brief Copies one HBlank DMA block if the PPU has reached HBlank, otherwise waits for it
+     *
+     */
+    void RunHBlankBlock();
+
+public:
+    /**
+     * @brief Constructs a new DMAController and registers it for writes to the IO registers
+     *
+     * @param memory_bus_ptr Pointer to the memory bus. Expects size of at least 65,536
+     * @param state The CPU state whose memory accesses are observed
+     * @param scheduler The scheduler driven by the emulated clock
+     * @param ppu The PPU whose HBlanks pace HBlank DMA
+     */
+    DMAController(uint8_t* memory_bus_ptr, SM83State* state, Scheduler* scheduler, PPUBase* ppu);
+
+    /**
+     * @brief Cancels pending transfers and unregisters the controller
+     *
+     */
+    ~DMAController();
+
+    /**
+     * @brief Starts transfers when the DMA registers are written
+     *
+     * @param address The 16bit address written to
+     * @param value The value written
+     */
+    void OnMemoryWrite(uint16_t address, uint8_t value) override;
+
+    /**
+     * @brief Returns 0xFF for reads outside HRAM while an OAM DMA owns the bus
+     *
+     * @param address The 16bit address being read
+     * @param value Receives 0xFF when the read is blocked
+     * @return true if the read was blocked
+     */
+    bool OnMemoryRead(uint16_t address, uint8_t* value) override;
+
+    /**
+     * @brief Gets whether an OAM DMA is restricting the bus
+     *
+     */
+    bool oamDMAActive();
+
+    /**
+     * @brief Gets whether an HBlank DMA still has blocks to copy
+     *
+     */
+    bool hdmaActive();
+
+    /**
+     * @brief Gets and clears the dots the CPU has been halted for by VRAM DMA
+     *
+     * @return uint32_t The number of dots the owner should run the rest of the system for
+     */
+    uint32_t TakeStallCycles();
+
+    /**
+     * @brief Copies the transfers in progress on another machine and schedules their events again.
+     *
+     * Call after the owner's Scheduler has been restarted at the other machine's time and its PPU
+     * state copied, since HBlank DMA is paced from the PPU.
+     *
+     * @param other The controller to copy
+     */
+    void CopyStateFrom(const DMAController& other);
+};
+
+#endif
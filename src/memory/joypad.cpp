@@ -0,0 +1,70 @@
+/**
+ * @file joypad.cpp
+ * @brief Implementation of the joypad register
+ *
+ */
+
+#include "./joypad.hpp"
+#include "../ppu/ppu_registers.hpp"
+
+// Bits 4 and 5 of P1 select the direction and action buttons when clear
+static const uint8_t SELECT_DIRECTIONS = 0b00010000;
+static const uint8_t SELECT_ACTIONS = 0b00100000;
+static const uint8_t SELECT_MASK = SELECT_DIRECTIONS | SELECT_ACTIONS;
+
+// The unused top two bits read as 1
+static const uint8_t P1_UNUSED = 0b11000000;
+
+Joypad::Joypad(uint8_t* memory_bus_ptr, SM83State* state) {
+    this->memory_bus_ = memory_bus_ptr;
+    this->state_ = state;
+    this->buttons_ = 0;
+
+    this->memory_bus_[P1_ADDRESS] = (uint8_t)(P1_UNUSED | (this->memory_bus_[P1_ADDRESS] & SELECT_MASK) | 0x0F);
+    this->state_->AddMemoryObserver(this, 0xFF, 0xFF, WATCH_WRITES);
+}
+
+Joypad::~Joypad() {
+    this->state_->RemoveMemoryObserver(this);
+}
+
+uint8_t Joypad::PressedBits(uint8_t select) {
+    uint8_t pressed = 0;
+
+    if ((select & SELECT_DIRECTIONS) == 0) {
+        pressed |= this->buttons_ & 0x0F;
+    }
+    if ((select & SELECT_ACTIONS) == 0) {
+        pressed |= this->buttons_ >> 4;
+    }
+
+    return (uint8_t)(~pressed & 0x0F);
+}
+
+void Joypad::SetButtons(uint8_t buttons) {
+    uint8_t select = this->memory_bus_[P1_ADDRESS] & SELECT_MASK;
+    uint8_t before = this->PressedBits(select);
+
+    this->buttons_ = buttons;
+    uint8_t after = this->PressedBits(select);
+    this->memory_bus_[P1_ADDRESS] = (uint8_t)(P1_UNUSED | select | after);
+
+    // The interrupt fires when a selected line goes from high to low
+    if ((before & ~after) != 0) {
+        this->memory_bus_[IF_ADDRESS] |= JOYPAD_INTERRUPT;
+    }
+}
+
+uint8_t Joypad::buttons() {
+    return this->buttons_;
+}
+
+void Joypad::OnMemoryWrite(uint16_t address, uint8_t value) {
+    if (address != P1_ADDRESS) {
+        return;
+    }
+
+    // Only the select bits are writable
+    uint8_t select = value & SELECT_MASK;
+    this->memory_bus_[P1_ADDRESS] = (uint8_t)(P1_UNUSED | select | this->PressedBits(select));
+}
@@ -0,0 +1,93 @@
+/**
+ * @file joypad.hpp
+ * @brief The P1 joypad register
+ *
+ */
+
+#ifndef JOYPAD_H
+#define JOYPAD_H
+
+#include <cstdint>
+#include "../cpu/memory_observer.hpp"
+#include "../cpu/sm83_state.hpp"
+
+static const uint16_t P1_ADDRESS = 0xFF00;
+
+// Bits of the button state passed to Joypad::SetButtons, set while a button is held
+static const uint8_t BUTTON_RIGHT = 0b00000001;
+static const uint8_t BUTTON_LEFT = 0b00000010;
+static const uint8_t BUTTON_UP = 0b00000100;
+static const uint8_t BUTTON_DOWN = 0b00001000;
+static const uint8_t BUTTON_A = 0b00010000;
+static const uint8_t BUTTON_B = 0b00100000;
+static const uint8_t BUTTON_SELECT = 0b01000000;
+static const uint8_t BUTTON_START = 0b10000000;
+
+// Bit of the joypad interrupt in IF
+static const uint8_t JOYPAD_INTERRUPT = 0b00010000;
+
+/**
+ * @brief Keeps P1 on the memory bus up to date with the held buttons and the selected button group.
+ *
+ * Rather than watching every read of page 0xFF, the register is rewritten whenever the game selects a
+ * group or the buttons change, so reads stay plain memory reads. Pressing a button in a selected
+ * group requests the joypad interrupt.
+ *
+ * The joypad registers itself with the SM83State for writes to page 0xFF.
+ */
+class Joypad : public MemoryObserver
+{
+
+private:
+
+    uint8_t* memory_bus_;
+    SM83State* state_;
+
+    // BUTTON_* bits of the held buttons
+    uint8_t buttons_;
+
+    /**
+     * @brief Gets the low nibble of P1 for the selected groups, a bit clear for each held button
+     *
+     * @param select Bits 4 and 5 of P1
+     */
+    uint8_t PressedBits(uint8_t select);
+
+public:
+    /**
+     * @brief Constructs a new Joypad with no buttons held and registers it for writes to the IO registers
+     *
+     * @param memory_bus_ptr Pointer to the memory bus. Expects size of at least 65,536
+     * @param state The CPU state whose writes are observed
+     */
+    Joypad(uint8_t* memory_bus_ptr, SM83State* state);
+
+    /**
+     * @brief Unregisters the joypad
+     *
+     */
+    ~Joypad();
+
+    /**
+     * @brief Sets the held buttons
+     *
+     * @param buttons BUTTON_* bits
+     */
+    void SetButtons(uint8_t buttons);
+
+    /**
+     * @brief Gets the held buttons as BUTTON_* bits
+     *
+     */
+    uint8_t buttons();
+
+    /**
+     * @brief Keeps the button bits of P1 when the game selects a button group
+     *
+     * @param address The 16bit address written to
+     * @param value The value written
+     */
+    void OnMemoryWrite(uint16_t address, uint8_t value) override;
+};
+
+#endif
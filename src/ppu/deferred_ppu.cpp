@@ -0,0 +1,195 @@
+/**
+ * @file deferred_ppu.cpp
+ * @brief Implementation of the deferred PPU
+ *
+ */
+
+#include <chrono>
+#include <cstring>
+#include "./deferred_ppu.hpp"
+
+// Room for several frames of heavy VRAM traffic before the emulation thread has to wait
+static const size_t LOG_CAPACITY = 1 << 17;
+
+// Keeps the dot deltas well inside 32 bits while the LCD is off and no frames complete
+static const uint32_t MAX_PENDING_DOTS = 1u << 30;
+
+// Empty polls before the render thread starts sleeping between polls
+static const int SPIN_POLLS = 1024;
+
+bool IsRenderingWrite(uint16_t address) {
+    if (address >= VRAM_START && address <= VRAM_END) {
+        return true;
+    }
+    if (address >= OAM_START && address <= OAM_END) {
+        return true;
+    }
+
+    switch (address) {
+        case LCDC_ADDRESS:
+        case SCY_ADDRESS:
+        case SCX_ADDRESS:
+        case BGP_ADDRESS:
+        case OBP0_ADDRESS:
+        case OBP1_ADDRESS:
+        case WY_ADDRESS:
+        case WX_ADDRESS:
+            return true;
+        default:
+            return false;
+    }
+}
+
+DeferredPPU::DeferredPPU(uint8_t* memory_bus_ptr, std::function<void(const uint32_t*)> frame_callback)
+    : timing_ppu_(memory_bus_ptr), log_(LOG_CAPACITY), frames_rendered_(0), entries_replayed_(0), running_(true) {
+    this->pending_dots_ = 0;
+    this->frames_logged_ = 0;
+    this->entries_logged_ = 0;
+    this->frame_callback_ = frame_callback;
+
+    this->render_ppu_ = nullptr;
+
+    this->render_memory_ = new uint8_t[65536];
+    memcpy(this->render_memory_, memory_bus_ptr, 65536);
+
+    // The destructor does not run for a constructor that throws
+    try {
+        this->render_ppu_ = new FastPPU(this->render_memory_);
+        this->render_thread_ = std::thread(&DeferredPPU::RenderLoop, this);
+    } catch (...) {
+        delete this->render_ppu_;
+        delete[] this->render_memory_;
+        throw;
+    }
+}
+
+DeferredPPU::~DeferredPPU() {
+    this->running_.store(false, std::memory_order_release);
+    this->render_thread_.join();
+
+    delete this->render_ppu_;
+    delete[] this->render_memory_;
+}
+
+void DeferredPPU::Tick(uint16_t cycles) {
+    this->timing_ppu_.Tick(cycles);
+    this->pending_dots_ += cycles;
+
+    if (this->timing_ppu_.frameCount() != this->frames_logged_) {
+        this->frames_logged_ = this->timing_ppu_.frameCount();
+        this->Record(0, 0, PPU_WRITE_FRAME_END);
+    } else if (this->pending_dots_ > MAX_PENDING_DOTS) {
+        this->Record(0, 0, PPU_WRITE_SYNC);
+    }
+}
+
+void DeferredPPU::OnMemoryWrite(uint16_t address, uint8_t value) {
+    if (IsRenderingWrite(address)) {
+        this->Record(address, value, PPU_WRITE_MEMORY);
+    }
+}
+
+void DeferredPPU::OnMemoryBlockWrite(uint16_t address, const uint8_t* data, uint16_t length) {
+    bool oam = false;
+
+    for (uint16_t i = 0; i < length; i++) {
+        uint16_t target = (uint16_t)(address + i);
+        if (IsRenderingWrite(target)) {
+            this->Record(target, data[i], PPU_WRITE_BLOCK);
+            oam = oam || (target >= OAM_START && target <= OAM_END);
+        }
+    }
+
+    if (oam) {
+        this->Record(0, 0, PPU_WRITE_INVALIDATE_SPRITES);
+    }
+}
+
+PPUBase* DeferredPPU::timing() {
+    return &this->timing_ppu_;
+}
+
+void DeferredPPU::WaitForFrames() {
+    while (this->frames_rendered_.load(std::memory_order_acquire) < this->frames_logged_) {
+        std::this_thread::yield();
+    }
+}
+
+void DeferredPPU::Drain() {
+    while (this->entries_replayed_.load(std::memory_order_acquire) < this->entries_logged_) {
+        std::this_thread::yield();
+    }
+}
+
+const uint32_t* DeferredPPU::framebuffer() {
+    this->Drain();
+    return this->render_ppu_->framebuffer();
+}
+
+void DeferredPPU::SetFramebuffer(uint32_t* framebuffer) {
+    // The render thread only touches the render PPU while replaying, so it is safe once drained
+    this->Drain();
+    this->render_ppu_->SetFramebuffer(framebuffer);
+}
+
+uint64_t DeferredPPU::framesRendered() {
+    return this->frames_rendered_.load(std::memory_order_acquire);
+}
+
+void DeferredPPU::Record(uint16_t address, uint8_t value, uint8_t kind) {
+    PPUWrite write;
+    write.delta = this->pending_dots_;
+    write.address = address;
+    write.value = value;
+    write.kind = kind;
+
+    while (!this->log_.TryPush(write)) {
+        std::this_thread::yield();
+    }
+    this->pending_dots_ = 0;
+    this->entries_logged_++;
+}
+
+void DeferredPPU::RenderLoop() {
+    PPUWrite write;
+    int idle_polls = 0;
+
+    while (true) {
+        if (!this->log_.TryPop(&write)) {
+            // Only stop once the log is drained, so every logged frame is delivered
+            if (!this->running_.load(std::memory_order_acquire)) {
+                break;
+            }
+            if (++idle_polls < SPIN_POLLS) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            continue;
+        }
+        idle_polls = 0;
+
+        // Catch the render PPU up to the dot the entry was logged on
+        uint32_t delta = write.delta;
+        while (delta > 0) {
+            uint16_t step = delta < 0xFFFF ? (uint16_t)delta : 0xFFFF;
+            this->render_ppu_->Tick(step);
+            delta -= step;
+        }
+
+        if (write.kind == PPU_WRITE_MEMORY) {
+            this->render_memory_[write.address] = write.value;
+            this->render_ppu_->OnMemoryWrite(write.address, write.value);
+        } else if (write.kind == PPU_WRITE_BLOCK) {
+            this->render_memory_[write.address] = write.value;
+        } else if (write.kind == PPU_WRITE_INVALIDATE_SPRITES) {
+            this->render_ppu_->InvalidateSprites();
+        } else if (write.kind == PPU_WRITE_FRAME_END) {
+            if (this->frame_callback_) {
+                this->frame_callback_(this->render_ppu_->framebuffer());
+            }
+            this->frames_rendered_.fetch_add(1, std::memory_order_release);
+        }
+        this->entries_replayed_.fetch_add(1, std::memory_order_release);
+    }
+}
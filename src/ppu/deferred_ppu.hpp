@@ -0,0 +1,188 @@
+/**
+ * @file deferred_ppu.hpp
+ * @brief PPU that rasterises on a second thread from a log of the CPU's video writes
+ *
+ */
+
+#ifndef DEFERRED_PPU_H
+#define DEFERRED_PPU_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include "../cpu/memory_observer.hpp"
+#include "../util/spsc_ring_buffer.hpp"
+#include "./null_renderer.hpp"
+#include "./ppu.hpp"
+
+/**
+ * @brief One entry of the video write log
+ *
+ */
+struct PPUWrite {
+    // Dots elapsed since the previous entry
+    uint32_t delta;
+    uint16_t address;
+    uint8_t value;
+    uint8_t kind;
+};
+
+// Kinds of log entry
+static const uint8_t PPU_WRITE_MEMORY = 0;
+static const uint8_t PPU_WRITE_FRAME_END = 1;
+static const uint8_t PPU_WRITE_SYNC = 2;
+static const uint8_t PPU_WRITE_BLOCK = 3;
+static const uint8_t PPU_WRITE_INVALIDATE_SPRITES = 4;
+
+/**
+ * @brief Splits the PPU across two threads.
+ *
+ * The emulation thread ticks a timing only PPU, which keeps LY, STAT and the interrupts exact for
+ * the CPU, and logs every write that can change the picture along with the dot it happened on. A
+ * render thread replays the log into a FastPPU running on its own copy of memory, so it draws
+ * frame N while the CPU is already on frame N+1. Since the replayed PPU sees every write at the
+ * same dot as an inline FastPPU would, the frames are pixel identical.
+ *
+ * Register the DeferredPPU with SM83State::AddMemoryObserver for pages 0x80-0x9F, 0xFE and 0xFF.
+ * GameBoy does this when built with DEFERRED_PPU.
+ */
+class DeferredPPU : public MemoryObserver
+{
+
+private:
+
+    // Emulation thread side
+    PPU<NullRenderer> timing_ppu_;
+    uint32_t pending_dots_;
+    uint64_t frames_logged_;
+    uint64_t entries_logged_;
+
+    // Render thread side
+    uint8_t* render_memory_;
+    FastPPU* render_ppu_;
+    std::function<void(const uint32_t*)> frame_callback_;
+
+    SPSCRingBuffer<PPUWrite> log_;
+    std::atomic<uint64_t> frames_rendered_;
+    std::atomic<uint64_t> entries_replayed_;
+    std::atomic<bool> running_;
+    std::thread render_thread_;
+
+    /**
+     * @brief Appends an entry to the log, waiting for the render thread if the log is full
+     *
+     * @param address The address written, ignored for markers
+     * @param value The value written, ignored for markers
+     * @param kind The kind of entry
+     */
+    void Record(uint16_t address, uint8_t value, uint8_t kind);
+
+    /**
+     * @brief Body of the render thread
+     *
+     */
+    void RenderLoop();
+
+public:
+    /**
+     * @brief Constructs a new DeferredPPU and starts its render thread
+     *
+     * @param memory_bus_ptr Pointer to the emulated memory bus, copied as the starting render state
+     * @param frame_callback Called on the render thread with each completed framebuffer
+     */
+    DeferredPPU(uint8_t* memory_bus_ptr, std::function<void(const uint32_t*)> frame_callback);
+
+    /**
+     * @brief Renders any frames still in the log and stops the render thread
+     *
+     */
+    ~DeferredPPU();
+
+    /**
+     * @brief Advances the timing PPU. Emulation thread only
+     *
+     * @param cycles The number of dots to advance by
+     */
+    void Tick(uint16_t cycles);
+
+    /**
+     * @brief Logs writes to VRAM, OAM and the registers that affect rendering
+     *
+     * @param address The 16bit address written to
+     * @param value The value written
+     */
+    void OnMemoryWrite(uint16_t address, uint8_t value) override;
+
+    /**
+     * @brief Logs the rendering bytes of a DMA copy, followed by a single object list rebuild if it reached OAM
+     *
+     * @param address The first address written to
+     * @param data The bytes written
+     * @param length The number of bytes written
+     */
+    void OnMemoryBlockWrite(uint16_t address, const uint8_t* data, uint16_t length) override;
+
+    /**
+     * @brief Gets the timing PPU, whose LY, STAT and frame state match an inline PPU
+     *
+     */
+    PPUBase* timing();
+
+    /**
+     * @brief Gets whether the timing PPU has completed a frame that has not been acknowledged
+     *
+     */
+    bool frameComplete() {
+        return this->timing_ppu_.frameComplete();
+    }
+
+    /**
+     * @brief Acknowledges the timing PPU's completed frame
+     *
+     */
+    void AcknowledgeFrame() {
+        this->timing_ppu_.AcknowledgeFrame();
+    }
+
+    /**
+     * @brief Blocks until every frame completed on the emulation thread has been rendered
+     *
+     */
+    void WaitForFrames();
+
+    /**
+     * @brief Blocks until the render thread has replayed everything logged so far and is idle
+     *
+     */
+    void Drain();
+
+    /**
+     * @brief Gets the render PPU's framebuffer once everything logged has been replayed.
+     *
+     * The contents stay valid until the emulation thread logs more writes.
+     */
+    const uint32_t* framebuffer();
+
+    /**
+     * @brief Makes the render PPU draw into an external buffer, once everything logged has been replayed
+     *
+     * @param framebuffer The buffer to draw into, or nullptr for the render PPU's own
+     */
+    void SetFramebuffer(uint32_t* framebuffer);
+
+    /**
+     * @brief Gets the number of frames the render thread has finished
+     *
+     */
+    uint64_t framesRendered();
+};
+
+/**
+ * @brief Gets whether a write to an address can change what the PPU draws
+ *
+ * @param address The 16bit address written to
+ */
+bool IsRenderingWrite(uint16_t address);
+
+#endif
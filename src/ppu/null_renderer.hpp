@@ -0,0 +1,50 @@
+/**
+ * @file null_renderer.hpp
+ * @brief PPU renderer that keeps the timing of ScanlineRenderer but draws nothing
+ *
+ */
+
+#ifndef NULL_RENDERER_H
+#define NULL_RENDERER_H
+
+#include <cstdint>
+#include "./ppu_registers.hpp"
+
+/**
+ * @brief Drives LY, STAT and the PPU interrupts without touching the framebuffer.
+ *
+ * Used where the pixels are produced elsewhere, such as the CPU side of DeferredPPU. Mode 3 lasts
+ * TRANSFER_DOTS exactly as it does with ScanlineRenderer, so the two stay in lockstep.
+ */
+class NullRenderer
+{
+
+private:
+
+    uint16_t remaining_dots_;
+
+public:
+    NullRenderer(const uint8_t* memory_bus_ptr) : remaining_dots_(0) {}
+
+    void BeginFrame() {}
+
+    void BeginLine(uint8_t ly, uint32_t* line) {
+        this->remaining_dots_ = TRANSFER_DOTS;
+    }
+
+    uint16_t Transfer(uint16_t dots) {
+        uint16_t used = dots < this->remaining_dots_ ? dots : this->remaining_dots_;
+        this->remaining_dots_ -= used;
+        return used;
+    }
+
+    bool lineComplete() {
+        return this->remaining_dots_ == 0;
+    }
+
+    void OnOAMWrite(uint16_t address) {}
+
+    void InvalidateSprites() {}
+};
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file oam.cpp
+ * @brief Implementation of OAM scanning
+ *
+ */
+
+#include "./oam.hpp"
+#include "./ppu_registers.hpp"
+
+uint8_t SpriteHeight(uint8_t lcdc) {
+    return (lcdc & LCDC_OBJ_SIZE) > 0 ? 16 : 8;
+}
+
+uint8_t ScanOAM(const uint8_t* memory_bus, uint8_t ly, uint8_t sprite_height, SpriteEntry* sprites) {
+    uint8_t count = 0;
+    const uint8_t* oam = memory_bus + OAM_START;
+
+    for (uint8_t i = 0; i < OAM_ENTRIES && count < MAX_SPRITES_PER_LINE; i++) {
+        // OAM stores Y + 16 so that objects can be scrolled in from the top
+        int top = oam[i * 4] - 16;
+
+        if (ly >= top && ly < top + sprite_height) {
+            SpriteEntry& sprite = sprites[count++];
+            sprite.y = oam[i * 4];
+            sprite.x = oam[i * 4 + 1];
+            sprite.tile = oam[i * 4 + 2];
+            sprite.attributes = oam[i * 4 + 3];
+            sprite.index = i;
+        }
+    }
+
+    return count;
+}
+
+void SortSpritesByPriority(SpriteEntry* sprites, uint8_t count) {
+    // Insertion sort, stable so that OAM order breaks ties between equal X values
+    for (uint8_t i = 1; i < count; i++) {
+        SpriteEntry sprite = sprites[i];
+        int j = i - 1;
+
+        while (j >= 0 && sprites[j].x > sprite.x) {
+            sprites[j + 1] = sprites[j];
+            j--;
+        }
+        sprites[j + 1] = sprite;
+    }
+}
+
+void SpriteRow(const uint8_t* memory_bus, const SpriteEntry& sprite, uint8_t ly, uint8_t sprite_height, uint8_t* low, uint8_t* high) {
+    uint8_t row = (uint8_t)(ly - (sprite.y - 16));
+    uint8_t tile = sprite.tile;
+
+    if ((sprite.attributes & OAM_Y_FLIP) > 0) {
+        row = (uint8_t)(sprite_height - 1 - row);
+    }
+
+    // Bit 0 of the tile index is ignored for 8x16 objects
+    if (sprite_height == 16) {
+        tile = tile & 0xFE;
+    }
+
+    uint16_t address = (uint16_t)(VRAM_START + tile * 16 + row * 2);
+    *low = memory_bus[address];
+    *high = memory_bus[address + 1];
+}
@@ -0,0 +1,67 @@
+/**
+ * @file oam.hpp
+ * @brief Object attribute memory scanning shared by the PPU renderers
+ *
+ */
+
+#ifndef OAM_H
+#define OAM_H
+
+#include <cstdint>
+
+// The PPU only displays the first 10 objects that intersect a line
+static const uint8_t MAX_SPRITES_PER_LINE = 10;
+static const uint8_t OAM_ENTRIES = 40;
+
+/**
+ * @brief A single 4 byte OAM entry along with its position in OAM
+ *
+ */
+struct SpriteEntry {
+    uint8_t y;
+    uint8_t x;
+    uint8_t tile;
+    uint8_t attributes;
+    uint8_t index;
+};
+
+/**
+ * @brief Gets the height of objects selected by the LCDC register
+ *
+ * @param lcdc The LCDC register
+ * @return uint8_t 16 for 8x16 objects, 8 otherwise
+ */
+uint8_t SpriteHeight(uint8_t lcdc);
+
+/**
+ * @brief Collects the objects visible on a line the way the PPU does during mode 2
+ *
+ * @param memory_bus Pointer to the memory bus
+ * @param ly The line being scanned
+ * @param sprite_height The object height, 8 or 16
+ * @param sprites Output array with room for MAX_SPRITES_PER_LINE entries
+ * @return uint8_t The number of objects found, in OAM order
+ */
+uint8_t ScanOAM(const uint8_t* memory_bus, uint8_t ly, uint8_t sprite_height, SpriteEntry* sprites);
+
+/**
+ * @brief Sorts objects into DMG drawing priority, lowest X first with OAM order breaking ties
+ *
+ * @param sprites The objects found by ScanOAM
+ * @param count The number of objects
+ */
+void SortSpritesByPriority(SpriteEntry* sprites, uint8_t count);
+
+/**
+ * @brief Reads the two bitplanes of the row of an object that lands on a line
+ *
+ * @param memory_bus Pointer to the memory bus
+ * @param sprite The object being drawn
+ * @param ly The line being drawn
+ * @param sprite_height The object height, 8 or 16
+ * @param low Receives the low bitplane
+ * @param high Receives the high bitplane
+ */
+void SpriteRow(const uint8_t* memory_bus, const SpriteEntry& sprite, uint8_t ly, uint8_t sprite_height, uint8_t* low, uint8_t* high);
+
+#endif
@@ -0,0 +1,278 @@
+/**
+ * @file pixel_fifo_renderer.cpp
+ * @brief Implementation of the dot accurate pixel FIFO renderer
+ *
+ */
+
+#include <cstring>
+#include "./pixel_fifo_renderer.hpp"
+#include "./ppu_registers.hpp"
+
+// The fetcher throws away its first tile at the start of every line
+static const uint8_t STARTUP_DOTS = 6;
+
+// Dots the pipeline is paused for while an object is fetched
+static const uint8_t SPRITE_FETCH_DOTS = 6;
+
+// Fetcher step that pushes a fetched tile row into the background FIFO
+static const uint8_t FETCH_PUSH_STEP = 6;
+
+PixelFIFORenderer::PixelFIFORenderer(const uint8_t* memory_bus_ptr) {
+    this->memory_bus_ = memory_bus_ptr;
+    this->line_ = nullptr;
+    this->ly_ = 0;
+    this->x_ = 0;
+    this->line_complete_ = true;
+    this->sprite_count_ = 0;
+    this->window_triggered_ = false;
+    this->window_drawn_ = false;
+    this->window_line_ = 0;
+}
+
+void PixelFIFORenderer::BeginFrame() {
+    this->window_triggered_ = false;
+    this->window_line_ = 0;
+}
+
+void PixelFIFORenderer::BeginLine(uint8_t ly, uint32_t* line) {
+    const uint8_t* memory = this->memory_bus_;
+    uint8_t lcdc = memory[LCDC_ADDRESS];
+
+    this->ly_ = ly;
+    this->line_ = line;
+    this->x_ = 0;
+    this->discard_ = memory[SCX_ADDRESS] & 7;
+    this->startup_dots_ = STARTUP_DOTS;
+    this->line_complete_ = false;
+
+    this->bg_head_ = 0;
+    this->bg_size_ = 0;
+    this->obj_head_ = 0;
+    memset(this->obj_fifo_, 0, sizeof(this->obj_fifo_));
+
+    this->fetch_step_ = 0;
+    this->fetch_x_ = 0;
+    this->fetching_window_ = false;
+    this->window_drawn_ = false;
+
+    if (ly == memory[WY_ADDRESS]) {
+        this->window_triggered_ = true;
+    }
+
+    this->sprite_count_ = ScanOAM(memory, ly, SpriteHeight(lcdc), this->sprites_);
+    SortSpritesByPriority(this->sprites_, this->sprite_count_);
+    this->next_sprite_ = 0;
+    this->sprite_stall_ = 0;
+}
+
+uint16_t PixelFIFORenderer::Transfer(uint16_t dots) {
+    uint16_t used = 0;
+
+    while (used < dots && !this->line_complete_) {
+        this->Step();
+        used++;
+    }
+
+    return used;
+}
+
+bool PixelFIFORenderer::lineComplete() {
+    return this->line_complete_;
+}
+
+void PixelFIFORenderer::OnOAMWrite(uint16_t address) {
+}
+
+void PixelFIFORenderer::InvalidateSprites() {
+}
+
+void PixelFIFORenderer::Step() {
+    uint8_t lcdc = this->memory_bus_[LCDC_ADDRESS];
+
+    if (this->startup_dots_ > 0) {
+        this->startup_dots_--;
+        return;
+    }
+
+    // Start fetching the next object once the output reaches it
+    if (this->sprite_stall_ == 0 && (lcdc & LCDC_OBJ_ENABLE) > 0) {
+        while (this->next_sprite_ < this->sprite_count_ && this->SpriteFetchX(this->sprites_[this->next_sprite_]) < this->x_) {
+            this->next_sprite_++;
+        }
+        if (this->next_sprite_ < this->sprite_count_ && this->SpriteFetchX(this->sprites_[this->next_sprite_]) == this->x_) {
+            this->sprite_stall_ = SPRITE_FETCH_DOTS;
+        }
+    }
+
+    if (this->sprite_stall_ > 0) {
+        this->sprite_stall_--;
+        if (this->sprite_stall_ == 0) {
+            this->LoadSprite(this->sprites_[this->next_sprite_], lcdc);
+            this->next_sprite_++;
+        }
+        return;
+    }
+
+    this->StepFetcher(lcdc);
+
+    if (this->bg_size_ == 0) {
+        return;
+    }
+
+    // The window takes over once the output reaches WX - 7
+    if (!this->fetching_window_ && this->window_triggered_ && (lcdc & LCDC_WINDOW_ENABLE) > 0 && (lcdc & LCDC_BG_ENABLE) > 0) {
+        uint8_t wx = this->memory_bus_[WX_ADDRESS];
+        int start = wx < 7 ? 0 : wx - 7;
+
+        if (wx <= 166 && this->x_ == start) {
+            this->StartWindow(wx);
+            return;
+        }
+    }
+
+    if (this->discard_ > 0) {
+        this->bg_head_ = (this->bg_head_ + 1) & 15;
+        this->bg_size_--;
+        this->discard_--;
+        return;
+    }
+
+    this->OutputPixel(lcdc);
+    this->x_++;
+
+    if (this->x_ == SCREEN_WIDTH) {
+        this->line_complete_ = true;
+        if (this->window_drawn_) {
+            this->window_line_++;
+        }
+    }
+}
+
+void PixelFIFORenderer::StepFetcher(uint8_t lcdc) {
+    const uint8_t* memory = this->memory_bus_;
+    uint8_t row;
+
+    if (this->fetching_window_) {
+        row = this->window_line_ & 7;
+    } else {
+        row = (uint8_t)(memory[SCY_ADDRESS] + this->ly_) & 7;
+    }
+
+    switch (this->fetch_step_) {
+        case 1: {
+            uint16_t address;
+
+            if (this->fetching_window_) {
+                uint16_t map = (lcdc & LCDC_WINDOW_MAP) > 0 ? 0x9C00 : 0x9800;
+                address = (uint16_t)(map + (this->window_line_ >> 3) * 32 + (this->fetch_x_ & 31));
+            } else {
+                uint16_t map = (lcdc & LCDC_BG_MAP) > 0 ? 0x9C00 : 0x9800;
+                uint8_t y = (uint8_t)(memory[SCY_ADDRESS] + this->ly_);
+                uint8_t column = (uint8_t)(((memory[SCX_ADDRESS] >> 3) + this->fetch_x_) & 31);
+                address = (uint16_t)(map + (y >> 3) * 32 + column);
+            }
+
+            this->fetch_tile_ = memory[address];
+            break;
+        }
+        case 3:
+            this->fetch_low_ = memory[TileRowAddress(lcdc, this->fetch_tile_, row)];
+            break;
+        case 5:
+            this->fetch_high_ = memory[TileRowAddress(lcdc, this->fetch_tile_, row) + 1];
+            break;
+        case FETCH_PUSH_STEP:
+            // The row is only pushed once the FIFO has drained
+            if (this->bg_size_ == 0) {
+                for (int bit = 7; bit >= 0; bit--) {
+                    this->bg_fifo_[(this->bg_head_ + this->bg_size_) & 15] = TilePixel(this->fetch_low_, this->fetch_high_, (uint8_t)bit);
+                    this->bg_size_++;
+                }
+                this->fetch_x_++;
+                this->fetch_step_ = 0;
+            }
+            return;
+        default:
+            break;
+    }
+
+    this->fetch_step_++;
+}
+
+void PixelFIFORenderer::StartWindow(uint8_t wx) {
+    this->bg_head_ = 0;
+    this->bg_size_ = 0;
+    this->fetch_step_ = 0;
+    this->fetch_x_ = 0;
+    this->fetching_window_ = true;
+    this->window_drawn_ = true;
+
+    // A window left of the screen edge has its first pixels thrown away
+    this->discard_ = wx < 7 ? (uint8_t)(7 - wx) : 0;
+}
+
+int PixelFIFORenderer::SpriteFetchX(const SpriteEntry& sprite) {
+    // Objects at X 0 or from 168 are entirely off screen and never fetched
+    if (sprite.x == 0 || sprite.x >= SCREEN_WIDTH + 8) {
+        return -1;
+    }
+    return sprite.x < 8 ? 0 : sprite.x - 8;
+}
+
+void PixelFIFORenderer::LoadSprite(const SpriteEntry& sprite, uint8_t lcdc) {
+    uint8_t low;
+    uint8_t high;
+    SpriteRow(this->memory_bus_, sprite, this->ly_, SpriteHeight(lcdc), &low, &high);
+
+    bool x_flip = (sprite.attributes & OAM_X_FLIP) > 0;
+    int left = sprite.x - 8;
+
+    for (int p = 0; p < 8; p++) {
+        int slot = left + p - this->x_;
+
+        // Pixels left of the screen edge are shifted out
+        if (slot < 0) {
+            continue;
+        }
+
+        uint8_t color = TilePixel(low, high, (uint8_t)(x_flip ? p : 7 - p));
+        ObjectPixel& pixel = this->obj_fifo_[(this->obj_head_ + slot) & 7];
+
+        // Pixels already in the FIFO belong to higher priority objects
+        if (pixel.color == 0 && color != 0) {
+            pixel.color = color;
+            pixel.attributes = sprite.attributes;
+        }
+    }
+}
+
+void PixelFIFORenderer::OutputPixel(uint8_t lcdc) {
+    const uint8_t* memory = this->memory_bus_;
+
+    uint8_t bg_color = this->bg_fifo_[this->bg_head_];
+    this->bg_head_ = (this->bg_head_ + 1) & 15;
+    this->bg_size_--;
+
+    ObjectPixel obj = this->obj_fifo_[this->obj_head_];
+    this->obj_fifo_[this->obj_head_].color = 0;
+    this->obj_head_ = (this->obj_head_ + 1) & 7;
+
+    uint32_t shade;
+
+    // Palettes are read as the pixel leaves the FIFO
+    if ((lcdc & LCDC_BG_ENABLE) > 0) {
+        shade = PaletteShade(memory[BGP_ADDRESS], bg_color);
+    } else {
+        bg_color = 0;
+        shade = DMG_SHADES[0];
+    }
+
+    if (obj.color != 0 && (lcdc & LCDC_OBJ_ENABLE) > 0) {
+        if ((obj.attributes & OAM_BG_PRIORITY) == 0 || bg_color == 0) {
+            uint8_t palette = (obj.attributes & OAM_PALETTE) > 0 ? memory[OBP1_ADDRESS] : memory[OBP0_ADDRESS];
+            shade = PaletteShade(palette, obj.color);
+        }
+    }
+
+    this->line_[this->x_] = shade;
+}
@@ -0,0 +1,177 @@
+/**
+ * @file pixel_fifo_renderer.hpp
+ * @brief Dot accurate PPU renderer modelling the background fetcher and pixel FIFOs
+ *
+ */
+
+#ifndef PIXEL_FIFO_RENDERER_H
+#define PIXEL_FIFO_RENDERER_H
+
+#include <cstdint>
+#include "./oam.hpp"
+
+/**
+ * @brief Renders a line one dot at a time through a background FIFO and an object FIFO.
+ *
+ * SCX, SCY, LCDC and WX are read by the fetcher as it runs and the palettes are read as each pixel
+ * leaves the FIFO, so register writes made partway through mode 3 land on the right pixel. The
+ * length of mode 3 varies with the fine scroll, the window and the objects on the line.
+ *
+ * Together with ScanlineRenderer this defines the renderer policy used by PPU:
+ *  - BeginFrame() resets per frame state
+ *  - BeginLine(ly, line) starts mode 3 of a line, drawing into the 160 pixels at line
+ *  - Transfer(dots) advances mode 3 and returns the dots consumed
+ *  - lineComplete() reports when mode 3 has finished
+ *  - OnOAMWrite(address) and InvalidateSprites() report OAM changes, for renderers caching objects
+ */
+class PixelFIFORenderer
+{
+
+private:
+
+    // One pixel waiting in the object FIFO. Colour 0 is transparent
+    struct ObjectPixel {
+        uint8_t color;
+        uint8_t attributes;
+    };
+
+    const uint8_t* memory_bus_;
+
+    uint32_t* line_;
+    uint8_t ly_;
+
+    // The next screen X to be output
+    uint8_t x_;
+
+    // Background pixels still to be thrown away for fine scrolling
+    uint8_t discard_;
+
+    // Dots spent on the dummy fetch at the start of the line
+    uint8_t startup_dots_;
+
+    bool line_complete_;
+
+    // Background FIFO of colour indices
+    uint8_t bg_fifo_[16];
+    uint8_t bg_head_;
+    uint8_t bg_size_;
+
+    // Object FIFO, slot obj_head_ is the pixel at x_
+    ObjectPixel obj_fifo_[8];
+    uint8_t obj_head_;
+
+    // Background fetcher
+    uint8_t fetch_step_;
+    uint8_t fetch_x_;
+    uint8_t fetch_tile_;
+    uint8_t fetch_low_;
+    uint8_t fetch_high_;
+    bool fetching_window_;
+
+    // Window state
+    bool window_triggered_;
+    bool window_drawn_;
+    uint8_t window_line_;
+
+    // Objects on the line in priority order
+    SpriteEntry sprites_[MAX_SPRITES_PER_LINE];
+    uint8_t sprite_count_;
+    uint8_t next_sprite_;
+
+    // Dots left on the current object fetch
+    uint8_t sprite_stall_;
+
+    /**
+     * @brief Advances the renderer by a single dot
+     *
+     */
+    void Step();
+
+    /**
+     * @brief Advances the background fetcher by a single dot
+     *
+     * @param lcdc The LCDC register
+     */
+    void StepFetcher(uint8_t lcdc);
+
+    /**
+     * @brief Restarts the fetcher on the window tile map
+     *
+     * @param wx The WX register
+     */
+    void StartWindow(uint8_t wx);
+
+    /**
+     * @brief Gets the screen X at which an object is fetched
+     *
+     * @param sprite The object
+     * @return int The screen X, or -1 if the object is never fetched
+     */
+    int SpriteFetchX(const SpriteEntry& sprite);
+
+    /**
+     * @brief Fetches an object and merges it into the object FIFO
+     *
+     * @param sprite The object to fetch
+     * @param lcdc The LCDC register
+     */
+    void LoadSprite(const SpriteEntry& sprite, uint8_t lcdc);
+
+    /**
+     * @brief Pops one pixel from each FIFO, mixes them and writes the result to the line
+     *
+     * @param lcdc The LCDC register
+     */
+    void OutputPixel(uint8_t lcdc);
+
+public:
+    /**
+     * @brief Constructs a new PixelFIFORenderer
+     *
+     * @param memory_bus_ptr Pointer to the memory bus holding VRAM, OAM and the LCD registers
+     */
+    PixelFIFORenderer(const uint8_t* memory_bus_ptr);
+
+    /**
+     * @brief Resets per frame state. Called when LY wraps to 0 or the LCD is switched on
+     *
+     */
+    void BeginFrame();
+
+    /**
+     * @brief Starts mode 3 of a line
+     *
+     * @param ly The line entering mode 3
+     * @param line The 160 framebuffer pixels of the line
+     */
+    void BeginLine(uint8_t ly, uint32_t* line);
+
+    /**
+     * @brief Advances mode 3 dot by dot
+     *
+     * @param dots The number of dots available
+     * @return uint16_t The number of dots consumed, less than dots if the line completed
+     */
+    uint16_t Transfer(uint16_t dots);
+
+    /**
+     * @brief Gets whether the current line has finished mode 3
+     *
+     */
+    bool lineComplete();
+
+    /**
+     * @brief Does nothing, OAM is scanned afresh at the start of every line
+     *
+     * @param address The OAM address written to
+     */
+    void OnOAMWrite(uint16_t address);
+
+    /**
+     * @brief Does nothing, OAM is scanned afresh at the start of every line
+     *
+     */
+    void InvalidateSprites();
+};
+
+#endif
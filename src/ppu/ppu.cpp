@@ -0,0 +1,156 @@
+/**
+ * @file ppu.cpp
+ * @brief Implementation of the renderer independent parts of the PPU
+ *
+ */
+
+#include <cstring>
+#include "./ppu.hpp"
+
+PPUBase::PPUBase(uint8_t* memory_bus_ptr) {
+    this->memory_bus_ = memory_bus_ptr;
+    this->framebuffer_ = this->framebuffer_data_;
+    this->mode_ = HBLANK;
+    this->ly_ = 0;
+    this->line_dots_ = 0;
+    this->lcd_enabled_ = false;
+    this->frame_complete_ = false;
+    this->frame_count_ = 0;
+    this->stat_line_ = false;
+
+    for (int i = 0; i < SCREEN_PIXELS; i++) {
+        this->framebuffer_data_[i] = DMG_SHADES[0];
+    }
+}
+
+PPUMode PPUBase::mode() {
+    return this->mode_;
+}
+
+uint8_t PPUBase::ly() {
+    return this->ly_;
+}
+
+uint32_t PPUBase::frameDots() {
+    return this->ly_ * DOTS_PER_LINE + this->line_dots_;
+}
+
+const uint32_t* PPUBase::framebuffer() {
+    return this->framebuffer_;
+}
+
+void PPUBase::SetFramebuffer(uint32_t* framebuffer) {
+    this->framebuffer_ = framebuffer != nullptr ? framebuffer : this->framebuffer_data_;
+}
+
+bool PPUBase::frameComplete() {
+    return this->frame_complete_;
+}
+
+void PPUBase::AcknowledgeFrame() {
+    this->frame_complete_ = false;
+}
+
+uint64_t PPUBase::frameCount() {
+    return this->frame_count_;
+}
+
+uint32_t PPUBase::DotsUntilNextHBlank() {
+    static const uint16_t HBLANK_DOT = OAM_SCAN_DOTS + TRANSFER_DOTS;
+
+    if (!this->lcd_enabled_) {
+        return DOTS_PER_LINE;
+    }
+
+    if (this->ly_ < VISIBLE_LINES && this->mode_ != HBLANK) {
+        // Still before HBlank on this line, or running late in a long mode 3
+        return this->line_dots_ < HBLANK_DOT ? HBLANK_DOT - this->line_dots_ : 1;
+    }
+
+    // The next line, or the first line of the next frame when HBlank of the last line or VBlank has begun
+    uint8_t next_line = this->ly_ + 1 < VISIBLE_LINES ? this->ly_ + 1 : LINES_PER_FRAME;
+    return (next_line - this->ly_) * DOTS_PER_LINE - this->line_dots_ + HBLANK_DOT;
+}
+
+void PPUBase::CopyStateFrom(const PPUBase& other) {
+    this->mode_ = other.mode_;
+    this->ly_ = other.ly_;
+    this->line_dots_ = other.line_dots_;
+    this->lcd_enabled_ = other.lcd_enabled_;
+    this->frame_complete_ = other.frame_complete_;
+    this->frame_count_ = other.frame_count_;
+    this->stat_line_ = other.stat_line_;
+
+    // Into whichever buffer this PPU draws to, so external framebuffers stay where they are
+    memcpy(this->framebuffer_, other.framebuffer_, sizeof(this->framebuffer_data_));
+}
+
+void PPUBase::EnterMode(PPUMode mode) {
+    this->mode_ = mode;
+    this->UpdateStat();
+}
+
+void PPUBase::UpdateStat() {
+    uint8_t stat = this->memory_bus_[STAT_ADDRESS];
+    bool coincidence = this->ly_ == this->memory_bus_[LYC_ADDRESS];
+
+    stat = (stat & 0b11111000) | (coincidence ? STAT_LYC_EQUAL : 0) | this->mode_;
+    this->memory_bus_[STAT_ADDRESS] = stat;
+
+    bool line = (coincidence && (stat & STAT_LYC_SOURCE) > 0)
+        || (this->mode_ == HBLANK && (stat & STAT_HBLANK_SOURCE) > 0)
+        || (this->mode_ == VBLANK && (stat & STAT_VBLANK_SOURCE) > 0)
+        || (this->mode_ == OAM_SCAN && (stat & STAT_OAM_SOURCE) > 0);
+
+    if (line && !this->stat_line_) {
+        this->RequestInterrupt(STAT_INTERRUPT);
+    }
+    this->stat_line_ = line;
+}
+
+void PPUBase::RequestInterrupt(uint8_t interrupt) {
+    this->memory_bus_[IF_ADDRESS] = this->memory_bus_[IF_ADDRESS] | interrupt;
+}
+
+bool PPUBase::NextLine() {
+    this->line_dots_ = 0;
+    this->ly_++;
+
+    if (this->ly_ == LINES_PER_FRAME) {
+        this->ly_ = 0;
+        this->memory_bus_[LY_ADDRESS] = 0;
+        this->EnterMode(OAM_SCAN);
+        return true;
+    }
+
+    this->memory_bus_[LY_ADDRESS] = this->ly_;
+
+    if (this->ly_ == VISIBLE_LINES) {
+        this->EnterMode(VBLANK);
+        this->RequestInterrupt(VBLANK_INTERRUPT);
+        this->frame_complete_ = true;
+        this->frame_count_++;
+    } else if (this->ly_ < VISIBLE_LINES) {
+        this->EnterMode(OAM_SCAN);
+    } else {
+        this->UpdateStat();
+    }
+
+    return false;
+}
+
+void PPUBase::EnableLCD() {
+    this->lcd_enabled_ = true;
+    this->ly_ = 0;
+    this->line_dots_ = 0;
+    this->memory_bus_[LY_ADDRESS] = 0;
+    this->EnterMode(OAM_SCAN);
+}
+
+void PPUBase::DisableLCD() {
+    this->lcd_enabled_ = false;
+    this->ly_ = 0;
+    this->line_dots_ = 0;
+    this->memory_bus_[LY_ADDRESS] = 0;
+    this->EnterMode(HBLANK);
+}
@@ -0,0 +1,303 @@
+/**
+ * @file ppu.hpp
+ * @brief The picture processing unit, parameterised on the renderer that draws each line
+ *
+ */
+
+#ifndef PPU_H
+#define PPU_H
+
+#include <cstdint>
+#include "../cpu/memory_observer.hpp"
+#include "./ppu_registers.hpp"
+#include "./scanline_renderer.hpp"
+#include "./pixel_fifo_renderer.hpp"
+
+/**
+ * @brief State and IO register handling shared by every PPU, independent of how lines are drawn
+ *
+ */
+class PPUBase
+{
+
+protected:
+
+    // The PPU reads VRAM, OAM and its registers straight from the memory bus
+    uint8_t* memory_bus_;
+
+    uint32_t framebuffer_data_[SCREEN_PIXELS];
+    uint32_t* framebuffer_;
+
+    PPUMode mode_;
+    uint8_t ly_;
+
+    // Dots elapsed on the current line
+    uint16_t line_dots_;
+
+    bool lcd_enabled_;
+    bool frame_complete_;
+
+    // Number of times VBlank has been entered
+    uint64_t frame_count_;
+
+    // Level of the combined STAT interrupt sources, the interrupt fires on its rising edge
+    bool stat_line_;
+
+    /**
+     * @brief Switches to a new mode and updates STAT
+     *
+     * @param mode The new mode
+     */
+    void EnterMode(PPUMode mode);
+
+    /**
+     * @brief Writes the mode and LY=LYC bits to STAT and raises the STAT interrupt on a rising edge
+     *
+     */
+    void UpdateStat();
+
+    /**
+     * @brief Sets a bit in the IF register
+     *
+     * @param interrupt The interrupt bit to request
+     */
+    void RequestInterrupt(uint8_t interrupt);
+
+    /**
+     * @brief Moves LY to the next line at the end of a line
+     *
+     * @return true if LY wrapped back to the first line of a new frame
+     */
+    bool NextLine();
+
+    /**
+     * @brief Starts the first line of a frame after the LCD is switched on
+     *
+     */
+    void EnableLCD();
+
+    /**
+     * @brief Stops the PPU and resets LY when the LCD is switched off
+     *
+     */
+    void DisableLCD();
+
+public:
+    /**
+     * @brief Constructs a new PPUBase
+     *
+     * @param memory_bus_ptr Pointer to the memory bus. Expects size of at least 65,536
+     */
+    PPUBase(uint8_t* memory_bus_ptr);
+
+    /**
+     * @brief Gets the current PPU mode
+     *
+     */
+    PPUMode mode();
+
+    /**
+     * @brief Gets the line currently being drawn
+     *
+     */
+    uint8_t ly();
+
+    /**
+     * @brief Gets the number of dots elapsed since the start of the frame
+     *
+     */
+    uint32_t frameDots();
+
+    /**
+     * @brief Gets the framebuffer, 160x144 ARGB8888 pixels in row order
+     *
+     */
+    const uint32_t* framebuffer();
+
+    /**
+     * @brief Redirects drawing into an external 160x144 buffer. Passing nullptr restores the internal buffer
+     *
+     * @param framebuffer The buffer to draw into
+     */
+    void SetFramebuffer(uint32_t* framebuffer);
+
+    /**
+     * @brief Gets whether a frame has been completed since the last call to AcknowledgeFrame
+     *
+     */
+    bool frameComplete();
+
+    /**
+     * @brief Clears the frame complete flag
+     *
+     */
+    void AcknowledgeFrame();
+
+    /**
+     * @brief Gets the number of frames completed since the PPU was created
+     *
+     */
+    uint64_t frameCount();
+
+    /**
+     * @brief Estimates the dots until the next visible line enters HBlank, assuming mode 3 lasts TRANSFER_DOTS.
+     *
+     * Used to schedule work that happens at the start of HBlank, such as HDMA. Renderers with a longer
+     * mode 3 reach HBlank later, so the caller should check mode() when the time comes. Returns
+     * DOTS_PER_LINE while the LCD is off.
+     *
+     * @return uint32_t The number of dots, at least 1
+     */
+    uint32_t DotsUntilNextHBlank();
+
+    /**
+     * @brief Copies the timing state and the current frame of another PPU on the same kind of machine
+     *
+     * @param other The PPU to copy
+     */
+    void CopyStateFrom(const PPUBase& other);
+};
+
+/**
+ * @brief A PPU drawing lines through the Renderer policy.
+ *
+ * The policy is chosen at compile time so the fast path carries none of the cost of the
+ * accurate one. Both share the framebuffer and IO register behaviour of PPUBase, so an owner that
+ * holds one of each can pick per ROM and only pay for the PPU it actually ticks.
+ *
+ * Register the PPU with SM83State::AddMemoryObserver for page 0xFE so renderers caching object
+ * lists see OAM writes and DMA copies.
+ */
+template <typename Renderer>
+class PPU : public PPUBase, public MemoryObserver
+{
+
+private:
+
+    Renderer renderer_;
+
+public:
+    /**
+     * @brief Constructs a new PPU
+     *
+     * @param memory_bus_ptr Pointer to the memory bus. Expects size of at least 65,536
+     */
+    PPU(uint8_t* memory_bus_ptr) : PPUBase(memory_bus_ptr), renderer_(memory_bus_ptr) {}
+
+    /**
+     * @brief Advances the PPU
+     *
+     * @param cycles The number of dots to advance by
+     */
+    void Tick(uint16_t cycles);
+
+    /**
+     * @brief Passes OAM writes on to the renderer
+     *
+     * @param address The 16bit address written to
+     * @param value The value written
+     */
+    void OnMemoryWrite(uint16_t address, uint8_t value) override {
+        if (address >= OAM_START && address <= OAM_END) {
+            this->renderer_.OnOAMWrite(address);
+        }
+    }
+
+    /**
+     * @brief Rebuilds the renderer's object lists once after a block copy into OAM
+     *
+     * @param address The first address written to
+     * @param data The bytes written
+     * @param length The number of bytes written
+     */
+    void OnMemoryBlockWrite(uint16_t address, const uint8_t* data, uint16_t length) override {
+        if (address <= OAM_END && address + length > OAM_START) {
+            this->renderer_.InvalidateSprites();
+        }
+    }
+
+    /**
+     * @brief Tells the renderer OAM has changed in bulk, such as after an OAM DMA
+     *
+     */
+    void InvalidateSprites() {
+        this->renderer_.InvalidateSprites();
+    }
+
+    /**
+     * @brief Copies the state of another PPU between frames.
+     *
+     * Renderers keep no state from one frame to the next beyond their object lists, which are rebuilt,
+     * so the copy is exact as long as neither PPU is part way through a visible line.
+     *
+     * @param other The PPU to copy
+     */
+    void CopyStateFrom(const PPU<Renderer>& other) {
+        PPUBase::CopyStateFrom(other);
+        this->renderer_.BeginFrame();
+        this->renderer_.InvalidateSprites();
+    }
+};
+
+// Draws whole lines at the start of mode 3
+typedef PPU<ScanlineRenderer> FastPPU;
+
+// Steps the pixel FIFO dot by dot, for ROMs relying on mid-line register writes
+typedef PPU<PixelFIFORenderer> AccuratePPU;
+
+template <typename Renderer>
+void PPU<Renderer>::Tick(uint16_t cycles) {
+    if ((this->memory_bus_[LCDC_ADDRESS] & LCDC_LCD_ENABLE) == 0) {
+        if (this->lcd_enabled_) {
+            this->DisableLCD();
+        }
+        return;
+    }
+
+    if (!this->lcd_enabled_) {
+        this->EnableLCD();
+        this->renderer_.BeginFrame();
+    }
+
+    // Each pass runs to the end of the current mode or until the cycles run out
+    while (cycles > 0) {
+        switch (this->mode_) {
+            case OAM_SCAN: {
+                uint16_t remaining = OAM_SCAN_DOTS - this->line_dots_;
+                uint16_t step = cycles < remaining ? cycles : remaining;
+                this->line_dots_ += step;
+                cycles -= step;
+
+                if (this->line_dots_ == OAM_SCAN_DOTS) {
+                    this->EnterMode(TRANSFER);
+                    this->renderer_.BeginLine(this->ly_, this->framebuffer_ + this->ly_ * SCREEN_WIDTH);
+                }
+                break;
+            }
+            case TRANSFER: {
+                uint16_t used = this->renderer_.Transfer(cycles);
+                this->line_dots_ += used;
+                cycles -= used;
+
+                if (this->renderer_.lineComplete()) {
+                    this->EnterMode(HBLANK);
+                }
+                break;
+            }
+            case HBLANK:
+            case VBLANK: {
+                uint16_t remaining = DOTS_PER_LINE - this->line_dots_;
+                uint16_t step = cycles < remaining ? cycles : remaining;
+                this->line_dots_ += step;
+                cycles -= step;
+
+                if (this->line_dots_ == DOTS_PER_LINE && this->NextLine()) {
+                    this->renderer_.BeginFrame();
+                }
+                break;
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,126 @@
+/**
+ * @file ppu_registers.hpp
+ * @brief Memory map, IO register and timing constants shared by the PPU and its renderers
+ *
+ */
+
+#ifndef PPU_REGISTERS_H
+#define PPU_REGISTERS_H
+
+#include <cstdint>
+
+// LCD dimensions
+static const int SCREEN_WIDTH = 160;
+static const int SCREEN_HEIGHT = 144;
+static const int SCREEN_PIXELS = SCREEN_WIDTH * SCREEN_HEIGHT;
+
+// Video memory regions
+static const uint16_t VRAM_START = 0x8000;
+static const uint16_t VRAM_END = 0x9FFF;
+static const uint16_t OAM_START = 0xFE00;
+static const uint16_t OAM_END = 0xFE9F;
+static const uint16_t OAM_SIZE = 160;
+
+// IO registers used by the PPU
+static const uint16_t IF_ADDRESS = 0xFF0F;
+static const uint16_t LCDC_ADDRESS = 0xFF40;
+static const uint16_t STAT_ADDRESS = 0xFF41;
+static const uint16_t SCY_ADDRESS = 0xFF42;
+static const uint16_t SCX_ADDRESS = 0xFF43;
+static const uint16_t LY_ADDRESS = 0xFF44;
+static const uint16_t LYC_ADDRESS = 0xFF45;
+static const uint16_t BGP_ADDRESS = 0xFF47;
+static const uint16_t OBP0_ADDRESS = 0xFF48;
+static const uint16_t OBP1_ADDRESS = 0xFF49;
+static const uint16_t WY_ADDRESS = 0xFF4A;
+static const uint16_t WX_ADDRESS = 0xFF4B;
+
+// LCDC bits
+static const uint8_t LCDC_BG_ENABLE = 0b00000001;
+static const uint8_t LCDC_OBJ_ENABLE = 0b00000010;
+static const uint8_t LCDC_OBJ_SIZE = 0b00000100;
+static const uint8_t LCDC_BG_MAP = 0b00001000;
+static const uint8_t LCDC_TILE_DATA = 0b00010000;
+static const uint8_t LCDC_WINDOW_ENABLE = 0b00100000;
+static const uint8_t LCDC_WINDOW_MAP = 0b01000000;
+static const uint8_t LCDC_LCD_ENABLE = 0b10000000;
+
+// STAT bits
+static const uint8_t STAT_MODE_MASK = 0b00000011;
+static const uint8_t STAT_LYC_EQUAL = 0b00000100;
+static const uint8_t STAT_HBLANK_SOURCE = 0b00001000;
+static const uint8_t STAT_VBLANK_SOURCE = 0b00010000;
+static const uint8_t STAT_OAM_SOURCE = 0b00100000;
+static const uint8_t STAT_LYC_SOURCE = 0b01000000;
+
+// Interrupt flag bits raised by the PPU
+static const uint8_t VBLANK_INTERRUPT = 0b00000001;
+static const uint8_t STAT_INTERRUPT = 0b00000010;
+
+// OAM attribute bits
+static const uint8_t OAM_BG_PRIORITY = 0b10000000;
+static const uint8_t OAM_Y_FLIP = 0b01000000;
+static const uint8_t OAM_X_FLIP = 0b00100000;
+static const uint8_t OAM_PALETTE = 0b00010000;
+
+// Timing, in dots (one dot per 4.19MHz clock)
+static const uint16_t OAM_SCAN_DOTS = 80;
+static const uint16_t TRANSFER_DOTS = 172;
+static const uint16_t DOTS_PER_LINE = 456;
+static const uint8_t VISIBLE_LINES = 144;
+static const uint8_t LINES_PER_FRAME = 154;
+static const uint32_t DOTS_PER_FRAME = DOTS_PER_LINE * LINES_PER_FRAME;
+
+// The four DMG shades as ARGB8888, lightest first
+static const uint32_t DMG_SHADES[4] = { 0xFFFFFFFF, 0xFFAAAAAA, 0xFF555555, 0xFF000000 };
+
+/**
+ * @brief The PPU modes, numbered as they are reported in the STAT register
+ *
+ */
+enum PPUMode : uint8_t {
+    HBLANK = 0,
+    VBLANK = 1,
+    OAM_SCAN = 2,
+    TRANSFER = 3
+};
+
+/**
+ * @brief Maps a 2bit colour index through a DMG palette register to an ARGB shade
+ *
+ * @param palette The value of BGP, OBP0 or OBP1
+ * @param color The 2bit colour index
+ * @return uint32_t The ARGB8888 shade
+ */
+inline uint32_t PaletteShade(uint8_t palette, uint8_t color) {
+    return DMG_SHADES[(palette >> (color * 2)) & 0b11];
+}
+
+/**
+ * @brief Gets the address of one row of a background or window tile
+ *
+ * @param lcdc The LCDC register, selects between the 0x8000 and 0x8800 addressing modes
+ * @param tile The tile index read from the tile map
+ * @param row The row within the tile (0-7)
+ * @return uint16_t The address of the low byte of the row
+ */
+inline uint16_t TileRowAddress(uint8_t lcdc, uint8_t tile, uint8_t row) {
+    if ((lcdc & LCDC_TILE_DATA) > 0) {
+        return (uint16_t)(0x8000 + tile * 16 + row * 2);
+    }
+    return (uint16_t)(0x9000 + (int8_t)tile * 16 + row * 2);
+}
+
+/**
+ * @brief Gets the 2bit colour index of one pixel from the two bytes of a tile row
+ *
+ * @param low The low bitplane of the row
+ * @param high The high bitplane of the row
+ * @param bit The bit of the pixel, 7 is the leftmost pixel
+ * @return uint8_t The colour index (0-3)
+ */
+inline uint8_t TilePixel(uint8_t low, uint8_t high, uint8_t bit) {
+    return (uint8_t)((((high >> bit) & 1) << 1) | ((low >> bit) & 1));
+}
+
+#endif
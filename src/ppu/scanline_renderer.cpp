@@ -0,0 +1,175 @@
+/**
+ * @file scanline_renderer.cpp
+ * @brief Implementation of the fast scanline renderer
+ *
+ */
+
+#include <cstring>
+#include "./scanline_renderer.hpp"
+#include "./ppu_registers.hpp"
+#include "./oam.hpp"
+
+ScanlineRenderer::ScanlineRenderer(const uint8_t* memory_bus_ptr) : sprite_cache_(memory_bus_ptr) {
+    this->memory_bus_ = memory_bus_ptr;
+    this->remaining_dots_ = 0;
+    this->window_triggered_ = false;
+    this->window_line_ = 0;
+}
+
+void ScanlineRenderer::BeginFrame() {
+    this->window_triggered_ = false;
+    this->window_line_ = 0;
+}
+
+void ScanlineRenderer::BeginLine(uint8_t ly, uint32_t* line) {
+    this->remaining_dots_ = TRANSFER_DOTS;
+    this->RenderLine(ly, line);
+}
+
+uint16_t ScanlineRenderer::Transfer(uint16_t dots) {
+    uint16_t used = dots < this->remaining_dots_ ? dots : this->remaining_dots_;
+    this->remaining_dots_ -= used;
+    return used;
+}
+
+bool ScanlineRenderer::lineComplete() {
+    return this->remaining_dots_ == 0;
+}
+
+void ScanlineRenderer::OnOAMWrite(uint16_t address) {
+    this->sprite_cache_.OnOAMWrite(address);
+}
+
+void ScanlineRenderer::InvalidateSprites() {
+    this->sprite_cache_.Invalidate();
+}
+
+void ScanlineRenderer::RenderLine(uint8_t ly, uint32_t* line) {
+    const uint8_t* memory = this->memory_bus_;
+    uint8_t lcdc = memory[LCDC_ADDRESS];
+
+    if (ly == memory[WY_ADDRESS]) {
+        this->window_triggered_ = true;
+    }
+
+    // Colour indices of the background and window, kept for object priority
+    uint8_t bg_colors[SCREEN_WIDTH];
+
+    if ((lcdc & LCDC_BG_ENABLE) > 0) {
+        // The window starts at WX - 7 and covers the rest of the line
+        int window_x = SCREEN_WIDTH;
+        uint8_t wx = memory[WX_ADDRESS];
+
+        if ((lcdc & LCDC_WINDOW_ENABLE) > 0 && this->window_triggered_ && wx <= 166) {
+            window_x = wx - 7;
+        }
+
+        uint8_t scx = memory[SCX_ADDRESS];
+        uint8_t y = (uint8_t)(memory[SCY_ADDRESS] + ly);
+        uint16_t bg_map = (lcdc & LCDC_BG_MAP) > 0 ? 0x9C00 : 0x9800;
+        int bg_end = window_x < 0 ? 0 : window_x;
+
+        this->RenderTiles((uint16_t)(bg_map + (y >> 3) * 32), scx, y & 7, 0, bg_end, lcdc, bg_colors);
+
+        if (window_x < SCREEN_WIDTH) {
+            uint16_t window_map = (lcdc & LCDC_WINDOW_MAP) > 0 ? 0x9C00 : 0x9800;
+            uint8_t window_y = this->window_line_;
+            uint8_t source_x = (uint8_t)(window_x < 0 ? -window_x : 0);
+
+            this->RenderTiles((uint16_t)(window_map + (window_y >> 3) * 32), source_x, window_y & 7, bg_end, SCREEN_WIDTH, lcdc, bg_colors);
+            this->window_line_++;
+        }
+
+        uint8_t bgp = memory[BGP_ADDRESS];
+        uint32_t shades[4] = {
+            PaletteShade(bgp, 0), PaletteShade(bgp, 1), PaletteShade(bgp, 2), PaletteShade(bgp, 3)
+        };
+
+        for (int x = 0; x < SCREEN_WIDTH; x++) {
+            line[x] = shades[bg_colors[x]];
+        }
+    } else {
+        // With the background disabled the line is blank and every object is drawn over it
+        memset(bg_colors, 0, sizeof(bg_colors));
+
+        for (int x = 0; x < SCREEN_WIDTH; x++) {
+            line[x] = DMG_SHADES[0];
+        }
+    }
+
+    if ((lcdc & LCDC_OBJ_ENABLE) > 0) {
+        this->RenderSprites(ly, lcdc, bg_colors, line);
+    }
+}
+
+void ScanlineRenderer::RenderTiles(uint16_t map_row, uint8_t source_x, uint8_t row, int start, int end, uint8_t lcdc, uint8_t* colors) {
+    const uint8_t* memory = this->memory_bus_;
+    int x = start;
+
+    while (x < end) {
+        uint8_t tile = memory[map_row + (source_x >> 3)];
+        uint16_t address = TileRowAddress(lcdc, tile, row);
+        uint8_t low = memory[address];
+        uint8_t high = memory[address + 1];
+
+        // Decode from the current pixel to the end of the tile
+        for (int bit = 7 - (source_x & 7); bit >= 0 && x < end; bit--) {
+            colors[x++] = TilePixel(low, high, (uint8_t)bit);
+            source_x++;
+        }
+    }
+}
+
+void ScanlineRenderer::RenderSprites(uint8_t ly, uint8_t lcdc, const uint8_t* bg_colors, uint32_t* line) {
+    SpriteEntry sprites[MAX_SPRITES_PER_LINE];
+    uint8_t height = SpriteHeight(lcdc);
+    uint8_t count = this->sprite_cache_.Sprites(ly, height, sprites);
+
+    if (count == 0) {
+        return;
+    }
+
+    // The highest priority opaque object pixel at each X, colour 0 meaning none
+    uint8_t obj_colors[SCREEN_WIDTH];
+    uint8_t obj_attributes[SCREEN_WIDTH];
+    memset(obj_colors, 0, sizeof(obj_colors));
+
+    for (uint8_t i = 0; i < count; i++) {
+        const SpriteEntry& sprite = sprites[i];
+        uint8_t low;
+        uint8_t high;
+        SpriteRow(this->memory_bus_, sprite, ly, height, &low, &high);
+
+        bool x_flip = (sprite.attributes & OAM_X_FLIP) > 0;
+
+        for (int p = 0; p < 8; p++) {
+            int x = sprite.x - 8 + p;
+
+            if (x < 0 || x >= SCREEN_WIDTH || obj_colors[x] != 0) {
+                continue;
+            }
+
+            uint8_t color = TilePixel(low, high, (uint8_t)(x_flip ? p : 7 - p));
+            if (color != 0) {
+                obj_colors[x] = color;
+                obj_attributes[x] = sprite.attributes;
+            }
+        }
+    }
+
+    uint8_t obp0 = this->memory_bus_[OBP0_ADDRESS];
+    uint8_t obp1 = this->memory_bus_[OBP1_ADDRESS];
+
+    for (int x = 0; x < SCREEN_WIDTH; x++) {
+        if (obj_colors[x] == 0) {
+            continue;
+        }
+        // Objects behind the background only show through background colour 0
+        if ((obj_attributes[x] & OAM_BG_PRIORITY) > 0 && bg_colors[x] != 0) {
+            continue;
+        }
+
+        uint8_t palette = (obj_attributes[x] & OAM_PALETTE) > 0 ? obp1 : obp0;
+        line[x] = PaletteShade(palette, obj_colors[x]);
+    }
+}
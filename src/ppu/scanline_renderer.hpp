@@ -0,0 +1,120 @@
+/**
+ * @file scanline_renderer.hpp
+ * @brief Fast PPU renderer that draws a whole line at the start of mode 3
+ *
+ */
+
+#ifndef SCANLINE_RENDERER_H
+#define SCANLINE_RENDERER_H
+
+#include <cstdint>
+#include "./sprite_line_cache.hpp"
+
+/**
+ * @brief Renders each line in one pass using the register values latched when mode 3 begins.
+ *
+ * Mode 3 always lasts TRANSFER_DOTS. Register writes made during mode 3 only take effect on the
+ * next line, which is what almost every game expects and is far cheaper than stepping a pixel FIFO.
+ * See PixelFIFORenderer for the renderer policy interface.
+ */
+class ScanlineRenderer
+{
+
+private:
+
+    const uint8_t* memory_bus_;
+
+    // Objects selected for each line, updated as OAM is written
+    SpriteLineCache sprite_cache_;
+
+    // Dots left before the current line finishes mode 3
+    uint16_t remaining_dots_;
+
+    // Set once LY has matched WY during the current frame
+    bool window_triggered_;
+
+    // Internal line counter of the window, only advances on lines where it is drawn
+    uint8_t window_line_;
+
+    /**
+     * @brief Draws the background and window, then the objects, for a line
+     *
+     * @param ly The line to draw
+     * @param line The 160 framebuffer pixels of the line
+     */
+    void RenderLine(uint8_t ly, uint32_t* line);
+
+    /**
+     * @brief Decodes a run of background or window tiles into colour indices
+     *
+     * @param map_row Address of the first tile map entry of the row
+     * @param source_x The X position in the 256x256 map of the first pixel
+     * @param row The row within the tiles (0-7)
+     * @param start The first screen X to fill
+     * @param end One past the last screen X to fill
+     * @param lcdc The LCDC register
+     * @param colors Receives the colour indices, indexed by screen X
+     */
+    void RenderTiles(uint16_t map_row, uint8_t source_x, uint8_t row, int start, int end, uint8_t lcdc, uint8_t* colors);
+
+    /**
+     * @brief Draws the objects on a line over the background
+     *
+     * @param ly The line to draw
+     * @param lcdc The LCDC register
+     * @param bg_colors The background colour indices of the line, used for object priority
+     * @param line The 160 framebuffer pixels of the line
+     */
+    void RenderSprites(uint8_t ly, uint8_t lcdc, const uint8_t* bg_colors, uint32_t* line);
+
+public:
+    /**
+     * @brief Constructs a new ScanlineRenderer
+     *
+     * @param memory_bus_ptr Pointer to the memory bus holding VRAM, OAM and the LCD registers
+     */
+    ScanlineRenderer(const uint8_t* memory_bus_ptr);
+
+    /**
+     * @brief Resets per frame state. Called when LY wraps to 0 or the LCD is switched on
+     *
+     */
+    void BeginFrame();
+
+    /**
+     * @brief Starts mode 3 of a line, drawing all of its pixels immediately
+     *
+     * @param ly The line entering mode 3
+     * @param line The 160 framebuffer pixels of the line
+     */
+    void BeginLine(uint8_t ly, uint32_t* line);
+
+    /**
+     * @brief Advances mode 3
+     *
+     * @param dots The number of dots available
+     * @return uint16_t The number of dots consumed, less than dots if the line completed
+     */
+    uint16_t Transfer(uint16_t dots);
+
+    /**
+     * @brief Gets whether the current line has finished mode 3
+     *
+     */
+    bool lineComplete();
+
+    /**
+     * @brief Updates the object lists after a write to a single OAM byte
+     *
+     * @param address The OAM address written to
+     */
+    void OnOAMWrite(uint16_t address);
+
+    /**
+     * @brief Rebuilds the object lists before the next line, after OAM changed in bulk
+     *
+     */
+    void InvalidateSprites();
+};
+
+#endif
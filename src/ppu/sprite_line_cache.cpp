@@ -0,0 +1,142 @@
+/**
+ * @file sprite_line_cache.cpp
+ * @brief Implementation of the per line object lists
+ *
+ */
+
+#include "./sprite_line_cache.hpp"
+
+SpriteLineCache::SpriteLineCache(const uint8_t* memory_bus_ptr) {
+    this->memory_bus_ = memory_bus_ptr;
+    this->sprite_height_ = 8;
+    this->dirty_ = true;
+}
+
+void SpriteLineCache::Invalidate() {
+    this->dirty_ = true;
+}
+
+void SpriteLineCache::OnOAMWrite(uint16_t address) {
+    // Everything is rebuilt on the next lookup anyway
+    if (this->dirty_) {
+        return;
+    }
+
+    uint8_t index = (uint8_t)((address - OAM_START) >> 2);
+    const uint8_t* entry = this->memory_bus_ + OAM_START + index * 4;
+
+    switch (address & 3) {
+        case 0: {
+            uint8_t old_y = this->oam_y_[index];
+            if (old_y == entry[0]) {
+                return;
+            }
+
+            this->oam_y_[index] = entry[0];
+            this->RebuildLines(old_y);
+            this->RebuildLines(entry[0]);
+            break;
+        }
+        case 1: {
+            int top = this->oam_y_[index] - 16;
+
+            for (int line = top; line < top + this->sprite_height_; line++) {
+                if (line >= 0 && line < SCREEN_HEIGHT) {
+                    this->SortLine((uint8_t)line);
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+uint8_t SpriteLineCache::Sprites(uint8_t ly, uint8_t sprite_height, SpriteEntry* sprites) {
+    if (this->dirty_ || sprite_height != this->sprite_height_) {
+        this->sprite_height_ = sprite_height;
+        this->Rebuild();
+    }
+
+    uint8_t count = this->line_counts_[ly];
+    const uint8_t* oam = this->memory_bus_ + OAM_START;
+
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t index = this->line_sprites_[ly][i];
+        SpriteEntry& sprite = sprites[i];
+
+        sprite.y = oam[index * 4];
+        sprite.x = oam[index * 4 + 1];
+        sprite.tile = oam[index * 4 + 2];
+        sprite.attributes = oam[index * 4 + 3];
+        sprite.index = index;
+    }
+
+    return count;
+}
+
+void SpriteLineCache::Rebuild() {
+    const uint8_t* oam = this->memory_bus_ + OAM_START;
+
+    for (int line = 0; line < SCREEN_HEIGHT; line++) {
+        this->line_counts_[line] = 0;
+    }
+
+    // Walking OAM in order keeps each list in selection order before it is sorted
+    for (uint8_t i = 0; i < OAM_ENTRIES; i++) {
+        this->oam_y_[i] = oam[i * 4];
+        int top = oam[i * 4] - 16;
+
+        for (int line = top; line < top + this->sprite_height_; line++) {
+            if (line >= 0 && line < SCREEN_HEIGHT && this->line_counts_[line] < MAX_SPRITES_PER_LINE) {
+                this->line_sprites_[line][this->line_counts_[line]++] = i;
+            }
+        }
+    }
+
+    for (int line = 0; line < SCREEN_HEIGHT; line++) {
+        this->SortLine((uint8_t)line);
+    }
+
+    this->dirty_ = false;
+}
+
+void SpriteLineCache::RebuildLines(uint8_t oam_y) {
+    int top = oam_y - 16;
+
+    for (int line = top; line < top + this->sprite_height_; line++) {
+        if (line < 0 || line >= SCREEN_HEIGHT) {
+            continue;
+        }
+
+        uint8_t count = 0;
+        for (uint8_t i = 0; i < OAM_ENTRIES && count < MAX_SPRITES_PER_LINE; i++) {
+            int sprite_top = this->oam_y_[i] - 16;
+            if (line >= sprite_top && line < sprite_top + this->sprite_height_) {
+                this->line_sprites_[line][count++] = i;
+            }
+        }
+
+        this->line_counts_[line] = count;
+        this->SortLine((uint8_t)line);
+    }
+}
+
+void SpriteLineCache::SortLine(uint8_t line) {
+    const uint8_t* oam = this->memory_bus_ + OAM_START;
+    uint8_t* sprites = this->line_sprites_[line];
+    uint8_t count = this->line_counts_[line];
+
+    // Lowest X first, OAM index breaking ties
+    for (uint8_t i = 1; i < count; i++) {
+        uint8_t index = sprites[i];
+        uint8_t x = oam[index * 4 + 1];
+        int j = i - 1;
+
+        while (j >= 0 && (oam[sprites[j] * 4 + 1] > x || (oam[sprites[j] * 4 + 1] == x && sprites[j] > index))) {
+            sprites[j + 1] = sprites[j];
+            j--;
+        }
+        sprites[j + 1] = index;
+    }
+}
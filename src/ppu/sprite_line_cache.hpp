@@ -0,0 +1,94 @@
+/**
+ * @file sprite_line_cache.hpp
+ * @brief Precomputed per line object lists, kept in step with OAM writes
+ *
+ */
+
+#ifndef SPRITE_LINE_CACHE_H
+#define SPRITE_LINE_CACHE_H
+
+#include <cstdint>
+#include "./oam.hpp"
+#include "./ppu_registers.hpp"
+
+/**
+ * @brief Holds, for each visible line, the objects the PPU would select during mode 2.
+ *
+ * Each list holds at most MAX_SPRITES_PER_LINE OAM indices, picked in OAM order and stored in
+ * drawing priority order. OAM rarely changes mid frame, so instead of scanning all 40 entries on
+ * every line the lists are built once and patched: a Y write rebuilds the lines the object left
+ * and entered, an X write re-sorts the lines it is on. Tile and attribute bytes are read from
+ * OAM when the line is drawn, so writes to them need no work at all.
+ */
+class SpriteLineCache
+{
+
+private:
+
+    const uint8_t* memory_bus_;
+
+    // Height the lists were built for, 8 or 16
+    uint8_t sprite_height_;
+
+    // Set when the lists have to be rebuilt from scratch before the next lookup
+    bool dirty_;
+
+    // Y byte of each OAM entry as of the last update
+    uint8_t oam_y_[OAM_ENTRIES];
+
+    uint8_t line_counts_[SCREEN_HEIGHT];
+    uint8_t line_sprites_[SCREEN_HEIGHT][MAX_SPRITES_PER_LINE];
+
+    /**
+     * @brief Rebuilds every line list in a single pass over OAM
+     *
+     */
+    void Rebuild();
+
+    /**
+     * @brief Reselects the objects of a range of lines
+     *
+     * @param oam_y The OAM Y value whose lines are rebuilt
+     */
+    void RebuildLines(uint8_t oam_y);
+
+    /**
+     * @brief Sorts one line list into drawing priority order
+     *
+     * @param line The line to sort
+     */
+    void SortLine(uint8_t line);
+
+public:
+    /**
+     * @brief Constructs a new SpriteLineCache. The lists are built on first use
+     *
+     * @param memory_bus_ptr Pointer to the memory bus holding OAM
+     */
+    SpriteLineCache(const uint8_t* memory_bus_ptr);
+
+    /**
+     * @brief Forces a full rebuild, for bulk changes such as OAM DMA
+     *
+     */
+    void Invalidate();
+
+    /**
+     * @brief Updates the lists affected by a write to a single OAM byte
+     *
+     * @param address The OAM address written to, the new value is read from OAM
+     */
+    void OnOAMWrite(uint16_t address);
+
+    /**
+     * @brief Gets the objects on a line in drawing priority order
+     *
+     * @param ly The visible line
+     * @param sprite_height The object height selected by LCDC, 8 or 16
+     * @param sprites Output array with room for MAX_SPRITES_PER_LINE entries
+     * @return uint8_t The number of objects on the line
+     */
+    uint8_t Sprites(uint8_t ly, uint8_t sprite_height, SpriteEntry* sprites);
+};
+
+#endif
@@ -0,0 +1,72 @@
+/**
+ * @file trace.cpp
+ * @brief Decodes a binary execution trace saved by lameboy-headless --trace into text
+ *
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "./cpu/execution_trace.hpp"
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr, "Usage: %s [--last N] [--sym PATH] TRACE\n", program);
+    fprintf(stderr, "  --last N    Only print the newest N instructions\n");
+    fprintf(stderr, "  --sym PATH  Label addresses with the symbols in an RGBDS .sym file\n");
+}
+
+int main(int argc, char *argv[])
+{
+    const char* trace_path = nullptr;
+    long last = 0;
+    const char* sym_path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--last") == 0 && i + 1 < argc) {
+            last = strtol(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--sym") == 0 && i + 1 < argc) {
+            sym_path = argv[++i];
+        } else if (argv[i][0] != '-' && trace_path == nullptr) {
+            trace_path = argv[i];
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (trace_path == nullptr || last < 0) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    SymbolTable symbols;
+    if (sym_path != nullptr && !symbols.LoadSymFile(sym_path)) {
+        fprintf(stderr, "Could not read symbols from %s\n", sym_path);
+        return 1;
+    }
+
+    TraceFileHeader header;
+    std::vector<TraceRecord> records;
+    if (!LoadTrace(trace_path, &header, &records)) {
+        fprintf(stderr, "Could not read a trace from %s\n", trace_path);
+        return 1;
+    }
+
+    size_t first = last > 0 && (size_t)last < records.size() ? records.size() - last : 0;
+    uint64_t cycle = header.first_cycle;
+    for (size_t i = 0; i < first; i++) {
+        cycle += records[i].cycles;
+    }
+
+    // Each line is the instruction and the registers after it ran, the cycle count is where it started
+    printf("%-12s %-4s %-8s %3s  %-2s %-2s %-2s %-2s %-2s %-2s %-2s %-2s %-4s %-4s  %s\n",
+        "cycle", "pc", "op", "cyc", "a", "f", "b", "c", "d", "e", "h", "l", "sp", "flags", "instruction");
+    for (size_t i = first; i < records.size(); i++) {
+        WriteTraceRecord(stdout, records[i], cycle, &symbols);
+        cycle += records[i].cycles;
+    }
+
+    return 0;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file cpu_features.cpp
+ * @brief Implementation of SIMD level detection
+ *
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include "./cpu_features.hpp"
+
+SIMDLevel DetectSIMDLevel() {
+#ifdef LAMEBOY_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SIMD_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SIMD_SSE2;
+    }
+#endif
+    return SIMD_SCALAR;
+}
+
+static SIMDLevel ChooseSIMDLevel() {
+    SIMDLevel level = DetectSIMDLevel();
+    const char* requested = getenv("LAMEBOY_SIMD");
+
+    if (requested == nullptr) {
+        return level;
+    }
+
+    for (int candidate = SIMD_SCALAR; candidate <= SIMD_AVX512; candidate++) {
+        if (strcmp(requested, SIMDLevelName((SIMDLevel)candidate)) == 0 && candidate < level) {
+            return (SIMDLevel)candidate;
+        }
+    }
+    return level;
+}
+
+SIMDLevel ActiveSIMDLevel() {
+    static const SIMDLevel level = ChooseSIMDLevel();
+    return level;
+}
+
+bool SIMDLevelSupported(SIMDLevel level) {
+    return level <= DetectSIMDLevel();
+}
+
+const char* SIMDLevelName(SIMDLevel level) {
+    switch (level) {
+        case SIMD_SSE2:
+            return "sse2";
+        case SIMD_AVX2:
+            return "avx2";
+        case SIMD_AVX512:
+            return "avx512";
+        default:
+            return "scalar";
+    }
+}
@@ -0,0 +1,54 @@
+/**
+ * @file cpu_features.hpp
+ * @brief Runtime detection of the SIMD instruction sets kernels can be dispatched to
+ *
+ */
+
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LAMEBOY_X86 1
+#endif
+
+/**
+ * @brief Instruction set levels, each one including those below it
+ *
+ */
+enum SIMDLevel {
+    SIMD_SCALAR,
+    SIMD_SSE2,
+    SIMD_AVX2,
+    // AVX-512 foundation. Kernels without an AVX-512 version use their AVX2 one
+    SIMD_AVX512
+};
+
+/**
+ * @brief Queries the CPU for the best SIMD level it supports
+ *
+ * @return SIMDLevel SIMD_SCALAR on CPUs other than x86
+ */
+SIMDLevel DetectSIMDLevel();
+
+/**
+ * @brief Gets the SIMD level kernels should use, detected once. The LAMEBOY_SIMD environment
+ * variable (scalar, sse2, avx2 or avx512) can lower it for testing
+ *
+ */
+SIMDLevel ActiveSIMDLevel();
+
+/**
+ * @brief Gets whether kernels for a level can run on this CPU
+ *
+ * @param level The level to check
+ */
+bool SIMDLevelSupported(SIMDLevel level);
+
+/**
+ * @brief Gets the name of a level, as accepted by LAMEBOY_SIMD
+ *
+ * @param level The level
+ */
+const char* SIMDLevelName(SIMDLevel level);
+
+#endif
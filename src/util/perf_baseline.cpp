@@ -0,0 +1,197 @@
+/**
+ * @file perf_baseline.cpp
+ * @brief Implementation of benchmark baselines and the Mann-Whitney U test
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include "./perf_baseline.hpp"
+
+// First line of a baseline file, bumped if the format changes
+static const char* BASELINE_HEADER = "# lameboy perf baseline 1";
+
+bool SavePerfBaseline(const char* path, const std::vector<PerfMetric>& metrics) {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    fprintf(file, "%s\n", BASELINE_HEADER);
+    for (const PerfMetric& metric : metrics) {
+        fprintf(file, "%s %s %s", metric.name.c_str(), metric.unit.c_str(), metric.higher_is_better ? "higher" : "lower");
+        for (double sample : metric.samples) {
+            fprintf(file, " %.9g", sample);
+        }
+        fprintf(file, "\n");
+    }
+
+    return fclose(file) == 0;
+}
+
+bool LoadPerfBaseline(const char* path, std::vector<PerfMetric>* metrics) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::string text;
+    char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        text.append(buffer, read);
+    }
+    fclose(file);
+
+    std::istringstream lines(text);
+    std::string line;
+    if (!std::getline(lines, line) || line != BASELINE_HEADER) {
+        return false;
+    }
+
+    metrics->clear();
+    while (std::getline(lines, line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        PerfMetric metric;
+        std::string direction;
+        if (!(fields >> metric.name >> metric.unit >> direction)) {
+            return false;
+        }
+        if (direction != "higher" && direction != "lower") {
+            return false;
+        }
+        metric.higher_is_better = direction == "higher";
+
+        double sample;
+        while (fields >> sample) {
+            metric.samples.push_back(sample);
+        }
+        if (!fields.eof() || metric.samples.empty()) {
+            return false;
+        }
+        metrics->push_back(metric);
+    }
+
+    return true;
+}
+
+double Median(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    size_t middle = samples.size() / 2;
+
+    if (samples.size() % 2 == 0) {
+        return (samples[middle - 1] + samples[middle]) / 2;
+    }
+    return samples[middle];
+}
+
+double MannWhitneyGreater(const std::vector<double>& x, const std::vector<double>& y) {
+    double n1 = (double)x.size();
+    double n2 = (double)y.size();
+    if (x.empty() || y.empty()) {
+        return 1.0;
+    }
+
+    // Rank both samples together, giving tied values the mean of their ranks
+    std::vector<std::pair<double, bool>> pooled;
+    for (double value : x) {
+        pooled.push_back(std::make_pair(value, true));
+    }
+    for (double value : y) {
+        pooled.push_back(std::make_pair(value, false));
+    }
+    std::sort(pooled.begin(), pooled.end());
+
+    double x_rank_sum = 0;
+    double tie_term = 0;
+    size_t i = 0;
+    while (i < pooled.size()) {
+        size_t j = i;
+        while (j < pooled.size() && pooled[j].first == pooled[i].first) {
+            j++;
+        }
+
+        double rank = (i + 1 + j) / 2.0;
+        for (size_t k = i; k < j; k++) {
+            if (pooled[k].second) {
+                x_rank_sum += rank;
+            }
+        }
+
+        double tied = (double)(j - i);
+        tie_term += tied * tied * tied - tied;
+        i = j;
+    }
+
+    double u = x_rank_sum - n1 * (n1 + 1) / 2;
+    double mean = n1 * n2 / 2;
+    double n = n1 + n2;
+    double variance = n1 * n2 / 12 * ((n + 1) - tie_term / (n * (n - 1)));
+
+    if (variance <= 0) {
+        // Every sample is equal, so neither side is larger
+        return u > mean ? 0.0 : 1.0;
+    }
+
+    double z = (u - mean - 0.5) / std::sqrt(variance);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+PerfComparison ComparePerfMetric(const PerfMetric& baseline, const PerfMetric& current, double threshold, double alpha) {
+    PerfComparison result;
+    result.change = Median(current.samples) / Median(baseline.samples) - 1;
+
+    // Moves the baseline by the threshold in the worse direction for the regression test, and in the
+    // better direction for the improvement test
+    std::vector<double> worse_baseline = baseline.samples;
+    std::vector<double> better_baseline = baseline.samples;
+    for (size_t i = 0; i < baseline.samples.size(); i++) {
+        if (baseline.higher_is_better) {
+            worse_baseline[i] = baseline.samples[i] / (1 + threshold);
+            better_baseline[i] = baseline.samples[i] * (1 + threshold);
+        } else {
+            worse_baseline[i] = baseline.samples[i] * (1 + threshold);
+            better_baseline[i] = baseline.samples[i] / (1 + threshold);
+        }
+    }
+
+    double improvement_p;
+    if (baseline.higher_is_better) {
+        result.p_value = MannWhitneyGreater(worse_baseline, current.samples);
+        improvement_p = MannWhitneyGreater(current.samples, better_baseline);
+    } else {
+        result.p_value = MannWhitneyGreater(current.samples, worse_baseline);
+        improvement_p = MannWhitneyGreater(better_baseline, current.samples);
+    }
+
+    result.regression = result.p_value < alpha;
+    result.improvement = improvement_p < alpha;
+    return result;
+}
+
+std::vector<bool> HolmSignificant(const std::vector<double>& p_values, double alpha) {
+    std::vector<size_t> order(p_values.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return p_values[a] < p_values[b];
+    });
+
+    // The smallest p value is tested at alpha / n, the next at alpha / (n - 1), stopping at the first
+    // that is not significant
+    std::vector<bool> significant(p_values.size(), false);
+    for (size_t rank = 0; rank < order.size(); rank++) {
+        if (p_values[order[rank]] >= alpha / (order.size() - rank)) {
+            break;
+        }
+        significant[order[rank]] = true;
+    }
+    return significant;
+}
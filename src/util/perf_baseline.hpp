@@ -0,0 +1,103 @@
+/**
+ * @file perf_baseline.hpp
+ * @brief Stored benchmark samples and the statistical comparison used to catch performance regressions
+ *
+ */
+
+#ifndef PERF_BASELINE_H
+#define PERF_BASELINE_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Repeated measurements of one quantity, such as ns/op of a handler or frames/s of a ROM
+ *
+ */
+struct PerfMetric {
+    // Identifies the metric between runs, without whitespace
+    std::string name;
+    // Unit shown in reports, without whitespace
+    std::string unit;
+    // True for rates such as frames/s, false for times such as ns/op
+    bool higher_is_better;
+    std::vector<double> samples;
+};
+
+/**
+ * @brief The outcome of comparing a metric against its baseline
+ *
+ */
+struct PerfComparison {
+    // Median of the current samples over the median of the baseline samples, minus one
+    double change;
+    // One sided p value that the metric got worse by more than the threshold
+    double p_value;
+    // Worse by more than the threshold, at the requested significance
+    bool regression;
+    // Better by more than the threshold, at the requested significance
+    bool improvement;
+};
+
+/**
+ * @brief Writes metrics to a text file, one per line as name, unit, direction and samples
+ *
+ * @param path The file to write
+ * @param metrics The metrics to save
+ * @return true if the file was written
+ */
+bool SavePerfBaseline(const char* path, const std::vector<PerfMetric>& metrics);
+
+/**
+ * @brief Reads metrics written by SavePerfBaseline
+ *
+ * @param path The file to read
+ * @param metrics Receives the metrics
+ * @return true if the file was read and every line parsed
+ */
+bool LoadPerfBaseline(const char* path, std::vector<PerfMetric>* metrics);
+
+/**
+ * @brief Gets the median of a set of samples
+ *
+ * @param samples The samples, at least one
+ * @return double The median
+ */
+double Median(std::vector<double> samples);
+
+/**
+ * @brief One sided Mann-Whitney U test, using the normal approximation with tie and continuity
+ * corrections. Makes no assumption about the shape of the timing distribution.
+ *
+ * @param x The samples expected to be larger
+ * @param y The samples expected to be smaller
+ * @return double The p value for x tending to be larger than y
+ */
+double MannWhitneyGreater(const std::vector<double>& x, const std::vector<double>& y);
+
+/**
+ * @brief Compares current samples of a metric against its baseline.
+ *
+ * The samples are tested against the baseline shifted by the threshold, so a regression is only
+ * reported when the metric is significantly worse than the baseline by more than the threshold.
+ * Slowdowns smaller than the threshold are treated as noise however consistent they are.
+ *
+ * @param baseline The stored samples
+ * @param current The new samples of the same metric
+ * @param threshold Relative change treated as noise, such as 0.05 for 5%
+ * @param alpha Significance level, such as 0.01
+ * @return PerfComparison The change and verdict
+ */
+PerfComparison ComparePerfMetric(const PerfMetric& baseline, const PerfMetric& current, double threshold, double alpha);
+
+/**
+ * @brief Holm-Bonferroni step down procedure, so comparing many metrics at once keeps the chance of
+ * any false alarm at alpha
+ *
+ * @param p_values The p value of each test
+ * @param alpha The family wise significance level
+ * @return std::vector<bool> Whether each test remains significant
+ */
+std::vector<bool> HolmSignificant(const std::vector<double>& p_values, double alpha);
+
+#endif
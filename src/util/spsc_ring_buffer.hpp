@@ -0,0 +1,149 @@
+/**
+ * @file spsc_ring_buffer.hpp
+ * @brief Lock-free single producer, single consumer ring buffer
+ *
+ */
+
+#ifndef SPSC_RING_BUFFER_H
+#define SPSC_RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Keeps the producer and consumer indices on separate cache lines
+static const size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief A bounded FIFO safe for exactly one pushing thread and one popping thread.
+ *
+ * Each side only writes its own index and keeps a cached copy of the other side's, so the shared
+ * cache lines are touched only when the cached copy says the buffer looks full or empty.
+ */
+template <typename T>
+class SPSCRingBuffer
+{
+
+private:
+
+    std::vector<T> buffer_;
+    size_t mask_;
+
+    // Written by the consumer only
+    std::atomic<size_t> head_;
+    char head_padding_[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+
+    // Written by the producer only
+    std::atomic<size_t> tail_;
+    char tail_padding_[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+
+    // Producer's last view of head_
+    size_t cached_head_;
+    char cached_head_padding_[CACHE_LINE_SIZE - sizeof(size_t)];
+
+    // Consumer's last view of tail_
+    size_t cached_tail_;
+
+public:
+    /**
+     * @brief Constructs a new SPSCRingBuffer
+     *
+     * @param capacity The minimum number of items the buffer can hold, rounded up to a power of two
+     */
+    SPSCRingBuffer(size_t capacity) : head_(0), tail_(0), cached_head_(0), cached_tail_(0) {
+        size_t size = 1;
+        while (size < capacity) {
+            size = size << 1;
+        }
+        this->buffer_.resize(size);
+        this->mask_ = size - 1;
+    }
+
+    /**
+     * @brief Gets the number of items the buffer can hold
+     *
+     */
+    size_t capacity() const {
+        return this->mask_ + 1;
+    }
+
+    /**
+     * @brief Gets the number of items in the buffer. Exact only when called from the producer or consumer
+     *
+     */
+    size_t size() const {
+        return this->tail_.load(std::memory_order_acquire) - this->head_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Adds one item. Producer only
+     *
+     * @param item The item to add
+     * @return true if the item was added, false if the buffer was full
+     */
+    bool TryPush(const T& item) {
+        return this->Push(&item, 1) == 1;
+    }
+
+    /**
+     * @brief Removes one item. Consumer only
+     *
+     * @param item Receives the item
+     * @return true if an item was removed, false if the buffer was empty
+     */
+    bool TryPop(T* item) {
+        return this->Pop(item, 1) == 1;
+    }
+
+    /**
+     * @brief Adds as many items as fit. Producer only
+     *
+     * @param items The items to add
+     * @param count The number of items
+     * @return size_t The number of items added
+     */
+    size_t Push(const T* items, size_t count) {
+        size_t tail = this->tail_.load(std::memory_order_relaxed);
+        size_t free = this->capacity() - (tail - this->cached_head_);
+
+        if (free < count) {
+            this->cached_head_ = this->head_.load(std::memory_order_acquire);
+            free = this->capacity() - (tail - this->cached_head_);
+        }
+
+        size_t n = count < free ? count : free;
+        for (size_t i = 0; i < n; i++) {
+            this->buffer_[(tail + i) & this->mask_] = items[i];
+        }
+
+        this->tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief Removes up to count items. Consumer only
+     *
+     * @param items Receives the items
+     * @param count The maximum number of items to remove
+     * @return size_t The number of items removed
+     */
+    size_t Pop(T* items, size_t count) {
+        size_t head = this->head_.load(std::memory_order_relaxed);
+        size_t available = this->cached_tail_ - head;
+
+        if (available < count) {
+            this->cached_tail_ = this->tail_.load(std::memory_order_acquire);
+            available = this->cached_tail_ - head;
+        }
+
+        size_t n = count < available ? count : available;
+        for (size_t i = 0; i < n; i++) {
+            items[i] = this->buffer_[(head + i) & this->mask_];
+        }
+
+        this->head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+};
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ * @file triple_buffer.hpp
+ * @brief Lock-free triple buffer handing whole frames from one thread to another
+ *
+ */
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Three equally sized arrays shared by one writing thread and one reading thread.
+ *
+ * The writer always owns a back buffer and the reader always owns a front buffer, so neither ever
+ * waits for the other. Publishing swaps the back buffer with the middle one and marks it fresh;
+ * acquiring swaps the front buffer with the middle one if it is fresh. The reader therefore only
+ * ever sees complete buffers, and when it falls behind it skips straight to the newest one.
+ */
+template <typename T>
+class TripleBuffer
+{
+
+private:
+
+    // Set on the middle index when it holds a buffer the reader has not seen
+    static const uint8_t FRESH = 0b00000100;
+    static const uint8_t INDEX_MASK = 0b00000011;
+
+    std::vector<T> storage_;
+    size_t length_;
+
+    // Index of the buffer between the two threads, plus the FRESH bit
+    std::atomic<uint8_t> middle_;
+
+    // Owned by the writer
+    uint8_t back_;
+
+    // Owned by the reader
+    uint8_t front_;
+
+public:
+    /**
+     * @brief Constructs a new TripleBuffer
+     *
+     * @param length The number of items in each buffer
+     */
+    TripleBuffer(size_t length) : storage_(length * 3), length_(length), middle_(1), back_(0), front_(2) {}
+
+    /**
+     * @brief Gets the number of items in each buffer
+     *
+     */
+    size_t length() const {
+        return this->length_;
+    }
+
+    /**
+     * @brief Gets the buffer to fill with the next frame. Writer only
+     *
+     */
+    T* WriteBuffer() {
+        return this->storage_.data() + this->back_ * this->length_;
+    }
+
+    /**
+     * @brief Hands the filled write buffer to the reader and takes a new write buffer. Writer only
+     *
+     */
+    void Publish() {
+        uint8_t previous = this->middle_.exchange((uint8_t)(this->back_ | FRESH), std::memory_order_acq_rel);
+        this->back_ = previous & INDEX_MASK;
+    }
+
+    /**
+     * @brief Takes the newest published buffer, if there is one the reader has not seen. Reader only
+     *
+     * @return true if ReadBuffer() now holds a new frame
+     */
+    bool Acquire() {
+        if ((this->middle_.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+
+        uint8_t previous = this->middle_.exchange(this->front_, std::memory_order_acq_rel);
+        this->front_ = previous & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * @brief Gets the buffer last taken by Acquire. Reader only
+     *
+     */
+    const T* ReadBuffer() const {
+        return this->storage_.data() + this->front_ * this->length_;
+    }
+};
+
+#endif
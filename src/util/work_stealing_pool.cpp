@@ -0,0 +1,81 @@
+/**
+ * @file work_stealing_pool.cpp
+ * @brief Implementation of the work stealing thread pool
+ *
+ */
+
+#include <thread>
+#include <vector>
+#include "./work_stealing_pool.hpp"
+
+WorkStealingPool::WorkStealingPool(size_t thread_count) : steals_(0) {
+    if (thread_count == 0) {
+        thread_count = std::thread::hardware_concurrency();
+    }
+
+    this->thread_count_ = thread_count > 0 ? thread_count : 1;
+    this->queues_ = new WorkerQueue[this->thread_count_];
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    delete[] this->queues_;
+}
+
+bool WorkStealingPool::TakeOwn(size_t worker, size_t* job) {
+    WorkerQueue& queue = this->queues_[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.jobs.empty()) {
+        return false;
+    }
+
+    *job = queue.jobs.front();
+    queue.jobs.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::Steal(size_t worker, size_t* job) {
+    // Start with the next worker along so thieves spread out over the victims
+    for (size_t i = 1; i < this->thread_count_; i++) {
+        WorkerQueue& queue = this->queues_[(worker + i) % this->thread_count_];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.jobs.empty()) {
+            *job = queue.jobs.back();
+            queue.jobs.pop_back();
+            this->steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WorkStealingPool::Run(size_t job_count, const std::function<void(size_t worker, size_t job)>& work) {
+    for (size_t job = 0; job < job_count; job++) {
+        this->queues_[job % this->thread_count_].jobs.push_back(job);
+    }
+
+    // No jobs are added once running, so a worker that finds every queue empty is done
+    std::vector<std::thread> threads;
+    for (size_t worker = 0; worker < this->thread_count_; worker++) {
+        threads.emplace_back([this, worker, &work]() {
+            size_t job;
+            while (this->TakeOwn(worker, &job) || this->Steal(worker, &job)) {
+                work(worker, job);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+size_t WorkStealingPool::threadCount() {
+    return this->thread_count_;
+}
+
+uint64_t WorkStealingPool::steals() {
+    return this->steals_.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,91 @@
+/**
+ * @file work_stealing_pool.hpp
+ * @brief Thread pool that balances a fixed set of jobs by letting idle workers steal queued ones
+ *
+ */
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+/**
+ * @brief Runs numbered jobs across a set of worker threads.
+ *
+ * Jobs are dealt round robin into one queue per worker. Each worker takes from the front of its own
+ * queue and, once that is empty, steals from the back of the others, so a few long jobs landing
+ * on one worker do not leave the rest idle. Queues are only touched once per job, so each is guarded
+ * by its own mutex rather than anything cleverer.
+ *
+ * Work is passed the worker index, letting callers keep per worker state such as an emulator that
+ * is reused from one job to the next.
+ */
+class WorkStealingPool
+{
+
+private:
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<size_t> jobs;
+    };
+
+    size_t thread_count_;
+    WorkerQueue* queues_;
+    std::atomic<uint64_t> steals_;
+
+    /**
+     * @brief Takes the next job from a worker's own queue
+     *
+     * @param worker The worker index
+     * @param job Receives the job
+     * @return true if there was a job
+     */
+    bool TakeOwn(size_t worker, size_t* job);
+
+    /**
+     * @brief Takes the last job from another worker's queue
+     *
+     * @param worker The index of the worker stealing
+     * @param job Receives the job
+     * @return true if any queue had a job
+     */
+    bool Steal(size_t worker, size_t* job);
+
+public:
+    /**
+     * @brief Constructs a new WorkStealingPool
+     *
+     * @param thread_count The number of workers, or 0 for one per hardware thread
+     */
+    WorkStealingPool(size_t thread_count = 0);
+
+    ~WorkStealingPool();
+
+    /**
+     * @brief Runs jobs 0 to job_count - 1 and returns once all have finished
+     *
+     * @param job_count The number of jobs
+     * @param work Called once per job with the worker index and the job number. Must not throw
+     */
+    void Run(size_t job_count, const std::function<void(size_t worker, size_t job)>& work);
+
+    /**
+     * @brief Gets the number of workers
+     *
+     */
+    size_t threadCount();
+
+    /**
+     * @brief Gets the number of jobs taken from another worker's queue, over every run
+     *
+     */
+    uint64_t steals();
+};
+
+#endif
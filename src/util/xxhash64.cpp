@@ -0,0 +1,100 @@
+/**
+ * @file xxhash64.cpp
+ * @brief Implementation of XXH64
+ *
+ */
+
+#include <cstring>
+#include "./xxhash64.hpp"
+
+static const uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME_3 = 0x165667B19E3779F9ULL;
+static const uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t RotateLeft64(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline uint64_t Read64(const uint8_t* data) {
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static inline uint32_t Read32(const uint8_t* data) {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static inline uint64_t Round(uint64_t accumulator, uint64_t input) {
+    accumulator += input * PRIME_2;
+    accumulator = RotateLeft64(accumulator, 31);
+    return accumulator * PRIME_1;
+}
+
+static inline uint64_t MergeRound(uint64_t hash, uint64_t accumulator) {
+    hash ^= Round(0, accumulator);
+    return hash * PRIME_1 + PRIME_4;
+}
+
+uint64_t XXHash64(const void* data, size_t length, uint64_t seed) {
+    const uint8_t* input = (const uint8_t*)data;
+    const uint8_t* end = input + length;
+    uint64_t hash;
+
+    if (length >= 32) {
+        // Four independent lanes over 32 byte stripes
+        uint64_t v1 = seed + PRIME_1 + PRIME_2;
+        uint64_t v2 = seed + PRIME_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME_1;
+
+        do {
+            v1 = Round(v1, Read64(input));
+            v2 = Round(v2, Read64(input + 8));
+            v3 = Round(v3, Read64(input + 16));
+            v4 = Round(v4, Read64(input + 24));
+            input += 32;
+        } while (input + 32 <= end);
+
+        hash = RotateLeft64(v1, 1) + RotateLeft64(v2, 7) + RotateLeft64(v3, 12) + RotateLeft64(v4, 18);
+        hash = MergeRound(hash, v1);
+        hash = MergeRound(hash, v2);
+        hash = MergeRound(hash, v3);
+        hash = MergeRound(hash, v4);
+    } else {
+        hash = seed + PRIME_5;
+    }
+
+    hash += (uint64_t)length;
+
+    while (input + 8 <= end) {
+        hash ^= Round(0, Read64(input));
+        hash = RotateLeft64(hash, 27) * PRIME_1 + PRIME_4;
+        input += 8;
+    }
+
+    if (input + 4 <= end) {
+        hash ^= (uint64_t)Read32(input) * PRIME_1;
+        hash = RotateLeft64(hash, 23) * PRIME_2 + PRIME_3;
+        input += 4;
+    }
+
+    while (input < end) {
+        hash ^= (*input) * PRIME_5;
+        hash = RotateLeft64(hash, 11) * PRIME_1;
+        input++;
+    }
+
+    // Avalanche
+    hash ^= hash >> 33;
+    hash *= PRIME_2;
+    hash ^= hash >> 29;
+    hash *= PRIME_3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
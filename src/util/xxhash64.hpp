@@ -0,0 +1,23 @@
+/**
+ * @file xxhash64.hpp
+ * @brief 64bit xxHash (XXH64) used to fingerprint frames
+ *
+ */
+
+#ifndef XXHASH64_H
+#define XXHASH64_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Hashes a buffer with XXH64, matching the reference implementation on little endian hosts
+ *
+ * @param data The bytes to hash
+ * @param length The number of bytes
+ * @param seed The hash seed
+ * @return uint64_t The hash
+ */
+uint64_t XXHash64(const void* data, size_t length, uint64_t seed = 0);
+
+#endif
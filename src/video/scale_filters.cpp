@@ -0,0 +1,137 @@
+/**
+ * @file scale_filters.cpp
+ * @brief Scaling filter dispatch and the scalar reference kernels
+ *
+ */
+
+#include <cstring>
+#include "./scale_filters.hpp"
+#include "./scale_kernels.hpp"
+
+static void ExpandRowScalar(const uint32_t* src, int width, int factor, uint32_t* dst) {
+    for (int x = 0; x < width; x++) {
+        for (int i = 0; i < factor; i++) {
+            *dst++ = src[x];
+        }
+    }
+}
+
+static void DimRowScalar(uint32_t* pixels, int count) {
+    for (int i = 0; i < count; i++) {
+        pixels[i] = DimPixel(pixels[i]);
+    }
+}
+
+static void Scale2xRowScalar(const uint32_t* above, const uint32_t* cur, const uint32_t* below, int width, uint32_t* top, uint32_t* bottom) {
+    for (int x = 0; x < width; x++) {
+        uint32_t left = cur[x > 0 ? x - 1 : 0];
+        uint32_t right = cur[x < width - 1 ? x + 1 : x];
+        Scale2xPixel(above[x], left, cur[x], right, below[x], top + x * 2, bottom + x * 2);
+    }
+}
+
+static void Scale3xRowScalar(const uint32_t* above, const uint32_t* cur, const uint32_t* below, int width, uint32_t* rows[3]) {
+    for (int x = 0; x < width; x++) {
+        int l = x > 0 ? x - 1 : 0;
+        int r = x < width - 1 ? x + 1 : x;
+        uint32_t* block[3] = { rows[0] + x * 3, rows[1] + x * 3, rows[2] + x * 3 };
+        Scale3xPixel(above[l], above[x], above[r], cur[l], cur[x], cur[r], below[l], below[x], below[r], block);
+    }
+}
+
+const ScaleKernels SCALAR_SCALE_KERNELS = {
+    ExpandRowScalar,
+    DimRowScalar,
+    Scale2xRowScalar,
+    Scale3xRowScalar
+};
+
+static const ScaleKernels& KernelsFor(SIMDLevel level) {
+#ifdef LAMEBOY_X86
+    if (level >= SIMD_AVX2) {
+        return AVX2_SCALE_KERNELS;
+    }
+    if (level == SIMD_SSE2) {
+        return SSE2_SCALE_KERNELS;
+    }
+#endif
+    return SCALAR_SCALE_KERNELS;
+}
+
+bool ParseScaleFilter(const char* name, ScaleFilter* filter) {
+    if (strcmp(name, "nearest") == 0) {
+        *filter = NEAREST_FILTER;
+    } else if (strcmp(name, "scale2x") == 0) {
+        *filter = SCALE2X_FILTER;
+    } else if (strcmp(name, "scale3x") == 0) {
+        *filter = SCALE3X_FILTER;
+    } else if (strcmp(name, "lcd") == 0) {
+        *filter = LCD_GRID_FILTER;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int FilterFactor(ScaleFilter filter, int requested) {
+    switch (filter) {
+        case SCALE2X_FILTER:
+            return 2;
+        case SCALE3X_FILTER:
+            return 3;
+        default:
+            if (requested < MIN_SCALE_FACTOR) {
+                return MIN_SCALE_FACTOR;
+            }
+            return requested > MAX_SCALE_FACTOR ? MAX_SCALE_FACTOR : requested;
+    }
+}
+
+void ScaleFrame(ScaleFilter filter, int factor, const uint32_t* src, int width, int height, uint32_t* dst, int dst_pitch, SIMDLevel level) {
+    const ScaleKernels& kernels = KernelsFor(level);
+    size_t row_bytes = (size_t)width * factor * sizeof(uint32_t);
+
+    for (int y = 0; y < height; y++) {
+        const uint32_t* cur = src + y * width;
+        const uint32_t* above = y > 0 ? cur - width : cur;
+        const uint32_t* below = y < height - 1 ? cur + width : cur;
+        uint32_t* out = dst + (size_t)y * factor * dst_pitch;
+
+        switch (filter) {
+            case SCALE2X_FILTER:
+                kernels.scale2x_row(above, cur, below, width, out, out + dst_pitch);
+                break;
+            case SCALE3X_FILTER: {
+                uint32_t* rows[3] = { out, out + dst_pitch, out + 2 * dst_pitch };
+                kernels.scale3x_row(above, cur, below, width, rows);
+                break;
+            }
+            case LCD_GRID_FILTER: {
+                kernels.expand_row(cur, width, factor, out);
+                if (factor == 1) {
+                    break;
+                }
+
+                // Dim the right column of each block, then copy the row down and dim the whole bottom row
+                for (int x = 0; x < width; x++) {
+                    out[x * factor + factor - 1] = DimPixel(cur[x]);
+                }
+                for (int r = 1; r < factor; r++) {
+                    memcpy(out + r * dst_pitch, out, row_bytes);
+                }
+                kernels.dim_row(out + (factor - 1) * dst_pitch, width * factor);
+                break;
+            }
+            default:
+                kernels.expand_row(cur, width, factor, out);
+                for (int r = 1; r < factor; r++) {
+                    memcpy(out + r * dst_pitch, out, row_bytes);
+                }
+                break;
+        }
+    }
+}
+
+void ScaleFrame(ScaleFilter filter, int factor, const uint32_t* src, int width, int height, uint32_t* dst, int dst_pitch) {
+    ScaleFrame(filter, factor, src, width, height, dst, dst_pitch, ActiveSIMDLevel());
+}
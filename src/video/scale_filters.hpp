@@ -0,0 +1,70 @@
+/**
+ * @file scale_filters.hpp
+ * @brief CPU side upscaling filters for the framebuffer, with scalar reference and SIMD kernels
+ *
+ */
+
+#ifndef SCALE_FILTERS_H
+#define SCALE_FILTERS_H
+
+#include <cstdint>
+#include "../util/cpu_features.hpp"
+
+// Range of factors accepted by the nearest neighbour and LCD grid filters
+static const int MIN_SCALE_FACTOR = 1;
+static const int MAX_SCALE_FACTOR = 6;
+
+/**
+ * @brief The available filters
+ *
+ */
+enum ScaleFilter {
+    // Each pixel becomes a factor x factor block
+    NEAREST_FILTER,
+    // EPX / AdvMAME2x edge smoothing, always 2x
+    SCALE2X_FILTER,
+    // AdvMAME3x edge smoothing, always 3x
+    SCALE3X_FILTER,
+    // Nearest neighbour with the last row and column of every block dimmed to 75%, like the gaps between LCD cells
+    LCD_GRID_FILTER
+};
+
+/**
+ * @brief Looks up a filter by name: nearest, scale2x, scale3x or lcd
+ *
+ * @param name The name of the filter
+ * @param filter Receives the filter
+ * @return true if the name is known
+ */
+bool ParseScaleFilter(const char* name, ScaleFilter* filter);
+
+/**
+ * @brief Gets the factor a filter will actually scale by
+ *
+ * @param filter The filter
+ * @param requested The requested factor, clamped to MIN_SCALE_FACTOR..MAX_SCALE_FACTOR where the filter allows any factor
+ * @return int The factor
+ */
+int FilterFactor(ScaleFilter filter, int requested);
+
+/**
+ * @brief Scales an image into a buffer factor times as wide and high
+ *
+ * @param filter The filter to apply
+ * @param factor The factor returned by FilterFactor
+ * @param src The source pixels, width x height ARGB8888 in row order
+ * @param width The source width
+ * @param height The source height
+ * @param dst The destination pixels
+ * @param dst_pitch The distance between destination rows, in pixels
+ * @param level The kernels to use. Must be supported by the CPU
+ */
+void ScaleFrame(ScaleFilter filter, int factor, const uint32_t* src, int width, int height, uint32_t* dst, int dst_pitch, SIMDLevel level);
+
+/**
+ * @brief Scales an image with the kernels for ActiveSIMDLevel()
+ *
+ */
+void ScaleFrame(ScaleFilter filter, int factor, const uint32_t* src, int width, int height, uint32_t* dst, int dst_pitch);
+
+#endif
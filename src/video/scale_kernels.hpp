@@ -0,0 +1,90 @@
+/**
+ * @file scale_kernels.hpp
+ * @brief Row kernels shared by the scaling filters, one set per SIMD level
+ *
+ */
+
+#ifndef SCALE_KERNELS_H
+#define SCALE_KERNELS_H
+
+#include <cstdint>
+#include "../util/cpu_features.hpp"
+
+/**
+ * @brief Darkens a pixel to 75% brightness, keeping alpha
+ *
+ */
+inline uint32_t DimPixel(uint32_t pixel) {
+    return (pixel & 0xFF000000) + ((pixel >> 1) & 0x007F7F7F) + ((pixel >> 2) & 0x003F3F3F);
+}
+
+/**
+ * @brief Computes the 2x2 block of Scale2x for one pixel
+ *
+ * @param b The pixel above
+ * @param d The pixel to the left
+ * @param e The pixel itself
+ * @param f The pixel to the right
+ * @param h The pixel below
+ * @param top Receives the top two output pixels
+ * @param bottom Receives the bottom two output pixels
+ */
+inline void Scale2xPixel(uint32_t b, uint32_t d, uint32_t e, uint32_t f, uint32_t h, uint32_t* top, uint32_t* bottom) {
+    if (b != h && d != f) {
+        top[0] = d == b ? d : e;
+        top[1] = b == f ? f : e;
+        bottom[0] = d == h ? d : e;
+        bottom[1] = h == f ? f : e;
+    } else {
+        top[0] = top[1] = bottom[0] = bottom[1] = e;
+    }
+}
+
+/**
+ * @brief Computes the 3x3 block of Scale3x for one pixel from its 3x3 neighbourhood a-i
+ *
+ * @param rows Receives the three output rows of three pixels each
+ */
+inline void Scale3xPixel(uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t e, uint32_t f, uint32_t g, uint32_t h, uint32_t i, uint32_t* rows[3]) {
+    if (b != h && d != f) {
+        rows[0][0] = d == b ? d : e;
+        rows[0][1] = (d == b && e != c) || (b == f && e != a) ? b : e;
+        rows[0][2] = b == f ? f : e;
+        rows[1][0] = (d == b && e != g) || (d == h && e != a) ? d : e;
+        rows[1][1] = e;
+        rows[1][2] = (b == f && e != i) || (h == f && e != c) ? f : e;
+        rows[2][0] = d == h ? d : e;
+        rows[2][1] = (d == h && e != i) || (h == f && e != g) ? h : e;
+        rows[2][2] = h == f ? f : e;
+    } else {
+        for (int r = 0; r < 3; r++) {
+            rows[r][0] = rows[r][1] = rows[r][2] = e;
+        }
+    }
+}
+
+/**
+ * @brief The row kernels for one SIMD level.
+ *
+ * Rows above and below the image are clamped to the edge by the caller, so the kernels only deal
+ * with the left and right edges.
+ */
+struct ScaleKernels {
+    // Repeats each of width pixels factor times
+    void (*expand_row)(const uint32_t* src, int width, int factor, uint32_t* dst);
+    // Dims count pixels in place
+    void (*dim_row)(uint32_t* pixels, int count);
+    // Scale2x of the row cur, writing two rows of 2 * width pixels
+    void (*scale2x_row)(const uint32_t* above, const uint32_t* cur, const uint32_t* below, int width, uint32_t* top, uint32_t* bottom);
+    // Scale3x of the row cur, writing three rows of 3 * width pixels
+    void (*scale3x_row)(const uint32_t* above, const uint32_t* cur, const uint32_t* below, int width, uint32_t* rows[3]);
+};
+
+extern const ScaleKernels SCALAR_SCALE_KERNELS;
+
+#ifdef LAMEBOY_X86
+extern const ScaleKernels SSE2_SCALE_KERNELS;
+extern const ScaleKernels AVX2_SCALE_KERNELS;
+#endif
+
+#endif
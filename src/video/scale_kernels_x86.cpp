@@ -0,0 +1,352 @@
+/**
+ * @file scale_kernels_x86.cpp
+ * @brief SSE2 and AVX2 row kernels for the scaling filters
+ *
+ * Each function carries its own target attribute rather than the file being built with -mavx2, so
+ * no AVX2 code can leak into shared inline functions and the binary still runs on older CPUs.
+ */
+
+#include "./scale_kernels.hpp"
+
+#ifdef LAMEBOY_X86
+
+#include <immintrin.h>
+
+#define SSE2_TARGET __attribute__((target("sse2")))
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+// SSE2
+
+SSE2_TARGET static inline __m128i Select128(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+SSE2_TARGET static inline __m128i NotEqual128(__m128i a, __m128i b) {
+    return _mm_xor_si128(_mm_cmpeq_epi32(a, b), _mm_set1_epi32(-1));
+}
+
+/**
+ * @brief Stores three vectors of pixels interleaved, a0 b0 c0 a1 b1 c1 ...
+ *
+ */
+SSE2_TARGET static inline void StoreInterleaved3(__m128i a, __m128i b, __m128i c, uint32_t* dst) {
+    __m128 fa = _mm_castsi128_ps(a);
+    __m128 fb = _mm_castsi128_ps(b);
+    __m128 fc = _mm_castsi128_ps(c);
+
+    __m128 ab_lo = _mm_unpacklo_ps(fa, fb);
+    __m128 ab_hi = _mm_unpackhi_ps(fa, fb);
+
+    __m128 c0a1 = _mm_shuffle_ps(fc, fa, _MM_SHUFFLE(1, 1, 0, 0));
+    __m128 b1c1 = _mm_shuffle_ps(fb, fc, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 c2a3 = _mm_shuffle_ps(fc, ab_hi, _MM_SHUFFLE(2, 2, 2, 2));
+    __m128 b3c3 = _mm_shuffle_ps(ab_hi, fc, _MM_SHUFFLE(3, 3, 3, 3));
+
+    _mm_storeu_ps((float*)dst, _mm_shuffle_ps(ab_lo, c0a1, _MM_SHUFFLE(2, 0, 1, 0)));
+    _mm_storeu_ps((float*)dst + 4, _mm_shuffle_ps(b1c1, ab_hi, _MM_SHUFFLE(1, 0, 2, 0)));
+    _mm_storeu_ps((float*)dst + 8, _mm_shuffle_ps(c2a3, b3c3, _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+/**
+ * @brief Writes the factor vectors that repeat each of 4 pixels factor times, one shuffle each
+ *
+ */
+template <int F, int K>
+struct ExpandSSE2 {
+    SSE2_TARGET static inline void Store(__m128i v, uint32_t* dst) {
+        static const int IMM = ((4 * K) / F) | (((4 * K + 1) / F) << 2) | (((4 * K + 2) / F) << 4) | (((4 * K + 3) / F) << 6);
+        _mm_storeu_si128((__m128i*)(dst + 4 * K), _mm_shuffle_epi32(v, IMM));
+        ExpandSSE2<F, K + 1>::Store(v, dst);
+    }
+};
+
+template <int F>
+struct ExpandSSE2<F, F> {
+    SSE2_TARGET static inline void Store(__m128i v, uint32_t* dst) {}
+};
+
+template <int F>
+SSE2_TARGET static void ExpandRowSSE2Factor(const uint32_t* src, int width, uint32_t* dst) {
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        ExpandSSE2<F, 0>::Store(_mm_loadu_si128((const __m128i*)(src + x)), dst + x * F);
+    }
+    for (; x < width; x++) {
+        for (int i = 0; i < F; i++) {
+            dst[x * F + i] = src[x];
+        }
+    }
+}
+
+SSE2_TARGET static void ExpandRowSSE2(const uint32_t* src, int width, int factor, uint32_t* dst) {
+    switch (factor) {
+        case 1: ExpandRowSSE2Factor<1>(src, width, dst); break;
+        case 2: ExpandRowSSE2Factor<2>(src, width, dst); break;
+        case 3: ExpandRowSSE2Factor<3>(src, width, dst); break;
+        case 4: ExpandRowSSE2Factor<4>(src, width, dst); break;
+        case 5: ExpandRowSSE2Factor<5>(src, width, dst); break;
+        case 6: ExpandRowSSE2Factor<6>(src, width, dst); break;
+        default: SCALAR_SCALE_KERNELS.expand_row(src, width, factor, dst); break;
+    }
+}
+
+SSE2_TARGET static void DimRowSSE2(uint32_t* pixels, int count) {
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    const __m128i half = _mm_set1_epi32(0x007F7F7F);
+    const __m128i quarter = _mm_set1_epi32(0x003F3F3F);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(pixels + i));
+        __m128i dim = _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(v, 1), half), _mm_and_si128(_mm_srli_epi32(v, 2), quarter));
+        _mm_storeu_si128((__m128i*)(pixels + i), _mm_or_si128(_mm_and_si128(v, alpha), dim));
+    }
+    for (; i < count; i++) {
+        pixels[i] = DimPixel(pixels[i]);
+    }
+}
+
+SSE2_TARGET static void Scale2xRowSSE2(const uint32_t* above, const uint32_t* cur, const uint32_t* below, int width, uint32_t* top, uint32_t* bottom) {
+    // The first pixel and the tail need the clamped left and right neighbours
+    if (width > 0) {
+        Scale2xPixel(above[0], cur[0], cur[0], cur[width > 1 ? 1 : 0], below[0], top, bottom);
+    }
+
+    int x = 1;
+    for (; x + 5 <= width; x += 4) {
+        __m128i b = _mm_loadu_si128((const __m128i*)(above + x));
+        __m128i h = _mm_loadu_si128((const __m128i*)(below + x));
+        __m128i d = _mm_loadu_si128((const __m128i*)(cur + x - 1));
+        __m128i e = _mm_loadu_si128((const __m128i*)(cur + x));
+        __m128i f = _mm_loadu_si128((const __m128i*)(cur + x + 1));
+
+        __m128i active = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi32(b, h), _mm_cmpeq_epi32(d, f)), _mm_set1_epi32(-1));
+        __m128i e0 = Select128(_mm_and_si128(active, _mm_cmpeq_epi32(d, b)), d, e);
+        __m128i e1 = Select128(_mm_and_si128(active, _mm_cmpeq_epi32(b, f)), f, e);
+        __m128i e2 = Select128(_mm_and_si128(active, _mm_cmpeq_epi32(d, h)), d, e);
+        __m128i e3 = Select128(_mm_and_si128(active, _mm_cmpeq_epi32(h, f)), f, e);
+
+        _mm_storeu_si128((__m128i*)(top + x * 2), _mm_unpacklo_epi32(e0, e1));
+        _mm_storeu_si128((__m128i*)(top + x * 2 + 4), _mm_unpackhi_epi32(e0, e1));
+        _mm_storeu_si128((__m128i*)(bottom + x * 2), _mm_unpacklo_epi32(e2, e3));
+        _mm_storeu_si128((__m128i*)(bottom + x * 2 + 4), _mm_unpackhi_epi32(e2, e3));
+    }
+
+    for (; x < width; x++) {
+        uint32_t right = cur[x < width - 1 ? x + 1 : x];
+        Scale2xPixel(above[x], cur[x - 1], cur[x], right, below[x], top + x * 2, bottom + x * 2);
+    }
+}
+
+SSE2_TARGET static void Scale3xRowSSE2(const uint32_t* above, const uint32_t* cur, const uint32_t* below, int width, uint32_t* rows[3]) {
+    if (width > 0) {
+        int r = width > 1 ? 1 : 0;
+        Scale3xPixel(above[0], above[0], above[r], cur[0], cur[0], cur[r], below[0], below[0], below[r], rows);
+    }
+
+    int x = 1;
+    for (; x + 5 <= width; x += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(above + x - 1));
+        __m128i b = _mm_loadu_si128((const __m128i*)(above + x));
+        __m128i c = _mm_loadu_si128((const __m128i*)(above + x + 1));
+        __m128i d = _mm_loadu_si128((const __m128i*)(cur + x - 1));
+        __m128i e = _mm_loadu_si128((const __m128i*)(cur + x));
+        __m128i f = _mm_loadu_si128((const __m128i*)(cur + x + 1));
+        __m128i g = _mm_loadu_si128((const __m128i*)(below + x - 1));
+        __m128i h = _mm_loadu_si128((const __m128i*)(below + x));
+        __m128i i = _mm_loadu_si128((const __m128i*)(below + x + 1));
+
+        __m128i active = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi32(b, h), _mm_cmpeq_epi32(d, f)), _mm_set1_epi32(-1));
+        __m128i db = _mm_and_si128(active, _mm_cmpeq_epi32(d, b));
+        __m128i bf = _mm_and_si128(active, _mm_cmpeq_epi32(b, f));
+        __m128i dh = _mm_and_si128(active, _mm_cmpeq_epi32(d, h));
+        __m128i hf = _mm_and_si128(active, _mm_cmpeq_epi32(h, f));
+
+        __m128i e0 = Select128(db, d, e);
+        __m128i e1 = Select128(_mm_or_si128(_mm_and_si128(db, NotEqual128(e, c)), _mm_and_si128(bf, NotEqual128(e, a))), b, e);
+        __m128i e2 = Select128(bf, f, e);
+        __m128i e3 = Select128(_mm_or_si128(_mm_and_si128(db, NotEqual128(e, g)), _mm_and_si128(dh, NotEqual128(e, a))), d, e);
+        __m128i e5 = Select128(_mm_or_si128(_mm_and_si128(bf, NotEqual128(e, i)), _mm_and_si128(hf, NotEqual128(e, c))), f, e);
+        __m128i e6 = Select128(dh, d, e);
+        __m128i e7 = Select128(_mm_or_si128(_mm_and_si128(dh, NotEqual128(e, i)), _mm_and_si128(hf, NotEqual128(e, g))), h, e);
+        __m128i e8 = Select128(hf, f, e);
+
+        StoreInterleaved3(e0, e1, e2, rows[0] + x * 3);
+        StoreInterleaved3(e3, e, e5, rows[1] + x * 3);
+        StoreInterleaved3(e6, e7, e8, rows[2] + x * 3);
+    }
+
+    for (; x < width; x++) {
+        int r = x < width - 1 ? x + 1 : x;
+        uint32_t* block[3] = { rows[0] + x * 3, rows[1] + x * 3, rows[2] + x * 3 };
+        Scale3xPixel(above[x - 1], above[x], above[r], cur[x - 1], cur[x], cur[r], below[x - 1], below[x], below[r], block);
+    }
+}
+
+const ScaleKernels SSE2_SCALE_KERNELS = {
+    ExpandRowSSE2,
+    DimRowSSE2,
+    Scale2xRowSSE2,
+    Scale3xRowSSE2
+};
+
+// AVX2
+
+AVX2_TARGET static inline __m256i Select256(__m256i mask, __m256i a, __m256i b) {
+    return _mm256_blendv_epi8(b, a, mask);
+}
+
+AVX2_TARGET static inline __m256i NotEqual256(__m256i a, __m256i b) {
+    return _mm256_xor_si256(_mm256_cmpeq_epi32(a, b), _mm256_set1_epi32(-1));
+}
+
+template <int F>
+AVX2_TARGET static void ExpandRowAVX2Factor(const uint32_t* src, int width, uint32_t* dst) {
+    // Output vector k of each group of 8 pixels takes pixel (8k + j) / F in lane j
+    __m256i indices[F];
+    for (int k = 0; k < F; k++) {
+        indices[k] = _mm256_setr_epi32((8 * k) / F, (8 * k + 1) / F, (8 * k + 2) / F, (8 * k + 3) / F,
+                                       (8 * k + 4) / F, (8 * k + 5) / F, (8 * k + 6) / F, (8 * k + 7) / F);
+    }
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(src + x));
+        for (int k = 0; k < F; k++) {
+            _mm256_storeu_si256((__m256i*)(dst + x * F + 8 * k), _mm256_permutevar8x32_epi32(v, indices[k]));
+        }
+    }
+    for (; x < width; x++) {
+        for (int i = 0; i < F; i++) {
+            dst[x * F + i] = src[x];
+        }
+    }
+}
+
+AVX2_TARGET static void ExpandRowAVX2(const uint32_t* src, int width, int factor, uint32_t* dst) {
+    switch (factor) {
+        case 1: ExpandRowAVX2Factor<1>(src, width, dst); break;
+        case 2: ExpandRowAVX2Factor<2>(src, width, dst); break;
+        case 3: ExpandRowAVX2Factor<3>(src, width, dst); break;
+        case 4: ExpandRowAVX2Factor<4>(src, width, dst); break;
+        case 5: ExpandRowAVX2Factor<5>(src, width, dst); break;
+        case 6: ExpandRowAVX2Factor<6>(src, width, dst); break;
+        default: SCALAR_SCALE_KERNELS.expand_row(src, width, factor, dst); break;
+    }
+}
+
+AVX2_TARGET static void DimRowAVX2(uint32_t* pixels, int count) {
+    const __m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+    const __m256i half = _mm256_set1_epi32(0x007F7F7F);
+    const __m256i quarter = _mm256_set1_epi32(0x003F3F3F);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(pixels + i));
+        __m256i dim = _mm256_add_epi32(_mm256_and_si256(_mm256_srli_epi32(v, 1), half), _mm256_and_si256(_mm256_srli_epi32(v, 2), quarter));
+        _mm256_storeu_si256((__m256i*)(pixels + i), _mm256_or_si256(_mm256_and_si256(v, alpha), dim));
+    }
+    for (; i < count; i++) {
+        pixels[i] = DimPixel(pixels[i]);
+    }
+}
+
+/**
+ * @brief Stores two vectors of pixels interleaved, a0 b0 a1 b1 ...
+ *
+ */
+AVX2_TARGET static inline void StoreInterleaved2(__m256i a, __m256i b, uint32_t* dst) {
+    // The unpacks work within 128 bit lanes, so swap the middle halves back into order
+    __m256i lo = _mm256_unpacklo_epi32(a, b);
+    __m256i hi = _mm256_unpackhi_epi32(a, b);
+    _mm256_storeu_si256((__m256i*)dst, _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256((__m256i*)(dst + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+AVX2_TARGET static inline void StoreInterleaved3AVX2(__m256i a, __m256i b, __m256i c, uint32_t* dst) {
+    StoreInterleaved3(_mm256_castsi256_si128(a), _mm256_castsi256_si128(b), _mm256_castsi256_si128(c), dst);
+    StoreInterleaved3(_mm256_extracti128_si256(a, 1), _mm256_extracti128_si256(b, 1), _mm256_extracti128_si256(c, 1), dst + 12);
+}
+
+AVX2_TARGET static void Scale2xRowAVX2(const uint32_t* above, const uint32_t* cur, const uint32_t* below, int width, uint32_t* top, uint32_t* bottom) {
+    if (width > 0) {
+        Scale2xPixel(above[0], cur[0], cur[0], cur[width > 1 ? 1 : 0], below[0], top, bottom);
+    }
+
+    int x = 1;
+    for (; x + 9 <= width; x += 8) {
+        __m256i b = _mm256_loadu_si256((const __m256i*)(above + x));
+        __m256i h = _mm256_loadu_si256((const __m256i*)(below + x));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(cur + x - 1));
+        __m256i e = _mm256_loadu_si256((const __m256i*)(cur + x));
+        __m256i f = _mm256_loadu_si256((const __m256i*)(cur + x + 1));
+
+        __m256i active = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi32(b, h), _mm256_cmpeq_epi32(d, f)), _mm256_set1_epi32(-1));
+        __m256i e0 = Select256(_mm256_and_si256(active, _mm256_cmpeq_epi32(d, b)), d, e);
+        __m256i e1 = Select256(_mm256_and_si256(active, _mm256_cmpeq_epi32(b, f)), f, e);
+        __m256i e2 = Select256(_mm256_and_si256(active, _mm256_cmpeq_epi32(d, h)), d, e);
+        __m256i e3 = Select256(_mm256_and_si256(active, _mm256_cmpeq_epi32(h, f)), f, e);
+
+        StoreInterleaved2(e0, e1, top + x * 2);
+        StoreInterleaved2(e2, e3, bottom + x * 2);
+    }
+
+    for (; x < width; x++) {
+        uint32_t right = cur[x < width - 1 ? x + 1 : x];
+        Scale2xPixel(above[x], cur[x - 1], cur[x], right, below[x], top + x * 2, bottom + x * 2);
+    }
+}
+
+AVX2_TARGET static void Scale3xRowAVX2(const uint32_t* above, const uint32_t* cur, const uint32_t* below, int width, uint32_t* rows[3]) {
+    if (width > 0) {
+        int r = width > 1 ? 1 : 0;
+        Scale3xPixel(above[0], above[0], above[r], cur[0], cur[0], cur[r], below[0], below[0], below[r], rows);
+    }
+
+    int x = 1;
+    for (; x + 9 <= width; x += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(above + x - 1));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(above + x));
+        __m256i c = _mm256_loadu_si256((const __m256i*)(above + x + 1));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(cur + x - 1));
+        __m256i e = _mm256_loadu_si256((const __m256i*)(cur + x));
+        __m256i f = _mm256_loadu_si256((const __m256i*)(cur + x + 1));
+        __m256i g = _mm256_loadu_si256((const __m256i*)(below + x - 1));
+        __m256i h = _mm256_loadu_si256((const __m256i*)(below + x));
+        __m256i i = _mm256_loadu_si256((const __m256i*)(below + x + 1));
+
+        __m256i active = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi32(b, h), _mm256_cmpeq_epi32(d, f)), _mm256_set1_epi32(-1));
+        __m256i db = _mm256_and_si256(active, _mm256_cmpeq_epi32(d, b));
+        __m256i bf = _mm256_and_si256(active, _mm256_cmpeq_epi32(b, f));
+        __m256i dh = _mm256_and_si256(active, _mm256_cmpeq_epi32(d, h));
+        __m256i hf = _mm256_and_si256(active, _mm256_cmpeq_epi32(h, f));
+
+        __m256i e0 = Select256(db, d, e);
+        __m256i e1 = Select256(_mm256_or_si256(_mm256_and_si256(db, NotEqual256(e, c)), _mm256_and_si256(bf, NotEqual256(e, a))), b, e);
+        __m256i e2 = Select256(bf, f, e);
+        __m256i e3 = Select256(_mm256_or_si256(_mm256_and_si256(db, NotEqual256(e, g)), _mm256_and_si256(dh, NotEqual256(e, a))), d, e);
+        __m256i e5 = Select256(_mm256_or_si256(_mm256_and_si256(bf, NotEqual256(e, i)), _mm256_and_si256(hf, NotEqual256(e, c))), f, e);
+        __m256i e6 = Select256(dh, d, e);
+        __m256i e7 = Select256(_mm256_or_si256(_mm256_and_si256(dh, NotEqual256(e, i)), _mm256_and_si256(hf, NotEqual256(e, g))), h, e);
+        __m256i e8 = Select256(hf, f, e);
+
+        StoreInterleaved3AVX2(e0, e1, e2, rows[0] + x * 3);
+        StoreInterleaved3AVX2(e3, e, e5, rows[1] + x * 3);
+        StoreInterleaved3AVX2(e6, e7, e8, rows[2] + x * 3);
+    }
+
+    for (; x < width; x++) {
+        int r = x < width - 1 ? x + 1 : x;
+        uint32_t* block[3] = { rows[0] + x * 3, rows[1] + x * 3, rows[2] + x * 3 };
+        Scale3xPixel(above[x - 1], above[x], above[r], cur[x - 1], cur[x], cur[r], below[x - 1], below[x], below[r], block);
+    }
+}
+
+const ScaleKernels AVX2_SCALE_KERNELS = {
+    ExpandRowAVX2,
+    DimRowAVX2,
+    Scale2xRowAVX2,
+    Scale3xRowAVX2
+};
+
+#endif
@@ -0,0 +1,237 @@
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/apu/apu.hpp"
+#include "../src/apu/blip_buffer.hpp"
+#include "../src/core/scheduler.hpp"
+#include "../src/cpu/sm83_state.hpp"
+#include "../src/ppu/ppu_registers.hpp"
+
+namespace {
+
+static const uint32_t CLOCK_RATE = 4194304;
+
+/**
+ * @brief Wires an APU to a CPU state and scheduler sharing one memory bus
+ *
+ */
+class APUTest : public ::testing::Test {
+protected:
+
+    uint8_t* memory_;
+    SM83State* state_;
+    Scheduler* scheduler_;
+    APU* apu_;
+
+    void SetUp() override {
+        this->memory_ = new uint8_t[65536]();
+        this->state_ = new SM83State(this->memory_);
+        this->scheduler_ = new Scheduler();
+        this->apu_ = new APU(this->memory_, this->scheduler_, DEFAULT_SAMPLE_RATE);
+        this->state_->AddMemoryObserver(this->apu_, 0xFF, 0xFF);
+
+        this->state_->SetMemoryAt(NR50_ADDRESS, 0x77);
+        this->state_->SetMemoryAt(NR51_ADDRESS, 0xFF);
+    }
+
+    void TearDown() override {
+        delete this->apu_;
+        delete this->scheduler_;
+        delete this->state_;
+        delete[] this->memory_;
+    }
+
+    // Runs whole frames, returning the left channel of the samples they produced
+    std::vector<float> RunFrames(int frames) {
+        std::vector<float> left;
+
+        for (int i = 0; i < frames; i++) {
+            this->scheduler_->Advance(DOTS_PER_FRAME);
+            this->apu_->EndFrame();
+
+            std::vector<float> samples(this->apu_->samplesAvailable() * 2);
+            size_t count = this->apu_->ReadSamples(samples.data(), samples.size() / 2);
+            for (size_t s = 0; s < count; s++) {
+                left.push_back(samples[s * 2]);
+            }
+        }
+        return left;
+    }
+
+    // Plays a 50% duty square on channel 2 at full volume
+    void PlaySquare(uint16_t frequency) {
+        this->state_->SetMemoryAt(0xFF16, 0x80);
+        this->state_->SetMemoryAt(0xFF17, 0xF0);
+        this->state_->SetMemoryAt(0xFF18, frequency & 0xFF);
+        this->state_->SetMemoryAt(0xFF19, NRX4_TRIGGER | (frequency >> 8));
+    }
+};
+
+/**
+ * @brief Counts the times a signal rises through zero
+ *
+ */
+int RisingCrossings(const std::vector<float>& samples, size_t start) {
+    int crossings = 0;
+    for (size_t i = start + 1; i < samples.size(); i++) {
+        if (samples[i - 1] < 0 && samples[i] >= 0) {
+            crossings++;
+        }
+    }
+    return crossings;
+}
+
+TEST(BlipBufferTest, TestStepSettlesAtItsHeight) {
+    BlipBuffer buffer(CLOCK_RATE, DEFAULT_SAMPLE_RATE, DOTS_PER_FRAME);
+    buffer.AddDelta(DOTS_PER_FRAME / 2, 0.5f);
+    buffer.EndFrame(DOTS_PER_FRAME);
+
+    std::vector<float> samples(buffer.samplesAvailable());
+    ASSERT_EQ(buffer.ReadSamples(samples.data(), samples.size()), samples.size());
+
+    // The step lands half way through the frame, delayed by half the impulse
+    size_t step = samples.size() / 2 + BLIP_TAPS / 2;
+    ASSERT_NEAR(samples[step - BLIP_TAPS], 0.0f, 0.001f);
+    ASSERT_NEAR(samples[step + 4], 0.5f, 0.02f);
+
+    // No overshoot far from the edge, and the output capacitor slowly discharges
+    ASSERT_LT(samples.back(), samples[step + 4]);
+    ASSERT_GT(samples.back(), 0.0f);
+}
+
+TEST(BlipBufferTest, TestSampleCountTracksClockRate) {
+    BlipBuffer buffer(CLOCK_RATE, DEFAULT_SAMPLE_RATE, DOTS_PER_FRAME);
+    size_t total = 0;
+
+    for (int frame = 0; frame < 60; frame++) {
+        buffer.EndFrame(DOTS_PER_FRAME);
+        total += buffer.ReadSamples(nullptr, buffer.samplesAvailable());
+    }
+
+    // Fractions of a sample carry over between frames, so nothing drifts
+    size_t expected = (size_t)((uint64_t)60 * DOTS_PER_FRAME * DEFAULT_SAMPLE_RATE / CLOCK_RATE);
+    ASSERT_EQ(total, expected);
+}
+
+TEST_F(APUTest, TestSilentWithoutChannels) {
+    std::vector<float> samples = this->RunFrames(4);
+
+    ASSERT_GT(samples.size(), 3000u);
+    for (float sample : samples) {
+        ASSERT_EQ(sample, 0.0f);
+    }
+}
+
+TEST_F(APUTest, TestSquareFrequency) {
+    // 131072 / (2048 - 1798) = 524.288Hz
+    this->PlaySquare(1798);
+    std::vector<float> samples = this->RunFrames(60);
+    ASSERT_EQ(this->memory_[NR52_ADDRESS] & 0x02, 0x02);
+
+    // Skip the first frames while the output capacitor charges
+    size_t start = samples.size() / 6;
+    double seconds = (double)(samples.size() - start) / DEFAULT_SAMPLE_RATE;
+    double frequency = RisingCrossings(samples, start) / seconds;
+
+    ASSERT_NEAR(frequency, 524.288, 524.288 * 0.02);
+}
+
+TEST_F(APUTest, TestWritesTakeEffectAtTheirTime) {
+    // Silent for the first half of the frame, then the square starts
+    this->scheduler_->Advance(DOTS_PER_FRAME / 2);
+    this->PlaySquare(1798);
+
+    this->scheduler_->Advance(DOTS_PER_FRAME / 2);
+    this->apu_->EndFrame();
+
+    std::vector<float> samples(this->apu_->samplesAvailable() * 2);
+    size_t count = this->apu_->ReadSamples(samples.data(), samples.size() / 2);
+    size_t half = count / 2;
+
+    for (size_t i = 0; i < half - BLIP_TAPS; i++) {
+        ASSERT_EQ(samples[i * 2], 0.0f);
+    }
+    float peak = 0;
+    for (size_t i = half; i < count; i++) {
+        peak = std::max(peak, std::fabs(samples[i * 2]));
+    }
+    ASSERT_GT(peak, 0.1f);
+}
+
+TEST_F(APUTest, TestLengthCounterDisablesChannel) {
+    this->state_->SetMemoryAt(0xFF16, 0x80 | 0x3F);
+    this->state_->SetMemoryAt(0xFF17, 0xF0);
+    this->state_->SetMemoryAt(0xFF19, NRX4_TRIGGER | NRX4_LENGTH_ENABLE | 0x07);
+    ASSERT_EQ(this->memory_[NR52_ADDRESS] & 0x02, 0x02);
+
+    // A length of 1 expires on the first length clock, within 8192 * 2 clocks
+    this->RunFrames(1);
+    ASSERT_EQ(this->memory_[NR52_ADDRESS] & 0x02, 0x00);
+}
+
+TEST_F(APUTest, TestDACOffDisablesChannel) {
+    this->PlaySquare(1798);
+    this->state_->SetMemoryAt(0xFF17, 0x00);
+
+    ASSERT_EQ(this->memory_[NR52_ADDRESS] & 0x02, 0x00);
+}
+
+TEST_F(APUTest, TestSweepOverflowDisablesChannel) {
+    // Sweep up by f >> 1 each sweep clock. 1200 becomes 1800, whose next step overflows
+    this->state_->SetMemoryAt(0xFF10, 0x11);
+    this->state_->SetMemoryAt(0xFF12, 0xF0);
+    this->state_->SetMemoryAt(0xFF13, 1200 & 0xFF);
+    this->state_->SetMemoryAt(0xFF14, NRX4_TRIGGER | (1200 >> 8));
+    ASSERT_EQ(this->memory_[NR52_ADDRESS] & 0x01, 0x01);
+
+    this->RunFrames(2);
+    ASSERT_EQ(this->memory_[NR52_ADDRESS] & 0x01, 0x00);
+}
+
+TEST_F(APUTest, TestNoiseAndWaveProduceSound) {
+    for (uint16_t address = WAVE_RAM_ADDRESS; address <= APU_LAST_ADDRESS; address++) {
+        this->state_->SetMemoryAt(address, 0x0F);
+    }
+    this->state_->SetMemoryAt(0xFF1A, 0x80);
+    this->state_->SetMemoryAt(0xFF1C, 0x20);
+    this->state_->SetMemoryAt(0xFF1E, NRX4_TRIGGER | 0x07);
+
+    this->state_->SetMemoryAt(0xFF21, 0xF0);
+    this->state_->SetMemoryAt(0xFF22, 0x25);
+    this->state_->SetMemoryAt(0xFF23, NRX4_TRIGGER);
+
+    ASSERT_EQ(this->memory_[NR52_ADDRESS] & 0x0C, 0x0C);
+
+    std::vector<float> samples = this->RunFrames(10);
+    float peak = 0;
+    for (float sample : samples) {
+        peak = std::max(peak, std::fabs(sample));
+    }
+    ASSERT_GT(peak, 0.1f);
+    ASSERT_LE(peak, 1.0f);
+}
+
+TEST_F(APUTest, TestPowerOffClearsRegisters) {
+    this->PlaySquare(1798);
+    this->state_->SetMemoryAt(NR52_ADDRESS, 0x00);
+
+    ASSERT_EQ(this->memory_[NR52_ADDRESS] & 0x8F, 0x00);
+    ASSERT_EQ(this->memory_[0xFF17], 0x00);
+    ASSERT_EQ(this->memory_[NR51_ADDRESS], 0x00);
+
+    // Writes are ignored until the APU is powered again
+    this->state_->SetMemoryAt(0xFF17, 0xF0);
+    ASSERT_EQ(this->memory_[0xFF17], 0x00);
+
+    this->state_->SetMemoryAt(NR52_ADDRESS, NR52_POWER);
+    this->state_->SetMemoryAt(0xFF17, 0xF0);
+    ASSERT_EQ(this->memory_[0xFF17], 0xF0);
+    ASSERT_EQ(this->memory_[NR52_ADDRESS] & NR52_POWER, NR52_POWER);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
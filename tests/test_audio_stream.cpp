@@ -0,0 +1,156 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/audio/audio_stream.hpp"
+
+namespace {
+
+// One DMG frame of audio at 48kHz, rounded down
+static const size_t FRAME_SAMPLES = 803;
+
+TEST(AudioStreamTest, TestNominalRateAtTargetFill) {
+    AudioStream stream(48000, 48000, FRAME_SAMPLES * 4);
+    std::vector<float> batch(FRAME_SAMPLES * 2, 0.5f);
+
+    for (int i = 0; i < 4; i++) {
+        stream.Write(batch.data(), FRAME_SAMPLES);
+    }
+
+    // Three quarters of the way to the target before the last batch
+    ASSERT_NEAR(stream.rateAdjustment(), MAX_RATE_DEVIATION / 4, 1e-4);
+
+    // Sitting on the target the ratio is untouched
+    size_t queued = stream.Write(batch.data(), FRAME_SAMPLES);
+    ASSERT_NEAR(stream.rateAdjustment(), 0.0, 1e-3);
+    ASSERT_NEAR((double)queued, (double)FRAME_SAMPLES, 1.0);
+}
+
+TEST(AudioStreamTest, TestAdjustmentFollowsFill) {
+    AudioStream stream(48000, 44100, 3000);
+    std::vector<float> batch(FRAME_SAMPLES * 2, 0.0f);
+    double nominal = (FRAME_SAMPLES - RESAMPLER_TAPS / 2) * 44100.0 / 48000.0;
+
+    // Empty, so the batch is stretched by the full deviation. The resampler holds back a few samples
+    size_t stretched = stream.Write(batch.data(), FRAME_SAMPLES);
+    ASSERT_DOUBLE_EQ(stream.rateAdjustment(), MAX_RATE_DEVIATION);
+    ASSERT_NEAR((double)stretched, nominal * (1 + MAX_RATE_DEVIATION), 1.0);
+
+    // Twice the target or more, so the batch is shrunk by the full deviation
+    while (stream.fill() < 6000) {
+        stream.Write(batch.data(), FRAME_SAMPLES);
+    }
+    stream.Write(batch.data(), FRAME_SAMPLES);
+    ASSERT_DOUBLE_EQ(stream.rateAdjustment(), -MAX_RATE_DEVIATION);
+}
+
+TEST(AudioStreamTest, TestUnderrunFillsSilence) {
+    AudioStream stream(48000, 48000, 1024);
+    std::vector<float> batch(64 * 2, 0.25f);
+    stream.Write(batch.data(), 64);
+
+    std::vector<float> out(256 * 2, 1.0f);
+    size_t read = stream.Read(out.data(), 256);
+
+    ASSERT_LT(read, 256u);
+    ASSERT_EQ(stream.underruns(), 1u);
+    for (size_t i = read * 2; i < out.size(); i++) {
+        ASSERT_EQ(out[i], 0.0f);
+    }
+}
+
+TEST(AudioStreamTest, TestOverflowDropsSamples) {
+    AudioStream stream(48000, 48000, 256);
+    std::vector<float> batch(FRAME_SAMPLES * 2, 0.25f);
+
+    for (int i = 0; i < 4; i++) {
+        stream.Write(batch.data(), FRAME_SAMPLES);
+    }
+
+    ASSERT_EQ(stream.fill(), stream.capacity());
+    ASSERT_GT(stream.droppedSamples(), 0u);
+}
+
+TEST(AudioStreamTest, TestFillSettlesWhenClocksDisagree) {
+    // The device consumes 0.3% faster than the emulator produces, as with a slightly fast sound card
+    const size_t latency = 2048;
+    AudioStream stream(48000, 48000, latency);
+    std::vector<float> batch(FRAME_SAMPLES * 2, 0.1f);
+    std::vector<float> out(4096 * 2);
+    double owed = 0;
+
+    for (int frame = 0; frame < 6000; frame++) {
+        stream.Write(batch.data(), FRAME_SAMPLES);
+
+        owed += FRAME_SAMPLES * 1.003;
+        size_t wanted = (size_t)owed;
+        owed -= wanted;
+
+        // Skip the first frames while the ring fills for the first time
+        size_t read = stream.Read(out.data(), wanted);
+        if (frame > 10) {
+            ASSERT_EQ(read, wanted) << "underrun on frame " << frame;
+        }
+    }
+
+    ASSERT_EQ(stream.droppedSamples(), 0u);
+    ASSERT_GT(stream.rateAdjustment(), 0.0);
+    ASSERT_LE(stream.rateAdjustment(), MAX_RATE_DEVIATION);
+}
+
+TEST(AudioStreamTest, TestSamplesArriveInOrderAcrossThreads) {
+    AudioStream stream(48000, 48000, 4096);
+    const size_t total = 200000;
+    std::atomic<bool> done(false);
+
+    // A ramp comes out as a ramp, so a lost, repeated or reordered batch shows up as a jump
+    std::thread producer([&stream, &done, total]() {
+        std::vector<float> batch(FRAME_SAMPLES * 2);
+        size_t written = 0;
+
+        while (written < total) {
+            for (size_t i = 0; i < FRAME_SAMPLES; i++) {
+                batch[i * 2] = (float)(written + i);
+                batch[i * 2 + 1] = -(float)(written + i);
+            }
+            written += FRAME_SAMPLES;
+
+            while (stream.fill() > 6000) {
+                std::this_thread::yield();
+            }
+            stream.Write(batch.data(), FRAME_SAMPLES);
+        }
+        done.store(true);
+    });
+
+    std::vector<float> out(256 * 2);
+    float last = -1;
+
+    // Skip the filter's response to the start of the ramp
+    while (stream.fill() < RESAMPLER_TAPS) {
+        std::this_thread::yield();
+    }
+    stream.Read(out.data(), RESAMPLER_TAPS);
+    last = out[(RESAMPLER_TAPS - 1) * 2];
+    size_t received = 0;
+
+    while (!done.load() || stream.fill() > 0) {
+        size_t read = stream.Read(out.data(), 256);
+        for (size_t i = 0; i < read; i++) {
+            ASSERT_NEAR(out[i * 2], last + 1.0f, 0.5f);
+            ASSERT_EQ(out[i * 2], -out[i * 2 + 1]);
+            last = out[i * 2];
+        }
+        received += read;
+    }
+    producer.join();
+
+    ASSERT_GT(received, total * 99 / 100);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,244 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/capi/lameboy.h"
+
+// Counts every allocation in the process, including those made inside the library
+static std::atomic<size_t> allocations(0);
+
+// Allocations that may still succeed before every later one throws, SIZE_MAX for no limit
+static std::atomic<size_t> allocations_allowed(SIZE_MAX);
+
+void* operator new(size_t size) {
+    allocations++;
+    if (allocations_allowed.load() != SIZE_MAX && allocations_allowed-- == 0) {
+        allocations_allowed = 0;
+        throw std::bad_alloc();
+    }
+    void* memory = malloc(size > 0 ? size : 1);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+// Kept out of line so the compiler pairs every delete with the operator new above rather than seeing free()
+__attribute__((noinline)) void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t /* size */) noexcept {
+    ::operator delete(memory);
+}
+
+namespace {
+
+/**
+ * @brief Builds a ROM that copies P1 to 0xC000 and counts at 0xC010 in a loop
+ *
+ */
+std::vector<uint8_t> JoypadROM() {
+    std::vector<uint8_t> rom(0x8000, 0);
+    const uint8_t program[] = {
+        0x01, 0x00, 0xFF,   // LD BC, 0xFF00
+        0x11, 0x00, 0xC0,   // LD DE, 0xC000
+        0x21, 0x10, 0xC0,   // LD HL, 0xC010
+        0x0A,               // LD A, (BC)
+        0x12,               // LD (DE), A
+        0x34,               // INC (HL)
+        0x18, 0xFB          // JR back to LD A, (BC)
+    };
+    memcpy(rom.data() + 0x100, program, sizeof(program));
+    return rom;
+}
+
+lb_instance* CreateLoaded() {
+    lb_instance* instance = lb_create(0);
+    std::vector<uint8_t> rom = JoypadROM();
+    EXPECT_EQ(lb_load_rom(instance, rom.data(), rom.size()), LB_OK);
+    return instance;
+}
+
+TEST(CAPITest, TestButtonsReachP1) {
+    lb_instance* instance = CreateLoaded();
+    const uint8_t* wram = lb_wram(instance);
+
+    ASSERT_EQ(lb_step(instance, 1, 0), LB_OK);
+    ASSERT_EQ(wram[0], 0xCF);
+
+    // Both button groups are selected, so A and Right share bit 0
+    ASSERT_EQ(lb_step(instance, 1, LB_BUTTON_A), LB_OK);
+    ASSERT_EQ(wram[0], 0xCE);
+
+    ASSERT_EQ(lb_step(instance, 1, LB_BUTTON_A | LB_BUTTON_DOWN), LB_OK);
+    ASSERT_EQ(wram[0], 0xC6);
+
+    ASSERT_EQ(lb_step(instance, 1, 0), LB_OK);
+    ASSERT_EQ(wram[0], 0xCF);
+
+    lb_destroy(instance);
+}
+
+TEST(CAPITest, TestBorrowedPointersAreStable) {
+    lb_instance* instance = lb_create(0);
+    const uint32_t* framebuffer = lb_framebuffer(instance);
+    const uint8_t* wram = lb_wram(instance);
+    const uint8_t* hram = lb_hram(instance);
+
+    std::vector<uint8_t> rom = JoypadROM();
+    ASSERT_EQ(lb_load_rom(instance, rom.data(), rom.size()), LB_OK);
+    ASSERT_EQ(lb_step(instance, 2, 0), LB_OK);
+
+    ASSERT_EQ(lb_framebuffer(instance), framebuffer);
+    ASSERT_EQ(lb_wram(instance), wram);
+    ASSERT_EQ(lb_hram(instance), hram);
+    ASSERT_EQ(hram - wram, 0xFF80 - 0xC000);
+    ASSERT_GT(lb_cycles(instance), 0u);
+
+    lb_destroy(instance);
+}
+
+TEST(CAPITest, TestResetToReplaysExactly) {
+    lb_instance* instance = CreateLoaded();
+    lb_instance* other = CreateLoaded();
+    const uint8_t buttons[] = { 0, LB_BUTTON_A, LB_BUTTON_START, LB_BUTTON_UP | LB_BUTTON_B, 0 };
+
+    ASSERT_EQ(lb_step(instance, 7, LB_BUTTON_LEFT), LB_OK);
+    lb_snapshot* snapshot = lb_snapshot_create(instance);
+    ASSERT_NE(snapshot, nullptr);
+    uint64_t snapshot_cycles = lb_cycles(instance);
+
+    for (uint8_t held : buttons) {
+        ASSERT_EQ(lb_step(instance, 3, held), LB_OK);
+    }
+    std::vector<uint8_t> wram(lb_wram(instance), lb_wram(instance) + LB_WRAM_SIZE);
+    std::vector<uint32_t> frame(lb_framebuffer(instance), lb_framebuffer(instance) + LB_SCREEN_WIDTH * LB_SCREEN_HEIGHT);
+    uint64_t cycles = lb_cycles(instance);
+
+    // The same instance and a different one both replay from the snapshot
+    lb_instance* replays[] = { instance, other };
+    for (lb_instance* replay : replays) {
+        ASSERT_EQ(lb_reset_to(replay, snapshot), LB_OK);
+        ASSERT_EQ(lb_cycles(replay), snapshot_cycles);
+
+        for (uint8_t held : buttons) {
+            ASSERT_EQ(lb_step(replay, 3, held), LB_OK);
+        }
+        ASSERT_EQ(lb_cycles(replay), cycles);
+        ASSERT_EQ(memcmp(lb_wram(replay), wram.data(), LB_WRAM_SIZE), 0);
+        ASSERT_EQ(memcmp(lb_framebuffer(replay), frame.data(), frame.size() * sizeof(uint32_t)), 0);
+    }
+
+    lb_snapshot_destroy(snapshot);
+    lb_destroy(other);
+    lb_destroy(instance);
+}
+
+TEST(CAPITest, TestStepAndResetDoNotAllocate) {
+    lb_instance* instances[4];
+    for (lb_instance*& instance : instances) {
+        instance = CreateLoaded();
+    }
+    // Creating a snapshot does allocate, which shows the counter sees inside the library
+    size_t created = allocations.load();
+    lb_snapshot* snapshot = lb_snapshot_create(instances[0]);
+    ASSERT_GT(allocations.load(), created);
+    const uint8_t buttons[4] = { 0, LB_BUTTON_A, LB_BUTTON_B, LB_BUTTON_START };
+
+    size_t before = allocations.load();
+    for (int episode = 0; episode < 10; episode++) {
+        for (lb_instance* instance : instances) {
+            ASSERT_EQ(lb_reset_to(instance, snapshot), LB_OK);
+        }
+        ASSERT_EQ(lb_step_many(instances, 4, 5, buttons), LB_OK);
+        ASSERT_EQ(lb_step(instances[0], 1, LB_BUTTON_SELECT), LB_OK);
+        ASSERT_EQ(lb_snapshot_save(instances[1], snapshot), LB_OK);
+    }
+    ASSERT_EQ(allocations.load(), before);
+
+    lb_snapshot_destroy(snapshot);
+    for (lb_instance* instance : instances) {
+        lb_destroy(instance);
+    }
+}
+
+TEST(CAPITest, TestErrorsAreReported) {
+    lb_instance* instance = lb_create(0);
+    ASSERT_EQ(lb_load_rom(instance, nullptr, 0), LB_ERROR);
+    ASSERT_STRNE(lb_last_error(instance), "");
+    ASSERT_EQ(lb_load_rom_file(instance, "no/such/rom.gb"), LB_ERROR);
+
+    std::vector<uint8_t> rom(0x8000, 0xD3);
+    ASSERT_EQ(lb_load_rom(instance, rom.data(), rom.size()), LB_OK);
+    ASSERT_STREQ(lb_last_error(instance), "");
+    ASSERT_EQ(lb_step(instance, 1, 0), LB_ERROR);
+    ASSERT_NE(strstr(lb_last_error(instance), "0xD3"), nullptr);
+
+    lb_instance* accurate = lb_create(LB_ACCURATE_PPU);
+    lb_snapshot* snapshot = lb_snapshot_create(accurate);
+    ASSERT_EQ(lb_reset_to(instance, snapshot), LB_ERROR);
+
+    lb_snapshot_destroy(snapshot);
+    lb_destroy(accurate);
+    lb_destroy(instance);
+}
+
+TEST(CAPITest, TestOutOfMemoryStaysInsideTheLibrary) {
+    lb_instance* instance = CreateLoaded();
+
+    // Fails every allocation in turn, from the outer object down to the machine's components
+    bool created = false;
+    for (size_t allowed = 0; !created; allowed++) {
+        allocations_allowed = allowed;
+        lb_instance* failing = lb_create(0);
+        allocations_allowed = SIZE_MAX;
+
+        created = failing != nullptr;
+        lb_destroy(failing);
+    }
+
+    bool snapshotted = false;
+    for (size_t allowed = 0; !snapshotted; allowed++) {
+        allocations_allowed = allowed;
+        lb_snapshot* snapshot = lb_snapshot_create(instance);
+        allocations_allowed = SIZE_MAX;
+
+        snapshotted = snapshot != nullptr;
+        if (!snapshotted) {
+            ASSERT_STRNE(lb_last_error(instance), "");
+        }
+        lb_snapshot_destroy(snapshot);
+    }
+
+    // A larger image than the loaded one so the ROM buffer has to grow before the machine is rebuilt
+    std::vector<uint8_t> rom = JoypadROM();
+    rom.resize(rom.size() * 2, 0);
+    bool loaded = false;
+    for (size_t allowed = 0; !loaded; allowed++) {
+        allocations_allowed = allowed;
+        loaded = lb_load_rom(instance, rom.data(), rom.size()) == LB_OK;
+        allocations_allowed = SIZE_MAX;
+
+        if (!loaded) {
+            ASSERT_STRNE(lb_last_error(instance), "");
+        }
+
+        // Whatever failed, the instance is left with a complete machine
+        uint64_t cycles = lb_cycles(instance);
+        ASSERT_EQ(lb_step(instance, 1, 0), LB_OK);
+        ASSERT_GT(lb_cycles(instance), cycles);
+    }
+
+    lb_destroy(instance);
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
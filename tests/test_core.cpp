@@ -0,0 +1,207 @@
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/core/game_boy.hpp"
+#include "../src/util/xxhash64.hpp"
+
+namespace {
+
+/**
+ * @brief Builds a ROM that draws a black tile into the first four map entries, using only implemented op codes
+ * with 8bit operands
+ *
+ */
+std::vector<uint8_t> TileROM() {
+    std::vector<uint8_t> rom(MAX_ROM_SIZE, 0);
+    std::vector<uint8_t> program = {
+        0x06, 0x01,         // LD B, 0x01
+        0x0E, 0x50,         // LD C, 0x50
+        0x0A,               // LD A, (BC)      A = 0xFF
+        0x26, 0x80,         // LD H, 0x80
+        0x2E, 0x10,         // LD L, 0x10      tile 1
+    };
+    for (int i = 0; i < 16; i++) {
+        program.push_back(0x22);  // LD (HL+), A
+    }
+    std::vector<uint8_t> map = {
+        0x0E, 0x51,         // LD C, 0x51
+        0x0A,               // LD A, (BC)      A = 0x01
+        0x26, 0x98,         // LD H, 0x98
+        0x2E, 0x00,         // LD L, 0x00      first map entry
+        0x22, 0x22, 0x22, 0x22,
+        0x18, 0x00,         // JR 0, falling through to the next JR
+        0x18, 0xFC,         // JR back to the JR 0
+    };
+    program.insert(program.end(), map.begin(), map.end());
+
+    memcpy(rom.data() + 0x100, program.data(), program.size());
+    rom[0x150] = 0xFF;
+    rom[0x151] = 0x01;
+    return rom;
+}
+
+TEST(XXHash64Test, TestReferenceValues) {
+    ASSERT_EQ(XXHash64("", 0), 0xEF46DB3751D8E999ULL);
+    ASSERT_EQ(XXHash64("abc", 3), 0x44BC2CF5AD770999ULL);
+
+    // Long enough to use the four lane loop
+    const char* text = "Nobody inspects the spammish repetition";
+    ASSERT_EQ(XXHash64(text, strlen(text)), 0xFBCEA83C8A378BF1ULL);
+}
+
+TEST(GameBoyTest, TestRunsFramesHeadless) {
+    std::vector<uint8_t> rom = TileROM();
+    GameBoy game_boy;
+    ASSERT_TRUE(game_boy.LoadROM(rom.data(), rom.size()));
+
+    game_boy.RunFrame();
+    game_boy.RunFrame();
+
+    // The first four tiles of line 0 are black, the rest of the line is white
+    const uint32_t* frame = game_boy.framebuffer();
+    ASSERT_EQ(frame[0], DMG_SHADES[3]);
+    ASSERT_EQ(frame[31], DMG_SHADES[3]);
+    ASSERT_EQ(frame[32], DMG_SHADES[0]);
+    ASSERT_EQ(frame[SCREEN_WIDTH * 8], DMG_SHADES[0]);
+
+    // Frames end at VBlank, one frame apart
+    uint64_t cycles = game_boy.cycles();
+    game_boy.RunFrame();
+    ASSERT_GE(game_boy.cycles() - cycles, DOTS_PER_FRAME - 24);
+    ASSERT_LE(game_boy.cycles() - cycles, DOTS_PER_FRAME + 24);
+}
+
+TEST(GameBoyTest, TestStepInstructionMatchesRunFrame) {
+    std::vector<uint8_t> rom = TileROM();
+    GameBoy framed;
+    GameBoy stepped;
+    framed.LoadROM(rom.data(), rom.size());
+    stepped.LoadROM(rom.data(), rom.size());
+
+    for (int frame = 0; frame < 3; frame++) {
+        framed.RunFrame();
+    }
+    while (stepped.cycles() < framed.cycles()) {
+        stepped.StepInstruction();
+    }
+
+    ASSERT_EQ(stepped.cycles(), framed.cycles());
+    ASSERT_EQ(stepped.instructions(), framed.instructions());
+    ASSERT_EQ(XXHash64(stepped.framebuffer(), SCREEN_PIXELS * sizeof(uint32_t)),
+        XXHash64(framed.framebuffer(), SCREEN_PIXELS * sizeof(uint32_t)));
+    ASSERT_EQ(stepped.audioSamplesAvailable(), framed.audioSamplesAvailable());
+
+    // Frames carry on from wherever stepping left off
+    stepped.StepInstruction();
+    stepped.RunFrame();
+    framed.RunFrame();
+    ASSERT_EQ(stepped.cycles(), framed.cycles());
+}
+
+TEST(GameBoyTest, TestFrameHashesMatchAcrossPPUs) {
+    std::vector<uint8_t> rom = TileROM();
+    GameBoy fast(FAST_PPU);
+    GameBoy accurate(ACCURATE_PPU);
+    fast.LoadROM(rom.data(), rom.size());
+    accurate.LoadROM(rom.data(), rom.size());
+
+    for (int frame = 0; frame < 4; frame++) {
+        fast.RunFrame();
+        accurate.RunFrame();
+
+        uint64_t fast_hash = XXHash64(fast.framebuffer(), SCREEN_PIXELS * sizeof(uint32_t));
+        uint64_t accurate_hash = XXHash64(accurate.framebuffer(), SCREEN_PIXELS * sizeof(uint32_t));
+        ASSERT_EQ(fast_hash, accurate_hash);
+    }
+}
+
+TEST(GameBoyTest, TestDeferredPPUMatchesInline) {
+    std::vector<uint8_t> rom = TileROM();
+    GameBoy fast(FAST_PPU);
+    GameBoy deferred(DEFERRED_PPU);
+    fast.LoadROM(rom.data(), rom.size());
+    deferred.LoadROM(rom.data(), rom.size());
+
+    for (int frame = 0; frame < 8; frame++) {
+        fast.RunFrame();
+        deferred.RunFrame();
+
+        ASSERT_EQ(deferred.cycles(), fast.cycles());
+        uint64_t fast_hash = XXHash64(fast.framebuffer(), SCREEN_PIXELS * sizeof(uint32_t));
+        uint64_t deferred_hash = XXHash64(deferred.framebuffer(), SCREEN_PIXELS * sizeof(uint32_t));
+        ASSERT_EQ(deferred_hash, fast_hash);
+    }
+
+    // An external buffer receives the following frames once the render thread catches up
+    std::vector<uint32_t> target(SCREEN_PIXELS, 0);
+    deferred.SetFramebuffer(target.data());
+    fast.RunFrame();
+    deferred.RunFrame();
+    ASSERT_EQ(deferred.framebuffer(), target.data());
+    ASSERT_EQ(memcmp(target.data(), fast.framebuffer(), SCREEN_PIXELS * sizeof(uint32_t)), 0);
+
+    // The render state lives on another thread, so there is nothing to copy
+    GameBoy other(DEFERRED_PPU);
+    ASSERT_FALSE(other.CopyStateFrom(&deferred));
+}
+
+TEST(GameBoyTest, TestResetIsDeterministic) {
+    std::vector<uint8_t> rom = TileROM();
+    GameBoy game_boy;
+    game_boy.LoadROM(rom.data(), rom.size());
+
+    game_boy.RunFrame();
+    game_boy.RunFrame();
+    uint64_t first = XXHash64(game_boy.framebuffer(), SCREEN_PIXELS * sizeof(uint32_t));
+
+    game_boy.Reset();
+    ASSERT_EQ(game_boy.cycles(), 0u);
+    game_boy.RunFrame();
+    game_boy.RunFrame();
+    ASSERT_EQ(XXHash64(game_boy.framebuffer(), SCREEN_PIXELS * sizeof(uint32_t)), first);
+}
+
+TEST(GameBoyTest, TestROMIsReadOnly) {
+    std::vector<uint8_t> rom = TileROM();
+    GameBoy game_boy;
+    game_boy.LoadROM(rom.data(), rom.size());
+
+    game_boy.state()->SetMemoryAt(0x0150, 0x00);
+    ASSERT_EQ(game_boy.state()->MemoryAt(0x0150), 0xFF);
+}
+
+TEST(GameBoyTest, TestEachFrameProducesAudio) {
+    std::vector<uint8_t> rom = TileROM();
+    GameBoy game_boy(FAST_PPU, 44100);
+    game_boy.LoadROM(rom.data(), rom.size());
+    ASSERT_EQ(game_boy.sampleRate(), 44100u);
+
+    // The first frame after reset is short. After that a frame lasts 70224 / 4194304 seconds
+    game_boy.RunFrame();
+    game_boy.ReadAudio(nullptr, game_boy.audioSamplesAvailable());
+    game_boy.RunFrame();
+    size_t available = game_boy.audioSamplesAvailable();
+    ASSERT_GE(available, 737u);
+    ASSERT_LE(available, 739u);
+
+    std::vector<float> samples(available * 2);
+    ASSERT_EQ(game_boy.ReadAudio(samples.data(), available), available);
+    ASSERT_EQ(game_boy.audioSamplesAvailable(), 0u);
+}
+
+TEST(GameBoyTest, TestUnimplementedOpCodeThrows) {
+    uint8_t rom[0x200] = {};
+    rom[0x100] = 0xD3;
+    GameBoy game_boy;
+    game_boy.LoadROM(rom, sizeof(rom));
+
+    ASSERT_THROW(game_boy.RunFrame(), std::runtime_error);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,285 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/core/game_boy.hpp"
+#include "../src/debug/debugger.hpp"
+#include "../src/debug/gdb_stub.hpp"
+
+namespace {
+
+/**
+ * @brief Builds a ROM that alternately writes and reads upwards from 0xC000 forever
+ *
+ */
+std::vector<uint8_t> LoopROM() {
+    std::vector<uint8_t> rom(0x200, 0);
+    std::vector<uint8_t> program = {
+        0x21, 0x00, 0xC0,   // 0x100 LD HL, 0xC000
+        0x06, 0x42,         // 0x103 LD B, 0x42
+        0x22,               // 0x105 LD (HL+), A
+        0x2A,               // 0x106 LD A, (HL+)
+        0x04,               // 0x107 INC B
+        0x18, 0xFB,         // 0x108 JR 0x105
+    };
+    memcpy(rom.data() + 0x100, program.data(), program.size());
+    return rom;
+}
+
+/**
+ * @brief Counts the memory observer slots left free on a machine's bus
+ *
+ */
+int FreeObserverSlots(GameBoy* game_boy) {
+    std::vector<Debugger*> debuggers;
+    int free_slots = 0;
+
+    while (free_slots < MAX_MEMORY_OBSERVERS) {
+        Debugger* debugger = new Debugger(game_boy);
+        debuggers.push_back(debugger);
+        if (!debugger->AddWatchpoint(0xD000, 1, WATCH_WRITES)) {
+            break;
+        }
+        free_slots++;
+    }
+
+    for (Debugger* debugger : debuggers) {
+        delete debugger;
+    }
+    return free_slots;
+}
+
+class DebuggerTest : public ::testing::Test {
+protected:
+    GameBoy game_boy_;
+    Debugger debugger_;
+
+    DebuggerTest() : debugger_(&game_boy_) {
+        std::vector<uint8_t> rom = LoopROM();
+        game_boy_.LoadROM(rom.data(), rom.size());
+    }
+};
+
+TEST_F(DebuggerTest, TestBreakpointStopsBeforeInstruction) {
+    this->debugger_.AddBreakpoint(0x0107);
+    ASSERT_TRUE(this->debugger_.hasBreakpoint(0x0107));
+    ASSERT_FALSE(this->debugger_.hasBreakpoint(0x0106));
+
+    ASSERT_EQ(this->debugger_.Continue(), STOP_BREAKPOINT);
+    ASSERT_EQ(this->game_boy_.state()->programCounter(), 0x0107);
+    ASSERT_EQ(this->debugger_.stopAddress(), 0x0107);
+    ASSERT_EQ(this->game_boy_.state()->hl(), 0xC002);
+
+    // Continuing from the breakpoint runs the loop once more
+    ASSERT_EQ(this->debugger_.Continue(), STOP_BREAKPOINT);
+    ASSERT_EQ(this->game_boy_.state()->programCounter(), 0x0107);
+    ASSERT_EQ(this->game_boy_.state()->hl(), 0xC004);
+
+    this->debugger_.RemoveBreakpoint(0x0107);
+    ASSERT_EQ(this->debugger_.Continue(100), STOP_LIMIT);
+}
+
+TEST_F(DebuggerTest, TestStepIgnoresBreakpoints) {
+    this->debugger_.AddBreakpoint(0x0103);
+
+    ASSERT_EQ(this->debugger_.Step(), STOP_STEP);
+    ASSERT_EQ(this->game_boy_.state()->programCounter(), 0x0103);
+    ASSERT_EQ(this->debugger_.Step(), STOP_STEP);
+    ASSERT_EQ(this->game_boy_.state()->programCounter(), 0x0105);
+}
+
+TEST_F(DebuggerTest, TestWriteWatchpointStopsAfterWrite) {
+    ASSERT_TRUE(this->debugger_.AddWatchpoint(0xC000, 1, WATCH_WRITES));
+
+    // A is 0x01 after boot
+    ASSERT_EQ(this->debugger_.Continue(), STOP_WATCH_WRITE);
+    ASSERT_EQ(this->debugger_.stopAddress(), 0xC000);
+    ASSERT_EQ(this->game_boy_.state()->programCounter(), 0x0106);
+    ASSERT_EQ(this->game_boy_.memory()[0xC000], 0x01);
+}
+
+TEST_F(DebuggerTest, TestReadWatchpointStopsAfterRead) {
+    ASSERT_TRUE(this->debugger_.AddWatchpoint(0xC001, 1, WATCH_READS));
+
+    ASSERT_EQ(this->debugger_.Continue(), STOP_WATCH_READ);
+    ASSERT_EQ(this->debugger_.stopAddress(), 0xC001);
+    ASSERT_EQ(this->game_boy_.state()->programCounter(), 0x0107);
+}
+
+TEST_F(DebuggerTest, TestExecutingWatchedCodeIsNotARead) {
+    // The whole program, op codes and operands, is run but never read as data
+    ASSERT_TRUE(this->debugger_.AddWatchpoint(0x0100, 10, WATCH_READS));
+    ASSERT_EQ(this->debugger_.Continue(40), STOP_LIMIT);
+
+    // Data reads still stop
+    ASSERT_TRUE(this->debugger_.AddWatchpoint(0xC031, 1, WATCH_READS));
+    ASSERT_EQ(this->debugger_.Continue(), STOP_WATCH_READ);
+    ASSERT_EQ(this->debugger_.stopAddress(), 0xC031);
+}
+
+TEST_F(DebuggerTest, TestOnlyWatchedAddressesStop) {
+    // Same page as the accesses, but never touched within the limit
+    ASSERT_TRUE(this->debugger_.AddWatchpoint(0xC0F0, 16, WATCH_READS | WATCH_WRITES));
+    ASSERT_TRUE(this->debugger_.isWatched(0xC0FF, WATCH_READS));
+    ASSERT_FALSE(this->debugger_.isWatched(0xC0EF, WATCH_WRITES));
+    ASSERT_EQ(this->debugger_.Continue(40), STOP_LIMIT);
+
+    ASSERT_TRUE(this->debugger_.AddWatchpoint(0xC020, 1, WATCH_WRITES));
+    this->debugger_.RemoveWatchpoint(0xC020, 1, WATCH_WRITES);
+    ASSERT_FALSE(this->debugger_.isWatched(0xC020, WATCH_WRITES));
+    ASSERT_EQ(this->debugger_.Continue(40), STOP_LIMIT);
+}
+
+TEST_F(DebuggerTest, TestClearedWatchpointsReleaseTheBus) {
+    ASSERT_TRUE(this->debugger_.AddWatchpoint(0xC002, 1, WATCH_WRITES));
+    int free_while_watching = FreeObserverSlots(&this->game_boy_);
+
+    this->debugger_.ClearAll();
+    ASSERT_EQ(FreeObserverSlots(&this->game_boy_), free_while_watching + 1);
+    ASSERT_EQ(this->debugger_.Continue(40), STOP_LIMIT);
+}
+
+TEST(DebuggerFaultTest, TestUnimplementedOpCodeStops) {
+    uint8_t rom[0x200] = {};
+    rom[0x100] = 0xD3;
+    GameBoy game_boy;
+    game_boy.LoadROM(rom, sizeof(rom));
+    Debugger debugger(&game_boy);
+
+    ASSERT_EQ(debugger.Continue(), STOP_FAULT);
+    ASSERT_NE(debugger.fault().find("Unimplemented"), std::string::npos);
+}
+
+class GDBStubTest : public DebuggerTest {
+protected:
+    GDBStub stub_;
+
+    GDBStubTest() : stub_(&debugger_) {}
+};
+
+TEST_F(GDBStubTest, TestFrame) {
+    ASSERT_EQ(GDBStub::Checksum("OK"), 0x9A);
+    ASSERT_EQ(GDBStub::Frame("OK"), "$OK#9a");
+    ASSERT_EQ(GDBStub::Frame(""), "$#00");
+}
+
+TEST_F(GDBStubTest, TestReadsRegistersInZ80Layout) {
+    std::string expected = "b001" "1300" "d800" "4d01" "feff" "0001";
+    for (int i = GDB_IX; i < GDB_REGISTER_COUNT; i++) {
+        expected += "0000";
+    }
+
+    ASSERT_EQ(this->stub_.HandlePacket("g"), expected);
+    ASSERT_EQ(this->stub_.HandlePacket("p5"), "0001");
+    ASSERT_EQ(this->stub_.HandlePacket("pd"), "E01");
+}
+
+TEST_F(GDBStubTest, TestWritesRegisters) {
+    ASSERT_EQ(this->stub_.HandlePacket("P5=0201"), "OK");
+    ASSERT_EQ(this->game_boy_.state()->programCounter(), 0x0102);
+
+    std::string registers = this->stub_.HandlePacket("g");
+    registers.replace(GDB_BC * 4, 4, "3412");
+    ASSERT_EQ(this->stub_.HandlePacket("G" + registers), "OK");
+    ASSERT_EQ(this->game_boy_.state()->bc(), 0x1234);
+    ASSERT_EQ(this->game_boy_.state()->programCounter(), 0x0102);
+
+    ASSERT_EQ(this->stub_.HandlePacket("G00"), "E01");
+}
+
+TEST_F(GDBStubTest, TestReadsAndWritesMemory) {
+    ASSERT_EQ(this->stub_.HandlePacket("Mc000,3:abcdef"), "OK");
+    ASSERT_EQ(this->stub_.HandlePacket("mc000,3"), "abcdef");
+    ASSERT_EQ(this->stub_.HandlePacket("m100,3"), "2100c0");
+    ASSERT_EQ(this->stub_.HandlePacket("Mffff,2:5a5b"), "OK");
+    ASSERT_EQ(this->stub_.HandlePacket("mffff,2"), "5a5b");
+    ASSERT_EQ(this->game_boy_.memory()[0x0000], 0x5B);
+    ASSERT_EQ(this->stub_.HandlePacket("Mc000,2:ab"), "E01");
+}
+
+TEST_F(GDBStubTest, TestBreakpointPackets) {
+    ASSERT_EQ(this->stub_.HandlePacket("Z0,107,1"), "OK");
+    ASSERT_EQ(this->stub_.HandlePacket("c"), "T05");
+    ASSERT_EQ(this->game_boy_.state()->programCounter(), 0x0107);
+    ASSERT_EQ(this->stub_.HandlePacket("?"), "T05");
+
+    ASSERT_EQ(this->stub_.HandlePacket("z0,107,1"), "OK");
+    ASSERT_FALSE(this->debugger_.hasBreakpoint(0x0107));
+
+    ASSERT_EQ(this->stub_.HandlePacket("s"), "T05");
+    ASSERT_EQ(this->game_boy_.state()->programCounter(), 0x0108);
+}
+
+TEST_F(GDBStubTest, TestWatchpointPackets) {
+    ASSERT_EQ(this->stub_.HandlePacket("Z2,c002,1"), "OK");
+    ASSERT_EQ(this->stub_.HandlePacket("c"), "T05watch:c002;");
+    ASSERT_EQ(this->stub_.HandlePacket("z2,c002,1"), "OK");
+
+    ASSERT_EQ(this->stub_.HandlePacket("Z3,c003,1"), "OK");
+    ASSERT_EQ(this->stub_.HandlePacket("c"), "T05rwatch:c003;");
+    ASSERT_EQ(this->stub_.HandlePacket("z3,c003,1"), "OK");
+
+    ASSERT_EQ(this->stub_.HandlePacket("Z4,c004,2"), "OK");
+    ASSERT_EQ(this->stub_.HandlePacket("c"), "T05awatch:c004;");
+}
+
+TEST_F(GDBStubTest, TestUnsupportedPacketsGetEmptyReplies) {
+    ASSERT_EQ(this->stub_.HandlePacket("vMustReplyEmpty"), "");
+    ASSERT_EQ(this->stub_.HandlePacket("Z9,100,1"), "");
+    ASSERT_EQ(this->stub_.HandlePacket("qSupported:swbreak+"), "PacketSize=4000");
+}
+
+TEST_F(GDBStubTest, TestServesClientOverTCP) {
+    ASSERT_TRUE(this->stub_.Listen(0));
+    ASSERT_NE(this->stub_.port(), 0);
+
+    std::string received;
+    std::thread client([this, &received]() {
+        int connection = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(this->stub_.port());
+        if (connect(connection, (sockaddr*)&address, sizeof(address)) != 0) {
+            close(connection);
+            return;
+        }
+
+        // A corrupt packet is refused, then the resend is answered
+        std::string request = "$?#00$?#3f";
+        send(connection, request.data(), request.size(), 0);
+
+        char buffer[64];
+        while (received.find('#') == std::string::npos || received.size() < received.find('#') + 3) {
+            ssize_t length = recv(connection, buffer, sizeof(buffer), 0);
+            if (length <= 0) {
+                break;
+            }
+            received.append(buffer, (size_t)length);
+        }
+
+        std::string kill = "+$k#6b";
+        send(connection, kill.data(), kill.size(), 0);
+        recv(connection, buffer, sizeof(buffer), 0);
+        close(connection);
+    });
+
+    ASSERT_TRUE(this->stub_.Serve());
+    client.join();
+
+    ASSERT_EQ(received, "-+$T05#b9");
+    ASSERT_TRUE(this->stub_.killed());
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
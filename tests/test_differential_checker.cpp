@@ -0,0 +1,149 @@
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/cpu/cpu_engine.hpp"
+#include "../src/cpu/differential_checker.hpp"
+#include "../src/cpu/instruction_observer.hpp"
+
+namespace {
+
+// Corrupts the state of an engine just after it runs the instruction at a given address
+class FaultInjector : public InstructionObserver {
+public:
+    uint16_t pc;
+    uint16_t address;
+
+    void OnInstruction(uint16_t pc, uint8_t op_code, uint8_t cycles, SM83State* state) override {
+        if (pc != this->pc) {
+            return;
+        }
+        if (this->address == 0) {
+            state->setA((uint8_t)(state->a() + 1));
+        } else {
+            state->SetMemoryAt(this->address, 0x5A);
+        }
+    }
+};
+
+// A bus of NOPs, so the PC walks through every address at 4 cycles an instruction
+std::vector<uint8_t> BuildNopMemory(SM83State* registers) {
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    registers->setAF(0x01B0);
+    registers->setStackPointer(0xFFFE);
+    registers->setProgramCounter(0x0100);
+    return memory;
+}
+
+TEST(DifferentialCheckerTest, TestEnginesAgreeOnRandomCode) {
+    std::vector<uint8_t> op_codes;
+    for (int op_code = 0; op_code < 0x100; op_code++) {
+        // 08 writes its operand into the code, C9 and CD move the PC through RAM
+        if (OpCodeHandlerFor((uint8_t)op_code) != nullptr && op_code != 0x08 && op_code != 0xC9 && op_code != 0xCD) {
+            op_codes.push_back((uint8_t)op_code);
+        }
+    }
+
+    // The first and last pages are NOPs, the last ending in JR 7F80, so relative jumps never leave ROM
+    std::mt19937 random(99);
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    for (uint32_t i = 0x100; i < 0x7F00; i++) {
+        memory[i] = op_codes[random() % op_codes.size()];
+    }
+    memory[0x7FFE] = 0x18;
+    memory[0x7FFF] = 0x80;
+
+    SM83State registers(memory.data());
+    registers.setAF(0x01B0);
+    registers.setStackPointer(0xD000);
+    registers.setProgramCounter(0x0400);
+
+    InterpreterEngine interpreter;
+    LockstepEngine lockstep(1);
+    DifferentialChecker checker(&interpreter, &lockstep, 4096, 16);
+
+    ASSERT_TRUE(checker.Run(&registers, memory.data(), 200000));
+    ASSERT_GE(checker.checks(), 200000u / 4096);
+}
+
+TEST(DifferentialCheckerTest, TestFindsFirstDivergingInstruction) {
+    SM83State registers(nullptr);
+    std::vector<uint8_t> memory = BuildNopMemory(&registers);
+
+    InterpreterEngine first;
+    InterpreterEngine second;
+    FaultInjector fault;
+    fault.pc = 0x1234;
+    fault.address = 0;
+    second.cpu()->AddInstructionObserver(&fault);
+
+    DifferentialChecker checker(&first, &second, 4096, 8);
+    ASSERT_FALSE(checker.Run(&registers, memory.data(), 100000));
+
+    const Divergence& divergence = checker.divergence();
+    ASSERT_EQ(divergence.pc, 0x1234);
+    ASSERT_EQ(divergence.op_code, 0x00);
+    ASSERT_EQ(divergence.cycle, (0x1234u - 0x100u) * 4);
+    ASSERT_NE(divergence.differences.find("AF 01B0 != 02B0"), std::string::npos);
+
+    // Both traces end on the diverging instruction, with the corruption only in the second
+    ASSERT_EQ(divergence.first_trace.size(), 8u);
+    ASSERT_EQ(divergence.second_trace.size(), 8u);
+    ASSERT_EQ(divergence.first_trace.back().pc, 0x1234);
+    ASSERT_EQ(divergence.second_trace.back().pc, 0x1234);
+    ASSERT_EQ(divergence.first_trace.back().a, 0x01);
+    ASSERT_EQ(divergence.second_trace.back().a, 0x02);
+    ASSERT_EQ(divergence.first_trace[6].a, divergence.second_trace[6].a);
+}
+
+TEST(DifferentialCheckerTest, TestReportsMemoryDifferences) {
+    SM83State registers(nullptr);
+    std::vector<uint8_t> memory = BuildNopMemory(&registers);
+
+    InterpreterEngine first;
+    InterpreterEngine second;
+    FaultInjector fault;
+    fault.pc = 0x0200;
+    fault.address = 0xC123;
+    second.cpu()->AddInstructionObserver(&fault);
+
+    // The divergence lands in the first interval, which is cut short by the end of the run
+    DifferentialChecker checker(&first, &second, 65536, 4);
+    ASSERT_FALSE(checker.Run(&registers, memory.data(), 2000));
+
+    const Divergence& divergence = checker.divergence();
+    ASSERT_EQ(divergence.pc, 0x0200);
+    ASSERT_EQ(divergence.differences, "memory C123-C123, first byte 00 != 5A\n");
+
+    std::string path = testing::TempDir() + "differential_report.txt";
+    FILE* file = fopen(path.c_str(), "w");
+    checker.WriteReport(file);
+    fclose(file);
+
+    file = fopen(path.c_str(), "r");
+    char line[256];
+    ASSERT_NE(fgets(line, sizeof(line), file), nullptr);
+    fclose(file);
+    remove(path.c_str());
+    ASSERT_STREQ(line, "interpreter and interpreter diverge at cycle 1024 running 00 at 0200\n");
+}
+
+TEST(DifferentialCheckerTest, TestNoDivergenceWithoutFault) {
+    SM83State registers(nullptr);
+    std::vector<uint8_t> memory = BuildNopMemory(&registers);
+
+    InterpreterEngine first;
+    InterpreterEngine second;
+    DifferentialChecker checker(&first, &second, 1000, 4);
+
+    ASSERT_TRUE(checker.Run(&registers, memory.data(), 10000));
+    ASSERT_EQ(checker.checks(), 10u);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
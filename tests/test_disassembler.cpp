@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/cpu/disassembler.hpp"
+#include "../src/cpu/sm83_emulator.hpp"
+#include "../src/cpu/sm83_op_code_info.hpp"
+#include "../src/cpu/symbol_table.hpp"
+
+namespace {
+
+std::string Disassemble(std::vector<uint8_t> bytes, uint16_t address = 0x0100, const SymbolTable* symbols = nullptr) {
+    bytes.resize(3, 0x00);
+    char text[DISASSEMBLY_TEXT_SIZE];
+    DisassembleInstruction(bytes.data(), address, symbols, text);
+    return text;
+}
+
+bool IsBranch(const char* mnemonic) {
+    const char* branches[] = {"JR", "JP", "CALL", "RET", "RST"};
+    for (const char* branch : branches) {
+        if (strncmp(mnemonic, branch, strlen(branch)) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The tables check themselves when included, and the accessors work at compile time too
+static_assert(OpCodeInfoFor(0x01).length == 3 && OpCodeInfoFor(0x01).cycles == 12, "LD BC,d16");
+static_assert(OpCodeInfoFor(0x20).cycles == 8 && OpCodeInfoFor(0x20).branch_cycles == 12, "JR NZ,r8");
+static_assert(CBOpCodeInfoFor(0x46).cycles == 12 && CBOpCodeInfoFor(0x86).cycles == 16, "BIT and RES through (HL)");
+
+TEST(OpCodeInfoTest, TestChecksCatchMismatches) {
+    OpCodeInfo short_load = {"LD BC,d16", 2, 12, 12, "----"};
+    ASSERT_EQ(ExpectedLength(short_load, false), 3);
+    ASSERT_EQ(ExpectedLength(OpCodeInfoFor(0x10), false), 2);
+    ASSERT_EQ(ExpectedLength(OpCodeInfoFor(0xF8), false), 2);
+    ASSERT_EQ(ExpectedLength(OpCodeInfoFor(0xD3), false), 1);
+    ASSERT_EQ(ExpectedLength(CBOpCodeInfoFor(0x00), true), 2);
+
+    ASSERT_TRUE(IsConditionalBranch(OpCodeInfoFor(0x38)));
+    ASSERT_TRUE(IsConditionalBranch(OpCodeInfoFor(0xC0)));
+    ASSERT_TRUE(IsConditionalBranch(OpCodeInfoFor(0xDC)));
+    ASSERT_FALSE(IsConditionalBranch(OpCodeInfoFor(0x18)));
+    ASSERT_FALSE(IsConditionalBranch(OpCodeInfoFor(0x0E)));
+    ASSERT_FALSE(IsConditionalBranch(OpCodeInfoFor(0xD9)));
+    ASSERT_FALSE(IsConditionalBranch(OpCodeInfoFor(0xE9)));
+
+    OpCodeInfo table[256];
+    std::copy(OP_CODE_INFO, OP_CODE_INFO + 256, table);
+    ASSERT_TRUE(LengthsMatchOperands(table, false));
+    ASSERT_TRUE(BranchCyclesMatchConditions(table));
+
+    table[0x01] = short_load;
+    ASSERT_FALSE(LengthsMatchOperands(table, false));
+    table[0x01] = OP_CODE_INFO[0x01];
+
+    table[0x20].cycles = 12;
+    ASSERT_FALSE(BranchCyclesMatchConditions(table));
+    table[0x20] = OP_CODE_INFO[0x20];
+
+    table[0x04].cycles = 6;
+    ASSERT_FALSE(CyclesAreMachineCycles(table));
+    table[0x04] = OP_CODE_INFO[0x04];
+
+    table[0x04].flags = "Z0H";
+    ASSERT_FALSE(FlagsAreWellFormed(table));
+}
+
+TEST(OpCodeInfoTest, TestTablesMatchHandlers) {
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    SM83State state(memory.data());
+
+    for (int op_code = 0; op_code < 256; op_code++) {
+        OpCodeHandler handler = OpCodeHandlerFor((uint8_t)op_code);
+        if (handler == nullptr) {
+            continue;
+        }
+        const OpCodeInfo& info = OpCodeInfoFor((uint8_t)op_code);
+        ASSERT_NE(info.mnemonic, nullptr) << std::hex << op_code;
+
+        // Every condition is true under one of these flag values and false under the other
+        const uint8_t flag_values[] = {0x00, 0xF0};
+        for (uint8_t flags : flag_values) {
+            std::fill(memory.begin(), memory.end(), 0x00);
+            memory[0x1000] = (uint8_t)op_code;
+            state.setAF(flags);
+            state.setHL(0xC000);
+            state.setStackPointer(0xDFF0);
+            state.setProgramCounter(0x1000);
+
+            uint8_t cycles = handler(&state);
+            ASSERT_TRUE(cycles == info.cycles || cycles == info.branch_cycles) << std::hex << op_code;
+            if (!IsBranch(info.mnemonic)) {
+                ASSERT_EQ(state.programCounter(), 0x1000 + info.length) << std::hex << op_code;
+                ASSERT_EQ(cycles, info.cycles) << std::hex << op_code;
+            }
+        }
+    }
+}
+
+TEST(DisassemblerTest, TestOperands) {
+    ASSERT_EQ(Disassemble({0x00}), "NOP");
+    ASSERT_EQ(Disassemble({0x01, 0x34, 0x12}), "LD BC,$1234");
+    ASSERT_EQ(Disassemble({0x36, 0x7F}), "LD (HL),$7F");
+    ASSERT_EQ(Disassemble({0x08, 0x00, 0xC0}), "LD ($C000),SP");
+    ASSERT_EQ(Disassemble({0xE0, 0x44}), "LDH ($FF44),A");
+    ASSERT_EQ(Disassemble({0xF8, 0xFB}), "LD HL,SP-5");
+    ASSERT_EQ(Disassemble({0xF8, 0x05}), "LD HL,SP+5");
+    ASSERT_EQ(Disassemble({0xE8, 0x80}), "ADD SP,-128");
+    ASSERT_EQ(Disassemble({0xCB, 0x7C}), "BIT 7,H");
+    ASSERT_EQ(Disassemble({0xCB, 0x36}), "SWAP (HL)");
+    ASSERT_EQ(Disassemble({0xD3}), "DB $D3");
+    ASSERT_EQ(Disassemble({0xFF}), "RST 38H");
+}
+
+TEST(DisassemblerTest, TestRelativeJumpTargets) {
+    ASSERT_EQ(Disassemble({0x18, 0xFE}, 0x0150), "JR $0150");
+    ASSERT_EQ(Disassemble({0x20, 0x05}, 0x0100), "JR NZ,$0107");
+    ASSERT_EQ(Disassemble({0x38, 0x80}, 0x0000), "JR C,$FF82");
+}
+
+TEST(DisassemblerTest, TestLabels) {
+    SymbolTable symbols;
+    symbols.Add(0x01, 0x4000, "Main");
+    symbols.Add(0x00, 0x0150, "Start.loop");
+    symbols.Add(0x00, 0xFF80, "hFrameCount");
+
+    ASSERT_EQ(Disassemble({0xCD, 0x00, 0x40}, 0x0100, &symbols), "CALL Main");
+    ASSERT_EQ(Disassemble({0xC3, 0x00, 0x40}, 0x0100, &symbols), "JP Main");
+    ASSERT_EQ(Disassemble({0x18, 0xFE}, 0x0150, &symbols), "JR Start.loop");
+    ASSERT_EQ(Disassemble({0xF0, 0x80}, 0x0100, &symbols), "LDH A,(hFrameCount)");
+
+    // Immediate data is never taken for an address
+    ASSERT_EQ(Disassemble({0x21, 0x00, 0x40}, 0x0100, &symbols), "LD HL,$4000");
+}
+
+TEST(SymbolTableTest, TestLoadSymFile) {
+    std::string path = testing::TempDir() + "lameboy_symbols.sym";
+    FILE* file = fopen(path.c_str(), "w");
+    fputs("; File generated by rgblink\n", file);
+    fputs("00:0150 Start\n", file);
+    fputs("00:0150 Start.loop\n", file);
+    fputs("01:4000 Main ; entry point\n", file);
+    fputs("00:c000 wBuffer\r\n", file);
+    fputs("garbage line\n", file);
+    fputs("1:ZZZZ Broken\n", file);
+    fclose(file);
+
+    SymbolTable symbols;
+    ASSERT_TRUE(symbols.LoadSymFile(path.c_str()));
+    remove(path.c_str());
+
+    ASSERT_EQ(symbols.size(), 3u);
+    ASSERT_STREQ(symbols.Find(0x00, 0x0150), "Start");
+    ASSERT_STREQ(symbols.Find(0x01, 0x4000), "Main");
+    ASSERT_STREQ(symbols.Find(0x00, 0xC000), "wBuffer");
+    ASSERT_EQ(symbols.Find(0x00, 0x4000), nullptr);
+
+    ASSERT_FALSE(symbols.LoadSymFile((path + ".missing").c_str()));
+}
+
+TEST(SymbolTableTest, TestGlobalLabelsReplaceLocalOnes) {
+    SymbolTable symbols;
+    symbols.Add(0x00, 0x0200, "Loop.inner");
+    symbols.Add(0x00, 0x0200, "Copy");
+    symbols.Add(0x00, 0x0200, "Copy.start");
+    ASSERT_STREQ(symbols.Find(0x00, 0x0200), "Copy");
+}
+
+TEST(DisassemblerTest, TestCacheHitsAndInvalidation) {
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    memory[0xC000] = 0x01;
+    memory[0xC001] = 0x34;
+    memory[0xC002] = 0x12;
+    Disassembler disassembler(memory.data());
+
+    ASSERT_STREQ(disassembler.Disassemble(0xC000).text, "LD BC,$1234");
+    ASSERT_STREQ(disassembler.Disassemble(0xC000).text, "LD BC,$1234");
+    ASSERT_EQ(disassembler.misses(), 1u);
+    ASSERT_EQ(disassembler.hits(), 1u);
+
+    // Writing an operand byte invalidates the line
+    memory[0xC002] = 0x56;
+    const DisassembledLine& line = disassembler.Disassemble(0xC000);
+    ASSERT_STREQ(line.text, "LD BC,$5634");
+    ASSERT_EQ(line.length, 3);
+    ASSERT_EQ(line.address, 0xC000);
+    ASSERT_EQ(disassembler.misses(), 2u);
+
+    // Bytes past the end of the instruction do not matter
+    memory[0xC003] = 0xFF;
+    disassembler.Disassemble(0xC000);
+    ASSERT_EQ(disassembler.hits(), 2u);
+
+    // The same address in another bank is a different line
+    ASSERT_EQ(disassembler.Disassemble(0xC000, 2).bank, 2);
+    ASSERT_EQ(disassembler.misses(), 3u);
+}
+
+TEST(DisassemblerTest, TestSymbolsClearTheCache) {
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    memory[0x0100] = 0xC3;
+    memory[0x0101] = 0x50;
+    memory[0x0102] = 0x01;
+    Disassembler disassembler(memory.data());
+    ASSERT_STREQ(disassembler.Disassemble(0x0100).text, "JP $0150");
+
+    SymbolTable symbols;
+    symbols.Add(0x00, 0x0150, "Start");
+    disassembler.SetSymbols(&symbols);
+    ASSERT_STREQ(disassembler.Disassemble(0x0100).text, "JP Start");
+}
+
+TEST(DisassemblerTest, TestWrapsAtTheEndOfMemory) {
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    memory[0xFFFF] = 0x01;
+    memory[0x0000] = 0xCD;
+    memory[0x0001] = 0xAB;
+    Disassembler disassembler(memory.data());
+    ASSERT_STREQ(disassembler.Disassemble(0xFFFF).text, "LD BC,$ABCD");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,177 @@
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/core/scheduler.hpp"
+#include "../src/cpu/sm83_state.hpp"
+#include "../src/memory/dma_controller.hpp"
+#include "../src/ppu/ppu.hpp"
+
+namespace {
+
+/**
+ * @brief Wires a DMA controller to a CPU state, scheduler and PPU sharing one memory bus
+ *
+ */
+class DMATest : public ::testing::Test {
+protected:
+
+    uint8_t* memory_;
+    SM83State* state_;
+    Scheduler* scheduler_;
+    FastPPU* ppu_;
+    DMAController* dma_;
+
+    void SetUp() override {
+        this->memory_ = new uint8_t[65536]();
+        this->state_ = new SM83State(this->memory_);
+        this->scheduler_ = new Scheduler();
+        this->ppu_ = new FastPPU(this->memory_);
+        this->dma_ = new DMAController(this->memory_, this->state_, this->scheduler_, this->ppu_);
+        this->state_->AddMemoryObserver(this->ppu_, 0xFE, 0xFE);
+    }
+
+    void TearDown() override {
+        delete this->dma_;
+        delete this->ppu_;
+        delete this->scheduler_;
+        delete this->state_;
+        delete[] this->memory_;
+    }
+
+    // Runs the PPU and scheduler in lockstep, as the emulator core does
+    void Run(uint32_t cycles) {
+        while (cycles > 0) {
+            uint16_t step = cycles < 4 ? (uint16_t)cycles : 4;
+            this->ppu_->Tick(step);
+            this->scheduler_->Advance(step);
+            cycles -= step;
+        }
+    }
+};
+
+TEST(SchedulerTest, TestEventsRunInTimeOrder) {
+    Scheduler scheduler;
+    std::vector<int> order;
+
+    scheduler.Schedule(10, [&order](uint64_t late) { order.push_back(2); });
+    scheduler.Schedule(5, [&order](uint64_t late) { order.push_back(1); });
+    uint32_t cancelled = scheduler.Schedule(7, [&order](uint64_t late) { order.push_back(99); });
+    scheduler.Schedule(10, [&order](uint64_t late) { order.push_back(3); });
+    scheduler.Cancel(cancelled);
+
+    ASSERT_EQ(scheduler.nextEventTime(), 5u);
+    scheduler.Advance(4);
+    ASSERT_TRUE(order.empty());
+
+    scheduler.Advance(8);
+    ASSERT_EQ(order, std::vector<int>({ 1, 2, 3 }));
+    ASSERT_EQ(scheduler.nextEventTime(), UINT64_MAX);
+}
+
+TEST_F(DMATest, TestOAMDMACopiesAndRestrictsBus) {
+    for (int i = 0; i < OAM_SIZE; i++) {
+        this->memory_[0xC100 + i] = (uint8_t)(i + 1);
+    }
+    this->memory_[0xFF80] = 0x42;
+
+    this->state_->SetMemoryAt(DMA_ADDRESS, 0xC1);
+
+    for (int i = 0; i < OAM_SIZE; i++) {
+        ASSERT_EQ(this->memory_[OAM_START + i], i + 1);
+    }
+
+    // Only HRAM and the IO registers are reachable while the transfer runs
+    ASSERT_TRUE(this->dma_->oamDMAActive());
+    ASSERT_EQ(this->state_->MemoryAt(0xC100), 0xFF);
+    ASSERT_EQ(this->state_->MemoryAt(0x0000), 0xFF);
+    ASSERT_EQ(this->state_->MemoryAt(0xFF80), 0x42);
+
+    this->Run(OAM_DMA_DOTS - 4);
+    ASSERT_EQ(this->state_->MemoryAt(0xC100), 0xFF);
+
+    this->Run(4);
+    ASSERT_FALSE(this->dma_->oamDMAActive());
+    ASSERT_EQ(this->state_->MemoryAt(0xC100), 1);
+}
+
+TEST_F(DMATest, TestOAMDMAFromEchoRAM) {
+    this->memory_[0xC200] = 0x12;
+    this->state_->SetMemoryAt(DMA_ADDRESS, 0xE2);
+    ASSERT_EQ(this->memory_[OAM_START], 0x12);
+}
+
+TEST_F(DMATest, TestGeneralPurposeDMA) {
+    for (int i = 0; i < 64; i++) {
+        this->memory_[0xD000 + i] = (uint8_t)(0x80 | i);
+    }
+
+    this->state_->SetMemoryAt(HDMA1_ADDRESS, 0xD0);
+    this->state_->SetMemoryAt(HDMA2_ADDRESS, 0x0F);
+    this->state_->SetMemoryAt(HDMA3_ADDRESS, 0x01);
+    this->state_->SetMemoryAt(HDMA4_ADDRESS, 0x2F);
+    this->state_->SetMemoryAt(HDMA5_ADDRESS, 0x03);
+
+    // The low nibbles of the addresses are ignored
+    for (int i = 0; i < 64; i++) {
+        ASSERT_EQ(this->memory_[0x8120 + i], 0x80 | i);
+    }
+    ASSERT_EQ(this->memory_[0x8120 + 64], 0);
+    ASSERT_EQ(this->memory_[HDMA5_ADDRESS], 0xFF);
+    ASSERT_EQ(this->dma_->TakeStallCycles(), 4u * HDMA_BLOCK_DOTS);
+    ASSERT_EQ(this->dma_->TakeStallCycles(), 0u);
+}
+
+TEST_F(DMATest, TestHBlankDMACopiesOneBlockPerLine) {
+    for (int i = 0; i < 48; i++) {
+        this->memory_[0xC000 + i] = (uint8_t)(i + 1);
+    }
+    this->state_->SetMemoryAt(LCDC_ADDRESS, LCDC_LCD_ENABLE);
+    this->Run(4);
+
+    this->state_->SetMemoryAt(HDMA1_ADDRESS, 0xC0);
+    this->state_->SetMemoryAt(HDMA2_ADDRESS, 0x00);
+    this->state_->SetMemoryAt(HDMA3_ADDRESS, 0x00);
+    this->state_->SetMemoryAt(HDMA4_ADDRESS, 0x00);
+    this->state_->SetMemoryAt(HDMA5_ADDRESS, HDMA_HBLANK_MODE | 0x02);
+
+    ASSERT_TRUE(this->dma_->hdmaActive());
+    ASSERT_EQ(this->memory_[HDMA5_ADDRESS], 0x02);
+
+    // Nothing moves before the first HBlank
+    this->Run(OAM_SCAN_DOTS + TRANSFER_DOTS - 8);
+    ASSERT_EQ(this->memory_[0x8000], 0);
+
+    this->Run(8);
+    ASSERT_EQ(this->memory_[0x8000], 1);
+    ASSERT_EQ(this->memory_[0x800F], 16);
+    ASSERT_EQ(this->memory_[0x8010], 0);
+    ASSERT_EQ(this->memory_[HDMA5_ADDRESS], 0x01);
+
+    this->Run(DOTS_PER_LINE);
+    ASSERT_EQ(this->memory_[0x801F], 32);
+    ASSERT_EQ(this->memory_[0x8020], 0);
+
+    this->Run(DOTS_PER_LINE);
+    ASSERT_EQ(this->memory_[0x802F], 48);
+    ASSERT_FALSE(this->dma_->hdmaActive());
+    ASSERT_EQ(this->memory_[HDMA5_ADDRESS], 0xFF);
+    ASSERT_EQ(this->dma_->TakeStallCycles(), 3u * HDMA_BLOCK_DOTS);
+}
+
+TEST_F(DMATest, TestHBlankDMACancel) {
+    this->state_->SetMemoryAt(LCDC_ADDRESS, LCDC_LCD_ENABLE);
+    this->Run(4);
+
+    this->state_->SetMemoryAt(HDMA5_ADDRESS, HDMA_HBLANK_MODE | 0x05);
+    this->Run(DOTS_PER_LINE);
+    this->state_->SetMemoryAt(HDMA5_ADDRESS, 0x00);
+
+    ASSERT_FALSE(this->dma_->hdmaActive());
+    ASSERT_EQ(this->memory_[HDMA5_ADDRESS], HDMA_HBLANK_MODE | 0x04);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
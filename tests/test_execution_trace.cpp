@@ -0,0 +1,135 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/cpu/execution_trace.hpp"
+#include "../src/cpu/sm83_emulator.hpp"
+
+namespace {
+
+TEST(ExecutionTraceTest, TestRecordsRegistersAfterEachInstruction) {
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    SM83State state(memory.data());
+    SM83Emulator emulator(&state);
+    ExecutionTrace trace(16, memory.data());
+
+    // INC B, then LD C,0x42
+    memory[0x100] = 0x04;
+    memory[0x101] = 0x0E;
+    memory[0x102] = 0x42;
+    state.setStackPointer(0xFFFE);
+    state.setProgramCounter(0x100);
+
+    emulator.SetTrace(&trace);
+    ASSERT_EQ(emulator.trace(), &trace);
+    emulator.Step();
+    emulator.Step();
+
+    ASSERT_EQ(trace.size(), 2u);
+    const TraceRecord& inc = trace.at(0);
+    ASSERT_EQ(inc.pc, 0x100);
+    ASSERT_EQ(inc.op_code, 0x04);
+    ASSERT_EQ(inc.operands[0], 0x0E);
+    ASSERT_EQ(inc.operands[1], 0x42);
+    ASSERT_EQ(inc.cycles, 4);
+    ASSERT_EQ(inc.b, 0x01);
+    ASSERT_EQ(inc.c, 0x00);
+    ASSERT_EQ(inc.sp, 0xFFFE);
+
+    const TraceRecord& load = trace.at(1);
+    ASSERT_EQ(load.pc, 0x101);
+    ASSERT_EQ(load.op_code, 0x0E);
+    ASSERT_EQ(load.cycles, 8);
+    ASSERT_EQ(load.c, 0x42);
+}
+
+TEST(ExecutionTraceTest, TestRingKeepsNewestRecords) {
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    SM83State state(memory.data());
+    SM83Emulator emulator(&state);
+
+    // Rounded up to 4
+    ExecutionTrace trace(3, memory.data());
+    ASSERT_EQ(trace.capacity(), 4u);
+
+    state.setProgramCounter(0x100);
+    emulator.SetTrace(&trace);
+    for (int i = 0; i < 6; i++) {
+        emulator.Step();
+    }
+
+    ASSERT_EQ(trace.size(), 4u);
+    for (size_t i = 0; i < trace.size(); i++) {
+        ASSERT_EQ(trace.at(i).pc, 0x102 + i);
+    }
+
+    trace.Clear();
+    ASSERT_EQ(trace.size(), 0u);
+}
+
+TEST(ExecutionTraceTest, TestToggle) {
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    SM83State state(memory.data());
+    SM83Emulator emulator(&state);
+    ExecutionTrace trace(16, memory.data());
+    state.setProgramCounter(0x100);
+
+    emulator.Step();
+    emulator.SetTrace(&trace);
+    emulator.Step();
+    emulator.SetTrace(nullptr);
+    emulator.Step();
+
+    ASSERT_EQ(emulator.trace(), nullptr);
+    ASSERT_EQ(trace.size(), 1u);
+    ASSERT_EQ(trace.at(0).pc, 0x101);
+}
+
+TEST(ExecutionTraceTest, TestSaveAndLoad) {
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    SM83State state(memory.data());
+    SM83Emulator emulator(&state);
+    ExecutionTrace trace(4, memory.data());
+    state.setProgramCounter(0x100);
+
+    // Wraps the ring partway so the file is written in two runs
+    emulator.SetTrace(&trace);
+    for (int i = 0; i < 6; i++) {
+        emulator.Step();
+    }
+
+    std::string path = testing::TempDir() + "lameboy_trace.bin";
+    ASSERT_TRUE(trace.Save(path.c_str()));
+
+    TraceFileHeader header;
+    std::vector<TraceRecord> records;
+    ASSERT_TRUE(LoadTrace(path.c_str(), &header, &records));
+    ASSERT_EQ(header.record_count, 4u);
+    // The two dropped NOPs ran before the oldest record
+    ASSERT_EQ(header.first_cycle, 8u);
+    ASSERT_EQ(records.size(), 4u);
+    for (size_t i = 0; i < records.size(); i++) {
+        ASSERT_EQ(records[i].pc, 0x102 + i);
+    }
+
+    // A truncated trace, or one counting more records than it holds, is rejected before anything is allocated
+    FILE* file = fopen(path.c_str(), "r+b");
+    header.record_count = 0xFFFFFFFF;
+    fwrite(&header, sizeof(header), 1, file);
+    fclose(file);
+    ASSERT_FALSE(LoadTrace(path.c_str(), &header, &records));
+
+    // A file that is not a trace is rejected
+    file = fopen(path.c_str(), "wb");
+    fprintf(file, "not a trace at all, but long enough to have a header");
+    fclose(file);
+    ASSERT_FALSE(LoadTrace(path.c_str(), &header, &records));
+    remove(path.c_str());
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
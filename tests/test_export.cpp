@@ -0,0 +1,194 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/export/async_file_writer.hpp"
+#include "../src/export/wav_writer.hpp"
+#include "../src/export/y4m_writer.hpp"
+
+namespace {
+
+static std::vector<uint8_t> ReadFile(const std::string& path) {
+    std::vector<uint8_t> contents;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return contents;
+    }
+
+    uint8_t chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        contents.insert(contents.end(), chunk, chunk + read);
+    }
+    fclose(file);
+    return contents;
+}
+
+static uint32_t Get32(const uint8_t* data) {
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static uint16_t Get16(const uint8_t* data) {
+    return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+TEST(AsyncFileWriterTest, TestWritesSpanningBuffers) {
+    std::string path = testing::TempDir() + "lameboy_async_writer.bin";
+
+    // Small buffers so writes straddle buffer boundaries and the producer has to wait
+    AsyncFileWriter writer(64, 2);
+    ASSERT_TRUE(writer.Open(path.c_str()));
+
+    std::vector<uint8_t> expected;
+    uint8_t value = 0;
+    for (size_t size = 1; size < 200; size += 7) {
+        std::vector<uint8_t> data(size);
+        for (size_t i = 0; i < size; i++) {
+            data[i] = value++;
+        }
+        writer.Write(data.data(), data.size());
+        expected.insert(expected.end(), data.begin(), data.end());
+    }
+
+    ASSERT_TRUE(writer.Close());
+    ASSERT_EQ(writer.bytesWritten(), expected.size());
+    ASSERT_EQ(ReadFile(path), expected);
+    remove(path.c_str());
+}
+
+TEST(AsyncFileWriterTest, TestRewrite) {
+    std::string path = testing::TempDir() + "lameboy_async_rewrite.bin";
+    AsyncFileWriter writer(16, 4);
+    ASSERT_TRUE(writer.Open(path.c_str()));
+
+    writer.Write("0000abcdefgh", 12);
+    ASSERT_TRUE(writer.Rewrite(0, "1234", 4));
+
+    // Writes after a rewrite continue at the end of the file
+    writer.Write("ij", 2);
+    ASSERT_TRUE(writer.Close());
+
+    std::vector<uint8_t> contents = ReadFile(path);
+    ASSERT_EQ(std::string(contents.begin(), contents.end()), "1234abcdefghij");
+    remove(path.c_str());
+}
+
+TEST(AsyncFileWriterTest, TestReserveLargerThanABuffer) {
+    std::string path = testing::TempDir() + "lameboy_async_reserve.bin";
+    AsyncFileWriter writer(16, 2);
+    ASSERT_TRUE(writer.Open(path.c_str()));
+
+    ASSERT_EQ(writer.Reserve(17), nullptr);
+
+    uint8_t* out = writer.Reserve(16);
+    ASSERT_NE(out, nullptr);
+    memcpy(out, "0123456789abcdef", 16);
+    writer.Commit(16);
+    ASSERT_TRUE(writer.Close());
+
+    std::vector<uint8_t> contents = ReadFile(path);
+    ASSERT_EQ(std::string(contents.begin(), contents.end()), "0123456789abcdef");
+    remove(path.c_str());
+}
+
+TEST(AsyncFileWriterTest, TestOpenFailure) {
+    AsyncFileWriter writer(16, 2);
+    ASSERT_FALSE(writer.Open("/nonexistent-directory/file.bin"));
+}
+
+TEST(WavWriterTest, TestHeaderAndSamples) {
+    std::string path = testing::TempDir() + "lameboy_export.wav";
+    WavWriter wav(48000);
+    ASSERT_TRUE(wav.Open(path.c_str()));
+
+    float samples[6] = { 0.0f, 1.0f, -1.0f, 0.5f, 2.0f, -2.0f };
+    wav.WriteSamples(samples, 3);
+    ASSERT_TRUE(wav.Close());
+    ASSERT_EQ(wav.samplesWritten(), 3u);
+
+    std::vector<uint8_t> contents = ReadFile(path);
+    ASSERT_EQ(contents.size(), WAV_HEADER_SIZE + 12);
+    const uint8_t* header = contents.data();
+
+    ASSERT_EQ(memcmp(header, "RIFF", 4), 0);
+    ASSERT_EQ(Get32(header + 4), contents.size() - 8);
+    ASSERT_EQ(memcmp(header + 8, "WAVEfmt ", 8), 0);
+    ASSERT_EQ(Get16(header + 22), 2);
+    ASSERT_EQ(Get32(header + 24), 48000u);
+    ASSERT_EQ(Get32(header + 28), 48000u * 4);
+    ASSERT_EQ(Get16(header + 34), 16);
+    ASSERT_EQ(memcmp(header + 36, "data", 4), 0);
+    ASSERT_EQ(Get32(header + 40), 12u);
+
+    // Out of range samples are clamped
+    const int16_t expected[6] = { 0, 32767, -32767, 16383, 32767, -32767 };
+    for (int i = 0; i < 6; i++) {
+        ASSERT_EQ((int16_t)Get16(header + WAV_HEADER_SIZE + i * 2), expected[i]);
+    }
+    remove(path.c_str());
+}
+
+TEST(Y4MWriterTest, TestHeaderAndFrames) {
+    std::string path = testing::TempDir() + "lameboy_export.y4m";
+    Y4MWriter y4m(4, 2, 4194304, 70224);
+    ASSERT_TRUE(y4m.Open(path.c_str()));
+
+    // Black on the left, white on the right
+    const uint32_t pixels[8] = {
+        0xFF000000, 0xFF000000, 0xFFFFFFFF, 0xFFFFFFFF,
+        0xFF000000, 0xFF000000, 0xFFFFFFFF, 0xFFFFFFFF,
+    };
+    y4m.WriteFrame(pixels);
+    y4m.WriteFrame(pixels);
+    ASSERT_TRUE(y4m.Close());
+    ASSERT_EQ(y4m.framesWritten(), 2u);
+
+    std::vector<uint8_t> contents = ReadFile(path);
+    std::string header = "YUV4MPEG2 W4 H2 F4194304:70224 Ip A1:1 C420jpeg\n";
+    size_t frame_size = 6 + 8 + 2 + 2;
+    ASSERT_EQ(contents.size(), header.size() + frame_size * 2);
+    ASSERT_EQ(std::string(contents.begin(), contents.begin() + header.size()), header);
+
+    const uint8_t* frame = contents.data() + header.size();
+    ASSERT_EQ(memcmp(frame, "FRAME\n", 6), 0);
+
+    // Studio range luma, neutral chroma for greys
+    const uint8_t expected[12] = { 16, 16, 235, 235, 16, 16, 235, 235, 128, 128, 128, 128 };
+    ASSERT_EQ(memcmp(frame + 6, expected, sizeof(expected)), 0);
+    ASSERT_EQ(memcmp(frame + frame_size, frame, frame_size), 0);
+    remove(path.c_str());
+}
+
+TEST(Y4MWriterTest, TestFrameLargerThanABuffer) {
+    std::string path = testing::TempDir() + "lameboy_export_large.y4m";
+    const int width = 2048;
+    const int height = 2048;
+    Y4MWriter y4m(width, height, 60, 1);
+    ASSERT_TRUE(y4m.Open(path.c_str()));
+
+    // A frame over DEFAULT_WRITE_BUFFER_SIZE cannot be reserved, so it is written in pieces
+    std::vector<uint32_t> pixels((size_t)width * height, 0xFFFFFFFF);
+    y4m.WriteFrame(pixels.data());
+    y4m.WriteFrame(pixels.data());
+    ASSERT_TRUE(y4m.Close());
+
+    std::vector<uint8_t> contents = ReadFile(path);
+    std::string header = "YUV4MPEG2 W2048 H2048 F60:1 Ip A1:1 C420jpeg\n";
+    size_t frame_size = 6 + (size_t)width * height * 3 / 2;
+    ASSERT_GT(frame_size, DEFAULT_WRITE_BUFFER_SIZE);
+    ASSERT_EQ(contents.size(), header.size() + frame_size * 2);
+
+    const uint8_t* frame = contents.data() + header.size() + frame_size;
+    ASSERT_EQ(memcmp(frame, "FRAME\n", 6), 0);
+    ASSERT_EQ(frame[6], 235);
+    ASSERT_EQ(frame[frame_size - 1], 128);
+    remove(path.c_str());
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
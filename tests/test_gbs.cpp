@@ -0,0 +1,189 @@
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/core/gbs_player.hpp"
+#include "../src/ppu/ppu_registers.hpp"
+
+namespace {
+
+static const uint16_t LOAD_ADDRESS = 0x0400;
+static const uint16_t PLAY_ADDRESS = 0x0440;
+
+// HRAM used by the test routines
+static const uint16_t SONG_ADDRESS = 0xFF80;
+static const uint16_t PLAY_COUNT_ADDRESS = 0xFF81;
+
+// INIT stores the song number, then starts a square wave on channel 2
+static const uint8_t INIT_CODE[] = {
+    0x06, 0xFF,        // LD B, 0xFF
+    0x0E, 0x80,        // LD C, 0x80
+    0x02,              // LD (BC), A
+    0x26, 0xFF,        // LD H, 0xFF
+    0x2E, 0x16,        // LD L, 0x16
+    0x36, 0x80,        // LD (HL), 0x80
+    0x2E, 0x17,        // LD L, 0x17
+    0x36, 0xF0,        // LD (HL), 0xF0
+    0x2E, 0x18,        // LD L, 0x18
+    0x36, 0x00,        // LD (HL), 0x00
+    0x2E, 0x19,        // LD L, 0x19
+    0x36, 0x87,        // LD (HL), 0x87
+    0xC9               // RET
+};
+
+// PLAY counts how many times it has been called
+static const uint8_t PLAY_CODE[] = {
+    0x26, 0xFF,        // LD H, 0xFF
+    0x2E, 0x81,        // LD L, 0x81
+    0x34,              // INC (HL)
+    0xC9               // RET
+};
+
+/**
+ * @brief Builds a GBS file running INIT_CODE and PLAY_CODE
+ *
+ * @param timer_modulo The TMA field
+ * @param timer_control The TAC field
+ * @param size The size of the data after the header
+ */
+static std::vector<uint8_t> BuildGBS(uint8_t timer_modulo, uint8_t timer_control, size_t size = 0x100) {
+    std::vector<uint8_t> file(GBS_HEADER_SIZE + size, 0x00);
+    memcpy(file.data(), "GBS", 3);
+    file[0x03] = 1;
+    file[0x04] = 3;
+    file[0x05] = 1;
+    file[0x06] = (uint8_t)LOAD_ADDRESS;
+    file[0x07] = (uint8_t)(LOAD_ADDRESS >> 8);
+    file[0x08] = (uint8_t)LOAD_ADDRESS;
+    file[0x09] = (uint8_t)(LOAD_ADDRESS >> 8);
+    file[0x0A] = (uint8_t)PLAY_ADDRESS;
+    file[0x0B] = (uint8_t)(PLAY_ADDRESS >> 8);
+    file[0x0C] = 0xFE;
+    file[0x0D] = 0xFF;
+    file[0x0E] = timer_modulo;
+    file[0x0F] = timer_control;
+    memcpy(file.data() + 0x10, "Test Song", 9);
+
+    memcpy(file.data() + GBS_HEADER_SIZE, INIT_CODE, sizeof(INIT_CODE));
+    memcpy(file.data() + GBS_HEADER_SIZE + (PLAY_ADDRESS - LOAD_ADDRESS), PLAY_CODE, sizeof(PLAY_CODE));
+    return file;
+}
+
+TEST(GBSPlayerTest, TestParseHeader) {
+    std::vector<uint8_t> file = BuildGBS(0xC0, 0x04);
+    GBSHeader header;
+
+    ASSERT_TRUE(ParseGBSHeader(file.data(), file.size(), &header));
+    ASSERT_EQ(header.song_count, 3);
+    ASSERT_EQ(header.first_song, 1);
+    ASSERT_EQ(header.load_address, LOAD_ADDRESS);
+    ASSERT_EQ(header.play_address, PLAY_ADDRESS);
+    ASSERT_EQ(header.stack_pointer, 0xFFFE);
+    ASSERT_EQ(header.timer_modulo, 0xC0);
+    ASSERT_EQ(header.timer_control, 0x04);
+    ASSERT_STREQ(header.title, "Test Song");
+    ASSERT_STREQ(header.author, "");
+
+    // Truncated, wrong magic and code loaded over the return address
+    ASSERT_FALSE(ParseGBSHeader(file.data(), GBS_HEADER_SIZE, &header));
+    file[0] = 'X';
+    ASSERT_FALSE(ParseGBSHeader(file.data(), file.size(), &header));
+    file[0] = 'G';
+    file[0x07] = 0x00;
+    ASSERT_FALSE(ParseGBSHeader(file.data(), file.size(), &header));
+}
+
+TEST(GBSPlayerTest, TestInitReceivesSong) {
+    std::vector<uint8_t> file = BuildGBS(0, 0);
+    GBSPlayer player;
+
+    ASSERT_FALSE(player.StartSong(0));
+    ASSERT_TRUE(player.Load(file.data(), file.size()));
+
+    ASSERT_TRUE(player.StartSong(2));
+    ASSERT_EQ(player.memory()[SONG_ADDRESS], 2);
+    ASSERT_FALSE(player.StartSong(3));
+}
+
+TEST(GBSPlayerTest, TestPlayAtVerticalBlankRate) {
+    std::vector<uint8_t> file = BuildGBS(0, 0);
+    GBSPlayer player;
+    ASSERT_TRUE(player.Load(file.data(), file.size()));
+    ASSERT_TRUE(player.StartSong(0));
+
+    ASSERT_EQ(player.playPeriod(), DOTS_PER_FRAME);
+    player.Run((uint64_t)DOTS_PER_FRAME * 60);
+    ASSERT_EQ(player.memory()[PLAY_COUNT_ADDRESS], 60);
+}
+
+TEST(GBSPlayerTest, TestPlayAtTimerRate) {
+    // 4096Hz timer reloaded from 0xC0, so PLAY every 1024 x 64 dots
+    std::vector<uint8_t> file = BuildGBS(0xC0, GBS_TIMER_PLAY);
+    GBSPlayer player;
+    ASSERT_TRUE(player.Load(file.data(), file.size()));
+    ASSERT_TRUE(player.StartSong(0));
+
+    ASSERT_EQ(player.playPeriod(), 65536u);
+    player.Run(65536 * 10);
+    ASSERT_EQ(player.memory()[PLAY_COUNT_ADDRESS], 10);
+}
+
+TEST(GBSPlayerTest, TestProducesAudio) {
+    std::vector<uint8_t> file = BuildGBS(0, 0);
+    GBSPlayer player(48000);
+    ASSERT_TRUE(player.Load(file.data(), file.size()));
+    ASSERT_TRUE(player.StartSong(0));
+
+    // A second of playback, read a frame at a time as the player only holds a few frames
+    std::vector<float> samples;
+    std::vector<float> frame(4096);
+    for (int i = 0; i < 60; i++) {
+        player.Run(DOTS_PER_FRAME);
+        size_t count = player.ReadAudio(frame.data(), frame.size() / 2);
+        samples.insert(samples.end(), frame.begin(), frame.begin() + count * 2);
+    }
+    ASSERT_NEAR((double)samples.size() / 2, 48000.0 * 60 * DOTS_PER_FRAME / 4194304, 48.0);
+
+    double energy = 0;
+    for (float sample : samples) {
+        energy += sample * sample;
+    }
+    ASSERT_GT(energy / samples.size(), 1e-3);
+}
+
+TEST(GBSPlayerTest, TestBankSwitching) {
+    // Three banks of data with a marker at the start of bank 2
+    std::vector<uint8_t> file = BuildGBS(0, 0, 0xC000 - LOAD_ADDRESS);
+    file[GBS_HEADER_SIZE + 0x8000 - LOAD_ADDRESS] = 0x42;
+
+    // INIT selects bank 2 instead of starting a tone
+    const uint8_t select_bank[] = { 0x26, 0x20, 0x2E, 0x00, 0x36, 0x02, 0xC9 };
+    memcpy(file.data() + GBS_HEADER_SIZE, select_bank, sizeof(select_bank));
+
+    GBSPlayer player;
+    ASSERT_TRUE(player.Load(file.data(), file.size()));
+    ASSERT_TRUE(player.StartSong(0));
+
+    ASSERT_EQ(player.memory()[0x4000], 0x42);
+    // The write itself did not change the ROM
+    ASSERT_EQ(player.memory()[0x2000], 0x00);
+}
+
+TEST(GBSPlayerTest, TestRunawayRoutineThrows) {
+    std::vector<uint8_t> file = BuildGBS(0, 0);
+    // INIT jumps to itself forever
+    file[GBS_HEADER_SIZE] = 0x18;
+    file[GBS_HEADER_SIZE + 1] = 0xFE;
+
+    GBSPlayer player;
+    ASSERT_TRUE(player.Load(file.data(), file.size()));
+    ASSERT_THROW(player.StartSong(0), std::runtime_error);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
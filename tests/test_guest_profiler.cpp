@@ -0,0 +1,213 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/cpu/guest_profiler.hpp"
+#include "../src/cpu/sm83_emulator.hpp"
+
+namespace {
+
+static std::string Folded(GuestProfiler* profiler, const SymbolTable* symbols = nullptr) {
+    std::string path = testing::TempDir() + "lameboy_guest_profiler.folded";
+    FILE* file = fopen(path.c_str(), "w+");
+    profiler->WriteFolded(file, symbols);
+    rewind(file);
+
+    std::string folded;
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), file) != nullptr) {
+        folded += buffer;
+    }
+    fclose(file);
+    remove(path.c_str());
+    return folded;
+}
+
+// 0100 calls 4100, which calls 0300, which runs 4 NOPs and returns
+static void WriteNestedCalls(uint8_t* memory) {
+    const uint8_t main[] = { 0xCD, 0x00, 0x41 };
+    const uint8_t outer[] = { 0xCD, 0x00, 0x03, 0xC9 };
+    const uint8_t inner[] = { 0x00, 0x00, 0x00, 0x00, 0xC9 };
+    memcpy(memory + 0x0100, main, sizeof(main));
+    memcpy(memory + 0x4100, outer, sizeof(outer));
+    memcpy(memory + 0x0300, inner, sizeof(inner));
+}
+
+TEST(GuestProfilerTest, TestFoldedStacks) {
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    SM83State state(memory.data());
+    SM83Emulator emulator(&state);
+    WriteNestedCalls(memory.data());
+    state.setStackPointer(0xDFFE);
+    state.setProgramCounter(0x0100);
+
+    // One sample every 4 cycles, so each instruction is weighted by its length
+    GuestProfiler profiler(4);
+    ASSERT_TRUE(emulator.AddInstructionObserver(&profiler));
+
+    emulator.Step();
+    ASSERT_EQ(profiler.depth(), 1u);
+    emulator.Step();
+    ASSERT_EQ(profiler.depth(), 2u);
+    for (int i = 0; i < 5; i++) {
+        emulator.Step();
+    }
+    ASSERT_EQ(profiler.depth(), 1u);
+    emulator.Step();
+    ASSERT_EQ(profiler.depth(), 0u);
+    ASSERT_EQ(state.programCounter(), 0x0103);
+
+    // CALL 24 + CALL 24 + 4 NOPs + RET 16 + RET 16 cycles
+    ASSERT_EQ(profiler.samples(), 24u / 4 + 24 / 4 + 4 + 16 / 4 + 16 / 4);
+    ASSERT_EQ(Folded(&profiler),
+        "00:0103 4\n"
+        "01:4100;00:0300;00:0300 6\n"
+        "01:4100;00:0300;00:0301 1\n"
+        "01:4100;00:0300;00:0302 1\n"
+        "01:4100;00:0300;00:0303 1\n"
+        "01:4100;00:0300;00:0304 1\n"
+        "01:4100;01:4100 6\n"
+        "01:4100;01:4103 4\n");
+}
+
+TEST(GuestProfilerTest, TestFramesUseLabels) {
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    SM83State state(memory.data());
+    SM83Emulator emulator(&state);
+    WriteNestedCalls(memory.data());
+    state.setStackPointer(0xDFFE);
+    state.setProgramCounter(0x0100);
+
+    GuestProfiler profiler(4);
+    ASSERT_TRUE(emulator.AddInstructionObserver(&profiler));
+    for (int i = 0; i < 3; i++) {
+        emulator.Step();
+    }
+
+    SymbolTable symbols;
+    symbols.Add(0x01, 0x4100, "Outer");
+    symbols.Add(0x00, 0x0300, "Inner");
+    ASSERT_EQ(Folded(&profiler, &symbols),
+        "Outer;Inner;Inner 6\n"
+        "Outer;Inner;00:0301 1\n"
+        "Outer;Outer 6\n");
+}
+
+TEST(GuestProfilerTest, TestSamplePeriod) {
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    SM83State state(memory.data());
+    SM83Emulator emulator(&state);
+    state.setProgramCounter(0x0100);
+
+    GuestProfiler profiler(100);
+    emulator.AddInstructionObserver(&profiler);
+    for (int i = 0; i < 1000; i++) {
+        emulator.Step();
+    }
+
+    // 4000 cycles of NOPs
+    ASSERT_EQ(profiler.samples(), 40u);
+
+    profiler.Clear();
+    ASSERT_EQ(profiler.samples(), 0u);
+    ASSERT_EQ(Folded(&profiler), "");
+}
+
+TEST(GuestProfilerTest, TestConditionalCallsAndUnwinding) {
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    SM83State state(memory.data());
+    GuestProfiler profiler(1000);
+
+    // CALL NZ not taken falls through to the next instruction and pushes nothing
+    state.setStackPointer(0xDFFE);
+    state.setProgramCounter(0x0203);
+    profiler.OnInstruction(0x0200, 0xC4, 12, &state);
+    ASSERT_EQ(profiler.depth(), 0u);
+
+    // RST 38 and CALL Z taken
+    state.setStackPointer(0xDFFC);
+    state.setProgramCounter(0x0038);
+    profiler.OnInstruction(0x0203, 0xFF, 16, &state);
+    state.setStackPointer(0xDFFA);
+    state.setProgramCounter(0x1234);
+    profiler.OnInstruction(0x0038, 0xCC, 24, &state);
+    ASSERT_EQ(profiler.depth(), 2u);
+
+    // Reloading SP past both return addresses drops both frames
+    state.setStackPointer(0xDFFE);
+    state.setProgramCounter(0x1235);
+    profiler.OnInstruction(0x1234, 0xF9, 8, &state);
+    ASSERT_EQ(profiler.depth(), 0u);
+}
+
+TEST(GuestProfilerTest, TestDoesNotChangeExecution) {
+    std::vector<uint8_t> plain_memory(0x10000, 0x00);
+    std::vector<uint8_t> profiled_memory(0x10000, 0x00);
+    SM83State plain(plain_memory.data());
+    SM83State profiled(profiled_memory.data());
+    SM83Emulator plain_cpu(&plain);
+    SM83Emulator profiled_cpu(&profiled);
+    WriteNestedCalls(plain_memory.data());
+    WriteNestedCalls(profiled_memory.data());
+
+    // The constructor leaves registers undefined, so both start from the same values
+    SM83State* states[] = {&plain, &profiled};
+    for (SM83State* state : states) {
+        state->setAF(0x01B0);
+        state->setBC(0x0013);
+        state->setDE(0x00D8);
+        state->setHL(0x014D);
+    }
+    plain.setStackPointer(0xDFFE);
+    profiled.setStackPointer(0xDFFE);
+    plain.setProgramCounter(0x0100);
+    profiled.setProgramCounter(0x0100);
+
+    GuestProfiler profiler(1);
+    profiled_cpu.AddInstructionObserver(&profiler);
+
+    uint64_t plain_cycles = 0;
+    uint64_t profiled_cycles = 0;
+    for (int i = 0; i < 20; i++) {
+        plain_cycles += plain_cpu.Step();
+        profiled_cycles += profiled_cpu.Step();
+    }
+
+    ASSERT_EQ(plain_cycles, profiled_cycles);
+    ASSERT_EQ(plain.programCounter(), profiled.programCounter());
+    ASSERT_EQ(plain.stackPointer(), profiled.stackPointer());
+    ASSERT_EQ(plain.af(), profiled.af());
+    ASSERT_EQ(plain.bc(), profiled.bc());
+    ASSERT_EQ(plain.de(), profiled.de());
+    ASSERT_EQ(plain.hl(), profiled.hl());
+    ASSERT_EQ(plain_memory, profiled_memory);
+}
+
+TEST(GuestProfilerTest, TestObserverSlots) {
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    SM83State state(memory.data());
+    SM83Emulator emulator(&state);
+    state.setProgramCounter(0x0100);
+
+    GuestProfiler profilers[MAX_INSTRUCTION_OBSERVERS + 1] = {
+        GuestProfiler(4), GuestProfiler(4), GuestProfiler(4), GuestProfiler(4), GuestProfiler(4)
+    };
+    for (uint8_t i = 0; i < MAX_INSTRUCTION_OBSERVERS; i++) {
+        ASSERT_TRUE(emulator.AddInstructionObserver(&profilers[i]));
+    }
+    ASSERT_FALSE(emulator.AddInstructionObserver(&profilers[MAX_INSTRUCTION_OBSERVERS]));
+
+    emulator.RemoveInstructionObserver(&profilers[1]);
+    emulator.Step();
+    ASSERT_EQ(profilers[0].samples(), 1u);
+    ASSERT_EQ(profilers[1].samples(), 0u);
+    ASSERT_EQ(profilers[3].samples(), 1u);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,551 @@
+#include <cstring>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/cpu/sm83_emulator.hpp"
+#include "../src/cpu/sm83_lockstep_kernels.hpp"
+#include "../src/cpu/sm83_state.hpp"
+
+namespace {
+
+// Register values of a reference model step, kept apart from SM83State so nothing is shared with the
+// code under test
+struct Registers {
+    uint8_t a, f, b, c, d, e, h, l;
+    uint16_t sp, pc;
+};
+
+struct MemoryWrite {
+    uint16_t address;
+    uint8_t value;
+};
+
+struct Outcome {
+    Registers registers;
+    uint8_t cycles;
+    std::vector<MemoryWrite> writes;
+};
+
+/**
+ * @brief A deliberately plain SM83 model, written from the op code table rather than from the handlers.
+ *
+ * Op codes are decoded from their bit fields, x = bits 7-6, y = bits 5-3, z = bits 2-0, with
+ * p = y >> 1 and q = y & 1 selecting register pairs. Arithmetic is done in int so carries are just
+ * comparisons against the width. Reads come from memory, writes are only recorded.
+ */
+class ReferenceModel {
+public:
+    ReferenceModel(const Registers& registers, const uint8_t* memory) : memory_(memory) {
+        this->out_.registers = registers;
+        this->out_.cycles = 0;
+    }
+
+    /**
+     * @brief Runs the instruction at PC
+     *
+     * @return true if the model knows the op code
+     */
+    bool Step() {
+        Registers& r = this->out_.registers;
+        uint16_t pc = r.pc;
+        int op = this->Read(pc);
+        int n8 = this->Read(pc + 1);
+        int n16 = this->Read(pc + 2) << 8 | n8;
+        int x = op >> 6;
+        int y = (op >> 3) & 7;
+        int z = op & 7;
+        int p = y >> 1;
+        int q = y & 1;
+
+        if (op == 0xC9) {
+            // RET
+            r.pc = (uint16_t)(this->Read(r.sp + 1) << 8 | this->Read(r.sp));
+            r.sp += 2;
+            return this->Cycles(16);
+        }
+        if (op == 0xCD) {
+            // CALL a16, pushing the address of the next instruction high byte first
+            int next = (pc + 3) & 0xFFFF;
+            this->Write(r.sp - 1, next >> 8);
+            this->Write(r.sp - 2, next & 0xFF);
+            r.sp -= 2;
+            r.pc = (uint16_t)n16;
+            return this->Cycles(24);
+        }
+        if (x != 0) {
+            return false;
+        }
+
+        switch (z) {
+            case 0:
+                if (y == 0) {
+                    r.pc = pc + 1;
+                    return this->Cycles(4);
+                }
+                if (y == 1) {
+                    // LD (a16), SP
+                    this->Write(n16, r.sp & 0xFF);
+                    this->Write(n16 + 1, r.sp >> 8);
+                    r.pc = pc + 3;
+                    return this->Cycles(20);
+                }
+                if (y == 2) {
+                    // STOP is not modelled
+                    return false;
+                }
+                if (y == 3 || this->Condition(y - 4)) {
+                    // JR, relative to the next instruction
+                    r.pc = (uint16_t)(pc + 2 + (int8_t)n8);
+                    return this->Cycles(12);
+                }
+                r.pc = pc + 2;
+                return this->Cycles(8);
+            case 1:
+                if (q == 0) {
+                    this->SetPair(p, n16);
+                    r.pc = pc + 3;
+                    return this->Cycles(12);
+                } else {
+                    // ADD HL, rr
+                    int hl = this->Pair(2);
+                    int value = this->Pair(p);
+                    int sum = hl + value;
+                    bool half = (hl & 0xFFF) + (value & 0xFFF) > 0xFFF;
+                    this->SetFlags(this->Flag(7), false, half, sum > 0xFFFF);
+                    this->SetPair(2, sum);
+                    r.pc = pc + 1;
+                    return this->Cycles(8);
+                }
+            case 2: {
+                // LD (BC), A / LD (DE), A / LD (HL+), A / LD (HL-), A and the loads back into A
+                int address = this->Pair(p < 2 ? p : 2);
+                if (q == 0) {
+                    this->Write(address, r.a);
+                } else {
+                    r.a = (uint8_t)this->Read(address);
+                }
+                if (p == 2) {
+                    this->SetPair(2, address + 1);
+                } else if (p == 3) {
+                    this->SetPair(2, address - 1);
+                }
+                r.pc = pc + 1;
+                return this->Cycles(8);
+            }
+            case 3:
+                this->SetPair(p, this->Pair(p) + (q == 0 ? 1 : -1));
+                r.pc = pc + 1;
+                return this->Cycles(8);
+            case 4: {
+                // INC r, C is unaffected
+                int value = this->Register(y);
+                this->SetRegister(y, value + 1);
+                this->SetFlags(((value + 1) & 0xFF) == 0, false, (value & 0xF) == 0xF, this->Flag(4));
+                r.pc = pc + 1;
+                return this->Cycles(y == 6 ? 12 : 4);
+            }
+            case 5: {
+                // DEC r, C is unaffected
+                int value = this->Register(y);
+                this->SetRegister(y, value - 1);
+                this->SetFlags(((value - 1) & 0xFF) == 0, true, (value & 0xF) == 0, this->Flag(4));
+                r.pc = pc + 1;
+                return this->Cycles(y == 6 ? 12 : 4);
+            }
+            case 6:
+                this->SetRegister(y, n8);
+                r.pc = pc + 2;
+                return this->Cycles(y == 6 ? 12 : 8);
+            default:
+                r.pc = pc + 1;
+                return this->Accumulator(y) && this->Cycles(4);
+        }
+    }
+
+    const Outcome& outcome() {
+        return this->out_;
+    }
+
+private:
+    const uint8_t* memory_;
+    Outcome out_;
+
+    bool Cycles(int cycles) {
+        this->out_.cycles = (uint8_t)cycles;
+        return true;
+    }
+
+    int Read(int address) {
+        return this->memory_[address & 0xFFFF];
+    }
+
+    void Write(int address, int value) {
+        this->out_.writes.push_back(MemoryWrite{ (uint16_t)(address & 0xFFFF), (uint8_t)value });
+    }
+
+    bool Flag(int bit) {
+        return (this->out_.registers.f >> bit & 1) != 0;
+    }
+
+    void SetFlags(bool z, bool n, bool h, bool c) {
+        this->out_.registers.f = (uint8_t)(z << 7 | n << 6 | h << 5 | c << 4);
+    }
+
+    bool Condition(int cc) {
+        // NZ, Z, NC, C
+        bool flag = cc < 2 ? this->Flag(7) : this->Flag(4);
+        return (cc & 1) == 1 ? flag : !flag;
+    }
+
+    // BC, DE, HL, SP
+    int Pair(int p) {
+        Registers& r = this->out_.registers;
+        switch (p) {
+            case 0: return r.b << 8 | r.c;
+            case 1: return r.d << 8 | r.e;
+            case 2: return r.h << 8 | r.l;
+            default: return r.sp;
+        }
+    }
+
+    void SetPair(int p, int value) {
+        Registers& r = this->out_.registers;
+        value &= 0xFFFF;
+        switch (p) {
+            case 0: r.b = (uint8_t)(value >> 8); r.c = (uint8_t)value; break;
+            case 1: r.d = (uint8_t)(value >> 8); r.e = (uint8_t)value; break;
+            case 2: r.h = (uint8_t)(value >> 8); r.l = (uint8_t)value; break;
+            default: r.sp = (uint16_t)value; break;
+        }
+    }
+
+    // B, C, D, E, H, L, (HL), A
+    int Register(int index) {
+        Registers& r = this->out_.registers;
+        uint8_t* registers[8] = { &r.b, &r.c, &r.d, &r.e, &r.h, &r.l, nullptr, &r.a };
+        return index == 6 ? this->Read(this->Pair(2)) : *registers[index];
+    }
+
+    void SetRegister(int index, int value) {
+        Registers& r = this->out_.registers;
+        uint8_t* registers[8] = { &r.b, &r.c, &r.d, &r.e, &r.h, &r.l, nullptr, &r.a };
+        if (index == 6) {
+            this->Write(this->Pair(2), value & 0xFF);
+        } else {
+            *registers[index] = (uint8_t)value;
+        }
+    }
+
+    // RLCA, RRCA, RLA, RRA, DAA, CPL, SCF, CCF
+    bool Accumulator(int y) {
+        Registers& r = this->out_.registers;
+        int a = r.a;
+        bool carry = this->Flag(4);
+
+        switch (y) {
+            case 0:
+                r.a = (uint8_t)(a << 1 | a >> 7);
+                this->SetFlags(false, false, false, (a & 0x80) != 0);
+                return true;
+            case 1:
+                r.a = (uint8_t)(a >> 1 | a << 7);
+                this->SetFlags(false, false, false, (a & 1) != 0);
+                return true;
+            case 2:
+                r.a = (uint8_t)(a << 1 | carry);
+                this->SetFlags(false, false, false, (a & 0x80) != 0);
+                return true;
+            case 3:
+                r.a = (uint8_t)(a >> 1 | carry << 7);
+                this->SetFlags(false, false, false, (a & 1) != 0);
+                return true;
+            case 4: {
+                // The correction undoes whichever nibbles overflowed a decimal digit
+                int correction = 0;
+                if (this->Flag(6)) {
+                    correction |= this->Flag(5) ? 0x06 : 0;
+                    correction |= carry ? 0x60 : 0;
+                    a -= correction;
+                } else {
+                    correction |= this->Flag(5) || (a & 0xF) > 9 ? 0x06 : 0;
+                    if (carry || a > 0x99) {
+                        correction |= 0x60;
+                        carry = true;
+                    }
+                    a += correction;
+                }
+                r.a = (uint8_t)a;
+                this->SetFlags(r.a == 0, this->Flag(6), false, carry);
+                return true;
+            }
+            case 5:
+                r.a = (uint8_t)~a;
+                this->SetFlags(this->Flag(7), true, true, carry);
+                return true;
+            case 6:
+                this->SetFlags(this->Flag(7), false, false, true);
+                return true;
+            default:
+                this->SetFlags(this->Flag(7), false, false, !carry);
+                return true;
+        }
+    }
+};
+
+// Records every write the handler under test makes
+class WriteLog : public MemoryObserver {
+public:
+    std::vector<MemoryWrite> writes;
+
+    void OnMemoryWrite(uint16_t address, uint8_t value) override {
+        this->writes.push_back(MemoryWrite{ address, value });
+    }
+};
+
+Registers RandomRegisters(std::mt19937* random) {
+    Registers r;
+    uint32_t bits = (*random)();
+    r.a = (uint8_t)bits;
+    // The low nibble of F always reads as zero
+    r.f = (uint8_t)(bits >> 8 & 0xF0);
+    r.b = (uint8_t)(bits >> 16);
+    r.c = (uint8_t)(bits >> 24);
+    bits = (*random)();
+    r.d = (uint8_t)bits;
+    r.e = (uint8_t)(bits >> 8);
+    r.h = (uint8_t)(bits >> 16);
+    r.l = (uint8_t)(bits >> 24);
+    bits = (*random)();
+    r.sp = (uint16_t)bits;
+    r.pc = (uint16_t)(bits >> 16);
+    return r;
+}
+
+// Every 8 bit register and operand set to value, so each 8 bit op code sees every input with every flag
+Registers UniformRegisters(uint8_t value, uint8_t flags, std::mt19937* random) {
+    Registers r = RandomRegisters(random);
+    r.a = r.b = r.c = r.d = r.e = r.h = r.l = value;
+    r.f = (uint8_t)(flags << 4);
+    return r;
+}
+
+void LoadRegisters(const Registers& r, SM83State* state) {
+    state->setA(r.a);
+    state->setF(r.f);
+    state->setB(r.b);
+    state->setC(r.c);
+    state->setD(r.d);
+    state->setE(r.e);
+    state->setH(r.h);
+    state->setL(r.l);
+    state->setStackPointer(r.sp);
+    state->setProgramCounter(r.pc);
+}
+
+std::vector<uint8_t> ImplementedOpCodes() {
+    std::vector<uint8_t> op_codes;
+    for (int op_code = 0; op_code < 0x100; op_code++) {
+        if (OpCodeHandlerFor((uint8_t)op_code) != nullptr) {
+            op_codes.push_back((uint8_t)op_code);
+        }
+    }
+    return op_codes;
+}
+
+/**
+ * @brief Runs one instruction through its handler and the reference model and compares everything
+ *
+ * @param memory The bus, with the op code at the PC of the registers
+ * @param state A state over memory, with a WriteLog watching every page
+ * @param log The WriteLog
+ */
+void ExpectHandlerMatches(const Registers& before, std::vector<uint8_t>* memory, SM83State* state, WriteLog* log) {
+    uint8_t op_code = (*memory)[before.pc];
+    ReferenceModel model(before, memory->data());
+    ASSERT_TRUE(model.Step()) << "No reference for op code " << std::hex << (int)op_code;
+    const Outcome& expected = model.outcome();
+
+    LoadRegisters(before, state);
+    log->writes.clear();
+    uint8_t cycles = OpCodeHandlerFor(op_code)(state);
+
+    const Registers& r = expected.registers;
+    SCOPED_TRACE(testing::Message() << std::hex << "op=" << (int)op_code << " a=" << (int)before.a << " f=" << (int)before.f
+        << " bc=" << (int)(before.b << 8 | before.c) << " de=" << (int)(before.d << 8 | before.e)
+        << " hl=" << (int)(before.h << 8 | before.l) << " sp=" << before.sp << " pc=" << before.pc);
+    ASSERT_EQ((int)state->a(), (int)r.a);
+    ASSERT_EQ((int)state->f(), (int)r.f);
+    ASSERT_EQ(state->bc(), r.b << 8 | r.c);
+    ASSERT_EQ(state->de(), r.d << 8 | r.e);
+    ASSERT_EQ(state->hl(), r.h << 8 | r.l);
+    ASSERT_EQ(state->stackPointer(), r.sp);
+    ASSERT_EQ(state->programCounter(), r.pc);
+    ASSERT_EQ((int)cycles, (int)expected.cycles);
+    ASSERT_EQ(log->writes.size(), expected.writes.size());
+    for (size_t i = 0; i < expected.writes.size(); i++) {
+        ASSERT_EQ(log->writes[i].address, expected.writes[i].address);
+        ASSERT_EQ((int)log->writes[i].value, (int)expected.writes[i].value);
+    }
+}
+
+/**
+ * @brief Places an op code and its operands, and sets the bytes the registers point at
+ *
+ */
+void PlaceInstruction(const Registers& r, uint8_t op_code, uint8_t operand1, uint8_t operand2, uint8_t pointed, uint8_t* memory) {
+    memory[(uint16_t)(r.b << 8 | r.c)] = pointed;
+    memory[(uint16_t)(r.d << 8 | r.e)] = pointed;
+    memory[(uint16_t)(r.h << 8 | r.l)] = pointed;
+    memory[r.pc] = op_code;
+    memory[(uint16_t)(r.pc + 1)] = operand1;
+    memory[(uint16_t)(r.pc + 2)] = operand2;
+}
+
+TEST(OpCodeFuzzTest, TestHandlersMatchReferenceForEveryByteAndFlag) {
+    std::mt19937 random(2024);
+    std::vector<uint8_t> memory(0x10000);
+    for (uint8_t& byte : memory) {
+        byte = (uint8_t)random();
+    }
+    SM83State state(memory.data());
+    WriteLog log;
+    state.AddMemoryObserver(&log, 0x00, 0xFF);
+
+    for (uint8_t op_code : ImplementedOpCodes()) {
+        for (int value = 0; value < 0x100; value++) {
+            for (uint8_t flags = 0; flags < 0x10; flags++) {
+                Registers before = UniformRegisters((uint8_t)value, flags, &random);
+                PlaceInstruction(before, op_code, (uint8_t)value, (uint8_t)random(), (uint8_t)value, memory.data());
+                ExpectHandlerMatches(before, &memory, &state, &log);
+                if (HasFatalFailure()) {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+TEST(OpCodeFuzzTest, TestHandlersMatchReferenceForRandomStates) {
+    std::mt19937 random(7);
+    std::vector<uint8_t> memory(0x10000);
+    for (uint8_t& byte : memory) {
+        byte = (uint8_t)random();
+    }
+    SM83State state(memory.data());
+    WriteLog log;
+    state.AddMemoryObserver(&log, 0x00, 0xFF);
+
+    for (uint8_t op_code : ImplementedOpCodes()) {
+        for (int trial = 0; trial < 8192; trial++) {
+            Registers before = RandomRegisters(&random);
+            PlaceInstruction(before, op_code, (uint8_t)random(), (uint8_t)random(), (uint8_t)random(), memory.data());
+            ExpectHandlerMatches(before, &memory, &state, &log);
+            if (HasFatalFailure()) {
+                return;
+            }
+        }
+    }
+}
+
+// The lane kernels the CPU can run, with the scalar kernel always first
+std::vector<LaneKernel> AvailableKernels() {
+    std::vector<LaneKernel> kernels = { ExecuteLanesScalar };
+#ifdef LAMEBOY_X86
+    if (SIMDLevelSupported(SIMD_AVX2)) {
+        kernels.push_back(ExecuteLanesAVX2);
+    }
+    if (SIMDLevelSupported(SIMD_AVX512)) {
+        kernels.push_back(ExecuteLanesAVX512);
+    }
+#endif
+    return kernels;
+}
+
+/**
+ * @brief Runs one op code on a group of lanes sharing a PC and checks each lane against the reference
+ *
+ * @param lanes The registers of each lane
+ * @param mask The lanes to run, the rest must be left untouched
+ */
+void ExpectKernelMatches(LaneKernel kernel, uint8_t op_code, const Registers* lanes, uint32_t mask,
+                         uint8_t operand1, uint8_t operand2, std::vector<uint8_t>* memory) {
+    uint16_t pc = lanes[0].pc;
+    (*memory)[pc] = op_code;
+    (*memory)[(uint16_t)(pc + 1)] = operand1;
+    (*memory)[(uint16_t)(pc + 2)] = operand2;
+
+    LaneGroup group;
+    for (int lane = 0; lane < LOCKSTEP_LANES; lane++) {
+        const Registers& r = lanes[lane];
+        uint32_t values[LANE_REGISTERS] = { r.a, r.f, r.b, r.c, r.d, r.e, r.h, r.l, r.sp, pc, (uint32_t)lane };
+        for (int i = 0; i < LANE_REGISTERS; i++) {
+            group.registers[i][lane] = values[i];
+        }
+    }
+
+    kernel(&group, mask, LaneOpFor(op_code), operand1, operand2);
+
+    for (int lane = 0; lane < LOCKSTEP_LANES; lane++) {
+        Registers before = lanes[lane];
+        before.pc = pc;
+        ReferenceModel model(before, memory->data());
+        ASSERT_TRUE(model.Step());
+        bool ran = (mask & (1u << lane)) != 0;
+        const Registers& r = ran ? model.outcome().registers : before;
+        uint32_t cycles = (uint32_t)lane + (ran ? model.outcome().cycles : 0);
+
+        SCOPED_TRACE(testing::Message() << std::hex << "op=" << (int)op_code << " lane=" << lane << " a=" << (int)before.a
+            << " f=" << (int)before.f << " operands=" << (int)operand1 << " " << (int)operand2);
+        uint32_t expected[LANE_REGISTERS] = { r.a, r.f, r.b, r.c, r.d, r.e, r.h, r.l, r.sp, r.pc, cycles };
+        for (int i = 0; i < LANE_REGISTERS; i++) {
+            ASSERT_EQ(group.registers[i][lane], expected[i]) << "register row " << i;
+        }
+    }
+}
+
+TEST(OpCodeFuzzTest, TestLaneKernelsMatchReference) {
+    std::mt19937 random(31);
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    Registers lanes[LOCKSTEP_LANES];
+
+    for (LaneKernel kernel : AvailableKernels()) {
+        for (int op_code = 0; op_code < 0x100; op_code++) {
+            if (LaneOpFor((uint8_t)op_code).kind == LANE_OP_SCALAR) {
+                continue;
+            }
+
+            // One group per value with a lane for each combination of flags, every lane running
+            uint16_t pc = (uint16_t)random();
+            for (int value = 0; value < 0x100; value++) {
+                for (int lane = 0; lane < LOCKSTEP_LANES; lane++) {
+                    lanes[lane] = UniformRegisters((uint8_t)value, (uint8_t)lane, &random);
+                    lanes[lane].pc = pc;
+                }
+                ExpectKernelMatches(kernel, (uint8_t)op_code, lanes, 0xFFFF, (uint8_t)value, (uint8_t)random(), &memory);
+                if (HasFatalFailure()) {
+                    return;
+                }
+            }
+
+            // Then random lanes under random masks
+            for (int trial = 0; trial < 256; trial++) {
+                for (int lane = 0; lane < LOCKSTEP_LANES; lane++) {
+                    lanes[lane] = RandomRegisters(&random);
+                    lanes[lane].pc = pc;
+                }
+                uint32_t mask = random() & 0xFFFF;
+                ExpectKernelMatches(kernel, (uint8_t)op_code, lanes, mask, (uint8_t)random(), (uint8_t)random(), &memory);
+                if (HasFatalFailure()) {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,131 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/cpu/op_code_profile.hpp"
+#include "../src/cpu/sm83_emulator.hpp"
+
+namespace {
+
+TEST(OpCodeProfileTest, TestRecord) {
+    OpCodeProfile profile;
+    profile.Record(0x20, 12);
+    profile.Record(0x20, 12);
+    profile.Record(0x20, 8);
+    profile.Record(CB_PROFILE_SLOT + 0x37, 8);
+
+    ASSERT_EQ(profile.executions(0x20), 3u);
+    ASSERT_EQ(profile.cycles(0x20), 32u);
+    ASSERT_EQ(profile.histogram(0x20, 2), 1u);
+    ASSERT_EQ(profile.histogram(0x20, 3), 2u);
+    ASSERT_EQ(profile.executions(CB_PROFILE_SLOT + 0x37), 1u);
+    ASSERT_EQ(profile.executions(0x37), 0u);
+    ASSERT_EQ(profile.totalExecutions(), 4u);
+    ASSERT_EQ(profile.totalCycles(), 40u);
+
+    profile.Clear();
+    ASSERT_EQ(profile.totalExecutions(), 0u);
+    ASSERT_EQ(profile.histogram(0x20, 3), 0u);
+}
+
+TEST(OpCodeProfileTest, TestTopRanksByCycles) {
+    OpCodeProfile profile;
+    for (int i = 0; i < 10; i++) {
+        profile.Record(0x00, 4);
+    }
+    profile.Record(0xCD, 24);
+    profile.Record(0xCD, 24);
+    profile.Record(0x3C, 4);
+    profile.Record(0x01, 12);
+
+    // 00 and 01 tie on 12 cycles against 0xCD's 48, and 00 ran more often
+    uint16_t slots[8];
+    ASSERT_EQ(profile.Top(8, slots), 4u);
+    ASSERT_EQ(slots[0], 0xCD);
+    ASSERT_EQ(slots[1], 0x00);
+    ASSERT_EQ(slots[2], 0x01);
+    ASSERT_EQ(slots[3], 0x3C);
+
+    ASSERT_EQ(profile.Top(2, slots), 2u);
+    ASSERT_EQ(slots[1], 0x00);
+}
+
+TEST(OpCodeProfileTest, TestMerge) {
+    OpCodeProfile first;
+    OpCodeProfile second;
+    first.Record(0x3C, 4);
+    second.Record(0x3C, 4);
+    second.Record(0x34, 12);
+
+    first.Merge(second);
+    ASSERT_EQ(first.executions(0x3C), 2u);
+    ASSERT_EQ(first.cycles(0x34), 12u);
+    ASSERT_EQ(second.executions(0x3C), 1u);
+}
+
+TEST(OpCodeProfileTest, TestReport) {
+    OpCodeProfile profile;
+    profile.Record(0x20, 12);
+    profile.Record(0x20, 8);
+    profile.Record(CB_PROFILE_SLOT + 0x11, 8);
+    profile.Record(0x00, 4);
+
+    std::string path = testing::TempDir() + "lameboy_op_code_profile.txt";
+    FILE* file = fopen(path.c_str(), "w+");
+    ASSERT_NE(file, nullptr);
+    profile.WriteReport(file, 2);
+    rewind(file);
+
+    std::string report;
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), file) != nullptr) {
+        report += buffer;
+    }
+    fclose(file);
+    remove(path.c_str());
+
+    ASSERT_NE(report.find("4 instructions, 32 cycles"), std::string::npos);
+    ASSERT_NE(report.find("8:1 12:1"), std::string::npos);
+    ASSERT_NE(report.find("CB 11"), std::string::npos);
+    // Only the top 2 are listed
+    ASSERT_EQ(report.find("\n00 "), std::string::npos);
+}
+
+TEST(OpCodeProfileTest, TestDispatcherRecords) {
+    std::vector<uint8_t> memory(0x10000, 0x00);
+    SM83State state(memory.data());
+    SM83Emulator emulator(&state);
+    ASSERT_NE(emulator.profile(), nullptr);
+
+    // JR NZ at 0x100, run once taken and once not taken
+    memory[0x100] = 0x20;
+    memory[0x101] = 0x10;
+    state.setF(0x00);
+    state.setProgramCounter(0x100);
+    emulator.Step();
+    state.setF(0x80);
+    state.setProgramCounter(0x100);
+    emulator.Step();
+
+    // Then INC B twice
+    memory[0x200] = 0x04;
+    memory[0x201] = 0x04;
+    state.setProgramCounter(0x200);
+    emulator.Step();
+    emulator.Step();
+
+    OpCodeProfile* profile = emulator.profile();
+    ASSERT_EQ(profile->executions(0x20), 2u);
+    ASSERT_EQ(profile->histogram(0x20, 3), 1u);
+    ASSERT_EQ(profile->histogram(0x20, 2), 1u);
+    ASSERT_EQ(profile->executions(0x04), 2u);
+    ASSERT_EQ(profile->cycles(0x04), 8u);
+    ASSERT_EQ(profile->totalExecutions(), emulator.instructions());
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -45,9 +45,10 @@ TEST_F(OpCodesTest, TestExecute01) {
     ASSERT_EQ(Execute01(this->state_), 12);
     ASSERT_EQ(this->state_->programCounter(), program_counter_ + 3);
 
-    ASSERT_EQ(this->state_->b(), 0x04);
-    ASSERT_EQ(this->state_->c(), 0x02);
-    ASSERT_EQ(this->state_->bc(), 0x0402);
+    // The immediate is little endian
+    ASSERT_EQ(this->state_->b(), 0x02);
+    ASSERT_EQ(this->state_->c(), 0x04);
+    ASSERT_EQ(this->state_->bc(), 0x0204);
 }
 
 TEST_F(OpCodesTest, TestExecute11) {
@@ -58,9 +59,10 @@ TEST_F(OpCodesTest, TestExecute11) {
     ASSERT_EQ(Execute11(this->state_), 12);
     ASSERT_EQ(this->state_->programCounter(), program_counter_ + 3);
 
-    ASSERT_EQ(this->state_->d(), 0x04);
-    ASSERT_EQ(this->state_->e(), 0x02);
-    ASSERT_EQ(this->state_->de(), 0x0402);
+    // The immediate is little endian
+    ASSERT_EQ(this->state_->d(), 0x02);
+    ASSERT_EQ(this->state_->e(), 0x04);
+    ASSERT_EQ(this->state_->de(), 0x0204);
 }
 
 TEST_F(OpCodesTest, TestExecute21) {
@@ -71,9 +73,10 @@ TEST_F(OpCodesTest, TestExecute21) {
     ASSERT_EQ(Execute21(this->state_), 12);
     ASSERT_EQ(this->state_->programCounter(), program_counter_ + 3);
 
-    ASSERT_EQ(this->state_->h(), 0x04);
-    ASSERT_EQ(this->state_->l(), 0x02);
-    ASSERT_EQ(this->state_->hl(), 0x0402);
+    // The immediate is little endian
+    ASSERT_EQ(this->state_->h(), 0x02);
+    ASSERT_EQ(this->state_->l(), 0x04);
+    ASSERT_EQ(this->state_->hl(), 0x0204);
 }
 
 TEST_F(OpCodesTest, TestExecute31) {
@@ -84,7 +87,7 @@ TEST_F(OpCodesTest, TestExecute31) {
     ASSERT_EQ(Execute31(this->state_), 12);
     ASSERT_EQ(this->state_->programCounter(), program_counter_ + 3);
 
-    ASSERT_EQ(this->state_->stackPointer(), 0x0402);
+    ASSERT_EQ(this->state_->stackPointer(), 0x0204);
 }
 
 TEST_F(OpCodesTest, TestExecute02) {
@@ -542,7 +545,7 @@ TEST_F(OpCodesTest, TestExecute07_Z0N0H0C1) {
     ASSERT_EQ(this->state_->cFlag(), true);
 }
 
-TEST_F(OpCodesTest, TestExecute07_Z1N0H0C0) {
+TEST_F(OpCodesTest, TestExecute07_Z0N0H0C0) {
     uint8_t a = 0b00000000;
     state_->setA(a);
 
@@ -550,8 +553,8 @@ TEST_F(OpCodesTest, TestExecute07_Z1N0H0C0) {
     ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + 1);
     ASSERT_EQ(this->state_->a(), 0b00000000);
 
-    // Check the state of the CPU flags
-    ASSERT_EQ(this->state_->zFlag(), true);
+    // Check the state of the CPU flags, the accumulator rotates never set Z
+    ASSERT_EQ(this->state_->zFlag(), false);
     ASSERT_EQ(this->state_->nFlag(), false);
     ASSERT_EQ(this->state_->hFlag(), false);
     ASSERT_EQ(this->state_->cFlag(), false);
@@ -573,7 +576,7 @@ TEST_F(OpCodesTest, TestExecute17_Z0N0H0C1) {
     ASSERT_EQ(this->state_->cFlag(), true);
 }
 
-TEST_F(OpCodesTest, TestExecute17_Z1N0H0C0) {
+TEST_F(OpCodesTest, TestExecute17_Z0N0H0C0) {
     uint8_t a = 0b00000000;
     state_->setA(a);
     state_->setF(0b00000000);
@@ -582,8 +585,8 @@ TEST_F(OpCodesTest, TestExecute17_Z1N0H0C0) {
     ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + 1);
     ASSERT_EQ(this->state_->a(), 0b00000000);
 
-    // Check the state of the CPU flags
-    ASSERT_EQ(this->state_->zFlag(), true);
+    // Check the state of the CPU flags, the accumulator rotates never set Z
+    ASSERT_EQ(this->state_->zFlag(), false);
     ASSERT_EQ(this->state_->nFlag(), false);
     ASSERT_EQ(this->state_->hFlag(), false);
     ASSERT_EQ(this->state_->cFlag(), false);
@@ -605,14 +608,17 @@ TEST_F(OpCodesTest, TestExecute37) {
 }
 
 TEST_F(OpCodesTest, TestExecute08) {
-    uint8_t sp_a = 0xA3;
-    uint8_t sp_b = 0x0E;
     state_->setStackPointer(0xA30E);
+    state_->SetMemoryAt(this->program_counter_ + 1, 0x00);
+    state_->SetMemoryAt(this->program_counter_ + 2, 0xC1);
 
     ASSERT_EQ(Execute08(this->state_), 20);
     ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + 3);
-    ASSERT_EQ(this->state_->MemoryAt(this->program_counter_ + 1), sp_a);
-    ASSERT_EQ(this->state_->MemoryAt(this->program_counter_ + 2), sp_b);
+    // SP is stored low byte first at 0xC100, and the instruction itself is untouched
+    ASSERT_EQ(this->state_->MemoryAt(0xC100), 0x0E);
+    ASSERT_EQ(this->state_->MemoryAt(0xC101), 0xA3);
+    ASSERT_EQ(this->state_->MemoryAt(this->program_counter_ + 1), 0x00);
+    ASSERT_EQ(this->state_->MemoryAt(this->program_counter_ + 2), 0xC1);
 }
 
 TEST_F(OpCodesTest, TestExecute18) {
@@ -620,7 +626,8 @@ TEST_F(OpCodesTest, TestExecute18) {
     state_->SetMemoryAt(this->program_counter_ + 1, r8);
 
     ASSERT_EQ(Execute18(this->state_), 12);
-    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ - 1);
+    // Relative to the next instruction, so -1 lands on the offset byte
+    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + 2 - 1);
 }
 
 TEST_F(OpCodesTest, TestExecute09_N0H1C1) {
@@ -1012,7 +1019,7 @@ TEST_F(OpCodesTest, TestExecute0F_Z0N0H0C1) {
     ASSERT_EQ(this->state_->cFlag(), true);
 }
 
-TEST_F(OpCodesTest, TestExecute0F_Z1N0H0C0) {
+TEST_F(OpCodesTest, TestExecute0F_Z0N0H0C0) {
     uint8_t a = 0b00000000;
     state_->setA(a);
 
@@ -1020,8 +1027,8 @@ TEST_F(OpCodesTest, TestExecute0F_Z1N0H0C0) {
     ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + 1);
     ASSERT_EQ(this->state_->a(), 0b00000000);
 
-    // Check the state of the CPU flags
-    ASSERT_EQ(this->state_->zFlag(), true);
+    // Check the state of the CPU flags, the accumulator rotates never set Z
+    ASSERT_EQ(this->state_->zFlag(), false);
     ASSERT_EQ(this->state_->nFlag(), false);
     ASSERT_EQ(this->state_->hFlag(), false);
     ASSERT_EQ(this->state_->cFlag(), false);
@@ -1043,7 +1050,7 @@ TEST_F(OpCodesTest, TestExecute1F_Z0N0H0C1) {
     ASSERT_EQ(this->state_->cFlag(), true);
 }
 
-TEST_F(OpCodesTest, TestExecute1F_Z1N0H0C0) {
+TEST_F(OpCodesTest, TestExecute1F_Z0N0H0C0) {
     uint8_t a = 0b00000000;
     state_->setA(a);
     state_->setF(0b00000000);
@@ -1052,8 +1059,8 @@ TEST_F(OpCodesTest, TestExecute1F_Z1N0H0C0) {
     ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + 1);
     ASSERT_EQ(this->state_->a(), 0b00000000);
 
-    // Check the state of the CPU flags
-    ASSERT_EQ(this->state_->zFlag(), true);
+    // Check the state of the CPU flags, the accumulator rotates never set Z
+    ASSERT_EQ(this->state_->zFlag(), false);
     ASSERT_EQ(this->state_->nFlag(), false);
     ASSERT_EQ(this->state_->hFlag(), false);
     ASSERT_EQ(this->state_->cFlag(), false);
@@ -1090,7 +1097,7 @@ TEST_F(OpCodesTest, TestExecute20_JumpForward) {
     state_->SetMemoryAt(state_->programCounter() + 1, jump);
 
     ASSERT_EQ(Execute20(this->state_), 12);
-    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + jump);
+    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + 2 + jump);
 }
 
 TEST_F(OpCodesTest, TestExecute20_JumpBack) {
@@ -1100,7 +1107,7 @@ TEST_F(OpCodesTest, TestExecute20_JumpBack) {
     state_->SetMemoryAt(state_->programCounter() + 1, jump);
 
     ASSERT_EQ(Execute20(this->state_), 12);
-    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + jump);
+    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + 2 + jump);
 }
 
 TEST_F(OpCodesTest, TestExecute30_NoJump) {
@@ -1118,7 +1125,7 @@ TEST_F(OpCodesTest, TestExecute30_JumpForward) {
     state_->SetMemoryAt(state_->programCounter() + 1, jump);
 
     ASSERT_EQ(Execute30(this->state_), 12);
-    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + jump);
+    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + 2 + jump);
 }
 
 TEST_F(OpCodesTest, TestExecute30_JumpBack) {
@@ -1128,7 +1135,7 @@ TEST_F(OpCodesTest, TestExecute30_JumpBack) {
     state_->SetMemoryAt(state_->programCounter() + 1, jump);
 
     ASSERT_EQ(Execute20(this->state_), 12);
-    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + jump);
+    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + 2 + jump);
 }
 
 TEST_F(OpCodesTest, TestExecute28_NoJump) {
@@ -1146,7 +1153,7 @@ TEST_F(OpCodesTest, TestExecute28_JumpForward) {
     state_->SetMemoryAt(state_->programCounter() + 1, jump);
 
     ASSERT_EQ(Execute28(this->state_), 12);
-    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + jump);
+    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + 2 + jump);
 }
 
 TEST_F(OpCodesTest, TestExecute28_JumpBack) {
@@ -1156,7 +1163,7 @@ TEST_F(OpCodesTest, TestExecute28_JumpBack) {
     state_->SetMemoryAt(state_->programCounter() + 1, jump);
 
     ASSERT_EQ(Execute28(this->state_), 12);
-    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + jump);
+    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + 2 + jump);
 }
 
 TEST_F(OpCodesTest, TestExecute38_NoJump) {
@@ -1174,7 +1181,7 @@ TEST_F(OpCodesTest, TestExecute38_JumpForward) {
     state_->SetMemoryAt(state_->programCounter() + 1, jump);
 
     ASSERT_EQ(Execute38(this->state_), 12);
-    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + jump);
+    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + 2 + jump);
 }
 
 TEST_F(OpCodesTest, TestExecute38_JumpBack) {
@@ -1184,7 +1191,43 @@ TEST_F(OpCodesTest, TestExecute38_JumpBack) {
     state_->SetMemoryAt(state_->programCounter() + 1, jump);
 
     ASSERT_EQ(Execute38(this->state_), 12);
-    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + jump);
+    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + 2 + jump);
+}
+
+TEST_F(OpCodesTest, TestExecuteCD) {
+    this->state_->setStackPointer(0xFFFE);
+    this->state_->SetMemoryAt(this->program_counter_ + 1, 0x34);
+    this->state_->SetMemoryAt(this->program_counter_ + 2, 0x12);
+
+    ASSERT_EQ(ExecuteCD(this->state_), 24);
+    ASSERT_EQ(this->state_->programCounter(), 0x1234);
+    ASSERT_EQ(this->state_->stackPointer(), 0xFFFC);
+
+    // The return address is the instruction after the call, little endian
+    ASSERT_EQ(this->state_->MemoryAt(0xFFFC), (uint8_t)(this->program_counter_ + 3));
+    ASSERT_EQ(this->state_->MemoryAt(0xFFFD), (uint8_t)((this->program_counter_ + 3) >> 8));
+}
+
+TEST_F(OpCodesTest, TestExecuteC9) {
+    this->state_->setStackPointer(0xFFFC);
+    this->state_->SetMemoryAt(0xFFFC, 0x34);
+    this->state_->SetMemoryAt(0xFFFD, 0x12);
+
+    ASSERT_EQ(ExecuteC9(this->state_), 16);
+    ASSERT_EQ(this->state_->programCounter(), 0x1234);
+    ASSERT_EQ(this->state_->stackPointer(), 0xFFFE);
+}
+
+TEST_F(OpCodesTest, TestExecuteCD_C9_RoundTrip) {
+    this->state_->setStackPointer(0xFFFE);
+    this->state_->SetMemoryAt(this->program_counter_ + 1, 0x00);
+    this->state_->SetMemoryAt(this->program_counter_ + 2, 0x40);
+
+    ExecuteCD(this->state_);
+    ExecuteC9(this->state_);
+
+    ASSERT_EQ(this->state_->programCounter(), this->program_counter_ + 3);
+    ASSERT_EQ(this->state_->stackPointer(), 0xFFFE);
 }
 
 }  // namespace
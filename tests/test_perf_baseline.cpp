@@ -0,0 +1,145 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/util/perf_baseline.hpp"
+
+namespace {
+
+// Spreads samples evenly within 1% around a value, like timings on a quiet machine
+static std::vector<double> Samples(double value, int count) {
+    std::vector<double> samples;
+    for (int i = 0; i < count; i++) {
+        samples.push_back(value * (0.995 + 0.01 * i / (count - 1)));
+    }
+    return samples;
+}
+
+TEST(PerfBaselineTest, TestSaveAndLoad) {
+    std::string path = testing::TempDir() + "lameboy_perf_baseline.txt";
+    std::vector<PerfMetric> metrics = {
+        PerfMetric{ "execute/3C", "ns/op", false, { 12.5, 12.25, 13.125 } },
+        PerfMetric{ "rom/tiles.gb/frames", "frames/s", true, { 4000.5 } }
+    };
+    ASSERT_TRUE(SavePerfBaseline(path.c_str(), metrics));
+
+    std::vector<PerfMetric> loaded;
+    ASSERT_TRUE(LoadPerfBaseline(path.c_str(), &loaded));
+    ASSERT_EQ(loaded.size(), 2u);
+    for (size_t i = 0; i < metrics.size(); i++) {
+        ASSERT_EQ(loaded[i].name, metrics[i].name);
+        ASSERT_EQ(loaded[i].unit, metrics[i].unit);
+        ASSERT_EQ(loaded[i].higher_is_better, metrics[i].higher_is_better);
+        ASSERT_EQ(loaded[i].samples, metrics[i].samples);
+    }
+    remove(path.c_str());
+}
+
+TEST(PerfBaselineTest, TestLoadRejectsMalformedFiles) {
+    std::string path = testing::TempDir() + "lameboy_perf_malformed.txt";
+    std::vector<PerfMetric> loaded;
+
+    FILE* file = fopen(path.c_str(), "w");
+    fprintf(file, "# lameboy perf baseline 1\nexecute/00 ns/op sideways 1 2\n");
+    fclose(file);
+    ASSERT_FALSE(LoadPerfBaseline(path.c_str(), &loaded));
+
+    file = fopen(path.c_str(), "w");
+    fprintf(file, "# lameboy perf baseline 1\nexecute/00 ns/op lower 1 two\n");
+    fclose(file);
+    ASSERT_FALSE(LoadPerfBaseline(path.c_str(), &loaded));
+
+    file = fopen(path.c_str(), "w");
+    fprintf(file, "execute/00 ns/op lower 1 2\n");
+    fclose(file);
+    ASSERT_FALSE(LoadPerfBaseline(path.c_str(), &loaded));
+
+    ASSERT_FALSE(LoadPerfBaseline("/nonexistent/baseline.txt", &loaded));
+    remove(path.c_str());
+}
+
+TEST(PerfBaselineTest, TestMedian) {
+    ASSERT_DOUBLE_EQ(Median({ 3, 1, 2 }), 2);
+    ASSERT_DOUBLE_EQ(Median({ 4, 1, 3, 2 }), 2.5);
+    ASSERT_DOUBLE_EQ(Median({ 7 }), 7);
+}
+
+TEST(PerfBaselineTest, TestMannWhitney) {
+    std::vector<double> low = { 1, 2, 3, 4, 5 };
+    std::vector<double> high = { 6, 7, 8, 9, 10 };
+
+    // U = 25 against a mean of 12.5 and a variance of 25 * 11 / 12
+    ASSERT_NEAR(MannWhitneyGreater(high, low), 0.0061, 0.0001);
+    ASSERT_GT(MannWhitneyGreater(low, high), 0.99);
+
+    std::vector<double> mixed = { 1.5, 2.5, 3.5, 4.5, 5.5 };
+    ASSERT_GT(MannWhitneyGreater(mixed, low), 0.05);
+
+    std::vector<double> equal = { 2, 2, 2, 2, 2 };
+    ASSERT_DOUBLE_EQ(MannWhitneyGreater(equal, equal), 1.0);
+}
+
+TEST(PerfBaselineTest, TestSlowdownsWithinThresholdAreNoise) {
+    PerfMetric baseline{ "execute/3C", "ns/op", false, Samples(10.0, 10) };
+    PerfMetric current{ "execute/3C", "ns/op", false, Samples(10.3, 10) };
+
+    // Consistently 3% slower, but under the 5% threshold
+    PerfComparison comparison = ComparePerfMetric(baseline, current, 0.05, 0.01);
+    ASSERT_NEAR(comparison.change, 0.03, 0.001);
+    ASSERT_FALSE(comparison.regression);
+    ASSERT_FALSE(comparison.improvement);
+}
+
+TEST(PerfBaselineTest, TestTimeRegression) {
+    PerfMetric baseline{ "execute/3C", "ns/op", false, Samples(10.0, 10) };
+    PerfMetric current{ "execute/3C", "ns/op", false, Samples(12.0, 10) };
+
+    PerfComparison comparison = ComparePerfMetric(baseline, current, 0.05, 0.01);
+    ASSERT_NEAR(comparison.change, 0.2, 0.001);
+    ASSERT_LT(comparison.p_value, 0.01);
+    ASSERT_TRUE(comparison.regression);
+
+    // The same change the other way round is an improvement
+    comparison = ComparePerfMetric(current, baseline, 0.05, 0.01);
+    ASSERT_FALSE(comparison.regression);
+    ASSERT_TRUE(comparison.improvement);
+}
+
+TEST(PerfBaselineTest, TestRateRegression) {
+    PerfMetric baseline{ "rom/tiles.gb/frames", "frames/s", true, Samples(5000, 10) };
+    PerfMetric current{ "rom/tiles.gb/frames", "frames/s", true, Samples(4000, 10) };
+
+    // A lower rate is worse
+    PerfComparison comparison = ComparePerfMetric(baseline, current, 0.05, 0.01);
+    ASSERT_NEAR(comparison.change, -0.2, 0.001);
+    ASSERT_TRUE(comparison.regression);
+
+    comparison = ComparePerfMetric(current, baseline, 0.05, 0.01);
+    ASSERT_FALSE(comparison.regression);
+    ASSERT_TRUE(comparison.improvement);
+}
+
+TEST(PerfBaselineTest, TestNoisySamplesNeedMoreEvidence) {
+    // A single fast outlier in the baseline is not enough to call a regression on its own
+    PerfMetric baseline{ "execute/3C", "ns/op", false, { 10, 20, 20, 20, 20 } };
+    PerfMetric current{ "execute/3C", "ns/op", false, { 20, 20, 20, 20, 20 } };
+
+    PerfComparison comparison = ComparePerfMetric(baseline, current, 0.05, 0.01);
+    ASSERT_FALSE(comparison.regression);
+}
+
+TEST(PerfBaselineTest, TestHolmSignificant) {
+    // 0.001 < 0.05 / 4 and 0.012 < 0.05 / 3, but 0.03 >= 0.05 / 2 stops the procedure
+    std::vector<bool> significant = HolmSignificant({ 0.03, 0.001, 0.2, 0.012 }, 0.05);
+    ASSERT_EQ(significant, std::vector<bool>({ false, true, false, true }));
+
+    ASSERT_EQ(HolmSignificant({ 0.04 }, 0.05), std::vector<bool>({ true }));
+    ASSERT_TRUE(HolmSignificant({}, 0.05).empty());
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
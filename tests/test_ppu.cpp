@@ -0,0 +1,301 @@
+#include <cstring>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/cpu/sm83_state.hpp"
+#include "../src/ppu/deferred_ppu.hpp"
+#include "../src/ppu/ppu.hpp"
+#include "../src/ppu/sprite_line_cache.hpp"
+
+namespace {
+
+/**
+ * @brief Runs the fast and accurate PPUs on identical copies of memory
+ *
+ */
+class PPUTest : public ::testing::Test {
+protected:
+
+    uint8_t* fast_memory_;
+    uint8_t* accurate_memory_;
+    FastPPU* fast_ppu_;
+    AccuratePPU* accurate_ppu_;
+
+    void SetUp() override {
+        this->fast_memory_ = new uint8_t[65536]();
+        this->accurate_memory_ = new uint8_t[65536]();
+        this->fast_ppu_ = new FastPPU(this->fast_memory_);
+        this->accurate_ppu_ = new AccuratePPU(this->accurate_memory_);
+    }
+
+    void TearDown() override {
+        delete this->fast_ppu_;
+        delete this->accurate_ppu_;
+        delete[] this->fast_memory_;
+        delete[] this->accurate_memory_;
+    }
+
+    // Writes the same value to both memories, notifying the PPUs as SM83State would
+    void Write(uint16_t address, uint8_t value) {
+        this->fast_memory_[address] = value;
+        this->accurate_memory_[address] = value;
+        this->fast_ppu_->OnMemoryWrite(address, value);
+        this->accurate_ppu_->OnMemoryWrite(address, value);
+    }
+
+    // Fills VRAM and OAM with the same random contents in both memories
+    void FillVideoMemory(unsigned int seed) {
+        std::mt19937 random(seed);
+
+        for (int address = VRAM_START; address <= VRAM_END; address++) {
+            this->Write((uint16_t)address, (uint8_t)random());
+        }
+        for (int address = OAM_START; address <= OAM_END; address++) {
+            this->Write((uint16_t)address, (uint8_t)random());
+        }
+    }
+
+    void TickBoth(uint32_t cycles) {
+        while (cycles > 0) {
+            uint16_t step = cycles < 4 ? (uint16_t)cycles : 4;
+            this->fast_ppu_->Tick(step);
+            this->accurate_ppu_->Tick(step);
+            cycles -= step;
+        }
+    }
+};
+
+TEST_F(PPUTest, TestFrameTiming) {
+    this->Write(LCDC_ADDRESS, LCDC_LCD_ENABLE | LCDC_BG_ENABLE);
+
+    // Line 0 starts in mode 2
+    this->fast_ppu_->Tick(4);
+    ASSERT_EQ(this->fast_ppu_->mode(), OAM_SCAN);
+
+    this->fast_ppu_->Tick(OAM_SCAN_DOTS);
+    ASSERT_EQ(this->fast_ppu_->mode(), TRANSFER);
+
+    this->fast_ppu_->Tick(TRANSFER_DOTS);
+    ASSERT_EQ(this->fast_ppu_->mode(), HBLANK);
+    ASSERT_EQ(this->fast_memory_[STAT_ADDRESS] & STAT_MODE_MASK, HBLANK);
+
+    // Run up to the start of VBlank
+    this->fast_ppu_->Tick(DOTS_PER_LINE * VISIBLE_LINES - OAM_SCAN_DOTS - TRANSFER_DOTS - 4);
+    ASSERT_EQ(this->fast_ppu_->mode(), VBLANK);
+    ASSERT_EQ(this->fast_ppu_->ly(), VISIBLE_LINES);
+    ASSERT_EQ(this->fast_memory_[LY_ADDRESS], VISIBLE_LINES);
+    ASSERT_TRUE(this->fast_ppu_->frameComplete());
+    ASSERT_EQ(this->fast_memory_[IF_ADDRESS] & VBLANK_INTERRUPT, VBLANK_INTERRUPT);
+
+    // And wrap around to the next frame
+    this->fast_ppu_->Tick(DOTS_PER_LINE * (LINES_PER_FRAME - VISIBLE_LINES));
+    ASSERT_EQ(this->fast_ppu_->ly(), 0);
+    ASSERT_EQ(this->fast_ppu_->frameDots(), 0u);
+}
+
+TEST_F(PPUTest, TestLCDDisabled) {
+    this->fast_ppu_->Tick(DOTS_PER_LINE * 10);
+
+    ASSERT_EQ(this->fast_ppu_->ly(), 0);
+    ASSERT_EQ(this->fast_ppu_->mode(), HBLANK);
+    ASSERT_FALSE(this->fast_ppu_->frameComplete());
+}
+
+TEST_F(PPUTest, TestLYCInterrupt) {
+    this->Write(LCDC_ADDRESS, LCDC_LCD_ENABLE);
+    this->Write(LYC_ADDRESS, 10);
+    this->Write(STAT_ADDRESS, STAT_LYC_SOURCE);
+
+    this->fast_ppu_->Tick(DOTS_PER_LINE * 10 - 4);
+    ASSERT_EQ(this->fast_memory_[IF_ADDRESS] & STAT_INTERRUPT, 0);
+
+    this->fast_ppu_->Tick(8);
+    ASSERT_EQ(this->fast_memory_[IF_ADDRESS] & STAT_INTERRUPT, STAT_INTERRUPT);
+    ASSERT_EQ(this->fast_memory_[STAT_ADDRESS] & STAT_LYC_EQUAL, STAT_LYC_EQUAL);
+}
+
+TEST_F(PPUTest, TestRenderersMatchOnStaticFrames) {
+    const uint8_t lcdc_values[] = {
+        LCDC_LCD_ENABLE | LCDC_BG_ENABLE,
+        LCDC_LCD_ENABLE | LCDC_BG_ENABLE | LCDC_TILE_DATA | LCDC_OBJ_ENABLE,
+        LCDC_LCD_ENABLE | LCDC_BG_ENABLE | LCDC_OBJ_ENABLE | LCDC_OBJ_SIZE | LCDC_BG_MAP,
+        LCDC_LCD_ENABLE | LCDC_BG_ENABLE | LCDC_OBJ_ENABLE | LCDC_WINDOW_ENABLE | LCDC_WINDOW_MAP,
+        LCDC_LCD_ENABLE | LCDC_OBJ_ENABLE | LCDC_OBJ_SIZE,
+        0xFF,
+    };
+
+    unsigned int seed = 1;
+
+    for (uint8_t lcdc : lcdc_values) {
+        for (int i = 0; i < 4; i++, seed++) {
+            std::mt19937 random(seed);
+
+            this->FillVideoMemory(seed);
+            this->Write(SCX_ADDRESS, (uint8_t)random());
+            this->Write(SCY_ADDRESS, (uint8_t)random());
+            this->Write(WX_ADDRESS, (uint8_t)(random() % 180));
+            this->Write(WY_ADDRESS, (uint8_t)(random() % 150));
+            this->Write(BGP_ADDRESS, 0b11100100);
+            this->Write(OBP0_ADDRESS, 0b11010010);
+            this->Write(OBP1_ADDRESS, 0b00011011);
+            this->Write(LCDC_ADDRESS, lcdc);
+
+            this->TickBoth(DOTS_PER_FRAME);
+
+            ASSERT_EQ(memcmp(this->fast_ppu_->framebuffer(), this->accurate_ppu_->framebuffer(), SCREEN_PIXELS * 4), 0)
+                << "LCDC " << (int)lcdc << " seed " << seed;
+        }
+    }
+}
+
+TEST_F(PPUTest, TestAccurateTransferLength) {
+    this->Write(LCDC_ADDRESS, LCDC_LCD_ENABLE | LCDC_BG_ENABLE);
+    this->Write(SCX_ADDRESS, 3);
+
+    // Fine scrolling discards 3 pixels, lengthening mode 3 by 3 dots
+    this->accurate_ppu_->Tick(OAM_SCAN_DOTS + TRANSFER_DOTS + 2);
+    ASSERT_EQ(this->accurate_ppu_->mode(), TRANSFER);
+
+    this->accurate_ppu_->Tick(1);
+    ASSERT_EQ(this->accurate_ppu_->mode(), HBLANK);
+}
+
+TEST_F(PPUTest, TestMidScanlinePaletteChange) {
+    // Tile 0 is solid colour 3 and fills the background map
+    for (int address = 0x8000; address < 0x8010; address++) {
+        this->Write((uint16_t)address, 0xFF);
+    }
+    this->Write(BGP_ADDRESS, 0b11000000);
+    this->Write(LCDC_ADDRESS, LCDC_LCD_ENABLE | LCDC_BG_ENABLE | LCDC_TILE_DATA);
+
+    // Run into the middle of mode 3 of line 0, then switch colour 3 from black to white
+    this->TickBoth(OAM_SCAN_DOTS + 92);
+    this->Write(BGP_ADDRESS, 0b00000000);
+    this->TickBoth(DOTS_PER_LINE - OAM_SCAN_DOTS - 92);
+
+    const uint32_t* fast = this->fast_ppu_->framebuffer();
+    const uint32_t* accurate = this->accurate_ppu_->framebuffer();
+
+    // The fast renderer drew the whole line before the write
+    ASSERT_EQ(fast[0], DMG_SHADES[3]);
+    ASSERT_EQ(fast[SCREEN_WIDTH - 1], DMG_SHADES[3]);
+
+    // The accurate renderer splits the line where the write landed
+    ASSERT_EQ(accurate[0], DMG_SHADES[3]);
+    ASSERT_EQ(accurate[79], DMG_SHADES[3]);
+    ASSERT_EQ(accurate[80], DMG_SHADES[0]);
+    ASSERT_EQ(accurate[SCREEN_WIDTH - 1], DMG_SHADES[0]);
+}
+
+TEST_F(PPUTest, TestDeferredMatchesInline) {
+    std::mt19937 random(26);
+
+    this->FillVideoMemory(27);
+    this->Write(BGP_ADDRESS, 0b11100100);
+    this->Write(OBP0_ADDRESS, 0b11010010);
+    this->Write(WX_ADDRESS, 40);
+    this->Write(WY_ADDRESS, 60);
+    this->Write(LCDC_ADDRESS, 0xFF);
+
+    // The CPU side writes through SM83State into the accurate PPU's memory, the inline PPU gets the same writes directly
+    SM83State state(this->accurate_memory_);
+    std::vector<std::vector<uint32_t>> deferred_frames;
+    std::vector<std::vector<uint32_t>> inline_frames;
+
+    {
+        DeferredPPU deferred(this->accurate_memory_, [&deferred_frames](const uint32_t* framebuffer) {
+            deferred_frames.push_back(std::vector<uint32_t>(framebuffer, framebuffer + SCREEN_PIXELS));
+        });
+        state.AddMemoryObserver(&deferred, 0x80, 0x9F);
+        state.AddMemoryObserver(&deferred, 0xFE, 0xFF);
+
+        const uint16_t registers[] = { SCX_ADDRESS, SCY_ADDRESS, BGP_ADDRESS, OBP0_ADDRESS, WX_ADDRESS, WY_ADDRESS };
+
+        while (inline_frames.size() < 6) {
+            uint16_t cycles = (uint16_t)(4 * (1 + random() % 6));
+            deferred.Tick(cycles);
+            this->fast_ppu_->Tick(cycles);
+
+            if (this->fast_ppu_->frameComplete()) {
+                const uint32_t* framebuffer = this->fast_ppu_->framebuffer();
+                inline_frames.push_back(std::vector<uint32_t>(framebuffer, framebuffer + SCREEN_PIXELS));
+                this->fast_ppu_->AcknowledgeFrame();
+            }
+
+            // Raster effects, tile and sprite updates at arbitrary dots
+            uint16_t address;
+            uint8_t value = (uint8_t)random();
+            switch (random() % 8) {
+                case 0:
+                    address = registers[random() % 6];
+                    break;
+                case 1:
+                    address = (uint16_t)(VRAM_START + random() % 0x2000);
+                    break;
+                case 2:
+                    address = (uint16_t)(OAM_START + random() % OAM_SIZE);
+                    break;
+                case 3:
+                    address = LCDC_ADDRESS;
+                    value = value | LCDC_LCD_ENABLE;
+                    break;
+                default:
+                    continue;
+            }
+
+            state.SetMemoryAt(address, value);
+            this->fast_memory_[address] = value;
+            this->fast_ppu_->OnMemoryWrite(address, value);
+        }
+
+        deferred.WaitForFrames();
+        ASSERT_EQ(deferred.timing()->ly(), this->fast_ppu_->ly());
+        ASSERT_EQ(deferred.timing()->frameDots(), this->fast_ppu_->frameDots());
+    }
+
+    ASSERT_EQ(deferred_frames.size(), inline_frames.size());
+    for (size_t i = 0; i < inline_frames.size(); i++) {
+        ASSERT_EQ(deferred_frames[i], inline_frames[i]) << "frame " << i;
+    }
+}
+
+TEST(SpriteLineCacheTest, TestIncrementalUpdatesMatchScan) {
+    uint8_t* memory = new uint8_t[65536]();
+    std::mt19937 random(28);
+    SpriteLineCache cache(memory);
+
+    for (int address = OAM_START; address <= OAM_END; address++) {
+        memory[address] = (uint8_t)random();
+    }
+
+    for (int i = 0; i < 2000; i++) {
+        // Moves are biased onto the screen so lines fill up past the 10 object limit
+        uint16_t address = (uint16_t)(OAM_START + random() % OAM_SIZE);
+        memory[address] = (address & 3) == 0 ? (uint8_t)(random() % 170) : (uint8_t)random();
+        cache.OnOAMWrite(address);
+
+        uint8_t height = i < 1000 ? 8 : 16;
+        for (uint8_t ly = 0; ly < SCREEN_HEIGHT; ly++) {
+            SpriteEntry expected[MAX_SPRITES_PER_LINE];
+            SpriteEntry actual[MAX_SPRITES_PER_LINE];
+
+            uint8_t expected_count = ScanOAM(memory, ly, height, expected);
+            SortSpritesByPriority(expected, expected_count);
+
+            ASSERT_EQ(cache.Sprites(ly, height, actual), expected_count);
+            for (uint8_t s = 0; s < expected_count; s++) {
+                ASSERT_EQ(actual[s].index, expected[s].index);
+                ASSERT_EQ(actual[s].x, expected[s].x);
+            }
+        }
+    }
+
+    delete[] memory;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,139 @@
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/audio/resampler.hpp"
+
+namespace {
+
+static const double PI = 3.14159265358979323846;
+
+// Batches the size of one DMG frame at 48kHz
+static const size_t BATCH = 803;
+
+/**
+ * @brief Resamples a stereo tone, a sine on the left and a cosine on the right, in frame sized batches
+ *
+ */
+std::vector<float> ResampleTone(double frequency, uint32_t input_rate, uint32_t output_rate, size_t samples, SIMDLevel level, double adjustment = 0.0) {
+    Resampler resampler(input_rate, output_rate, level);
+    std::vector<float> in(samples * 2);
+    for (size_t i = 0; i < samples; i++) {
+        in[i * 2] = (float)(0.5 * sin(2 * PI * frequency * i / input_rate));
+        in[i * 2 + 1] = (float)(0.5 * cos(2 * PI * frequency * i / input_rate));
+    }
+
+    std::vector<float> out;
+    std::vector<float> batch(resampler.MaxOutput(BATCH, adjustment) * 2);
+    for (size_t start = 0; start < samples; start += BATCH) {
+        size_t count = samples - start < BATCH ? samples - start : BATCH;
+        size_t produced = resampler.Process(in.data() + start * 2, count, batch.data(), adjustment);
+        out.insert(out.end(), batch.begin(), batch.begin() + produced * 2);
+    }
+    return out;
+}
+
+/**
+ * @brief Gets the RMS difference from the tone output sample n should hold, after the start up
+ *
+ */
+double ToneError(const std::vector<float>& out, double frequency, uint32_t input_rate, uint32_t output_rate) {
+    double step = (double)input_rate / output_rate;
+    double sum = 0;
+    size_t count = 0;
+
+    for (size_t n = RESAMPLER_TAPS; n < out.size() / 2; n++) {
+        double t = n * step / input_rate;
+        double left = out[n * 2] - 0.5 * sin(2 * PI * frequency * t);
+        double right = out[n * 2 + 1] - 0.5 * cos(2 * PI * frequency * t);
+        sum += left * left + right * right;
+        count += 2;
+    }
+    return sqrt(sum / count);
+}
+
+/**
+ * @brief Gets the RMS of a signal after the start up
+ *
+ */
+double RMS(const std::vector<float>& out) {
+    double sum = 0;
+    for (size_t i = RESAMPLER_TAPS * 2; i < out.size(); i++) {
+        sum += out[i] * out[i];
+    }
+    return sqrt(sum / (out.size() - RESAMPLER_TAPS * 2));
+}
+
+TEST(ResamplerTest, TestDCPassesUnchanged) {
+    Resampler resampler(48000, 44100, SIMD_SCALAR);
+    std::vector<float> in(BATCH * 2, 0.5f);
+    std::vector<float> out(resampler.MaxOutput(BATCH) * 2);
+
+    resampler.Process(in.data(), BATCH, out.data());
+    size_t produced = resampler.Process(in.data(), BATCH, out.data());
+
+    for (size_t i = 0; i < produced * 2; i++) {
+        ASSERT_NEAR(out[i], 0.5f, 1e-5f);
+    }
+}
+
+TEST(ResamplerTest, TestOutputLinesUpWithInput) {
+    for (uint32_t output_rate : { 44100u, 48000u, 96000u }) {
+        std::vector<float> out = ResampleTone(1000, 48000, output_rate, 48000, SIMD_SCALAR);
+        ASSERT_LT(ToneError(out, 1000, 48000, output_rate), 1e-3) << output_rate;
+    }
+}
+
+TEST(ResamplerTest, TestAliasesAreRejected) {
+    // Above the 22.05kHz output Nyquist frequency, so it may only come out as an alias
+    std::vector<float> out = ResampleTone(23800, 48000, 44100, 48000, SIMD_SCALAR);
+    ASSERT_LT(RMS(out), 0.5 * pow(10, -40 / 20.0));
+}
+
+TEST(ResamplerTest, TestOutputCountFollowsRatio) {
+    std::vector<float> out = ResampleTone(440, 48000, 44100, BATCH * 100, SIMD_SCALAR);
+    // All but the samples held back for the filter come out
+    double expected = (BATCH * 100 - RESAMPLER_TAPS / 2) * 44100.0 / 48000.0;
+    ASSERT_NEAR((double)(out.size() / 2), expected, 2.0);
+
+    std::vector<float> stretched = ResampleTone(440, 48000, 44100, BATCH * 100, SIMD_SCALAR, 0.005);
+    ASSERT_NEAR((double)(stretched.size() / 2), expected * 1.005, 2.0);
+}
+
+TEST(ResamplerTest, TestSIMDLevelsMatchScalar) {
+    std::vector<float> expected = ResampleTone(3000, 48000, 44100, BATCH * 10, SIMD_SCALAR, 0.003);
+
+    for (int level = SIMD_SSE2; level <= SIMD_AVX2; level++) {
+        if (!SIMDLevelSupported((SIMDLevel)level)) {
+            continue;
+        }
+
+        std::vector<float> out = ResampleTone(3000, 48000, 44100, BATCH * 10, (SIMDLevel)level, 0.003);
+        ASSERT_EQ(out.size(), expected.size());
+        for (size_t i = 0; i < out.size(); i++) {
+            ASSERT_NEAR(out[i], expected[i], 1e-5f) << SIMDLevelName((SIMDLevel)level) << " sample " << i;
+        }
+    }
+}
+
+TEST(ResamplerTest, TestResetForgetsInput) {
+    Resampler resampler(48000, 48000, SIMD_SCALAR);
+    std::vector<float> loud(BATCH * 2, 1.0f);
+    std::vector<float> silent(BATCH * 2, 0.0f);
+    std::vector<float> out(resampler.MaxOutput(BATCH) * 2);
+
+    resampler.Process(loud.data(), BATCH, out.data());
+    resampler.Reset();
+    size_t produced = resampler.Process(silent.data(), BATCH, out.data());
+
+    ASSERT_EQ(produced, BATCH - resampler.latency());
+    for (size_t i = 0; i < produced * 2; i++) {
+        ASSERT_EQ(out[i], 0.0f);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,128 @@
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/video/scale_filters.hpp"
+#include "../src/video/scale_kernels.hpp"
+
+namespace {
+
+/**
+ * @brief Runs every filter over the same images at each supported SIMD level
+ *
+ */
+class ScaleFiltersTest : public ::testing::Test {
+protected:
+
+    // Few distinct colours, so the edge rules of Scale2x and Scale3x fire often
+    std::vector<uint32_t> RandomImage(int width, int height, unsigned int seed) {
+        static const uint32_t COLORS[4] = { 0xFFFFFFFF, 0xFFAAAAAA, 0xFF555555, 0xFF000000 };
+        std::mt19937 random(seed);
+        std::vector<uint32_t> image(width * height);
+
+        for (size_t i = 0; i < image.size(); i++) {
+            image[i] = COLORS[random() % 4];
+        }
+        return image;
+    }
+
+    std::vector<uint32_t> Scale(ScaleFilter filter, int factor, const std::vector<uint32_t>& image, int width, int height, SIMDLevel level) {
+        // A wider pitch than needed checks that rows are placed by dst_pitch
+        int pitch = width * factor + 3;
+        std::vector<uint32_t> output(pitch * height * factor, 0x12345678);
+        ScaleFrame(filter, factor, image.data(), width, height, output.data(), pitch, level);
+        return output;
+    }
+
+    void ExpectMatchesScalar(ScaleFilter filter, int factor) {
+        const int sizes[][2] = { { 160, 144 }, { 13, 7 }, { 1, 1 }, { 2, 3 }, { 9, 2 }, { 17, 5 } };
+
+        for (const auto& size : sizes) {
+            std::vector<uint32_t> image = this->RandomImage(size[0], size[1], (unsigned int)(size[0] * 31 + factor));
+            std::vector<uint32_t> expected = this->Scale(filter, factor, image, size[0], size[1], SIMD_SCALAR);
+
+            for (int level = SIMD_SSE2; level <= SIMD_AVX2; level++) {
+                if (!SIMDLevelSupported((SIMDLevel)level)) {
+                    continue;
+                }
+                ASSERT_EQ(this->Scale(filter, factor, image, size[0], size[1], (SIMDLevel)level), expected)
+                    << SIMDLevelName((SIMDLevel)level) << " " << size[0] << "x" << size[1] << " factor " << factor;
+            }
+        }
+    }
+};
+
+TEST_F(ScaleFiltersTest, TestNearest) {
+    std::vector<uint32_t> image = { 1, 2, 3, 4 };
+    std::vector<uint32_t> output(6 * 6);
+    ScaleFrame(NEAREST_FILTER, 3, image.data(), 2, 2, output.data(), 6, SIMD_SCALAR);
+
+    ASSERT_EQ(output[0], 1u);
+    ASSERT_EQ(output[2], 1u);
+    ASSERT_EQ(output[3], 2u);
+    ASSERT_EQ(output[2 * 6 + 5], 2u);
+    ASSERT_EQ(output[3 * 6], 3u);
+    ASSERT_EQ(output[5 * 6 + 5], 4u);
+
+    for (int factor = MIN_SCALE_FACTOR; factor <= MAX_SCALE_FACTOR; factor++) {
+        this->ExpectMatchesScalar(NEAREST_FILTER, factor);
+    }
+}
+
+TEST_F(ScaleFiltersTest, TestScale2x) {
+    // The corner between two black pixels of a diagonal edge is filled in
+    const uint32_t W = 0xFFFFFFFF;
+    const uint32_t K = 0xFF000000;
+    std::vector<uint32_t> image = {
+        W, K, W,
+        K, W, W,
+        W, W, W
+    };
+    std::vector<uint32_t> output(6 * 6);
+    ScaleFrame(SCALE2X_FILTER, 2, image.data(), 3, 3, output.data(), 6, SIMD_SCALAR);
+
+    ASSERT_EQ(output[2 * 6 + 2], K);
+    ASSERT_EQ(output[2 * 6 + 3], W);
+    ASSERT_EQ(output[3 * 6 + 2], W);
+    ASSERT_EQ(output[3 * 6 + 3], W);
+
+    this->ExpectMatchesScalar(SCALE2X_FILTER, 2);
+}
+
+TEST_F(ScaleFiltersTest, TestScale3x) {
+    this->ExpectMatchesScalar(SCALE3X_FILTER, 3);
+}
+
+TEST_F(ScaleFiltersTest, TestLCDGrid) {
+    std::vector<uint32_t> image = { 0xFFFFFFFF };
+    std::vector<uint32_t> output(3 * 3);
+    ScaleFrame(LCD_GRID_FILTER, 3, image.data(), 1, 1, output.data(), 3, SIMD_SCALAR);
+
+    ASSERT_EQ(output[0], 0xFFFFFFFFu);
+    ASSERT_EQ(output[2], DimPixel(0xFFFFFFFF));
+    ASSERT_EQ(output[2 * 3], DimPixel(0xFFFFFFFF));
+    ASSERT_EQ(output[2 * 3 + 2], DimPixel(DimPixel(0xFFFFFFFF)));
+    ASSERT_EQ(DimPixel(0xFFFFFFFF), 0xFFBEBEBEu);
+
+    for (int factor = MIN_SCALE_FACTOR; factor <= MAX_SCALE_FACTOR; factor++) {
+        this->ExpectMatchesScalar(LCD_GRID_FILTER, factor);
+    }
+}
+
+TEST_F(ScaleFiltersTest, TestFilterFactor) {
+    ASSERT_EQ(FilterFactor(SCALE2X_FILTER, 5), 2);
+    ASSERT_EQ(FilterFactor(SCALE3X_FILTER, 2), 3);
+    ASSERT_EQ(FilterFactor(NEAREST_FILTER, 9), MAX_SCALE_FACTOR);
+    ASSERT_EQ(FilterFactor(LCD_GRID_FILTER, 0), MIN_SCALE_FACTOR);
+
+    ScaleFilter filter;
+    ASSERT_TRUE(ParseScaleFilter("scale3x", &filter));
+    ASSERT_EQ(filter, SCALE3X_FILTER);
+    ASSERT_FALSE(ParseScaleFilter("hq4x", &filter));
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
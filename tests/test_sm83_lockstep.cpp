@@ -0,0 +1,185 @@
+#include <cstring>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/cpu/sm83_emulator.hpp"
+#include "../src/cpu/sm83_lockstep.hpp"
+
+namespace {
+
+// Undoes ROM writes on a lone instance, as LockstepSM83 does for each of its own
+class RomGuard : public MemoryObserver {
+public:
+    uint8_t* memory;
+    const uint8_t* rom;
+
+    void OnMemoryWrite(uint16_t address, uint8_t value) override {
+        memory[address] = rom[address];
+    }
+};
+
+// A ROM of random implemented op codes. Every byte is a valid op code so any alignment decodes, and
+// the first and last pages are NOPs, the last ending in a jump back into itself, so relative jumps
+// never leave ROM
+std::vector<uint8_t> BuildRandomROM(std::mt19937* random) {
+    std::vector<uint8_t> op_codes;
+    for (int op_code = 0; op_code < 0x100; op_code++) {
+        // 08 writes its operand into the code, C9 and CD move the PC through RAM
+        if (OpCodeHandlerFor((uint8_t)op_code) != nullptr && op_code != 0x08 && op_code != 0xC9 && op_code != 0xCD) {
+            op_codes.push_back((uint8_t)op_code);
+        }
+    }
+
+    std::vector<uint8_t> rom(LOCKSTEP_ROM_SIZE);
+    for (size_t i = 0; i < rom.size(); i++) {
+        bool edge = i < 0x100 || i >= 0x7F00;
+        rom[i] = edge ? 0x00 : op_codes[(*random)() % op_codes.size()];
+    }
+
+    // JR 7F80, out of reach of any jump from the random code
+    rom[0x7FFE] = 0x18;
+    rom[0x7FFF] = 0x80;
+    return rom;
+}
+
+void RandomiseRegisters(SM83State* state, std::mt19937* random) {
+    state->setAF((uint16_t)((*random)() & 0xFFF0));
+    state->setBC((uint16_t)(*random)());
+    state->setDE((uint16_t)(*random)());
+    state->setHL((uint16_t)(*random)());
+    state->setStackPointer((uint16_t)(0xC000 + (*random)() % 0x2000));
+    state->setProgramCounter((uint16_t)(0x100 + (*random)() % 0x7E00));
+}
+
+// Runs instances in lockstep and one at a time from the same registers, and compares everything
+void ExpectMatchesScalar(SIMDLevel level, size_t instances, bool identical) {
+    std::mt19937 random(1234);
+    std::vector<uint8_t> rom = BuildRandomROM(&random);
+
+    LockstepSM83 lockstep(instances, level);
+    ASSERT_EQ(lockstep.simdLevel(), level);
+    lockstep.LoadROM(rom.data(), rom.size());
+
+    std::vector<std::vector<uint8_t>> memories(instances, std::vector<uint8_t>(0x10000));
+    std::vector<RomGuard> guards(instances);
+    std::vector<SM83State*> states;
+    std::vector<uint64_t> cycles(instances, 0);
+
+    uint32_t seed = random();
+    for (size_t i = 0; i < instances; i++) {
+        memcpy(memories[i].data(), lockstep.memory(i), 0x10000);
+        guards[i].memory = memories[i].data();
+        guards[i].rom = rom.data();
+
+        SM83State* state = new SM83State(memories[i].data());
+        state->AddMemoryObserver(&guards[i], 0x00, 0x7F);
+
+        std::mt19937 lane_random(identical ? seed : seed + (uint32_t)i);
+        RandomiseRegisters(state, &lane_random);
+        lockstep.WriteRegisters(i, state);
+        states.push_back(state);
+    }
+
+    const uint32_t budget = 1000;
+    for (int run = 0; run < 8; run++) {
+        lockstep.Run(budget);
+
+        for (size_t i = 0; i < instances; i++) {
+            SM83Emulator emulator(states[i]);
+            while (cycles[i] < (uint64_t)(run + 1) * budget) {
+                cycles[i] += emulator.Step();
+            }
+        }
+    }
+
+    SM83State lane(nullptr);
+    for (size_t i = 0; i < instances; i++) {
+        lockstep.ReadRegisters(i, &lane);
+        ASSERT_EQ(lane.af(), states[i]->af()) << "instance " << i;
+        ASSERT_EQ(lane.bc(), states[i]->bc()) << "instance " << i;
+        ASSERT_EQ(lane.de(), states[i]->de()) << "instance " << i;
+        ASSERT_EQ(lane.hl(), states[i]->hl()) << "instance " << i;
+        ASSERT_EQ(lane.stackPointer(), states[i]->stackPointer()) << "instance " << i;
+        ASSERT_EQ(lane.programCounter(), states[i]->programCounter()) << "instance " << i;
+        ASSERT_EQ(lockstep.cycles(i), cycles[i]) << "instance " << i;
+        ASSERT_EQ(memcmp(lockstep.memory(i), memories[i].data(), 0x10000), 0) << "instance " << i;
+        delete states[i];
+    }
+
+    ASSERT_GT(lockstep.scalarSteps(), 0u);
+    if (identical) {
+        ASSERT_GT(lockstep.vectorSteps(), 0u);
+    }
+}
+
+std::vector<SIMDLevel> SupportedLevels() {
+    std::vector<SIMDLevel> levels = { SIMD_SCALAR };
+    if (SIMDLevelSupported(SIMD_AVX2)) {
+        levels.push_back(SIMD_AVX2);
+    }
+    if (SIMDLevelSupported(SIMD_AVX512)) {
+        levels.push_back(SIMD_AVX512);
+    }
+    return levels;
+}
+
+TEST(LockstepSM83Test, TestDivergentInstancesMatchScalar) {
+    // 37 leaves a partly filled last group
+    for (SIMDLevel level : SupportedLevels()) {
+        SCOPED_TRACE(SIMDLevelName(level));
+        ExpectMatchesScalar(level, 37, false);
+    }
+}
+
+TEST(LockstepSM83Test, TestConvergedInstancesMatchScalar) {
+    for (SIMDLevel level : SupportedLevels()) {
+        SCOPED_TRACE(SIMDLevelName(level));
+        ExpectMatchesScalar(level, 20, true);
+    }
+}
+
+TEST(LockstepSM83Test, TestLoadROMSetsBootRegisters) {
+    std::vector<uint8_t> rom(0x200, 0x00);
+    LockstepSM83 lockstep(3);
+    lockstep.LoadROM(rom.data(), rom.size());
+
+    SM83State lane(nullptr);
+    for (size_t i = 0; i < 3; i++) {
+        lockstep.ReadRegisters(i, &lane);
+        ASSERT_EQ(lane.af(), 0x01B0);
+        ASSERT_EQ(lane.bc(), 0x0013);
+        ASSERT_EQ(lane.de(), 0x00D8);
+        ASSERT_EQ(lane.hl(), 0x014D);
+        ASSERT_EQ(lane.stackPointer(), 0xFFFE);
+        ASSERT_EQ(lane.programCounter(), 0x0100);
+        // Past the end of the ROM reads as open bus
+        ASSERT_EQ(lockstep.memory(i)[0x7000], 0xFF);
+    }
+}
+
+TEST(LockstepSM83Test, TestNOPsRunAsOneGroup) {
+    std::vector<uint8_t> rom(LOCKSTEP_ROM_SIZE, 0x00);
+    LockstepSM83 lockstep(16);
+    lockstep.LoadROM(rom.data(), rom.size());
+
+    lockstep.Run(4000);
+
+    ASSERT_EQ(lockstep.scalarSteps(), 0u);
+    ASSERT_EQ(lockstep.vectorSteps(), 1000u);
+    ASSERT_EQ(lockstep.cycles(15), 4000u);
+}
+
+TEST(LockstepSM83Test, TestUnimplementedOpCodeThrows) {
+    std::vector<uint8_t> rom(LOCKSTEP_ROM_SIZE, 0xD3);
+    LockstepSM83 lockstep(2);
+    lockstep.LoadROM(rom.data(), rom.size());
+
+    ASSERT_THROW(lockstep.Run(100), std::runtime_error);
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
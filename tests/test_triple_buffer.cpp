@@ -0,0 +1,84 @@
+#include <atomic>
+#include <thread>
+#include <gtest/gtest.h>
+#include "../src/util/triple_buffer.hpp"
+
+namespace {
+
+TEST(TripleBufferTest, TestAcquireSeesOnlyNewFrames) {
+    TripleBuffer<uint32_t> buffer(4);
+    ASSERT_FALSE(buffer.Acquire());
+
+    buffer.WriteBuffer()[0] = 1;
+    buffer.Publish();
+    buffer.WriteBuffer()[0] = 2;
+    buffer.Publish();
+
+    // The reader skips straight to the newest frame
+    ASSERT_TRUE(buffer.Acquire());
+    ASSERT_EQ(buffer.ReadBuffer()[0], 2u);
+    ASSERT_FALSE(buffer.Acquire());
+    ASSERT_EQ(buffer.ReadBuffer()[0], 2u);
+}
+
+TEST(TripleBufferTest, TestWriterNeverTouchesReadBuffer) {
+    TripleBuffer<uint32_t> buffer(4);
+    buffer.Publish();
+    ASSERT_TRUE(buffer.Acquire());
+
+    const uint32_t* front = buffer.ReadBuffer();
+    for (int i = 0; i < 10; i++) {
+        ASSERT_NE(buffer.WriteBuffer(), front);
+        buffer.Publish();
+    }
+}
+
+TEST(TripleBufferTest, TestFramesArriveWholeAcrossThreads) {
+    const size_t length = 160 * 144;
+    const uint32_t frames = 20000;
+    TripleBuffer<uint32_t> buffer(length);
+    std::atomic<bool> done(false);
+
+    std::thread writer([&]() {
+        for (uint32_t frame = 1; frame <= frames; frame++) {
+            uint32_t* pixels = buffer.WriteBuffer();
+            for (size_t i = 0; i < length; i += 97) {
+                pixels[i] = frame;
+            }
+            pixels[length - 1] = frame;
+            buffer.Publish();
+        }
+        done.store(true);
+    });
+
+    uint32_t last = 0;
+    while (true) {
+        bool finished = done.load();
+        if (!buffer.Acquire()) {
+            if (finished) {
+                break;
+            }
+            continue;
+        }
+
+        // Every sampled pixel belongs to the same frame, and frames never go backwards
+        const uint32_t* pixels = buffer.ReadBuffer();
+        uint32_t frame = pixels[0];
+        for (size_t i = 0; i < length; i += 97) {
+            ASSERT_EQ(pixels[i], frame);
+        }
+        ASSERT_EQ(pixels[length - 1], frame);
+        ASSERT_GT(frame, last);
+        last = frame;
+    }
+    writer.join();
+
+    ASSERT_EQ(last, frames);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
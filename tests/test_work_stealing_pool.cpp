@@ -0,0 +1,81 @@
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../src/util/work_stealing_pool.hpp"
+
+namespace {
+
+TEST(WorkStealingPoolTest, TestRunsEveryJobOnce) {
+    WorkStealingPool pool(4);
+    std::vector<std::atomic<int>> runs(1000);
+    for (std::atomic<int>& count : runs) {
+        count = 0;
+    }
+
+    pool.Run(runs.size(), [&](size_t worker, size_t job) {
+        ASSERT_LT(worker, 4u);
+        runs[job]++;
+    });
+
+    for (size_t job = 0; job < runs.size(); job++) {
+        ASSERT_EQ(runs[job].load(), 1) << "job " << job;
+    }
+}
+
+TEST(WorkStealingPoolTest, TestIdleWorkersSteal) {
+    WorkStealingPool pool(2);
+    std::atomic<int> worker_one_jobs(0);
+
+    // Worker 0 is dealt every even job and stalls on the first, so worker 1 has to take its share
+    pool.Run(8, [&](size_t worker, size_t job) {
+        if (job == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        if (worker == 1) {
+            worker_one_jobs++;
+        }
+    });
+
+    ASSERT_GT(pool.steals(), 0u);
+    ASSERT_GT(worker_one_jobs.load(), 4);
+}
+
+TEST(WorkStealingPoolTest, TestWorkersKeepTheirIndex) {
+    WorkStealingPool pool(3);
+    std::vector<std::thread::id> owners(pool.threadCount());
+    std::atomic<bool> mismatch(false);
+    std::mutex mutex;
+
+    // The same worker index is always the same thread, so per worker state needs no locking
+    pool.Run(300, [&](size_t worker, size_t job) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (owners[worker] == std::thread::id()) {
+            owners[worker] = std::this_thread::get_id();
+        } else if (owners[worker] != std::this_thread::get_id()) {
+            mismatch = true;
+        }
+    });
+
+    ASSERT_FALSE(mismatch.load());
+}
+
+TEST(WorkStealingPoolTest, TestRunsAgain) {
+    WorkStealingPool pool;
+    std::atomic<size_t> total(0);
+
+    ASSERT_GT(pool.threadCount(), 0u);
+    pool.Run(0, [&](size_t worker, size_t job) { total++; });
+    pool.Run(10, [&](size_t worker, size_t job) { total++; });
+    pool.Run(10, [&](size_t worker, size_t job) { total++; });
+    ASSERT_EQ(total.load(), 20u);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}